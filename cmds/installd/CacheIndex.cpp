@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CacheIndex.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/xattr.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include <android-base/logging.h>
+
+#include "utils.h"
+
+namespace android {
+namespace installd {
+
+// Directory entries kept in the index across all cache directories. Once there are more, the
+// cache directories that were loaded least recently are dropped from the index.
+static constexpr size_t kMaxIndexedEntries = 100000;
+
+static bool sameTime(const struct timespec& left, const struct timespec& right) {
+    return left.tv_sec == right.tv_sec && left.tv_nsec == right.tv_nsec;
+}
+
+static bool isBefore(const struct timespec& left, const struct timespec& right) {
+    return left.tv_sec < right.tv_sec
+            || (left.tv_sec == right.tv_sec && left.tv_nsec < right.tv_nsec);
+}
+
+static std::string join(const std::string& path, const std::string& name) {
+    if (!path.empty() && path.back() == '/') {
+        return path + name;
+    }
+    return path + "/" + name;
+}
+
+class CacheIndex::Walk {
+public:
+    Walk(dev_t rootDevice, Root* previous, std::vector<std::shared_ptr<CacheItem>>* items)
+          : mRootDevice(rootDevice), mPrevious(previous), mItems(items) {
+    }
+
+    Root next;
+
+    /**
+     * Returns the entries of the directory at path, whose current stat is st,
+     * reading them again unless the previous walk's are still valid. Returns
+     * null if the directory can't be read.
+     */
+    const Directory* load(const std::string& path, const struct stat& st, bool tombstone) {
+        auto previous = mPrevious->directories.find(path);
+        if (previous != mPrevious->directories.end()) {
+            Directory& dir = previous->second;
+            if (dir.reusable && !tombstone && !dir.tombstone && dir.device == st.st_dev
+                    && dir.inode == st.st_ino && sameTime(dir.modified, st.st_mtim)
+                    && sameTime(dir.changed, st.st_ctim)) {
+                return add(path, std::move(dir));
+            }
+        }
+
+        // Timestamps only move once per clock tick, so a directory changed in
+        // the tick it was read in may look unchanged later on.
+        struct timespec readTime;
+        clock_gettime(CLOCK_REALTIME_COARSE, &readTime);
+
+        DIR* d = opendir(path.c_str());
+        if (d == nullptr) {
+            PLOG(WARNING) << "Failed to opendir " << path;
+            return nullptr;
+        }
+        Directory dir = {
+            .device = st.st_dev,
+            .inode = st.st_ino,
+            .modified = st.st_mtim,
+            .changed = st.st_ctim,
+            .group = getxattr(path.c_str(), kXattrCacheGroup, nullptr, 0) >= 0,
+            .tombstone = getxattr(path.c_str(), kXattrCacheTombstone, nullptr, 0) >= 0,
+            .reusable = isBefore(st.st_ctim, readTime),
+            .entries = {},
+        };
+        struct dirent* de;
+        while ((de = readdir(d)) != nullptr) {
+            if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, "..")) {
+                continue;
+            }
+            struct stat s;
+            if (fstatat(dirfd(d), de->d_name, &s, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            dir.entries.push_back({
+                .name = de->d_name,
+                .directory = S_ISDIR(s.st_mode),
+                .size = s.st_blocks * 512,
+                .modified = s.st_mtime,
+            });
+        }
+        closedir(d);
+        return add(path, std::move(dir));
+    }
+
+    void addEntries(const std::string& path, const Directory& dir, CacheItem* parent) {
+        for (const auto& entry : dir.entries) {
+            // Items directly under the cache directory are named by their path.
+            addEntry(join(path, entry.name), parent ? entry.name : join(path, entry.name), entry,
+                    parent);
+        }
+    }
+
+private:
+    const Directory* add(const std::string& path, Directory&& dir) {
+        next.entryCount += dir.entries.size();
+        return &(next.directories[path] = std::move(dir));
+    }
+
+    void addEntry(const std::string& path, const std::string& name, const Entry& entry,
+            CacheItem* parent) {
+        if (!entry.directory) {
+            addItem(std::make_shared<CacheItem>(parent, name, false, entry.size, entry.modified),
+                    parent);
+            return;
+        }
+
+        // The directory itself may have changed since its parent was read.
+        struct stat st;
+        if (lstat(path.c_str(), &st) != 0) {
+            return;
+        }
+        auto item = std::make_shared<CacheItem>(parent, name, S_ISDIR(st.st_mode),
+                st.st_blocks * 512, st.st_mtime);
+        if (!item->directory) {
+            addItem(item, parent);
+            return;
+        }
+        mItems->push_back(item);
+
+        if (st.st_dev != mRootDevice) {
+            // Not walked, like with FTS_XDEV, but still an item of its own.
+            item->group |= (getxattr(path.c_str(), kXattrCacheGroup, nullptr, 0) >= 0);
+            item->tombstone |= (getxattr(path.c_str(), kXattrCacheTombstone, nullptr, 0) >= 0);
+        } else {
+            const Directory* dir = load(path, st, item->tombstone);
+            if (dir == nullptr) {
+                // Like FTS_DNR, which doesn't update the parent's modified time.
+                return;
+            }
+            item->group |= dir->group;
+            item->tombstone |= dir->tombstone;
+
+            // When group, the whole tree is a single item
+            if (item->group) {
+                addGroup(path, *dir, item.get());
+            } else {
+                addEntries(path, *dir, item.get());
+            }
+        }
+        bubble(item.get(), parent);
+    }
+
+    void addGroup(const std::string& path, const Directory& dir, CacheItem* group) {
+        for (const auto& entry : dir.entries) {
+            if (!entry.directory) {
+                group->size += entry.size;
+                group->modified = std::max(group->modified, entry.modified);
+                continue;
+            }
+            const std::string childPath = join(path, entry.name);
+            struct stat st;
+            if (lstat(childPath.c_str(), &st) != 0) {
+                continue;
+            }
+            group->size += st.st_blocks * 512;
+            group->modified = std::max(group->modified, st.st_mtime);
+            if (S_ISDIR(st.st_mode) && st.st_dev == mRootDevice) {
+                const Directory* child = load(childPath, st, group->tombstone);
+                if (child != nullptr) {
+                    addGroup(childPath, *child, group);
+                }
+            }
+        }
+    }
+
+    void addItem(const std::shared_ptr<CacheItem>& item, CacheItem* parent) {
+        mItems->push_back(item);
+        bubble(item.get(), parent);
+    }
+
+    // Bubble up modified time to parent
+    static void bubble(CacheItem* item, CacheItem* parent) {
+        if (parent) {
+            parent->modified = std::max(parent->modified, item->modified);
+        }
+    }
+
+    const dev_t mRootDevice;
+    Root* const mPrevious;
+    std::vector<std::shared_ptr<CacheItem>>* const mItems;
+};
+
+CacheIndex::CacheIndex() : mEntryCount(0), mGeneration(0) {
+}
+
+CacheIndex::~CacheIndex() {
+}
+
+void CacheIndex::loadItems(const std::string& path,
+        std::vector<std::shared_ptr<CacheItem>>* items) {
+    std::lock_guard<std::mutex> lock(mLock);
+
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        auto it = mRoots.find(path);
+        if (it != mRoots.end()) {
+            mEntryCount -= it->second.entryCount;
+            mRoots.erase(it);
+        }
+        return;
+    }
+
+    Root& root = mRoots[path];
+    Walk walk(st.st_dev, &root, items);
+    // The cache directory itself isn't an item, and neither are its attributes
+    // looked at.
+    if (const Directory* dir = walk.load(path, st, false)) {
+        walk.addEntries(path, *dir, nullptr);
+    }
+
+    // Directories that weren't walked again are gone.
+    mEntryCount = mEntryCount - root.entryCount + walk.next.entryCount;
+    root.directories = std::move(walk.next.directories);
+    root.entryCount = walk.next.entryCount;
+    root.lastUsed = ++mGeneration;
+    trimLocked();
+}
+
+void CacheIndex::trimLocked() {
+    while (mEntryCount > kMaxIndexedEntries && !mRoots.empty()) {
+        auto oldest = std::min_element(mRoots.begin(), mRoots.end(),
+                [](const auto& left, const auto& right) {
+                    return left.second.lastUsed < right.second.lastUsed;
+                });
+        mEntryCount -= oldest->second.entryCount;
+        mRoots.erase(oldest);
+    }
+}
+
+}  // namespace installd
+}  // namespace android
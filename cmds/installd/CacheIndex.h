@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_INSTALLD_CACHE_INDEX_H
+#define ANDROID_INSTALLD_CACHE_INDEX_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <android-base/macros.h>
+
+#include "CacheItem.h"
+
+namespace android {
+namespace installd {
+
+/**
+ * Index of the contents of cache directories, kept across freeCache() calls
+ * so that only the directories that changed since the last call are read
+ * again. Every indexed directory is still stat'ed on each call, but the
+ * files in a directory are only stat'ed again once the directory itself
+ * changes, so the size and modified time of a file rewritten in place can be
+ * stale. Those only affect the order of purging and the estimate of freed
+ * space, which freeCache() checks against the free space of the disk.
+ *
+ * Files of tombstone directories are truncated in place when purged, so
+ * those directories are always read again.
+ */
+class CacheIndex {
+public:
+    CacheIndex();
+    ~CacheIndex();
+
+    /**
+     * Appends the items under the cache directory at path to items, as a
+     * FTS_PHYSICAL | FTS_XDEV walk of the directory would have found them.
+     */
+    void loadItems(const std::string& path, std::vector<std::shared_ptr<CacheItem>>* items);
+
+private:
+    struct Entry {
+        std::string name;
+        bool directory;
+        int64_t size;
+        time_t modified;
+    };
+
+    struct Directory {
+        dev_t device;
+        ino_t inode;
+        struct timespec modified;
+        struct timespec changed;
+        bool group;
+        bool tombstone;
+        // Whether the directory can't have changed since it was read without
+        // changing its modified or changed time.
+        bool reusable;
+        std::vector<Entry> entries;
+    };
+
+    struct Root {
+        // Directories under the root, by path, including the root itself.
+        std::unordered_map<std::string, Directory> directories;
+        size_t entryCount = 0;
+        uint64_t lastUsed = 0;
+    };
+
+    class Walk;
+
+    void trimLocked();
+
+    std::mutex mLock;
+    std::unordered_map<std::string, Root> mRoots;
+    size_t mEntryCount;
+    uint64_t mGeneration;
+
+    DISALLOW_COPY_AND_ASSIGN(CacheIndex);
+};
+
+}  // namespace installd
+}  // namespace android
+
+#endif  // ANDROID_INSTALLD_CACHE_INDEX_H
@@ -16,6 +16,7 @@
 
 #include "CacheItem.h"
 
+#include <fts.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <sys/xattr.h>
@@ -30,22 +31,19 @@ using android::base::StringPrintf;
 namespace android {
 namespace installd {
 
-CacheItem::CacheItem(FTSENT* p) {
-    level = p->fts_level;
-    directory = S_ISDIR(p->fts_statp->st_mode);
-    size = p->fts_statp->st_blocks * 512;
-    modified = p->fts_statp->st_mtime;
-
-    mParent = static_cast<CacheItem*>(p->fts_parent->fts_pointer);
+CacheItem::CacheItem(CacheItem* parent, const std::string& name, bool directory, int64_t size,
+        time_t modified)
+      : directory(directory), size(size), modified(modified), mParent(parent) {
     if (mParent) {
+        level = mParent->level + 1;
         group = mParent->group;
         tombstone = mParent->tombstone;
-        mName = p->fts_name;
-        mName.insert(0, "/");
+        mName = "/" + name;
     } else {
+        level = 1;
         group = false;
         tombstone = false;
-        mName = p->fts_path;
+        mName = name;
     }
 }
 
@@ -118,20 +116,25 @@ int CacheItem::purge() {
         }
 	fts_close(fts);
     } else {
-        if (tombstone) {
-            if (truncate(path.c_str(), 0) != 0) {
-                PLOG(WARNING) << "Failed to truncate " << path;
-                res = -1;
-            }
-        } else {
-            if (unlink(path.c_str()) != 0) {
-                PLOG(WARNING) << "Failed to unlink " << path;
-                res = -1;
-            }
-        }
+        res = purgeFile(path, tombstone);
     }
     return res;
 }
 
+int CacheItem::purgeFile(const std::string& path, bool tombstone) {
+    if (tombstone) {
+        if (truncate(path.c_str(), 0) != 0) {
+            PLOG(WARNING) << "Failed to truncate " << path;
+            return -1;
+        }
+    } else {
+        if (unlink(path.c_str()) != 0) {
+            PLOG(WARNING) << "Failed to unlink " << path;
+            return -1;
+        }
+    }
+    return 0;
+}
+
 }  // namespace installd
 }  // namespace android
@@ -20,7 +20,6 @@
 #include <memory>
 #include <string>
 
-#include <fts.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -36,7 +35,12 @@ namespace installd {
  */
 class CacheItem {
 public:
-    CacheItem(FTSENT* p);
+    /**
+     * Creates an item named name under parent, or an item at the path name
+     * directly under a cache directory when parent is null.
+     */
+    CacheItem(CacheItem* parent, const std::string& name, bool directory, int64_t size,
+            time_t modified);
     ~CacheItem();
 
     std::string toString();
@@ -44,6 +48,12 @@ public:
 
     int purge();
 
+    /**
+     * Purges the file at path, which is truncated instead of unlinked when
+     * tombstone is set.
+     */
+    static int purgeFile(const std::string& path, bool tombstone);
+
     short level;
     bool directory;
     bool group;
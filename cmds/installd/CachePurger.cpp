@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CachePurger.h"
+
+#include <algorithm>
+
+namespace android {
+namespace installd {
+
+static constexpr size_t kMaxThreads = 4;
+
+CachePurger::CachePurger() : mPending(0), mStopping(false) {
+}
+
+CachePurger::~CachePurger() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStopping = true;
+    }
+    mQueued.notify_all();
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+void CachePurger::purge(const std::shared_ptr<CacheItem>& item) {
+    if (item->directory) {
+        wait();
+        item->purge();
+        return;
+    }
+
+    // The path is built now, as the parents of the item may be gone by the
+    // time it's purged.
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mFiles.push_back({item->buildPath(), item->tombstone});
+        mPending++;
+        // Threads are only started once there are files to purge.
+        size_t maxThreads = std::clamp(static_cast<size_t>(std::thread::hardware_concurrency()),
+                static_cast<size_t>(1), kMaxThreads);
+        if (mThreads.size() < std::min(mPending, maxThreads)) {
+            mThreads.emplace_back([this]() { loop(); });
+        }
+    }
+    mQueued.notify_one();
+}
+
+void CachePurger::wait() {
+    std::unique_lock<std::mutex> lock(mLock);
+    mDone.wait(lock, [this]() { return mPending == 0; });
+}
+
+void CachePurger::loop() {
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true) {
+        mQueued.wait(lock, [this]() { return mStopping || !mFiles.empty(); });
+        if (mFiles.empty()) {
+            return;
+        }
+        File file = std::move(mFiles.front());
+        mFiles.pop_front();
+        lock.unlock();
+        CacheItem::purgeFile(file.path, file.tombstone);
+        lock.lock();
+        if (--mPending == 0) {
+            mDone.notify_all();
+        }
+    }
+}
+
+}  // namespace installd
+}  // namespace android
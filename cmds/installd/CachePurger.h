@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_INSTALLD_CACHE_PURGER_H
+#define ANDROID_INSTALLD_CACHE_PURGER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <android-base/macros.h>
+
+#include "CacheItem.h"
+
+namespace android {
+namespace installd {
+
+/**
+ * Purges cache items on a few threads. Most of the time spent unlinking a
+ * large file goes to freeing its blocks, which happens outside of the lock
+ * of its directory, so files purge faster in parallel even when they share a
+ * directory.
+ */
+class CachePurger {
+public:
+    CachePurger();
+    ~CachePurger();
+
+    /**
+     * Purges item, in the background if it's a file. Directories are purged
+     * right away, once the files purging in the background are gone, since
+     * some of them might be in the directory.
+     */
+    void purge(const std::shared_ptr<CacheItem>& item);
+
+    /**
+     * Waits for the files purging in the background.
+     */
+    void wait();
+
+private:
+    struct File {
+        std::string path;
+        bool tombstone;
+    };
+
+    void loop();
+
+    std::mutex mLock;
+    std::condition_variable mQueued;
+    std::condition_variable mDone;
+    std::deque<File> mFiles;
+    // Files queued or being purged.
+    size_t mPending;
+    bool mStopping;
+    std::vector<std::thread> mThreads;
+
+    DISALLOW_COPY_AND_ASSIGN(CachePurger);
+};
+
+}  // namespace installd
+}  // namespace android
+
+#endif  // ANDROID_INSTALLD_CACHE_PURGER_H
@@ -18,8 +18,6 @@
 
 #include "CacheTracker.h"
 
-#include <fts.h>
-#include <sys/xattr.h>
 #include <utils/Trace.h>
 
 #include <android-base/logging.h>
@@ -33,13 +31,15 @@ using android::base::StringPrintf;
 namespace android {
 namespace installd {
 
-CacheTracker::CacheTracker(userid_t userId, appid_t appId, const std::string& uuid)
+CacheTracker::CacheTracker(userid_t userId, appid_t appId, const std::string& uuid,
+        CacheIndex* index)
       : cacheUsed(0),
         cacheQuota(0),
         mUserId(userId),
         mAppId(appId),
         mItemsLoaded(false),
-        mUuid(uuid) {
+        mUuid(uuid),
+        mIndex(index) {
 }
 
 CacheTracker::~CacheTracker() {
@@ -94,80 +94,13 @@ bool CacheTracker::loadQuotaStats() {
     }
 }
 
-void CacheTracker::loadItemsFrom(const std::string& path) {
-    FTS *fts;
-    FTSENT *p;
-    char *argv[] = { (char*) path.c_str(), nullptr };
-    if (!(fts = fts_open(argv, FTS_PHYSICAL | FTS_NOCHDIR | FTS_XDEV, nullptr))) {
-        PLOG(WARNING) << "Failed to fts_open " << path;
-        return;
-    }
-    while ((p = fts_read(fts)) != nullptr) {
-        if (p->fts_level == 0) continue;
-
-        // Create tracking nodes for everything we encounter
-        switch (p->fts_info) {
-        case FTS_D:
-        case FTS_DEFAULT:
-        case FTS_F:
-        case FTS_SL:
-        case FTS_SLNONE: {
-            auto item = std::shared_ptr<CacheItem>(new CacheItem(p));
-            p->fts_pointer = static_cast<void*>(item.get());
-            items.push_back(item);
-        }
-        }
-
-        switch (p->fts_info) {
-        case FTS_D: {
-            auto item = static_cast<CacheItem*>(p->fts_pointer);
-            item->group |= (getxattr(p->fts_path, kXattrCacheGroup, nullptr, 0) >= 0);
-            item->tombstone |= (getxattr(p->fts_path, kXattrCacheTombstone, nullptr, 0) >= 0);
-
-            // When group, immediately collect all files under tree
-            if (item->group) {
-                while ((p = fts_read(fts)) != nullptr) {
-                    if (p->fts_info == FTS_DP && p->fts_level == item->level) break;
-                    switch (p->fts_info) {
-                    case FTS_D:
-                    case FTS_DEFAULT:
-                    case FTS_F:
-                    case FTS_SL:
-                    case FTS_SLNONE:
-                        item->size += p->fts_statp->st_blocks * 512;
-                        item->modified = std::max(item->modified, p->fts_statp->st_mtime);
-                    }
-                }
-            }
-        }
-        }
-
-        // Bubble up modified time to parent
-        CHECK(p != nullptr);
-        switch (p->fts_info) {
-        case FTS_DP:
-        case FTS_DEFAULT:
-        case FTS_F:
-        case FTS_SL:
-        case FTS_SLNONE: {
-            auto item = static_cast<CacheItem*>(p->fts_pointer);
-            auto parent = static_cast<CacheItem*>(p->fts_parent->fts_pointer);
-            if (parent) {
-                parent->modified = std::max(parent->modified, item->modified);
-            }
-        }
-        }
-    }
-    fts_close(fts);
-}
-
 void CacheTracker::loadItems() {
     items.clear();
 
     ATRACE_BEGIN("loadItems");
     for (const auto& path : mDataPaths) {
-        loadItemsFrom(read_path_inode(path, "cache", kXattrInodeCache));
-        loadItemsFrom(read_path_inode(path, "code_cache", kXattrInodeCodeCache));
+        mIndex->loadItems(read_path_inode(path, "cache", kXattrInodeCache), &items);
+        mIndex->loadItems(read_path_inode(path, "code_cache", kXattrInodeCodeCache), &items);
     }
     ATRACE_END();
 
@@ -27,6 +27,7 @@
 #include <android-base/macros.h>
 #include <cutils/multiuser.h>
 
+#include "CacheIndex.h"
 #include "CacheItem.h"
 
 namespace android {
@@ -39,7 +40,7 @@ namespace installd {
  */
 class CacheTracker {
 public:
-    CacheTracker(userid_t userId, appid_t appId, const std::string& uuid);
+    CacheTracker(userid_t userId, appid_t appId, const std::string& uuid, CacheIndex* index);
     ~CacheTracker();
 
     std::string toString();
@@ -63,11 +64,11 @@ private:
     appid_t mAppId;
     bool mItemsLoaded;
     const std::string& mUuid;
+    CacheIndex* mIndex;
 
     std::vector<std::string> mDataPaths;
 
     bool loadQuotaStats();
-    void loadItemsFrom(const std::string& path);
 
     DISALLOW_COPY_AND_ASSIGN(CacheTracker);
 };
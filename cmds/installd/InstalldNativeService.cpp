@@ -71,11 +71,13 @@
 #include "otapreopt_utils.h"
 #include "utils.h"
 
+#include "CachePurger.h"
 #include "CacheTracker.h"
 #include "CrateManager.h"
 #include "MatchExtensionGen.h"
 #include "QuotaUtils.h"
 #include "SysTrace.h"
+#include "tree_size.h"
 
 #ifndef LOG_TAG
 #define LOG_TAG "installd"
@@ -2183,7 +2185,8 @@ binder::Status InstalldNativeService::freeCache(const std::optional<std::string>
                         search->second->addDataPath(p->fts_path);
                     } else {
                         auto tracker = std::shared_ptr<CacheTracker>(new CacheTracker(
-                                multiuser_get_user_id(uid), multiuser_get_app_id(uid), uuidString));
+                                multiuser_get_user_id(uid), multiuser_get_app_id(uid), uuidString,
+                                &mCacheIndex));
                         tracker->addDataPath(p->fts_path);
                         {
                             std::lock_guard<std::recursive_mutex> lock(mQuotasLock);
@@ -2220,6 +2223,7 @@ binder::Status InstalldNativeService::freeCache(const std::optional<std::string>
         // 3. Bounce across the queue, freeing items from whichever tracker is
         // the most over their assigned quota
         atrace_pm_begin("bounce");
+        CachePurger purger;
         std::shared_ptr<CacheTracker> active;
         while (active || !queue.empty()) {
             // Only look at apps under quota when explicitly requested
@@ -2255,7 +2259,7 @@ binder::Status InstalldNativeService::freeCache(const std::optional<std::string>
 
                 LOG(DEBUG) << "Purging " << item->toString() << " from " << active->toString();
                 if (!noop) {
-                    item->purge();
+                    purger.purge(item);
                 }
                 active->cacheUsed -= item->size;
                 needed -= item->size;
@@ -2265,6 +2269,7 @@ binder::Status InstalldNativeService::freeCache(const std::optional<std::string>
                 // Verify that we're actually done before bailing, since sneaky
                 // apps might be using hardlinks
                 if (needed <= 0) {
+                    purger.wait();
                     free = data_disk_free(data_path);
                     needed = targetFreeBytes - free;
                     if (needed <= 0) {
@@ -2275,6 +2280,7 @@ binder::Status InstalldNativeService::freeCache(const std::optional<std::string>
                 }
             }
         }
+        purger.wait();
         atrace_pm_end();
 
     } else {
@@ -2519,46 +2525,45 @@ static void collectManualStatsForUser(const std::string& path, struct stats* sta
 }
 
 static void collectManualExternalStatsForUser(const std::string& path, struct stats* stats) {
-    FTS *fts;
-    FTSENT *p;
-    char *argv[] = { (char*) path.c_str(), nullptr };
-    if (!(fts = fts_open(argv, FTS_PHYSICAL | FTS_NOCHDIR | FTS_XDEV, nullptr))) {
-        PLOG(ERROR) << "Failed to fts_open " << path;
-        return;
-    }
-    while ((p = fts_read(fts)) != nullptr) {
-        p->fts_number = p->fts_parent->fts_number;
-        switch (p->fts_info) {
-        case FTS_D:
-            if (p->fts_level == 3
-                    && !strcmp(p->fts_parent->fts_name, "obb")
-                    && !strcmp(p->fts_parent->fts_parent->fts_name, "Android")) {
-                p->fts_number = 1;
-            } else if (p->fts_level == 4
-                    && !strcmp(p->fts_name, "cache")
-                    && !strcmp(p->fts_parent->fts_parent->fts_name, "data")
-                    && !strcmp(p->fts_parent->fts_parent->fts_parent->fts_name, "Android")) {
-                p->fts_number = 2;
-            }
-            [[fallthrough]]; // to count the directory
-        case FTS_DEFAULT:
-        case FTS_F:
-        case FTS_SL:
-        case FTS_SLNONE:
-            int64_t size = (p->fts_statp->st_blocks * 512);
-            if (p->fts_number == 1) {
-                stats->codeSize += size;
-            } else {
-                if (p->fts_number == 2) {
-                    stats->cacheSize += size;
-                }
-                stats->dataSize += size;
+    // Entries of Android/obb/<package> count as code, and entries of Android/data/<package>/cache
+    // count as cache. The other categories only track the way to those directories.
+    enum Category { kData, kAndroid, kObbRoot, kDataRoot, kPackageData, kObb, kCache, kCount };
+    auto classify = [](const tree_entry& entry) -> int {
+        const int parent = entry.parent_category;
+        if (parent == kObb || parent == kCache) {
+            return parent;
+        }
+        if (!S_ISDIR(entry.stat.st_mode)) {
+            return kData;
+        }
+        if (entry.level == 1 && !strcmp(entry.name, "Android")) {
+            return kAndroid;
+        } else if (parent == kAndroid && !strcmp(entry.name, "obb")) {
+            return kObbRoot;
+        } else if (parent == kAndroid && !strcmp(entry.name, "data")) {
+            return kDataRoot;
+        } else if (parent == kObbRoot) {
+            return kObb;
+        } else if (parent == kDataRoot) {
+            return kPackageData;
+        } else if (parent == kPackageData && !strcmp(entry.name, "cache")) {
+            return kCache;
+        }
+        return kData;
+    };
+    const std::vector<int64_t> sizes = measure_classified_tree_size(path, kCount, classify);
+    for (int category = 0; category < kCount; category++) {
+        if (category == kObb) {
+            stats->codeSize += sizes[category];
+        } else {
+            if (category == kCache) {
+                stats->cacheSize += sizes[category];
             }
-            break;
+            stats->dataSize += sizes[category];
         }
     }
-    fts_close(fts);
 }
+
 static bool ownsExternalStorage(int32_t appId) {
     // if project id calculation is supported then, there is no need to
     // calculate in a different way and project_id based calculation can work
@@ -3011,48 +3016,37 @@ binder::Status InstalldNativeService::getExternalSize(const std::optional<std::s
         atrace_pm_end();
     } else {
         atrace_pm_begin("manual");
-        FTS *fts;
-        FTSENT *p;
-        auto path = create_data_media_path(uuid_, userId);
-        char *argv[] = { (char*) path.c_str(), nullptr };
-        if (!(fts = fts_open(argv, FTS_PHYSICAL | FTS_NOCHDIR | FTS_XDEV, nullptr))) {
-            return error("Failed to fts_open " + path);
-        }
-        while ((p = fts_read(fts)) != nullptr) {
-            char* ext;
-            int64_t size = (p->fts_statp->st_blocks * 512);
-            switch (p->fts_info) {
-            case FTS_F:
-                // Only categorize files not belonging to apps
-                if (p->fts_parent->fts_number == 0) {
-                    ext = strrchr(p->fts_name, '.');
-                    if (ext != nullptr) {
-                        switch (MatchExtension(++ext)) {
-                        case AID_MEDIA_AUDIO: audioSize += size; break;
-                        case AID_MEDIA_VIDEO: videoSize += size; break;
-                        case AID_MEDIA_IMAGE: imageSize += size; break;
-                        }
+        // Entries below the Android directory belong to apps. Other files are sorted into
+        // audio, video and images by their extension.
+        enum Category { kOther, kAndroid, kApp, kAudio, kVideo, kImage, kCount };
+        auto classify = [](const tree_entry& entry) -> int {
+            if (entry.parent_category == kAndroid || entry.parent_category == kApp) {
+                return kApp;
+            }
+            if (entry.level == 1 && !strcmp(entry.name, "Android")) {
+                return kAndroid;
+            }
+            if (S_ISREG(entry.stat.st_mode)) {
+                const char* ext = strrchr(entry.name, '.');
+                if (ext != nullptr) {
+                    switch (MatchExtension(ext + 1)) {
+                    case AID_MEDIA_AUDIO: return kAudio;
+                    case AID_MEDIA_VIDEO: return kVideo;
+                    case AID_MEDIA_IMAGE: return kImage;
                     }
                 }
-                [[fallthrough]]; // always count against total
-            case FTS_D:
-                // Ignore data belonging to specific apps
-                p->fts_number = p->fts_parent->fts_number;
-                if (p->fts_level == 1 && !strcmp(p->fts_name, "Android")) {
-                    p->fts_number = 1;
-                }
-                [[fallthrough]]; // always count against total
-            case FTS_DEFAULT:
-            case FTS_SL:
-            case FTS_SLNONE:
-                if (p->fts_parent->fts_number == 1) {
-                    appSize += size;
-                }
-                totalSize += size;
-                break;
             }
-        }
-        fts_close(fts);
+            return kOther;
+        };
+        auto path = create_data_media_path(uuid_, userId);
+        const std::vector<int64_t> sizes = measure_classified_tree_size(path, kCount, classify);
+        for (int64_t size : sizes) {
+            totalSize += size;
+        }
+        appSize += sizes[kApp];
+        audioSize += sizes[kAudio];
+        videoSize += sizes[kVideo];
+        imageSize += sizes[kImage];
         atrace_pm_end();
 
         atrace_pm_begin("obb");
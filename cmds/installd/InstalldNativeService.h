@@ -30,6 +30,7 @@
 #include <binder/BinderService.h>
 #include <cutils/multiuser.h>
 
+#include "CacheIndex.h"
 #include "android/os/BnInstalld.h"
 #include "installd_constants.h"
 
@@ -230,6 +231,9 @@ private:
     /* Map from UID to cache quota size */
     std::unordered_map<uid_t, int64_t> mCacheQuotas;
 
+    /* Contents of cache directories, as of the last freeCache() */
+    CacheIndex mCacheIndex;
+
     std::string findDataMediaPath(const std::optional<std::string>& uuid, userid_t userid);
 
     binder::Status createAppDataLocked(const std::optional<std::string>& uuid,
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include <android-base/stringprintf.h>
+#include <benchmark/benchmark.h>
+#include <cutils/properties.h>
+#include <private/android_filesystem_config.h>
+
+#include "InstalldNativeService.h"
+#include "globals.h"
+#include "utils.h"
+
+namespace android {
+namespace installd {
+
+int get_property(const char* key, char* value, const char* default_value) {
+    return property_get(key, value, default_value);
+}
+
+bool calculate_oat_file_path(char path[PKG_PATH_MAX] ATTRIBUTE_UNUSED,
+                             const char* oat_dir ATTRIBUTE_UNUSED,
+                             const char* apk_path ATTRIBUTE_UNUSED,
+                             const char* instruction_set ATTRIBUTE_UNUSED) {
+    return false;
+}
+
+bool calculate_odex_file_path(char path[PKG_PATH_MAX] ATTRIBUTE_UNUSED,
+                              const char* apk_path ATTRIBUTE_UNUSED,
+                              const char* instruction_set ATTRIBUTE_UNUSED) {
+    return false;
+}
+
+bool create_cache_path(char path[PKG_PATH_MAX] ATTRIBUTE_UNUSED, const char* src ATTRIBUTE_UNUSED,
+                       const char* instruction_set ATTRIBUTE_UNUSED) {
+    return false;
+}
+
+bool force_compile_without_image() {
+    return false;
+}
+
+namespace {
+
+using android::base::StringPrintf;
+
+// The "TEST" volume lives under /data/local/tmp.
+static constexpr const char* kTestUuid = "TEST";
+static constexpr const char* kUserRoot = "/data/local/tmp/user/0";
+static constexpr int kDirectoriesPerApp = 4;
+static constexpr int kFilesPerDirectory = 50;
+static constexpr int64_t kTbInBytes = 1024LL * 1024 * 1024 * 1024;
+
+// Creates a data partition with the given number of apps, each with a cache of a few directories
+// of small files, and owned by its own uid so that each app gets a tracker of its own.
+void createPartition(int apps) {
+    delete_dir_contents_and_dir("/data/local/tmp/user", true /* ignore_if_missing */);
+    mkdir("/data/local/tmp/user", 0700);
+    mkdir(kUserRoot, 0700);
+    for (int app = 0; app < apps; app++) {
+        const std::string appDir = StringPrintf("%s/com.example%d", kUserRoot, app);
+        const std::string cacheDir = appDir + "/cache";
+        mkdir(appDir.c_str(), 0700);
+        mkdir(cacheDir.c_str(), 0700);
+        for (int i = 0; i < kDirectoriesPerApp; i++) {
+            const std::string dir = StringPrintf("%s/d%d", cacheDir.c_str(), i);
+            mkdir(dir.c_str(), 0700);
+            for (int j = 0; j < kFilesPerDirectory; j++) {
+                const std::string file = StringPrintf("%s/f%d", dir.c_str(), j);
+                int fd = open(file.c_str(), O_WRONLY | O_CREAT, 0600);
+                fallocate(fd, 0, 0, 4096);
+                close(fd);
+            }
+        }
+        chown(appDir.c_str(), AID_APP_START + app, AID_APP_START + app);
+    }
+}
+
+void freeCache(InstalldNativeService* service, int32_t flags) {
+    service->freeCache(std::optional<std::string>(kTestUuid), kTbInBytes,
+                       InstalldNativeService::FLAG_FREE_CACHE_V2 |
+                               InstalldNativeService::FLAG_FREE_CACHE_V2_DEFY_QUOTA |
+                               InstalldNativeService::FLAG_FREE_CACHE_DEFY_TARGET_FREE_BYTES |
+                               flags);
+}
+
+// Picks everything to purge without purging it, with an empty cache index, as the first call after
+// installd starts does.
+void BM_FreeCache_PlanCold(benchmark::State& state) {
+    createPartition(state.range(0));
+    for (auto _ : state) {
+        InstalldNativeService service;
+        freeCache(&service, InstalldNativeService::FLAG_FREE_CACHE_NOOP);
+    }
+}
+BENCHMARK(BM_FreeCache_PlanCold)->Arg(50)->Arg(200)->Unit(benchmark::kMillisecond);
+
+// Same, once the cache index is up to date.
+void BM_FreeCache_PlanIndexed(benchmark::State& state) {
+    createPartition(state.range(0));
+    InstalldNativeService service;
+    freeCache(&service, InstalldNativeService::FLAG_FREE_CACHE_NOOP);
+    for (auto _ : state) {
+        freeCache(&service, InstalldNativeService::FLAG_FREE_CACHE_NOOP);
+    }
+}
+BENCHMARK(BM_FreeCache_PlanIndexed)->Arg(50)->Arg(200)->Unit(benchmark::kMillisecond);
+
+// Purges the whole cache of every app.
+void BM_FreeCache_Purge(benchmark::State& state) {
+    InstalldNativeService service;
+    for (auto _ : state) {
+        state.PauseTiming();
+        createPartition(state.range(0));
+        state.ResumeTiming();
+        freeCache(&service, 0);
+    }
+}
+BENCHMARK(BM_FreeCache_Purge)->Arg(50)->Arg(200)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace installd
+} // namespace android
+
+BENCHMARK_MAIN();
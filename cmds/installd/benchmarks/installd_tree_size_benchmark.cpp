@@ -0,0 +1,115 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fts.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <android-base/file.h>
+#include <android-base/stringprintf.h>
+#include <benchmark/benchmark.h>
+
+#include "tree_size.h"
+#include "utils.h"
+
+namespace android {
+namespace installd {
+namespace {
+
+using android::base::StringPrintf;
+
+static constexpr const char* kTreeRoot = "/data/local/tmp/installd_tree_size_benchmark";
+static constexpr int kFilesPerDirectory = 64;
+static constexpr int kDirectoriesPerDirectory = 16;
+
+// Creates count files spread over a tree of directories, unless an earlier run already did. The
+// trees are kept, as creating millions of files takes a while.
+std::string createTree(int count) {
+    const std::string root = StringPrintf("%s/%d", kTreeRoot, count);
+    const std::string done = root + "/.done";
+    if (access(done.c_str(), F_OK) == 0) {
+        return root;
+    }
+    delete_dir_contents_and_dir(root, true /* ignore_if_missing */);
+    mkdir(kTreeRoot, 0700);
+    mkdir(root.c_str(), 0700);
+
+    const std::string contents(4096, 'x');
+    int created = 0;
+    std::vector<std::string> directories = {root};
+    for (size_t i = 0; created < count; i++) {
+        const std::string parent = directories[i];
+        for (int j = 0; j < kFilesPerDirectory && created < count; j++, created++) {
+            android::base::WriteStringToFile(contents, StringPrintf("%s/f%d", parent.c_str(), j));
+        }
+        for (int j = 0; j < kDirectoriesPerDirectory && created < count; j++) {
+            const std::string directory = StringPrintf("%s/d%d", parent.c_str(), j);
+            mkdir(directory.c_str(), 0700);
+            directories.push_back(directory);
+        }
+    }
+    android::base::WriteStringToFile("", done);
+    return root;
+}
+
+// How calculate_tree_size() used to walk trees.
+int64_t measureTreeSizeWithFts(const std::string& path) {
+    int64_t size = 0;
+    char* argv[] = {const_cast<char*>(path.c_str()), nullptr};
+    FTS* fts = fts_open(argv, FTS_PHYSICAL | FTS_NOCHDIR | FTS_XDEV, nullptr);
+    if (fts == nullptr) {
+        return -1;
+    }
+    while (FTSENT* p = fts_read(fts)) {
+        switch (p->fts_info) {
+            case FTS_D:
+            case FTS_DEFAULT:
+            case FTS_F:
+            case FTS_SL:
+            case FTS_SLNONE:
+                size += p->fts_statp->st_blocks * 512;
+                break;
+        }
+    }
+    fts_close(fts);
+    return size;
+}
+
+void BM_TreeSize_Fts(benchmark::State& state) {
+    const std::string root = createTree(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(measureTreeSizeWithFts(root));
+    }
+}
+BENCHMARK(BM_TreeSize_Fts)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(
+        benchmark::kMillisecond);
+
+void BM_TreeSize_Parallel(benchmark::State& state) {
+    const std::string root = createTree(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(measure_tree_size(root));
+    }
+}
+BENCHMARK(BM_TreeSize_Parallel)->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(
+        benchmark::kMillisecond);
+
+} // namespace
+} // namespace installd
+} // namespace android
+
+BENCHMARK_MAIN();
@@ -19,6 +19,9 @@
 #include <sys/statvfs.h>
 #include <sys/xattr.h>
 
+#include <chrono>
+#include <thread>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <cutils/properties.h>
@@ -43,6 +46,7 @@ constexpr int64_t kTbInBytes = 1024 * kGbInBytes;
 #define FLAG_FREE_CACHE_V2 InstalldNativeService::FLAG_FREE_CACHE_V2
 #define FLAG_FREE_CACHE_V2_DEFY_QUOTA InstalldNativeService::FLAG_FREE_CACHE_V2_DEFY_QUOTA
 #define FLAG_FREE_CACHE_DEFY_TARGET_FREE_BYTES InstalldNativeService::FLAG_FREE_CACHE_DEFY_TARGET_FREE_BYTES
+#define FLAG_FREE_CACHE_NOOP InstalldNativeService::FLAG_FREE_CACHE_NOOP
 
 int get_property(const char *key, char *value, const char *default_value) {
     return property_get(key, value, default_value);
@@ -116,6 +120,16 @@ static void setxattr(const char* path, const char* key) {
     ::setxattr(fullPath.c_str(), key, "", 0, 0);
 }
 
+static void unlink(const char* path) {
+    const std::string fullPath = StringPrintf("/data/local/tmp/user/0/%s", path);
+    ::unlink(fullPath.c_str());
+}
+
+// Lets enough time pass for directories to be trusted by the cache index.
+static void settle() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
 class CacheTest : public testing::Test {
 protected:
     InstalldNativeService* service;
@@ -389,5 +403,69 @@ TEST_F(CacheTest, FreeCache_GroupTombstone) {
     EXPECT_EQ(0, size("com.example/cache/tomb/group/dir/file2"));
 }
 
+TEST_F(CacheTest, FreeCache_IndexSeesNewEntries) {
+    LOG(INFO) << "FreeCache_IndexSeesNewEntries";
+
+    mkdir("com.example");
+    mkdir("com.example/cache");
+    mkdir("com.example/cache/foo");
+    touch("com.example/cache/foo/one", kMbInBytes, 60);
+    mkdir("com.example/cache/bar");
+    touch("com.example/cache/bar/two", kMbInBytes, 120);
+
+    // Only indexes the cache
+    service->freeCache(testUuid, kTbInBytes, FLAG_FREE_CACHE_V2 | FLAG_FREE_CACHE_V2_DEFY_QUOTA
+            | FLAG_FREE_CACHE_NOOP);
+
+    EXPECT_EQ(0, exists("com.example/cache/foo/one"));
+    EXPECT_EQ(0, exists("com.example/cache/bar/two"));
+
+    settle();
+    touch("com.example/cache/foo/old", kMbInBytes, -600);
+
+    service->freeCache(testUuid, free() + kKbInBytes,
+            FLAG_FREE_CACHE_V2 | FLAG_FREE_CACHE_V2_DEFY_QUOTA);
+
+    EXPECT_EQ(-1, exists("com.example/cache/foo/old"));
+    EXPECT_EQ(0, exists("com.example/cache/foo/one"));
+    EXPECT_EQ(0, exists("com.example/cache/bar/two"));
+
+    settle();
+    setxattr("com.example/cache/bar", "user.cache_tombstone");
+
+    service->freeCache(testUuid, kTbInBytes,
+            FLAG_FREE_CACHE_V2 | FLAG_FREE_CACHE_V2_DEFY_QUOTA);
+
+    EXPECT_EQ(-1, exists("com.example/cache/foo/one"));
+    EXPECT_EQ(0, exists("com.example/cache/bar/two"));
+    EXPECT_EQ(0, size("com.example/cache/bar/two"));
+}
+
+TEST_F(CacheTest, FreeCache_IndexSeesReplacedEntries) {
+    LOG(INFO) << "FreeCache_IndexSeesReplacedEntries";
+
+    mkdir("com.example");
+    mkdir("com.example/cache");
+    mkdir("com.example/cache/foo");
+    touch("com.example/cache/foo/one", kMbInBytes, 60);
+    touch("com.example/cache/foo/two", kMbInBytes, 120);
+
+    // Only indexes the cache
+    service->freeCache(testUuid, kTbInBytes, FLAG_FREE_CACHE_V2 | FLAG_FREE_CACHE_V2_DEFY_QUOTA
+            | FLAG_FREE_CACHE_NOOP);
+
+    settle();
+    unlink("com.example/cache/foo/one");
+    mkdir("com.example/cache/foo/one");
+    touch("com.example/cache/foo/one/inner", kMbInBytes, -600);
+
+    service->freeCache(testUuid, free() + kKbInBytes,
+            FLAG_FREE_CACHE_V2 | FLAG_FREE_CACHE_V2_DEFY_QUOTA);
+
+    EXPECT_EQ(-1, exists("com.example/cache/foo/one/inner"));
+    EXPECT_EQ(0, exists("com.example/cache/foo/one"));
+    EXPECT_EQ(0, exists("com.example/cache/foo/two"));
+}
+
 }  // namespace installd
 }  // namespace android
@@ -17,16 +17,22 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <atomic>
+
+#include <android-base/file.h>
 #include <android-base/logging.h>
 #include <android-base/scopeguard.h>
+#include <android-base/stringprintf.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "InstalldNativeService.h"
 #include "MatchExtensionGen.h"
 #include "globals.h"
+#include "tree_size.h"
 #include "utils.h"
 
 #undef LOG_TAG
@@ -48,6 +54,7 @@
 namespace android {
 namespace installd {
 
+using ::testing::ElementsAre;
 using ::testing::UnorderedElementsAre;
 
 class UtilsTest : public testing::Test {
@@ -754,5 +761,132 @@ TEST_F(UtilsTest, RemoveFileAtFd) {
     close(fd);
 }
 
+static int64_t disk_usage(const std::string& path) {
+    struct stat st;
+    EXPECT_EQ(0, lstat(path.c_str(), &st)) << path;
+    return st.st_blocks * 512;
+}
+
+TEST_F(UtilsTest, CalculateTreeSize) {
+    auto deleter = [&]() {
+        delete_dir_contents_and_dir("/data/local/tmp/user/0", true /* ignore_if_missing */);
+    };
+    auto scope_guard = android::base::make_scope_guard(deleter);
+
+    // Enough directories for the walk to be shared between threads.
+    const std::string root = "/data/local/tmp/user/0/tree";
+    ASSERT_EQ(0, system(("mkdir -p " + root).c_str()));
+    std::vector<std::string> entries = {root, root + "/link"};
+    for (int i = 0; i < 64; i++) {
+        const std::string dir = android::base::StringPrintf("%s/dir%d", root.c_str(), i);
+        const std::string file = dir + "/file";
+        ASSERT_EQ(0, mkdir(dir.c_str(), 0700));
+        ASSERT_TRUE(android::base::WriteStringToFile(std::string(4096 * (i + 1), 'x'), file));
+        entries.push_back(dir);
+        entries.push_back(file);
+    }
+    ASSERT_EQ(0, symlink("dir0/file", (root + "/link").c_str()));
+    // Hard links to a file are only counted once.
+    ASSERT_EQ(0, link((root + "/dir1/file").c_str(), (root + "/dir2/hardlink").c_str()));
+    ASSERT_EQ(0, link((root + "/dir1/file").c_str(), (root + "/dir3/hardlink").c_str()));
+    int64_t expected = 0;
+    for (const std::string& entry : entries) {
+        expected += disk_usage(entry);
+    }
+
+    int64_t size = 0;
+    ASSERT_EQ(0, calculate_tree_size(root, &size));
+    EXPECT_EQ(expected, size);
+
+    // Sizes are added to the given size, and missing trees are empty.
+    ASSERT_EQ(0, calculate_tree_size(root + "/missing", &size));
+    EXPECT_EQ(expected, size);
+}
+
+TEST_F(UtilsTest, CalculateTreeSizeFilters) {
+    auto deleter = [&]() {
+        delete_dir_contents_and_dir("/data/local/tmp/user/0", true /* ignore_if_missing */);
+    };
+    auto scope_guard = android::base::make_scope_guard(deleter);
+
+    const std::string root = "/data/local/tmp/user/0/tree";
+    const std::string app = root + "/app";
+    const std::string appFile = app + "/file";
+    const std::string systemDir = root + "/system";
+    const std::string systemFile = systemDir + "/file";
+    ASSERT_EQ(0, system(("mkdir -p " + app + " " + systemDir).c_str()));
+    ASSERT_TRUE(android::base::WriteStringToFile(std::string(8192, 'x'), appFile));
+    ASSERT_TRUE(android::base::WriteStringToFile(std::string(8192, 'x'), systemFile));
+    ASSERT_EQ(0, chown(root.c_str(), AID_SYSTEM, AID_SYSTEM));
+    ASSERT_EQ(0, chown(systemDir.c_str(), AID_SYSTEM, AID_SYSTEM));
+    ASSERT_EQ(0, chown(systemFile.c_str(), AID_SYSTEM, AID_SYSTEM));
+    // The file of the app isn't owned by it, but is still skipped along with its directory.
+    ASSERT_EQ(0, chown(app.c_str(), AID_APP_START, AID_APP_START));
+    ASSERT_EQ(0, chown(appFile.c_str(), AID_SYSTEM, AID_SYSTEM));
+
+    int64_t size = 0;
+    ASSERT_EQ(0, calculate_tree_size(root, &size, -1, -1, true /* exclude_apps */));
+    EXPECT_EQ(disk_usage(root) + disk_usage(systemDir) + disk_usage(systemFile), size);
+
+    // Entries that don't match the gid aren't counted, but their children are.
+    size = 0;
+    ASSERT_EQ(0, calculate_tree_size(root, &size, AID_SYSTEM));
+    EXPECT_EQ(disk_usage(root) + disk_usage(systemDir) + disk_usage(systemFile) +
+                      disk_usage(appFile),
+              size);
+
+    size = 0;
+    ASSERT_EQ(0, calculate_tree_size(root, &size, -1, AID_SYSTEM));
+    EXPECT_EQ(disk_usage(app), size);
+}
+
+
+TEST_F(UtilsTest, MeasureClassifiedTreeSize) {
+    auto deleter = [&]() {
+        delete_dir_contents_and_dir("/data/local/tmp/user/0", true /* ignore_if_missing */);
+    };
+    auto scope_guard = android::base::make_scope_guard(deleter);
+
+    const std::string root = "/data/local/tmp/user/0/tree";
+    const std::string androidDir = root + "/Android";
+    const std::string obb = androidDir + "/obb";
+    const std::string package = obb + "/com.example";
+    const std::string packageFile = package + "/main.obb";
+    const std::string photo = root + "/photo.jpg";
+    ASSERT_EQ(0, system(("mkdir -p " + package).c_str()));
+    ASSERT_TRUE(android::base::WriteStringToFile(std::string(8192, 'x'), packageFile));
+    ASSERT_TRUE(android::base::WriteStringToFile(std::string(4096, 'x'), photo));
+
+    // Everything below Android/obb is an app, files elsewhere are media, and the rest is other.
+    enum Category { kOther, kAndroid, kObb, kApp, kMedia, kCount };
+    std::atomic<int> rootCount = 0;
+    auto classify = [&](const tree_entry& entry) -> int {
+        if (entry.parent_category == -1) {
+            EXPECT_EQ(0, entry.level);
+            EXPECT_EQ(root, entry.name);
+            rootCount++;
+            return kOther;
+        }
+        if (entry.parent_category == kObb || entry.parent_category == kApp) {
+            return kApp;
+        } else if (entry.level == 1 && !strcmp(entry.name, "Android")) {
+            return kAndroid;
+        } else if (entry.parent_category == kAndroid && !strcmp(entry.name, "obb")) {
+            return kObb;
+        }
+        return S_ISREG(entry.stat.st_mode) ? kMedia : kOther;
+    };
+
+    std::vector<int64_t> sizes = measure_classified_tree_size(root, kCount, classify);
+    EXPECT_EQ(1, rootCount.load());
+    EXPECT_THAT(sizes,
+                ElementsAre(disk_usage(root), disk_usage(androidDir), disk_usage(obb),
+                            disk_usage(package) + disk_usage(packageFile), disk_usage(photo)));
+
+    // Missing trees are empty.
+    sizes = measure_classified_tree_size(root + "/missing", kCount, classify);
+    EXPECT_THAT(sizes, ElementsAre(0, 0, 0, 0, 0));
+}
+
 }  // namespace installd
 }  // namespace android
@@ -0,0 +1,321 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tree_size.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+#include <cutils/multiuser.h>
+#include <private/android_filesystem_config.h>
+
+using android::base::unique_fd;
+
+namespace {
+
+// Including the thread that asked for the size.
+static constexpr size_t kMaxThreads = 4;
+static constexpr size_t kDirentBufferSize = 32 * 1024;
+
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+// Threads that help the walks with many directories. Never destroyed, like installd itself.
+class WorkerPool {
+public:
+    static WorkerPool& get() {
+        static WorkerPool* pool = new WorkerPool(
+                std::min(static_cast<size_t>(std::thread::hardware_concurrency()), kMaxThreads));
+        return *pool;
+    }
+
+    // Number of threads that can run tasks, including the one that asked for the size.
+    size_t threadCount() const { return mWorkerCount + 1; }
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mLock);
+            mTasks.push_back(std::move(task));
+        }
+        mCondition.notify_one();
+    }
+
+private:
+    explicit WorkerPool(size_t threadCount) : mWorkerCount(threadCount > 1 ? threadCount - 1 : 0) {
+        for (size_t i = 0; i < mWorkerCount; i++) {
+            std::thread([this]() { loop(); }).detach();
+        }
+    }
+
+    void loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mLock);
+                mCondition.wait(lock, [this]() { return !mTasks.empty(); });
+                task = std::move(mTasks.front());
+                mTasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    const size_t mWorkerCount;
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    std::deque<std::function<void()>> mTasks;
+};
+
+using android::installd::tree_classifier;
+using android::installd::tree_entry;
+
+class TreeWalk : public std::enable_shared_from_this<TreeWalk> {
+public:
+    TreeWalk(dev_t rootDevice, int32_t includeGid, int32_t excludeGid, bool excludeApps,
+             size_t categoryCount, const tree_classifier* classifier)
+          : mRootDevice(rootDevice),
+            mIncludeGid(includeGid),
+            mExcludeGid(excludeGid),
+            mExcludeApps(excludeApps),
+            mClassifier(classifier),
+            mSizes(categoryCount, 0) {}
+
+    // Adds the size of an entry to its category, which is returned in category, and returns
+    // whether its children should be walked too.
+    bool visit(const struct stat& s, const tree_entry& entry, int* category,
+               std::vector<int64_t>* sizes) {
+        *category = mClassifier != nullptr ? (*mClassifier)(entry) : 0;
+        const int32_t user_uid = multiuser_get_app_id(s.st_uid);
+        const int32_t user_gid = multiuser_get_app_id(s.st_gid);
+        if (mExcludeApps && ((user_uid >= AID_APP_START && user_uid <= AID_APP_END)
+                || (user_gid >= AID_CACHE_GID_START && user_gid <= AID_CACHE_GID_END)
+                || (user_gid >= AID_SHARED_GID_START && user_gid <= AID_SHARED_GID_END))) {
+            // Don't traverse inside or measure
+            return false;
+        }
+        const int32_t gid = s.st_gid;
+        if ((mIncludeGid == -1 || gid == mIncludeGid) && (mExcludeGid == -1 || gid != mExcludeGid)
+                && isFirstLink(s)) {
+            (*sizes)[*category] += s.st_blocks * 512;
+        }
+        return S_ISDIR(s.st_mode) && s.st_dev == mRootDevice;
+    }
+
+    // Walks the root directory at path, which has the given category, and returns the size of each
+    // category of its children.
+    const std::vector<int64_t>& walk(const std::string& path, int category) {
+        std::unique_lock<std::mutex> lock(mLock);
+        mDirectories.push_back({nullptr, path, 0, category});
+        while (true) {
+            if (!mDirectories.empty()) {
+                readNextDirectory(lock);
+            } else if (mReading == 0) {
+                return mSizes;
+            } else {
+                // Another thread may still find more directories.
+                mCondition.wait(lock);
+            }
+        }
+    }
+
+private:
+    struct Directory {
+        // The parent directory, which is kept open until all its children have been opened.
+        std::shared_ptr<unique_fd> parent;
+        std::string name;
+        int level;
+        int category;
+    };
+
+    bool isFirstLink(const struct stat& s) {
+        if (S_ISDIR(s.st_mode) || s.st_nlink <= 1) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(mLinksLock);
+        return mLinks.emplace(s.st_dev, s.st_ino).second;
+    }
+
+    // Called with mLock held, which is released while reading the directory.
+    void readNextDirectory(std::unique_lock<std::mutex>& lock) {
+        Directory directory = std::move(mDirectories.back());
+        mDirectories.pop_back();
+        mReading++;
+        lock.unlock();
+
+        std::vector<Directory> children;
+        std::vector<int64_t> sizes(mSizes.size(), 0);
+        readDirectory(directory, &children, &sizes);
+
+        lock.lock();
+        mReading--;
+        for (size_t i = 0; i < sizes.size(); i++) {
+            mSizes[i] += sizes[i];
+        }
+        for (Directory& child : children) {
+            mDirectories.push_back(std::move(child));
+        }
+        if (!mDirectories.empty()) {
+            mCondition.notify_one();
+            requestHelpLocked();
+        } else if (mReading == 0) {
+            mCondition.notify_all();
+        }
+    }
+
+    void readDirectory(const Directory& directory, std::vector<Directory>* children,
+                       std::vector<int64_t>* sizes) {
+        const int parentFd = directory.parent ? directory.parent->get() : AT_FDCWD;
+        auto fd = std::make_shared<unique_fd>(
+                openat(parentFd, directory.name.c_str(),
+                       O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOFOLLOW));
+        if (fd->get() < 0) {
+            // The directory itself was already counted, as fts does for directories it can't read.
+            return;
+        }
+
+        char buffer[kDirentBufferSize];
+        while (true) {
+            const long count = syscall(SYS_getdents64, fd->get(), buffer, sizeof(buffer));
+            if (count <= 0) {
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            for (long offset = 0; offset < count;) {
+                const auto* entry = reinterpret_cast<const linux_dirent64*>(buffer + offset);
+                offset += entry->d_reclen;
+                const char* name = entry->d_name;
+                if (!strcmp(name, ".") || !strcmp(name, "..")) {
+                    continue;
+                }
+                struct stat s;
+                if (fstatat(fd->get(), name, &s, AT_SYMLINK_NOFOLLOW) != 0) {
+                    continue;
+                }
+                const tree_entry treeEntry{directory.level + 1, name, s, directory.category};
+                int category;
+                if (visit(s, treeEntry, &category, sizes)) {
+                    children->push_back({fd, name, directory.level + 1, category});
+                }
+            }
+        }
+    }
+
+    // Asks an idle thread of the pool to read directories too, if there are enough of them.
+    void requestHelpLocked() {
+        WorkerPool& pool = WorkerPool::get();
+        // Each thread reading the tree can be one of the walkers.
+        if (mDirectories.size() < 2 || mHelpers + 1 >= pool.threadCount()) {
+            return;
+        }
+        mHelpers++;
+        pool.post([walk = shared_from_this()]() { walk->help(); });
+    }
+
+    void help() {
+        std::unique_lock<std::mutex> lock(mLock);
+        while (!mDirectories.empty()) {
+            readNextDirectory(lock);
+        }
+        mHelpers--;
+    }
+
+    const dev_t mRootDevice;
+    const int32_t mIncludeGid;
+    const int32_t mExcludeGid;
+    const bool mExcludeApps;
+    const tree_classifier* const mClassifier;
+
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    // Directories left to read, read deepest first.
+    std::vector<Directory> mDirectories;
+    // Number of threads reading directories, and number of helpers from the pool.
+    size_t mReading = 0;
+    size_t mHelpers = 0;
+    std::vector<int64_t> mSizes;
+
+    // Files with several links that were already counted.
+    std::mutex mLinksLock;
+    std::set<std::pair<dev_t, ino_t>> mLinks;
+};
+
+// Returns the sizes of the categories of the tree at path, or only zeroes if it doesn't exist.
+std::vector<int64_t> measureTree(const std::string& path, int32_t includeGid, int32_t excludeGid,
+                                 bool excludeApps, size_t categoryCount,
+                                 const tree_classifier* classifier) {
+    std::vector<int64_t> sizes(categoryCount, 0);
+    struct stat s;
+    if (lstat(path.c_str(), &s) != 0) {
+        if (errno != ENOENT) {
+            PLOG(ERROR) << "Failed to stat " << path;
+        }
+        return sizes;
+    }
+    auto walk = std::make_shared<TreeWalk>(s.st_dev, includeGid, excludeGid, excludeApps,
+                                           categoryCount, classifier);
+    const tree_entry root{0, path.c_str(), s, -1};
+    int category;
+    if (walk->visit(s, root, &category, &sizes)) {
+        const std::vector<int64_t>& childSizes = walk->walk(path, category);
+        for (size_t i = 0; i < categoryCount; i++) {
+            sizes[i] += childSizes[i];
+        }
+    }
+    return sizes;
+}
+
+} // namespace
+
+namespace android {
+namespace installd {
+
+int64_t measure_tree_size(const std::string& path, int32_t include_gid, int32_t exclude_gid,
+                          bool exclude_apps) {
+    return measureTree(path, include_gid, exclude_gid, exclude_apps, 1, nullptr)[0];
+}
+
+std::vector<int64_t> measure_classified_tree_size(const std::string& path, size_t category_count,
+                                                  const tree_classifier& classifier) {
+    return measureTree(path, -1, -1, false, category_count, &classifier);
+}
+
+} // namespace installd
+} // namespace android
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_INSTALLD_TREE_SIZE_H
+#define ANDROID_INSTALLD_TREE_SIZE_H
+
+#include <stdint.h>
+#include <sys/stat.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace android {
+namespace installd {
+
+// Returns the disk usage in bytes of the tree at path, which is 0 if path doesn't exist. Every
+// entry is counted, without following symbolic links or crossing mount points, as with
+// fts_open(FTS_PHYSICAL | FTS_XDEV), except that files with several hard links in the tree are
+// only counted once. Directories are read by a small pool of threads shared by all the walks.
+//
+// If exclude_apps is set, entries owned by apps are neither counted nor walked. Entries whose gid
+// is not include_gid, or is exclude_gid, are not counted, but their children are.
+int64_t measure_tree_size(const std::string& path, int32_t include_gid = -1,
+                          int32_t exclude_gid = -1, bool exclude_apps = false);
+
+// An entry found by measure_classified_tree_size.
+struct tree_entry {
+    // Depth of the entry below the root of the walk, which is at level 0.
+    int level;
+    // Name of the entry, or the path that was given for the root.
+    const char* name;
+    const struct stat& stat;
+    // Category of the parent directory, or -1 for the root.
+    int parent_category;
+};
+
+// Returns the category of an entry, in [0, category_count). The entry's size is added to that
+// category, and the children of a directory are given its category as parent_category. This is
+// called by several threads at once.
+using tree_classifier = std::function<int(const tree_entry& entry)>;
+
+// Walks the tree at path like measure_tree_size, without any filter, and returns the disk usage in
+// bytes of each of the category_count categories that classifier puts the entries in.
+std::vector<int64_t> measure_classified_tree_size(const std::string& path, size_t category_count,
+                                                  const tree_classifier& classifier);
+
+} // namespace installd
+} // namespace android
+
+#endif // ANDROID_INSTALLD_TREE_SIZE_H
@@ -30,6 +30,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <android-base/chrono_utils.h>
 #include <android-base/result.h>
@@ -271,6 +272,22 @@ public:
      */
     status_t sendMessage(const InputMessage* msg);
 
+    /* Send several messages to the other endpoint, in order, using as few system calls as
+     * possible.
+     *
+     * Messages are sent atomically, one at a time: each message has either been sent in its
+     * entirety or not at all. If the channel fills up part way through, the remaining messages
+     * are not sent. Try again after the consumer has sent a finished signal.
+     *
+     * outSentCount is set to the number of messages that were sent, even on error.
+     *
+     * Return OK if all of the messages were sent.
+     * Return WOULD_BLOCK if the channel is full.
+     * Return DEAD_OBJECT if the channel's peer has been closed.
+     * Other errors probably indicate that the channel is broken.
+     */
+    status_t sendMessages(const InputMessage* msgs, size_t count, size_t& outSentCount);
+
     /* Receive a message sent by the other endpoint.
      *
      * If there is no message present, try again after poll() indicates that the fd
@@ -341,6 +358,28 @@ public:
     /* Gets the underlying input channel. */
     inline std::shared_ptr<InputChannel> getChannel() { return mChannel; }
 
+    /* Starts a batch of events.
+     *
+     * Until endBatch() is called, published events are validated and queued instead of being
+     * written to the input channel, and the publish methods return OK for every queued event.
+     * Use this when several events are ready to be published at once, so that they can be sent
+     * with a single system call.
+     */
+    void beginBatch();
+
+    /* Sends all of the events queued since beginBatch() to the input channel, in order, and ends
+     * the batch.
+     *
+     * outPublishedCount is set to the number of queued events that were published. Events that
+     * were not published have not been sent at all and may be published again later.
+     *
+     * Returns OK if all of the queued events were published.
+     * Returns WOULD_BLOCK if the channel is full.
+     * Returns DEAD_OBJECT if the channel's peer has been closed.
+     * Other errors probably indicate that the channel is broken.
+     */
+    status_t endBatch(size_t& outPublishedCount);
+
     /* Publishes a key event to the input channel.
      *
      * Returns OK on success.
@@ -446,6 +485,13 @@ public:
 private:
     std::shared_ptr<InputChannel> mChannel;
     InputVerifier mInputVerifier;
+
+    // Events queued between beginBatch() and endBatch(). The storage is reused across batches.
+    bool mBatching = false;
+    std::vector<InputMessage> mBatch;
+
+    status_t sendMessage(const InputMessage& msg);
+    void verifyMotionMessage(const InputMessage& msg);
 };
 
 /*
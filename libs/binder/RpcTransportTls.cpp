@@ -18,6 +18,7 @@
 #include <log/log.h>
 
 #include <poll.h>
+#include <string.h>
 #include <sys/socket.h>
 
 #include <openssl/bn.h>
@@ -301,6 +302,9 @@ public:
     bool isWaiting() override { return mSocket.isInPollingState(); };
 
 private:
+    status_t writeFully(FdTrigger* fdTrigger, const uint8_t* buffer, size_t size,
+                        const std::optional<SmallFunction<status_t()>>& altPoll);
+
     android::RpcTransportFd mSocket;
     Ssl mSsl;
 };
@@ -324,6 +328,29 @@ status_t RpcTransportTls::pollRead(void) {
     return OK;
 }
 
+status_t RpcTransportTls::writeFully(FdTrigger* fdTrigger, const uint8_t* buffer, size_t size,
+                                     const std::optional<SmallFunction<status_t()>>& altPoll) {
+    const uint8_t* end = buffer + size;
+    while (buffer < end) {
+        size_t todo = std::min<size_t>(end - buffer, std::numeric_limits<int>::max());
+        auto [writeSize, errorQueue] = mSsl.call(SSL_write, buffer, todo);
+        if (writeSize > 0) {
+            buffer += writeSize;
+            errorQueue.clear();
+            continue;
+        }
+        // SSL_write() should never return 0 unless BIO_write were to return 0.
+        int sslError = mSsl.getError(writeSize);
+        // TODO(b/195788248): BIO should contain the FdTrigger, and send(2) / recv(2) should be
+        //   triggerablePoll()-ed. Then additionalEvent is no longer necessary.
+        status_t pollStatus = errorQueue.pollForSslError(mSocket, sslError, fdTrigger,
+                                                         "SSL_write", POLLIN, altPoll);
+        if (pollStatus != OK) return pollStatus;
+        // Do not advance buffer. Try SSL_write() again.
+    }
+    return OK;
+}
+
 status_t RpcTransportTls::interruptableWriteFully(
         FdTrigger* fdTrigger, iovec* iovs, int niovs,
         const std::optional<SmallFunction<status_t()>>& altPoll,
@@ -338,6 +365,13 @@ status_t RpcTransportTls::interruptableWriteFully(
     // once. The trigger is also checked via triggerablePoll() after every SSL_write().
     if (fdTrigger->isTriggered()) return DEAD_OBJECT;
 
+    // Every SSL_write() produces its own TLS record and send(2), so the small headers that
+    // precede and follow a Parcel are gathered into one write. Larger vectors, such as the Parcel
+    // data itself, are written from where they are without being copied.
+    constexpr size_t kMaxGatheredSize = 512;
+    uint8_t gathered[kMaxGatheredSize];
+    size_t gatheredSize = 0;
+
     size_t size = 0;
     for (int i = 0; i < niovs; i++) {
         const iovec& iov = iovs[i];
@@ -347,23 +381,31 @@ status_t RpcTransportTls::interruptableWriteFully(
         size += iov.iov_len;
 
         auto buffer = reinterpret_cast<const uint8_t*>(iov.iov_base);
-        const uint8_t* end = buffer + iov.iov_len;
-        while (buffer < end) {
-            size_t todo = std::min<size_t>(end - buffer, std::numeric_limits<int>::max());
-            auto [writeSize, errorQueue] = mSsl.call(SSL_write, buffer, todo);
-            if (writeSize > 0) {
-                buffer += writeSize;
-                errorQueue.clear();
-                continue;
+        if (iov.iov_len <= kMaxGatheredSize - gatheredSize) {
+            memcpy(gathered + gatheredSize, buffer, iov.iov_len);
+            gatheredSize += iov.iov_len;
+            continue;
+        }
+        if (gatheredSize > 0) {
+            if (status_t status = writeFully(fdTrigger, gathered, gatheredSize, altPoll);
+                status != OK) {
+                return status;
             }
-            // SSL_write() should never return 0 unless BIO_write were to return 0.
-            int sslError = mSsl.getError(writeSize);
-            // TODO(b/195788248): BIO should contain the FdTrigger, and send(2) / recv(2) should be
-            //   triggerablePoll()-ed. Then additionalEvent is no longer necessary.
-            status_t pollStatus = errorQueue.pollForSslError(mSocket, sslError, fdTrigger,
-                                                             "SSL_write", POLLIN, altPoll);
-            if (pollStatus != OK) return pollStatus;
-            // Do not advance buffer. Try SSL_write() again.
+            gatheredSize = 0;
+        }
+        if (iov.iov_len <= kMaxGatheredSize) {
+            memcpy(gathered, buffer, iov.iov_len);
+            gatheredSize = iov.iov_len;
+            continue;
+        }
+        if (status_t status = writeFully(fdTrigger, buffer, iov.iov_len, altPoll); status != OK) {
+            return status;
+        }
+    }
+    if (gatheredSize > 0) {
+        if (status_t status = writeFully(fdTrigger, gathered, gatheredSize, altPoll);
+            status != OK) {
+            return status;
         }
     }
     LOG_TLS_DETAIL("TLS: Sent %zu bytes!", size);
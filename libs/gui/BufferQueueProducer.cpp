@@ -94,7 +94,24 @@ status_t BufferQueueProducer::requestBuffer(int slot, sp<GraphicBuffer>* buf) {
     ATRACE_CALL();
     BQ_LOGV("requestBuffer: slot %d", slot);
     std::lock_guard<std::mutex> lock(mCore->mMutex);
+    return requestBufferLocked(slot, buf);
+}
+
+status_t BufferQueueProducer::requestBuffers(const std::vector<int32_t>& slots,
+                                             std::vector<RequestBufferOutput>* outputs) {
+    ATRACE_CALL();
+    BQ_LOGV("requestBuffers: %zu slots", slots.size());
+    outputs->clear();
+    outputs->reserve(slots.size());
+    std::lock_guard<std::mutex> lock(mCore->mMutex);
+    for (int32_t slot : slots) {
+        RequestBufferOutput& output = outputs->emplace_back();
+        output.result = requestBufferLocked(static_cast<int>(slot), &output.buffer);
+    }
+    return NO_ERROR;
+}
 
+status_t BufferQueueProducer::requestBufferLocked(int slot, sp<GraphicBuffer>* buf) {
     if (mCore->mIsAbandoned) {
         BQ_LOGE("requestBuffer: BufferQueue has been abandoned");
         return NO_INIT;
@@ -388,6 +405,247 @@ status_t BufferQueueProducer::waitForFreeSlotThenRelock(FreeSlotCaller caller,
     return NO_ERROR;
 }
 
+struct BufferQueueProducer::DequeuedSlot {
+    // Requested buffer attributes. dequeueSlotLocked replaces the defaults
+    // (zero size and format) with the BufferQueue's defaults and adds the
+    // consumer usage bits.
+    uint32_t width = 0;
+    uint32_t height = 0;
+    PixelFormat format = 0;
+    uint64_t usage = 0;
+
+    int slot = BufferQueueCore::INVALID_BUFFER_SLOT;
+    sp<Fence> fence = Fence::NO_FENCE;
+    status_t returnFlags = NO_ERROR;
+    uint64_t bufferAge = 0;
+    bool attachedByConsumer = false;
+    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    EGLSyncKHR eglFence = EGL_NO_SYNC_KHR;
+
+    bool callOnFrameDequeued = false;
+    uint64_t bufferId = 0; // Only used if callOnFrameDequeued == true
+};
+
+status_t BufferQueueProducer::dequeueSlotLocked(std::unique_lock<std::mutex>& lock,
+                                                DequeuedSlot* dequeued) {
+    // If we don't have a free buffer, but we are currently allocating, we wait until allocation
+    // is finished such that we don't allocate in parallel.
+    if (mCore->mFreeBuffers.empty() && mCore->mIsAllocating) {
+        mDequeueWaitingForAllocation = true;
+        mCore->waitWhileAllocatingLocked(lock);
+        mDequeueWaitingForAllocation = false;
+        mDequeueWaitingForAllocationCondition.notify_all();
+    }
+
+    uint32_t& width = dequeued->width;
+    uint32_t& height = dequeued->height;
+    PixelFormat& format = dequeued->format;
+    uint64_t& usage = dequeued->usage;
+
+    if (format == 0) {
+        format = mCore->mDefaultBufferFormat;
+    }
+
+    // Enable the usage bits the consumer requested
+    usage |= mCore->mConsumerUsageBits;
+
+    const bool useDefaultSize = !width && !height;
+    if (useDefaultSize) {
+        width = mCore->mDefaultWidth;
+        height = mCore->mDefaultHeight;
+        if (mCore->mAutoPrerotation &&
+            (mCore->mTransformHintInUse & NATIVE_WINDOW_TRANSFORM_ROT_90)) {
+            std::swap(width, height);
+        }
+    }
+
+    int found = BufferItem::INVALID_BUFFER_SLOT;
+    while (found == BufferItem::INVALID_BUFFER_SLOT) {
+        status_t status = waitForFreeSlotThenRelock(FreeSlotCaller::Dequeue, lock, &found);
+        if (status != NO_ERROR) {
+            return status;
+        }
+
+        // This should not happen
+        if (found == BufferQueueCore::INVALID_BUFFER_SLOT) {
+            BQ_LOGE("dequeueBuffer: no available buffer slots");
+            return -EBUSY;
+        }
+
+        const sp<GraphicBuffer>& buffer(mSlots[found].mGraphicBuffer);
+
+        // If we are not allowed to allocate new buffers,
+        // waitForFreeSlotThenRelock must have returned a slot containing a
+        // buffer. If this buffer would require reallocation to meet the
+        // requested attributes, we free it and attempt to get another one.
+        if (!mCore->mAllowAllocation) {
+            if (buffer->needsReallocation(width, height, format, BQ_LAYER_COUNT, usage)) {
+                if (mCore->mSharedBufferSlot == found) {
+                    BQ_LOGE("dequeueBuffer: cannot re-allocate a sharedbuffer");
+                    return BAD_VALUE;
+                }
+                mCore->mFreeSlots.insert(found);
+                mCore->clearBufferSlotLocked(found);
+                found = BufferItem::INVALID_BUFFER_SLOT;
+                continue;
+            }
+        }
+    }
+
+    const sp<GraphicBuffer>& buffer(mSlots[found].mGraphicBuffer);
+    if (mCore->mSharedBufferSlot == found &&
+            buffer->needsReallocation(width, height, format, BQ_LAYER_COUNT, usage)) {
+        BQ_LOGE("dequeueBuffer: cannot re-allocate a shared"
+                "buffer");
+
+        return BAD_VALUE;
+    }
+
+    if (mCore->mSharedBufferSlot != found) {
+        mCore->mActiveBuffers.insert(found);
+    }
+    dequeued->slot = found;
+    ATRACE_BUFFER_INDEX(found);
+
+    dequeued->attachedByConsumer = mSlots[found].mNeedsReallocation;
+    mSlots[found].mNeedsReallocation = false;
+
+    mSlots[found].mBufferState.dequeue();
+
+    if ((buffer == nullptr) ||
+            buffer->needsReallocation(width, height, format, BQ_LAYER_COUNT, usage))
+    {
+        if (CC_UNLIKELY(ATRACE_ENABLED())) {
+            if (buffer == nullptr) {
+                ATRACE_FORMAT_INSTANT("%s buffer reallocation: null", mConsumerName.c_str());
+            } else {
+                ATRACE_FORMAT_INSTANT("%s buffer reallocation actual %dx%d format:%d "
+                                      "layerCount:%d "
+                                      "usage:%d requested: %dx%d format:%d layerCount:%d "
+                                      "usage:%d ",
+                                      mConsumerName.c_str(), width, height, format,
+                                      BQ_LAYER_COUNT, usage, buffer->getWidth(),
+                                      buffer->getHeight(), buffer->getPixelFormat(),
+                                      buffer->getLayerCount(), buffer->getUsage());
+            }
+        }
+        mSlots[found].mAcquireCalled = false;
+        mSlots[found].mGraphicBuffer = nullptr;
+        mSlots[found].mRequestBufferCalled = false;
+        mSlots[found].mEglDisplay = EGL_NO_DISPLAY;
+        mSlots[found].mEglFence = EGL_NO_SYNC_KHR;
+        mSlots[found].mFence = Fence::NO_FENCE;
+        mCore->mBufferAge = 0;
+
+        dequeued->returnFlags |= BUFFER_NEEDS_REALLOCATION;
+    } else {
+        // We add 1 because that will be the frame number when this buffer
+        // is queued
+        mCore->mBufferAge = mCore->mFrameCounter + 1 - mSlots[found].mFrameNumber;
+    }
+    dequeued->bufferAge = mCore->mBufferAge;
+
+    BQ_LOGV("dequeueBuffer: setting buffer age to %" PRIu64,
+            mCore->mBufferAge);
+
+    if (CC_UNLIKELY(mSlots[found].mFence == nullptr)) {
+        BQ_LOGE("dequeueBuffer: about to return a NULL fence - "
+                "slot=%d w=%d h=%d format=%u",
+                found, buffer->width, buffer->height, buffer->format);
+    }
+
+    dequeued->eglDisplay = mSlots[found].mEglDisplay;
+    dequeued->eglFence = mSlots[found].mEglFence;
+    // Don't return a fence in shared buffer mode, except for the first
+    // frame.
+    dequeued->fence = (mCore->mSharedBufferMode &&
+            mCore->mSharedBufferSlot == found) ?
+            Fence::NO_FENCE : mSlots[found].mFence;
+    mSlots[found].mEglFence = EGL_NO_SYNC_KHR;
+    mSlots[found].mFence = Fence::NO_FENCE;
+
+    // If shared buffer mode has just been enabled, cache the slot of the
+    // first buffer that is dequeued and mark it as the shared buffer.
+    if (mCore->mSharedBufferMode && mCore->mSharedBufferSlot ==
+            BufferQueueCore::INVALID_BUFFER_SLOT) {
+        mCore->mSharedBufferSlot = found;
+        mSlots[found].mBufferState.mShared = true;
+    }
+
+    if (!(dequeued->returnFlags & BUFFER_NEEDS_REALLOCATION)) {
+        dequeued->callOnFrameDequeued = true;
+        dequeued->bufferId = mSlots[found].mGraphicBuffer->getId();
+    }
+
+    return NO_ERROR;
+}
+
+sp<GraphicBuffer> BufferQueueProducer::allocateDequeuedBuffer(
+        const DequeuedSlot& dequeued) const {
+    BQ_LOGV("dequeueBuffer: allocating a new buffer for slot %d", dequeued.slot);
+    return new GraphicBuffer(dequeued.width, dequeued.height, dequeued.format, BQ_LAYER_COUNT,
+                             dequeued.usage, {mConsumerName.c_str(), mConsumerName.size()});
+}
+
+status_t BufferQueueProducer::installDequeuedBufferLocked(
+        DequeuedSlot* dequeued, const sp<GraphicBuffer>& graphicBuffer) {
+    status_t error = graphicBuffer->initCheck();
+    const int slot = dequeued->slot;
+
+    if (error == NO_ERROR && !mCore->mIsAbandoned) {
+        graphicBuffer->setGenerationNumber(mCore->mGenerationNumber);
+        mSlots[slot].mGraphicBuffer = graphicBuffer;
+        dequeued->callOnFrameDequeued = true;
+        dequeued->bufferId = graphicBuffer->getId();
+    }
+
+    if (error != NO_ERROR) {
+        mCore->mFreeSlots.insert(slot);
+        mCore->clearBufferSlotLocked(slot);
+        BQ_LOGE("dequeueBuffer: createGraphicBuffer failed");
+        return error;
+    }
+
+    if (mCore->mIsAbandoned) {
+        mCore->mFreeSlots.insert(slot);
+        mCore->clearBufferSlotLocked(slot);
+        BQ_LOGE("dequeueBuffer: BufferQueue has been abandoned");
+        return NO_INIT;
+    }
+
+    return NO_ERROR;
+}
+
+status_t BufferQueueProducer::finishDequeue(DequeuedSlot* dequeued) {
+    if (dequeued->attachedByConsumer) {
+        dequeued->returnFlags |= BUFFER_NEEDS_REALLOCATION;
+    }
+
+    if (dequeued->eglFence != EGL_NO_SYNC_KHR) {
+        EGLint result = eglClientWaitSyncKHR(dequeued->eglDisplay, dequeued->eglFence, 0,
+                1000000000);
+        // If something goes wrong, log the error, but return the buffer without
+        // synchronizing access to it. It's too late at this point to abort the
+        // dequeue operation.
+        if (result == EGL_FALSE) {
+            BQ_LOGE("dequeueBuffer: error %#x waiting for fence",
+                    eglGetError());
+        } else if (result == EGL_TIMEOUT_EXPIRED_KHR) {
+            BQ_LOGE("dequeueBuffer: timeout waiting for fence");
+        }
+        eglDestroySyncKHR(dequeued->eglDisplay, dequeued->eglFence);
+        dequeued->eglFence = EGL_NO_SYNC_KHR;
+    }
+
+    BQ_LOGV("dequeueBuffer: returning slot=%d/%" PRIu64 " buf=%p flags=%#x",
+            dequeued->slot,
+            mSlots[dequeued->slot].mFrameNumber,
+            mSlots[dequeued->slot].mGraphicBuffer != nullptr ?
+            mSlots[dequeued->slot].mGraphicBuffer->handle : nullptr, dequeued->returnFlags);
+
+    return dequeued->returnFlags;
+}
+
 status_t BufferQueueProducer::dequeueBuffer(int* outSlot, sp<android::Fence>* outFence,
                                             uint32_t width, uint32_t height, PixelFormat format,
                                             uint64_t usage, uint64_t* outBufferAge,
@@ -415,238 +673,182 @@ status_t BufferQueueProducer::dequeueBuffer(int* outSlot, sp<android::Fence>* ou
         return BAD_VALUE;
     }
 
-    status_t returnFlags = NO_ERROR;
-    EGLDisplay eglDisplay = EGL_NO_DISPLAY;
-    EGLSyncKHR eglFence = EGL_NO_SYNC_KHR;
-    bool attachedByConsumer = false;
+    DequeuedSlot dequeued;
+    dequeued.width = width;
+    dequeued.height = height;
+    dequeued.format = format;
+    dequeued.usage = usage;
 
     sp<IConsumerListener> listener;
-    bool callOnFrameDequeued = false;
-    uint64_t bufferId = 0; // Only used if callOnFrameDequeued == true
     { // Autolock scope
         std::unique_lock<std::mutex> lock(mCore->mMutex);
 
-        // If we don't have a free buffer, but we are currently allocating, we wait until allocation
-        // is finished such that we don't allocate in parallel.
-        if (mCore->mFreeBuffers.empty() && mCore->mIsAllocating) {
-            mDequeueWaitingForAllocation = true;
-            mCore->waitWhileAllocatingLocked(lock);
-            mDequeueWaitingForAllocation = false;
-            mDequeueWaitingForAllocationCondition.notify_all();
+        status_t status = dequeueSlotLocked(lock, &dequeued);
+        if (status != NO_ERROR) {
+            return status;
         }
 
-        if (format == 0) {
-            format = mCore->mDefaultBufferFormat;
+        if (dequeued.returnFlags & BUFFER_NEEDS_REALLOCATION) {
+            mCore->mIsAllocating = true;
         }
 
-        // Enable the usage bits the consumer requested
-        usage |= mCore->mConsumerUsageBits;
+        listener = mCore->mConsumerListener;
+    } // Autolock scope
 
-        const bool useDefaultSize = !width && !height;
-        if (useDefaultSize) {
-            width = mCore->mDefaultWidth;
-            height = mCore->mDefaultHeight;
-            if (mCore->mAutoPrerotation &&
-                (mCore->mTransformHintInUse & NATIVE_WINDOW_TRANSFORM_ROT_90)) {
-                std::swap(width, height);
-            }
-        }
+    *outSlot = dequeued.slot;
+    *outFence = dequeued.fence;
 
-        int found = BufferItem::INVALID_BUFFER_SLOT;
-        while (found == BufferItem::INVALID_BUFFER_SLOT) {
-            status_t status = waitForFreeSlotThenRelock(FreeSlotCaller::Dequeue, lock, &found);
-            if (status != NO_ERROR) {
-                return status;
-            }
+    if (dequeued.returnFlags & BUFFER_NEEDS_REALLOCATION) {
+        sp<GraphicBuffer> graphicBuffer = allocateDequeuedBuffer(dequeued);
 
-            // This should not happen
-            if (found == BufferQueueCore::INVALID_BUFFER_SLOT) {
-                BQ_LOGE("dequeueBuffer: no available buffer slots");
-                return -EBUSY;
-            }
+        { // Autolock scope
+            std::lock_guard<std::mutex> lock(mCore->mMutex);
 
-            const sp<GraphicBuffer>& buffer(mSlots[found].mGraphicBuffer);
+            status_t error = installDequeuedBufferLocked(&dequeued, graphicBuffer);
 
-            // If we are not allowed to allocate new buffers,
-            // waitForFreeSlotThenRelock must have returned a slot containing a
-            // buffer. If this buffer would require reallocation to meet the
-            // requested attributes, we free it and attempt to get another one.
-            if (!mCore->mAllowAllocation) {
-                if (buffer->needsReallocation(width, height, format, BQ_LAYER_COUNT, usage)) {
-                    if (mCore->mSharedBufferSlot == found) {
-                        BQ_LOGE("dequeueBuffer: cannot re-allocate a sharedbuffer");
-                        return BAD_VALUE;
-                    }
-                    mCore->mFreeSlots.insert(found);
-                    mCore->clearBufferSlotLocked(found);
-                    found = BufferItem::INVALID_BUFFER_SLOT;
-                    continue;
-                }
+            mCore->mIsAllocating = false;
+            mCore->mIsAllocatingCondition.notify_all();
+
+            if (error != NO_ERROR) {
+                return error;
             }
-        }
 
-        const sp<GraphicBuffer>& buffer(mSlots[found].mGraphicBuffer);
-        if (mCore->mSharedBufferSlot == found &&
-                buffer->needsReallocation(width, height, format, BQ_LAYER_COUNT, usage)) {
-            BQ_LOGE("dequeueBuffer: cannot re-allocate a shared"
-                    "buffer");
+            VALIDATE_CONSISTENCY();
+        } // Autolock scope
+    }
 
-            return BAD_VALUE;
-        }
+    if (listener != nullptr && dequeued.callOnFrameDequeued) {
+        listener->onFrameDequeued(dequeued.bufferId);
+    }
 
-        if (mCore->mSharedBufferSlot != found) {
-            mCore->mActiveBuffers.insert(found);
-        }
-        *outSlot = found;
-        ATRACE_BUFFER_INDEX(found);
+    status_t returnFlags = finishDequeue(&dequeued);
 
-        attachedByConsumer = mSlots[found].mNeedsReallocation;
-        mSlots[found].mNeedsReallocation = false;
+    if (outBufferAge) {
+        *outBufferAge = dequeued.bufferAge;
+    }
+    addAndGetFrameTimestamps(nullptr, outTimestamps);
 
-        mSlots[found].mBufferState.dequeue();
+    return returnFlags;
+}
 
-        if ((buffer == nullptr) ||
-                buffer->needsReallocation(width, height, format, BQ_LAYER_COUNT, usage))
-        {
-            if (CC_UNLIKELY(ATRACE_ENABLED())) {
-                if (buffer == nullptr) {
-                    ATRACE_FORMAT_INSTANT("%s buffer reallocation: null", mConsumerName.c_str());
-                } else {
-                    ATRACE_FORMAT_INSTANT("%s buffer reallocation actual %dx%d format:%d "
-                                          "layerCount:%d "
-                                          "usage:%d requested: %dx%d format:%d layerCount:%d "
-                                          "usage:%d ",
-                                          mConsumerName.c_str(), width, height, format,
-                                          BQ_LAYER_COUNT, usage, buffer->getWidth(),
-                                          buffer->getHeight(), buffer->getPixelFormat(),
-                                          buffer->getLayerCount(), buffer->getUsage());
-                }
-            }
-            mSlots[found].mAcquireCalled = false;
-            mSlots[found].mGraphicBuffer = nullptr;
-            mSlots[found].mRequestBufferCalled = false;
-            mSlots[found].mEglDisplay = EGL_NO_DISPLAY;
-            mSlots[found].mEglFence = EGL_NO_SYNC_KHR;
-            mSlots[found].mFence = Fence::NO_FENCE;
-            mCore->mBufferAge = 0;
-            mCore->mIsAllocating = true;
+status_t BufferQueueProducer::dequeueBuffers(const std::vector<DequeueBufferInput>& inputs,
+                                             std::vector<DequeueBufferOutput>* outputs) {
+    ATRACE_CALL();
+    BQ_LOGV("dequeueBuffers: %zu buffers", inputs.size());
 
-            returnFlags |= BUFFER_NEEDS_REALLOCATION;
-        } else {
-            // We add 1 because that will be the frame number when this buffer
-            // is queued
-            mCore->mBufferAge = mCore->mFrameCounter + 1 - mSlots[found].mFrameNumber;
-        }
+    outputs->clear();
+    outputs->resize(inputs.size());
+    std::vector<DequeuedSlot> dequeued(inputs.size());
 
-        BQ_LOGV("dequeueBuffer: setting buffer age to %" PRIu64,
-                mCore->mBufferAge);
+    size_t allocationCount = 0;
+    sp<IConsumerListener> listener;
+    { // Autolock scope
+        std::unique_lock<std::mutex> lock(mCore->mMutex);
+        mConsumerName = mCore->mConsumerName;
 
-        if (CC_UNLIKELY(mSlots[found].mFence == nullptr)) {
-            BQ_LOGE("dequeueBuffer: about to return a NULL fence - "
-                    "slot=%d w=%d h=%d format=%u",
-                    found, buffer->width, buffer->height, buffer->format);
+        // Every dequeue returns the same slot in shared buffer mode, so there
+        // is nothing to gain from batching it.
+        if (mCore->mSharedBufferMode) {
+            lock.unlock();
+            return IGraphicBufferProducer::dequeueBuffers(inputs, outputs);
         }
 
-        eglDisplay = mSlots[found].mEglDisplay;
-        eglFence = mSlots[found].mEglFence;
-        // Don't return a fence in shared buffer mode, except for the first
-        // frame.
-        *outFence = (mCore->mSharedBufferMode &&
-                mCore->mSharedBufferSlot == found) ?
-                Fence::NO_FENCE : mSlots[found].mFence;
-        mSlots[found].mEglFence = EGL_NO_SYNC_KHR;
-        mSlots[found].mFence = Fence::NO_FENCE;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const DequeueBufferInput& input = inputs[i];
+            DequeueBufferOutput& output = (*outputs)[i];
+
+            if (mCore->mIsAbandoned) {
+                BQ_LOGE("dequeueBuffers: BufferQueue has been abandoned");
+                output.result = NO_INIT;
+                continue;
+            }
+
+            if (mCore->mConnectedApi == BufferQueueCore::NO_CONNECTED_API) {
+                BQ_LOGE("dequeueBuffers: BufferQueue has no connected producer");
+                output.result = NO_INIT;
+                continue;
+            }
+
+            if ((input.width && !input.height) || (!input.width && input.height)) {
+                BQ_LOGE("dequeueBuffers: invalid size: w=%u h=%u", input.width, input.height);
+                output.result = BAD_VALUE;
+                continue;
+            }
 
-        // If shared buffer mode has just been enabled, cache the slot of the
-        // first buffer that is dequeued and mark it as the shared buffer.
-        if (mCore->mSharedBufferMode && mCore->mSharedBufferSlot ==
-                BufferQueueCore::INVALID_BUFFER_SLOT) {
-            mCore->mSharedBufferSlot = found;
-            mSlots[found].mBufferState.mShared = true;
+            dequeued[i].width = input.width;
+            dequeued[i].height = input.height;
+            dequeued[i].format = input.format;
+            dequeued[i].usage = input.usage;
+
+            // Unlike dequeueBuffer, mIsAllocating is only set once the whole
+            // batch has been dequeued, so that a later entry doesn't wait for
+            // an allocation that this call is going to make itself.
+            output.result = dequeueSlotLocked(lock, &dequeued[i]);
+            if (output.result == NO_ERROR &&
+                (dequeued[i].returnFlags & BUFFER_NEEDS_REALLOCATION)) {
+                ++allocationCount;
+            }
         }
 
-        if (!(returnFlags & BUFFER_NEEDS_REALLOCATION)) {
-            callOnFrameDequeued = true;
-            bufferId = mSlots[*outSlot].mGraphicBuffer->getId();
+        if (allocationCount > 0) {
+            mCore->mIsAllocating = true;
         }
 
         listener = mCore->mConsumerListener;
     } // Autolock scope
 
-    if (returnFlags & BUFFER_NEEDS_REALLOCATION) {
-        BQ_LOGV("dequeueBuffer: allocating a new buffer for slot %d", *outSlot);
-        sp<GraphicBuffer> graphicBuffer =
-                new GraphicBuffer(width, height, format, BQ_LAYER_COUNT, usage,
-                                  {mConsumerName.c_str(), mConsumerName.size()});
-
-        status_t error = graphicBuffer->initCheck();
+    if (allocationCount > 0) {
+        ATRACE_FORMAT("allocate %zu buffers", allocationCount);
+        std::vector<sp<GraphicBuffer>> graphicBuffers(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if ((*outputs)[i].result == NO_ERROR &&
+                (dequeued[i].returnFlags & BUFFER_NEEDS_REALLOCATION)) {
+                graphicBuffers[i] = allocateDequeuedBuffer(dequeued[i]);
+            }
+        }
 
         { // Autolock scope
             std::lock_guard<std::mutex> lock(mCore->mMutex);
 
-            if (error == NO_ERROR && !mCore->mIsAbandoned) {
-                graphicBuffer->setGenerationNumber(mCore->mGenerationNumber);
-                mSlots[*outSlot].mGraphicBuffer = graphicBuffer;
-                callOnFrameDequeued = true;
-                bufferId = mSlots[*outSlot].mGraphicBuffer->getId();
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                if (graphicBuffers[i] != nullptr) {
+                    (*outputs)[i].result =
+                            installDequeuedBufferLocked(&dequeued[i], graphicBuffers[i]);
+                }
             }
 
             mCore->mIsAllocating = false;
             mCore->mIsAllocatingCondition.notify_all();
 
-            if (error != NO_ERROR) {
-                mCore->mFreeSlots.insert(*outSlot);
-                mCore->clearBufferSlotLocked(*outSlot);
-                BQ_LOGE("dequeueBuffer: createGraphicBuffer failed");
-                return error;
-            }
-
-            if (mCore->mIsAbandoned) {
-                mCore->mFreeSlots.insert(*outSlot);
-                mCore->clearBufferSlotLocked(*outSlot);
-                BQ_LOGE("dequeueBuffer: BufferQueue has been abandoned");
-                return NO_INIT;
-            }
-
             VALIDATE_CONSISTENCY();
         } // Autolock scope
     }
 
-    if (listener != nullptr && callOnFrameDequeued) {
-        listener->onFrameDequeued(bufferId);
-    }
-
-    if (attachedByConsumer) {
-        returnFlags |= BUFFER_NEEDS_REALLOCATION;
-    }
-
-    if (eglFence != EGL_NO_SYNC_KHR) {
-        EGLint result = eglClientWaitSyncKHR(eglDisplay, eglFence, 0,
-                1000000000);
-        // If something goes wrong, log the error, but return the buffer without
-        // synchronizing access to it. It's too late at this point to abort the
-        // dequeue operation.
-        if (result == EGL_FALSE) {
-            BQ_LOGE("dequeueBuffer: error %#x waiting for fence",
-                    eglGetError());
-        } else if (result == EGL_TIMEOUT_EXPIRED_KHR) {
-            BQ_LOGE("dequeueBuffer: timeout waiting for fence");
+    if (listener != nullptr) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if ((*outputs)[i].result == NO_ERROR && dequeued[i].callOnFrameDequeued) {
+                listener->onFrameDequeued(dequeued[i].bufferId);
+            }
         }
-        eglDestroySyncKHR(eglDisplay, eglFence);
     }
 
-    BQ_LOGV("dequeueBuffer: returning slot=%d/%" PRIu64 " buf=%p flags=%#x",
-            *outSlot,
-            mSlots[*outSlot].mFrameNumber,
-            mSlots[*outSlot].mGraphicBuffer != nullptr ?
-            mSlots[*outSlot].mGraphicBuffer->handle : nullptr, returnFlags);
-
-    if (outBufferAge) {
-        *outBufferAge = mCore->mBufferAge;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        DequeueBufferOutput& output = (*outputs)[i];
+        if (output.result == NO_ERROR) {
+            output.slot = dequeued[i].slot;
+            output.fence = dequeued[i].fence;
+            output.bufferAge = dequeued[i].bufferAge;
+            output.result = finishDequeue(&dequeued[i]);
+        }
+        if (inputs[i].getTimestamps) {
+            FrameEventHistoryDelta* timestamps = &output.timestamps.emplace();
+            if (output.result >= NO_ERROR && listener != nullptr) {
+                listener->addAndGetFrameTimestamps(nullptr, timestamps);
+            }
+        }
     }
-    addAndGetFrameTimestamps(nullptr, outTimestamps);
 
-    return returnFlags;
+    return NO_ERROR;
 }
 
 status_t BufferQueueProducer::detachBuffer(int slot) {
@@ -844,237 +1046,303 @@ status_t BufferQueueProducer::attachBuffer(int* outSlot,
     return returnFlags;
 }
 
-status_t BufferQueueProducer::queueBuffer(int slot,
-        const QueueBufferInput &input, QueueBufferOutput *output) {
-    ATRACE_CALL();
-    ATRACE_BUFFER_INDEX(slot);
-
-    int64_t requestedPresentTimestamp;
-    bool isAutoTimestamp;
-    android_dataspace dataSpace;
-    Rect crop(Rect::EMPTY_RECT);
-    int scalingMode;
-    uint32_t transform;
-    uint32_t stickyTransform;
+struct BufferQueueProducer::QueuedFrame {
+    int slot = BufferQueueCore::INVALID_BUFFER_SLOT;
+
+    // Deflated from the QueueBufferInput by prepareQueuedFrame.
+    int64_t requestedPresentTimestamp = 0;
+    bool isAutoTimestamp = false;
+    android_dataspace dataSpace = HAL_DATASPACE_UNKNOWN;
+    Rect crop = Rect::EMPTY_RECT;
+    int scalingMode = 0;
+    uint32_t transform = 0;
+    uint32_t stickyTransform = 0;
     sp<Fence> acquireFence;
+    std::shared_ptr<FenceTime> acquireFenceTime;
     bool getFrameTimestamps = false;
-    input.deflate(&requestedPresentTimestamp, &isAutoTimestamp, &dataSpace,
-            &crop, &scalingMode, &transform, &acquireFence, &stickyTransform,
-            &getFrameTimestamps);
-    const Region& surfaceDamage = input.getSurfaceDamage();
-    const HdrMetadata& hdrMetadata = input.getHdrMetadata();
 
-    if (acquireFence == nullptr) {
+    // Filled in by queueFrameLocked.
+    uint64_t frameNumber = 0;
+    BufferItem item;
+    sp<IConsumerListener> listener;
+    sp<IConsumerListener> frameAvailableListener;
+    sp<IConsumerListener> frameReplacedListener;
+};
+
+status_t BufferQueueProducer::prepareQueuedFrame(int slot, const QueueBufferInput& input,
+                                                 QueuedFrame* frame) const {
+    frame->slot = slot;
+    input.deflate(&frame->requestedPresentTimestamp, &frame->isAutoTimestamp, &frame->dataSpace,
+            &frame->crop, &frame->scalingMode, &frame->transform, &frame->acquireFence,
+            &frame->stickyTransform, &frame->getFrameTimestamps);
+
+    if (frame->acquireFence == nullptr) {
         BQ_LOGE("queueBuffer: fence is NULL");
         return BAD_VALUE;
     }
 
-    auto acquireFenceTime = std::make_shared<FenceTime>(acquireFence);
+    frame->acquireFenceTime = std::make_shared<FenceTime>(frame->acquireFence);
 
-    switch (scalingMode) {
+    switch (frame->scalingMode) {
         case NATIVE_WINDOW_SCALING_MODE_FREEZE:
         case NATIVE_WINDOW_SCALING_MODE_SCALE_TO_WINDOW:
         case NATIVE_WINDOW_SCALING_MODE_SCALE_CROP:
         case NATIVE_WINDOW_SCALING_MODE_NO_SCALE_CROP:
             break;
         default:
-            BQ_LOGE("queueBuffer: unknown scaling mode %d", scalingMode);
+            BQ_LOGE("queueBuffer: unknown scaling mode %d", frame->scalingMode);
             return BAD_VALUE;
     }
 
-    sp<IConsumerListener> frameAvailableListener;
-    sp<IConsumerListener> frameReplacedListener;
-    int callbackTicket = 0;
-    uint64_t currentFrameNumber = 0;
-    BufferItem item;
-    { // Autolock scope
-        std::lock_guard<std::mutex> lock(mCore->mMutex);
+    return NO_ERROR;
+}
 
-        if (mCore->mIsAbandoned) {
-            BQ_LOGE("queueBuffer: BufferQueue has been abandoned");
-            return NO_INIT;
-        }
+status_t BufferQueueProducer::queueFrameLocked(const QueueBufferInput& input, QueuedFrame* frame,
+                                               QueueBufferOutput* output) {
+    const int slot = frame->slot;
+    const Rect& crop = frame->crop;
+    const uint32_t transform = frame->transform;
+    const int scalingMode = frame->scalingMode;
+    const Region& surfaceDamage = input.getSurfaceDamage();
+    const HdrMetadata& hdrMetadata = input.getHdrMetadata();
+    BufferItem& item = frame->item;
 
-        if (mCore->mConnectedApi == BufferQueueCore::NO_CONNECTED_API) {
-            BQ_LOGE("queueBuffer: BufferQueue has no connected producer");
-            return NO_INIT;
-        }
+    if (mCore->mIsAbandoned) {
+        BQ_LOGE("queueBuffer: BufferQueue has been abandoned");
+        return NO_INIT;
+    }
 
-        if (slot < 0 || slot >= BufferQueueDefs::NUM_BUFFER_SLOTS) {
-            BQ_LOGE("queueBuffer: slot index %d out of range [0, %d)",
-                    slot, BufferQueueDefs::NUM_BUFFER_SLOTS);
-            return BAD_VALUE;
-        } else if (!mSlots[slot].mBufferState.isDequeued()) {
-            BQ_LOGE("queueBuffer: slot %d is not owned by the producer "
-                    "(state = %s)", slot, mSlots[slot].mBufferState.string());
-            return BAD_VALUE;
-        } else if (!mSlots[slot].mRequestBufferCalled) {
-            BQ_LOGE("queueBuffer: slot %d was queued without requesting "
-                    "a buffer", slot);
-            return BAD_VALUE;
-        }
+    if (mCore->mConnectedApi == BufferQueueCore::NO_CONNECTED_API) {
+        BQ_LOGE("queueBuffer: BufferQueue has no connected producer");
+        return NO_INIT;
+    }
 
-        // If shared buffer mode has just been enabled, cache the slot of the
-        // first buffer that is queued and mark it as the shared buffer.
-        if (mCore->mSharedBufferMode && mCore->mSharedBufferSlot ==
-                BufferQueueCore::INVALID_BUFFER_SLOT) {
-            mCore->mSharedBufferSlot = slot;
-            mSlots[slot].mBufferState.mShared = true;
-        }
-
-        BQ_LOGV("queueBuffer: slot=%d/%" PRIu64 " time=%" PRIu64 " dataSpace=%d"
-                " validHdrMetadataTypes=0x%x crop=[%d,%d,%d,%d] transform=%#x scale=%s",
-                slot, mCore->mFrameCounter + 1, requestedPresentTimestamp, dataSpace,
-                hdrMetadata.validTypes, crop.left, crop.top, crop.right, crop.bottom,
-                transform,
-                BufferItem::scalingModeName(static_cast<uint32_t>(scalingMode)));
-
-        const sp<GraphicBuffer>& graphicBuffer(mSlots[slot].mGraphicBuffer);
-        Rect bufferRect(graphicBuffer->getWidth(), graphicBuffer->getHeight());
-        Rect croppedRect(Rect::EMPTY_RECT);
-        crop.intersect(bufferRect, &croppedRect);
-        if (croppedRect != crop) {
-            BQ_LOGE("queueBuffer: crop rect is not contained within the "
-                    "buffer in slot %d", slot);
-            return BAD_VALUE;
-        }
+    if (slot < 0 || slot >= BufferQueueDefs::NUM_BUFFER_SLOTS) {
+        BQ_LOGE("queueBuffer: slot index %d out of range [0, %d)",
+                slot, BufferQueueDefs::NUM_BUFFER_SLOTS);
+        return BAD_VALUE;
+    } else if (!mSlots[slot].mBufferState.isDequeued()) {
+        BQ_LOGE("queueBuffer: slot %d is not owned by the producer "
+                "(state = %s)", slot, mSlots[slot].mBufferState.string());
+        return BAD_VALUE;
+    } else if (!mSlots[slot].mRequestBufferCalled) {
+        BQ_LOGE("queueBuffer: slot %d was queued without requesting "
+                "a buffer", slot);
+        return BAD_VALUE;
+    }
 
-        // Override UNKNOWN dataspace with consumer default
-        if (dataSpace == HAL_DATASPACE_UNKNOWN) {
-            dataSpace = mCore->mDefaultBufferDataSpace;
-        }
-
-        mSlots[slot].mFence = acquireFence;
-        mSlots[slot].mBufferState.queue();
-
-        // Increment the frame counter and store a local version of it
-        // for use outside the lock on mCore->mMutex.
-        ++mCore->mFrameCounter;
-        currentFrameNumber = mCore->mFrameCounter;
-        mSlots[slot].mFrameNumber = currentFrameNumber;
-
-        item.mAcquireCalled = mSlots[slot].mAcquireCalled;
-        item.mGraphicBuffer = mSlots[slot].mGraphicBuffer;
-        item.mCrop = crop;
-        item.mTransform = transform &
-                ~static_cast<uint32_t>(NATIVE_WINDOW_TRANSFORM_INVERSE_DISPLAY);
-        item.mTransformToDisplayInverse =
-                (transform & NATIVE_WINDOW_TRANSFORM_INVERSE_DISPLAY) != 0;
-        item.mScalingMode = static_cast<uint32_t>(scalingMode);
-        item.mTimestamp = requestedPresentTimestamp;
-        item.mIsAutoTimestamp = isAutoTimestamp;
-        item.mDataSpace = dataSpace;
-        item.mHdrMetadata = hdrMetadata;
-        item.mFrameNumber = currentFrameNumber;
-        item.mSlot = slot;
-        item.mFence = acquireFence;
-        item.mFenceTime = acquireFenceTime;
-        item.mIsDroppable = mCore->mAsyncMode ||
-                (mConsumerIsSurfaceFlinger && mCore->mQueueBufferCanDrop) ||
-                (mCore->mLegacyBufferDrop && mCore->mQueueBufferCanDrop) ||
-                (mCore->mSharedBufferMode && mCore->mSharedBufferSlot == slot);
-        item.mSurfaceDamage = surfaceDamage;
-        item.mQueuedBuffer = true;
-        item.mAutoRefresh = mCore->mSharedBufferMode && mCore->mAutoRefresh;
-        item.mApi = mCore->mConnectedApi;
-
-        mStickyTransform = stickyTransform;
-
-        // Cache the shared buffer data so that the BufferItem can be recreated.
-        if (mCore->mSharedBufferMode) {
-            mCore->mSharedBufferCache.crop = crop;
-            mCore->mSharedBufferCache.transform = transform;
-            mCore->mSharedBufferCache.scalingMode = static_cast<uint32_t>(
-                    scalingMode);
-            mCore->mSharedBufferCache.dataspace = dataSpace;
-        }
+    // If shared buffer mode has just been enabled, cache the slot of the
+    // first buffer that is queued and mark it as the shared buffer.
+    if (mCore->mSharedBufferMode && mCore->mSharedBufferSlot ==
+            BufferQueueCore::INVALID_BUFFER_SLOT) {
+        mCore->mSharedBufferSlot = slot;
+        mSlots[slot].mBufferState.mShared = true;
+    }
 
-        output->bufferReplaced = false;
-        if (mCore->mQueue.empty()) {
-            // When the queue is empty, we can ignore mDequeueBufferCannotBlock
-            // and simply queue this buffer
-            mCore->mQueue.push_back(item);
-            frameAvailableListener = mCore->mConsumerListener;
-        } else {
-            // When the queue is not empty, we need to look at the last buffer
-            // in the queue to see if we need to replace it
-            const BufferItem& last = mCore->mQueue.itemAt(
-                    mCore->mQueue.size() - 1);
-            if (last.mIsDroppable) {
-
-                if (!last.mIsStale) {
-                    mSlots[last.mSlot].mBufferState.freeQueued();
-
-                    // After leaving shared buffer mode, the shared buffer will
-                    // still be around. Mark it as no longer shared if this
-                    // operation causes it to be free.
-                    if (!mCore->mSharedBufferMode &&
-                            mSlots[last.mSlot].mBufferState.isFree()) {
-                        mSlots[last.mSlot].mBufferState.mShared = false;
-                    }
-                    // Don't put the shared buffer on the free list.
-                    if (!mSlots[last.mSlot].mBufferState.isShared()) {
-                        mCore->mActiveBuffers.erase(last.mSlot);
-                        mCore->mFreeBuffers.push_back(last.mSlot);
-                        output->bufferReplaced = true;
-                    }
-                }
+    BQ_LOGV("queueBuffer: slot=%d/%" PRIu64 " time=%" PRIu64 " dataSpace=%d"
+            " validHdrMetadataTypes=0x%x crop=[%d,%d,%d,%d] transform=%#x scale=%s",
+            slot, mCore->mFrameCounter + 1, frame->requestedPresentTimestamp, frame->dataSpace,
+            hdrMetadata.validTypes, crop.left, crop.top, crop.right, crop.bottom,
+            transform,
+            BufferItem::scalingModeName(static_cast<uint32_t>(scalingMode)));
+
+    const sp<GraphicBuffer>& graphicBuffer(mSlots[slot].mGraphicBuffer);
+    Rect bufferRect(graphicBuffer->getWidth(), graphicBuffer->getHeight());
+    Rect croppedRect(Rect::EMPTY_RECT);
+    crop.intersect(bufferRect, &croppedRect);
+    if (croppedRect != crop) {
+        BQ_LOGE("queueBuffer: crop rect is not contained within the "
+                "buffer in slot %d", slot);
+        return BAD_VALUE;
+    }
 
-                // Make sure to merge the damage rect from the frame we're about
-                // to drop into the new frame's damage rect.
-                if (last.mSurfaceDamage.bounds() == Rect::INVALID_RECT ||
-                    item.mSurfaceDamage.bounds() == Rect::INVALID_RECT) {
-                    item.mSurfaceDamage = Region::INVALID_REGION;
-                } else {
-                    item.mSurfaceDamage |= last.mSurfaceDamage;
+    // Override UNKNOWN dataspace with consumer default
+    if (frame->dataSpace == HAL_DATASPACE_UNKNOWN) {
+        frame->dataSpace = mCore->mDefaultBufferDataSpace;
+    }
+
+    mSlots[slot].mFence = frame->acquireFence;
+    mSlots[slot].mBufferState.queue();
+
+    // Increment the frame counter and store a local version of it
+    // for use outside the lock on mCore->mMutex.
+    ++mCore->mFrameCounter;
+    frame->frameNumber = mCore->mFrameCounter;
+    mSlots[slot].mFrameNumber = frame->frameNumber;
+
+    item.mAcquireCalled = mSlots[slot].mAcquireCalled;
+    item.mGraphicBuffer = mSlots[slot].mGraphicBuffer;
+    item.mCrop = crop;
+    item.mTransform = transform &
+            ~static_cast<uint32_t>(NATIVE_WINDOW_TRANSFORM_INVERSE_DISPLAY);
+    item.mTransformToDisplayInverse =
+            (transform & NATIVE_WINDOW_TRANSFORM_INVERSE_DISPLAY) != 0;
+    item.mScalingMode = static_cast<uint32_t>(scalingMode);
+    item.mTimestamp = frame->requestedPresentTimestamp;
+    item.mIsAutoTimestamp = frame->isAutoTimestamp;
+    item.mDataSpace = frame->dataSpace;
+    item.mHdrMetadata = hdrMetadata;
+    item.mFrameNumber = frame->frameNumber;
+    item.mSlot = slot;
+    item.mFence = frame->acquireFence;
+    item.mFenceTime = frame->acquireFenceTime;
+    item.mIsDroppable = mCore->mAsyncMode ||
+            (mConsumerIsSurfaceFlinger && mCore->mQueueBufferCanDrop) ||
+            (mCore->mLegacyBufferDrop && mCore->mQueueBufferCanDrop) ||
+            (mCore->mSharedBufferMode && mCore->mSharedBufferSlot == slot);
+    item.mSurfaceDamage = surfaceDamage;
+    item.mQueuedBuffer = true;
+    item.mAutoRefresh = mCore->mSharedBufferMode && mCore->mAutoRefresh;
+    item.mApi = mCore->mConnectedApi;
+
+    mStickyTransform = frame->stickyTransform;
+
+    // Cache the shared buffer data so that the BufferItem can be recreated.
+    if (mCore->mSharedBufferMode) {
+        mCore->mSharedBufferCache.crop = crop;
+        mCore->mSharedBufferCache.transform = transform;
+        mCore->mSharedBufferCache.scalingMode = static_cast<uint32_t>(
+                scalingMode);
+        mCore->mSharedBufferCache.dataspace = frame->dataSpace;
+    }
+
+    output->bufferReplaced = false;
+    if (mCore->mQueue.empty()) {
+        // When the queue is empty, we can ignore mDequeueBufferCannotBlock
+        // and simply queue this buffer
+        mCore->mQueue.push_back(item);
+        frame->frameAvailableListener = mCore->mConsumerListener;
+    } else {
+        // When the queue is not empty, we need to look at the last buffer
+        // in the queue to see if we need to replace it
+        const BufferItem& last = mCore->mQueue.itemAt(
+                mCore->mQueue.size() - 1);
+        if (last.mIsDroppable) {
+
+            if (!last.mIsStale) {
+                mSlots[last.mSlot].mBufferState.freeQueued();
+
+                // After leaving shared buffer mode, the shared buffer will
+                // still be around. Mark it as no longer shared if this
+                // operation causes it to be free.
+                if (!mCore->mSharedBufferMode &&
+                        mSlots[last.mSlot].mBufferState.isFree()) {
+                    mSlots[last.mSlot].mBufferState.mShared = false;
                 }
+                // Don't put the shared buffer on the free list.
+                if (!mSlots[last.mSlot].mBufferState.isShared()) {
+                    mCore->mActiveBuffers.erase(last.mSlot);
+                    mCore->mFreeBuffers.push_back(last.mSlot);
+                    output->bufferReplaced = true;
+                }
+            }
 
-                // Overwrite the droppable buffer with the incoming one
-                mCore->mQueue.editItemAt(mCore->mQueue.size() - 1) = item;
-                frameReplacedListener = mCore->mConsumerListener;
+            // Make sure to merge the damage rect from the frame we're about
+            // to drop into the new frame's damage rect.
+            if (last.mSurfaceDamage.bounds() == Rect::INVALID_RECT ||
+                item.mSurfaceDamage.bounds() == Rect::INVALID_RECT) {
+                item.mSurfaceDamage = Region::INVALID_REGION;
             } else {
-                mCore->mQueue.push_back(item);
-                frameAvailableListener = mCore->mConsumerListener;
+                item.mSurfaceDamage |= last.mSurfaceDamage;
             }
+
+            // Overwrite the droppable buffer with the incoming one
+            mCore->mQueue.editItemAt(mCore->mQueue.size() - 1) = item;
+            frame->frameReplacedListener = mCore->mConsumerListener;
+        } else {
+            mCore->mQueue.push_back(item);
+            frame->frameAvailableListener = mCore->mConsumerListener;
         }
+    }
+    frame->listener = mCore->mConsumerListener;
 
-        mCore->mBufferHasBeenQueued = true;
-        mCore->mDequeueCondition.notify_all();
-        mCore->mLastQueuedSlot = slot;
+    mCore->mBufferHasBeenQueued = true;
+    mCore->mLastQueuedSlot = slot;
 
-        output->width = mCore->mDefaultWidth;
-        output->height = mCore->mDefaultHeight;
-        output->transformHint = mCore->mTransformHintInUse = mCore->mTransformHint;
-        output->numPendingBuffers = static_cast<uint32_t>(mCore->mQueue.size());
-        output->nextFrameNumber = mCore->mFrameCounter + 1;
+    output->width = mCore->mDefaultWidth;
+    output->height = mCore->mDefaultHeight;
+    output->transformHint = mCore->mTransformHintInUse = mCore->mTransformHint;
+    output->numPendingBuffers = static_cast<uint32_t>(mCore->mQueue.size());
+    output->nextFrameNumber = mCore->mFrameCounter + 1;
 
-        ATRACE_INT(mCore->mConsumerName.c_str(), static_cast<int32_t>(mCore->mQueue.size()));
+    ATRACE_INT(mCore->mConsumerName.c_str(), static_cast<int32_t>(mCore->mQueue.size()));
 #ifndef NO_BINDER
-        mCore->mOccupancyTracker.registerOccupancyChange(mCore->mQueue.size());
+    mCore->mOccupancyTracker.registerOccupancyChange(mCore->mQueue.size());
 #endif
-        // Take a ticket for the callback functions
-        callbackTicket = mNextCallbackTicket++;
 
-        VALIDATE_CONSISTENCY();
-    } // Autolock scope
+    return NO_ERROR;
+}
 
+void BufferQueueProducer::addQueuedFrameTimestamps(QueuedFrame* frame,
+                                                   QueueBufferOutput* output) {
     // It is okay not to clear the GraphicBuffer when the consumer is SurfaceFlinger because
     // it is guaranteed that the BufferQueue is inside SurfaceFlinger's process and
     // there will be no Binder call
     if (!mConsumerIsSurfaceFlinger) {
-        item.mGraphicBuffer.clear();
+        frame->item.mGraphicBuffer.clear();
+    }
+
+    if (frame->listener == nullptr) {
+        return;
     }
 
     // Update and get FrameEventHistory.
     nsecs_t postedTime = systemTime(SYSTEM_TIME_MONOTONIC);
     NewFrameEventsEntry newFrameEventsEntry = {
-        currentFrameNumber,
+        frame->frameNumber,
         postedTime,
-        requestedPresentTimestamp,
-        std::move(acquireFenceTime)
+        frame->requestedPresentTimestamp,
+        std::move(frame->acquireFenceTime)
     };
-    addAndGetFrameTimestamps(&newFrameEventsEntry,
-            getFrameTimestamps ? &output->frameTimestamps : nullptr);
+    frame->listener->addAndGetFrameTimestamps(&newFrameEventsEntry,
+            frame->getFrameTimestamps ? &output->frameTimestamps : nullptr);
+}
+
+sp<Fence> BufferQueueProducer::notifyFrameQueuedLocked(QueuedFrame* frame) {
+    if (frame->frameAvailableListener != nullptr) {
+        frame->frameAvailableListener->onFrameAvailable(frame->item);
+    } else if (frame->frameReplacedListener != nullptr) {
+        frame->frameReplacedListener->onFrameReplaced(frame->item);
+    }
+
+    sp<Fence> lastQueuedFence = std::move(mLastQueueBufferFence);
+
+    mLastQueueBufferFence = std::move(frame->acquireFence);
+    mLastQueuedCrop = frame->item.mCrop;
+    mLastQueuedTransform = frame->item.mTransform;
+
+    return lastQueuedFence;
+}
+
+status_t BufferQueueProducer::queueBuffer(int slot,
+        const QueueBufferInput &input, QueueBufferOutput *output) {
+    ATRACE_CALL();
+    ATRACE_BUFFER_INDEX(slot);
+
+    QueuedFrame frame;
+    status_t status = prepareQueuedFrame(slot, input, &frame);
+    if (status != NO_ERROR) {
+        return status;
+    }
+
+    int callbackTicket = 0;
+    { // Autolock scope
+        std::lock_guard<std::mutex> lock(mCore->mMutex);
+
+        status = queueFrameLocked(input, &frame, output);
+        if (status != NO_ERROR) {
+            return status;
+        }
+
+        mCore->mDequeueCondition.notify_all();
+
+        // Take a ticket for the callback functions
+        callbackTicket = mNextCallbackTicket++;
+
+        VALIDATE_CONSISTENCY();
+    } // Autolock scope
+
+    addQueuedFrameTimestamps(&frame, output);
 
     // Call back without the main BufferQueue lock held, but with the callback
     // lock held so we can ensure that callbacks occur in order
@@ -1088,18 +1356,8 @@ status_t BufferQueueProducer::queueBuffer(int slot,
             mCallbackCondition.wait(lock);
         }
 
-        if (frameAvailableListener != nullptr) {
-            frameAvailableListener->onFrameAvailable(item);
-        } else if (frameReplacedListener != nullptr) {
-            frameReplacedListener->onFrameReplaced(item);
-        }
-
+        lastQueuedFence = notifyFrameQueuedLocked(&frame);
         connectedApi = mCore->mConnectedApi;
-        lastQueuedFence = std::move(mLastQueueBufferFence);
-
-        mLastQueueBufferFence = std::move(acquireFence);
-        mLastQueuedCrop = item.mCrop;
-        mLastQueuedTransform = item.mTransform;
 
         ++mCurrentCallbackTicket;
         mCallbackCondition.notify_all();
@@ -1116,6 +1374,84 @@ status_t BufferQueueProducer::queueBuffer(int slot,
     return NO_ERROR;
 }
 
+status_t BufferQueueProducer::queueBuffers(const std::vector<QueueBufferInput>& inputs,
+                                           std::vector<QueueBufferOutput>* outputs) {
+    ATRACE_CALL();
+    BQ_LOGV("queueBuffers: %zu buffers", inputs.size());
+
+    outputs->clear();
+    outputs->resize(inputs.size());
+    std::vector<QueuedFrame> frames(inputs.size());
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        (*outputs)[i].result = prepareQueuedFrame(inputs[i].slot, inputs[i], &frames[i]);
+    }
+
+    size_t queuedCount = 0;
+    int callbackTicket = 0;
+    { // Autolock scope
+        std::lock_guard<std::mutex> lock(mCore->mMutex);
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            QueueBufferOutput& output = (*outputs)[i];
+            if (output.result != NO_ERROR) {
+                continue;
+            }
+            output.result = queueFrameLocked(inputs[i], &frames[i], &output);
+            if (output.result == NO_ERROR) {
+                ++queuedCount;
+            }
+        }
+
+        if (queuedCount == 0) {
+            return NO_ERROR;
+        }
+
+        mCore->mDequeueCondition.notify_all();
+
+        // Take a single ticket for the callbacks of the whole batch
+        callbackTicket = mNextCallbackTicket++;
+
+        VALIDATE_CONSISTENCY();
+    } // Autolock scope
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if ((*outputs)[i].result == NO_ERROR) {
+            addQueuedFrameTimestamps(&frames[i], &(*outputs)[i]);
+        }
+    }
+
+    int connectedApi;
+    std::vector<sp<Fence>> lastQueuedFences;
+    lastQueuedFences.reserve(queuedCount);
+
+    { // scope for the lock
+        std::unique_lock<std::mutex> lock(mCallbackMutex);
+        while (callbackTicket != mCurrentCallbackTicket) {
+            mCallbackCondition.wait(lock);
+        }
+
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if ((*outputs)[i].result == NO_ERROR) {
+                lastQueuedFences.push_back(notifyFrameQueuedLocked(&frames[i]));
+            }
+        }
+        connectedApi = mCore->mConnectedApi;
+
+        ++mCurrentCallbackTicket;
+        mCallbackCondition.notify_all();
+    }
+
+    // Wait without lock held, as a sequence of queueBuffer calls would have
+    if (connectedApi == NATIVE_WINDOW_API_EGL) {
+        for (const sp<Fence>& lastQueuedFence : lastQueuedFences) {
+            lastQueuedFence->waitForever("Throttling EGL Production");
+        }
+    }
+
+    return NO_ERROR;
+}
+
 status_t BufferQueueProducer::cancelBuffer(int slot, const sp<Fence>& fence) {
     ATRACE_CALL();
     BQ_LOGV("cancelBuffer: slot %d", slot);
@@ -46,6 +46,10 @@ public:
     // flags indicating that previously-returned buffers are no longer valid.
     virtual status_t requestBuffer(int slot, sp<GraphicBuffer>* buf);
 
+    // See IGraphicBufferProducer::requestBuffers
+    status_t requestBuffers(const std::vector<int32_t>& slots,
+                            std::vector<RequestBufferOutput>* outputs) override;
+
     // see IGraphicsBufferProducer::setMaxDequeuedBufferCount
     virtual status_t setMaxDequeuedBufferCount(int maxDequeuedBuffers);
 
@@ -92,6 +96,16 @@ public:
                                    uint64_t* outBufferAge,
                                    FrameEventHistoryDelta* outTimestamps) override;
 
+    // See IGraphicBufferProducer::dequeueBuffers
+    //
+    // The slots for the whole batch are chosen under a single acquisition of
+    // the BufferQueue lock, the buffers that need (re)allocation are allocated
+    // together once the lock has been dropped, and the consumer is notified of
+    // the dequeued frames afterwards. In shared buffer mode this falls back to
+    // a sequence of dequeueBuffer() calls.
+    status_t dequeueBuffers(const std::vector<DequeueBufferInput>& inputs,
+                            std::vector<DequeueBufferOutput>* outputs) override;
+
     // See IGraphicBufferProducer::detachBuffer
     virtual status_t detachBuffer(int slot);
 
@@ -120,6 +134,15 @@ public:
     virtual status_t queueBuffer(int slot,
             const QueueBufferInput& input, QueueBufferOutput* output);
 
+    // See IGraphicBufferProducer::queueBuffers
+    //
+    // The frames of the whole batch are queued under a single acquisition of
+    // the BufferQueue lock and share one callback ticket, so waiting producers
+    // are woken once and the consumer callbacks for the batch are delivered in
+    // a single pass, in queue order.
+    status_t queueBuffers(const std::vector<QueueBufferInput>& inputs,
+                          std::vector<QueueBufferOutput>* outputs) override;
+
     // cancelBuffer returns a dequeued buffer to the BufferQueue, but doesn't
     // queue it for use by the consumer.
     //
@@ -228,6 +251,62 @@ private:
     void addAndGetFrameTimestamps(const NewFrameEventsEntry* newTimestamps,
             FrameEventHistoryDelta* outDelta);
 
+    // requestBufferLocked implements requestBuffer for a single slot. It must
+    // be called with mCore->mMutex held.
+    status_t requestBufferLocked(int slot, sp<GraphicBuffer>* buf);
+
+    // Tracks one dequeued slot from its selection under the BufferQueue lock
+    // until the buffer is handed back to the producer. Defined in the .cpp.
+    struct DequeuedSlot;
+
+    // dequeueSlotLocked selects and dequeues a slot for the request described
+    // by dequeued, filling in the rest of it. It may release mCore->mMutex
+    // while waiting for a free slot. If the slot needs a new buffer,
+    // BUFFER_NEEDS_REALLOCATION is set in dequeued->returnFlags and the caller
+    // is responsible for setting mCore->mIsAllocating before dropping the lock.
+    status_t dequeueSlotLocked(std::unique_lock<std::mutex>& lock, DequeuedSlot* dequeued);
+
+    // allocateDequeuedBuffer allocates the buffer for a slot returned by
+    // dequeueSlotLocked with BUFFER_NEEDS_REALLOCATION set. It must be called
+    // without mCore->mMutex held.
+    sp<GraphicBuffer> allocateDequeuedBuffer(const DequeuedSlot& dequeued) const;
+
+    // installDequeuedBufferLocked stores a buffer returned by
+    // allocateDequeuedBuffer in its slot, or frees the slot again if the
+    // allocation failed or the BufferQueue was abandoned in the meantime.
+    // The caller is responsible for clearing mCore->mIsAllocating.
+    status_t installDequeuedBufferLocked(DequeuedSlot* dequeued,
+                                         const sp<GraphicBuffer>& graphicBuffer);
+
+    // finishDequeue waits on the EGL fence of the slot, if any, and returns
+    // the flags to report to the producer. It must be called without
+    // mCore->mMutex held.
+    status_t finishDequeue(DequeuedSlot* dequeued);
+
+    // Tracks one queued frame from the validation of its QueueBufferInput until
+    // the consumer has been notified of it. Defined in the .cpp.
+    struct QueuedFrame;
+
+    // prepareQueuedFrame validates input without taking mCore->mMutex.
+    status_t prepareQueuedFrame(int slot, const QueueBufferInput& input,
+                                QueuedFrame* frame) const;
+
+    // queueFrameLocked moves a prepared frame into the BufferQueue and fills in
+    // output. It must be called with mCore->mMutex held. The caller is
+    // responsible for waking up mCore->mDequeueCondition and taking a callback
+    // ticket.
+    status_t queueFrameLocked(const QueueBufferInput& input, QueuedFrame* frame,
+                              QueueBufferOutput* output);
+
+    // addQueuedFrameTimestamps records a queued frame in the frame event
+    // history. It must be called without mCore->mMutex held.
+    void addQueuedFrameTimestamps(QueuedFrame* frame, QueueBufferOutput* output);
+
+    // notifyFrameQueuedLocked delivers the consumer callback for a queued
+    // frame. It must be called with mCallbackMutex held, in queue order, and
+    // returns the fence of the frame queued before it.
+    sp<Fence> notifyFrameQueuedLocked(QueuedFrame* frame);
+
     // waitForFreeSlotThenRelock finds the oldest slot in the FREE state. It may
     // block if there are no available slots and we are not in non-blocking
     // mode (producer and consumer controlled by the application). If it blocks,
@@ -40,6 +40,8 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <future>
 #include <thread>
 
@@ -1358,6 +1360,196 @@ TEST_F(BufferQueueTest, TestSetFrameRate) {
     producer->setFrameRate(12.34f, 1, 0);
 }
 
+struct CountingConsumerListener : public BnConsumerListener {
+    void onFrameAvailable(const BufferItem& /* item */) override { ++framesAvailable; }
+    void onFrameDequeued(const uint64_t /* bufferId */) override { ++framesDequeued; }
+    void onBuffersReleased() override {}
+    void onSidebandStreamChanged() override {}
+
+    std::atomic<int> framesAvailable = 0;
+    std::atomic<int> framesDequeued = 0;
+};
+
+TEST_F(BufferQueueTest, BatchedDequeueAndQueue_BehaveLikeSequentialCalls) {
+    constexpr size_t kBatchSize = 4;
+    createBufferQueue();
+    sp<CountingConsumerListener> listener = sp<CountingConsumerListener>::make();
+    ASSERT_EQ(OK, mConsumer->consumerConnect(listener, false));
+    IGraphicBufferProducer::QueueBufferOutput output;
+    ASSERT_EQ(OK,
+              mProducer->connect(new StubProducerListener, NATIVE_WINDOW_API_CPU, false, &output));
+    ASSERT_EQ(OK, mProducer->setMaxDequeuedBufferCount(kBatchSize));
+
+    std::vector<IGraphicBufferProducer::DequeueBufferInput> dequeueInputs(kBatchSize);
+    for (auto& input : dequeueInputs) {
+        input.width = 16;
+        input.height = 16;
+        input.format = PIXEL_FORMAT_RGBA_8888;
+        input.usage = TEST_PRODUCER_USAGE_BITS;
+        input.getTimestamps = false;
+    }
+    std::vector<IGraphicBufferProducer::DequeueBufferOutput> dequeueOutputs;
+    ASSERT_EQ(OK, mProducer->dequeueBuffers(dequeueInputs, &dequeueOutputs));
+    ASSERT_EQ(kBatchSize, dequeueOutputs.size());
+
+    std::vector<int32_t> slots;
+    for (const auto& dequeueOutput : dequeueOutputs) {
+        EXPECT_EQ(IGraphicBufferProducer::BUFFER_NEEDS_REALLOCATION, dequeueOutput.result);
+        EXPECT_EQ(slots.end(), std::find(slots.begin(), slots.end(), dequeueOutput.slot));
+        slots.push_back(dequeueOutput.slot);
+    }
+    EXPECT_EQ(static_cast<int>(kBatchSize), listener->framesDequeued.load());
+
+    std::vector<IGraphicBufferProducer::RequestBufferOutput> requestOutputs;
+    ASSERT_EQ(OK, mProducer->requestBuffers(slots, &requestOutputs));
+    ASSERT_EQ(kBatchSize, requestOutputs.size());
+    for (const auto& requestOutput : requestOutputs) {
+        EXPECT_EQ(OK, requestOutput.result);
+        EXPECT_NE(nullptr, requestOutput.buffer);
+    }
+
+    // An invalid entry fails on its own without affecting the rest of the batch.
+    std::vector<IGraphicBufferProducer::QueueBufferInput> queueInputs;
+    for (size_t i = 0; i < kBatchSize; ++i) {
+        queueInputs.emplace_back(static_cast<int64_t>(i), false, HAL_DATASPACE_UNKNOWN,
+                                 Rect(0, 0, 1, 1), NATIVE_WINDOW_SCALING_MODE_FREEZE, 0,
+                                 Fence::NO_FENCE, 0, false, slots[i]);
+    }
+    queueInputs.emplace(queueInputs.begin() + 1, 0, false, HAL_DATASPACE_UNKNOWN,
+                        Rect(0, 0, 1, 1), NATIVE_WINDOW_SCALING_MODE_FREEZE, 0, Fence::NO_FENCE,
+                        0, false, BufferQueueDefs::NUM_BUFFER_SLOTS);
+    std::vector<IGraphicBufferProducer::QueueBufferOutput> queueOutputs;
+    ASSERT_EQ(OK, mProducer->queueBuffers(queueInputs, &queueOutputs));
+    ASSERT_EQ(kBatchSize + 1, queueOutputs.size());
+    for (size_t i = 0; i < queueOutputs.size(); ++i) {
+        EXPECT_EQ(i == 1 ? BAD_VALUE : OK, queueOutputs[i].result);
+    }
+    EXPECT_EQ(kBatchSize, queueOutputs.back().numPendingBuffers);
+    EXPECT_EQ(static_cast<int>(kBatchSize), listener->framesAvailable.load());
+
+    // The consumer sees the frames in the order of the batch.
+    for (size_t i = 0; i < kBatchSize; ++i) {
+        BufferItem item;
+        ASSERT_EQ(OK, mConsumer->acquireBuffer(&item, 0));
+        EXPECT_EQ(slots[i], item.mSlot);
+        EXPECT_EQ(static_cast<int64_t>(i), item.mTimestamp);
+        ASSERT_EQ(OK,
+                  mConsumer->releaseBuffer(item.mSlot, item.mFrameNumber, EGL_NO_DISPLAY,
+                                           EGL_NO_SYNC_KHR, Fence::NO_FENCE));
+    }
+}
+
+struct BatchWorkload {
+    const char* name;
+    size_t batchSize;
+    uint32_t width;
+    uint32_t height;
+    int iterations;
+};
+
+// Measures the mean time in nanoseconds spent dequeuing and queuing one buffer of the workload,
+// either with the batched calls or with one call per buffer. The buffers are allocated before
+// timing starts, and the consumer releases every frame between iterations.
+static void measureBatchLatency(const sp<IGraphicBufferProducer>& producer,
+                                const sp<IGraphicBufferConsumer>& consumer,
+                                const BatchWorkload& workload, bool batched, nsecs_t* outLatency) {
+    std::vector<IGraphicBufferProducer::DequeueBufferInput> dequeueInputs(workload.batchSize);
+    for (auto& input : dequeueInputs) {
+        input.width = workload.width;
+        input.height = workload.height;
+        input.format = PIXEL_FORMAT_RGBA_8888;
+        input.usage = TEST_PRODUCER_USAGE_BITS;
+        input.getTimestamps = false;
+    }
+    std::vector<IGraphicBufferProducer::DequeueBufferOutput> dequeueOutputs;
+    std::vector<IGraphicBufferProducer::QueueBufferInput> queueInputs(workload.batchSize);
+    std::vector<IGraphicBufferProducer::QueueBufferOutput> queueOutputs(workload.batchSize);
+    std::vector<int32_t> slots(workload.batchSize);
+
+    nsecs_t elapsed = 0;
+    // The first iteration allocates the buffers and isn't timed.
+    for (int iteration = 0; iteration <= workload.iterations; ++iteration) {
+        const nsecs_t start = systemTime();
+        if (batched) {
+            ASSERT_EQ(OK, producer->dequeueBuffers(dequeueInputs, &dequeueOutputs));
+        } else {
+            dequeueOutputs.resize(workload.batchSize);
+            for (auto& output : dequeueOutputs) {
+                output.result =
+                        producer->dequeueBuffer(&output.slot, &output.fence, workload.width,
+                                                workload.height, PIXEL_FORMAT_RGBA_8888,
+                                                TEST_PRODUCER_USAGE_BITS, nullptr, nullptr);
+            }
+        }
+        for (size_t i = 0; i < workload.batchSize; ++i) {
+            ASSERT_GE(dequeueOutputs[i].result, OK);
+            slots[i] = dequeueOutputs[i].slot;
+            queueInputs[i] = IGraphicBufferProducer::QueueBufferInput(
+                    iteration, false, HAL_DATASPACE_UNKNOWN, Rect(0, 0, 1, 1),
+                    NATIVE_WINDOW_SCALING_MODE_FREEZE, 0, Fence::NO_FENCE, 0, false, slots[i]);
+        }
+        if (iteration == 0) {
+            std::vector<IGraphicBufferProducer::RequestBufferOutput> requestOutputs;
+            ASSERT_EQ(OK, producer->requestBuffers(slots, &requestOutputs));
+        }
+        if (batched) {
+            ASSERT_EQ(OK, producer->queueBuffers(queueInputs, &queueOutputs));
+        } else {
+            for (size_t i = 0; i < workload.batchSize; ++i) {
+                queueOutputs[i].result =
+                        producer->queueBuffer(slots[i], queueInputs[i], &queueOutputs[i]);
+            }
+        }
+        const nsecs_t end = systemTime();
+        if (iteration > 0) {
+            elapsed += end - start;
+        }
+
+        for (size_t i = 0; i < workload.batchSize; ++i) {
+            ASSERT_EQ(OK, queueOutputs[i].result);
+            BufferItem item;
+            ASSERT_EQ(OK, consumer->acquireBuffer(&item, 0));
+            ASSERT_EQ(OK,
+                      consumer->releaseBuffer(item.mSlot, item.mFrameNumber, EGL_NO_DISPLAY,
+                                              EGL_NO_SYNC_KHR, Fence::NO_FENCE));
+        }
+    }
+
+    *outLatency = elapsed / static_cast<nsecs_t>(workload.iterations * workload.batchSize);
+}
+
+// Measures the per-buffer latency of batched and sequential dequeue/queue for a media decoder
+// style workload (a few large buffers in flight) and a camera burst style workload (many buffers
+// in flight). The results are reported as test properties; timing is not asserted on since it
+// depends on the device.
+TEST_F(BufferQueueTest, BatchedDequeueAndQueue_Latency) {
+    const BatchWorkload workloads[] = {
+            {"Media", 4, 1920, 1080, 200},
+            {"CameraBurst", 16, 640, 480, 100},
+    };
+
+    for (const BatchWorkload& workload : workloads) {
+        SCOPED_TRACE(workload.name);
+        for (bool batched : {false, true}) {
+            createBufferQueue();
+            sp<MockConsumer> mc(new MockConsumer);
+            ASSERT_EQ(OK, mConsumer->consumerConnect(mc, false));
+            IGraphicBufferProducer::QueueBufferOutput output;
+            ASSERT_EQ(OK,
+                      mProducer->connect(new StubProducerListener, NATIVE_WINDOW_API_CPU, false,
+                                         &output));
+            ASSERT_EQ(OK,
+                      mProducer->setMaxDequeuedBufferCount(static_cast<int>(workload.batchSize)));
+
+            nsecs_t latency = 0;
+            ASSERT_NO_FATAL_FAILURE(
+                    measureBatchLatency(mProducer, mConsumer, workload, batched, &latency));
+            RecordProperty(std::string(workload.name) + (batched ? "BatchedNs" : "SequentialNs"),
+                           std::to_string(latency));
+        }
+    }
+}
+
 class Latch {
 public:
     explicit Latch(int expected) : mExpected(expected) {}
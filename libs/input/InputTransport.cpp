@@ -14,6 +14,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+
 #include <android-base/logging.h>
 #include <android-base/properties.h>
 #include <android-base/stringprintf.h>
@@ -110,6 +113,10 @@ static const size_t SOCKET_BUFFER_SIZE = 32 * 1024;
 // Nanoseconds per milliseconds.
 static const nsecs_t NANOS_PER_MS = 1000000;
 
+// Maximum number of messages handed to a single sendmmsg call. Each message is sanitized into a
+// stack buffer before it is sent, so this also bounds the stack used by sendMessages.
+static constexpr size_t MAX_MESSAGES_PER_SENDMMSG = 8;
+
 // Latency added during resampling.  A few milliseconds doesn't hurt much but
 // reduces the impact of mispredicted touch positions.
 const std::chrono::duration RESAMPLE_LATENCY = 5ms;
@@ -475,6 +482,79 @@ status_t InputChannel::sendMessage(const InputMessage* msg) {
     return OK;
 }
 
+status_t InputChannel::sendMessages(const InputMessage* msgs, size_t count,
+                                    size_t& outSentCount) {
+    ATRACE_NAME_IF(ATRACE_ENABLED(),
+                   StringPrintf("sendMessages(inputChannel=%s, count=%zu)", mName.c_str(), count));
+    outSentCount = 0;
+    if (count == 0) {
+        return OK;
+    }
+    if (count == 1) {
+        status_t status = sendMessage(&msgs[0]);
+        outSentCount = status == OK ? 1 : 0;
+        return status;
+    }
+
+    // Messages are sanitized into fixed-size stack buffers and handed to sendmmsg a chunk at a
+    // time, so that publishing a batch does not allocate.
+    std::array<InputMessage, MAX_MESSAGES_PER_SENDMMSG> cleanMsgs;
+    std::array<iovec, MAX_MESSAGES_PER_SENDMMSG> iovs;
+    std::array<mmsghdr, MAX_MESSAGES_PER_SENDMMSG> headers;
+    while (outSentCount < count) {
+        const size_t chunkSize = std::min(count - outSentCount, MAX_MESSAGES_PER_SENDMMSG);
+        for (size_t i = 0; i < chunkSize; i++) {
+            const InputMessage& msg = msgs[outSentCount + i];
+            msg.getSanitizedCopy(&cleanMsgs[i]);
+            iovs[i].iov_base = &cleanMsgs[i];
+            iovs[i].iov_len = msg.size();
+            headers[i] = {};
+            headers[i].msg_hdr.msg_iov = &iovs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        size_t chunkSentCount = 0;
+        while (chunkSentCount < chunkSize) {
+            int nSent;
+            do {
+                nSent = ::sendmmsg(getFd().get(), headers.data() + chunkSentCount,
+                                   chunkSize - chunkSentCount, MSG_DONTWAIT | MSG_NOSIGNAL);
+            } while (nSent == -1 && errno == EINTR);
+
+            if (nSent < 0) {
+                int error = errno;
+                ALOGD_IF(DEBUG_CHANNEL_MESSAGES,
+                         "channel '%s' ~ error sending message of type %s, %s", mName.c_str(),
+                         ftl::enum_string(msgs[outSentCount].header.type).c_str(),
+                         strerror(error));
+                if (error == EAGAIN || error == EWOULDBLOCK) {
+                    return WOULD_BLOCK;
+                }
+                if (error == EPIPE || error == ENOTCONN || error == ECONNREFUSED ||
+                    error == ECONNRESET) {
+                    return DEAD_OBJECT;
+                }
+                return -error;
+            }
+
+            for (int i = 0; i < nSent; i++) {
+                if (headers[chunkSentCount].msg_len != iovs[chunkSentCount].iov_len) {
+                    ALOGD_IF(DEBUG_CHANNEL_MESSAGES,
+                             "channel '%s' ~ error sending message type %s, send was incomplete",
+                             mName.c_str(),
+                             ftl::enum_string(msgs[outSentCount].header.type).c_str());
+                    return DEAD_OBJECT;
+                }
+                ALOGD_IF(DEBUG_CHANNEL_MESSAGES, "channel '%s' ~ sent message of type %s",
+                         mName.c_str(), ftl::enum_string(msgs[outSentCount].header.type).c_str());
+                chunkSentCount++;
+                outSentCount++;
+            }
+        }
+    }
+    return OK;
+}
+
 status_t InputChannel::receiveMessage(InputMessage* msg) {
     ssize_t nRead;
     do {
@@ -575,6 +655,56 @@ InputPublisher::InputPublisher(const std::shared_ptr<InputChannel>& channel)
 InputPublisher::~InputPublisher() {
 }
 
+void InputPublisher::beginBatch() {
+    LOG_ALWAYS_FATAL_IF(mBatching, "channel '%s' publisher ~ %s: a batch is already started",
+                        mChannel->getName().c_str(), __func__);
+    mBatching = true;
+    mBatch.clear();
+}
+
+status_t InputPublisher::endBatch(size_t& outPublishedCount) {
+    LOG_ALWAYS_FATAL_IF(!mBatching, "channel '%s' publisher ~ %s: no batch was started",
+                        mChannel->getName().c_str(), __func__);
+    mBatching = false;
+    const status_t status = mChannel->sendMessages(mBatch.data(), mBatch.size(),
+                                                   outPublishedCount);
+    if (verifyEvents()) {
+        for (size_t i = 0; i < outPublishedCount; i++) {
+            verifyMotionMessage(mBatch[i]);
+        }
+    }
+    mBatch.clear();
+    return status;
+}
+
+status_t InputPublisher::sendMessage(const InputMessage& msg) {
+    if (mBatching) {
+        mBatch.push_back(msg);
+        return OK;
+    }
+    return mChannel->sendMessage(&msg);
+}
+
+void InputPublisher::verifyMotionMessage(const InputMessage& msg) {
+    if (msg.header.type != InputMessage::Type::MOTION) {
+        return;
+    }
+    const InputMessage::Body::Motion& motion = msg.body.motion;
+    PointerProperties pointerProperties[MAX_POINTERS];
+    PointerCoords pointerCoords[MAX_POINTERS];
+    for (uint32_t i = 0; i < motion.pointerCount; i++) {
+        pointerProperties[i] = motion.pointers[i].properties;
+        pointerCoords[i] = motion.pointers[i].coords;
+    }
+    Result<void> result =
+            mInputVerifier.processMovement(motion.deviceId, motion.source, motion.action,
+                                           motion.pointerCount, pointerProperties, pointerCoords,
+                                           motion.flags);
+    if (!result.ok()) {
+        LOG(FATAL) << "Bad stream: " << result.error();
+    }
+}
+
 status_t InputPublisher::publishKeyEvent(uint32_t seq, int32_t eventId, int32_t deviceId,
                                          int32_t source, int32_t displayId,
                                          std::array<uint8_t, 32> hmac, int32_t action,
@@ -614,7 +744,7 @@ status_t InputPublisher::publishKeyEvent(uint32_t seq, int32_t eventId, int32_t
     msg.body.key.repeatCount = repeatCount;
     msg.body.key.downTime = downTime;
     msg.body.key.eventTime = eventTime;
-    return mChannel->sendMessage(&msg);
+    return sendMessage(msg);
 }
 
 status_t InputPublisher::publishMotionEvent(
@@ -630,7 +760,8 @@ status_t InputPublisher::publishMotionEvent(
                    StringPrintf("publishMotionEvent(inputChannel=%s, action=%s)",
                                 mChannel->getName().c_str(),
                                 MotionEvent::actionToString(action).c_str()));
-    if (verifyEvents()) {
+    // Batched events are verified once they have been sent, in endBatch().
+    if (verifyEvents() && !mBatching) {
         Result<void> result =
                 mInputVerifier.processMovement(deviceId, source, action, pointerCount,
                                                pointerProperties, pointerCoords, flags);
@@ -704,7 +835,7 @@ status_t InputPublisher::publishMotionEvent(
         msg.body.motion.pointers[i].coords = pointerCoords[i];
     }
 
-    return mChannel->sendMessage(&msg);
+    return sendMessage(msg);
 }
 
 status_t InputPublisher::publishFocusEvent(uint32_t seq, int32_t eventId, bool hasFocus) {
@@ -719,7 +850,7 @@ status_t InputPublisher::publishFocusEvent(uint32_t seq, int32_t eventId, bool h
     msg.header.seq = seq;
     msg.body.focus.eventId = eventId;
     msg.body.focus.hasFocus = hasFocus;
-    return mChannel->sendMessage(&msg);
+    return sendMessage(msg);
 }
 
 status_t InputPublisher::publishCaptureEvent(uint32_t seq, int32_t eventId,
@@ -736,7 +867,7 @@ status_t InputPublisher::publishCaptureEvent(uint32_t seq, int32_t eventId,
     msg.header.seq = seq;
     msg.body.capture.eventId = eventId;
     msg.body.capture.pointerCaptureEnabled = pointerCaptureEnabled;
-    return mChannel->sendMessage(&msg);
+    return sendMessage(msg);
 }
 
 status_t InputPublisher::publishDragEvent(uint32_t seq, int32_t eventId, float x, float y,
@@ -755,7 +886,7 @@ status_t InputPublisher::publishDragEvent(uint32_t seq, int32_t eventId, float x
     msg.body.drag.isExiting = isExiting;
     msg.body.drag.x = x;
     msg.body.drag.y = y;
-    return mChannel->sendMessage(&msg);
+    return sendMessage(msg);
 }
 
 status_t InputPublisher::publishTouchModeEvent(uint32_t seq, int32_t eventId, bool isInTouchMode) {
@@ -771,7 +902,7 @@ status_t InputPublisher::publishTouchModeEvent(uint32_t seq, int32_t eventId, bo
     msg.header.seq = seq;
     msg.body.touchMode.eventId = eventId;
     msg.body.touchMode.isInTouchMode = isInTouchMode;
-    return mChannel->sendMessage(&msg);
+    return sendMessage(msg);
 }
 
 android::base::Result<InputPublisher::ConsumerResponse> InputPublisher::receiveConsumerResponse() {
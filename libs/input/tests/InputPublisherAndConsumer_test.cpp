@@ -648,4 +648,48 @@ TEST_F(InputPublisherAndConsumerTest, PublishMultipleEvents_EndToEnd) {
     ASSERT_NO_FATAL_FAILURE(publishAndConsumeTouchModeEvent());
 }
 
+TEST_F(InputPublisherAndConsumerTest, PublishBatch_EndToEnd) {
+    constexpr uint32_t firstSeq = 20;
+    constexpr size_t eventCount = 5;
+
+    mPublisher->beginBatch();
+    for (size_t i = 0; i < eventCount; i++) {
+        ASSERT_EQ(OK,
+                  mPublisher->publishFocusEvent(firstSeq + i, InputEvent::nextId(),
+                                                /*hasFocus=*/i % 2 == 0))
+                << "publisher should queue events while batching";
+    }
+    // Nothing is sent until the batch is ended.
+    uint32_t consumeSeq;
+    InputEvent* event;
+    ASSERT_EQ(WOULD_BLOCK,
+              mConsumer->consume(&mEventFactory, /*consumeBatches=*/true, -1, &consumeSeq, &event));
+
+    size_t publishedCount;
+    ASSERT_EQ(OK, mPublisher->endBatch(publishedCount));
+    ASSERT_EQ(eventCount, publishedCount);
+
+    for (size_t i = 0; i < eventCount; i++) {
+        ASSERT_EQ(OK,
+                  mConsumer->consume(&mEventFactory, /*consumeBatches=*/true, -1, &consumeSeq,
+                                     &event));
+        ASSERT_EQ(InputEventType::FOCUS, event->getType());
+        EXPECT_EQ(firstSeq + i, consumeSeq) << "events should be received in order";
+        EXPECT_EQ(i % 2 == 0, static_cast<FocusEvent*>(event)->getHasFocus());
+    }
+}
+
+TEST_F(InputPublisherAndConsumerTest, PublishBatch_WhenPeerClosed_ReturnsError) {
+    mPublisher->beginBatch();
+    ASSERT_EQ(OK, mPublisher->publishFocusEvent(/*seq=*/1, InputEvent::nextId(), true));
+    ASSERT_EQ(OK, mPublisher->publishFocusEvent(/*seq=*/2, InputEvent::nextId(), false));
+
+    mConsumer.reset();
+    mClientChannel.reset();
+
+    size_t publishedCount;
+    ASSERT_EQ(DEAD_OBJECT, mPublisher->endBatch(publishedCount));
+    ASSERT_EQ(0u, publishedCount);
+}
+
 } // namespace android
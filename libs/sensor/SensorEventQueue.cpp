@@ -63,6 +63,11 @@ ssize_t SensorEventQueue::write(const sp<BitTube>& tube,
     return BitTube::sendObjects(tube, events, numEvents);
 }
 
+ssize_t SensorEventQueue::write(const sp<BitTube>& tube,
+        const struct iovec* buffers, size_t bufferCount) {
+    return BitTube::sendObjects<ASensorEvent>(tube, buffers, bufferCount);
+}
+
 ssize_t SensorEventQueue::read(ASensorEvent* events, size_t numEvents) {
     if (mAvailable == 0) {
         ssize_t err = BitTube::recvObjects(mSensorChannel,
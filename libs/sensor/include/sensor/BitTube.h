@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <utils/Errors.h>
 #include <utils/RefBase.h>
@@ -55,6 +56,14 @@ public:
         return sendObjects(tube, events, count, sizeof(T));
     }
 
+    // send objects gathered from several buffers as a single message, like sendObjects() does
+    // for a single buffer. The length of each buffer must be a multiple of sizeof(T).
+    template <typename T>
+    static ssize_t sendObjects(const sp<BitTube>& tube,
+            const struct iovec* buffers, size_t bufferCount) {
+        return sendObjects(tube, buffers, bufferCount, sizeof(T));
+    }
+
     // receive objects (sized blobs). If the receiving buffer isn't large enough,
     // excess messages are silently discarded.
     template <typename T>
@@ -72,6 +81,9 @@ private:
     // send a message. The write is guaranteed to send the whole message or fail.
     ssize_t write(void const* vaddr, size_t size);
 
+    // send a message gathered from several buffers, with the same guarantee as write().
+    ssize_t write(const struct iovec* buffers, size_t bufferCount);
+
     // receive a message. the passed buffer must be at least as large as the
     // write call used to send the message, excess data is silently discarded.
     ssize_t read(void* vaddr, size_t size);
@@ -82,6 +94,9 @@ private:
     static ssize_t sendObjects(const sp<BitTube>& tube,
             void const* events, size_t count, size_t objSize);
 
+    static ssize_t sendObjects(const sp<BitTube>& tube,
+            const struct iovec* buffers, size_t bufferCount, size_t objSize);
+
     static ssize_t recvObjects(const sp<BitTube>& tube,
             void* events, size_t count, size_t objSize);
 };
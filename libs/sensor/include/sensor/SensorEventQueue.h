@@ -74,6 +74,11 @@ public:
     static ssize_t write(const sp<BitTube>& tube,
             ASensorEvent const* events, size_t numEvents);
 
+    // Writes events gathered from several buffers as a single message. The length of each
+    // buffer must be a multiple of sizeof(ASensorEvent).
+    static ssize_t write(const sp<BitTube>& tube,
+            const struct iovec* buffers, size_t bufferCount);
+
     ssize_t read(ASensorEvent* events, size_t numEvents);
 
     status_t waitForEvent() const;
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include <gtest/gtest.h>
+#include <utils/Errors.h>
+
+#include <android/sensor.h>
+#include <sensor/BitTube.h>
+#include <sensor/SensorEventQueue.h>
+
+namespace android {
+
+class BitTubeTest : public ::testing::Test {
+protected:
+    virtual void SetUp() override {
+        mTube = new BitTube(sizeof(ASensorEvent) * 64);
+        ASSERT_EQ(NO_ERROR, mTube->initCheck());
+        for (size_t i = 0; i < kEventCount; i++) {
+            mEvents[i] = {};
+            mEvents[i].sensor = static_cast<int32_t>(i);
+            mEvents[i].timestamp = static_cast<int64_t>(i) * 1000;
+        }
+    }
+
+    static constexpr size_t kEventCount = 8;
+    sp<BitTube> mTube;
+    ASensorEvent mEvents[kEventCount];
+};
+
+TEST_F(BitTubeTest, gatheredEventsAreReceivedInOrder) {
+    // Not in the order of the buffer, and with a separate copy of one event.
+    ASensorEvent copy = mEvents[2];
+    copy.flags = 1;
+    const struct iovec buffers[] = {
+            {.iov_base = &mEvents[5], .iov_len = sizeof(ASensorEvent) * 3},
+            {.iov_base = &copy, .iov_len = sizeof(ASensorEvent)},
+            {.iov_base = &mEvents[0], .iov_len = sizeof(ASensorEvent) * 2},
+    };
+    ASSERT_EQ(6, SensorEventQueue::write(mTube, buffers, 3));
+
+    ASensorEvent received[kEventCount];
+    ASSERT_EQ(6, BitTube::recvObjects(mTube, received, kEventCount));
+    const int32_t expectedSensors[] = {5, 6, 7, 2, 0, 1};
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_EQ(expectedSensors[i], received[i].sensor);
+        EXPECT_EQ(expectedSensors[i] * 1000, received[i].timestamp);
+    }
+    EXPECT_EQ(1u, received[3].flags);
+}
+
+TEST_F(BitTubeTest, gatheredEventsAreSentAsOneMessage) {
+    const struct iovec buffers[] = {
+            {.iov_base = &mEvents[0], .iov_len = sizeof(ASensorEvent)},
+            {.iov_base = &mEvents[3], .iov_len = sizeof(ASensorEvent)},
+    };
+    ASSERT_EQ(2, BitTube::sendObjects<ASensorEvent>(mTube, buffers, 2));
+    ASSERT_EQ(1, SensorEventQueue::write(mTube, &mEvents[7], 1));
+
+    // Each message is read separately, however large the receiving buffer is.
+    ASensorEvent received[kEventCount];
+    ASSERT_EQ(2, BitTube::recvObjects(mTube, received, kEventCount));
+    EXPECT_EQ(0, received[0].sensor);
+    EXPECT_EQ(3, received[1].sensor);
+    ASSERT_EQ(1, BitTube::recvObjects(mTube, received, kEventCount));
+    EXPECT_EQ(7, received[0].sensor);
+    EXPECT_EQ(0, BitTube::recvObjects(mTube, received, kEventCount));
+}
+
+} // namespace android
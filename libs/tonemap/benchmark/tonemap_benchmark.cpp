@@ -0,0 +1,92 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <tonemap/tonemap.h>
+#include <tonemap/tonemapgainlut.h>
+
+#include <random>
+#include <vector>
+
+namespace android {
+namespace {
+
+using aidl::android::hardware::graphics::common::Dataspace;
+
+const tonemap::Metadata kMetadata{.displayMaxLuminance = 500.f,
+                                  .contentMaxLuminance = 1000.f,
+                                  .currentDisplayLuminance = 300.f};
+
+// Linear BT2020 to XYZ
+const mat3 kBt2020ToXYZ{vec3(0.636958f, 0.262700f, 0.000000f),
+                        vec3(0.144617f, 0.677998f, 0.028073f),
+                        vec3(0.168881f, 0.059302f, 1.060985f)};
+
+// One row of a 4K frame.
+std::vector<tonemap::Color> randomColors() {
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(0.f, 1.f);
+    std::vector<tonemap::Color> colors;
+    for (int i = 0; i < 3840; i++) {
+        vec3 linearRGB(distribution(generator), distribution(generator), distribution(generator));
+        linearRGB = linearRGB * linearRGB * linearRGB * 10000.f;
+        colors.push_back({.linearRGB = linearRGB, .xyz = kBt2020ToXYZ * linearRGB});
+    }
+    return colors;
+}
+
+void BM_ToneMapper(benchmark::State& state) {
+    const auto colors = randomColors();
+    tonemap::ToneMapper* toneMapper = tonemap::getToneMapper();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(toneMapper->lookupTonemapGain(Dataspace::BT2020_ITU_PQ,
+                                                               Dataspace::DISPLAY_P3, colors,
+                                                               kMetadata));
+    }
+    state.SetItemsProcessed(state.iterations() * colors.size());
+}
+BENCHMARK(BM_ToneMapper);
+
+void BM_TonemapGainLut(benchmark::State& state, tonemap::TonemapGainLut::Type type) {
+    const auto colors = randomColors();
+    const auto lut = tonemap::TonemapGainLut::get(tonemap::getToneMapper(),
+                                                  Dataspace::BT2020_ITU_PQ, Dataspace::DISPLAY_P3,
+                                                  kMetadata,
+                                                  {.type = type, .linearRGBToXYZ = kBt2020ToXYZ});
+    std::vector<tonemap::ToneMapper::Gain> gains(colors.size());
+    for (auto _ : state) {
+        lut->lookupTonemapGain(colors.data(), colors.size(), gains.data());
+        benchmark::DoNotOptimize(gains.data());
+    }
+    state.SetItemsProcessed(state.iterations() * colors.size());
+}
+BENCHMARK_CAPTURE(BM_TonemapGainLut, auto, tonemap::TonemapGainLut::Type::Auto);
+BENCHMARK_CAPTURE(BM_TonemapGainLut, 3d, tonemap::TonemapGainLut::Type::ThreeDimensional);
+
+// Includes computing the table, like the first frame after the metadata changes.
+void BM_TonemapGainLutCreate(benchmark::State& state, tonemap::TonemapGainLut::Type type) {
+    for (auto _ : state) {
+        tonemap::TonemapGainLut lut(tonemap::getToneMapper(), Dataspace::BT2020_ITU_PQ,
+                                    Dataspace::DISPLAY_P3, kMetadata,
+                                    {.type = type, .linearRGBToXYZ = kBt2020ToXYZ});
+        benchmark::DoNotOptimize(&lut);
+    }
+}
+BENCHMARK_CAPTURE(BM_TonemapGainLutCreate, auto, tonemap::TonemapGainLut::Type::Auto);
+BENCHMARK_CAPTURE(BM_TonemapGainLutCreate, 3d, tonemap::TonemapGainLut::Type::ThreeDimensional);
+
+} // namespace
+} // namespace android
@@ -148,6 +148,18 @@ public:
             aidl::android::hardware::graphics::common::Dataspace sourceDataspace,
             aidl::android::hardware::graphics::common::Dataspace destinationDataspace,
             const std::vector<Color>& colors, const Metadata& metadata) = 0;
+
+    // Describes which part of a Color the gain computed by lookupTonemapGain() depends on, so that
+    // CPU-side callers can precompute gains, e.g. with TonemapGainLut.
+    enum class GainInput {
+        // The gain may depend on any part of the color.
+        Color,
+        // The gain only depends on the maximum of the linear RGB channels.
+        MaxLinearRGB,
+        // The gain only depends on the Y channel of the XYZ color.
+        LuminanceY,
+    };
+    virtual GainInput getGainInput() const { return GainInput::Color; }
 };
 
 // Retrieves a tonemapper instance.
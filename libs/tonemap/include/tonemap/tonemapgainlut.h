@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <math/mat3.h>
+#include <tonemap/tonemap.h>
+
+#include <memory>
+#include <vector>
+
+namespace android::tonemap {
+
+// A precomputed table of the gains returned by ToneMapper::lookupTonemapGain() for one source and
+// destination dataspace and one Metadata, for CPU-side callers that tone map many colors, such as
+// screenshots and thumbnails.
+//
+// If the tone mapper's gain only depends on one value of each color (see
+// ToneMapper::getGainInput()), the table is 1D and indexed by that value. Otherwise it is a 3D
+// table indexed by linear RGB, in which case the XYZ colors are assumed to be linearRGBToXYZ times
+// the linear RGB colors. Tables are sampled more densely near black, where tone curves change the
+// most, and interpolated linearly (trilinearly for 3D tables) between samples.
+//
+// Colors outside of the table, i.e. brighter than maxInputNits or too dark to interpolate
+// accurately, are passed to ToneMapper::lookupTonemapGain() instead.
+class TonemapGainLut {
+public:
+    enum class Type {
+        // A 1D table if the tone mapper allows it, a 3D table otherwise.
+        Auto,
+        // A 3D table, regardless of the tone mapper.
+        ThreeDimensional,
+    };
+
+    struct Options {
+        Type type = Type::Auto;
+        // The brightest input color in nits that is looked up in the table.
+        float maxInputNits = 10000.f;
+        // Number of samples of a 1D table.
+        size_t size1D = 1024;
+        // Number of samples along each axis of a 3D table.
+        size_t size3D = 33;
+        // Converts linear RGB to XYZ, used to compute the samples of a 3D table.
+        mat3 linearRGBToXYZ;
+    };
+
+    // Computes a table. Prefer get(), which shares tables between callers.
+    TonemapGainLut(ToneMapper* toneMapper,
+                   aidl::android::hardware::graphics::common::Dataspace sourceDataspace,
+                   aidl::android::hardware::graphics::common::Dataspace destinationDataspace,
+                   const Metadata& metadata, const Options& options);
+
+    // Returns the table for the given arguments, computing it only if it is not one of the last
+    // few tables that were returned. Tables are shared, and are matched by the contents of
+    // metadata except for metadata.buffer, which is matched by address.
+    static std::shared_ptr<const TonemapGainLut> get(
+            ToneMapper* toneMapper,
+            aidl::android::hardware::graphics::common::Dataspace sourceDataspace,
+            aidl::android::hardware::graphics::common::Dataspace destinationDataspace,
+            const Metadata& metadata, const Options& options);
+
+    bool isThreeDimensional() const { return mThreeDimensional; }
+
+    // Looks up the gains of count colors, like ToneMapper::lookupTonemapGain() does.
+    void lookupTonemapGain(const Color* colors, size_t count, ToneMapper::Gain* gains) const;
+
+    std::vector<ToneMapper::Gain> lookupTonemapGain(const std::vector<Color>& colors) const;
+
+private:
+    // Returns the position of nits in the table, in samples, or -1 if it is outside the table.
+    float toTablePosition(float nits, size_t size) const;
+    // Returns the nits of the sample at index i.
+    float toNits(size_t i, size_t size) const;
+
+    ToneMapper::Gain lookup1D(float value) const;
+    ToneMapper::Gain lookup3D(const vec3& linearRGB) const;
+
+    ToneMapper* const mToneMapper;
+    const aidl::android::hardware::graphics::common::Dataspace mSourceDataspace;
+    const aidl::android::hardware::graphics::common::Dataspace mDestinationDataspace;
+    const Metadata mMetadata;
+    const Options mOptions;
+    const ToneMapper::GainInput mGainInput;
+    const bool mThreeDimensional;
+    std::vector<float> mGains;
+};
+
+} // namespace android::tonemap
@@ -17,7 +17,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <tonemap/tonemap.h>
+#include <tonemap/tonemapgainlut.h>
 #include <cmath>
+#include <random>
 
 namespace android {
 
@@ -85,4 +87,137 @@ TEST_F(TonemapTest, generateTonemapGainShaderSkSL_containsEntryPointForHLG) {
     EXPECT_THAT(shader, HasSubstr("float libtonemap_LookupTonemapGain(vec3 linearRGB, vec3 xyz)"));
 }
 
+using aidl::android::hardware::graphics::common::Dataspace;
+
+struct TonemapGainLutTest : public ::testing::Test {
+    // Random colors up to 10000 nits, more of them dark than bright like in real content, and some
+    // that can not be looked up in a table.
+    std::vector<tonemap::Color> randomColors(const mat3& linearRGBToXYZ) {
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<float> distribution(0.f, 1.f);
+        std::vector<tonemap::Color> colors;
+        for (int i = 0; i < 10000; i++) {
+            vec3 linearRGB(distribution(generator), distribution(generator),
+                           distribution(generator));
+            linearRGB = linearRGB * linearRGB * linearRGB * 10000.f;
+            colors.push_back({.linearRGB = linearRGB, .xyz = linearRGBToXYZ * linearRGB});
+        }
+        for (const vec3& linearRGB : {vec3(0.f), vec3(1e-4f), vec3(-1.f, 0.f, 0.f),
+                                      vec3(20000.f, 0.f, 0.f), vec3(10000.f), vec3(NAN)}) {
+            colors.push_back({.linearRGB = linearRGB, .xyz = linearRGBToXYZ * linearRGB});
+        }
+        return colors;
+    }
+
+    void expectGainsNear(const std::vector<tonemap::ToneMapper::Gain>& expected,
+                         const std::vector<tonemap::ToneMapper::Gain>& actual,
+                         double maxRelativeError) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (std::isnan(expected[i])) {
+                EXPECT_TRUE(std::isnan(actual[i])) << "color " << i;
+            } else {
+                EXPECT_NEAR(expected[i], actual[i], std::abs(expected[i]) * maxRelativeError)
+                        << "color " << i;
+            }
+        }
+    }
+
+    const tonemap::Metadata kMetadata{.displayMaxLuminance = 500.f,
+                                      .contentMaxLuminance = 1000.f,
+                                      .currentDisplayLuminance = 300.f};
+    // Linear BT2020 to XYZ
+    const mat3 kBt2020ToXYZ{vec3(0.636958f, 0.262700f, 0.000000f),
+                            vec3(0.144617f, 0.677998f, 0.028073f),
+                            vec3(0.168881f, 0.059302f, 1.060985f)};
+};
+
+TEST_F(TonemapGainLutTest, matchesToneMapper) {
+    tonemap::ToneMapper* toneMapper = tonemap::getToneMapper();
+    const auto colors = randomColors(kBt2020ToXYZ);
+    for (Dataspace source : {Dataspace::BT2020_ITU_PQ, Dataspace::BT2020_ITU_HLG,
+                             Dataspace::DISPLAY_P3}) {
+        for (Dataspace destination : {Dataspace::BT2020_ITU_PQ, Dataspace::BT2020_ITU_HLG,
+                                      Dataspace::DISPLAY_P3}) {
+            SCOPED_TRACE(testing::Message() << "source " << static_cast<int32_t>(source)
+                                            << " destination "
+                                            << static_cast<int32_t>(destination));
+            const tonemap::TonemapGainLut lut(toneMapper, source, destination, kMetadata,
+                                              {.linearRGBToXYZ = kBt2020ToXYZ});
+            EXPECT_EQ(lut.isThreeDimensional(),
+                      toneMapper->getGainInput() == tonemap::ToneMapper::GainInput::Color);
+            expectGainsNear(toneMapper->lookupTonemapGain(source, destination, colors, kMetadata),
+                            lut.lookupTonemapGain(colors), 0.005);
+        }
+    }
+}
+
+// Tone maps by luminance with a smooth curve, like a tone mapper that needs a 3D table may.
+class SmoothToneMapper : public tonemap::ToneMapper {
+public:
+    std::string generateTonemapGainShaderSkSL(Dataspace, Dataspace) override { return ""; }
+
+    std::vector<tonemap::ShaderUniform> generateShaderSkSLUniforms(
+            const tonemap::Metadata&) override {
+        return {};
+    }
+
+    std::vector<Gain> lookupTonemapGain(Dataspace, Dataspace,
+                                        const std::vector<tonemap::Color>& colors,
+                                        const tonemap::Metadata& metadata) override {
+        std::vector<Gain> gains;
+        for (const auto& [_, xyz] : colors) {
+            gains.push_back(xyz.y <= 0.f ? 1.0
+                                         : metadata.displayMaxLuminance /
+                                            (metadata.displayMaxLuminance + xyz.y));
+        }
+        return gains;
+    }
+};
+
+TEST_F(TonemapGainLutTest, threeDimensionalMatchesToneMapper) {
+    SmoothToneMapper toneMapper;
+    const auto colors = randomColors(kBt2020ToXYZ);
+    const tonemap::TonemapGainLut lut(&toneMapper, Dataspace::BT2020_ITU_PQ, Dataspace::DISPLAY_P3,
+                                      kMetadata, {.linearRGBToXYZ = kBt2020ToXYZ});
+    ASSERT_TRUE(lut.isThreeDimensional());
+    expectGainsNear(toneMapper.lookupTonemapGain(Dataspace::BT2020_ITU_PQ, Dataspace::DISPLAY_P3,
+                                                 colors, kMetadata),
+                    lut.lookupTonemapGain(colors), 0.01);
+}
+
+TEST_F(TonemapGainLutTest, threeDimensionalForced) {
+    tonemap::ToneMapper* toneMapper = tonemap::getToneMapper();
+    const tonemap::TonemapGainLut lut(toneMapper, Dataspace::BT2020_ITU_PQ, Dataspace::DISPLAY_P3,
+                                      kMetadata,
+                                      {.type = tonemap::TonemapGainLut::Type::ThreeDimensional,
+                                       .linearRGBToXYZ = kBt2020ToXYZ});
+    ASSERT_TRUE(lut.isThreeDimensional());
+    // The gain depends on the brightest channel, which has a kink wherever two channels are equal,
+    // so a 3D table of it is less accurate than a 1D table.
+    const auto colors = randomColors(kBt2020ToXYZ);
+    expectGainsNear(toneMapper->lookupTonemapGain(Dataspace::BT2020_ITU_PQ, Dataspace::DISPLAY_P3,
+                                                  colors, kMetadata),
+                    lut.lookupTonemapGain(colors), 0.1);
+}
+
+TEST_F(TonemapGainLutTest, getSharesTables) {
+    tonemap::ToneMapper* toneMapper = tonemap::getToneMapper();
+    const auto lut = tonemap::TonemapGainLut::get(toneMapper, Dataspace::BT2020_ITU_PQ,
+                                                  Dataspace::DISPLAY_P3, kMetadata, {});
+    ASSERT_NE(nullptr, lut);
+    EXPECT_EQ(lut,
+              tonemap::TonemapGainLut::get(toneMapper, Dataspace::BT2020_ITU_PQ,
+                                           Dataspace::DISPLAY_P3, kMetadata, {}));
+
+    tonemap::Metadata brighter = kMetadata;
+    brighter.displayMaxLuminance *= 2;
+    EXPECT_NE(lut,
+              tonemap::TonemapGainLut::get(toneMapper, Dataspace::BT2020_ITU_PQ,
+                                           Dataspace::DISPLAY_P3, brighter, {}));
+    EXPECT_NE(lut,
+              tonemap::TonemapGainLut::get(toneMapper, Dataspace::BT2020_ITU_HLG,
+                                           Dataspace::DISPLAY_P3, kMetadata, {}));
+}
+
 } // namespace android
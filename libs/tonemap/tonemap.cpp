@@ -432,6 +432,8 @@ public:
         }
         return gains;
     }
+
+    GainInput getGainInput() const override { return GainInput::LuminanceY; }
 };
 
 class ToneMapper13 : public ToneMapper {
@@ -726,6 +728,8 @@ public:
         }
         return gains;
     }
+
+    GainInput getGainInput() const override { return GainInput::MaxLinearRGB; }
 };
 
 } // namespace
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tonemap/tonemapgainlut.h>
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <mutex>
+
+namespace android::tonemap {
+
+namespace {
+
+using aidl::android::hardware::graphics::common::Dataspace;
+
+// Number of tables kept by TonemapGainLut::get(). A caller usually needs one table per dataspace
+// of the content it tone maps.
+static const constexpr size_t kMaxCachedLuts = 4;
+
+struct LutKey {
+    ToneMapper* toneMapper;
+    Dataspace sourceDataspace;
+    Dataspace destinationDataspace;
+    Metadata metadata;
+    TonemapGainLut::Options options;
+
+    bool operator==(const LutKey& other) const {
+        return toneMapper == other.toneMapper && sourceDataspace == other.sourceDataspace &&
+                destinationDataspace == other.destinationDataspace &&
+                metadata.displayMaxLuminance == other.metadata.displayMaxLuminance &&
+                metadata.contentMaxLuminance == other.metadata.contentMaxLuminance &&
+                metadata.currentDisplayLuminance == other.metadata.currentDisplayLuminance &&
+                metadata.buffer == other.metadata.buffer &&
+                metadata.renderIntent == other.metadata.renderIntent &&
+                options.type == other.options.type &&
+                options.maxInputNits == other.options.maxInputNits &&
+                options.size1D == other.options.size1D && options.size3D == other.options.size3D &&
+                options.linearRGBToXYZ[0] == other.options.linearRGBToXYZ[0] &&
+                options.linearRGBToXYZ[1] == other.options.linearRGBToXYZ[1] &&
+                options.linearRGBToXYZ[2] == other.options.linearRGBToXYZ[2];
+    }
+};
+
+float interpolate(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+
+} // namespace
+
+TonemapGainLut::TonemapGainLut(ToneMapper* toneMapper, Dataspace sourceDataspace,
+                               Dataspace destinationDataspace, const Metadata& metadata,
+                               const Options& options)
+      : mToneMapper(toneMapper),
+        mSourceDataspace(sourceDataspace),
+        mDestinationDataspace(destinationDataspace),
+        mMetadata(metadata),
+        mOptions(Options{.type = options.type,
+                         .maxInputNits = options.maxInputNits,
+                         .size1D = std::max(options.size1D, static_cast<size_t>(3)),
+                         .size3D = std::max(options.size3D, static_cast<size_t>(3)),
+                         .linearRGBToXYZ = options.linearRGBToXYZ}),
+        mGainInput(toneMapper->getGainInput()),
+        mThreeDimensional(options.type == Type::ThreeDimensional ||
+                          mGainInput == ToneMapper::GainInput::Color) {
+    std::vector<Color> samples;
+    if (mThreeDimensional) {
+        const size_t size = mOptions.size3D;
+        samples.reserve(size * size * size);
+        for (size_t b = 0; b < size; b++) {
+            for (size_t g = 0; g < size; g++) {
+                for (size_t r = 0; r < size; r++) {
+                    const vec3 linearRGB(toNits(r, size), toNits(g, size), toNits(b, size));
+                    samples.push_back({.linearRGB = linearRGB,
+                                       .xyz = mOptions.linearRGBToXYZ * linearRGB});
+                }
+            }
+        }
+    } else {
+        // The gain only depends on one value, so it does not matter what the other parts of the
+        // color are.
+        samples.reserve(mOptions.size1D);
+        for (size_t i = 0; i < mOptions.size1D; i++) {
+            const float nits = toNits(i, mOptions.size1D);
+            samples.push_back({.linearRGB = vec3(nits), .xyz = vec3(nits)});
+        }
+    }
+
+    const std::vector<ToneMapper::Gain> gains =
+            mToneMapper->lookupTonemapGain(mSourceDataspace, mDestinationDataspace, samples,
+                                           mMetadata);
+    mGains.assign(gains.begin(), gains.end());
+}
+
+std::shared_ptr<const TonemapGainLut> TonemapGainLut::get(ToneMapper* toneMapper,
+                                                          Dataspace sourceDataspace,
+                                                          Dataspace destinationDataspace,
+                                                          const Metadata& metadata,
+                                                          const Options& options) {
+    static std::mutex sMutex;
+    // Most recently used first.
+    static std::list<std::pair<LutKey, std::shared_ptr<const TonemapGainLut>>> sLuts;
+
+    const LutKey key{toneMapper, sourceDataspace, destinationDataspace, metadata, options};
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        for (auto it = sLuts.begin(); it != sLuts.end(); it++) {
+            if (it->first == key) {
+                sLuts.splice(sLuts.begin(), sLuts, it);
+                return sLuts.front().second;
+            }
+        }
+    }
+
+    // Computing a table takes a while, so don't block other lookups meanwhile. Two threads that
+    // miss at once both compute the table, and only one of the copies is kept.
+    auto lut = std::make_shared<const TonemapGainLut>(toneMapper, sourceDataspace,
+                                                      destinationDataspace, metadata, options);
+    std::lock_guard<std::mutex> lock(sMutex);
+    sLuts.emplace_front(key, lut);
+    if (sLuts.size() > kMaxCachedLuts) {
+        sLuts.pop_back();
+    }
+    return lut;
+}
+
+// Samples are spaced evenly in the square root of the nits, so that there are more of them near
+// black, where tone curves change the most.
+float TonemapGainLut::toNits(size_t i, size_t size) const {
+    const float t = static_cast<float>(i) / static_cast<float>(size - 1);
+    return t * t * mOptions.maxInputNits;
+}
+
+float TonemapGainLut::toTablePosition(float nits, size_t size) const {
+    // Also rejects NaN.
+    if (!(nits >= 0.f && nits <= mOptions.maxInputNits)) {
+        return -1.f;
+    }
+    return std::sqrt(nits / mOptions.maxInputNits) * static_cast<float>(size - 1);
+}
+
+ToneMapper::Gain TonemapGainLut::lookup1D(float value) const {
+    const size_t size = mOptions.size1D;
+    const float position = toTablePosition(value, size);
+    // Tone curves may change too quickly between black and the first sample to interpolate, and
+    // the gain of black itself is special cased by tone mappers.
+    if (position < 1.f) {
+        return NAN;
+    }
+    const size_t i = std::min(static_cast<size_t>(position), size - 2);
+    return interpolate(mGains[i], mGains[i + 1], position - static_cast<float>(i));
+}
+
+ToneMapper::Gain TonemapGainLut::lookup3D(const vec3& linearRGB) const {
+    const size_t size = mOptions.size3D;
+    const float r = toTablePosition(linearRGB.r, size);
+    const float g = toTablePosition(linearRGB.g, size);
+    const float b = toTablePosition(linearRGB.b, size);
+    if (r < 0.f || g < 0.f || b < 0.f || std::max({r, g, b}) < 1.f) {
+        return NAN;
+    }
+
+    const size_t r0 = std::min(static_cast<size_t>(r), size - 2);
+    const size_t g0 = std::min(static_cast<size_t>(g), size - 2);
+    const size_t b0 = std::min(static_cast<size_t>(b), size - 2);
+    const float rt = r - static_cast<float>(r0);
+    const float gt = g - static_cast<float>(g0);
+    const float bt = b - static_cast<float>(b0);
+
+    const float* c000 = &mGains[(b0 * size + g0) * size + r0];
+    const float* c010 = c000 + size;
+    const float* c001 = c000 + size * size;
+    const float* c011 = c001 + size;
+    const float c00 = interpolate(c000[0], c000[1], rt);
+    const float c10 = interpolate(c010[0], c010[1], rt);
+    const float c01 = interpolate(c001[0], c001[1], rt);
+    const float c11 = interpolate(c011[0], c011[1], rt);
+    return interpolate(interpolate(c00, c10, gt), interpolate(c01, c11, gt), bt);
+}
+
+void TonemapGainLut::lookupTonemapGain(const Color* colors, size_t count,
+                                       ToneMapper::Gain* gains) const {
+    std::vector<Color> misses;
+    std::vector<size_t> missIndices;
+    for (size_t i = 0; i < count; i++) {
+        const Color& color = colors[i];
+        ToneMapper::Gain gain;
+        if (mThreeDimensional) {
+            gain = lookup3D(color.linearRGB);
+        } else if (mGainInput == ToneMapper::GainInput::MaxLinearRGB) {
+            gain = lookup1D(std::max({color.linearRGB.r, color.linearRGB.g, color.linearRGB.b}));
+        } else {
+            gain = lookup1D(color.xyz.y);
+        }
+        if (std::isnan(gain)) {
+            misses.push_back(color);
+            missIndices.push_back(i);
+        }
+        gains[i] = gain;
+    }
+
+    if (!misses.empty()) {
+        const std::vector<ToneMapper::Gain> missGains =
+                mToneMapper->lookupTonemapGain(mSourceDataspace, mDestinationDataspace, misses,
+                                               mMetadata);
+        for (size_t i = 0; i < missIndices.size(); i++) {
+            gains[missIndices[i]] = missGains[i];
+        }
+    }
+}
+
+std::vector<ToneMapper::Gain> TonemapGainLut::lookupTonemapGain(
+        const std::vector<Color>& colors) const {
+    std::vector<ToneMapper::Gain> gains(colors.size());
+    lookupTonemapGain(colors.data(), colors.size(), gains.data());
+    return gains;
+}
+
+} // namespace android::tonemap
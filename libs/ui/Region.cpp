@@ -19,6 +19,9 @@
 #include <inttypes.h>
 #include <limits.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <android-base/stringprintf.h>
 
 #include <utils/Log.h>
@@ -66,6 +69,34 @@ const Region Region::INVALID_REGION(Rect::INVALID_RECT);
 
 // ----------------------------------------------------------------------------
 
+// Rects reused by every boolean operation of a thread, for operands that alias the destination and
+// for the spans being rasterized, so that operations don't allocate once the thread has seen
+// regions of a given size.
+struct ScratchRects {
+    // Retained capacity, beyond which the rects are freed after each operation.
+    static constexpr size_t kMaxRetainedRects = 256;
+
+    std::vector<Rect> lhs;
+    std::vector<Rect> rhs;
+    std::vector<Rect> span;
+
+    static ScratchRects& get() {
+        static thread_local ScratchRects scratch;
+        return scratch;
+    }
+
+    void trim() {
+        for (std::vector<Rect>* rects : {&lhs, &rhs, &span}) {
+            rects->clear();
+            if (rects->capacity() > kMaxRetainedRects) {
+                rects->shrink_to_fit();
+            }
+        }
+    }
+};
+
+// ----------------------------------------------------------------------------
+
 Region::Region() {
     mStorage.push_back(Rect(0, 0));
 }
@@ -329,8 +360,7 @@ Region& Region::subtractSelf(const Rect& r) {
     return operationSelf(r, op_nand);
 }
 Region& Region::operationSelf(const Rect& r, uint32_t op) {
-    Region lhs(*this);
-    boolean_operation(op, *this, lhs, r);
+    boolean_operation(op, *this, *this, r);
     return *this;
 }
 
@@ -353,8 +383,7 @@ Region& Region::subtractSelf(const Region& rhs) {
     return operationSelf(rhs, op_nand);
 }
 Region& Region::operationSelf(const Region& rhs, uint32_t op) {
-    Region lhs(*this);
-    boolean_operation(op, *this, lhs, rhs);
+    boolean_operation(op, *this, *this, rhs);
     return *this;
 }
 
@@ -438,8 +467,7 @@ Region& Region::subtractSelf(const Region& rhs, int dx, int dy) {
     return operationSelf(rhs, dx, dy, op_nand);
 }
 Region& Region::operationSelf(const Region& rhs, int dx, int dy, uint32_t op) {
-    Region lhs(*this);
-    boolean_operation(op, *this, lhs, rhs, dx, dy);
+    boolean_operation(op, *this, *this, rhs, dx, dy);
     return *this;
 }
 
@@ -473,12 +501,14 @@ class Region::rasterizer : public region_operator<Rect>::region_rasterizer
     FatVector<Rect>& storage;
     Rect* head;
     Rect* tail;
-    FatVector<Rect> span;
+    std::vector<Rect>& span;
     Rect* cur;
 public:
     explicit rasterizer(Region& reg)
-        : bounds(INT_MAX, 0, INT_MIN, 0), storage(reg.mStorage), head(), tail(), cur() {
+        : bounds(INT_MAX, 0, INT_MIN, 0), storage(reg.mStorage), head(), tail(),
+          span(ScratchRects::get().span), cur() {
         storage.clear();
+        span.clear();
     }
 
     virtual ~rasterizer();
@@ -643,6 +673,249 @@ bool Region::validate(const Region& reg, const char* name, bool silent)
     return result;
 }
 
+// The spans of the band between top and bottom of the operation on two rects, of which the band
+// is within inLhs and inRhs. Returns the number of spans, as left and right pairs in spans.
+static size_t band_operation(uint32_t op, const Rect& lhs, bool inLhs, const Rect& rhs,
+                             bool inRhs, int32_t spans[4]) {
+    switch (op) {
+        case op_and:
+            if (inLhs && inRhs && std::max(lhs.left, rhs.left) < std::min(lhs.right, rhs.right)) {
+                spans[0] = std::max(lhs.left, rhs.left);
+                spans[1] = std::min(lhs.right, rhs.right);
+                return 1;
+            }
+            return 0;
+        case op_nand: {
+            if (!inLhs) return 0;
+            if (!inRhs) {
+                spans[0] = lhs.left;
+                spans[1] = lhs.right;
+                return 1;
+            }
+            size_t count = 0;
+            if (lhs.left < rhs.left) {
+                spans[2 * count] = lhs.left;
+                spans[2 * count + 1] = std::min(lhs.right, rhs.left);
+                count++;
+            }
+            if (rhs.right < lhs.right) {
+                spans[2 * count] = std::max(lhs.left, rhs.right);
+                spans[2 * count + 1] = lhs.right;
+                count++;
+            }
+            return count;
+        }
+        case op_or:
+        case op_xor: {
+            if (!inLhs || !inRhs) {
+                const Rect& r = inLhs ? lhs : rhs;
+                spans[0] = r.left;
+                spans[1] = r.right;
+                return (inLhs || inRhs) ? 1 : 0;
+            }
+            const Rect& first = lhs.left <= rhs.left ? lhs : rhs;
+            const Rect& second = lhs.left <= rhs.left ? rhs : lhs;
+            if (first.right < second.left) {
+                spans[0] = first.left;
+                spans[1] = first.right;
+                spans[2] = second.left;
+                spans[3] = second.right;
+                return 2;
+            }
+            if (op == op_or || first.right == second.left) {
+                // touching spans are merged
+                spans[0] = first.left;
+                spans[1] = std::max(first.right, second.right);
+                return 1;
+            }
+            size_t count = 0;
+            if (first.left < second.left) {
+                spans[0] = first.left;
+                spans[1] = second.left;
+                count++;
+            }
+            if (first.right != second.right) {
+                spans[2 * count] = std::min(first.right, second.right);
+                spans[2 * count + 1] = std::max(first.right, second.right);
+                count++;
+            }
+            return count;
+        }
+    }
+    return 0;
+}
+
+// Whether outer covers all of inner, which isn't empty.
+static bool covers(const Rect& outer, const Rect& inner) {
+    return outer.left <= inner.left && outer.top <= inner.top && outer.right >= inner.right &&
+            outer.bottom >= inner.bottom;
+}
+
+bool Region::boolean_operation_shortcut(uint32_t op, Region& dst, Rect const* lhs,
+                                        size_t lhsCount, const Rect& lhsBounds,
+                                        Rect const* rhs, size_t rhsCount,
+                                        const Rect& rhsBounds, int dx, int dy) {
+    if (op != op_and && op != op_nand && op != op_or && op != op_xor) {
+        return false;
+    }
+    // only regions of several rects may be trusted to not be invalid
+    if ((lhsCount == 1 && !lhsBounds.isValid()) || (rhsCount == 1 && !rhsBounds.isValid())) {
+        return false;
+    }
+
+    // the operands may be dst itself
+    auto setRects = [&dst](Rect const* rects, size_t count, const Rect& bounds, int x, int y) {
+        if (rects != dst.mStorage.data()) {
+            dst.mStorage.clear();
+            dst.mStorage.insert(dst.mStorage.end(), rects, rects + count);
+            if (count > 1) {
+                dst.mStorage.push_back(bounds);
+            }
+        }
+        translate(dst, x, y);
+    };
+    auto setLhs = [&]() { setRects(lhs, lhsCount, lhsBounds, 0, 0); };
+    auto setRhs = [&]() { setRects(rhs, rhsCount, rhsBounds, dx, dy); };
+
+    Rect rhsRect(rhsBounds);
+    rhsRect.offsetBy(dx, dy);
+    const bool lhsEmpty = lhsBounds.isEmpty();
+    const bool rhsEmpty = rhsRect.isEmpty();
+    if (lhsEmpty || rhsEmpty) {
+        if (op == op_and || (op == op_nand && lhsEmpty) || (lhsEmpty && rhsEmpty)) {
+            dst.clear();
+        } else if (rhsEmpty) {
+            setLhs();
+        } else {
+            setRhs();
+        }
+        return true;
+    }
+
+    if (lhs == rhs && dx == 0 && dy == 0) {
+        if (op == op_and || op == op_or) {
+            setLhs();
+        } else {
+            dst.clear();
+        }
+        return true;
+    }
+
+    Rect overlap;
+    if (!lhsBounds.intersect(rhsRect, &overlap)) {
+        if (op == op_and) {
+            dst.clear();
+            return true;
+        }
+        if (op == op_nand) {
+            setLhs();
+            return true;
+        }
+    }
+
+    if (lhsCount == 1 && rhsCount == 1) {
+        // rasterize the bands between the edges of the two rects
+        const Rect lhsRect(lhsBounds);
+        int32_t edges[4] = {lhsRect.top, lhsRect.bottom, rhsRect.top, rhsRect.bottom};
+        std::sort(edges, edges + 4);
+        const size_t edgeCount = static_cast<size_t>(std::unique(edges, edges + 4) - edges);
+
+        FatVector<Rect>& storage = dst.mStorage;
+        storage.clear();
+        Rect bounds(INT_MAX, 0, INT_MIN, 0);
+        size_t lastCount = 0;
+        for (size_t i = 0; i + 1 < edgeCount; i++) {
+            const int32_t top = edges[i];
+            const int32_t bottom = edges[i + 1];
+            int32_t spans[4];
+            const size_t count =
+                    band_operation(op, lhsRect, lhsRect.top <= top && bottom <= lhsRect.bottom,
+                                   rhsRect, rhsRect.top <= top && bottom <= rhsRect.bottom, spans);
+            bool merge = count != 0 && count == lastCount && storage.back().bottom == top;
+            for (size_t j = 0; merge && j < count; j++) {
+                const Rect& last = storage[storage.size() - count + j];
+                merge = last.left == spans[2 * j] && last.right == spans[2 * j + 1];
+            }
+            if (merge) {
+                for (size_t j = 0; j < count; j++) {
+                    storage[storage.size() - count + j].bottom = bottom;
+                }
+            } else if (count != 0) {
+                for (size_t j = 0; j < count; j++) {
+                    storage.push_back(Rect(spans[2 * j], top, spans[2 * j + 1], bottom));
+                }
+                bounds.left = std::min(bounds.left, spans[0]);
+                bounds.right = std::max(bounds.right, spans[2 * count - 1]);
+            }
+            lastCount = count;
+        }
+        if (storage.empty()) {
+            dst.clear();
+        } else if (storage.size() > 1) {
+            bounds.top = storage.front().top;
+            bounds.bottom = storage.back().bottom;
+            storage.push_back(bounds);
+        }
+        return true;
+    }
+
+    if (lhsCount == 1) {
+        const Rect lhsRect(lhsBounds);
+        if (covers(lhsRect, rhsRect)) {
+            if (op == op_and) {
+                setRhs();
+                return true;
+            }
+            if (op == op_or) {
+                dst.set(lhsRect);
+                return true;
+            }
+        }
+        for (size_t i = 0; i < rhsCount && rhs[i].top + dy <= lhsRect.top; i++) {
+            if (covers(Rect(rhs[i]).offsetBy(dx, dy), lhsRect)) {
+                if (op == op_and) {
+                    dst.set(lhsRect);
+                } else if (op == op_nand) {
+                    dst.clear();
+                } else if (op == op_or) {
+                    setRhs();
+                } else {
+                    return false;
+                }
+                return true;
+            }
+        }
+    } else if (rhsCount == 1) {
+        if (covers(rhsRect, lhsBounds)) {
+            if (op == op_and) {
+                setLhs();
+                return true;
+            }
+            if (op == op_nand) {
+                dst.clear();
+                return true;
+            }
+            if (op == op_or) {
+                dst.set(rhsRect);
+                return true;
+            }
+        }
+        for (size_t i = 0; i < lhsCount && lhs[i].top <= rhsRect.top; i++) {
+            if (covers(lhs[i], rhsRect)) {
+                if (op == op_and) {
+                    dst.set(rhsRect);
+                } else if (op == op_or) {
+                    setLhs();
+                } else {
+                    return false;
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void Region::boolean_operation(uint32_t op, Region& dst,
         const Region& lhs,
         const Region& rhs, int dx, int dy)
@@ -654,17 +927,32 @@ void Region::boolean_operation(uint32_t op, Region& dst,
 #endif
 
     size_t lhs_count;
-    Rect const * const lhs_rects = lhs.getArray(&lhs_count);
+    Rect const * lhs_rects = lhs.getArray(&lhs_count);
 
     size_t rhs_count;
-    Rect const * const rhs_rects = rhs.getArray(&rhs_count);
+    Rect const * rhs_rects = rhs.getArray(&rhs_count);
+
+    if (!boolean_operation_shortcut(op, dst, lhs_rects, lhs_count, lhs.getBounds(), rhs_rects,
+                                    rhs_count, rhs.getBounds(), dx, dy)) {
+        // the rasterizer overwrites dst while the operands are being read
+        ScratchRects& scratch = ScratchRects::get();
+        if (&lhs == &dst) {
+            scratch.lhs.assign(lhs_rects, lhs_rects + lhs_count);
+            lhs_rects = scratch.lhs.data();
+        }
+        if (&rhs == &dst) {
+            scratch.rhs.assign(rhs_rects, rhs_rects + rhs_count);
+            rhs_rects = scratch.rhs.data();
+        }
 
-    region_operator<Rect>::region lhs_region(lhs_rects, lhs_count);
-    region_operator<Rect>::region rhs_region(rhs_rects, rhs_count, dx, dy);
-    region_operator<Rect> operation(op, lhs_region, rhs_region);
-    { // scope for rasterizer (dtor has side effects)
-        rasterizer r(dst);
-        operation(r);
+        region_operator<Rect>::region lhs_region(lhs_rects, lhs_count);
+        region_operator<Rect>::region rhs_region(rhs_rects, rhs_count, dx, dy);
+        region_operator<Rect> operation(op, lhs_region, rhs_region);
+        { // scope for rasterizer (dtor has side effects)
+            rasterizer r(dst);
+            operation(r);
+        }
+        scratch.trim();
     }
 
 #if defined(VALIDATE_REGIONS)
@@ -767,16 +1055,32 @@ void Region::boolean_operation(uint32_t op, Region& dst,
 #if VALIDATE_WITH_CORECG || defined(VALIDATE_REGIONS)
     boolean_operation(op, dst, lhs, Region(rhs), dx, dy);
 #else
+    // rhs may be one of the rects of dst
+    const Rect rhs_rect(rhs);
+
     size_t lhs_count;
-    Rect const * const lhs_rects = lhs.getArray(&lhs_count);
+    Rect const * lhs_rects = lhs.getArray(&lhs_count);
+
+    if (boolean_operation_shortcut(op, dst, lhs_rects, lhs_count, lhs.getBounds(), &rhs_rect, 1,
+                                   rhs_rect, dx, dy)) {
+        return;
+    }
+
+    // the rasterizer overwrites dst while the operands are being read
+    ScratchRects& scratch = ScratchRects::get();
+    if (&lhs == &dst) {
+        scratch.lhs.assign(lhs_rects, lhs_rects + lhs_count);
+        lhs_rects = scratch.lhs.data();
+    }
 
     region_operator<Rect>::region lhs_region(lhs_rects, lhs_count);
-    region_operator<Rect>::region rhs_region(&rhs, 1, dx, dy);
+    region_operator<Rect>::region rhs_region(&rhs_rect, 1, dx, dy);
     region_operator<Rect> operation(op, lhs_region, rhs_region);
     { // scope for rasterizer (dtor has side effects)
         rasterizer r(dst);
         operation(r);
     }
+    scratch.trim();
 
 #endif
 }
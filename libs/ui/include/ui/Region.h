@@ -171,6 +171,13 @@ private:
     static void boolean_operation(uint32_t op, Region& dst,
             const Region& lhs, const Rect& rhs);
 
+    // Computes the operations that don't need the rasterizer, such as those
+    // on two rects or on operands that cover each other. Returns false if op
+    // has to be rasterized.
+    static bool boolean_operation_shortcut(uint32_t op, Region& dst,
+            Rect const* lhs, size_t lhsCount, const Rect& lhsBounds,
+            Rect const* rhs, size_t rhsCount, const Rect& rhsBounds, int dx, int dy);
+
     static void translate(Region& reg, int dx, int dy);
     static void translate(Region& dst, const Region& reg, int dx, int dy);
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <ui/Rect.h>
+#include <ui/Region.h>
+
+#include <random>
+#include <vector>
+
+namespace android {
+namespace {
+
+const Rect kDisplay(1080, 2400);
+
+struct Layer {
+    Rect bounds;
+    bool opaque;
+    int32_t shadowLength;
+    Region transparentRegion;
+};
+
+// Windows of a phone screen from top to bottom: status and navigation bars, some dialogs and
+// popups over the app windows, and a wallpaper.
+std::vector<Layer> randomLayers(size_t count) {
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int32_t> x(-100, 1000);
+    std::uniform_int_distribution<int32_t> y(-100, 2300);
+    std::uniform_int_distribution<int32_t> size(50, 1200);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<Layer> layers;
+    layers.push_back({Rect(0, 0, 1080, 80), false, 0, Region()});
+    layers.push_back({Rect(0, 2280, 1080, 2400), false, 0, Region()});
+    while (layers.size() + 1 < count) {
+        Layer layer;
+        if (percent(generator) < 50) {
+            layer.bounds = kDisplay;
+        } else {
+            const int32_t left = x(generator);
+            const int32_t top = y(generator);
+            layer.bounds = Rect(left, top, left + size(generator), top + size(generator));
+        }
+        layer.opaque = percent(generator) < 70;
+        layer.shadowLength = percent(generator) < 20 ? 24 : 0;
+        if (!layer.opaque && percent(generator) < 30) {
+            layer.transparentRegion.set(Rect(layer.bounds.left + 10, layer.bounds.top + 10,
+                                             layer.bounds.left + 60, layer.bounds.top + 60));
+        }
+        layers.push_back(layer);
+    }
+    layers.push_back({kDisplay, true, 0, Region()});
+    return layers;
+}
+
+// The region operations of Output::ensureOutputLayerIfVisible() for every layer of a frame in
+// which all of them changed.
+void BM_ComputeVisibleRegions(benchmark::State& state) {
+    const std::vector<Layer> layers = randomLayers(static_cast<size_t>(state.range(0)));
+    std::vector<Region> oldVisibleRegions(layers.size());
+    for (auto _ : state) {
+        Region aboveOpaqueLayers;
+        Region aboveCoveredLayers;
+        Region dirtyRegion;
+        for (size_t i = 0; i < layers.size(); i++) {
+            const Layer& layer = layers[i];
+            Region visibleRegion(layer.bounds);
+            Region shadowRegion;
+            if (layer.shadowLength > 0) {
+                Rect visibleRectWithShadows(layer.bounds);
+                visibleRectWithShadows.inset(-layer.shadowLength, -layer.shadowLength,
+                                             -layer.shadowLength, -layer.shadowLength);
+                visibleRegion.set(visibleRectWithShadows);
+                shadowRegion = visibleRegion.subtract(layer.bounds);
+            }
+            const Region transparentRegion = layer.transparentRegion.intersect(layer.bounds);
+            Region opaqueRegion;
+            if (layer.opaque) {
+                opaqueRegion.set(layer.bounds);
+            }
+
+            const Region coveredRegion = aboveCoveredLayers.intersect(visibleRegion);
+            aboveCoveredLayers.orSelf(visibleRegion);
+            visibleRegion.subtractSelf(aboveOpaqueLayers);
+            if (visibleRegion.isEmpty()) {
+                continue;
+            }
+
+            Region dirty(visibleRegion);
+            dirty.orSelf(oldVisibleRegions[i]);
+            dirty.subtractSelf(aboveOpaqueLayers);
+            dirtyRegion.orSelf(dirty);
+            aboveOpaqueLayers.orSelf(opaqueRegion);
+
+            Region drawRegion = visibleRegion.subtract(transparentRegion);
+            drawRegion.andSelf(kDisplay);
+            const Region visibleNonShadowRegion = visibleRegion.subtract(shadowRegion);
+            benchmark::DoNotOptimize(visibleNonShadowRegion.intersect(kDisplay));
+            benchmark::DoNotOptimize(coveredRegion);
+            oldVisibleRegions[i] = visibleRegion;
+        }
+        benchmark::DoNotOptimize(dirtyRegion);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ComputeVisibleRegions)->Arg(8)->Arg(32)->Arg(128);
+
+void BM_RectIntersectRect(benchmark::State& state) {
+    const Region region(Rect(0, 0, 1080, 1200));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(region.intersect(Rect(100, 600, 980, 2400)));
+    }
+}
+BENCHMARK(BM_RectIntersectRect);
+
+void BM_RectSubtractRect(benchmark::State& state) {
+    const Region region(kDisplay);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(region.subtract(Rect(100, 600, 980, 1800)));
+    }
+}
+BENCHMARK(BM_RectSubtractRect);
+
+// Subtracting the opaque layers above from a layer covered by them, and adding it to them.
+void BM_RegionOrSelfRect(benchmark::State& state) {
+    Region aboveOpaqueLayers;
+    for (int i = 0; i < state.range(0); i++) {
+        aboveOpaqueLayers.orSelf(Rect(i * 20, i * 40, i * 20 + 300, i * 40 + 300));
+    }
+    for (auto _ : state) {
+        Region region(aboveOpaqueLayers);
+        region.orSelf(Rect(200, 200, 800, 1600));
+        region.subtractSelf(Rect(0, 0, 100, 100));
+        benchmark::DoNotOptimize(region);
+    }
+}
+BENCHMARK(BM_RegionOrSelfRect)->Arg(4)->Arg(16)->Arg(64);
+
+} // namespace
+} // namespace android
+
+BENCHMARK_MAIN();
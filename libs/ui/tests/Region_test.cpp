@@ -17,6 +17,7 @@
 #define LOG_TAG "RegionTest"
 
 #include <stdlib.h>
+#include <vector>
 #include <ui/Region.h>
 #include <ui/Rect.h>
 #include <gtest/gtest.h>
@@ -179,5 +180,131 @@ TEST_F(RegionTest, RegionHash) {
     EXPECT_NE(std::hash<Region>{}(region1), std::hash<Region>{}(region2));
 }
 
+static std::vector<Rect> rects(const Region& region) {
+    return std::vector<Rect>(region.begin(), region.end());
+}
+
+TEST_F(RegionTest, RectOperations) {
+    const Rect a(0, 0, 20, 20);
+    const Rect b(10, 10, 30, 30);
+
+    EXPECT_EQ(rects(Region(a).intersect(b)), std::vector<Rect>({Rect(10, 10, 20, 20)}));
+    EXPECT_EQ(rects(Region(a).merge(b)),
+              std::vector<Rect>({Rect(0, 0, 20, 10), Rect(0, 10, 30, 20), Rect(10, 20, 30, 30)}));
+    EXPECT_EQ(rects(Region(a).subtract(b)),
+              std::vector<Rect>({Rect(0, 0, 20, 10), Rect(0, 10, 10, 20)}));
+    EXPECT_EQ(rects(Region(a).mergeExclusive(b)),
+              std::vector<Rect>({Rect(0, 0, 20, 10), Rect(0, 10, 10, 20), Rect(20, 10, 30, 20),
+                                 Rect(10, 20, 30, 30)}));
+
+    // Touching rects are merged into one
+    EXPECT_EQ(rects(Region(a).merge(Rect(20, 0, 40, 20))), std::vector<Rect>({Rect(0, 0, 40, 20)}));
+    EXPECT_EQ(rects(Region(a).mergeExclusive(Rect(0, 20, 20, 40))),
+              std::vector<Rect>({Rect(0, 0, 20, 40)}));
+
+    // A hole splits the band it is in
+    EXPECT_EQ(rects(Region(a).subtract(Rect(5, 5, 15, 15))),
+              std::vector<Rect>({Rect(0, 0, 20, 5), Rect(0, 5, 5, 15), Rect(15, 5, 20, 15),
+                                 Rect(0, 15, 20, 20)}));
+
+    EXPECT_TRUE(Region(a).intersect(Rect(20, 0, 40, 20)).isEmpty());
+    EXPECT_TRUE(Region(a).subtract(Rect(-10, -10, 40, 40)).isEmpty());
+    EXPECT_EQ(Region(a).subtract(Rect(20, 0, 40, 20)).getBounds(), a);
+    EXPECT_EQ(Region(a).merge(Rect(5, 5, 5, 5)).getBounds(), a);
+    EXPECT_EQ(Region().merge(a).getBounds(), a);
+}
+
+TEST_F(RegionTest, SelfOperations) {
+    Region r;
+    r.orSelf(Rect(0, 0, 10, 10));
+    r.orSelf(Rect(20, 5, 30, 15));
+    const std::vector<Rect> expected = rects(r);
+
+    Region& self = r;
+    r.orSelf(self);
+    EXPECT_EQ(rects(r), expected);
+    r.andSelf(self);
+    EXPECT_EQ(rects(r), expected);
+
+    r.orSelf(*r.begin());
+    EXPECT_EQ(rects(r), expected);
+    r.andSelf(r.getBounds());
+    EXPECT_EQ(rects(r), expected);
+
+    r.orSelf(self, 5, 0);
+    EXPECT_EQ(rects(r),
+              rects(Region(Rect(0, 0, 15, 10)).merge(Rect(20, 5, 35, 15))));
+
+    // More rects than are stored inline
+    Region x;
+    for (int i = 0; i < 8; i++) {
+        x.orSelf(Rect(i * 10, i * 10, i * 10 + 5, i * 10 + 5));
+    }
+    x.xorSelf(x);
+    EXPECT_TRUE(x.isEmpty());
+    r.subtractSelf(self);
+    EXPECT_TRUE(r.isEmpty());
+}
+
+TEST_F(RegionTest, CoveringOperations) {
+    Region r;
+    r.orSelf(Rect(10, 10, 20, 20));
+    r.orSelf(Rect(30, 10, 40, 40));
+    const std::vector<Rect> expected = rects(r);
+    const Rect screen(0, 0, 100, 100);
+
+    EXPECT_EQ(rects(r.intersect(screen)), expected);
+    EXPECT_TRUE(r.subtract(screen).isEmpty());
+    EXPECT_EQ(rects(r.merge(screen)), std::vector<Rect>({screen}));
+    EXPECT_EQ(rects(Region(screen).intersect(r)), expected);
+    EXPECT_EQ(rects(Region(screen).merge(r)), std::vector<Rect>({screen}));
+
+    const Rect inside(32, 15, 38, 35);
+    EXPECT_EQ(rects(r.intersect(inside)), std::vector<Rect>({inside}));
+    EXPECT_EQ(rects(r.merge(inside)), expected);
+    EXPECT_EQ(rects(Region(inside).intersect(r)), std::vector<Rect>({inside}));
+    EXPECT_TRUE(Region(inside).subtract(r).isEmpty());
+    EXPECT_EQ(rects(Region(inside).merge(r)), expected);
+}
+
+TEST_F(RegionTest, Random_Operations) {
+    srandom(54321);
+
+    auto randomRegion = [] {
+        Region r;
+        const int count = random() % 4;
+        for (int i = 0; i < count; i++) {
+            const int left = random() % X_MAX;
+            const int top = random() % Y_MAX;
+            r.orSelf(Rect(left, top, left + random() % (X_MAX - left + 1),
+                          top + random() % (Y_MAX - top + 1)));
+        }
+        return r;
+    };
+
+    for (int iter = 0; iter < ITER_MAX; iter++) {
+        const Region lhs = randomRegion();
+        const Region rhs = randomRegion();
+        const int dx = random() % 5 - 2;
+        const int dy = random() % 5 - 2;
+
+        const Region merged = lhs.merge(rhs, dx, dy);
+        const Region intersected = lhs.intersect(rhs, dx, dy);
+        const Region subtracted = lhs.subtract(rhs, dx, dy);
+        const Region exclusive = lhs.mergeExclusive(rhs, dx, dy);
+
+        for (int x = -2; x < X_MAX + 2; x++) {
+            for (int y = -2; y < Y_MAX + 2; y++) {
+                const bool inLhs = lhs.contains(x, y);
+                const bool inRhs = rhs.contains(x - dx, y - dy);
+                EXPECT_EQ(merged.contains(x, y), inLhs || inRhs);
+                EXPECT_EQ(intersected.contains(x, y), inLhs && inRhs);
+                EXPECT_EQ(subtracted.contains(x, y), inLhs && !inRhs);
+                EXPECT_EQ(exclusive.contains(x, y), inLhs != inRhs);
+            }
+        }
+    }
+}
+
 }; // namespace android
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <ultrahdr/gainmapmath.h>
+#include <ultrahdr/gainmaprowkernels.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace android::ultrahdr {
+namespace {
+
+// One row of a 4000x3000 image.
+constexpr size_t kRowWidth = 4000;
+
+std::vector<float> randomRow(float min, float max) {
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(min, max);
+  std::vector<float> row(kRowWidth);
+  for (float& value : row) {
+    value = distribution(generator);
+  }
+  return row;
+}
+
+// The per pixel kernels of generateGainMap, for an HLG image with a BT.2100 gamut.
+void BM_GenerateGainMapRow(benchmark::State& state, const GainMapRowKernels& kernels) {
+  const GainEncodeParams params = {1.0f, 10.0f, 0.0f, log2f(10.0f)};
+  std::vector<float> r = randomRow(0.0f, 1.0f);
+  std::vector<float> g = randomRow(0.0f, 1.0f);
+  std::vector<float> b = randomRow(0.0f, 1.0f);
+  std::vector<float> sdr(kRowWidth), hdr(kRowWidth);
+  std::vector<uint8_t> map(kRowWidth);
+  for (auto _ : state) {
+    kernels.yuvToRgb(*getYuvToRgbCoeffs(srgbYuvToRgb), r.data(), g.data(), b.data(), kRowWidth);
+    kernels.luminance(*getLuminanceCoeffs(srgbLuminance), kSdrWhiteNits, r.data(), g.data(),
+                      b.data(), sdr.data(), kRowWidth);
+    kernels.convertGamut(*getColorMatrix(bt2100ToBt709), r.data(), g.data(), b.data(), kRowWidth);
+    kernels.luminance(*getLuminanceCoeffs(srgbLuminance), kHlgMaxNits, r.data(), g.data(),
+                      b.data(), hdr.data(), kRowWidth);
+    kernels.encodeGain(params, sdr.data(), hdr.data(), map.data(), kRowWidth);
+    benchmark::DoNotOptimize(map.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kRowWidth);
+}
+BENCHMARK_CAPTURE(BM_GenerateGainMapRow, scalar, getScalarGainMapRowKernels());
+BENCHMARK_CAPTURE(BM_GenerateGainMapRow, best, getGainMapRowKernels());
+
+// The per pixel kernels of applyGainMap, for RGBA1010102 output.
+void BM_ApplyGainMapRow(benchmark::State& state, const GainMapRowKernels& kernels) {
+  std::vector<float> r = randomRow(0.0f, 1.0f);
+  std::vector<float> g = randomRow(0.0f, 1.0f);
+  std::vector<float> b = randomRow(0.0f, 1.0f);
+  std::vector<float> gains = randomRow(1.0f, 10.0f);
+  std::vector<uint32_t> rgba(kRowWidth);
+  for (auto _ : state) {
+    kernels.yuvToRgb(*getYuvToRgbCoeffs(p3YuvToRgb), r.data(), g.data(), b.data(), kRowWidth);
+    kernels.applyGain(gains.data(), 4.0f, r.data(), g.data(), b.data(), kRowWidth);
+    kernels.toRgba1010102(r.data(), g.data(), b.data(), rgba.data(), kRowWidth);
+    benchmark::DoNotOptimize(rgba.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kRowWidth);
+}
+BENCHMARK_CAPTURE(BM_ApplyGainMapRow, scalar, getScalarGainMapRowKernels());
+BENCHMARK_CAPTURE(BM_ApplyGainMapRow, best, getGainMapRowKernels());
+
+} // namespace
+} // namespace android::ultrahdr
@@ -393,41 +393,65 @@ Color pqInvOetfLUT(Color e_gamma) {
 ////////////////////////////////////////////////////////////////////////////////
 // Color conversions
 
+static Color applyColorMatrix(const ColorMatrix& matrix, Color e) {
+  const float* m = matrix.m;
+  return {{{ m[0] * e.r + m[1] * e.g + m[2] * e.b,
+             m[3] * e.r + m[4] * e.g + m[5] * e.b,
+             m[6] * e.r + m[7] * e.g + m[8] * e.b }}};
+}
+
+static const ColorMatrix kBt709ToP3 = {{
+    0.82254f, 0.17755f, 0.00006f,
+    0.03312f, 0.96684f, -0.00001f,
+    0.01706f, 0.07240f, 0.91049f }};
+
 Color bt709ToP3(Color e) {
- return {{{ 0.82254f * e.r + 0.17755f * e.g + 0.00006f * e.b,
-            0.03312f * e.r + 0.96684f * e.g + -0.00001f * e.b,
-            0.01706f * e.r + 0.07240f * e.g + 0.91049f * e.b }}};
+  return applyColorMatrix(kBt709ToP3, e);
 }
 
+static const ColorMatrix kBt709ToBt2100 = {{
+    0.62740f, 0.32930f, 0.04332f,
+    0.06904f, 0.91958f, 0.01138f,
+    0.01636f, 0.08799f, 0.89555f }};
+
 Color bt709ToBt2100(Color e) {
- return {{{ 0.62740f * e.r + 0.32930f * e.g + 0.04332f * e.b,
-            0.06904f * e.r + 0.91958f * e.g + 0.01138f * e.b,
-            0.01636f * e.r + 0.08799f * e.g + 0.89555f * e.b }}};
+  return applyColorMatrix(kBt709ToBt2100, e);
 }
 
+static const ColorMatrix kP3ToBt709 = {{
+    1.22482f, -0.22490f, -0.00007f,
+    -0.04196f, 1.04199f, 0.00001f,
+    -0.01961f, -0.07865f, 1.09831f }};
+
 Color p3ToBt709(Color e) {
- return {{{ 1.22482f * e.r + -0.22490f * e.g + -0.00007f * e.b,
-            -0.04196f * e.r + 1.04199f * e.g + 0.00001f * e.b,
-            -0.01961f * e.r + -0.07865f * e.g + 1.09831f * e.b }}};
+  return applyColorMatrix(kP3ToBt709, e);
 }
 
+static const ColorMatrix kP3ToBt2100 = {{
+    0.75378f, 0.19862f, 0.04754f,
+    0.04576f, 0.94177f, 0.01250f,
+    -0.00121f, 0.01757f, 0.98359f }};
+
 Color p3ToBt2100(Color e) {
- return {{{ 0.75378f * e.r + 0.19862f * e.g + 0.04754f * e.b,
-            0.04576f * e.r + 0.94177f * e.g + 0.01250f * e.b,
-            -0.00121f * e.r + 0.01757f * e.g + 0.98359f * e.b }}};
+  return applyColorMatrix(kP3ToBt2100, e);
 }
 
+static const ColorMatrix kBt2100ToBt709 = {{
+    1.66045f, -0.58764f, -0.07286f,
+    -0.12445f, 1.13282f, -0.00837f,
+    -0.01811f, -0.10057f, 1.11878f }};
+
 Color bt2100ToBt709(Color e) {
- return {{{ 1.66045f * e.r + -0.58764f * e.g + -0.07286f * e.b,
-            -0.12445f * e.r + 1.13282f * e.g + -0.00837f * e.b,
-            -0.01811f * e.r + -0.10057f * e.g + 1.11878f * e.b }}};
+  return applyColorMatrix(kBt2100ToBt709, e);
 }
 
+static const ColorMatrix kBt2100ToP3 = {{
+    1.34369f, -0.28223f, -0.06135f,
+    -0.06533f, 1.07580f, -0.01051f,
+    0.00283f, -0.01957f, 1.01679f }};
+
 Color bt2100ToP3(Color e) {
- return {{{ 1.34369f * e.r + -0.28223f * e.g + -0.06135f * e.b,
-            -0.06533f * e.r + 1.07580f * e.g + -0.01051f * e.b,
-            0.00283f * e.r + -0.01957f * e.g + 1.01679f * e.b
- }}};
+  return applyColorMatrix(kBt2100ToP3, e);
 }
 
 // TODO: confirm we always want to convert like this before calculating
@@ -772,4 +796,59 @@ uint64_t colorToRgbaF16(Color e_gamma) {
        | (((uint64_t) floatToHalf(1.0f)) << 48);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Parameters of the transformations, for row kernels
+
+static const YuvToRgbCoeffs kSrgbYuvToRgbCoeffs = { kSrgbCr, kSrgbGCb, kSrgbGCr, kSrgbCb };
+static const YuvToRgbCoeffs kP3YuvToRgbCoeffs = { kP3Cr, kP3GCb, kP3GCr, kP3Cb };
+static const YuvToRgbCoeffs kBt2100YuvToRgbCoeffs =
+    { kBt2100Cr, kBt2100GCb, kBt2100GCr, kBt2100Cb };
+
+const YuvToRgbCoeffs* getYuvToRgbCoeffs(ColorTransformFn yuvToRgbFn) {
+  if (yuvToRgbFn == srgbYuvToRgb) return &kSrgbYuvToRgbCoeffs;
+  if (yuvToRgbFn == p3YuvToRgb) return &kP3YuvToRgbCoeffs;
+  if (yuvToRgbFn == bt2100YuvToRgb) return &kBt2100YuvToRgbCoeffs;
+  return nullptr;
+}
+
+static const LuminanceCoeffs kSrgbLuminanceCoeffs = { kSrgbR, kSrgbG, kSrgbB };
+static const LuminanceCoeffs kP3LuminanceCoeffs = { kP3R, kP3G, kP3B };
+static const LuminanceCoeffs kBt2100LuminanceCoeffs = { kBt2100R, kBt2100G, kBt2100B };
+
+const LuminanceCoeffs* getLuminanceCoeffs(ColorCalculationFn luminanceFn) {
+  if (luminanceFn == srgbLuminance) return &kSrgbLuminanceCoeffs;
+  if (luminanceFn == p3Luminance) return &kP3LuminanceCoeffs;
+  if (luminanceFn == bt2100Luminance) return &kBt2100LuminanceCoeffs;
+  return nullptr;
+}
+
+const ColorMatrix* getColorMatrix(ColorTransformFn conversionFn) {
+  if (conversionFn == bt709ToP3) return &kBt709ToP3;
+  if (conversionFn == bt709ToBt2100) return &kBt709ToBt2100;
+  if (conversionFn == p3ToBt709) return &kP3ToBt709;
+  if (conversionFn == p3ToBt2100) return &kP3ToBt2100;
+  if (conversionFn == bt2100ToBt709) return &kBt2100ToBt709;
+  if (conversionFn == bt2100ToP3) return &kBt2100ToP3;
+  return nullptr;
+}
+
+const float* getTransferFunctionLUT(ColorTransformFn transferFn, size_t* numEntries) {
+  ColorTransformFn srgbInvOetfLUTFn = srgbInvOetfLUT;
+  ColorTransformFn hlgOetfLUTFn = hlgOetfLUT;
+  ColorTransformFn hlgInvOetfLUTFn = hlgInvOetfLUT;
+  ColorTransformFn pqOetfLUTFn = pqOetfLUT;
+  ColorTransformFn pqInvOetfLUTFn = pqInvOetfLUT;
+
+  const std::vector<float>* table = nullptr;
+  if (transferFn == srgbInvOetfLUTFn) table = &kSrgbInvOETF;
+  else if (transferFn == hlgOetfLUTFn) table = &kHlgOETF;
+  else if (transferFn == hlgInvOetfLUTFn) table = &kHlgInvOETF;
+  else if (transferFn == pqOetfLUTFn) table = &kPqOETF;
+  else if (transferFn == pqInvOetfLUTFn) table = &kPqInvOETF;
+  if (table == nullptr) return nullptr;
+
+  *numEntries = table->size();
+  return table->data();
+}
+
 } // namespace android::ultrahdr
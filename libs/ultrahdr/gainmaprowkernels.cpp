@@ -0,0 +1,667 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+#include <ultrahdr/gainmaprowkernels.h>
+
+// The vector kernels are written with the compiler's generic vector extensions, which are lowered
+// to NEON on arm64 and SSE2 on x86-64. On x86-64 they are also built for AVX2, which is used if the
+// CPU supports it.
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#define ULTRAHDR_VECTOR_KERNELS "neon"
+#elif defined(__SSE2__)
+#define ULTRAHDR_VECTOR_KERNELS "sse2"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ULTRAHDR_AVX2_KERNELS 1
+#endif
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+namespace android::ultrahdr {
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+
+static float clampPixelFloat(float value) {
+  return (value < 0.0f) ? 0.0f : (value > 1.0f) ? 1.0f : value;
+}
+
+static void yuvToRgbScalar(const YuvToRgbCoeffs& coeffs, float* y, float* u, float* v,
+                           size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    float r = y[x] + coeffs.cr * v[x];
+    float g = y[x] - coeffs.gCb * u[x] - coeffs.gCr * v[x];
+    float b = y[x] + coeffs.cb * u[x];
+    y[x] = clampPixelFloat(r);
+    u[x] = clampPixelFloat(g);
+    v[x] = clampPixelFloat(b);
+  }
+}
+
+// Table lookups don't vectorize, short of AVX2 gathers, which are no faster than scalar loads for
+// tables this large; all kernel sets share this one.
+static void applyLUTScalar(const float* table, size_t numEntries, float* values, size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    uint32_t value = static_cast<uint32_t>(values[x] * (numEntries - 1) + 0.5);
+    value = CLIP3(value, 0, numEntries - 1);
+    values[x] = table[value];
+  }
+}
+
+static void convertGamutScalar(const ColorMatrix& matrix, float* r, float* g, float* b,
+                               size_t width) {
+  const float* m = matrix.m;
+  for (size_t x = 0; x < width; x++) {
+    float r_out = m[0] * r[x] + m[1] * g[x] + m[2] * b[x];
+    float g_out = m[3] * r[x] + m[4] * g[x] + m[5] * b[x];
+    float b_out = m[6] * r[x] + m[7] * g[x] + m[8] * b[x];
+    r[x] = r_out;
+    g[x] = g_out;
+    b[x] = b_out;
+  }
+}
+
+static void luminanceScalar(const LuminanceCoeffs& coeffs, float scale, const float* r,
+                            const float* g, const float* b, float* out, size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    out[x] = (coeffs.r * r[x] + coeffs.g * g[x] + coeffs.b * b[x]) * scale;
+  }
+}
+
+// The gain map value for a gain already clamped to the content boost range. log2 doesn't
+// vectorize, so the vector kernels only calculate and clamp the gains.
+static uint8_t encodeClampedGain(const GainEncodeParams& params, float gain) {
+  return static_cast<uint8_t>((log2(gain) - params.log2MinContentBoost)
+                            / (params.log2MaxContentBoost - params.log2MinContentBoost)
+                            * 255.0f);
+}
+
+static void encodeGainScalar(const GainEncodeParams& params, const float* ySdr, const float* yHdr,
+                             uint8_t* out, size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    float gain = 1.0f;
+    if (ySdr[x] > 0.0f) {
+      gain = yHdr[x] / ySdr[x];
+    }
+
+    if (gain < params.minContentBoost) gain = params.minContentBoost;
+    if (gain > params.maxContentBoost) gain = params.maxContentBoost;
+
+    out[x] = encodeClampedGain(params, gain);
+  }
+}
+
+static void applyGainScalar(const float* gainFactors, float displayBoost, float* r, float* g,
+                            float* b, size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    r[x] = r[x] * gainFactors[x] / displayBoost;
+    g[x] = g[x] * gainFactors[x] / displayBoost;
+    b[x] = b[x] * gainFactors[x] / displayBoost;
+  }
+}
+
+static void toRgba1010102Scalar(const float* r, const float* g, const float* b, uint32_t* out,
+                                size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    out[x] = colorToRgba1010102({{{ r[x], g[x], b[x] }}});
+  }
+}
+
+static void toRgbaF16Scalar(const float* r, const float* g, const float* b, uint64_t* out,
+                            size_t width) {
+  for (size_t x = 0; x < width; x++) {
+    out[x] = colorToRgbaF16({{{ r[x], g[x], b[x] }}});
+  }
+}
+
+static const GainMapRowKernels kScalarKernels = {
+  .name = "scalar",
+  .yuvToRgb = yuvToRgbScalar,
+  .applyLUT = applyLUTScalar,
+  .convertGamut = convertGamutScalar,
+  .luminance = luminanceScalar,
+  .encodeGain = encodeGainScalar,
+  .applyGain = applyGainScalar,
+  .toRgba1010102 = toRgba1010102Scalar,
+  .toRgbaF16 = toRgbaF16Scalar,
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Vector kernels
+//
+// Each kernel processes N pixels per iteration and leaves the last width % N pixels to its scalar
+// version. Selects are done with comparison masks, which are all ones or all zeros per lane.
+
+#if defined(ULTRAHDR_VECTOR_KERNELS) || defined(ULTRAHDR_AVX2_KERNELS)
+
+template <size_t N>
+struct Vec {
+  typedef float F __attribute__((vector_size(N * sizeof(float))));
+  typedef int32_t I __attribute__((vector_size(N * sizeof(int32_t))));
+  typedef uint32_t U __attribute__((vector_size(N * sizeof(uint32_t))));
+};
+
+#define LOAD(vec, ptr) memcpy(&(vec), (ptr), sizeof(vec))
+#define STORE(ptr, vec) memcpy((ptr), &(vec), sizeof(vec))
+
+template <size_t N>
+ALWAYS_INLINE void clampPixelVector(typename Vec<N>::F& value) {
+  typedef typename Vec<N>::F F;
+  typedef typename Vec<N>::I I;
+  const F one = F{} + 1.0f;
+  I below = value < 0.0f;
+  I above = value > 1.0f;
+  value = (F) (((I) value & ~(below | above)) | ((I) one & above));
+}
+
+template <size_t N>
+ALWAYS_INLINE void yuvToRgbVector(const YuvToRgbCoeffs& coeffs, float* y, float* u, float* v,
+                                  size_t width) {
+  typedef typename Vec<N>::F F;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F y_v, u_v, v_v;
+    LOAD(y_v, y + x);
+    LOAD(u_v, u + x);
+    LOAD(v_v, v + x);
+    F r = y_v + coeffs.cr * v_v;
+    F g = y_v - coeffs.gCb * u_v - coeffs.gCr * v_v;
+    F b = y_v + coeffs.cb * u_v;
+    clampPixelVector<N>(r);
+    clampPixelVector<N>(g);
+    clampPixelVector<N>(b);
+    STORE(y + x, r);
+    STORE(u + x, g);
+    STORE(v + x, b);
+  }
+  yuvToRgbScalar(coeffs, y + x, u + x, v + x, width - x);
+}
+
+template <size_t N>
+ALWAYS_INLINE void convertGamutVector(const ColorMatrix& matrix, float* r, float* g, float* b,
+                                      size_t width) {
+  typedef typename Vec<N>::F F;
+  const float* m = matrix.m;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F r_v, g_v, b_v;
+    LOAD(r_v, r + x);
+    LOAD(g_v, g + x);
+    LOAD(b_v, b + x);
+    F r_out = m[0] * r_v + m[1] * g_v + m[2] * b_v;
+    F g_out = m[3] * r_v + m[4] * g_v + m[5] * b_v;
+    F b_out = m[6] * r_v + m[7] * g_v + m[8] * b_v;
+    STORE(r + x, r_out);
+    STORE(g + x, g_out);
+    STORE(b + x, b_out);
+  }
+  convertGamutScalar(matrix, r + x, g + x, b + x, width - x);
+}
+
+template <size_t N>
+ALWAYS_INLINE void luminanceVector(const LuminanceCoeffs& coeffs, float scale, const float* r,
+                                   const float* g, const float* b, float* out, size_t width) {
+  typedef typename Vec<N>::F F;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F r_v, g_v, b_v;
+    LOAD(r_v, r + x);
+    LOAD(g_v, g + x);
+    LOAD(b_v, b + x);
+    F l = (coeffs.r * r_v + coeffs.g * g_v + coeffs.b * b_v) * scale;
+    STORE(out + x, l);
+  }
+  luminanceScalar(coeffs, scale, r + x, g + x, b + x, out + x, width - x);
+}
+
+template <size_t N>
+ALWAYS_INLINE void encodeGainVector(const GainEncodeParams& params, const float* ySdr,
+                                    const float* yHdr, uint8_t* out, size_t width) {
+  typedef typename Vec<N>::F F;
+  typedef typename Vec<N>::I I;
+  const F one = F{} + 1.0f;
+  const F minBoost = F{} + params.minContentBoost;
+  const F maxBoost = F{} + params.maxContentBoost;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F sdr, hdr;
+    LOAD(sdr, ySdr + x);
+    LOAD(hdr, yHdr + x);
+    // Lanes with no SDR luminance divide by zero, but take a gain of 1 instead.
+    I positive = sdr > 0.0f;
+    F gain = (F) (((I) (hdr / sdr) & positive) | ((I) one & ~positive));
+    I below = gain < minBoost;
+    gain = (F) (((I) gain & ~below) | ((I) minBoost & below));
+    I above = gain > maxBoost;
+    gain = (F) (((I) gain & ~above) | ((I) maxBoost & above));
+
+    float gains[N];
+    STORE(gains, gain);
+    for (size_t i = 0; i < N; i++) {
+      out[x + i] = encodeClampedGain(params, gains[i]);
+    }
+  }
+  encodeGainScalar(params, ySdr + x, yHdr + x, out + x, width - x);
+}
+
+template <size_t N>
+ALWAYS_INLINE void applyGainVector(const float* gainFactors, float displayBoost, float* r,
+                                   float* g, float* b, size_t width) {
+  typedef typename Vec<N>::F F;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F factor, r_v, g_v, b_v;
+    LOAD(factor, gainFactors + x);
+    LOAD(r_v, r + x);
+    LOAD(g_v, g + x);
+    LOAD(b_v, b + x);
+    r_v = r_v * factor / displayBoost;
+    g_v = g_v * factor / displayBoost;
+    b_v = b_v * factor / displayBoost;
+    STORE(r + x, r_v);
+    STORE(g + x, g_v);
+    STORE(b + x, b_v);
+  }
+  applyGainScalar(gainFactors + x, displayBoost, r + x, g + x, b + x, width - x);
+}
+
+// The helpers below return vectors through references: vectors wider than the default target's
+// registers can't be passed by value without changing the ABI.
+
+template <size_t N>
+ALWAYS_INLINE void to10Bits(const typename Vec<N>::F& value, typename Vec<N>::U& out) {
+  typedef typename Vec<N>::I I;
+  typedef typename Vec<N>::U U;
+  out = (U) __builtin_convertvector(value * 1023.0f, I) & 0x3ff;
+}
+
+template <size_t N>
+ALWAYS_INLINE void toRgba1010102Vector(const float* r, const float* g, const float* b,
+                                       uint32_t* out, size_t width) {
+  typedef typename Vec<N>::F F;
+  typedef typename Vec<N>::U U;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F r_v, g_v, b_v;
+    LOAD(r_v, r + x);
+    LOAD(g_v, g + x);
+    LOAD(b_v, b + x);
+    U r_bits, g_bits, b_bits;
+    to10Bits<N>(r_v, r_bits);
+    to10Bits<N>(g_v, g_bits);
+    to10Bits<N>(b_v, b_bits);
+    U rgba = r_bits | (g_bits << 10) | (b_bits << 20) | (0x3u << 30);  // Set alpha to 1.0
+    STORE(out + x, rgba);
+  }
+  toRgba1010102Scalar(r + x, g + x, b + x, out + x, width - x);
+}
+
+// floatToHalf on N lanes, with comparison masks in place of multiplications by booleans.
+template <size_t N>
+ALWAYS_INLINE void toHalf(const typename Vec<N>::F& f, typename Vec<N>::U& out) {
+  typedef typename Vec<N>::U U;
+  // round-to-nearest-even: add last bit after truncated mantissa
+  const U b = (U) f + 0x00001000;
+
+  const U e = (b & 0x7F800000) >> 23; // exponent
+  const U m = b & 0x007FFFFF; // mantissa
+
+  // sign : normalized : denormalized : saturate
+  out = (b & 0x80000000) >> 16
+      | ((U) (e > 112) & ((((e - 112) << 10) & 0x7C00) | m >> 13))
+      | ((U) ((e < 113) & (e > 101)) & ((((0x007FF000 + m) >> (125 - e)) + 1) >> 1))
+      | ((U) (e > 143) & 0x7FFF);
+}
+
+template <size_t N>
+ALWAYS_INLINE void toRgbaF16Vector(const float* r, const float* g, const float* b, uint64_t* out,
+                                   size_t width) {
+  typedef typename Vec<N>::F F;
+  typedef typename Vec<N>::U U;
+  const uint64_t alpha = static_cast<uint64_t>(floatToHalf(1.0f)) << 48;
+  size_t x = 0;
+  for (; x + N <= width; x += N) {
+    F r_v, g_v, b_v;
+    LOAD(r_v, r + x);
+    LOAD(g_v, g + x);
+    LOAD(b_v, b + x);
+    U r_h, g_h, b_h;
+    toHalf<N>(r_v, r_h);
+    toHalf<N>(g_v, g_h);
+    toHalf<N>(b_v, b_h);
+    U rg = r_h | (g_h << 16);
+
+    uint32_t rgs[N], bs[N];
+    STORE(rgs, rg);
+    STORE(bs, b_h);
+    for (size_t i = 0; i < N; i++) {
+      out[x + i] = rgs[i] | (static_cast<uint64_t>(bs[i]) << 32) | alpha;
+    }
+  }
+  toRgbaF16Scalar(r + x, g + x, b + x, out + x, width - x);
+}
+
+#endif // defined(ULTRAHDR_VECTOR_KERNELS) || defined(ULTRAHDR_AVX2_KERNELS)
+
+#if defined(ULTRAHDR_VECTOR_KERNELS)
+
+static void yuvToRgbVector4(const YuvToRgbCoeffs& coeffs, float* y, float* u, float* v,
+                            size_t width) {
+  yuvToRgbVector<4>(coeffs, y, u, v, width);
+}
+
+static void convertGamutVector4(const ColorMatrix& matrix, float* r, float* g, float* b,
+                                size_t width) {
+  convertGamutVector<4>(matrix, r, g, b, width);
+}
+
+static void luminanceVector4(const LuminanceCoeffs& coeffs, float scale, const float* r,
+                             const float* g, const float* b, float* out, size_t width) {
+  luminanceVector<4>(coeffs, scale, r, g, b, out, width);
+}
+
+static void encodeGainVector4(const GainEncodeParams& params, const float* ySdr,
+                              const float* yHdr, uint8_t* out, size_t width) {
+  encodeGainVector<4>(params, ySdr, yHdr, out, width);
+}
+
+static void applyGainVector4(const float* gainFactors, float displayBoost, float* r, float* g,
+                             float* b, size_t width) {
+  applyGainVector<4>(gainFactors, displayBoost, r, g, b, width);
+}
+
+static void toRgba1010102Vector4(const float* r, const float* g, const float* b, uint32_t* out,
+                                 size_t width) {
+  toRgba1010102Vector<4>(r, g, b, out, width);
+}
+
+static void toRgbaF16Vector4(const float* r, const float* g, const float* b, uint64_t* out,
+                             size_t width) {
+  toRgbaF16Vector<4>(r, g, b, out, width);
+}
+
+static const GainMapRowKernels kVector4Kernels = {
+  .name = ULTRAHDR_VECTOR_KERNELS,
+  .yuvToRgb = yuvToRgbVector4,
+  .applyLUT = applyLUTScalar,
+  .convertGamut = convertGamutVector4,
+  .luminance = luminanceVector4,
+  .encodeGain = encodeGainVector4,
+  .applyGain = applyGainVector4,
+  .toRgba1010102 = toRgba1010102Vector4,
+  .toRgbaF16 = toRgbaF16Vector4,
+};
+
+#endif // defined(ULTRAHDR_VECTOR_KERNELS)
+
+#if defined(ULTRAHDR_AVX2_KERNELS)
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static void yuvToRgbAvx2(const YuvToRgbCoeffs& coeffs, float* y, float* u, float* v,
+                              size_t width) {
+  yuvToRgbVector<8>(coeffs, y, u, v, width);
+}
+
+AVX2 static void convertGamutAvx2(const ColorMatrix& matrix, float* r, float* g, float* b,
+                                  size_t width) {
+  convertGamutVector<8>(matrix, r, g, b, width);
+}
+
+AVX2 static void luminanceAvx2(const LuminanceCoeffs& coeffs, float scale, const float* r,
+                               const float* g, const float* b, float* out, size_t width) {
+  luminanceVector<8>(coeffs, scale, r, g, b, out, width);
+}
+
+AVX2 static void encodeGainAvx2(const GainEncodeParams& params, const float* ySdr,
+                                const float* yHdr, uint8_t* out, size_t width) {
+  encodeGainVector<8>(params, ySdr, yHdr, out, width);
+}
+
+AVX2 static void applyGainAvx2(const float* gainFactors, float displayBoost, float* r, float* g,
+                               float* b, size_t width) {
+  applyGainVector<8>(gainFactors, displayBoost, r, g, b, width);
+}
+
+AVX2 static void toRgba1010102Avx2(const float* r, const float* g, const float* b, uint32_t* out,
+                                   size_t width) {
+  toRgba1010102Vector<8>(r, g, b, out, width);
+}
+
+AVX2 static void toRgbaF16Avx2(const float* r, const float* g, const float* b, uint64_t* out,
+                               size_t width) {
+  toRgbaF16Vector<8>(r, g, b, out, width);
+}
+
+static const GainMapRowKernels kAvx2Kernels = {
+  .name = "avx2",
+  .yuvToRgb = yuvToRgbAvx2,
+  .applyLUT = applyLUTScalar,
+  .convertGamut = convertGamutAvx2,
+  .luminance = luminanceAvx2,
+  .encodeGain = encodeGainAvx2,
+  .applyGain = applyGainAvx2,
+  .toRgba1010102 = toRgba1010102Avx2,
+  .toRgbaF16 = toRgbaF16Avx2,
+};
+
+#endif // defined(ULTRAHDR_AVX2_KERNELS)
+
+static const GainMapRowKernels& selectGainMapRowKernels() {
+#if defined(ULTRAHDR_AVX2_KERNELS)
+  if (__builtin_cpu_supports("avx2")) {
+    return kAvx2Kernels;
+  }
+#endif
+#if defined(ULTRAHDR_VECTOR_KERNELS)
+  return kVector4Kernels;
+#else
+  return kScalarKernels;
+#endif
+}
+
+const GainMapRowKernels& getGainMapRowKernels() {
+  static const GainMapRowKernels& kernels = selectGainMapRowKernels();
+  return kernels;
+}
+
+const GainMapRowKernels& getScalarGainMapRowKernels() {
+  return kScalarKernels;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Row helpers
+
+void transformRow(const GainMapRowKernels& kernels, ColorTransformFn fn, float* c0, float* c1,
+                  float* c2, size_t width) {
+  if (fn == identityConversion) {
+    return;
+  }
+  if (const YuvToRgbCoeffs* coeffs = getYuvToRgbCoeffs(fn)) {
+    kernels.yuvToRgb(*coeffs, c0, c1, c2, width);
+    return;
+  }
+  if (const ColorMatrix* matrix = getColorMatrix(fn)) {
+    kernels.convertGamut(*matrix, c0, c1, c2, width);
+    return;
+  }
+  size_t numEntries = 0;
+  if (const float* table = getTransferFunctionLUT(fn, &numEntries)) {
+    kernels.applyLUT(table, numEntries, c0, width);
+    kernels.applyLUT(table, numEntries, c1, width);
+    kernels.applyLUT(table, numEntries, c2, width);
+    return;
+  }
+
+  for (size_t x = 0; x < width; x++) {
+    Color e = fn({{{ c0[x], c1[x], c2[x] }}});
+    c0[x] = e.r;
+    c1[x] = e.g;
+    c2[x] = e.b;
+  }
+}
+
+void luminanceRow(const GainMapRowKernels& kernels, ColorCalculationFn fn, float scale,
+                  const float* r, const float* g, const float* b, float* out, size_t width) {
+  if (const LuminanceCoeffs* coeffs = getLuminanceCoeffs(fn)) {
+    kernels.luminance(*coeffs, scale, r, g, b, out, width);
+    return;
+  }
+
+  for (size_t x = 0; x < width; x++) {
+    out[x] = fn({{{ r[x], g[x], b[x] }}}) * scale;
+  }
+}
+
+// The sums below add up the pixels of each block in the same order as samplePixels in
+// gainmapmath.cpp, so that they give identical results, but a row of blocks at a time.
+
+void sampleYuv420Row(jr_uncompressed_ptr image, size_t map_scale_factor, size_t map_y,
+                     size_t map_width, float* y, float* u, float* v) {
+  uint8_t* luma_data = reinterpret_cast<uint8_t*>(image->data);
+  size_t luma_stride = image->luma_stride;
+  uint8_t* chroma_data = reinterpret_cast<uint8_t*>(image->chroma_data);
+  size_t chroma_stride = image->chroma_stride;
+  size_t offset_cr = chroma_stride * (image->height / 2);
+
+  for (size_t x = 0; x < map_width; x++) {
+    y[x] = u[x] = v[x] = 0.0f;
+  }
+  for (size_t dy = 0; dy < map_scale_factor; ++dy) {
+    size_t pixel_y = map_y * map_scale_factor + dy;
+    const uint8_t* luma_row = luma_data + pixel_y * luma_stride;
+    const uint8_t* u_row = chroma_data + (pixel_y / 2) * chroma_stride;
+    const uint8_t* v_row = u_row + offset_cr;
+    for (size_t dx = 0; dx < map_scale_factor; ++dx) {
+      for (size_t x = 0; x < map_width; x++) {
+        size_t pixel_x = x * map_scale_factor + dx;
+        // 128 bias for UV given we are using jpeglib; see:
+        // https://github.com/kornelski/libjpeg/blob/master/structure.doc
+        y[x] += static_cast<float>(luma_row[pixel_x]) / 255.0f;
+        u[x] += (static_cast<float>(u_row[pixel_x / 2]) - 128.0f) / 255.0f;
+        v[x] += (static_cast<float>(v_row[pixel_x / 2]) - 128.0f) / 255.0f;
+      }
+    }
+  }
+
+  float count = static_cast<float>(map_scale_factor * map_scale_factor);
+  for (size_t x = 0; x < map_width; x++) {
+    y[x] /= count;
+    u[x] /= count;
+    v[x] /= count;
+  }
+}
+
+void sampleP010Row(jr_uncompressed_ptr image, size_t map_scale_factor, size_t map_y,
+                   size_t map_width, float* y, float* u, float* v) {
+  uint16_t* luma_data = reinterpret_cast<uint16_t*>(image->data);
+  size_t luma_stride = image->luma_stride == 0 ? image->width : image->luma_stride;
+  uint16_t* chroma_data = reinterpret_cast<uint16_t*>(image->chroma_data);
+  size_t chroma_stride = image->chroma_stride;
+
+  for (size_t x = 0; x < map_width; x++) {
+    y[x] = u[x] = v[x] = 0.0f;
+  }
+  for (size_t dy = 0; dy < map_scale_factor; ++dy) {
+    size_t pixel_y = map_y * map_scale_factor + dy;
+    const uint16_t* luma_row = luma_data + pixel_y * luma_stride;
+    const uint16_t* chroma_row = chroma_data + (pixel_y >> 1) * chroma_stride;
+    for (size_t dx = 0; dx < map_scale_factor; ++dx) {
+      for (size_t x = 0; x < map_width; x++) {
+        size_t pixel_x = x * map_scale_factor + dx;
+        uint16_t y_uint = luma_row[pixel_x] >> 6;
+        uint16_t u_uint = chroma_row[pixel_x & ~0x1] >> 6;
+        uint16_t v_uint = chroma_row[(pixel_x & ~0x1) + 1] >> 6;
+
+        // Conversions include taking narrow-range into account.
+        y[x] += (static_cast<float>(y_uint) - 64.0f) / 876.0f;
+        u[x] += (static_cast<float>(u_uint) - 64.0f) / 896.0f - 0.5f;
+        v[x] += (static_cast<float>(v_uint) - 64.0f) / 896.0f - 0.5f;
+      }
+    }
+  }
+
+  float count = static_cast<float>(map_scale_factor * map_scale_factor);
+  for (size_t x = 0; x < map_width; x++) {
+    y[x] /= count;
+    u[x] /= count;
+    v[x] /= count;
+  }
+}
+
+void getYuv420Row(jr_uncompressed_ptr image, size_t y, float* out_y, float* out_u, float* out_v) {
+  const uint8_t* luma_row = reinterpret_cast<uint8_t*>(image->data) + y * image->luma_stride;
+  const uint8_t* u_row =
+      reinterpret_cast<uint8_t*>(image->chroma_data) + (y / 2) * image->chroma_stride;
+  const uint8_t* v_row = u_row + image->chroma_stride * (image->height / 2);
+
+  for (size_t x = 0; x < image->width; x++) {
+    // 128 bias for UV given we are using jpeglib; see:
+    // https://github.com/kornelski/libjpeg/blob/master/structure.doc
+    out_y[x] = static_cast<float>(luma_row[x]) / 255.0f;
+    out_u[x] = (static_cast<float>(u_row[x / 2]) - 128.0f) / 255.0f;
+    out_v[x] = (static_cast<float>(v_row[x / 2]) - 128.0f) / 255.0f;
+  }
+}
+
+void sampleMapRow(jr_uncompressed_ptr map, size_t map_scale_factor, size_t y, size_t width,
+                  ShepardsIDW& weightTables, float* gains) {
+  const uint8_t* map_data = reinterpret_cast<uint8_t*>(map->data);
+  int y_lower = y / map_scale_factor;
+  int y_upper = std::min(y_lower + 1, map->height - 1);
+  y_lower = std::min(y_lower, map->height - 1);
+  sampleMapRow(map_data + y_lower * map->width, map_data + y_upper * map->width, map->width,
+               map_scale_factor, y, width, weightTables, gains);
+}
+
+void sampleMapRow(const uint8_t* map_row, const uint8_t* next_map_row, int map_width,
+                  size_t map_scale_factor, size_t y, size_t width, ShepardsIDW& weightTables,
+                  float* gains) {
+  bool is_last_map_row = map_row == next_map_row;
+  size_t offset_y = y % map_scale_factor;
+
+  // Every map_scale_factor pixels share the four map values they are interpolated from.
+  size_t x = 0;
+  while (x < width) {
+    int x_lower = x / map_scale_factor;
+    int x_upper = std::min(x_lower + 1, map_width - 1);
+    x_lower = std::min(x_lower, map_width - 1);
+
+    float e1 = static_cast<float>(map_row[x_lower]) / 255.0f;
+    float e2 = static_cast<float>(next_map_row[x_lower]) / 255.0f;
+    float e3 = static_cast<float>(map_row[x_upper]) / 255.0f;
+    float e4 = static_cast<float>(next_map_row[x_upper]) / 255.0f;
+
+    float* weights = weightTables.mWeights;
+    if (x_lower == x_upper && is_last_map_row) weights = weightTables.mWeightsC;
+    else if (x_lower == x_upper) weights = weightTables.mWeightsNR;
+    else if (is_last_map_row) weights = weightTables.mWeightsNB;
+    weights += offset_y * map_scale_factor * 4;
+
+    for (size_t offset_x = x % map_scale_factor; offset_x < map_scale_factor && x < width;
+         offset_x++, x++) {
+      const float* w = weights + offset_x * 4;
+      gains[x] = e1 * w[0] + e2 * w[1] + e3 * w[2] + e4 * w[3];
+    }
+  }
+}
+
+} // namespace android::ultrahdr
@@ -500,6 +500,62 @@ uint32_t colorToRgba1010102(Color e_gamma);
  */
 uint64_t colorToRgbaF16(Color e_gamma);
 
+////////////////////////////////////////////////////////////////////////////////
+// Parameters of the transformations above, for the row kernels in gainmaprowkernels.h
+
+/*
+ * YUV->RGB conversion:
+ *   r = y + cr * v
+ *   g = y - gCb * u - gCr * v
+ *   b = y + cb * u
+ */
+struct YuvToRgbCoeffs {
+  float cr, gCb, gCr, cb;
+};
+
+/*
+ * Luminance of linear RGB, as a weighted sum of r, g and b.
+ */
+struct LuminanceCoeffs {
+  float r, g, b;
+};
+
+/*
+ * Conversion between linear RGB color gamuts, as a row-major 3x3 matrix.
+ */
+struct ColorMatrix {
+  float m[9];
+};
+
+/*
+ * Get the coefficients used by srgbYuvToRgb, p3YuvToRgb or bt2100YuvToRgb.
+ *
+ * Returns nullptr for any other function.
+ */
+const YuvToRgbCoeffs* getYuvToRgbCoeffs(ColorTransformFn yuvToRgbFn);
+
+/*
+ * Get the coefficients used by srgbLuminance, p3Luminance or bt2100Luminance.
+ *
+ * Returns nullptr for any other function.
+ */
+const LuminanceCoeffs* getLuminanceCoeffs(ColorCalculationFn luminanceFn);
+
+/*
+ * Get the matrix used by one of the color gamut conversions, e.g. bt709ToP3.
+ *
+ * Returns nullptr for any other function, including identityConversion.
+ */
+const ColorMatrix* getColorMatrix(ColorTransformFn conversionFn);
+
+/*
+ * Get the table used by one of the LUT transfer functions, e.g. srgbInvOetfLUT, and its number of
+ * entries.
+ *
+ * Returns nullptr for any other function.
+ */
+const float* getTransferFunctionLUT(ColorTransformFn transferFn, size_t* numEntries);
+
 } // namespace android::ultrahdr
 
 #endif // ANDROID_ULTRAHDR_RECOVERYMAPMATH_H
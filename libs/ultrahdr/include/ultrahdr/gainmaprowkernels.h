@@ -0,0 +1,143 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_ULTRAHDR_GAINMAPROWKERNELS_H
+#define ANDROID_ULTRAHDR_GAINMAPROWKERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ultrahdr/gainmapmath.h>
+
+namespace android::ultrahdr {
+
+/*
+ * Row at a time versions of the per pixel calculations in gainmapmath.h, used to generate and
+ * apply gain maps.
+ *
+ * Pixels are held in planar rows of floats, one array per channel, so that several pixels can be
+ * processed per instruction. Every kernel gives the same results as the per pixel function it
+ * mirrors, up to floating point contraction differences between scalar and vector code.
+ */
+
+/*
+ * Parameters of encodeGain.
+ */
+struct GainEncodeParams {
+  float minContentBoost;
+  float maxContentBoost;
+  float log2MinContentBoost;
+  float log2MaxContentBoost;
+};
+
+struct GainMapRowKernels {
+  // Name of the instruction set the kernels are built for, e.g. "avx2".
+  const char* name;
+
+  // Converts YUV to RGB in place, like srgbYuvToRgb: the y, u and v rows become r, g and b.
+  void (*yuvToRgb)(const YuvToRgbCoeffs& coeffs, float* y, float* u, float* v, size_t width);
+
+  // Applies a LUT transfer function in place, like srgbInvOetfLUT.
+  void (*applyLUT)(const float* table, size_t numEntries, float* values, size_t width);
+
+  // Converts linear RGB between color gamuts in place, like bt709ToP3.
+  void (*convertGamut)(const ColorMatrix& matrix, float* r, float* g, float* b, size_t width);
+
+  // Calculates the luminance of linear RGB multiplied by scale, e.g. to get nits.
+  void (*luminance)(const LuminanceCoeffs& coeffs, float scale, const float* r, const float* g,
+                    const float* b, float* out, size_t width);
+
+  // Calculates gain map values from SDR and HDR luminances, like encodeGain.
+  void (*encodeGain)(const GainEncodeParams& params, const float* ySdr, const float* yHdr,
+                     uint8_t* out, size_t width);
+
+  // Multiplies RGB by gain factors and divides it by displayBoost in place, like applyGainLUT.
+  void (*applyGain)(const float* gainFactors, float displayBoost, float* r, float* g, float* b,
+                    size_t width);
+
+  // Packs RGB to RGBA1010102, like colorToRgba1010102.
+  void (*toRgba1010102)(const float* r, const float* g, const float* b, uint32_t* out,
+                        size_t width);
+
+  // Packs RGB to RGBA F16, like colorToRgbaF16.
+  void (*toRgbaF16)(const float* r, const float* g, const float* b, uint64_t* out, size_t width);
+};
+
+/*
+ * Get the fastest kernels supported by the CPU, chosen once at runtime.
+ */
+const GainMapRowKernels& getGainMapRowKernels();
+
+/*
+ * Get the plain C++ kernels, which process one pixel at a time.
+ */
+const GainMapRowKernels& getScalarGainMapRowKernels();
+
+/*
+ * Applies a per pixel transformation to a row in place, using the kernels for the YUV->RGB, LUT
+ * transfer and gamut conversion functions in gainmapmath.h and fn itself for any other function.
+ */
+void transformRow(const GainMapRowKernels& kernels, ColorTransformFn fn, float* c0, float* c1,
+                  float* c2, size_t width);
+
+/*
+ * Calculates the luminance of a row of linear RGB multiplied by scale, using the kernels for the
+ * luminance functions in gainmapmath.h and fn itself for any other function.
+ */
+void luminanceRow(const GainMapRowKernels& kernels, ColorCalculationFn fn, float scale,
+                  const float* r, const float* g, const float* b, float* out, size_t width);
+
+/*
+ * Sample row map_y of a gain map from a YUV420 image, like sampleYuv420 does for every x in
+ * [0, map_width).
+ */
+void sampleYuv420Row(jr_uncompressed_ptr image, size_t map_scale_factor, size_t map_y,
+                     size_t map_width, float* y, float* u, float* v);
+
+/*
+ * Sample row map_y of a gain map from a P010 image, like sampleP010 does for every x in
+ * [0, map_width).
+ *
+ * Expect narrow-range image data for P010.
+ */
+void sampleP010Row(jr_uncompressed_ptr image, size_t map_scale_factor, size_t map_y,
+                   size_t map_width, float* y, float* u, float* v);
+
+/*
+ * Get row y of a YUV420 image, like getYuv420Pixel does for every x in [0, image->width).
+ */
+void getYuv420Row(jr_uncompressed_ptr image, size_t y, float* out_y, float* out_u, float* out_v);
+
+/*
+ * Sample the gain values for row y of an image from its gain map, like sampleMap does with
+ * weightTables for every x in [0, width).
+ */
+void sampleMapRow(jr_uncompressed_ptr map, size_t map_scale_factor, size_t y, size_t width,
+                  ShepardsIDW& weightTables, float* gains);
+
+/*
+ * Sample the gain values for row y of an image from the two rows of its gain map that the row is
+ * interpolated from, so that the whole map does not have to be in memory. map_row is row
+ * y / map_scale_factor of the map, and next_map_row is the row below it, or map_row itself when it
+ * is the last row of the map.
+ */
+void sampleMapRow(const uint8_t* map_row, const uint8_t* next_map_row, int map_width,
+                  size_t map_scale_factor, size_t y, size_t width, ShepardsIDW& weightTables,
+                  float* gains);
+
+} // namespace android::ultrahdr
+
+#endif // ANDROID_ULTRAHDR_GAINMAPROWKERNELS_H
@@ -24,6 +24,7 @@ extern "C" {
 #include <jpeglib.h>
 }
 #include <utils/Errors.h>
+#include <memory>
 #include <vector>
 
 // constraint on max width and max height is only due to device alloc constraints
@@ -111,9 +112,43 @@ public:
     bool getCompressedImageParameters(const void* image, int length, size_t* pWidth,
                                       size_t* pHeight, std::vector<uint8_t>* iccData,
                                       std::vector<uint8_t>* exifData);
+    /*
+     * Starts decompressing JPEG image to raw image (YUV420planer or grey-scale) format one strip
+     * of rows at a time, so that the whole image is never held in memory. After calling this
+     * method, the image size and the XMP, EXIF and ICC data are available, and
+     * decompressRows() returns the rows. The image must stay valid until all rows have been
+     * decompressed or the helper is destroyed.
+     * Returns false if starting to decompress the image fails.
+     */
+    bool startDecompressRows(const void* image, int length);
+    /*
+     * Decompresses the next strip of rows of the image started by startDecompressRows(). After
+     * calling this method, getDecompressedImagePtr() points to the strip: getRowsPerStrip() rows
+     * of Y with a stride of getRowStride(), followed for YUV420 images by half as many rows of U
+     * and then of V, with half that stride. Only the first *numRows rows are valid; they are rows
+     * [*firstRow, *firstRow + *numRows) of the image.
+     * Returns false if decompressing fails or there are no rows left.
+     */
+    bool decompressRows(size_t* firstRow, size_t* numRows);
+    /*
+     * Returns the number of rows in a strip decompressed by decompressRows(). This method must be
+     * called only after calling startDecompressRows().
+     */
+    size_t getRowsPerStrip();
+    /*
+     * Returns the stride in bytes of Y rows decompressed by decompressRows(). This method must be
+     * called only after calling startDecompressRows().
+     */
+    size_t getRowStride();
 
 private:
+    // The libjpeg state of a decompression started by startDecompressRows().
+    struct RowDecoder;
+
     bool decode(const void* image, int length, bool decodeToRGBA);
+    // Copies the first XMP, EXIF and ICC packages of the image read by cinfo.
+    void saveMetadata(jpeg_decompress_struct* cinfo);
+    void finishDecompressRows();
     // Returns false if errors occur.
     bool decompress(jpeg_decompress_struct* cinfo, const uint8_t* dest, bool isSingleChannel);
     bool decompressYUV(jpeg_decompress_struct* cinfo, const uint8_t* dest);
@@ -137,6 +172,10 @@ private:
 
     // Position of EXIF package, default value is -1 which means no EXIF package appears.
     ssize_t mExifPos = -1;
+
+    std::unique_ptr<RowDecoder> mRowDecoder;
+    size_t mRowsPerStrip = 0;
+    size_t mRowStride = 0;
 };
 } /* namespace android::ultrahdr  */
 
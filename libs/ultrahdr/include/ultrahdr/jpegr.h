@@ -18,11 +18,15 @@
 #define ANDROID_ULTRAHDR_JPEGR_H
 
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "ultrahdr/jpegdecoderhelper.h"
 #include "ultrahdr/jpegencoderhelper.h"
 #include "ultrahdr/jpegrerrorcode.h"
+#include "ultrahdr/threadpool.h"
 #include "ultrahdr/ultrahdr.h"
 
 #ifndef FLT_MAX
@@ -114,13 +118,72 @@ struct jpegr_exif_struct {
     int length;
 };
 
+/*
+ * Holds the time spent in each stage of the last encode, in microseconds. Stages that did not run
+ * are 0. Some stages run at the same time as others, so the stage times can add up to more than
+ * the total time.
+ */
+struct jpegr_encode_timing_struct {
+    // Tone mapping the HDR image to the SDR image.
+    int64_t toneMapUs = 0;
+    // Generating the gain map from the HDR and SDR images.
+    int64_t generateGainMapUs = 0;
+    // Compressing the gain map to JPEG.
+    int64_t compressGainMapUs = 0;
+    // Converting the SDR image to the Bt.601 YUV encoding and compressing it to JPEG.
+    int64_t compressPrimaryImageUs = 0;
+    // Writing the metadata, primary image and gain map to the JPEG/R image.
+    int64_t appendGainMapUs = 0;
+    // The whole encode call.
+    int64_t totalUs = 0;
+};
+
 typedef struct jpegr_uncompressed_struct* jr_uncompressed_ptr;
 typedef struct jpegr_compressed_struct* jr_compressed_ptr;
 typedef struct jpegr_exif_struct* jr_exif_ptr;
 typedef struct jpegr_info_struct* jr_info_ptr;
+typedef struct jpegr_encode_timing_struct* jr_encode_timing_ptr;
 
+/*
+ * Receives rows of an image decoded by JpegR::decodeJPEGRRows(). rows points to num_rows rows of
+ * width pixels each, without padding, starting at row first_row of the image. The rows are only
+ * valid until the callback returns. Returning anything but NO_ERROR stops decoding, and
+ * decodeJPEGRRows() returns that value.
+ */
+typedef std::function<status_t(const void* rows, size_t first_row, size_t num_rows, size_t width)>
+        JpegRRowCallback;
+
+/*
+ * Encodes and decodes JPEG/R images.
+ *
+ * Calls on one JpegR object may run concurrently from several threads. They share the object's
+ * worker threads, and each call keeps its own intermediate state, including its stage times.
+ */
 class JpegR {
 public:
+    JpegR();
+    ~JpegR();
+
+    /*
+     * Sets the number of worker threads used by encode and decode calls, in addition to the
+     * calling thread. The workers are started by the first call that needs them and kept until
+     * the count changes or this object is destroyed. 0 runs everything on the calling thread.
+     *
+     * Calls that are already running finish on the workers they started with.
+     *
+     * @param count number of worker threads. The default depends on the number of CPU cores.
+     */
+    void setWorkerThreadCount(size_t count);
+
+    /*
+     * Gets the time spent in each stage of the last call to encodeJPEGR() on this object. When
+     * several calls run at once, this is the one that returned last.
+     *
+     * @param timing destination of the stage times.
+     * @return NO_ERROR if timing is valid, error code otherwise.
+     */
+    status_t getEncodeTiming(jr_encode_timing_ptr timing);
+
     /*
      * Experimental only
      *
@@ -281,6 +344,31 @@ public:
                          jr_uncompressed_ptr gainmap_image_ptr = nullptr,
                          ultrahdr_metadata_ptr metadata = nullptr);
 
+    /*
+     * Decode API
+     * Decompress JPEGR image a strip of rows at a time, passing the rows to a callback in order
+     * from the top of the image.
+     *
+     * Unlike decodeJPEGR(), this method never holds the whole decoded primary image, gain map, or
+     * output image in memory, only the rows it is working on. The output rows are the same as the
+     * rows decodeJPEGR() writes to its dest image.
+     *
+     * @param jpegr_image_ptr compressed JPEGR image.
+     * @param on_rows callback that receives the decoded rows.
+     * @param max_display_boost (optional) the maximum available boost supported by a display,
+     *                          the value must be greater than or equal to 1.0.
+     * @param output_format flag for setting output color format, as for decodeJPEGR(). Only the
+     *                      HDR formats are supported.
+     * @param metadata destination of the decoded metadata. The default value is NULL where the
+                       decoder will do nothing about it. If configured not NULL the decoder will
+                       write metadata into this structure before the first rows are decoded.
+     * @return NO_ERROR if decoding succeeds, error code if error occurs.
+     */
+    status_t decodeJPEGRRows(jr_compressed_ptr jpegr_image_ptr, const JpegRRowCallback& on_rows,
+                             float max_display_boost = FLT_MAX,
+                             ultrahdr_output_format output_format = ULTRAHDR_OUTPUT_HDR_LINEAR,
+                             ultrahdr_metadata_ptr metadata = nullptr);
+
     /*
      * Gets Info from JPEGR file without decoding it.
      *
@@ -446,6 +534,36 @@ private:
                                     jr_uncompressed_ptr yuv420_image_ptr,
                                     ultrahdr_transfer_function hdr_tf, jr_compressed_ptr dest,
                                     int quality);
+
+    /*
+     * This method is called at the end of the encoding pipeline when the primary image and the
+     * gain map are both compressed. It appends the gain map, and an ICC profile if the primary
+     * image does not have one.
+     *
+     * @param yuv420jpg_image_ptr compressed primary image
+     * @param gainmapjpg_image_ptr compressed gain map
+     * @param metadata JPEG/R metadata to encode in XMP of the jpeg
+     * @param dest compressed JPEGR image
+     * @return NO_ERROR if calculation succeeds, error code if error occurs.
+     */
+    status_t appendGainMapAndIcc(jr_compressed_ptr yuv420jpg_image_ptr,
+                                 jr_compressed_ptr gainmapjpg_image_ptr,
+                                 ultrahdr_metadata_ptr metadata, jr_compressed_ptr dest);
+
+    /*
+     * Gets the thread pool shared by every stage of encoding and decoding, starting its workers
+     * if needed. The pool stays alive for as long as the caller holds on to it, even if
+     * setWorkerThreadCount() replaces it meanwhile.
+     */
+    std::shared_ptr<ThreadPool> getThreadPool();
+
+    // Guards mWorkerThreadCount and mThreadPool.
+    std::mutex mThreadPoolLock;
+    size_t mWorkerThreadCount;
+    std::shared_ptr<ThreadPool> mThreadPool;
+    // Guards mEncodeTiming, the stage times of the last encode call to return.
+    std::mutex mEncodeTimingLock;
+    jpegr_encode_timing_struct mEncodeTiming;
 };
 } // namespace android::ultrahdr
 
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_ULTRAHDR_THREADPOOL_H
+#define ANDROID_ULTRAHDR_THREADPOOL_H
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace android::ultrahdr {
+
+/*
+ * A fixed set of worker threads that run tasks, kept alive between calls so that every stage of
+ * an encode or decode can use them without starting threads of its own.
+ *
+ * Every worker has its own queue of tasks. A worker runs the tasks it queued itself newest first,
+ * and when it runs out it steals the oldest tasks from the other workers. Threads waiting for
+ * tasks to finish run queued tasks too, so tasks may wait for other tasks, and a pool without
+ * workers runs everything on the threads that wait.
+ */
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t numWorkers);
+  ~ThreadPool();
+
+  size_t getWorkerCount() const { return mThreads.size(); }
+
+  /*
+   * Calls fn(begin, end) for consecutive ranges of at most step items that together cover
+   * [0, count), on the workers and the calling thread, and returns once every call has returned.
+   */
+  void parallelFor(size_t count, size_t step, const std::function<void(size_t, size_t)>& fn);
+
+private:
+  friend class TaskGroup;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  // Queues a task, on the queue of the calling worker if it is one.
+  void push(std::function<void()> task);
+  // Runs one queued task, preferring the newest task of the calling worker. Returns false if
+  // there are no queued tasks.
+  bool runQueuedTask();
+  void workerLoop(size_t index);
+
+  std::vector<std::unique_ptr<Queue>> mQueues;
+  std::vector<std::thread> mThreads;
+  std::atomic<size_t> mNextQueue = 0;
+
+  // Guards sleeping and waking workers.
+  std::mutex mMutex;
+  std::condition_variable mCv;
+  size_t mQueuedTasks = 0;
+  bool mStopping = false;
+};
+
+/*
+ * Tasks run on a ThreadPool that can be waited for together.
+ */
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool* pool) : mPool(pool) {}
+  ~TaskGroup() { wait(); }
+
+  /*
+   * Queues a task on the pool.
+   */
+  void run(std::function<void()> task);
+
+  /*
+   * Returns once every task run by this group has finished, running queued tasks of the pool
+   * meanwhile.
+   */
+  void wait();
+
+private:
+  ThreadPool* mPool;
+  std::mutex mMutex;
+  std::condition_variable mCv;
+  size_t mPendingTasks = 0;
+};
+
+} // namespace android::ultrahdr
+
+#endif // ANDROID_ULTRAHDR_THREADPOOL_H
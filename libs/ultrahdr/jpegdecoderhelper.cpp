@@ -20,6 +20,7 @@
 
 #include <errno.h>
 #include <setjmp.h>
+#include <algorithm>
 #include <string>
 
 using namespace std;
@@ -97,9 +98,19 @@ static void jpegrerror_exit(j_common_ptr cinfo) {
     longjmp(err->setjmp_buffer, 1);
 }
 
+struct JpegDecoderHelper::RowDecoder {
+    RowDecoder(const uint8_t* ptr, int len) : mgr(ptr, len) {}
+
+    jpeg_decompress_struct cinfo;
+    jpegrerror_mgr myerr;
+    jpegr_source_mgr mgr;
+};
+
 JpegDecoderHelper::JpegDecoderHelper() {}
 
-JpegDecoderHelper::~JpegDecoderHelper() {}
+JpegDecoderHelper::~JpegDecoderHelper() {
+    finishDecompressRows();
+}
 
 bool JpegDecoderHelper::decompressImage(const void* image, int length, bool decodeToRGBA) {
     if (image == nullptr || length <= 0) {
@@ -227,45 +238,7 @@ bool JpegDecoderHelper::decode(const void* image, int length, bool decodeToRGBA)
         return false;
     }
 
-    // Save XMP data, EXIF data, and ICC data.
-    // Here we only handle the first XMP / EXIF / ICC package.
-    // We assume that all packages are starting with two bytes marker (eg FF E1 for EXIF package),
-    // two bytes of package length which is stored in marker->original_length, and the real data
-    // which is stored in marker->data.
-    bool exifAppears = false;
-    bool xmpAppears = false;
-    bool iccAppears = false;
-    size_t pos = 2;  // position after SOI
-    for (jpeg_marker_struct* marker = cinfo.marker_list;
-         marker && !(exifAppears && xmpAppears && iccAppears);
-         marker = marker->next) {
-         pos += 4;
-         pos += marker->original_length;
-        if (marker->marker != kAPP1Marker && marker->marker != kAPP2Marker) {
-            continue;
-        }
-        const unsigned int len = marker->data_length;
-        if (!xmpAppears &&
-            len > sizeof(kXmpNameSpace) &&
-            !memcmp(marker->data, kXmpNameSpace, sizeof(kXmpNameSpace))) {
-            mXMPBuffer.resize(len+1, 0);
-            memcpy(static_cast<void*>(mXMPBuffer.data()), marker->data, len);
-            xmpAppears = true;
-        } else if (!exifAppears &&
-                   len > sizeof(kExifIdCode) &&
-                   !memcmp(marker->data, kExifIdCode, sizeof(kExifIdCode))) {
-            mEXIFBuffer.resize(len, 0);
-            memcpy(static_cast<void*>(mEXIFBuffer.data()), marker->data, len);
-            exifAppears = true;
-            mExifPos = pos - marker->original_length;
-        } else if (!iccAppears &&
-                   len > sizeof(kICCSig) &&
-                   !memcmp(marker->data, kICCSig, sizeof(kICCSig))) {
-            mICCBuffer.resize(len, 0);
-            memcpy(static_cast<void*>(mICCBuffer.data()), marker->data, len);
-            iccAppears = true;
-        }
-    }
+    saveMetadata(&cinfo);
 
     mWidth = cinfo.image_width;
     mHeight = cinfo.image_height;
@@ -327,6 +300,48 @@ CleanUp:
     return status;
 }
 
+void JpegDecoderHelper::saveMetadata(jpeg_decompress_struct* cinfo) {
+    // Save XMP data, EXIF data, and ICC data.
+    // Here we only handle the first XMP / EXIF / ICC package.
+    // We assume that all packages are starting with two bytes marker (eg FF E1 for EXIF package),
+    // two bytes of package length which is stored in marker->original_length, and the real data
+    // which is stored in marker->data.
+    bool exifAppears = false;
+    bool xmpAppears = false;
+    bool iccAppears = false;
+    size_t pos = 2;  // position after SOI
+    for (jpeg_marker_struct* marker = cinfo->marker_list;
+         marker && !(exifAppears && xmpAppears && iccAppears);
+         marker = marker->next) {
+         pos += 4;
+         pos += marker->original_length;
+        if (marker->marker != kAPP1Marker && marker->marker != kAPP2Marker) {
+            continue;
+        }
+        const unsigned int len = marker->data_length;
+        if (!xmpAppears &&
+            len > sizeof(kXmpNameSpace) &&
+            !memcmp(marker->data, kXmpNameSpace, sizeof(kXmpNameSpace))) {
+            mXMPBuffer.resize(len+1, 0);
+            memcpy(static_cast<void*>(mXMPBuffer.data()), marker->data, len);
+            xmpAppears = true;
+        } else if (!exifAppears &&
+                   len > sizeof(kExifIdCode) &&
+                   !memcmp(marker->data, kExifIdCode, sizeof(kExifIdCode))) {
+            mEXIFBuffer.resize(len, 0);
+            memcpy(static_cast<void*>(mEXIFBuffer.data()), marker->data, len);
+            exifAppears = true;
+            mExifPos = pos - marker->original_length;
+        } else if (!iccAppears &&
+                   len > sizeof(kICCSig) &&
+                   !memcmp(marker->data, kICCSig, sizeof(kICCSig))) {
+            mICCBuffer.resize(len, 0);
+            memcpy(static_cast<void*>(mICCBuffer.data()), marker->data, len);
+            iccAppears = true;
+        }
+    }
+}
+
 bool JpegDecoderHelper::decompress(jpeg_decompress_struct* cinfo, const uint8_t* dest,
                                    bool isSingleChannel) {
     return isSingleChannel
@@ -401,6 +416,139 @@ bool JpegDecoderHelper::getCompressedImageParameters(const void* image, int leng
     return true;
 }
 
+bool JpegDecoderHelper::startDecompressRows(const void* image, int length) {
+    finishDecompressRows();
+    if (image == nullptr || length <= 0) {
+        ALOGE("Image size can not be handled: %d", length);
+        return false;
+    }
+    mResultBuffer.clear();
+    mXMPBuffer.clear();
+
+    mRowDecoder = std::make_unique<RowDecoder>(static_cast<const uint8_t*>(image), length);
+    jpeg_decompress_struct* cinfo = &mRowDecoder->cinfo;
+    cinfo->err = jpeg_std_error(&mRowDecoder->myerr.pub);
+    mRowDecoder->myerr.pub.error_exit = jpegrerror_exit;
+    if (setjmp(mRowDecoder->myerr.setjmp_buffer)) {
+        finishDecompressRows();
+        return false;
+    }
+
+    jpeg_create_decompress(cinfo);
+
+    jpeg_save_markers(cinfo, kAPP0Marker, 0xFFFF);
+    jpeg_save_markers(cinfo, kAPP1Marker, 0xFFFF);
+    jpeg_save_markers(cinfo, kAPP2Marker, 0xFFFF);
+
+    cinfo->src = &mRowDecoder->mgr;
+    if (jpeg_read_header(cinfo, TRUE) != JPEG_HEADER_OK) {
+        finishDecompressRows();
+        return false;
+    }
+
+    saveMetadata(cinfo);
+
+    mWidth = cinfo->image_width;
+    mHeight = cinfo->image_height;
+    if (mWidth > kMaxWidth || mHeight > kMaxHeight) {
+        finishDecompressRows();
+        return false;
+    }
+
+    if (cinfo->jpeg_color_space == JCS_YCbCr) {
+        if (cinfo->comp_info[0].h_samp_factor != 2 || cinfo->comp_info[0].v_samp_factor != 2 ||
+            cinfo->comp_info[1].h_samp_factor != 1 || cinfo->comp_info[1].v_samp_factor != 1 ||
+            cinfo->comp_info[2].h_samp_factor != 1 || cinfo->comp_info[2].v_samp_factor != 1) {
+            ALOGE("%s: decoding to YUV only supports 4:2:0 subsampling", __func__);
+            finishDecompressRows();
+            return false;
+        }
+    } else if (cinfo->jpeg_color_space != JCS_GRAYSCALE) {
+        ALOGE("%s: decodeToYUV unexpected jpeg color space", __func__);
+        finishDecompressRows();
+        return false;
+    }
+    cinfo->out_color_space = cinfo->jpeg_color_space;
+    cinfo->raw_data_out = TRUE;
+    cinfo->dct_method = JDCT_ISLOW;
+    jpeg_start_decompress(cinfo);
+
+    // libjpeg returns one iMCU row per call, which is 16 rows of Y and 8 rows of U and V for
+    // 4:2:0 images, and 8 rows for grey-scale images. Rows are padded to whole MCUs.
+    mRowsPerStrip = cinfo->max_v_samp_factor * DCTSIZE;
+    if (mRowsPerStrip > kCompressBatchSize) {
+        ALOGE("%s: unexpected vertical sampling factor %d", __func__, cinfo->max_v_samp_factor);
+        finishDecompressRows();
+        return false;
+    }
+    mRowStride = ALIGNM(cinfo->image_width, kCompressBatchSize);
+    size_t strip_size = mRowStride * mRowsPerStrip;
+    if (cinfo->jpeg_color_space == JCS_YCbCr) {
+        strip_size += strip_size / 2;
+    }
+    mResultBuffer.resize(strip_size, 0);
+    return true;
+}
+
+bool JpegDecoderHelper::decompressRows(size_t* firstRow, size_t* numRows) {
+    if (mRowDecoder == nullptr || firstRow == nullptr || numRows == nullptr) {
+        return false;
+    }
+    jpeg_decompress_struct* cinfo = &mRowDecoder->cinfo;
+    if (setjmp(mRowDecoder->myerr.setjmp_buffer)) {
+        finishDecompressRows();
+        return false;
+    }
+
+    JSAMPROW y[kCompressBatchSize];
+    JSAMPROW cb[kCompressBatchSize / 2];
+    JSAMPROW cr[kCompressBatchSize / 2];
+    JSAMPARRAY planes[3]{y, cb, cr};
+    uint8_t* y_plane = mResultBuffer.data();
+    uint8_t* u_plane = y_plane + mRowStride * mRowsPerStrip;
+    uint8_t* v_plane = u_plane + mRowStride * mRowsPerStrip / 4;
+    for (size_t i = 0; i < mRowsPerStrip; ++i) {
+        y[i] = y_plane + i * mRowStride;
+    }
+    if (cinfo->jpeg_color_space == JCS_YCbCr) {
+        for (size_t i = 0; i < mRowsPerStrip / 2; ++i) {
+            cb[i] = u_plane + i * (mRowStride / 2);
+            cr[i] = v_plane + i * (mRowStride / 2);
+        }
+    }
+
+    size_t scanline = cinfo->output_scanline;
+    size_t processed = jpeg_read_raw_data(cinfo, planes, mRowsPerStrip);
+    if (processed != mRowsPerStrip) {
+        ALOGE("Number of processed lines does not equal input lines.");
+        finishDecompressRows();
+        return false;
+    }
+    *firstRow = scanline;
+    *numRows = std::min<size_t>(mRowsPerStrip, cinfo->image_height - scanline);
+
+    if (cinfo->output_scanline >= cinfo->image_height) {
+        jpeg_finish_decompress(cinfo);
+        finishDecompressRows();
+    }
+    return true;
+}
+
+size_t JpegDecoderHelper::getRowsPerStrip() {
+    return mRowsPerStrip;
+}
+
+size_t JpegDecoderHelper::getRowStride() {
+    return mRowStride;
+}
+
+void JpegDecoderHelper::finishDecompressRows() {
+    if (mRowDecoder != nullptr) {
+        jpeg_destroy_decompress(&mRowDecoder->cinfo);
+        mRowDecoder.reset();
+    }
+}
+
 bool JpegDecoderHelper::decompressRGBA(jpeg_decompress_struct* cinfo, const uint8_t* dest) {
     JSAMPLE* out = (JSAMPLE*)dest;
 
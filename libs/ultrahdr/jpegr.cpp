@@ -14,18 +14,20 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
-#include <condition_variable>
-#include <deque>
 #include <memory>
 #include <mutex>
-#include <thread>
+#include <optional>
 
 #include <ultrahdr/gainmapmath.h>
+#include <ultrahdr/gainmaprowkernels.h>
 #include <ultrahdr/icc.h>
 #include <ultrahdr/jpegr.h>
 #include <ultrahdr/jpegrutils.h>
 #include <ultrahdr/multipictureformat.h>
+#include <ultrahdr/threadpool.h>
 
 #include <image_io/base/data_segment_data_source.h>
 #include <image_io/jpeg/jpeg_info.h>
@@ -96,6 +98,76 @@ static void copyJpegWithoutExif(jr_compressed_ptr pDest,
          pSource->length - exif_pos - exif_size);
 }
 
+// Number of image rows processed by one task of the thread pool.
+const int kJobSzInRows = 16;
+static_assert(kJobSzInRows > 0 && kJobSzInRows % kMapDimensionScaleFactor == 0,
+              "align job size to kMapDimensionScaleFactor");
+
+// Stores the time from its construction to its destruction in *us, in microseconds.
+class ScopedStageTimer {
+public:
+  explicit ScopedStageTimer(int64_t* us) : mUs(us), mStart(std::chrono::steady_clock::now()) {}
+  ~ScopedStageTimer() {
+    *mUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 mStart)
+                   .count();
+  }
+
+private:
+  int64_t* mUs;
+  std::chrono::steady_clock::time_point mStart;
+};
+
+// Times one encode call. The stage timers of the call write to timing, which only this call
+// uses, and the result replaces *last under lock once the call returns.
+class ScopedEncodeTiming {
+public:
+  ScopedEncodeTiming(std::mutex* lock, jpegr_encode_timing_struct* last)
+        : mLock(lock), mLast(last), mTotalTimer(&timing.totalUs) {}
+  ~ScopedEncodeTiming() {
+    mTotalTimer.reset();
+    std::lock_guard<std::mutex> guard(*mLock);
+    *mLast = timing;
+  }
+
+  jpegr_encode_timing_struct timing = {};
+
+private:
+  std::mutex* mLock;
+  jpegr_encode_timing_struct* mLast;
+  std::optional<ScopedStageTimer> mTotalTimer;
+};
+
+JpegR::JpegR() : mWorkerThreadCount(std::clamp(GetCPUCoreCount(), 1, 4) - 1) {}
+
+JpegR::~JpegR() {}
+
+void JpegR::setWorkerThreadCount(size_t count) {
+  std::lock_guard<std::mutex> lock(mThreadPoolLock);
+  if (count != mWorkerThreadCount) {
+    mWorkerThreadCount = count;
+    // Calls that are running keep the old pool until they return.
+    mThreadPool.reset();
+  }
+}
+
+std::shared_ptr<ThreadPool> JpegR::getThreadPool() {
+  std::lock_guard<std::mutex> lock(mThreadPoolLock);
+  if (mThreadPool == nullptr) {
+    mThreadPool = std::make_shared<ThreadPool>(mWorkerThreadCount);
+  }
+  return mThreadPool;
+}
+
+status_t JpegR::getEncodeTiming(jr_encode_timing_ptr timing) {
+  if (timing == nullptr) {
+    return ERROR_JPEGR_INVALID_NULL_PTR;
+  }
+  std::lock_guard<std::mutex> lock(mEncodeTimingLock);
+  *timing = mEncodeTiming;
+  return NO_ERROR;
+}
+
 status_t JpegR::areInputArgumentsValid(jr_uncompressed_ptr p010_image_ptr,
                                        jr_uncompressed_ptr yuv420_image_ptr,
                                        ultrahdr_transfer_function hdr_tf,
@@ -199,6 +271,7 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr, ultrahdr_transfe
     ALOGE("received nullptr for exif metadata");
     return ERROR_JPEGR_INVALID_NULL_PTR;
   }
+  ScopedEncodeTiming encode_timing(&mEncodeTimingLock, &mEncodeTiming);
 
   // clean up input structure for later usage
   jpegr_uncompressed_struct p010_image = *p010_image_ptr;
@@ -223,18 +296,61 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr, ultrahdr_transfe
   yuv420_image.chroma_data = data + yuv420_image.luma_stride * yuv420_image.height;
 
   // tone map
-  JPEGR_CHECK(toneMap(&p010_image, &yuv420_image));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.toneMapUs);
+    JPEGR_CHECK(toneMap(&p010_image, &yuv420_image));
+  }
+
+  // compress 420 image, on the thread pool while the gain map is generated and compressed
+  sp<DataStruct> icc = IccHelper::writeIccProfile(ULTRAHDR_TF_SRGB, yuv420_image.colorGamut);
+  JpegEncoderHelper jpeg_enc_obj_yuv420;
+  status_t primary_status = NO_ERROR;
+  auto compressPrimaryImage = [this, &encode_timing, &yuv420_image, &jpeg_enc_obj_yuv420, &icc,
+                               quality, &primary_status]() {
+    ScopedStageTimer timer(&encode_timing.timing.compressPrimaryImageUs);
+    // convert to Bt601 YUV encoding for JPEG encode
+    if (yuv420_image.colorGamut != ULTRAHDR_COLORGAMUT_P3) {
+      primary_status =
+              convertYuv(&yuv420_image, yuv420_image.colorGamut, ULTRAHDR_COLORGAMUT_P3);
+      if (primary_status != NO_ERROR) {
+        return;
+      }
+    }
+    if (!jpeg_enc_obj_yuv420.compressImage(reinterpret_cast<uint8_t*>(yuv420_image.data),
+                                           reinterpret_cast<uint8_t*>(yuv420_image.chroma_data),
+                                           yuv420_image.width, yuv420_image.height,
+                                           yuv420_image.luma_stride, yuv420_image.chroma_stride,
+                                           quality, icc->getData(), icc->getLength())) {
+      primary_status = ERROR_JPEGR_ENCODE_ERROR;
+    }
+  };
+  // The YUV conversion is done in place, so it has to wait until the gain map is generated.
+  const bool primary_needs_conversion = yuv420_image.colorGamut != ULTRAHDR_COLORGAMUT_P3;
+  std::shared_ptr<ThreadPool> pool = getThreadPool();
+  TaskGroup primary_task(pool.get());
+  if (!primary_needs_conversion) {
+    primary_task.run(compressPrimaryImage);
+  }
 
   // gain map
   ultrahdr_metadata_struct metadata = {.version = kJpegrVersion};
   jpegr_uncompressed_struct gainmap_image;
-  JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.generateGainMapUs);
+    JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image));
+  }
   std::unique_ptr<uint8_t[]> map_data;
   map_data.reset(reinterpret_cast<uint8_t*>(gainmap_image.data));
+  if (primary_needs_conversion) {
+    primary_task.run(compressPrimaryImage);
+  }
 
   // compress gain map
   JpegEncoderHelper jpeg_enc_obj_gm;
-  JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.compressGainMapUs);
+    JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  }
   jpegr_compressed_struct compressed_map = {.data = jpeg_enc_obj_gm.getCompressedImagePtr(),
                                             .length = static_cast<int>(
                                                     jpeg_enc_obj_gm.getCompressedImageSize()),
@@ -242,22 +358,8 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr, ultrahdr_transfe
                                                     jpeg_enc_obj_gm.getCompressedImageSize()),
                                             .colorGamut = ULTRAHDR_COLORGAMUT_UNSPECIFIED};
 
-  sp<DataStruct> icc = IccHelper::writeIccProfile(ULTRAHDR_TF_SRGB, yuv420_image.colorGamut);
-
-  // convert to Bt601 YUV encoding for JPEG encode
-  if (yuv420_image.colorGamut != ULTRAHDR_COLORGAMUT_P3) {
-    JPEGR_CHECK(convertYuv(&yuv420_image, yuv420_image.colorGamut, ULTRAHDR_COLORGAMUT_P3));
-  }
-
-  // compress 420 image
-  JpegEncoderHelper jpeg_enc_obj_yuv420;
-  if (!jpeg_enc_obj_yuv420.compressImage(reinterpret_cast<uint8_t*>(yuv420_image.data),
-                                         reinterpret_cast<uint8_t*>(yuv420_image.chroma_data),
-                                         yuv420_image.width, yuv420_image.height,
-                                         yuv420_image.luma_stride, yuv420_image.chroma_stride,
-                                         quality, icc->getData(), icc->getLength())) {
-    return ERROR_JPEGR_ENCODE_ERROR;
-  }
+  primary_task.wait();
+  JPEGR_CHECK(primary_status);
   jpegr_compressed_struct jpeg = {.data = jpeg_enc_obj_yuv420.getCompressedImagePtr(),
                                   .length = static_cast<int>(
                                           jpeg_enc_obj_yuv420.getCompressedImageSize()),
@@ -266,8 +368,11 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr, ultrahdr_transfe
                                   .colorGamut = yuv420_image.colorGamut};
 
   // append gain map, no ICC since JPEG encode already did it
-  JPEGR_CHECK(appendGainMap(&jpeg, &compressed_map, exif, /* icc */ nullptr, /* icc size */ 0,
-                            &metadata, dest));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.appendGainMapUs);
+    JPEGR_CHECK(appendGainMap(&jpeg, &compressed_map, exif, /* icc */ nullptr, /* icc size */ 0,
+                              &metadata, dest));
+  }
 
   return NO_ERROR;
 }
@@ -289,6 +394,7 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
       ret != NO_ERROR) {
     return ret;
   }
+  ScopedEncodeTiming encode_timing(&mEncodeTimingLock, &mEncodeTiming);
 
   // clean up input structure for later usage
   jpegr_uncompressed_struct p010_image = *p010_image_ptr;
@@ -306,16 +412,108 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
     yuv420_image.chroma_stride = yuv420_image.luma_stride >> 1;
   }
 
+  // compress 420 image, on the thread pool while the gain map is generated and compressed
+  sp<DataStruct> icc = IccHelper::writeIccProfile(ULTRAHDR_TF_SRGB, yuv420_image.colorGamut);
+  jpegr_uncompressed_struct yuv420_bt601_image = yuv420_image;
+  unique_ptr<uint8_t[]> yuv_420_bt601_data;
+  JpegEncoderHelper jpeg_enc_obj_yuv420;
+  status_t primary_status = NO_ERROR;
+  std::shared_ptr<ThreadPool> pool = getThreadPool();
+  TaskGroup primary_task(pool.get());
+  primary_task.run([&]() {
+    ScopedStageTimer timer(&encode_timing.timing.compressPrimaryImageUs);
+    // Convert to bt601 YUV encoding for JPEG encode
+    if (yuv420_image.colorGamut != ULTRAHDR_COLORGAMUT_P3) {
+      const int yuv_420_bt601_luma_stride = ALIGNM(yuv420_image.width, kJpegBlock);
+      yuv_420_bt601_data =
+              make_unique<uint8_t[]>(yuv_420_bt601_luma_stride * yuv420_image.height * 3 / 2);
+      yuv420_bt601_image.data = yuv_420_bt601_data.get();
+      yuv420_bt601_image.colorGamut = yuv420_image.colorGamut;
+      yuv420_bt601_image.luma_stride = yuv_420_bt601_luma_stride;
+      uint8_t* data = reinterpret_cast<uint8_t*>(yuv420_bt601_image.data);
+      yuv420_bt601_image.chroma_data = data + yuv_420_bt601_luma_stride * yuv420_image.height;
+      yuv420_bt601_image.chroma_stride = yuv_420_bt601_luma_stride >> 1;
+
+      {
+        // copy luma
+        uint8_t* y_dst = reinterpret_cast<uint8_t*>(yuv420_bt601_image.data);
+        uint8_t* y_src = reinterpret_cast<uint8_t*>(yuv420_image.data);
+        if (yuv420_bt601_image.luma_stride == yuv420_image.luma_stride) {
+          memcpy(y_dst, y_src, yuv420_bt601_image.luma_stride * yuv420_image.height);
+        } else {
+          for (size_t i = 0; i < yuv420_image.height; i++) {
+            memcpy(y_dst, y_src, yuv420_image.width);
+            if (yuv420_image.width != yuv420_bt601_image.luma_stride) {
+              memset(y_dst + yuv420_image.width, 0,
+                     yuv420_bt601_image.luma_stride - yuv420_image.width);
+            }
+            y_dst += yuv420_bt601_image.luma_stride;
+            y_src += yuv420_image.luma_stride;
+          }
+        }
+      }
+
+      if (yuv420_bt601_image.chroma_stride == yuv420_image.chroma_stride) {
+        // copy luma
+        uint8_t* ch_dst = reinterpret_cast<uint8_t*>(yuv420_bt601_image.chroma_data);
+        uint8_t* ch_src = reinterpret_cast<uint8_t*>(yuv420_image.chroma_data);
+        memcpy(ch_dst, ch_src, yuv420_bt601_image.chroma_stride * yuv420_image.height);
+      } else {
+        // copy cb & cr
+        uint8_t* cb_dst = reinterpret_cast<uint8_t*>(yuv420_bt601_image.chroma_data);
+        uint8_t* cb_src = reinterpret_cast<uint8_t*>(yuv420_image.chroma_data);
+        uint8_t* cr_dst =
+                cb_dst + (yuv420_bt601_image.chroma_stride * yuv420_bt601_image.height / 2);
+        uint8_t* cr_src = cb_src + (yuv420_image.chroma_stride * yuv420_image.height / 2);
+        for (size_t i = 0; i < yuv420_image.height / 2; i++) {
+          memcpy(cb_dst, cb_src, yuv420_image.width / 2);
+          memcpy(cr_dst, cr_src, yuv420_image.width / 2);
+          if (yuv420_bt601_image.width / 2 != yuv420_bt601_image.chroma_stride) {
+            memset(cb_dst + yuv420_image.width / 2, 0,
+                   yuv420_bt601_image.chroma_stride - yuv420_image.width / 2);
+            memset(cr_dst + yuv420_image.width / 2, 0,
+                   yuv420_bt601_image.chroma_stride - yuv420_image.width / 2);
+          }
+          cb_dst += yuv420_bt601_image.chroma_stride;
+          cb_src += yuv420_image.chroma_stride;
+          cr_dst += yuv420_bt601_image.chroma_stride;
+          cr_src += yuv420_image.chroma_stride;
+        }
+      }
+      primary_status =
+              convertYuv(&yuv420_bt601_image, yuv420_image.colorGamut, ULTRAHDR_COLORGAMUT_P3);
+      if (primary_status != NO_ERROR) {
+        return;
+      }
+    }
+
+    if (!jpeg_enc_obj_yuv420.compressImage(reinterpret_cast<uint8_t*>(yuv420_bt601_image.data),
+                                           reinterpret_cast<uint8_t*>(
+                                                   yuv420_bt601_image.chroma_data),
+                                           yuv420_bt601_image.width, yuv420_bt601_image.height,
+                                           yuv420_bt601_image.luma_stride,
+                                           yuv420_bt601_image.chroma_stride, quality,
+                                           icc->getData(), icc->getLength())) {
+      primary_status = ERROR_JPEGR_ENCODE_ERROR;
+    }
+  });
+
   // gain map
   ultrahdr_metadata_struct metadata = {.version = kJpegrVersion};
   jpegr_uncompressed_struct gainmap_image;
-  JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.generateGainMapUs);
+    JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image));
+  }
   std::unique_ptr<uint8_t[]> map_data;
   map_data.reset(reinterpret_cast<uint8_t*>(gainmap_image.data));
 
   // compress gain map
   JpegEncoderHelper jpeg_enc_obj_gm;
-  JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.compressGainMapUs);
+    JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  }
   jpegr_compressed_struct compressed_map = {.data = jpeg_enc_obj_gm.getCompressedImagePtr(),
                                             .length = static_cast<int>(
                                                     jpeg_enc_obj_gm.getCompressedImageSize()),
@@ -323,80 +521,8 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
                                                     jpeg_enc_obj_gm.getCompressedImageSize()),
                                             .colorGamut = ULTRAHDR_COLORGAMUT_UNSPECIFIED};
 
-  sp<DataStruct> icc = IccHelper::writeIccProfile(ULTRAHDR_TF_SRGB, yuv420_image.colorGamut);
-
-  jpegr_uncompressed_struct yuv420_bt601_image = yuv420_image;
-  unique_ptr<uint8_t[]> yuv_420_bt601_data;
-  // Convert to bt601 YUV encoding for JPEG encode
-  if (yuv420_image.colorGamut != ULTRAHDR_COLORGAMUT_P3) {
-    const int yuv_420_bt601_luma_stride = ALIGNM(yuv420_image.width, kJpegBlock);
-    yuv_420_bt601_data =
-            make_unique<uint8_t[]>(yuv_420_bt601_luma_stride * yuv420_image.height * 3 / 2);
-    yuv420_bt601_image.data = yuv_420_bt601_data.get();
-    yuv420_bt601_image.colorGamut = yuv420_image.colorGamut;
-    yuv420_bt601_image.luma_stride = yuv_420_bt601_luma_stride;
-    uint8_t* data = reinterpret_cast<uint8_t*>(yuv420_bt601_image.data);
-    yuv420_bt601_image.chroma_data = data + yuv_420_bt601_luma_stride * yuv420_image.height;
-    yuv420_bt601_image.chroma_stride = yuv_420_bt601_luma_stride >> 1;
-
-    {
-      // copy luma
-      uint8_t* y_dst = reinterpret_cast<uint8_t*>(yuv420_bt601_image.data);
-      uint8_t* y_src = reinterpret_cast<uint8_t*>(yuv420_image.data);
-      if (yuv420_bt601_image.luma_stride == yuv420_image.luma_stride) {
-        memcpy(y_dst, y_src, yuv420_bt601_image.luma_stride * yuv420_image.height);
-      } else {
-        for (size_t i = 0; i < yuv420_image.height; i++) {
-          memcpy(y_dst, y_src, yuv420_image.width);
-          if (yuv420_image.width != yuv420_bt601_image.luma_stride) {
-            memset(y_dst + yuv420_image.width, 0,
-                   yuv420_bt601_image.luma_stride - yuv420_image.width);
-          }
-          y_dst += yuv420_bt601_image.luma_stride;
-          y_src += yuv420_image.luma_stride;
-        }
-      }
-    }
-
-    if (yuv420_bt601_image.chroma_stride == yuv420_image.chroma_stride) {
-      // copy luma
-      uint8_t* ch_dst = reinterpret_cast<uint8_t*>(yuv420_bt601_image.chroma_data);
-      uint8_t* ch_src = reinterpret_cast<uint8_t*>(yuv420_image.chroma_data);
-      memcpy(ch_dst, ch_src, yuv420_bt601_image.chroma_stride * yuv420_image.height);
-    } else {
-      // copy cb & cr
-      uint8_t* cb_dst = reinterpret_cast<uint8_t*>(yuv420_bt601_image.chroma_data);
-      uint8_t* cb_src = reinterpret_cast<uint8_t*>(yuv420_image.chroma_data);
-      uint8_t* cr_dst = cb_dst + (yuv420_bt601_image.chroma_stride * yuv420_bt601_image.height / 2);
-      uint8_t* cr_src = cb_src + (yuv420_image.chroma_stride * yuv420_image.height / 2);
-      for (size_t i = 0; i < yuv420_image.height / 2; i++) {
-        memcpy(cb_dst, cb_src, yuv420_image.width / 2);
-        memcpy(cr_dst, cr_src, yuv420_image.width / 2);
-        if (yuv420_bt601_image.width / 2 != yuv420_bt601_image.chroma_stride) {
-          memset(cb_dst + yuv420_image.width / 2, 0,
-                 yuv420_bt601_image.chroma_stride - yuv420_image.width / 2);
-          memset(cr_dst + yuv420_image.width / 2, 0,
-                 yuv420_bt601_image.chroma_stride - yuv420_image.width / 2);
-        }
-        cb_dst += yuv420_bt601_image.chroma_stride;
-        cb_src += yuv420_image.chroma_stride;
-        cr_dst += yuv420_bt601_image.chroma_stride;
-        cr_src += yuv420_image.chroma_stride;
-      }
-    }
-    JPEGR_CHECK(convertYuv(&yuv420_bt601_image, yuv420_image.colorGamut, ULTRAHDR_COLORGAMUT_P3));
-  }
-
-  // compress 420 image
-  JpegEncoderHelper jpeg_enc_obj_yuv420;
-  if (!jpeg_enc_obj_yuv420.compressImage(reinterpret_cast<uint8_t*>(yuv420_bt601_image.data),
-                                         reinterpret_cast<uint8_t*>(yuv420_bt601_image.chroma_data),
-                                         yuv420_bt601_image.width, yuv420_bt601_image.height,
-                                         yuv420_bt601_image.luma_stride,
-                                         yuv420_bt601_image.chroma_stride, quality, icc->getData(),
-                                         icc->getLength())) {
-    return ERROR_JPEGR_ENCODE_ERROR;
-  }
+  primary_task.wait();
+  JPEGR_CHECK(primary_status);
 
   jpegr_compressed_struct jpeg = {.data = jpeg_enc_obj_yuv420.getCompressedImagePtr(),
                                   .length = static_cast<int>(
@@ -406,8 +532,11 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
                                   .colorGamut = yuv420_image.colorGamut};
 
   // append gain map, no ICC since JPEG encode already did it
-  JPEGR_CHECK(appendGainMap(&jpeg, &compressed_map, exif, /* icc */ nullptr, /* icc size */ 0,
-                            &metadata, dest));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.appendGainMapUs);
+    JPEGR_CHECK(appendGainMap(&jpeg, &compressed_map, exif, /* icc */ nullptr, /* icc size */ 0,
+                              &metadata, dest));
+  }
   return NO_ERROR;
 }
 
@@ -429,6 +558,7 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
       ret != NO_ERROR) {
     return ret;
   }
+  ScopedEncodeTiming encode_timing(&mEncodeTimingLock, &mEncodeTiming);
 
   // clean up input structure for later usage
   jpegr_uncompressed_struct p010_image = *p010_image_ptr;
@@ -449,13 +579,19 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
   // gain map
   ultrahdr_metadata_struct metadata = {.version = kJpegrVersion};
   jpegr_uncompressed_struct gainmap_image;
-  JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.generateGainMapUs);
+    JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image));
+  }
   std::unique_ptr<uint8_t[]> map_data;
   map_data.reset(reinterpret_cast<uint8_t*>(gainmap_image.data));
 
   // compress gain map
   JpegEncoderHelper jpeg_enc_obj_gm;
-  JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.compressGainMapUs);
+    JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  }
   jpegr_compressed_struct gainmapjpg_image = {.data = jpeg_enc_obj_gm.getCompressedImagePtr(),
                                               .length = static_cast<int>(
                                                       jpeg_enc_obj_gm.getCompressedImageSize()),
@@ -463,7 +599,8 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
                                                       jpeg_enc_obj_gm.getCompressedImageSize()),
                                               .colorGamut = ULTRAHDR_COLORGAMUT_UNSPECIFIED};
 
-  return encodeJPEGR(yuv420jpg_image_ptr, &gainmapjpg_image, &metadata, dest);
+  ScopedStageTimer timer(&encode_timing.timing.appendGainMapUs);
+  return appendGainMapAndIcc(yuv420jpg_image_ptr, &gainmapjpg_image, &metadata, dest);
 }
 
 /* Encode API-3 */
@@ -478,6 +615,7 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
   if (auto ret = areInputArgumentsValid(p010_image_ptr, nullptr, hdr_tf, dest); ret != NO_ERROR) {
     return ret;
   }
+  ScopedEncodeTiming encode_timing(&mEncodeTimingLock, &mEncodeTiming);
 
   // clean up input structure for later usage
   jpegr_uncompressed_struct p010_image = *p010_image_ptr;
@@ -514,14 +652,20 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
   // gain map
   ultrahdr_metadata_struct metadata = {.version = kJpegrVersion};
   jpegr_uncompressed_struct gainmap_image;
-  JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image,
-                              true /* sdr_is_601 */));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.generateGainMapUs);
+    JPEGR_CHECK(generateGainMap(&yuv420_image, &p010_image, hdr_tf, &metadata, &gainmap_image,
+                                true /* sdr_is_601 */));
+  }
   std::unique_ptr<uint8_t[]> map_data;
   map_data.reset(reinterpret_cast<uint8_t*>(gainmap_image.data));
 
   // compress gain map
   JpegEncoderHelper jpeg_enc_obj_gm;
-  JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  {
+    ScopedStageTimer timer(&encode_timing.timing.compressGainMapUs);
+    JPEGR_CHECK(compressGainMap(&gainmap_image, &jpeg_enc_obj_gm));
+  }
   jpegr_compressed_struct gainmapjpg_image = {.data = jpeg_enc_obj_gm.getCompressedImagePtr(),
                                               .length = static_cast<int>(
                                                       jpeg_enc_obj_gm.getCompressedImageSize()),
@@ -529,7 +673,8 @@ status_t JpegR::encodeJPEGR(jr_uncompressed_ptr p010_image_ptr,
                                                       jpeg_enc_obj_gm.getCompressedImageSize()),
                                               .colorGamut = ULTRAHDR_COLORGAMUT_UNSPECIFIED};
 
-  return encodeJPEGR(yuv420jpg_image_ptr, &gainmapjpg_image, &metadata, dest);
+  ScopedStageTimer timer(&encode_timing.timing.appendGainMapUs);
+  return appendGainMapAndIcc(yuv420jpg_image_ptr, &gainmapjpg_image, &metadata, dest);
 }
 
 /* Encode API-4 */
@@ -548,7 +693,14 @@ status_t JpegR::encodeJPEGR(jr_compressed_ptr yuv420jpg_image_ptr,
     ALOGE("received nullptr for destination");
     return ERROR_JPEGR_INVALID_NULL_PTR;
   }
+  ScopedEncodeTiming encode_timing(&mEncodeTimingLock, &mEncodeTiming);
+  ScopedStageTimer timer(&encode_timing.timing.appendGainMapUs);
+  return appendGainMapAndIcc(yuv420jpg_image_ptr, gainmapjpg_image_ptr, metadata, dest);
+}
 
+status_t JpegR::appendGainMapAndIcc(jr_compressed_ptr yuv420jpg_image_ptr,
+                                    jr_compressed_ptr gainmapjpg_image_ptr,
+                                    ultrahdr_metadata_ptr metadata, jr_compressed_ptr dest) {
   // We just want to check if ICC is present, so don't do a full decode. Note,
   // this doesn't verify that the ICC is valid.
   JpegDecoderHelper decoder;
@@ -746,62 +898,220 @@ status_t JpegR::compressGainMap(jr_uncompressed_ptr gainmap_image_ptr,
   return NO_ERROR;
 }
 
-const int kJobSzInRows = 16;
-static_assert(kJobSzInRows > 0 && kJobSzInRows % kMapDimensionScaleFactor == 0,
-              "align job size to kMapDimensionScaleFactor");
+static status_t checkGainMapMetadata(ultrahdr_metadata_ptr metadata) {
+  if (metadata->version.compare(kJpegrVersion)) {
+    ALOGE("Unsupported metadata version: %s", metadata->version.c_str());
+    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  }
+  if (metadata->gamma != 1.0f) {
+    ALOGE("Unsupported metadata gamma: %f", metadata->gamma);
+    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  }
+  if (metadata->offsetSdr != 0.0f || metadata->offsetHdr != 0.0f) {
+    ALOGE("Unsupported metadata offset sdr, hdr: %f, %f", metadata->offsetSdr, metadata->offsetHdr);
+    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  }
+  if (metadata->hdrCapacityMin != metadata->minContentBoost ||
+      metadata->hdrCapacityMax != metadata->maxContentBoost) {
+    ALOGE("Unsupported metadata hdr capacity min, max: %f, %f", metadata->hdrCapacityMin,
+          metadata->hdrCapacityMax);
+    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  }
+  return NO_ERROR;
+}
 
-class JobQueue {
+static status_t checkGainMapDimensions(size_t image_width, size_t image_height,
+                                       size_t gainmap_width, size_t gainmap_height) {
+  // TODO: remove once map scaling factor is computed based on actual map dims
+  size_t map_width = image_width / kMapDimensionScaleFactor;
+  size_t map_height = image_height / kMapDimensionScaleFactor;
+  if (map_width != gainmap_width || map_height != gainmap_height) {
+    ALOGE("gain map dimensions and primary image dimensions are not to scale, computed gain map "
+          "resolution is %dx%d, received gain map resolution is %dx%d",
+          (int)map_width, (int)map_height, (int)gainmap_width, (int)gainmap_height);
+    return ERROR_JPEGR_INVALID_INPUT_TYPE;
+  }
+  return NO_ERROR;
+}
+
+// Rows of the gain map that row y of the image is interpolated from.
+static void getMapRowsForImageRow(size_t y, int map_height, int* map_y, int* next_map_y) {
+  // TODO: determine map scaling factor based on actual map dims
+  *map_y = std::min(static_cast<int>(y / kMapDimensionScaleFactor), map_height - 1);
+  *next_map_y = std::min(*map_y + 1, map_height - 1);
+}
+
+// Applies a gain map to a row of an SDR image at a time. Shared by the threads applying a gain map
+// to a whole image, and used to apply one to the strips of a streamed image.
+class GainMapRowApplier {
 public:
-  bool dequeueJob(size_t& rowStart, size_t& rowEnd);
-  void enqueueJob(size_t rowStart, size_t rowEnd);
-  void markQueueForEnd();
-  void reset();
+  GainMapRowApplier(ultrahdr_metadata_ptr metadata, ultrahdr_output_format output_format,
+                    float max_display_boost);
+
+  // Size of an output pixel in bytes.
+  size_t getBytesPerPixel() const;
+
+  // Applies the gain map rows map_row and next_map_row to row y of yuv420_image_ptr, which is row
+  // image_y of the whole image, and writes the output pixels to dest_row. rows must have room for
+  // 4 * yuv420_image_ptr->width floats.
+  void applyRow(jr_uncompressed_ptr yuv420_image_ptr, size_t y, const uint8_t* map_row,
+                const uint8_t* next_map_row, int map_width, size_t image_y, float* rows,
+                void* dest_row);
 
 private:
-  bool mQueuedAllJobs = false;
-  std::deque<std::tuple<size_t, size_t>> mJobs;
-  std::mutex mMutex;
-  std::condition_variable mCv;
+#if !USE_APPLY_GAIN_LUT
+  ultrahdr_metadata_ptr mMetadata;
+#endif
+  ultrahdr_output_format mOutputFormat;
+  float mDisplayBoost;
+  ShepardsIDW mIdwTable;
+  GainLUT mGainLUT;
+  ColorTransformFn mSdrYuvToRgbFn;
+  ColorTransformFn mSdrInvOetf;
+  ColorTransformFn mHdrOetf;
+  const GainMapRowKernels& mKernels;
 };
 
-bool JobQueue::dequeueJob(size_t& rowStart, size_t& rowEnd) {
-  std::unique_lock<std::mutex> lock{mMutex};
-  while (true) {
-    if (mJobs.empty()) {
-      if (mQueuedAllJobs) {
-        return false;
-      } else {
-        mCv.wait_for(lock, std::chrono::milliseconds(100));
-      }
-    } else {
-      auto it = mJobs.begin();
-      rowStart = std::get<0>(*it);
-      rowEnd = std::get<1>(*it);
-      mJobs.erase(it);
-      return true;
-    }
+GainMapRowApplier::GainMapRowApplier(ultrahdr_metadata_ptr metadata,
+                                     ultrahdr_output_format output_format,
+                                     float max_display_boost)
+      :
+#if !USE_APPLY_GAIN_LUT
+        mMetadata(metadata),
+#endif
+        mOutputFormat(output_format),
+        mDisplayBoost(std::min(max_display_boost, metadata->maxContentBoost)),
+        mIdwTable(kMapDimensionScaleFactor),
+        mGainLUT(metadata, mDisplayBoost),
+        // Assuming the sdr image is a decoded JPEG, we should always use Rec.601 YUV coefficients
+        mSdrYuvToRgbFn(p3YuvToRgb),
+        // We are assuming the SDR base image is always sRGB transfer.
+#if USE_SRGB_INVOETF_LUT
+        mSdrInvOetf(srgbInvOetfLUT),
+#else
+        mSdrInvOetf(srgbInvOetf),
+#endif
+        mHdrOetf(nullptr),
+        mKernels(getGainMapRowKernels()) {
+  switch (output_format) {
+    case ULTRAHDR_OUTPUT_HDR_HLG:
+#if USE_HLG_OETF_LUT
+      mHdrOetf = hlgOetfLUT;
+#else
+      mHdrOetf = hlgOetf;
+#endif
+      break;
+    case ULTRAHDR_OUTPUT_HDR_PQ:
+#if USE_PQ_OETF_LUT
+      mHdrOetf = pqOetfLUT;
+#else
+      mHdrOetf = pqOetf;
+#endif
+      break;
+    default:
+      break;
   }
-  return false;
 }
 
-void JobQueue::enqueueJob(size_t rowStart, size_t rowEnd) {
-  std::unique_lock<std::mutex> lock{mMutex};
-  mJobs.push_back(std::make_tuple(rowStart, rowEnd));
-  lock.unlock();
-  mCv.notify_one();
+size_t GainMapRowApplier::getBytesPerPixel() const {
+  return mOutputFormat == ULTRAHDR_OUTPUT_HDR_LINEAR ? sizeof(uint64_t) : sizeof(uint32_t);
+}
+
+void GainMapRowApplier::applyRow(jr_uncompressed_ptr yuv420_image_ptr, size_t y,
+                                 const uint8_t* map_row, const uint8_t* next_map_row,
+                                 int map_width, size_t image_y, float* rows, void* dest_row) {
+  size_t width = yuv420_image_ptr->width;
+  // Planar rows of the SDR and then HDR colors, and of the gain factors for them.
+  float* rgb[3] = {rows, rows + width, rows + width * 2};
+  float* gains = rows + width * 3;
+
+  getYuv420Row(yuv420_image_ptr, y, rgb[0], rgb[1], rgb[2]);
+  transformRow(mKernels, mSdrYuvToRgbFn, rgb[0], rgb[1], rgb[2], width);
+  transformRow(mKernels, mSdrInvOetf, rgb[0], rgb[1], rgb[2], width);
+
+  // TODO: determine map scaling factor based on actual map dims
+  sampleMapRow(map_row, next_map_row, map_width, kMapDimensionScaleFactor, image_y, width,
+               mIdwTable, gains);
+  for (size_t x = 0; x < width; ++x) {
+#if USE_APPLY_GAIN_LUT
+    gains[x] = mGainLUT.getGainFactor(gains[x]);
+#else
+    float logBoost = log2(mMetadata->minContentBoost) * (1.0f - gains[x])
+                   + log2(mMetadata->maxContentBoost) * gains[x];
+    gains[x] = exp2(logBoost * mDisplayBoost / mMetadata->maxContentBoost);
+#endif
+  }
+  mKernels.applyGain(gains, mDisplayBoost, rgb[0], rgb[1], rgb[2], width);
+
+  switch (mOutputFormat) {
+    case ULTRAHDR_OUTPUT_HDR_LINEAR: {
+      mKernels.toRgbaF16(rgb[0], rgb[1], rgb[2], reinterpret_cast<uint64_t*>(dest_row), width);
+      break;
+    }
+    case ULTRAHDR_OUTPUT_HDR_HLG:
+    case ULTRAHDR_OUTPUT_HDR_PQ: {
+      transformRow(mKernels, mHdrOetf, rgb[0], rgb[1], rgb[2], width);
+      mKernels.toRgba1010102(rgb[0], rgb[1], rgb[2], reinterpret_cast<uint32_t*>(dest_row),
+                             width);
+      break;
+    }
+    default: {
+    }
+      // Should be impossible to hit after input validation.
+  }
 }
 
-void JobQueue::markQueueForEnd() {
-  std::unique_lock<std::mutex> lock{mMutex};
-  mQueuedAllJobs = true;
-  lock.unlock();
-  mCv.notify_all();
+// Rows of a gain map being decompressed a strip at a time, from the first row that is still needed
+// to the last row decompressed so far.
+class GainMapRowWindow {
+public:
+  explicit GainMapRowWindow(JpegDecoderHelper* decoder)
+        : mDecoder(decoder), mWidth(decoder->getDecompressedImageWidth()) {}
+
+  // Returns row y of the map, decompressing strips up to it if needed, or nullptr if the row has
+  // been discarded or can not be decompressed. The row is valid until the next call to getRow()
+  // that decompresses more rows, or to discardRowsBefore().
+  const uint8_t* getRow(size_t y);
+
+  // Frees the rows above row y.
+  void discardRowsBefore(size_t y);
+
+private:
+  JpegDecoderHelper* mDecoder;
+  size_t mWidth;
+  size_t mFirstRow = 0;
+  size_t mNumRows = 0;
+  std::vector<uint8_t> mRows;
+};
+
+const uint8_t* GainMapRowWindow::getRow(size_t y) {
+  while (y >= mFirstRow + mNumRows) {
+    size_t firstRow, numRows;
+    if (!mDecoder->decompressRows(&firstRow, &numRows) || firstRow != mFirstRow + mNumRows) {
+      return nullptr;
+    }
+    const uint8_t* strip = static_cast<const uint8_t*>(mDecoder->getDecompressedImagePtr());
+    mRows.resize((mNumRows + numRows) * mWidth);
+    for (size_t i = 0; i < numRows; i++) {
+      memcpy(mRows.data() + (mNumRows + i) * mWidth, strip + i * mDecoder->getRowStride(),
+             mWidth);
+    }
+    mNumRows += numRows;
+  }
+  if (y < mFirstRow) {
+    return nullptr;
+  }
+  return mRows.data() + (y - mFirstRow) * mWidth;
 }
 
-void JobQueue::reset() {
-  std::unique_lock<std::mutex> lock{mMutex};
-  mJobs.clear();
-  mQueuedAllJobs = false;
+void GainMapRowWindow::discardRowsBefore(size_t y) {
+  size_t count = std::min(y - std::min(y, mFirstRow), mNumRows);
+  if (count == 0) {
+    return;
+  }
+  mRows.erase(mRows.begin(), mRows.begin() + count * mWidth);
+  mFirstRow += count;
+  mNumRows -= count;
 }
 
 status_t JpegR::generateGainMap(jr_uncompressed_ptr yuv420_image_ptr,
@@ -921,58 +1231,50 @@ status_t JpegR::generateGainMap(jr_uncompressed_ptr yuv420_image_ptr,
       return ERROR_JPEGR_INVALID_COLORGAMUT;
   }
 
-  std::mutex mutex;
-  const int threads = std::clamp(GetCPUCoreCount(), 1, 4);
-  size_t rowStep = threads == 1 ? image_height : kJobSzInRows;
-  JobQueue jobQueue;
-
-  std::function<void()> generateMap = [yuv420_image_ptr, p010_image_ptr, metadata, dest, hdrInvOetf,
-                                       hdrGamutConversionFn, luminanceFn, sdrYuvToRgbFn,
-                                       hdrYuvToRgbFn, hdr_white_nits, log2MinBoost, log2MaxBoost,
-                                       &jobQueue]() -> void {
-    size_t rowStart, rowEnd;
-    while (jobQueue.dequeueJob(rowStart, rowEnd)) {
-      for (size_t y = rowStart; y < rowEnd; ++y) {
-        for (size_t x = 0; x < dest->width; ++x) {
-          Color sdr_yuv_gamma = sampleYuv420(yuv420_image_ptr, kMapDimensionScaleFactor, x, y);
-          Color sdr_rgb_gamma = sdrYuvToRgbFn(sdr_yuv_gamma);
-          // We are assuming the SDR input is always sRGB transfer.
+  // We are assuming the SDR input is always sRGB transfer.
 #if USE_SRGB_INVOETF_LUT
-          Color sdr_rgb = srgbInvOetfLUT(sdr_rgb_gamma);
+  ColorTransformFn sdrInvOetf = srgbInvOetfLUT;
 #else
-          Color sdr_rgb = srgbInvOetf(sdr_rgb_gamma);
+  ColorTransformFn sdrInvOetf = srgbInvOetf;
 #endif
-          float sdr_y_nits = luminanceFn(sdr_rgb) * kSdrWhiteNits;
-
-          Color hdr_yuv_gamma = sampleP010(p010_image_ptr, kMapDimensionScaleFactor, x, y);
-          Color hdr_rgb_gamma = hdrYuvToRgbFn(hdr_yuv_gamma);
-          Color hdr_rgb = hdrInvOetf(hdr_rgb_gamma);
-          hdr_rgb = hdrGamutConversionFn(hdr_rgb);
-          float hdr_y_nits = luminanceFn(hdr_rgb) * hdr_white_nits;
-
-          size_t pixel_idx = x + y * dest->width;
-          reinterpret_cast<uint8_t*>(dest->data)[pixel_idx] =
-                  encodeGain(sdr_y_nits, hdr_y_nits, metadata, log2MinBoost, log2MaxBoost);
-        }
-      }
+  GainEncodeParams gainParams = {metadata->minContentBoost, metadata->maxContentBoost,
+                                 log2MinBoost, log2MaxBoost};
+  const GainMapRowKernels& kernels = getGainMapRowKernels();
+
+  auto generateMap = [yuv420_image_ptr, p010_image_ptr, dest, hdrInvOetf, sdrInvOetf,
+                      hdrGamutConversionFn, luminanceFn, sdrYuvToRgbFn, hdrYuvToRgbFn,
+                      hdr_white_nits, gainParams, &kernels](size_t rowStart, size_t rowEnd) {
+    const size_t width = dest->width;
+    // Planar rows of the sampled SDR and HDR colors, and of their luminances.
+    std::unique_ptr<float[]> rows = std::make_unique<float[]>(width * 8);
+    float* sdr[3] = {rows.get(), rows.get() + width, rows.get() + width * 2};
+    float* hdr[3] = {rows.get() + width * 3, rows.get() + width * 4, rows.get() + width * 5};
+    float* sdr_y_nits = rows.get() + width * 6;
+    float* hdr_y_nits = rows.get() + width * 7;
+
+    for (size_t y = rowStart; y < rowEnd; ++y) {
+      sampleYuv420Row(yuv420_image_ptr, kMapDimensionScaleFactor, y, width, sdr[0], sdr[1],
+                      sdr[2]);
+      transformRow(kernels, sdrYuvToRgbFn, sdr[0], sdr[1], sdr[2], width);
+      transformRow(kernels, sdrInvOetf, sdr[0], sdr[1], sdr[2], width);
+      luminanceRow(kernels, luminanceFn, kSdrWhiteNits, sdr[0], sdr[1], sdr[2], sdr_y_nits,
+                   width);
+
+      sampleP010Row(p010_image_ptr, kMapDimensionScaleFactor, y, width, hdr[0], hdr[1],
+                    hdr[2]);
+      transformRow(kernels, hdrYuvToRgbFn, hdr[0], hdr[1], hdr[2], width);
+      transformRow(kernels, hdrInvOetf, hdr[0], hdr[1], hdr[2], width);
+      transformRow(kernels, hdrGamutConversionFn, hdr[0], hdr[1], hdr[2], width);
+      luminanceRow(kernels, luminanceFn, hdr_white_nits, hdr[0], hdr[1], hdr[2], hdr_y_nits,
+                   width);
+
+      kernels.encodeGain(gainParams, sdr_y_nits, hdr_y_nits,
+                         reinterpret_cast<uint8_t*>(dest->data) + y * width, width);
     }
   };
 
   // generate map
-  std::vector<std::thread> workers;
-  for (int th = 0; th < threads - 1; th++) {
-    workers.push_back(std::thread(generateMap));
-  }
-
-  rowStep = (threads == 1 ? image_height : kJobSzInRows) / kMapDimensionScaleFactor;
-  for (size_t rowStart = 0; rowStart < map_height;) {
-    size_t rowEnd = std::min(rowStart + rowStep, map_height);
-    jobQueue.enqueueJob(rowStart, rowEnd);
-    rowStart = rowEnd;
-  }
-  jobQueue.markQueueForEnd();
-  generateMap();
-  std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
+  getThreadPool()->parallelFor(map_height, kJobSzInRows / kMapDimensionScaleFactor, generateMap);
 
   map_data.release();
   return NO_ERROR;
@@ -987,134 +1289,144 @@ status_t JpegR::applyGainMap(jr_uncompressed_ptr yuv420_image_ptr,
       yuv420_image_ptr->chroma_data == nullptr || gainmap_image_ptr->data == nullptr) {
     return ERROR_JPEGR_INVALID_NULL_PTR;
   }
-  if (metadata->version.compare(kJpegrVersion)) {
-    ALOGE("Unsupported metadata version: %s", metadata->version.c_str());
-    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  JPEGR_CHECK(checkGainMapMetadata(metadata));
+  JPEGR_CHECK(checkGainMapDimensions(yuv420_image_ptr->width, yuv420_image_ptr->height,
+                                     gainmap_image_ptr->width, gainmap_image_ptr->height));
+
+  dest->width = yuv420_image_ptr->width;
+  dest->height = yuv420_image_ptr->height;
+  GainMapRowApplier applier(metadata, output_format, max_display_boost);
+
+  auto applyRecMap = [yuv420_image_ptr, gainmap_image_ptr, dest, &applier](size_t rowStart,
+                                                                           size_t rowEnd) {
+    size_t width = yuv420_image_ptr->width;
+    std::unique_ptr<float[]> rows = std::make_unique<float[]>(width * 4);
+    const uint8_t* map_data = reinterpret_cast<uint8_t*>(gainmap_image_ptr->data);
+    int map_width = gainmap_image_ptr->width;
+    size_t dest_row_size = width * applier.getBytesPerPixel();
+
+    for (size_t y = rowStart; y < rowEnd; ++y) {
+      int map_y, next_map_y;
+      getMapRowsForImageRow(y, gainmap_image_ptr->height, &map_y, &next_map_y);
+      applier.applyRow(yuv420_image_ptr, y, map_data + map_y * map_width,
+                       map_data + next_map_y * map_width, map_width, y, rows.get(),
+                       reinterpret_cast<uint8_t*>(dest->data) + y * dest_row_size);
+    }
+  };
+
+  getThreadPool()->parallelFor(yuv420_image_ptr->height, kJobSzInRows, applyRecMap);
+  return NO_ERROR;
+}
+
+status_t JpegR::decodeJPEGRRows(jr_compressed_ptr jpegr_image_ptr,
+                                const JpegRRowCallback& on_rows, float max_display_boost,
+                                ultrahdr_output_format output_format,
+                                ultrahdr_metadata_ptr metadata) {
+  if (jpegr_image_ptr == nullptr || jpegr_image_ptr->data == nullptr) {
+    ALOGE("received nullptr for compressed jpegr image");
+    return ERROR_JPEGR_INVALID_NULL_PTR;
   }
-  if (metadata->gamma != 1.0f) {
-    ALOGE("Unsupported metadata gamma: %f", metadata->gamma);
-    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  if (!on_rows) {
+    ALOGE("received nullptr for row callback");
+    return ERROR_JPEGR_INVALID_NULL_PTR;
   }
-  if (metadata->offsetSdr != 0.0f || metadata->offsetHdr != 0.0f) {
-    ALOGE("Unsupported metadata offset sdr, hdr: %f, %f", metadata->offsetSdr, metadata->offsetHdr);
-    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  if (max_display_boost < 1.0f) {
+    ALOGE("received bad value for max_display_boost %f", max_display_boost);
+    return ERROR_JPEGR_INVALID_INPUT_TYPE;
   }
-  if (metadata->hdrCapacityMin != metadata->minContentBoost ||
-      metadata->hdrCapacityMax != metadata->maxContentBoost) {
-    ALOGE("Unsupported metadata hdr capacity min, max: %f, %f", metadata->hdrCapacityMin,
-          metadata->hdrCapacityMax);
-    return ERROR_JPEGR_UNSUPPORTED_METADATA;
+  if (output_format != ULTRAHDR_OUTPUT_HDR_LINEAR && output_format != ULTRAHDR_OUTPUT_HDR_HLG &&
+      output_format != ULTRAHDR_OUTPUT_HDR_PQ) {
+    ALOGE("received unsupported output format %d for decoding rows", output_format);
+    return ERROR_JPEGR_INVALID_INPUT_TYPE;
   }
 
-  // TODO: remove once map scaling factor is computed based on actual map dims
-  size_t image_width = yuv420_image_ptr->width;
-  size_t image_height = yuv420_image_ptr->height;
-  size_t map_width = image_width / kMapDimensionScaleFactor;
-  size_t map_height = image_height / kMapDimensionScaleFactor;
-  if (map_width != gainmap_image_ptr->width || map_height != gainmap_image_ptr->height) {
-    ALOGE("gain map dimensions and primary image dimensions are not to scale, computed gain map "
-          "resolution is %dx%d, received gain map resolution is %dx%d",
-          (int)map_width, (int)map_height, gainmap_image_ptr->width, gainmap_image_ptr->height);
-    return ERROR_JPEGR_INVALID_INPUT_TYPE;
+  jpegr_compressed_struct primary_jpeg_image, gainmap_jpeg_image;
+  JPEGR_CHECK(
+          extractPrimaryImageAndGainMap(jpegr_image_ptr, &primary_jpeg_image, &gainmap_jpeg_image));
+
+  JpegDecoderHelper jpeg_dec_obj_yuv420;
+  if (!jpeg_dec_obj_yuv420.startDecompressRows(primary_jpeg_image.data,
+                                               primary_jpeg_image.length)) {
+    return ERROR_JPEGR_DECODE_ERROR;
+  }
+  const size_t rows_per_strip = jpeg_dec_obj_yuv420.getRowsPerStrip();
+  const size_t row_stride = jpeg_dec_obj_yuv420.getRowStride();
+  if (row_stride * rows_per_strip * 3 / 2 > jpeg_dec_obj_yuv420.getDecompressedImageSize()) {
+    return ERROR_JPEGR_CALCULATION_ERROR;
   }
 
-  dest->width = yuv420_image_ptr->width;
-  dest->height = yuv420_image_ptr->height;
-  ShepardsIDW idwTable(kMapDimensionScaleFactor);
-  float display_boost = std::min(max_display_boost, metadata->maxContentBoost);
-  GainLUT gainLUT(metadata, display_boost);
-
-  JobQueue jobQueue;
-  std::function<void()> applyRecMap = [yuv420_image_ptr, gainmap_image_ptr, metadata, dest,
-                                       &jobQueue, &idwTable, output_format, &gainLUT,
-                                       display_boost]() -> void {
-    size_t width = yuv420_image_ptr->width;
-    size_t height = yuv420_image_ptr->height;
-
-    size_t rowStart, rowEnd;
-    while (jobQueue.dequeueJob(rowStart, rowEnd)) {
-      for (size_t y = rowStart; y < rowEnd; ++y) {
-        for (size_t x = 0; x < width; ++x) {
-          Color yuv_gamma_sdr = getYuv420Pixel(yuv420_image_ptr, x, y);
-          // Assuming the sdr image is a decoded JPEG, we should always use Rec.601 YUV coefficients
-          Color rgb_gamma_sdr = p3YuvToRgb(yuv_gamma_sdr);
-          // We are assuming the SDR base image is always sRGB transfer.
-#if USE_SRGB_INVOETF_LUT
-          Color rgb_sdr = srgbInvOetfLUT(rgb_gamma_sdr);
-#else
-          Color rgb_sdr = srgbInvOetf(rgb_gamma_sdr);
-#endif
-          float gain;
-          // TODO: determine map scaling factor based on actual map dims
-          size_t map_scale_factor = kMapDimensionScaleFactor;
-          // TODO: If map_scale_factor is guaranteed to be an integer, then remove the following.
-          // Currently map_scale_factor is of type size_t, but it could be changed to a float
-          // later.
-          if (map_scale_factor != floorf(map_scale_factor)) {
-            gain = sampleMap(gainmap_image_ptr, map_scale_factor, x, y);
-          } else {
-            gain = sampleMap(gainmap_image_ptr, map_scale_factor, x, y, idwTable);
-          }
+  JpegDecoderHelper jpeg_dec_obj_gm;
+  if (!jpeg_dec_obj_gm.startDecompressRows(gainmap_jpeg_image.data, gainmap_jpeg_image.length)) {
+    return ERROR_JPEGR_DECODE_ERROR;
+  }
 
-#if USE_APPLY_GAIN_LUT
-          Color rgb_hdr = applyGainLUT(rgb_sdr, gain, gainLUT);
-#else
-          Color rgb_hdr = applyGain(rgb_sdr, gain, metadata, display_boost);
-#endif
-          rgb_hdr = rgb_hdr / display_boost;
-          size_t pixel_idx = x + y * width;
-
-          switch (output_format) {
-            case ULTRAHDR_OUTPUT_HDR_LINEAR: {
-              uint64_t rgba_f16 = colorToRgbaF16(rgb_hdr);
-              reinterpret_cast<uint64_t*>(dest->data)[pixel_idx] = rgba_f16;
-              break;
-            }
-            case ULTRAHDR_OUTPUT_HDR_HLG: {
-#if USE_HLG_OETF_LUT
-              ColorTransformFn hdrOetf = hlgOetfLUT;
-#else
-              ColorTransformFn hdrOetf = hlgOetf;
-#endif
-              Color rgb_gamma_hdr = hdrOetf(rgb_hdr);
-              uint32_t rgba_1010102 = colorToRgba1010102(rgb_gamma_hdr);
-              reinterpret_cast<uint32_t*>(dest->data)[pixel_idx] = rgba_1010102;
-              break;
-            }
-            case ULTRAHDR_OUTPUT_HDR_PQ: {
-#if USE_PQ_OETF_LUT
-              ColorTransformFn hdrOetf = pqOetfLUT;
-#else
-              ColorTransformFn hdrOetf = pqOetf;
-#endif
-              Color rgb_gamma_hdr = hdrOetf(rgb_hdr);
-              uint32_t rgba_1010102 = colorToRgba1010102(rgb_gamma_hdr);
-              reinterpret_cast<uint32_t*>(dest->data)[pixel_idx] = rgba_1010102;
-              break;
-            }
-            default: {
-            }
-              // Should be impossible to hit after input validation.
-          }
-        }
-      }
-    }
-  };
+  ultrahdr_metadata_struct uhdr_metadata;
+  if (!getMetadataFromXMP(static_cast<uint8_t*>(jpeg_dec_obj_gm.getXMPPtr()),
+                          jpeg_dec_obj_gm.getXMPSize(), &uhdr_metadata)) {
+    return ERROR_JPEGR_INVALID_METADATA;
+  }
 
-  const int threads = std::clamp(GetCPUCoreCount(), 1, 4);
-  std::vector<std::thread> workers;
-  for (int th = 0; th < threads - 1; th++) {
-    workers.push_back(std::thread(applyRecMap));
+  if (metadata != nullptr) {
+    metadata->version = uhdr_metadata.version;
+    metadata->minContentBoost = uhdr_metadata.minContentBoost;
+    metadata->maxContentBoost = uhdr_metadata.maxContentBoost;
+    metadata->gamma = uhdr_metadata.gamma;
+    metadata->offsetSdr = uhdr_metadata.offsetSdr;
+    metadata->offsetHdr = uhdr_metadata.offsetHdr;
+    metadata->hdrCapacityMin = uhdr_metadata.hdrCapacityMin;
+    metadata->hdrCapacityMax = uhdr_metadata.hdrCapacityMax;
   }
-  const int rowStep = threads == 1 ? yuv420_image_ptr->height : kJobSzInRows;
-  for (int rowStart = 0; rowStart < yuv420_image_ptr->height;) {
-    int rowEnd = std::min(rowStart + rowStep, yuv420_image_ptr->height);
-    jobQueue.enqueueJob(rowStart, rowEnd);
-    rowStart = rowEnd;
+
+  JPEGR_CHECK(checkGainMapMetadata(&uhdr_metadata));
+  const size_t width = jpeg_dec_obj_yuv420.getDecompressedImageWidth();
+  const size_t height = jpeg_dec_obj_yuv420.getDecompressedImageHeight();
+  const int map_width = jpeg_dec_obj_gm.getDecompressedImageWidth();
+  const int map_height = jpeg_dec_obj_gm.getDecompressedImageHeight();
+  JPEGR_CHECK(checkGainMapDimensions(width, height, map_width, map_height));
+
+  // A strip of the primary image as decompressed, with padded rows.
+  jpegr_uncompressed_struct yuv420_strip;
+  yuv420_strip.data = jpeg_dec_obj_yuv420.getDecompressedImagePtr();
+  yuv420_strip.width = width;
+  yuv420_strip.height = rows_per_strip;
+  yuv420_strip.colorGamut = IccHelper::readIccColorGamut(jpeg_dec_obj_yuv420.getICCPtr(),
+                                                         jpeg_dec_obj_yuv420.getICCSize());
+  yuv420_strip.luma_stride = row_stride;
+  yuv420_strip.chroma_data = reinterpret_cast<uint8_t*>(yuv420_strip.data) +
+          yuv420_strip.luma_stride * yuv420_strip.height;
+  yuv420_strip.chroma_stride = row_stride >> 1;
+
+  GainMapRowApplier applier(&uhdr_metadata, output_format, max_display_boost);
+  GainMapRowWindow map_rows(&jpeg_dec_obj_gm);
+  const size_t dest_row_size = width * applier.getBytesPerPixel();
+  std::unique_ptr<uint8_t[]> dest_rows =
+          std::make_unique<uint8_t[]>(dest_row_size * rows_per_strip);
+  std::unique_ptr<float[]> rows = std::make_unique<float[]>(width * 4);
+
+  size_t first_row, num_rows;
+  size_t next_row = 0;
+  while (next_row < height) {
+    if (!jpeg_dec_obj_yuv420.decompressRows(&first_row, &num_rows) || first_row != next_row) {
+      return ERROR_JPEGR_DECODE_ERROR;
+    }
+
+    // Decompress the gain map up to the last row this strip needs, and free the rows above it.
+    int map_y, next_map_y, last_map_y;
+    getMapRowsForImageRow(first_row, map_height, &map_y, &next_map_y);
+    map_rows.discardRowsBefore(map_y);
+    getMapRowsForImageRow(first_row + num_rows - 1, map_height, &map_y, &last_map_y);
+    if (map_rows.getRow(last_map_y) == nullptr) {
+      return ERROR_JPEGR_DECODE_ERROR;
+    }
+
+    for (size_t i = 0; i < num_rows; ++i) {
+      getMapRowsForImageRow(first_row + i, map_height, &map_y, &next_map_y);
+      applier.applyRow(&yuv420_strip, i, map_rows.getRow(map_y), map_rows.getRow(next_map_y),
+                       map_width, first_row + i, rows.get(), dest_rows.get() + i * dest_row_size);
+    }
+    JPEGR_CHECK(on_rows(dest_rows.get(), first_row, num_rows, width));
+    next_row = first_row + num_rows;
   }
-  jobQueue.markQueueForEnd();
-  applyRecMap();
-  std::for_each(workers.begin(), workers.end(), [](std::thread& t) { t.join(); });
   return NO_ERROR;
 }
 
@@ -1390,36 +1702,41 @@ status_t JpegR::toneMap(jr_uncompressed_ptr src, jr_uncompressed_ptr dest) {
   }
   uint16_t* src_y_data = reinterpret_cast<uint16_t*>(src->data);
   uint8_t* dst_y_data = reinterpret_cast<uint8_t*>(dest->data);
-  for (size_t y = 0; y < src->height; ++y) {
-    uint16_t* src_y_row = src_y_data + y * src->luma_stride;
-    uint8_t* dst_y_row = dst_y_data + y * dest->luma_stride;
-    for (size_t x = 0; x < src->width; ++x) {
-      uint16_t y_uint = src_y_row[x] >> 6;
-      dst_y_row[x] = static_cast<uint8_t>((y_uint >> 2) & 0xff);
-    }
-    if (dest->width != dest->luma_stride) {
-      memset(dst_y_row + dest->width, 0, dest->luma_stride - dest->width);
+  getThreadPool()->parallelFor(src->height, kJobSzInRows, [&](size_t rowStart, size_t rowEnd) {
+    for (size_t y = rowStart; y < rowEnd; ++y) {
+      uint16_t* src_y_row = src_y_data + y * src->luma_stride;
+      uint8_t* dst_y_row = dst_y_data + y * dest->luma_stride;
+      for (size_t x = 0; x < src->width; ++x) {
+        uint16_t y_uint = src_y_row[x] >> 6;
+        dst_y_row[x] = static_cast<uint8_t>((y_uint >> 2) & 0xff);
+      }
+      if (dest->width != dest->luma_stride) {
+        memset(dst_y_row + dest->width, 0, dest->luma_stride - dest->width);
+      }
     }
-  }
+  });
   uint16_t* src_uv_data = reinterpret_cast<uint16_t*>(src->chroma_data);
   uint8_t* dst_u_data = reinterpret_cast<uint8_t*>(dest->chroma_data);
   size_t dst_v_offset = (dest->chroma_stride * dest->height / 2);
   uint8_t* dst_v_data = dst_u_data + dst_v_offset;
-  for (size_t y = 0; y < src->height / 2; ++y) {
-    uint16_t* src_uv_row = src_uv_data + y * src->chroma_stride;
-    uint8_t* dst_u_row = dst_u_data + y * dest->chroma_stride;
-    uint8_t* dst_v_row = dst_v_data + y * dest->chroma_stride;
-    for (size_t x = 0; x < src->width / 2; ++x) {
-      uint16_t u_uint = src_uv_row[x << 1] >> 6;
-      uint16_t v_uint = src_uv_row[(x << 1) + 1] >> 6;
-      dst_u_row[x] = static_cast<uint8_t>((u_uint >> 2) & 0xff);
-      dst_v_row[x] = static_cast<uint8_t>((v_uint >> 2) & 0xff);
-    }
-    if (dest->width / 2 != dest->chroma_stride) {
-      memset(dst_u_row + dest->width / 2, 0, dest->chroma_stride - dest->width / 2);
-      memset(dst_v_row + dest->width / 2, 0, dest->chroma_stride - dest->width / 2);
+  getThreadPool()->parallelFor(src->height / 2, kJobSzInRows / 2, [&](size_t rowStart,
+                                                                      size_t rowEnd) {
+    for (size_t y = rowStart; y < rowEnd; ++y) {
+      uint16_t* src_uv_row = src_uv_data + y * src->chroma_stride;
+      uint8_t* dst_u_row = dst_u_data + y * dest->chroma_stride;
+      uint8_t* dst_v_row = dst_v_data + y * dest->chroma_stride;
+      for (size_t x = 0; x < src->width / 2; ++x) {
+        uint16_t u_uint = src_uv_row[x << 1] >> 6;
+        uint16_t v_uint = src_uv_row[(x << 1) + 1] >> 6;
+        dst_u_row[x] = static_cast<uint8_t>((u_uint >> 2) & 0xff);
+        dst_v_row[x] = static_cast<uint8_t>((v_uint >> 2) & 0xff);
+      }
+      if (dest->width / 2 != dest->chroma_stride) {
+        memset(dst_u_row + dest->width / 2, 0, dest->chroma_stride - dest->width / 2);
+        memset(dst_v_row + dest->width / 2, 0, dest->chroma_stride - dest->width / 2);
+      }
     }
-  }
+  });
   dest->colorGamut = src->colorGamut;
   return NO_ERROR;
 }
@@ -1491,11 +1808,14 @@ status_t JpegR::convertYuv(jr_uncompressed_ptr image, ultrahdr_color_gamut src_e
     return ERROR_JPEGR_INVALID_COLORGAMUT;
   }
 
-  for (size_t y = 0; y < image->height / 2; ++y) {
-    for (size_t x = 0; x < image->width / 2; ++x) {
-      transformYuv420(image, x, y, conversionFn);
+  getThreadPool()->parallelFor(image->height / 2, kJobSzInRows / 2, [&](size_t rowStart,
+                                                                        size_t rowEnd) {
+    for (size_t y = rowStart; y < rowEnd; ++y) {
+      for (size_t x = 0; x < image->width / 2; ++x) {
+        transformYuv420(image, x, y, conversionFn);
+      }
     }
-  }
+  });
 
   return NO_ERROR;
 }
@@ -0,0 +1,308 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ultrahdr/gainmapmath.h>
+#include <ultrahdr/gainmaprowkernels.h>
+
+namespace android::ultrahdr {
+
+// Not a multiple of any vector width, so that every kernel also runs its scalar tail.
+constexpr size_t kRowWidth = 1021;
+
+class GainMapRowKernelsTest : public testing::TestWithParam<const GainMapRowKernels*> {
+public:
+  // Scalar and vector code may contract multiplies and adds differently.
+  float ComparisonEpsilon() { return 1e-5f; }
+
+  const GainMapRowKernels& Kernels() { return *GetParam(); }
+
+  std::vector<float> RandomRow(float min, float max) {
+    std::uniform_real_distribution<float> distribution(min, max);
+    std::vector<float> row(kRowWidth);
+    for (float& value : row) {
+      value = distribution(mGenerator);
+    }
+    return row;
+  }
+
+  template <typename T>
+  std::vector<T> RandomData(size_t size) {
+    std::uniform_int_distribution<uint32_t> distribution(0, std::numeric_limits<T>::max());
+    std::vector<T> data(size);
+    for (T& value : data) {
+      value = static_cast<T>(distribution(mGenerator));
+    }
+    return data;
+  }
+
+private:
+  std::mt19937 mGenerator{42};
+};
+
+TEST_P(GainMapRowKernelsTest, YuvToRgb) {
+  for (ColorTransformFn fn : {srgbYuvToRgb, p3YuvToRgb, bt2100YuvToRgb}) {
+    std::vector<float> y = RandomRow(0.0f, 1.0f);
+    std::vector<float> u = RandomRow(-0.5f, 0.5f);
+    std::vector<float> v = RandomRow(-0.5f, 0.5f);
+    std::vector<float> r = y, g = u, b = v;
+    Kernels().yuvToRgb(*getYuvToRgbCoeffs(fn), r.data(), g.data(), b.data(), kRowWidth);
+
+    for (size_t x = 0; x < kRowWidth; x++) {
+      Color expected = fn({{{ y[x], u[x], v[x] }}});
+      ASSERT_NEAR(r[x], expected.r, ComparisonEpsilon());
+      ASSERT_NEAR(g[x], expected.g, ComparisonEpsilon());
+      ASSERT_NEAR(b[x], expected.b, ComparisonEpsilon());
+      ASSERT_GE(std::min({r[x], g[x], b[x]}), 0.0f);
+      ASSERT_LE(std::max({r[x], g[x], b[x]}), 1.0f);
+    }
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, ApplyLUT) {
+  struct TransferFunctionLUT {
+    ColorTransformFn colorFn;
+    float (*fn)(float);
+  };
+  for (TransferFunctionLUT lut : std::initializer_list<TransferFunctionLUT>{
+               {srgbInvOetfLUT, srgbInvOetfLUT},
+               {hlgOetfLUT, hlgOetfLUT},
+               {hlgInvOetfLUT, hlgInvOetfLUT},
+               {pqOetfLUT, pqOetfLUT},
+               {pqInvOetfLUT, pqInvOetfLUT},
+       }) {
+    size_t numEntries = 0;
+    const float* table = getTransferFunctionLUT(lut.colorFn, &numEntries);
+    ASSERT_NE(table, nullptr);
+
+    std::vector<float> input = RandomRow(0.0f, 1.0f);
+    std::vector<float> values = input;
+    Kernels().applyLUT(table, numEntries, values.data(), kRowWidth);
+
+    for (size_t x = 0; x < kRowWidth; x++) {
+      ASSERT_EQ(values[x], lut.fn(input[x]));
+    }
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, ConvertGamut) {
+  for (ColorTransformFn fn : {bt709ToP3, bt709ToBt2100, p3ToBt709, p3ToBt2100, bt2100ToBt709,
+                              bt2100ToP3}) {
+    std::vector<float> r = RandomRow(0.0f, 1.0f);
+    std::vector<float> g = RandomRow(0.0f, 1.0f);
+    std::vector<float> b = RandomRow(0.0f, 1.0f);
+    std::vector<float> r_out = r, g_out = g, b_out = b;
+    Kernels().convertGamut(*getColorMatrix(fn), r_out.data(), g_out.data(), b_out.data(),
+                           kRowWidth);
+
+    for (size_t x = 0; x < kRowWidth; x++) {
+      Color expected = fn({{{ r[x], g[x], b[x] }}});
+      ASSERT_NEAR(r_out[x], expected.r, ComparisonEpsilon());
+      ASSERT_NEAR(g_out[x], expected.g, ComparisonEpsilon());
+      ASSERT_NEAR(b_out[x], expected.b, ComparisonEpsilon());
+    }
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, Luminance) {
+  for (ColorCalculationFn fn : {srgbLuminance, p3Luminance, bt2100Luminance}) {
+    std::vector<float> r = RandomRow(0.0f, 1.0f);
+    std::vector<float> g = RandomRow(0.0f, 1.0f);
+    std::vector<float> b = RandomRow(0.0f, 1.0f);
+    std::vector<float> nits(kRowWidth);
+    Kernels().luminance(*getLuminanceCoeffs(fn), kHlgMaxNits, r.data(), g.data(), b.data(),
+                        nits.data(), kRowWidth);
+
+    for (size_t x = 0; x < kRowWidth; x++) {
+      float expected = fn({{{ r[x], g[x], b[x] }}}) * kHlgMaxNits;
+      ASSERT_NEAR(nits[x], expected, ComparisonEpsilon() * kHlgMaxNits);
+    }
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, EncodeGain) {
+  ultrahdr_metadata_struct metadata;
+  metadata.minContentBoost = 1.0f;
+  metadata.maxContentBoost = kHlgMaxNits / kSdrWhiteNits;
+  float log2MinBoost = log2(metadata.minContentBoost);
+  float log2MaxBoost = log2(metadata.maxContentBoost);
+  GainEncodeParams params = {metadata.minContentBoost, metadata.maxContentBoost, log2MinBoost,
+                             log2MaxBoost};
+
+  std::vector<float> sdr = RandomRow(0.0f, kSdrWhiteNits);
+  std::vector<float> hdr = RandomRow(0.0f, kHlgMaxNits);
+  // Black SDR pixels get a gain of 1.
+  for (size_t x = 0; x < kRowWidth; x += 7) {
+    sdr[x] = 0.0f;
+  }
+  std::vector<uint8_t> gains(kRowWidth);
+  Kernels().encodeGain(params, sdr.data(), hdr.data(), gains.data(), kRowWidth);
+
+  for (size_t x = 0; x < kRowWidth; x++) {
+    int expected = encodeGain(sdr[x], hdr[x], &metadata, params.log2MinContentBoost,
+                              params.log2MaxContentBoost);
+    ASSERT_EQ(gains[x], expected);
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, ApplyGain) {
+  ultrahdr_metadata_struct metadata;
+  metadata.minContentBoost = 1.0f;
+  metadata.maxContentBoost = 8.0f;
+  const float displayBoost = 4.0f;
+  GainLUT gainLUT(&metadata, displayBoost);
+
+  std::vector<float> r = RandomRow(0.0f, 1.0f);
+  std::vector<float> g = RandomRow(0.0f, 1.0f);
+  std::vector<float> b = RandomRow(0.0f, 1.0f);
+  std::vector<float> gains = RandomRow(0.0f, 1.0f);
+  std::vector<float> gainFactors(kRowWidth);
+  for (size_t x = 0; x < kRowWidth; x++) {
+    gainFactors[x] = gainLUT.getGainFactor(gains[x]);
+  }
+  std::vector<float> r_out = r, g_out = g, b_out = b;
+  Kernels().applyGain(gainFactors.data(), displayBoost, r_out.data(), g_out.data(), b_out.data(),
+                      kRowWidth);
+
+  for (size_t x = 0; x < kRowWidth; x++) {
+    Color expected = applyGainLUT({{{ r[x], g[x], b[x] }}}, gains[x], gainLUT) / displayBoost;
+    ASSERT_NEAR(r_out[x], expected.r, ComparisonEpsilon());
+    ASSERT_NEAR(g_out[x], expected.g, ComparisonEpsilon());
+    ASSERT_NEAR(b_out[x], expected.b, ComparisonEpsilon());
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, ToRgba1010102) {
+  std::vector<float> r = RandomRow(0.0f, 1.0f);
+  std::vector<float> g = RandomRow(0.0f, 1.0f);
+  std::vector<float> b = RandomRow(0.0f, 1.0f);
+  r[0] = g[1] = b[2] = 0.0f;
+  r[3] = g[4] = b[5] = 1.0f;
+  std::vector<uint32_t> rgba(kRowWidth);
+  Kernels().toRgba1010102(r.data(), g.data(), b.data(), rgba.data(), kRowWidth);
+
+  for (size_t x = 0; x < kRowWidth; x++) {
+    ASSERT_EQ(rgba[x], colorToRgba1010102({{{ r[x], g[x], b[x] }}}));
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, ToRgbaF16) {
+  // Cover denormal, normal and saturated halfs, and negative values.
+  std::vector<float> r = RandomRow(-1e-6f, 1e-4f);
+  std::vector<float> g = RandomRow(-16.0f, 16.0f);
+  std::vector<float> b = RandomRow(0.0f, 1e5f);
+  std::vector<uint64_t> rgba(kRowWidth);
+  Kernels().toRgbaF16(r.data(), g.data(), b.data(), rgba.data(), kRowWidth);
+
+  for (size_t x = 0; x < kRowWidth; x++) {
+    ASSERT_EQ(rgba[x], colorToRgbaF16({{{ r[x], g[x], b[x] }}}));
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, TransformRowFallsBackToFn) {
+  std::vector<float> r = RandomRow(0.0f, 1.0f);
+  std::vector<float> g = RandomRow(0.0f, 1.0f);
+  std::vector<float> b = RandomRow(0.0f, 1.0f);
+  std::vector<float> r_out = r, g_out = g, b_out = b;
+  transformRow(Kernels(), hlgInvOetf, r_out.data(), g_out.data(), b_out.data(), kRowWidth);
+
+  for (size_t x = 0; x < kRowWidth; x++) {
+    Color expected = hlgInvOetf({{{ r[x], g[x], b[x] }}});
+    ASSERT_EQ(r_out[x], expected.r);
+    ASSERT_EQ(g_out[x], expected.g);
+    ASSERT_EQ(b_out[x], expected.b);
+  }
+
+  transformRow(Kernels(), identityConversion, r_out.data(), g_out.data(), b_out.data(),
+               kRowWidth);
+  for (size_t x = 0; x < kRowWidth; x++) {
+    Color expected = hlgInvOetf({{{ r[x], g[x], b[x] }}});
+    ASSERT_EQ(r_out[x], expected.r);
+  }
+}
+
+TEST_P(GainMapRowKernelsTest, SampleRows) {
+  const size_t kMapScaleFactor = 4;
+  const size_t kMapWidth = 13, kMapHeight = 5;
+  const size_t width = kMapWidth * kMapScaleFactor, height = kMapHeight * kMapScaleFactor;
+
+  std::vector<uint8_t> yuv420 = RandomData<uint8_t>(width * height * 3 / 2);
+  jpegr_uncompressed_struct yuv420Image = {yuv420.data(), static_cast<int>(width),
+                                           static_cast<int>(height), ULTRAHDR_COLORGAMUT_BT709,
+                                           yuv420.data() + width * height, static_cast<int>(width),
+                                           static_cast<int>(width / 2)};
+  std::vector<uint16_t> p010 = RandomData<uint16_t>(width * height * 3 / 2);
+  jpegr_uncompressed_struct p010Image = {p010.data(), static_cast<int>(width),
+                                         static_cast<int>(height), ULTRAHDR_COLORGAMUT_BT2100,
+                                         p010.data() + width * height, static_cast<int>(width),
+                                         static_cast<int>(width)};
+  std::vector<uint8_t> mapData = RandomData<uint8_t>(kMapWidth * kMapHeight);
+  jpegr_uncompressed_struct map = {mapData.data(), static_cast<int>(kMapWidth),
+                                   static_cast<int>(kMapHeight), ULTRAHDR_COLORGAMUT_UNSPECIFIED};
+  ShepardsIDW idwTable(kMapScaleFactor);
+
+  std::vector<float> y(width), u(width), v(width);
+  for (size_t map_y = 0; map_y < kMapHeight; map_y++) {
+    sampleYuv420Row(&yuv420Image, kMapScaleFactor, map_y, kMapWidth, y.data(), u.data(),
+                    v.data());
+    for (size_t x = 0; x < kMapWidth; x++) {
+      Color expected = sampleYuv420(&yuv420Image, kMapScaleFactor, x, map_y);
+      ASSERT_FLOAT_EQ(y[x], expected.y);
+      ASSERT_FLOAT_EQ(u[x], expected.u);
+      ASSERT_FLOAT_EQ(v[x], expected.v);
+    }
+
+    sampleP010Row(&p010Image, kMapScaleFactor, map_y, kMapWidth, y.data(), u.data(), v.data());
+    for (size_t x = 0; x < kMapWidth; x++) {
+      Color expected = sampleP010(&p010Image, kMapScaleFactor, x, map_y);
+      ASSERT_FLOAT_EQ(y[x], expected.y);
+      ASSERT_FLOAT_EQ(u[x], expected.u);
+      ASSERT_FLOAT_EQ(v[x], expected.v);
+    }
+  }
+
+  std::vector<float> gains(width);
+  for (size_t row = 0; row < height; row++) {
+    sampleMapRow(&map, kMapScaleFactor, row, width, idwTable, gains.data());
+    for (size_t x = 0; x < width; x++) {
+      ASSERT_FLOAT_EQ(gains[x], sampleMap(&map, kMapScaleFactor, x, row, idwTable));
+    }
+
+    getYuv420Row(&yuv420Image, row, y.data(), u.data(), v.data());
+    for (size_t x = 0; x < width; x++) {
+      Color expected = getYuv420Pixel(&yuv420Image, x, row);
+      ASSERT_EQ(y[x], expected.y);
+      ASSERT_EQ(u[x], expected.u);
+      ASSERT_EQ(v[x], expected.v);
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+        GainMapRowKernels, GainMapRowKernelsTest,
+        testing::Values(&getScalarGainMapRowKernels(), &getGainMapRowKernels()),
+        [](const testing::TestParamInfo<const GainMapRowKernels*>& info) {
+          return std::string(info.param->name) + "_" + std::to_string(info.index);
+        });
+
+} // namespace android::ultrahdr
@@ -123,6 +123,77 @@ TEST_F(JpegDecoderHelperTest, decodeGreyImage) {
     ASSERT_GT(decoder.getDecompressedImageSize(), static_cast<uint32_t>(0));
 }
 
+// Decompresses the image a strip of rows at a time, and checks that the rows match the whole
+// decompressed image.
+static void expectRowsMatchImage(const JpegDecoderHelperTest::Image& image, bool isSingleChannel) {
+    JpegDecoderHelper imageDecoder;
+    ASSERT_TRUE(imageDecoder.decompressImage(image.buffer.get(), image.size));
+    const size_t width = imageDecoder.getDecompressedImageWidth();
+    const size_t height = imageDecoder.getDecompressedImageHeight();
+    const uint8_t* y_plane = static_cast<const uint8_t*>(imageDecoder.getDecompressedImagePtr());
+    const uint8_t* u_plane = y_plane + width * height;
+    const uint8_t* v_plane = u_plane + width * height / 4;
+
+    JpegDecoderHelper rowDecoder;
+    ASSERT_TRUE(rowDecoder.startDecompressRows(image.buffer.get(), image.size));
+    EXPECT_EQ(rowDecoder.getDecompressedImageWidth(), width);
+    EXPECT_EQ(rowDecoder.getDecompressedImageHeight(), height);
+    const size_t rowsPerStrip = rowDecoder.getRowsPerStrip();
+    const size_t stride = rowDecoder.getRowStride();
+    EXPECT_EQ(rowsPerStrip, isSingleChannel ? 8 : 16);
+    EXPECT_GE(stride, width);
+
+    size_t firstRow = 0, numRows = 0, nextRow = 0;
+    while (rowDecoder.decompressRows(&firstRow, &numRows)) {
+        ASSERT_EQ(firstRow, nextRow);
+        ASSERT_GT(numRows, 0);
+        ASSERT_LE(firstRow + numRows, height);
+        const uint8_t* strip = static_cast<const uint8_t*>(rowDecoder.getDecompressedImagePtr());
+        for (size_t i = 0; i < numRows; i++) {
+            ASSERT_EQ(memcmp(strip + i * stride, y_plane + (firstRow + i) * width, width), 0)
+                    << "Y row " << firstRow + i;
+        }
+        if (!isSingleChannel) {
+            const uint8_t* strip_u = strip + stride * rowsPerStrip;
+            const uint8_t* strip_v = strip_u + stride * rowsPerStrip / 4;
+            for (size_t i = 0; i < numRows / 2; i++) {
+                const size_t row = firstRow / 2 + i;
+                const size_t chromaWidth = width / 2;
+                ASSERT_EQ(memcmp(strip_u + i * (stride / 2), u_plane + row * chromaWidth,
+                                 chromaWidth), 0) << "U row " << row;
+                ASSERT_EQ(memcmp(strip_v + i * (stride / 2), v_plane + row * chromaWidth,
+                                 chromaWidth), 0) << "V row " << row;
+            }
+        }
+        nextRow = firstRow + numRows;
+    }
+    EXPECT_EQ(nextRow, height);
+}
+
+TEST_F(JpegDecoderHelperTest, decodeYuvImageRows) {
+    expectRowsMatchImage(mYuvImage, /*isSingleChannel=*/false);
+}
+
+TEST_F(JpegDecoderHelperTest, decodeYuvIccImageRows) {
+    expectRowsMatchImage(mYuvIccImage, /*isSingleChannel=*/false);
+
+    JpegDecoderHelper decoder;
+    ASSERT_TRUE(decoder.startDecompressRows(mYuvIccImage.buffer.get(), mYuvIccImage.size));
+    EXPECT_EQ(IccHelper::readIccColorGamut(decoder.getICCPtr(), decoder.getICCSize()),
+              ULTRAHDR_COLORGAMUT_BT709);
+}
+
+TEST_F(JpegDecoderHelperTest, decodeGreyImageRows) {
+    expectRowsMatchImage(mGreyImage, /*isSingleChannel=*/true);
+}
+
+TEST_F(JpegDecoderHelperTest, decodeRowsInvalidImage) {
+    JpegDecoderHelper decoder;
+    EXPECT_FALSE(decoder.startDecompressRows(nullptr, 0));
+    size_t firstRow = 0, numRows = 0;
+    EXPECT_FALSE(decoder.decompressRows(&firstRow, &numRows));
+}
+
 TEST_F(JpegDecoderHelperTest, getCompressedImageParameters) {
     size_t width = 0, height = 0;
     std::vector<uint8_t> icc, exif;
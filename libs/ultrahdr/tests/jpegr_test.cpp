@@ -14,9 +14,13 @@
  * limitations under the License.
  */
 
+#include <inttypes.h>
 #include <sys/time.h>
+#include <array>
 #include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <ultrahdr/gainmapmath.h>
 #include <ultrahdr/jpegr.h>
@@ -1342,6 +1346,43 @@ TEST(JpegRTest, DecodeAPIWithInvalidArgs) {
           << "fail, API allows invalid output format";
 }
 
+/* Test Decode Rows API invalid arguments */
+TEST(JpegRTest, DecodeRowsAPIWithInvalidArgs) {
+  JpegR uHdrLib;
+
+  UhdrCompressedStructWrapper jpgImg(16, 16);
+  JpegRRowCallback onRows = [](const void*, size_t, size_t, size_t) -> status_t { return OK; };
+
+  // test jpegr image
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(nullptr, onRows), OK)
+          << "fail, API allows nullptr for jpegr img";
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), onRows), OK)
+          << "fail, API allows nullptr for jpegr img";
+  ASSERT_TRUE(jpgImg.allocateMemory());
+
+  // test callback
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), nullptr), OK)
+          << "fail, API allows nullptr for callback";
+
+  // test max display boost
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), onRows, 0.5), OK)
+          << "fail, API allows invalid max display boost";
+
+  // test output format
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), onRows, FLT_MAX,
+                                    ULTRAHDR_OUTPUT_SDR),
+            OK)
+          << "fail, API allows sdr output format";
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), onRows, FLT_MAX,
+                                    static_cast<ultrahdr_output_format>(-1)),
+            OK)
+          << "fail, API allows invalid output format";
+  ASSERT_NE(uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), onRows, FLT_MAX,
+                                    static_cast<ultrahdr_output_format>(ULTRAHDR_OUTPUT_MAX + 1)),
+            OK)
+          << "fail, API allows invalid output format";
+}
+
 TEST(JpegRTest, writeXmpThenRead) {
   ultrahdr_metadata_struct metadata_expected;
   metadata_expected.version = "1.0";
@@ -1916,6 +1957,77 @@ INSTANTIATE_TEST_SUITE_P(
                            ::testing::Values(ULTRAHDR_COLORGAMUT_BT709, ULTRAHDR_COLORGAMUT_P3,
                                              ULTRAHDR_COLORGAMUT_BT2100)));
 
+class JpegRDecodeRowsTest : public ::testing::TestWithParam<ultrahdr_output_format> {};
+
+/* Test that decoding rows gives the same image as decoding the whole image */
+TEST_P(JpegRDecodeRowsTest, DecodeRowsMatchesDecode) {
+  const ultrahdr_output_format outputFormat = GetParam();
+  const size_t bytesPerPixel = outputFormat == ULTRAHDR_OUTPUT_HDR_LINEAR ? 8 : 4;
+  UhdrUnCompressedStructWrapper rawImgP010(kImageWidth, kImageHeight, YCbCr_p010);
+  ASSERT_TRUE(rawImgP010.setImageColorGamut(ULTRAHDR_COLORGAMUT_BT2100));
+  ASSERT_TRUE(rawImgP010.allocateMemory());
+  ASSERT_TRUE(rawImgP010.loadRawResource(kYCbCrP010FileName));
+  UhdrUnCompressedStructWrapper rawImg420(kImageWidth, kImageHeight, YCbCr_420);
+  ASSERT_TRUE(rawImg420.setImageColorGamut(ULTRAHDR_COLORGAMUT_P3));
+  ASSERT_TRUE(rawImg420.allocateMemory());
+  ASSERT_TRUE(rawImg420.loadRawResource(kYCbCr420FileName));
+  UhdrCompressedStructWrapper jpgImg(kImageWidth, kImageHeight);
+  ASSERT_TRUE(jpgImg.allocateMemory());
+  JpegR uHdrLib;
+  ASSERT_EQ(uHdrLib.encodeJPEGR(rawImgP010.getImageHandle(), rawImg420.getImageHandle(),
+                                ultrahdr_transfer_function::ULTRAHDR_TF_HLG,
+                                jpgImg.getImageHandle(), kQuality, nullptr),
+            OK);
+
+  const size_t outSize = kImageWidth * kImageHeight * bytesPerPixel;
+  std::unique_ptr<uint8_t[]> expected = std::make_unique<uint8_t[]>(outSize);
+  jpegr_uncompressed_struct destImage{};
+  destImage.data = expected.get();
+  ultrahdr_metadata_struct expectedMetadata;
+  ASSERT_EQ(OK,
+            uHdrLib.decodeJPEGR(jpgImg.getImageHandle(), &destImage, FLT_MAX, nullptr,
+                                outputFormat, nullptr, &expectedMetadata));
+
+  std::unique_ptr<uint8_t[]> actual = std::make_unique<uint8_t[]>(outSize);
+  size_t nextRow = 0;
+  JpegRRowCallback onRows = [&](const void* rows, size_t firstRow, size_t numRows,
+                                size_t width) -> status_t {
+    EXPECT_EQ(width, kImageWidth);
+    EXPECT_EQ(firstRow, nextRow);
+    EXPECT_LE(firstRow + numRows, kImageHeight);
+    if (width != kImageWidth || firstRow != nextRow || firstRow + numRows > kImageHeight) {
+      return ERROR_JPEGR_CALCULATION_ERROR;
+    }
+    memcpy(actual.get() + firstRow * width * bytesPerPixel, rows,
+           numRows * width * bytesPerPixel);
+    nextRow = firstRow + numRows;
+    return OK;
+  };
+  ultrahdr_metadata_struct metadata;
+  ASSERT_EQ(OK,
+            uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), onRows, FLT_MAX, outputFormat,
+                                    &metadata));
+  ASSERT_EQ(nextRow, kImageHeight);
+  EXPECT_EQ(metadata.version, expectedMetadata.version);
+  EXPECT_EQ(metadata.minContentBoost, expectedMetadata.minContentBoost);
+  EXPECT_EQ(metadata.maxContentBoost, expectedMetadata.maxContentBoost);
+  EXPECT_EQ(0, memcmp(actual.get(), expected.get(), outSize));
+
+  // An error returned by the callback stops decoding.
+  size_t calls = 0;
+  JpegRRowCallback failRows = [&calls](const void*, size_t, size_t, size_t) -> status_t {
+    calls++;
+    return ERROR_JPEGR_BUFFER_TOO_SMALL;
+  };
+  EXPECT_EQ(ERROR_JPEGR_BUFFER_TOO_SMALL,
+            uHdrLib.decodeJPEGRRows(jpgImg.getImageHandle(), failRows, FLT_MAX, outputFormat));
+  EXPECT_EQ(calls, 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(JpegRDecodeRowsParameterizedTests, JpegRDecodeRowsTest,
+                         ::testing::Values(ULTRAHDR_OUTPUT_HDR_LINEAR, ULTRAHDR_OUTPUT_HDR_HLG,
+                                           ULTRAHDR_OUTPUT_HDR_PQ));
+
 // ============================================================================
 // Profiling
 // ============================================================================
@@ -2032,4 +2144,306 @@ TEST(JpegRTest, ProfileGainMapFuncs) {
           benchmark.BenchmarkApplyGainMap(rawImg420.getImageHandle(), &map, &metadata, &dest));
 }
 
+// Resets the peak resident set size of the process to its current size. Returns false if the
+// kernel does not support it.
+static bool resetPeakRss() {
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  clearRefs << "5";
+  clearRefs.close();
+  return !clearRefs.fail();
+}
+
+// Returns the peak resident set size of the process in KB, or -1 if it is unknown.
+static int64_t getPeakRssKb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return std::stoll(line.substr(6));
+    }
+  }
+  return -1;
+}
+
+TEST(JpegRTest, ProfileDecodeRows) {
+  UhdrUnCompressedStructWrapper rawImgP010(kImageWidth, kImageHeight, YCbCr_p010);
+  ASSERT_TRUE(rawImgP010.setImageColorGamut(ULTRAHDR_COLORGAMUT_BT2100));
+  ASSERT_TRUE(rawImgP010.allocateMemory());
+  ASSERT_TRUE(rawImgP010.loadRawResource(kYCbCrP010FileName));
+  UhdrCompressedStructWrapper jpgImg(kImageWidth, kImageHeight);
+  ASSERT_TRUE(jpgImg.allocateMemory());
+  JpegR uHdrLib;
+  ASSERT_EQ(uHdrLib.encodeJPEGR(rawImgP010.getImageHandle(),
+                                ultrahdr_transfer_function::ULTRAHDR_TF_HLG,
+                                jpgImg.getImageHandle(), kQuality, nullptr),
+            OK);
+  const bool canResetPeakRss = resetPeakRss();
+
+  // Decode the whole image, and then copy it out a row at a time like a caller of the rows API
+  // would, so that the two paths end at the same point.
+  const size_t outSize = kImageWidth * kImageHeight * 4;
+  std::vector<uint8_t> sink(kImageWidth * 4);
+  int64_t baseRssKb = getPeakRssKb();
+  Profiler profileDecode;
+  profileDecode.timerStart();
+  {
+    std::unique_ptr<uint8_t[]> data = std::make_unique<uint8_t[]>(outSize);
+    jpegr_uncompressed_struct destImage{};
+    destImage.data = data.get();
+    ASSERT_EQ(OK,
+              uHdrLib.decodeJPEGR(jpgImg.getImageHandle(), &destImage, FLT_MAX, nullptr,
+                                  ULTRAHDR_OUTPUT_HDR_HLG));
+    for (int y = 0; y < kImageHeight; y++) {
+      memcpy(sink.data(), data.get() + y * kImageWidth * 4, kImageWidth * 4);
+    }
+  }
+  profileDecode.timerStop();
+  int64_t decodePeakRssKb = getPeakRssKb() - baseRssKb;
+
+  if (canResetPeakRss) resetPeakRss();
+  baseRssKb = getPeakRssKb();
+  Profiler profileFirstRow;
+  Profiler profileDecodeRows;
+  bool firstRows = true;
+  profileFirstRow.timerStart();
+  profileDecodeRows.timerStart();
+  ASSERT_EQ(OK,
+            uHdrLib.decodeJPEGRRows(
+                    jpgImg.getImageHandle(),
+                    [&](const void* rows, size_t, size_t numRows, size_t width) -> status_t {
+                      if (firstRows) {
+                        profileFirstRow.timerStop();
+                        firstRows = false;
+                      }
+                      for (size_t y = 0; y < numRows; y++) {
+                        memcpy(sink.data(), static_cast<const uint8_t*>(rows) + y * width * 4,
+                               width * 4);
+                      }
+                      return OK;
+                    },
+                    FLT_MAX, ULTRAHDR_OUTPUT_HDR_HLG));
+  profileDecodeRows.timerStop();
+  int64_t decodeRowsPeakRssKb = getPeakRssKb() - baseRssKb;
+
+  if (!canResetPeakRss) {
+    ALOGE("Peak rss can not be reset, so peak rss growth is only an upper bound");
+  }
+  // Without decoding rows, the first row is only available once the whole image is decoded.
+  ALOGE("Decode:- Res = %i x %i, time to first row = %f ms, time = %f ms, peak rss growth = "
+        "%" PRId64 " KB",
+        kImageWidth, kImageHeight, profileDecode.elapsedTime() / 1000.f,
+        profileDecode.elapsedTime() / 1000.f, decodePeakRssKb);
+  ALOGE("Decode Rows:- Res = %i x %i, time to first row = %f ms, time = %f ms, peak rss growth = "
+        "%" PRId64 " KB",
+        kImageWidth, kImageHeight, profileFirstRow.elapsedTime() / 1000.f,
+        profileDecodeRows.elapsedTime() / 1000.f, decodeRowsPeakRssKb);
+}
+
+// Fills width x height P010 and YUV420 images by repeating the test images, to test resolutions
+// other than the one of the test images.
+static void tileTestImages(int width, int height, std::vector<uint16_t>* p010,
+                           std::vector<uint8_t>* yuv420) {
+  const int p010Size = kImageWidth * kImageHeight * 3;
+  const int yuv420Size = kImageWidth * kImageHeight * 3 / 2;
+  std::vector<uint16_t> srcP010(p010Size / 2);
+  std::vector<uint8_t> srcYuv420(yuv420Size);
+  void* srcP010Data = srcP010.data();
+  void* srcYuv420Data = srcYuv420.data();
+  int length;
+  ASSERT_TRUE(readFile(kYCbCrP010FileName, srcP010Data, p010Size, length));
+  ASSERT_TRUE(readFile(kYCbCr420FileName, srcYuv420Data, yuv420Size, length));
+
+  p010->resize(width * height * 3 / 2);
+  yuv420->resize(width * height * 3 / 2);
+  const uint16_t* srcUv = srcP010.data() + kImageWidth * kImageHeight;
+  uint16_t* dstUv = p010->data() + width * height;
+  const uint8_t* srcU = srcYuv420.data() + kImageWidth * kImageHeight;
+  const uint8_t* srcV = srcU + kImageWidth * kImageHeight / 4;
+  uint8_t* dstU = yuv420->data() + width * height;
+  uint8_t* dstV = dstU + width * height / 4;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const int srcIdx = (y % kImageHeight) * kImageWidth + x % kImageWidth;
+      (*p010)[y * width + x] = srcP010[srcIdx];
+      (*yuv420)[y * width + x] = srcYuv420[srcIdx];
+    }
+  }
+  for (int y = 0; y < height / 2; y++) {
+    for (int x = 0; x < width / 2; x++) {
+      const int srcY = y % (kImageHeight / 2);
+      const int srcX = x % (kImageWidth / 2);
+      dstUv[y * width + x * 2] = srcUv[srcY * kImageWidth + srcX * 2];
+      dstUv[y * width + x * 2 + 1] = srcUv[srcY * kImageWidth + srcX * 2 + 1];
+      dstU[y * (width / 2) + x] = srcU[srcY * (kImageWidth / 2) + srcX];
+      dstV[y * (width / 2) + x] = srcV[srcY * (kImageWidth / 2) + srcX];
+    }
+  }
+}
+
+/* Test that the encoded image does not depend on how many threads encode it */
+TEST(JpegRTest, EncodeWithWorkerThreadCounts) {
+  UhdrUnCompressedStructWrapper rawImgP010(kImageWidth, kImageHeight, YCbCr_p010);
+  ASSERT_TRUE(rawImgP010.setImageColorGamut(ULTRAHDR_COLORGAMUT_BT2100));
+  ASSERT_TRUE(rawImgP010.allocateMemory());
+  ASSERT_TRUE(rawImgP010.loadRawResource(kYCbCrP010FileName));
+  UhdrUnCompressedStructWrapper rawImg420(kImageWidth, kImageHeight, YCbCr_420);
+  ASSERT_TRUE(rawImg420.setImageColorGamut(ULTRAHDR_COLORGAMUT_BT709));
+  ASSERT_TRUE(rawImg420.allocateMemory());
+  ASSERT_TRUE(rawImg420.loadRawResource(kYCbCr420FileName));
+
+  JpegR uHdrLib;
+  ASSERT_NE(uHdrLib.getEncodeTiming(nullptr), OK) << "fail, API allows nullptr timing";
+
+  std::vector<uint8_t> refApi0, refApi1;
+  for (size_t workers : {0, 1, 3, 8}) {
+    SCOPED_TRACE(workers);
+    uHdrLib.setWorkerThreadCount(workers);
+
+    UhdrCompressedStructWrapper jpgImg(kImageWidth, kImageHeight);
+    ASSERT_TRUE(jpgImg.allocateMemory());
+    ASSERT_EQ(uHdrLib.encodeJPEGR(rawImgP010.getImageHandle(), ULTRAHDR_TF_HLG,
+                                  jpgImg.getImageHandle(), kQuality, nullptr),
+              OK);
+    jpegr_encode_timing_struct timing;
+    ASSERT_EQ(uHdrLib.getEncodeTiming(&timing), OK);
+    EXPECT_GT(timing.totalUs, 0);
+    EXPECT_GE(timing.totalUs, timing.toneMapUs + timing.generateGainMapUs);
+    auto jpg = jpgImg.getImageHandle();
+    const uint8_t* data = static_cast<const uint8_t*>(jpg->data);
+    if (refApi0.empty()) {
+      refApi0.assign(data, data + jpg->length);
+    } else {
+      ASSERT_EQ(refApi0.size(), jpg->length);
+      ASSERT_EQ(0, memcmp(refApi0.data(), data, jpg->length));
+    }
+
+    UhdrCompressedStructWrapper jpgImg2(kImageWidth, kImageHeight);
+    ASSERT_TRUE(jpgImg2.allocateMemory());
+    ASSERT_EQ(uHdrLib.encodeJPEGR(rawImgP010.getImageHandle(), rawImg420.getImageHandle(),
+                                  ULTRAHDR_TF_HLG, jpgImg2.getImageHandle(), kQuality, nullptr),
+              OK);
+    ASSERT_EQ(uHdrLib.getEncodeTiming(&timing), OK);
+    EXPECT_EQ(timing.toneMapUs, 0);
+    EXPECT_GT(timing.totalUs, 0);
+    jpg = jpgImg2.getImageHandle();
+    data = static_cast<const uint8_t*>(jpg->data);
+    if (refApi1.empty()) {
+      refApi1.assign(data, data + jpg->length);
+    } else {
+      ASSERT_EQ(refApi1.size(), jpg->length);
+      ASSERT_EQ(0, memcmp(refApi1.data(), data, jpg->length));
+    }
+  }
+}
+
+/* Test that encodes running at once on one object, while its worker count changes, do not
+ * disturb each other */
+TEST(JpegRTest, EncodeConcurrentlyOnOneObject) {
+  UhdrUnCompressedStructWrapper rawImgP010(kImageWidth, kImageHeight, YCbCr_p010);
+  ASSERT_TRUE(rawImgP010.setImageColorGamut(ULTRAHDR_COLORGAMUT_BT2100));
+  ASSERT_TRUE(rawImgP010.allocateMemory());
+  ASSERT_TRUE(rawImgP010.loadRawResource(kYCbCrP010FileName));
+
+  JpegR uHdrLib;
+  UhdrCompressedStructWrapper refImg(kImageWidth, kImageHeight);
+  ASSERT_TRUE(refImg.allocateMemory());
+  ASSERT_EQ(uHdrLib.encodeJPEGR(rawImgP010.getImageHandle(), ULTRAHDR_TF_HLG,
+                                refImg.getImageHandle(), kQuality, nullptr),
+            OK);
+  const auto ref = refImg.getImageHandle();
+
+  constexpr int kThreadCount = 4;
+  std::array<status_t, kThreadCount> results;
+  results.fill(UNKNOWN_ERROR);
+  std::array<bool, kThreadCount> matches = {};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&, i]() {
+      UhdrCompressedStructWrapper jpgImg(kImageWidth, kImageHeight);
+      if (!jpgImg.allocateMemory()) {
+        return;
+      }
+      results[i] = uHdrLib.encodeJPEGR(rawImgP010.getImageHandle(), ULTRAHDR_TF_HLG,
+                                       jpgImg.getImageHandle(), kQuality, nullptr);
+      jpegr_encode_timing_struct timing;
+      uHdrLib.getEncodeTiming(&timing);
+      const auto jpg = jpgImg.getImageHandle();
+      matches[i] = jpg->length == ref->length && memcmp(jpg->data, ref->data, ref->length) == 0;
+    });
+  }
+  for (size_t workers : {0, 3, 1}) {
+    uHdrLib.setWorkerThreadCount(workers);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kThreadCount; i++) {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(results[i], OK);
+    EXPECT_TRUE(matches[i]);
+  }
+  jpegr_encode_timing_struct timing;
+  ASSERT_EQ(uHdrLib.getEncodeTiming(&timing), OK);
+  EXPECT_GT(timing.totalUs, 0);
+}
+
+TEST(JpegRTest, ProfileEncode) {
+  const int kProfileCount = 5;
+  const std::pair<int, int> resolutions[] = {{640, 480}, {1280, 720}, {1920, 1080}, {4000, 3000}};
+  for (const auto& [width, height] : resolutions) {
+    std::vector<uint16_t> p010;
+    std::vector<uint8_t> yuv420;
+    ASSERT_NO_FATAL_FAILURE(tileTestImages(width, height, &p010, &yuv420));
+    jpegr_uncompressed_struct p010Image = {.data = p010.data(),
+                                           .width = width,
+                                           .height = height,
+                                           .colorGamut = ULTRAHDR_COLORGAMUT_BT2100};
+    jpegr_uncompressed_struct yuv420Image = {.data = yuv420.data(),
+                                             .width = width,
+                                             .height = height,
+                                             .colorGamut = ULTRAHDR_COLORGAMUT_BT709};
+    std::vector<uint8_t> output(width * height * 3);
+    jpegr_compressed_struct jpgImage = {.data = output.data(),
+                                        .length = 0,
+                                        .maxLength = static_cast<int>(output.size()),
+                                        .colorGamut = ULTRAHDR_COLORGAMUT_UNSPECIFIED};
+
+    for (size_t workers : {0, 1, 3}) {
+      for (bool withSdr : {false, true}) {
+        JpegR uHdrLib;
+        uHdrLib.setWorkerThreadCount(workers);
+        jpegr_encode_timing_struct sum{};
+        for (int i = 0; i < kProfileCount; i++) {
+          if (withSdr) {
+            ASSERT_EQ(OK,
+                      uHdrLib.encodeJPEGR(&p010Image, &yuv420Image, ULTRAHDR_TF_HLG, &jpgImage,
+                                          kQuality, nullptr));
+          } else {
+            ASSERT_EQ(OK,
+                      uHdrLib.encodeJPEGR(&p010Image, ULTRAHDR_TF_HLG, &jpgImage, kQuality,
+                                          nullptr));
+          }
+          jpegr_encode_timing_struct timing;
+          ASSERT_EQ(OK, uHdrLib.getEncodeTiming(&timing));
+          sum.toneMapUs += timing.toneMapUs;
+          sum.generateGainMapUs += timing.generateGainMapUs;
+          sum.compressGainMapUs += timing.compressGainMapUs;
+          sum.compressPrimaryImageUs += timing.compressPrimaryImageUs;
+          sum.appendGainMapUs += timing.appendGainMapUs;
+          sum.totalUs += timing.totalUs;
+        }
+        ALOGE("Encode API-%d:- Res = %i x %i, workers = %zu, tone map = %f ms, generate gain map "
+              "= %f ms, compress gain map = %f ms, compress primary image = %f ms, append gain "
+              "map = %f ms, total = %f ms",
+              withSdr ? 1 : 0, width, height, workers, sum.toneMapUs / (kProfileCount * 1000.f),
+              sum.generateGainMapUs / (kProfileCount * 1000.f),
+              sum.compressGainMapUs / (kProfileCount * 1000.f),
+              sum.compressPrimaryImageUs / (kProfileCount * 1000.f),
+              sum.appendGainMapUs / (kProfileCount * 1000.f),
+              sum.totalUs / (kProfileCount * 1000.f));
+      }
+    }
+  }
+}
+
 } // namespace android::ultrahdr
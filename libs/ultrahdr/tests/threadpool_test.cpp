@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <ultrahdr/threadpool.h>
+
+namespace android::ultrahdr {
+
+class ThreadPoolTest : public testing::TestWithParam<size_t> {};
+
+TEST_P(ThreadPoolTest, ParallelForCoversRange) {
+  ThreadPool pool(GetParam());
+  EXPECT_EQ(pool.getWorkerCount(), GetParam());
+  for (size_t count : {0, 1, 15, 16, 17, 1000}) {
+    std::vector<std::atomic<int>> visits(count);
+    pool.parallelFor(count, 16, [&](size_t begin, size_t end) {
+      EXPECT_LT(begin, end);
+      EXPECT_LE(end - begin, 16u);
+      for (size_t i = begin; i < end; i++) {
+        visits[i]++;
+      }
+    });
+    for (size_t i = 0; i < count; i++) {
+      EXPECT_EQ(visits[i], 1) << "item " << i << " of " << count;
+    }
+  }
+}
+
+TEST_P(ThreadPoolTest, ParallelForZeroStep) {
+  ThreadPool pool(GetParam());
+  std::atomic<size_t> total = 0;
+  pool.parallelFor(10, 0, [&](size_t begin, size_t end) { total += end - begin; });
+  EXPECT_EQ(total, 10u);
+}
+
+TEST_P(ThreadPoolTest, NestedParallelFor) {
+  ThreadPool pool(GetParam());
+  std::atomic<size_t> total = 0;
+  pool.parallelFor(8, 1, [&](size_t, size_t) {
+    pool.parallelFor(100, 7, [&](size_t begin, size_t end) { total += end - begin; });
+  });
+  EXPECT_EQ(total, 800u);
+}
+
+TEST_P(ThreadPoolTest, TaskGroupRunsEveryTask) {
+  ThreadPool pool(GetParam());
+  std::atomic<int> done = 0;
+  {
+    TaskGroup group(&pool);
+    for (int i = 0; i < 100; i++) {
+      group.run([&]() { done++; });
+    }
+    group.wait();
+    EXPECT_EQ(done, 100);
+    // A group can be reused after waiting.
+    group.run([&]() { done++; });
+  }
+  // The destructor waits for the last task.
+  EXPECT_EQ(done, 101);
+}
+
+TEST_P(ThreadPoolTest, TaskGroupWhileParallelFor) {
+  ThreadPool pool(GetParam());
+  std::atomic<size_t> groupTotal = 0, loopTotal = 0;
+  TaskGroup group(&pool);
+  group.run([&]() {
+    pool.parallelFor(1000, 10, [&](size_t begin, size_t end) { groupTotal += end - begin; });
+  });
+  pool.parallelFor(1000, 10, [&](size_t begin, size_t end) { loopTotal += end - begin; });
+  group.wait();
+  EXPECT_EQ(groupTotal, 1000u);
+  EXPECT_EQ(loopTotal, 1000u);
+}
+
+TEST(ThreadPoolTest, UsesWorkers) {
+  ThreadPool pool(3);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  // Each task waits for a while so that the calling thread can not run them all by itself.
+  pool.parallelFor(64, 1, [&](size_t, size_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(ThreadPoolTest, NoWorkersRunsOnCallingThread) {
+  ThreadPool pool(0);
+  const std::thread::id caller = std::this_thread::get_id();
+  pool.parallelFor(100, 1, [&](size_t, size_t) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+  });
+  TaskGroup group(&pool);
+  group.run([&]() { EXPECT_EQ(std::this_thread::get_id(), caller); });
+  group.wait();
+}
+
+INSTANTIATE_TEST_SUITE_P(WorkerCounts, ThreadPoolTest, testing::Values(0, 1, 3, 8));
+
+} // namespace android::ultrahdr
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ultrahdr/threadpool.h>
+
+#include <algorithm>
+
+namespace android::ultrahdr {
+
+// The pool and queue of the worker running on this thread, if any.
+static thread_local ThreadPool* tCurrentPool = nullptr;
+static thread_local size_t tCurrentQueue = 0;
+
+ThreadPool::ThreadPool(size_t numWorkers) {
+  // A pool without workers still needs a queue for the threads that wait to run tasks from.
+  const size_t numQueues = std::max(numWorkers, static_cast<size_t>(1));
+  for (size_t i = 0; i < numQueues; i++) {
+    mQueues.push_back(std::make_unique<Queue>());
+  }
+  for (size_t i = 0; i < numWorkers; i++) {
+    mThreads.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStopping = true;
+  }
+  mCv.notify_all();
+  for (std::thread& thread : mThreads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t step,
+                             const std::function<void(size_t, size_t)>& fn) {
+  if (count == 0) {
+    return;
+  }
+  step = std::max(step, static_cast<size_t>(1));
+  if (mThreads.empty() || count <= step) {
+    for (size_t begin = 0; begin < count; begin += step) {
+      fn(begin, std::min(begin + step, count));
+    }
+    return;
+  }
+  TaskGroup group(this);
+  for (size_t begin = 0; begin < count; begin += step) {
+    const size_t end = std::min(begin + step, count);
+    group.run([&fn, begin, end]() { fn(begin, end); });
+  }
+  group.wait();
+}
+
+void ThreadPool::push(std::function<void()> task) {
+  const size_t index = tCurrentPool == this
+          ? tCurrentQueue
+          : mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size();
+  {
+    std::lock_guard<std::mutex> lock(mQueues[index]->mutex);
+    mQueues[index]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueuedTasks++;
+  }
+  mCv.notify_one();
+}
+
+bool ThreadPool::runQueuedTask() {
+  const bool isWorker = tCurrentPool == this;
+  const size_t first = isWorker ? tCurrentQueue : 0;
+  std::function<void()> task;
+  for (size_t i = 0; i < mQueues.size() && !task; i++) {
+    Queue& queue = *mQueues[(first + i) % mQueues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    // A worker's own newest task is likely to touch the data it just worked on, while the oldest
+    // tasks of other queues are likely to be the biggest.
+    if (isWorker && i == 0) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+  }
+  if (!task) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mQueuedTasks--;
+  }
+  task();
+  return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+  tCurrentPool = this;
+  tCurrentQueue = index;
+  while (true) {
+    if (runQueuedTask()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCv.wait(lock, [this]() { return mStopping || mQueuedTasks > 0; });
+    if (mStopping && mQueuedTasks == 0) {
+      return;
+    }
+  }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPendingTasks++;
+  }
+  mPool->push([this, task = std::move(task)]() {
+    task();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (--mPendingTasks == 0) {
+      mCv.notify_all();
+    }
+  });
+}
+
+void TaskGroup::wait() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (mPendingTasks == 0) {
+        return;
+      }
+    }
+    if (mPool->runQueuedTask()) {
+      continue;
+    }
+    // Every task of the group has been taken by another thread, so wait for them to finish.
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCv.wait(lock, [this]() { return mPendingTasks == 0; });
+  }
+}
+
+} // namespace android::ultrahdr
@@ -25,6 +25,7 @@
 #include <log/log.h>
 #include <utils/Trace.h>
 
+#include <algorithm>
 #include <chrono>
 
 namespace android {
@@ -39,10 +40,21 @@ static const uint32_t blobCacheVersion = 3;
 static const uint32_t blobCacheDeviceVersion = 1;
 
 BlobCache::BlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize)
+      : BlobCache(maxKeySize, maxValueSize, maxTotalSize, EvictionPolicy::kRandom,
+                  maxTotalSize / 2) {}
+
+BlobCache::BlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
+                     EvictionPolicy evictionPolicy, size_t cleanWatermark)
       : mMaxTotalSize(maxTotalSize),
         mMaxKeySize(maxKeySize),
         mMaxValueSize(maxValueSize),
-        mTotalSize(0) {
+        mEvictionPolicy(evictionPolicy),
+        mCleanWatermark(cleanWatermark < maxTotalSize ? cleanWatermark : maxTotalSize / 2),
+        mTotalSize(0),
+        mAccessClock(0) {
+    ALOGW_IF(cleanWatermark >= maxTotalSize,
+             "clean watermark %zu is not below the maximum cache size %zu, using %zu",
+             cleanWatermark, maxTotalSize, mCleanWatermark);
     int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
 #ifdef _WIN32
     srand(now);
@@ -106,7 +118,8 @@ BlobCache::InsertResult BlobCache::set(const void* key, size_t keySize, const vo
                     return InsertResult::kNotEnoughSpace;
                 }
             }
-            mCacheEntries.insert(index, CacheEntry(keyBlob, valueBlob));
+            auto entry = mCacheEntries.insert(index, CacheEntry(keyBlob, valueBlob));
+            entry->recordAccess(++mAccessClock, /*isHit=*/false);
             mTotalSize = newTotalSize;
             ALOGV("set: created new cache entry with %zu byte key and %zu byte value", keySize,
                   valueSize);
@@ -129,6 +142,7 @@ BlobCache::InsertResult BlobCache::set(const void* key, size_t keySize, const vo
                 }
             }
             index->setValue(valueBlob);
+            index->recordAccess(++mAccessClock, /*isHit=*/false);
             mTotalSize = newTotalSize;
             ALOGV("set: updated existing cache entry with %zu byte key and %zu byte "
                   "value",
@@ -154,6 +168,7 @@ size_t BlobCache::get(const void* key, size_t keySize, void* value, size_t value
 
     // The key was found. Return the value if the caller's buffer is large
     // enough.
+    index->recordAccess(++mAccessClock, /*isHit=*/true);
     std::shared_ptr<Blob> valueBlob(index->getValue());
     size_t valueBlobSize = valueBlob->getSize();
     if (valueBlobSize <= valueSize) {
@@ -196,10 +211,22 @@ int BlobCache::flatten(void* buffer, size_t size) const {
     header->mBuildIdLength = buildId.size();
     memcpy(header->mBuildId, buildId.c_str(), header->mBuildIdLength);
 
-    // Write cache entries
+    // Write cache entries from the least to the most recently used, so that
+    // unflatten restores the order in which they were accessed.
+    std::vector<size_t> order(mCacheEntries.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        const uint64_t lhsTime = mCacheEntries[lhs].getLastAccessTime();
+        const uint64_t rhsTime = mCacheEntries[rhs].getLastAccessTime();
+        return lhsTime != rhsTime ? lhsTime < rhsTime : lhs < rhs;
+    });
+
     uint8_t* byteBuffer = reinterpret_cast<uint8_t*>(buffer);
     off_t byteOffset = align4(sizeof(Header) + header->mBuildIdLength);
-    for (const CacheEntry& e : mCacheEntries) {
+    for (size_t i : order) {
+        const CacheEntry& e = mCacheEntries[i];
         std::shared_ptr<Blob> const& keyBlob = e.getKey();
         std::shared_ptr<Blob> const& valueBlob = e.getValue();
         size_t keySize = keyBlob->getSize();
@@ -279,6 +306,9 @@ int BlobCache::unflatten(void const* buffer, size_t size) {
             return -EINVAL;
         }
 
+        // set stamps each entry with the next access time, so entries that
+        // were flattened from the least to the most recently used keep that
+        // order.
         const uint8_t* data = eheader->mData;
         set(data, keySize, data + keySize, valueSize);
 
@@ -299,9 +329,21 @@ long int BlobCache::blob_random() {
 void BlobCache::clean() {
     ATRACE_NAME("BlobCache::clean");
 
-    // Remove a random cache entry until the total cache size gets below half
-    // the maximum total cache size.
-    while (mTotalSize > mMaxTotalSize / 2) {
+    switch (mEvictionPolicy) {
+        case EvictionPolicy::kRandom:
+            cleanRandom();
+            break;
+        case EvictionPolicy::kLeastRecentlyUsed:
+        case EvictionPolicy::kCostAware:
+            cleanRanked();
+            break;
+    }
+}
+
+void BlobCache::cleanRandom() {
+    // Remove a random cache entry until the total cache size gets below the
+    // clean watermark.
+    while (mTotalSize > mCleanWatermark) {
         size_t i = size_t(blob_random() % (mCacheEntries.size()));
         const CacheEntry& entry(mCacheEntries[i]);
         mTotalSize -= entry.getKey()->getSize() + entry.getValue()->getSize();
@@ -309,8 +351,57 @@ void BlobCache::clean() {
     }
 }
 
+void BlobCache::cleanRanked() {
+    // Rank the entries from the first to the last to be evicted.
+    std::vector<size_t> ranking(mCacheEntries.size());
+    for (size_t i = 0; i < ranking.size(); i++) {
+        ranking[i] = i;
+    }
+    auto entrySize = [](const CacheEntry& e) {
+        return e.getKey()->getSize() + e.getValue()->getSize();
+    };
+    const bool costAware = mEvictionPolicy == EvictionPolicy::kCostAware;
+    std::sort(ranking.begin(), ranking.end(), [&](size_t lhs, size_t rhs) {
+        const CacheEntry& a = mCacheEntries[lhs];
+        const CacheEntry& b = mCacheEntries[rhs];
+        if (costAware) {
+            // Compare hits per byte without dividing. One is added to the hit
+            // count so that the size still matters for entries with no hits.
+            const uint64_t aWeight = uint64_t(a.getHitCount() + 1) * entrySize(b);
+            const uint64_t bWeight = uint64_t(b.getHitCount() + 1) * entrySize(a);
+            if (aWeight != bWeight) {
+                return aWeight < bWeight;
+            }
+        }
+        if (a.getLastAccessTime() != b.getLastAccessTime()) {
+            return a.getLastAccessTime() < b.getLastAccessTime();
+        }
+        // Entries are sorted by key, so this breaks ties by key.
+        return lhs < rhs;
+    });
+
+    // Mark entries for eviction until the total cache size gets below the
+    // clean watermark, then remove them all at once to keep the entries sorted
+    // by key.
+    std::vector<bool> evict(mCacheEntries.size(), false);
+    for (size_t i = 0; i < ranking.size() && mTotalSize > mCleanWatermark; i++) {
+        evict[ranking[i]] = true;
+        mTotalSize -= entrySize(mCacheEntries[ranking[i]]);
+    }
+    size_t next = 0;
+    for (size_t i = 0; i < mCacheEntries.size(); i++) {
+        if (!evict[i]) {
+            if (next != i) {
+                mCacheEntries[next] = mCacheEntries[i];
+            }
+            next++;
+        }
+    }
+    mCacheEntries.resize(next);
+}
+
 bool BlobCache::isCleanable() const {
-    return mTotalSize > mMaxTotalSize / 2;
+    return mTotalSize > mCleanWatermark;
 }
 
 BlobCache::Blob::Blob(const void* data, size_t size, bool copyData)
@@ -342,13 +433,17 @@ size_t BlobCache::Blob::getSize() const {
     return mSize;
 }
 
-BlobCache::CacheEntry::CacheEntry() {}
+BlobCache::CacheEntry::CacheEntry() : mLastAccessTime(0), mHitCount(0) {}
 
 BlobCache::CacheEntry::CacheEntry(const std::shared_ptr<Blob>& key,
                                   const std::shared_ptr<Blob>& value)
-      : mKey(key), mValue(value) {}
+      : mKey(key), mValue(value), mLastAccessTime(0), mHitCount(0) {}
 
-BlobCache::CacheEntry::CacheEntry(const CacheEntry& ce) : mKey(ce.mKey), mValue(ce.mValue) {}
+BlobCache::CacheEntry::CacheEntry(const CacheEntry& ce)
+      : mKey(ce.mKey),
+        mValue(ce.mValue),
+        mLastAccessTime(ce.mLastAccessTime),
+        mHitCount(ce.mHitCount) {}
 
 bool BlobCache::CacheEntry::operator<(const CacheEntry& rhs) const {
     return *mKey < *rhs.mKey;
@@ -357,6 +452,8 @@ bool BlobCache::CacheEntry::operator<(const CacheEntry& rhs) const {
 const BlobCache::CacheEntry& BlobCache::CacheEntry::operator=(const CacheEntry& rhs) {
     mKey = rhs.mKey;
     mValue = rhs.mValue;
+    mLastAccessTime = rhs.mLastAccessTime;
+    mHitCount = rhs.mHitCount;
     return *this;
 }
 
@@ -372,4 +469,19 @@ void BlobCache::CacheEntry::setValue(const std::shared_ptr<Blob>& value) {
     mValue = value;
 }
 
+void BlobCache::CacheEntry::recordAccess(uint64_t accessTime, bool isHit) {
+    mLastAccessTime = accessTime;
+    if (isHit && mHitCount < UINT32_MAX) {
+        mHitCount++;
+    }
+}
+
+uint64_t BlobCache::CacheEntry::getLastAccessTime() const {
+    return mLastAccessTime;
+}
+
+uint32_t BlobCache::CacheEntry::getHitCount() const {
+    return mHitCount;
+}
+
 } // namespace android
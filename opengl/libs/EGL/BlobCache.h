@@ -18,6 +18,7 @@
 #define ANDROID_BLOB_CACHE_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
 #include <vector>
@@ -39,6 +40,28 @@ public:
     // (key sizes plus value sizes) will not exceed maxTotalSize.
     BlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize);
 
+    // EvictionPolicy selects which entries are evicted when the cache needs to
+    // make room for a new entry.
+    enum class EvictionPolicy {
+        // Evict randomly chosen entries.
+        kRandom,
+        // Evict the entries that were least recently set or retrieved first.
+        kLeastRecentlyUsed,
+        // Evict the entries with the fewest hits per byte first, so that large,
+        // rarely used values are evicted before small, frequently used ones.
+        // Ties are broken by recency.
+        kCostAware,
+    };
+
+    // Create an empty blob cache that uses the given eviction policy. When the
+    // cache is full, entries are evicted until the total size of the remaining
+    // entries is no more than cleanWatermark bytes.
+    //
+    // Preconditions:
+    //   cleanWatermark < maxTotalSize
+    BlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
+              EvictionPolicy evictionPolicy, size_t cleanWatermark);
+
     // Return value from set(), below.
     enum class InsertResult {
         // The key is larger than maxKeySize specified in the constructor.
@@ -101,7 +124,9 @@ public:
     // flatten serializes the current contents of the cache into the memory
     // pointed to by 'buffer'.  The serialized cache contents can later be
     // loaded into a BlobCache object using the unflatten method.  The contents
-    // of the BlobCache object will not be modified.
+    // of the BlobCache object will not be modified.  Entries are serialized
+    // from the least to the most recently used, so that unflatten restores the
+    // order the eviction policies rank them by.
     //
     // Preconditions:
     //   size >= this.getFlattenedSize()
@@ -122,6 +147,9 @@ public:
         mTotalSize = 0;
     }
 
+    // getEvictionPolicy returns the policy used to choose the entries to evict.
+    EvictionPolicy getEvictionPolicy() const { return mEvictionPolicy; }
+
 protected:
     // mMaxTotalSize is the maximum size that all cache entries can occupy. This
     // includes space for both keys and values. When a call to BlobCache::set
@@ -138,10 +166,16 @@ private:
     // A random function helper to get around MinGW not having nrand48()
     long int blob_random();
 
-    // clean evicts a randomly chosen set of entries from the cache such that
-    // the total size of all remaining entries is less than mMaxTotalSize/2.
+    // clean evicts a set of entries chosen by mEvictionPolicy from the cache
+    // such that the total size of all remaining entries is no more than
+    // mCleanWatermark.
     void clean();
 
+    // cleanRandom and cleanRanked implement clean for the random and the
+    // ranked (LRU and cost-aware) eviction policies respectively.
+    void cleanRandom();
+    void cleanRanked();
+
     // isCleanable returns true if the cache is full enough for the clean method
     // to have some effect, and false otherwise.
     bool isCleanable() const;
@@ -188,12 +222,25 @@ private:
 
         void setValue(const std::shared_ptr<Blob>& value);
 
+        // recordAccess marks the entry as used at the given access time. If
+        // isHit is true the access is also counted as a cache hit.
+        void recordAccess(uint64_t accessTime, bool isHit);
+        uint64_t getLastAccessTime() const;
+        uint32_t getHitCount() const;
+
     private:
         // mKey is the key that identifies the cache entry.
         std::shared_ptr<Blob> mKey;
 
         // mValue is the cached data associated with the key.
         std::shared_ptr<Blob> mValue;
+
+        // mLastAccessTime is the value of BlobCache::mAccessClock when the
+        // entry was last set or retrieved.
+        uint64_t mLastAccessTime;
+
+        // mHitCount is the number of times the entry was retrieved by get.
+        uint32_t mHitCount;
     };
 
     // A Header is the header for the entire BlobCache serialization format. No
@@ -252,10 +299,20 @@ private:
     // simply not add the key/value pair to the cache.
     const size_t mMaxValueSize;
 
+    // mEvictionPolicy selects the entries that clean evicts.
+    const EvictionPolicy mEvictionPolicy;
+
+    // mCleanWatermark is the total size that clean evicts entries down to.
+    const size_t mCleanWatermark;
+
     // mTotalSize is the total combined size of all keys and values currently in
     // the cache.
     size_t mTotalSize;
 
+    // mAccessClock is incremented on every set and get, and is used to order
+    // cache entries by recency.
+    uint64_t mAccessClock;
+
     // mRandState is the pseudo-random number generator state. It is passed to
     // nrand48 to generate random numbers when needed.
     unsigned short mRandState[3];
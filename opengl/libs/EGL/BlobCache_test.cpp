@@ -16,11 +16,15 @@
 
 #include "BlobCache.h"
 
+#include <android-base/test_utils.h>
 #include <fcntl.h>
 #include <gtest/gtest.h>
 #include <stdio.h>
 
 #include <memory>
+#include <string>
+
+#include "FileBlobCache.h"
 
 namespace android {
 
@@ -302,6 +306,159 @@ TEST_F(BlobCacheTest, InvalidValueSize) {
     ASSERT_EQ(BlobCache::InsertResult::kInvalidValueSize, mBC->set("abcd", 4, "", 0));
 }
 
+TEST_F(BlobCacheTest, LeastRecentlyUsedEvictsOldestEntries) {
+    // Room for four 2 byte entries, cleaned down to three.
+    mBC.reset(new BlobCache(MAX_KEY_SIZE, MAX_VALUE_SIZE, 8,
+                            BlobCache::EvictionPolicy::kLeastRecentlyUsed, 6));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("a", 1, "1", 1));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("b", 1, "2", 1));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("c", 1, "3", 1));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("d", 1, "4", 1));
+
+    // Touch "a" so that "b" becomes the least recently used entry.
+    ASSERT_EQ(size_t(1), mBC->get("a", 1, nullptr, 0));
+    ASSERT_EQ(BlobCache::InsertResult::kDidClean, mBC->set("e", 1, "5", 1));
+
+    ASSERT_EQ(size_t(1), mBC->get("a", 1, nullptr, 0));
+    ASSERT_EQ(size_t(0), mBC->get("b", 1, nullptr, 0));
+    ASSERT_EQ(size_t(1), mBC->get("c", 1, nullptr, 0));
+    ASSERT_EQ(size_t(1), mBC->get("d", 1, nullptr, 0));
+    ASSERT_EQ(size_t(1), mBC->get("e", 1, nullptr, 0));
+}
+
+TEST_F(BlobCacheTest, CostAwareEvictsLargeUnusedEntriesFirst) {
+    mBC.reset(new BlobCache(MAX_KEY_SIZE, MAX_VALUE_SIZE, 16,
+                            BlobCache::EvictionPolicy::kCostAware, 12));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("a", 1, "1", 1));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("b", 1, "22222222", 8));
+    ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set("c", 1, "3", 1));
+    ASSERT_EQ(size_t(1), mBC->get("a", 1, nullptr, 0));
+    ASSERT_EQ(size_t(1), mBC->get("a", 1, nullptr, 0));
+
+    // Although "b" is more recently used than "a", it is the largest entry and
+    // has never been retrieved, so it is evicted first.
+    ASSERT_EQ(BlobCache::InsertResult::kDidClean, mBC->set("d", 1, "444", 3));
+
+    ASSERT_EQ(size_t(1), mBC->get("a", 1, nullptr, 0));
+    ASSERT_EQ(size_t(0), mBC->get("b", 1, nullptr, 0));
+    ASSERT_EQ(size_t(1), mBC->get("c", 1, nullptr, 0));
+    ASSERT_EQ(size_t(3), mBC->get("d", 1, nullptr, 0));
+}
+
+TEST_F(BlobCacheTest, CleanStopsAtWatermark) {
+    mBC.reset(new BlobCache(MAX_KEY_SIZE, MAX_VALUE_SIZE, MAX_TOTAL_SIZE,
+                            BlobCache::EvictionPolicy::kRandom, MAX_TOTAL_SIZE - 3));
+    // Fill up the entire cache with 1 char key/value pairs.
+    const int maxEntries = MAX_TOTAL_SIZE / 2;
+    for (int i = 0; i < maxEntries; i++) {
+        uint8_t k = i;
+        ASSERT_EQ(BlobCache::InsertResult::kInserted, mBC->set(&k, 1, "x", 1));
+    }
+    // Insert one more entry, causing a cache overflow. Only a single entry
+    // needs to be evicted to get below the watermark.
+    {
+        uint8_t k = maxEntries;
+        ASSERT_EQ(BlobCache::InsertResult::kDidClean, mBC->set(&k, 1, "x", 1));
+    }
+    int numCached = 0;
+    for (int i = 0; i < maxEntries + 1; i++) {
+        uint8_t k = i;
+        if (mBC->get(&k, 1, nullptr, 0) == 1) {
+            numCached++;
+        }
+    }
+    ASSERT_EQ(maxEntries, numCached);
+}
+
+// Simulates an app that uses a fixed set of hot shaders every frame while also
+// compiling a stream of shaders that are only ever used once, and returns the
+// fraction of lookups for hot shaders that hit the cache.
+static double measureHotShaderHitRatio(BlobCache::EvictionPolicy policy) {
+    constexpr uint32_t kHotShaders = 8;
+    constexpr uint32_t kColdShadersPerFrame = 4;
+    constexpr uint32_t kFrames = 200;
+    constexpr size_t kValueSize = 16;
+    constexpr size_t kEntrySize = sizeof(uint32_t) + kValueSize;
+    // The cache holds 16 entries and is cleaned down to 12.
+    BlobCache cache(sizeof(uint32_t), kValueSize, 16 * kEntrySize, policy, 12 * kEntrySize);
+
+    const uint8_t binary[kValueSize] = {};
+    size_t lookups = 0;
+    size_t hits = 0;
+    for (uint32_t frame = 0; frame < kFrames; frame++) {
+        for (uint32_t key = 0; key < kHotShaders; key++) {
+            lookups++;
+            if (cache.get(&key, sizeof(key), nullptr, 0) == kValueSize) {
+                hits++;
+            } else {
+                cache.set(&key, sizeof(key), binary, kValueSize);
+            }
+        }
+        for (uint32_t i = 0; i < kColdShadersPerFrame; i++) {
+            const uint32_t key = kHotShaders + frame * kColdShadersPerFrame + i;
+            cache.set(&key, sizeof(key), binary, kValueSize);
+        }
+    }
+    return double(hits) / double(lookups);
+}
+
+TEST_F(BlobCacheTest, HotShaderHitRatio) {
+    const double randomHitRatio = measureHotShaderHitRatio(BlobCache::EvictionPolicy::kRandom);
+    const double lruHitRatio =
+            measureHotShaderHitRatio(BlobCache::EvictionPolicy::kLeastRecentlyUsed);
+    const double costAwareHitRatio =
+            measureHotShaderHitRatio(BlobCache::EvictionPolicy::kCostAware);
+    RecordProperty("randomHitRatio", std::to_string(randomHitRatio));
+    RecordProperty("lruHitRatio", std::to_string(lruHitRatio));
+    RecordProperty("costAwareHitRatio", std::to_string(costAwareHitRatio));
+
+    // Only the first lookup of each hot shader should miss.
+    ASSERT_GE(lruHitRatio, 0.99);
+    ASSERT_GE(costAwareHitRatio, 0.99);
+    ASSERT_GE(lruHitRatio, randomHitRatio);
+}
+
+TEST_F(BlobCacheTest, FileBlobCacheHonoursEvictionPolicy) {
+    // Room for four 64 byte entries, cleaned down to three. The entries are
+    // large enough relative to the per-entry file overhead for the cache file
+    // to be reloaded.
+    constexpr size_t kValueSize = 63;
+    constexpr size_t kMaxTotalSize = 4 * (1 + kValueSize);
+    constexpr size_t kCleanWatermark = 3 * (1 + kValueSize);
+    const std::string value(kValueSize, 'x');
+
+    TemporaryFile tempFile;
+    {
+        FileBlobCache cache(1, kValueSize, kMaxTotalSize,
+                            BlobCache::EvictionPolicy::kLeastRecentlyUsed, kCleanWatermark,
+                            tempFile.path);
+        // Access the entries out of key order: "d" ends up least recently used.
+        ASSERT_EQ(BlobCache::InsertResult::kInserted, cache.set("c", 1, value.data(), kValueSize));
+        ASSERT_EQ(BlobCache::InsertResult::kInserted, cache.set("a", 1, value.data(), kValueSize));
+        ASSERT_EQ(BlobCache::InsertResult::kInserted, cache.set("d", 1, value.data(), kValueSize));
+        ASSERT_EQ(BlobCache::InsertResult::kInserted, cache.set("b", 1, value.data(), kValueSize));
+        ASSERT_EQ(kValueSize, cache.get("c", 1, nullptr, 0));
+        ASSERT_EQ(kValueSize, cache.get("a", 1, nullptr, 0));
+        cache.writeToFile();
+    }
+
+    // The cache loaded from disk evicts with the policy and watermark it was
+    // created with, and remembers the order in which entries were accessed.
+    FileBlobCache cache(1, kValueSize, kMaxTotalSize,
+                        BlobCache::EvictionPolicy::kLeastRecentlyUsed, kCleanWatermark,
+                        tempFile.path);
+    ASSERT_EQ(BlobCache::EvictionPolicy::kLeastRecentlyUsed, cache.getEvictionPolicy());
+
+    // Only "d" needs to be evicted to get down to the watermark.
+    ASSERT_EQ(BlobCache::InsertResult::kDidClean, cache.set("e", 1, value.data(), kValueSize));
+
+    ASSERT_EQ(kValueSize, cache.get("a", 1, nullptr, 0));
+    ASSERT_EQ(kValueSize, cache.get("b", 1, nullptr, 0));
+    ASSERT_EQ(kValueSize, cache.get("c", 1, nullptr, 0));
+    ASSERT_EQ(size_t(0), cache.get("d", 1, nullptr, 0));
+    ASSERT_EQ(kValueSize, cache.get("e", 1, nullptr, 0));
+}
+
 class BlobCacheFlattenTest : public BlobCacheTest {
 protected:
     virtual void SetUp() {
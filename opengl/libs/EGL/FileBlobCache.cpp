@@ -52,7 +52,12 @@ uint32_t crc32c(const uint8_t* buf, size_t len) {
 
 FileBlobCache::FileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
         const std::string& filename)
-        : BlobCache(maxKeySize, maxValueSize, maxTotalSize)
+        : FileBlobCache(maxKeySize, maxValueSize, maxTotalSize, EvictionPolicy::kRandom,
+                maxTotalSize / 2, filename) {}
+
+FileBlobCache::FileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
+        EvictionPolicy evictionPolicy, size_t cleanWatermark, const std::string& filename)
+        : BlobCache(maxKeySize, maxValueSize, maxTotalSize, evictionPolicy, cleanWatermark)
         , mFilename(filename) {
     ATRACE_CALL();
 
@@ -31,6 +31,11 @@ public:
     FileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
             const std::string& filename);
 
+    // Like the constructor above, but the loaded cache evicts entries chosen by
+    // evictionPolicy down to cleanWatermark bytes when it fills up.
+    FileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
+            EvictionPolicy evictionPolicy, size_t cleanWatermark, const std::string& filename);
+
     // writeToFile attempts to save the current contents of BlobCache to
     // disk.
     void writeToFile();
@@ -58,14 +58,28 @@ void freeHotCacheEntry(android::MultifileHotCache& entry) {
     }
 }
 
+// Mapped entries are shared so that their pages come straight from the page cache
+int mapFlagsFor(android::MultifileReadMode readMode) {
+    return readMode == android::MultifileReadMode::Mapped ? MAP_SHARED : MAP_PRIVATE;
+}
+
+bool isTempFile(const std::string& entryName) {
+    const size_t suffixLength = strlen(android::kMultifileBlobCacheTempSuffix);
+    return entryName.length() > suffixLength &&
+            entryName.compare(entryName.length() - suffixLength, suffixLength,
+                              android::kMultifileBlobCacheTempSuffix) == 0;
+}
+
 } // namespace
 
 namespace android {
 
 MultifileBlobCache::MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
-                                       size_t maxTotalEntries, const std::string& baseDir)
+                                       size_t maxTotalEntries, const std::string& baseDir,
+                                       MultifileReadMode readMode)
       : mInitialized(false),
         mCacheVersion(0),
+        mReadMode(readMode),
         mMaxKeySize(maxKeySize),
         mMaxValueSize(maxValueSize),
         mMaxTotalSize(maxTotalSize),
@@ -147,6 +161,16 @@ MultifileBlobCache::MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, s
                 std::string entryName = entry->d_name;
                 std::string fullPath = mMultifileDirName + "/" + entryName;
 
+                // Remove any partial write that was interrupted before it could be renamed
+                if (isTempFile(entryName)) {
+                    ALOGV("INIT: Removing temporary file %s", fullPath.c_str());
+                    if (remove(fullPath.c_str()) != 0) {
+                        ALOGE("INIT: Error removing %s: %s", fullPath.c_str(),
+                              std::strerror(errno));
+                    }
+                    continue;
+                }
+
                 // The filename is the same as the entryHash
                 uint32_t entryHash = static_cast<uint32_t>(strtoul(entry->d_name, nullptr, 10));
 
@@ -203,7 +227,7 @@ MultifileBlobCache::MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, s
 
                 // Memory map the file
                 uint8_t* mappedEntry = reinterpret_cast<uint8_t*>(
-                        mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0));
+                        mmap(nullptr, fileSize, PROT_READ, mapFlagsFor(mReadMode), fd, 0));
 
                 // We can close the file now and the mmap will remain
                 close(fd);
@@ -221,6 +245,7 @@ MultifileBlobCache::MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, s
                     if (remove(fullPath.c_str()) != 0) {
                         ALOGE("Error removing %s: %s", fullPath.c_str(), std::strerror(errno));
                     }
+                    munmap(mappedEntry, fileSize);
                     continue;
                 }
 
@@ -233,6 +258,7 @@ MultifileBlobCache::MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, s
                         ALOGE("INIT: Error removing %s: %s", fullPath.c_str(),
                               std::strerror(errno));
                     }
+                    munmap(mappedEntry, fileSize);
                     continue;
                 }
 
@@ -245,7 +271,11 @@ MultifileBlobCache::MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, s
                 increaseTotalCacheSize(fileSize);
 
                 // Preload the entry for fast retrieval
-                if ((mHotCacheSize + fileSize) < mHotCacheLimit) {
+                if (mReadMode == MultifileReadMode::Mapped) {
+                    // Keep the mapping, its pages are clean and shared with other processes
+                    ALOGV("INIT: Keeping mapping %p for entryHash %u", mappedEntry, entryHash);
+                    mMappedEntries[entryHash] = {mappedEntry, fileSize};
+                } else if ((mHotCacheSize + fileSize) < mHotCacheLimit) {
                     ALOGV("INIT: Populating hot cache with fd = %i, cacheEntry = %p for "
                           "entryHash %u",
                           fd, mappedEntry, entryHash);
@@ -348,6 +378,9 @@ void MultifileBlobCache::set(const void* key, EGLsizeiANDROID keySize, const voi
     // Update the overall cache size
     increaseTotalCacheSize(fileSize);
 
+    // Any existing mapping holds the previous value, the new one is served from hot cache
+    removeMappedEntry(entryHash);
+
     // Keep the entry in hot cache for quick retrieval
     ALOGV("SET: Adding %u to hot cache.", entryHash);
 
@@ -428,6 +461,9 @@ EGLsizeiANDROID MultifileBlobCache::get(const void* key, EGLsizeiANDROID keySize
     if (mHotCache.find(entryHash) != mHotCache.end()) {
         ALOGV("GET: HotCache HIT for entry %u", entryHash);
         cacheEntry = mHotCache[entryHash].entryBuffer;
+    } else if (mMappedEntries.find(entryHash) != mMappedEntries.end()) {
+        ALOGV("GET: Mapped HIT for entry %u", entryHash);
+        cacheEntry = mMappedEntries[entryHash].entryBuffer;
     } else {
         ALOGV("GET: HotCache MISS for entry: %u", entryHash);
 
@@ -444,33 +480,24 @@ EGLsizeiANDROID MultifileBlobCache::get(const void* key, EGLsizeiANDROID keySize
             waitForWorkComplete();
         }
 
-        // Open the entry file
-        int fd = open(fullPath.c_str(), O_RDONLY);
-        if (fd == -1) {
-            ALOGE("Cache error - failed to open fullPath: %s, error: %s", fullPath.c_str(),
-                  std::strerror(errno));
+        cacheEntry = mapEntry(fullPath, fileSize);
+        if (cacheEntry == nullptr) {
             return 0;
         }
 
-        // Memory map the file
-        cacheEntry =
-                reinterpret_cast<uint8_t*>(mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0));
-
-        // We can close the file now and the mmap will remain
-        close(fd);
-
-        if (cacheEntry == MAP_FAILED) {
-            ALOGE("Failed to mmap cacheEntry, error: %s", std::strerror(errno));
-            return 0;
-        }
+        if (mReadMode == MultifileReadMode::Mapped) {
+            ALOGV("GET: Keeping mapping for %u", entryHash);
+            mMappedEntries[entryHash] = {cacheEntry, fileSize};
+        } else {
+            ALOGV("GET: Adding %u to hot cache", entryHash);
+            // The fd was closed after mapping, any value other than -1 marks the entry as mapped
+            if (!addToHotCache(entryHash, 0, cacheEntry, fileSize)) {
+                ALOGE("GET: Failed to add %u to hot cache", entryHash);
+                return 0;
+            }
 
-        ALOGV("GET: Adding %u to hot cache", entryHash);
-        if (!addToHotCache(entryHash, fd, cacheEntry, fileSize)) {
-            ALOGE("GET: Failed to add %u to hot cache", entryHash);
-            return 0;
+            cacheEntry = mHotCache[entryHash].entryBuffer;
         }
-
-        cacheEntry = mHotCache[entryHash].entryBuffer;
     }
 
     // Ensure the header matches
@@ -480,6 +507,7 @@ EGLsizeiANDROID MultifileBlobCache::get(const void* key, EGLsizeiANDROID keySize
               "to cache header values for fullPath: %s",
               keySize, header->keySize, valueSize, header->valueSize, fullPath.c_str());
         removeFromHotCache(entryHash);
+        removeMappedEntry(entryHash);
         return 0;
     }
 
@@ -489,6 +517,7 @@ EGLsizeiANDROID MultifileBlobCache::get(const void* key, EGLsizeiANDROID keySize
     if (compare != 0) {
         ALOGW("Cached key and new key do not match! This is a hash collision or modified file");
         removeFromHotCache(entryHash);
+        removeMappedEntry(entryHash);
         return 0;
     }
 
@@ -518,6 +547,13 @@ void MultifileBlobCache::finish() {
 
         mHotCache.erase(hotCacheIter++);
     }
+
+    // Unmap all mapped entries
+    for (auto& [entryHash, entry] : mMappedEntries) {
+        ALOGV("FINISH: Unmapping entry for %u", entryHash);
+        munmap(entry.entryBuffer, entry.entrySize);
+    }
+    mMappedEntries.clear();
 }
 
 bool MultifileBlobCache::createStatus(const std::string& baseDir) {
@@ -716,6 +752,43 @@ bool MultifileBlobCache::removeFromHotCache(uint32_t entryHash) {
     return false;
 }
 
+// Map the entry file read-only, returning nullptr on failure
+uint8_t* MultifileBlobCache::mapEntry(const std::string& fullPath, size_t fileSize) {
+    // Open the entry file
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd == -1) {
+        ALOGE("Cache error - failed to open fullPath: %s, error: %s", fullPath.c_str(),
+              std::strerror(errno));
+        return nullptr;
+    }
+
+    // Memory map the file
+    uint8_t* entry = reinterpret_cast<uint8_t*>(
+            mmap(nullptr, fileSize, PROT_READ, mapFlagsFor(mReadMode), fd, 0));
+
+    // We can close the file now and the mmap will remain
+    close(fd);
+
+    if (entry == MAP_FAILED) {
+        ALOGE("Failed to mmap cacheEntry, error: %s", std::strerror(errno));
+        return nullptr;
+    }
+
+    return entry;
+}
+
+bool MultifileBlobCache::removeMappedEntry(uint32_t entryHash) {
+    auto mappedIter = mMappedEntries.find(entryHash);
+    if (mappedIter == mMappedEntries.end()) {
+        return false;
+    }
+
+    ALOGV("MAPPED(REMOVE): Unmapping entry for %u", entryHash);
+    munmap(mappedIter->second.entryBuffer, mappedIter->second.entrySize);
+    mMappedEntries.erase(mappedIter);
+    return true;
+}
+
 bool MultifileBlobCache::applyLRU(size_t cacheSizeLimit, size_t cacheEntryLimit) {
     // Walk through our map of sorted last access times and remove files until under the limit
     for (auto cacheEntryIter = mEntryStats.begin(); cacheEntryIter != mEntryStats.end();) {
@@ -727,8 +800,9 @@ bool MultifileBlobCache::applyLRU(size_t cacheSizeLimit, size_t cacheEntryLimit)
         MultifileEntryStats entryStats = getEntryStats(entryHash);
         decreaseTotalCacheSize(entryStats.fileSize);
 
-        // Remove it from hot cache if present
+        // Remove it from hot cache and unmap it if present
         removeFromHotCache(entryHash);
+        removeMappedEntry(entryHash);
 
         // Remove it from the system
         std::string entryPath = mMultifileDirName + "/" + std::to_string(entryHash);
@@ -828,15 +902,20 @@ void MultifileBlobCache::processTask(DeferredTask& task) {
             uint8_t* buffer = task.getBuffer();
             size_t bufferSize = task.getBufferSize();
 
+            // Write to a temporary file and rename it over the entry once complete. Replacing the
+            // entry rather than truncating it keeps existing mappings of the previous contents
+            // valid, including those held by other processes.
+            std::string tempPath = fullPath + kMultifileBlobCacheTempSuffix;
+
             // Create the file or reset it if already present, read+write for user only
-            int fd = open(fullPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+            int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
             if (fd == -1) {
-                ALOGE("Cache error in SET - failed to open fullPath: %s, error: %s",
-                      fullPath.c_str(), std::strerror(errno));
+                ALOGE("Cache error in SET - failed to open tempPath: %s, error: %s",
+                      tempPath.c_str(), std::strerror(errno));
                 return;
             }
 
-            ALOGV("DEFERRED: Opened fd %i from %s", fd, fullPath.c_str());
+            ALOGV("DEFERRED: Opened fd %i from %s", fd, tempPath.c_str());
 
             // Add CRC check to the header (always do this last!)
             MultifileHeader* header = reinterpret_cast<MultifileHeader*>(buffer);
@@ -844,14 +923,22 @@ void MultifileBlobCache::processTask(DeferredTask& task) {
                     crc32c(buffer + sizeof(MultifileHeader), bufferSize - sizeof(MultifileHeader));
 
             ssize_t result = write(fd, buffer, bufferSize);
+            close(fd);
             if (result != bufferSize) {
-                ALOGE("Error writing fileSize to cache entry (%s): %s", fullPath.c_str(),
+                ALOGE("Error writing fileSize to cache entry (%s): %s", tempPath.c_str(),
+                      std::strerror(errno));
+                remove(tempPath.c_str());
+                return;
+            }
+
+            if (rename(tempPath.c_str(), fullPath.c_str()) != 0) {
+                ALOGE("Error renaming %s to %s: %s", tempPath.c_str(), fullPath.c_str(),
                       std::strerror(errno));
+                remove(tempPath.c_str());
                 return;
             }
 
             ALOGV("DEFERRED: Completed write for: %s", fullPath.c_str());
-            close(fd);
 
             // Erase the entry from mDeferredWrites
             // Since there could be multiple outstanding writes for an entry, find the matching one
@@ -36,6 +36,7 @@ namespace android {
 
 constexpr uint32_t kMultifileBlobCacheVersion = 1;
 constexpr char kMultifileBlobCacheStatusFile[] = "cache.status";
+constexpr char kMultifileBlobCacheTempSuffix[] = ".tmp";
 
 struct MultifileHeader {
     uint32_t magic;
@@ -63,6 +64,20 @@ struct MultifileHotCache {
     size_t entrySize;
 };
 
+struct MultifileMappedEntry {
+    uint8_t* entryBuffer;
+    size_t entrySize;
+};
+
+// Controls how entries that were not set by this process are read back from disk
+enum class MultifileReadMode {
+    // Map entries on demand and keep the most recent ones in a small hot cache
+    HotCache,
+    // Keep a read-only shared mapping of every entry and serve gets directly from it, so the
+    // entries are backed by the page cache and shared with other processes
+    Mapped,
+};
+
 enum class TaskCommand {
     Invalid = 0,
     WriteToDisk,
@@ -103,7 +118,8 @@ private:
 class MultifileBlobCache {
 public:
     MultifileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxTotalSize,
-                       size_t maxTotalEntries, const std::string& baseDir);
+                       size_t maxTotalEntries, const std::string& baseDir,
+                       MultifileReadMode readMode = MultifileReadMode::HotCache);
     ~MultifileBlobCache();
 
     void set(const void* key, EGLsizeiANDROID keySize, const void* value,
@@ -119,6 +135,8 @@ public:
     const std::string& getCurrentBuildId() const { return mBuildId; }
     void setCurrentBuildId(const std::string& buildId) { mBuildId = buildId; }
 
+    MultifileReadMode getReadMode() const { return mReadMode; }
+
     uint32_t getCurrentCacheVersion() const { return mCacheVersion; }
     void setCurrentCacheVersion(uint32_t cacheVersion) { mCacheVersion = cacheVersion; }
 
@@ -141,6 +159,9 @@ private:
     bool addToHotCache(uint32_t entryHash, int fd, uint8_t* entryBufer, size_t entrySize);
     bool removeFromHotCache(uint32_t entryHash);
 
+    uint8_t* mapEntry(const std::string& fullPath, size_t fileSize);
+    bool removeMappedEntry(uint32_t entryHash);
+
     bool clearCache();
     void trimCache();
     bool applyLRU(size_t cacheSizeLimit, size_t cacheEntryLimit);
@@ -151,10 +172,15 @@ private:
     std::string mBuildId;
     uint32_t mCacheVersion;
 
+    MultifileReadMode mReadMode;
+
     std::unordered_set<uint32_t> mEntries;
     std::unordered_map<uint32_t, MultifileEntryStats> mEntryStats;
     std::unordered_map<uint32_t, MultifileHotCache> mHotCache;
 
+    // Entries served directly from their mapping in MultifileReadMode::Mapped
+    std::unordered_map<uint32_t, MultifileMappedEntry> mMappedEntries;
+
     size_t mMaxKeySize;
     size_t mMaxValueSize;
     size_t mMaxTotalSize;
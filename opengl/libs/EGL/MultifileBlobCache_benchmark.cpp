@@ -0,0 +1,131 @@
+/*
+ ** Copyright 2023, The Android Open Source Project
+ **
+ ** Licensed under the Apache License, Version 2.0 (the "License");
+ ** you may not use this file except in compliance with the License.
+ ** You may obtain a copy of the License at
+ **
+ **     http://www.apache.org/licenses/LICENSE-2.0
+ **
+ ** Unless required by applicable law or agreed to in writing, software
+ ** distributed under the License is distributed on an "AS IS" BASIS,
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ ** See the License for the specific language governing permissions and
+ ** limitations under the License.
+ */
+
+#include <android-base/file.h>
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MultifileBlobCache.h"
+
+namespace android {
+
+namespace {
+
+constexpr size_t kMaxKeySize = 1 * 1024 * 1024;
+constexpr size_t kMaxValueSize = 8 * 1024 * 1024;
+constexpr size_t kMaxTotalSize = 32 * 1024 * 1024;
+constexpr size_t kMaxTotalEntries = 4 * 1024;
+
+// Roughly the shape of the cache of a shader heavy app
+constexpr uint32_t kEntryCount = 512;
+constexpr size_t kValueSize = 32 * 1024;
+
+// Populate the cache on disk with kEntryCount entries
+void populateCache(const std::string& baseDir) {
+    MultifileBlobCache cache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries, baseDir);
+    std::vector<uint8_t> value(kValueSize);
+    for (uint32_t key = 0; key < kEntryCount; key++) {
+        std::fill(value.begin(), value.end(), static_cast<uint8_t>(key));
+        cache.set(&key, sizeof(key), value.data(), value.size());
+    }
+    cache.finish();
+}
+
+// Read a field, in kB, from /proc/self/smaps_rollup
+size_t readSmapsRollup(const std::string& field) {
+    std::ifstream smaps("/proc/self/smaps_rollup");
+    std::string name;
+    size_t value;
+    std::string unit;
+    while (smaps >> name >> value >> unit) {
+        if (name == field + ":") {
+            return value;
+        }
+    }
+    return 0;
+}
+
+void getAllEntries(benchmark::State& state, MultifileBlobCache& cache) {
+    std::vector<uint8_t> value(kValueSize);
+    for (uint32_t key = 0; key < kEntryCount; key++) {
+        if (cache.get(&key, sizeof(key), value.data(), value.size()) != kValueSize) {
+            state.SkipWithError("Cache miss");
+            return;
+        }
+    }
+}
+
+void reportMemory(benchmark::State& state) {
+    state.counters["rss_kb"] = readSmapsRollup("Rss");
+    state.counters["private_dirty_kb"] = readSmapsRollup("Private_Dirty");
+}
+
+} // namespace
+
+// Startup: open the cache and read back every entry once
+static void BM_MultifileBlobCache_ColdGet(benchmark::State& state) {
+    const MultifileReadMode readMode = static_cast<MultifileReadMode>(state.range(0));
+    TemporaryDir tempDir;
+    const std::string baseDir = std::string(tempDir.path) + "/cache";
+    populateCache(baseDir);
+
+    for (auto _ : state) {
+        MultifileBlobCache cache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries,
+                                 baseDir, readMode);
+        getAllEntries(state, cache);
+
+        state.PauseTiming();
+        reportMemory(state);
+        cache.finish();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kEntryCount);
+}
+BENCHMARK(BM_MultifileBlobCache_ColdGet)
+        ->ArgName("mapped")
+        ->Arg(static_cast<int>(MultifileReadMode::HotCache))
+        ->Arg(static_cast<int>(MultifileReadMode::Mapped));
+
+// Steady state: read back every entry from a cache that has already been used
+static void BM_MultifileBlobCache_WarmGet(benchmark::State& state) {
+    const MultifileReadMode readMode = static_cast<MultifileReadMode>(state.range(0));
+    TemporaryDir tempDir;
+    const std::string baseDir = std::string(tempDir.path) + "/cache";
+    populateCache(baseDir);
+
+    MultifileBlobCache cache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries, baseDir,
+                             readMode);
+    getAllEntries(state, cache);
+
+    for (auto _ : state) {
+        getAllEntries(state, cache);
+    }
+    reportMemory(state);
+    state.SetItemsProcessed(state.iterations() * kEntryCount);
+    cache.finish();
+}
+BENCHMARK(BM_MultifileBlobCache_WarmGet)
+        ->ArgName("mapped")
+        ->Arg(static_cast<int>(MultifileReadMode::HotCache))
+        ->Arg(static_cast<int>(MultifileReadMode::Mapped));
+
+} // namespace android
+
+BENCHMARK_MAIN();
@@ -503,4 +503,90 @@ TEST_F(MultifileBlobCacheTest, MismatchedBuildIdClears) {
     ASSERT_EQ(getCacheEntries().size(), 0);
 }
 
+// Verify entries can be read back in mapped mode, both before and after reopening the cache
+TEST_F(MultifileBlobCacheTest, MappedModeGetSucceeds) {
+    mMBC.reset(new MultifileBlobCache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries,
+                                      &mTempFile->path[0], MultifileReadMode::Mapped));
+    ASSERT_EQ(MultifileReadMode::Mapped, mMBC->getReadMode());
+
+    // Populate more entries than fit in the hot cache, so most of them are read from disk
+    for (int i = 0; i < kMaxTotalEntries / 2; i++) {
+        mMBC->set(&i, sizeof(i), &i, sizeof(i));
+    }
+    for (int i = 0; i < kMaxTotalEntries / 2; i++) {
+        int result = 0;
+        ASSERT_EQ(sizeof(i), mMBC->get(&i, sizeof(i), &result, sizeof(result)));
+        ASSERT_EQ(i, result);
+    }
+
+    // Close the cache so everything writes out
+    mMBC->finish();
+    mMBC.reset();
+
+    // No temporary files should be left behind
+    ASSERT_EQ(getCacheEntries().size(), kMaxTotalEntries / 2);
+
+    // Open the cache again, entries are now served from the mappings created at init
+    mMBC.reset(new MultifileBlobCache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries,
+                                      &mTempFile->path[0], MultifileReadMode::Mapped));
+    for (int i = 0; i < kMaxTotalEntries / 2; i++) {
+        int result = 0;
+        ASSERT_EQ(sizeof(i), mMBC->get(&i, sizeof(i), &result, sizeof(result)));
+        ASSERT_EQ(i, result);
+    }
+
+    // And we should not be holding on to any fds
+    ASSERT_LT(getFileDescriptorCount(), kMaxTotalEntries / 2);
+}
+
+// Verify that setting a mapped entry replaces it, rather than returning the stale mapping
+TEST_F(MultifileBlobCacheTest, MappedModeSetReplacesMappedEntry) {
+    unsigned char buf[4] = {0xee, 0xee, 0xee, 0xee};
+    mMBC->set("abcd", 4, "efgh", 4);
+    mMBC->finish();
+    mMBC.reset();
+
+    mMBC.reset(new MultifileBlobCache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries,
+                                      &mTempFile->path[0], MultifileReadMode::Mapped));
+    ASSERT_EQ(size_t(4), mMBC->get("abcd", 4, buf, 4));
+    ASSERT_EQ('e', buf[0]);
+
+    // Replace the value while it is mapped
+    mMBC->set("abcd", 4, "ijkl", 4);
+    ASSERT_EQ(size_t(4), mMBC->get("abcd", 4, buf, 4));
+    ASSERT_EQ('i', buf[0]);
+    ASSERT_EQ('l', buf[3]);
+
+    // The new value should also be on disk
+    mMBC->finish();
+    mMBC.reset();
+    mMBC.reset(new MultifileBlobCache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries,
+                                      &mTempFile->path[0], MultifileReadMode::Mapped));
+    ASSERT_EQ(size_t(4), mMBC->get("abcd", 4, buf, 4));
+    ASSERT_EQ('i', buf[0]);
+    ASSERT_EQ('l', buf[3]);
+}
+
+// Verify a partial write left behind by an interrupted process is cleaned up at init
+TEST_F(MultifileBlobCacheTest, LeftoverTempFileIsRemoved) {
+    mMBC->set("abcd", 4, "efgh", 4);
+    mMBC->finish();
+    mMBC.reset();
+
+    std::string cachePath = &mTempFile->path[0];
+    std::string tempPath = cachePath + ".multifile/1234" + kMultifileBlobCacheTempSuffix;
+    std::ofstream tempFile(tempPath);
+    tempFile << "partial";
+    tempFile.close();
+    ASSERT_EQ(getCacheEntries().size(), 2);
+
+    mMBC.reset(new MultifileBlobCache(kMaxKeySize, kMaxValueSize, kMaxTotalSize, kMaxTotalEntries,
+                                      &mTempFile->path[0]));
+    ASSERT_EQ(getCacheEntries().size(), 1);
+
+    unsigned char buf[4] = {0xee, 0xee, 0xee, 0xee};
+    ASSERT_EQ(size_t(4), mMBC->get("abcd", 4, buf, 4));
+    ASSERT_EQ('e', buf[0]);
+}
+
 } // namespace android
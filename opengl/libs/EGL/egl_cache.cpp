@@ -37,6 +37,9 @@ static const size_t kMaxMonolithicTotalSize = 2 * 1024 * 1024;
 // The time in seconds to wait before saving newly inserted monolithic cache entries.
 static const unsigned int kDeferredMonolithicSaveDelay = 4;
 
+// How full, as a percentage of its limit, the monolithic cache is left after evicting entries.
+static const uint32_t kDefaultMonolithicCleanWatermarkPercent = 50;
+
 // Multifile cache size limits
 constexpr uint32_t kMaxMultifileKeySize = 1 * 1024 * 1024;
 constexpr uint32_t kMaxMultifileValueSize = 8 * 1024 * 1024;
@@ -69,7 +72,12 @@ static EGLsizeiANDROID getBlob(const void* key, EGLsizeiANDROID keySize, void* v
 // egl_cache_t definition
 //
 egl_cache_t::egl_cache_t()
-      : mInitialized(false), mMultifileMode(false), mCacheByteLimit(kMaxMonolithicTotalSize) {}
+      : mInitialized(false),
+        mMultifileMode(false),
+        mCacheByteLimit(kMaxMonolithicTotalSize),
+        mMultifileReadMode(MultifileReadMode::HotCache),
+        mEvictionPolicy(BlobCache::EvictionPolicy::kLeastRecentlyUsed),
+        mCleanWatermarkPercent(kDefaultMonolithicCleanWatermarkPercent) {}
 
 egl_cache_t::~egl_cache_t() {}
 
@@ -263,13 +271,44 @@ void egl_cache_t::updateMode() {
         }
 
         ALOGV("Using multifile EGL blobcache limit of %zu bytes", mCacheByteLimit);
+
+        // Check whether entries should be served directly from shared mappings
+        bool mapped = base::GetBoolProperty("ro.egl.blobcache.multifile_mapped", false);
+        mapped = base::GetBoolProperty("debug.egl.blobcache.multifile_mapped", mapped);
+        mMultifileReadMode = mapped ? MultifileReadMode::Mapped : MultifileReadMode::HotCache;
+        ALOGV("Using %s reads for multifile EGL blobcache", mapped ? "mapped" : "hot cache");
+    } else {
+        // Check which entries the monolithic cache should evict, allowing a debug override
+        std::string policy = base::GetProperty("ro.egl.blobcache.eviction_policy", "");
+        policy = base::GetProperty("debug.egl.blobcache.eviction_policy", policy);
+        if (policy == "random") {
+            mEvictionPolicy = BlobCache::EvictionPolicy::kRandom;
+        } else if (policy == "lru") {
+            mEvictionPolicy = BlobCache::EvictionPolicy::kLeastRecentlyUsed;
+        } else if (policy == "cost_aware") {
+            mEvictionPolicy = BlobCache::EvictionPolicy::kCostAware;
+        } else if (!policy.empty()) {
+            ALOGW("Ignoring unknown EGL blobcache eviction policy %s", policy.c_str());
+        }
+
+        mCleanWatermarkPercent =
+                base::GetUintProperty<uint32_t>("ro.egl.blobcache.clean_watermark_percent",
+                                                kDefaultMonolithicCleanWatermarkPercent, 99);
+        mCleanWatermarkPercent =
+                base::GetUintProperty<uint32_t>("debug.egl.blobcache.clean_watermark_percent",
+                                                mCleanWatermarkPercent, 99);
+
+        ALOGV("Using %s eviction down to %u%% for monolithic EGL blobcache",
+              policy.empty() ? "default" : policy.c_str(), mCleanWatermarkPercent);
     }
 }
 
 BlobCache* egl_cache_t::getBlobCacheLocked() {
     if (mBlobCache == nullptr) {
         mBlobCache.reset(new FileBlobCache(kMaxMonolithicKeySize, kMaxMonolithicValueSize,
-                                           mCacheByteLimit, mFilename));
+                                           mCacheByteLimit, mEvictionPolicy,
+                                           mCacheByteLimit * mCleanWatermarkPercent / 100,
+                                           mFilename));
     }
     return mBlobCache.get();
 }
@@ -278,7 +317,8 @@ MultifileBlobCache* egl_cache_t::getMultifileBlobCacheLocked() {
     if (mMultifileBlobCache == nullptr) {
         mMultifileBlobCache.reset(new MultifileBlobCache(kMaxMultifileKeySize,
                                                          kMaxMultifileValueSize, mCacheByteLimit,
-                                                         kMaxMultifileTotalEntries, mFilename));
+                                                         kMaxMultifileTotalEntries, mFilename,
+                                                         mMultifileReadMode));
     }
     return mMultifileBlobCache.get();
 }
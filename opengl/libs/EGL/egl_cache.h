@@ -142,6 +142,16 @@ private:
 
     // Cache limit
     size_t mCacheByteLimit;
+
+    // How the multifile cache reads entries back from disk
+    MultifileReadMode mMultifileReadMode;
+
+    // Which entries the monolithic cache evicts when it fills up
+    BlobCache::EvictionPolicy mEvictionPolicy;
+
+    // How full, as a percentage of mCacheByteLimit, the monolithic cache is
+    // left after evicting entries
+    uint32_t mCleanWatermarkPercent;
 };
 
 }; // namespace android
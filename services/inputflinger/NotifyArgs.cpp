@@ -212,4 +212,99 @@ const char* toString(const NotifyArgs& args) {
     return std::visit(toStringVisitor, args);
 }
 
+// --- NotifyArgsBatch ---
+
+namespace {
+
+// The number of unused buffers kept for reuse by each thread. A thread rarely has more than a few
+// batches alive at once: the one being delivered, and the ones being filled by the mappers.
+constexpr size_t kMaxPooledBuffers = 16;
+// Buffers that grew beyond this are released rather than kept, so that a burst of events does not
+// pin memory for the lifetime of the thread.
+constexpr size_t kMaxPooledCapacity = 32;
+// Enough for a typical multi-touch frame without growing.
+constexpr size_t kInitialCapacity = 4;
+
+class NotifyArgsBufferPool {
+public:
+    std::vector<NotifyArgs> acquire() {
+        if (mBuffers.empty()) {
+            std::vector<NotifyArgs> buffer;
+            buffer.reserve(kInitialCapacity);
+            return buffer;
+        }
+        std::vector<NotifyArgs> buffer = std::move(mBuffers.back());
+        mBuffers.pop_back();
+        return buffer;
+    }
+
+    void release(std::vector<NotifyArgs>&& buffer) {
+        if (buffer.capacity() == 0 || buffer.capacity() > kMaxPooledCapacity ||
+            mBuffers.size() >= kMaxPooledBuffers) {
+            return;
+        }
+        buffer.clear();
+        mBuffers.push_back(std::move(buffer));
+    }
+
+private:
+    std::vector<std::vector<NotifyArgs>> mBuffers;
+};
+
+NotifyArgsBufferPool& getBufferPool() {
+    thread_local NotifyArgsBufferPool pool;
+    return pool;
+}
+
+} // namespace
+
+NotifyArgsBatch::NotifyArgsBatch() : mArgs(getBufferPool().acquire()) {}
+
+NotifyArgsBatch::NotifyArgsBatch(std::initializer_list<NotifyArgs> args) : NotifyArgsBatch() {
+    mArgs.insert(mArgs.end(), args);
+}
+
+NotifyArgsBatch::NotifyArgsBatch(const NotifyArgsBatch& other) : NotifyArgsBatch() {
+    mArgs.insert(mArgs.end(), other.mArgs.begin(), other.mArgs.end());
+}
+
+NotifyArgsBatch::NotifyArgsBatch(NotifyArgsBatch&& other) noexcept
+      : mArgs(std::move(other.mArgs)) {
+    other.mArgs.clear();
+}
+
+NotifyArgsBatch::~NotifyArgsBatch() {
+    getBufferPool().release(std::move(mArgs));
+}
+
+NotifyArgsBatch& NotifyArgsBatch::operator=(const NotifyArgsBatch& other) {
+    if (this != &other) {
+        mArgs.assign(other.mArgs.begin(), other.mArgs.end());
+    }
+    return *this;
+}
+
+NotifyArgsBatch& NotifyArgsBatch::operator=(NotifyArgsBatch&& other) noexcept {
+    if (this != &other) {
+        // Keep our buffer with the other batch, so that it is returned to the pool with it.
+        mArgs.clear();
+        mArgs.swap(other.mArgs);
+    }
+    return *this;
+}
+
+NotifyArgsBatch& NotifyArgsBatch::operator+=(NotifyArgsBatch&& other) {
+    if (mArgs.empty()) {
+        // Take over the other buffer rather than copying into ours. The larger of the two is kept.
+        if (other.mArgs.capacity() >= mArgs.capacity()) {
+            mArgs.swap(other.mArgs);
+            return *this;
+        }
+    }
+    mArgs.insert(mArgs.end(), std::make_move_iterator(other.mArgs.begin()),
+                 std::make_move_iterator(other.mArgs.end()));
+    other.mArgs.clear();
+    return *this;
+}
+
 } // namespace android
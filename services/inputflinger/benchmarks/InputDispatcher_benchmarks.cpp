@@ -196,11 +196,80 @@ static void benchmarkOnWindowInfosChanged(benchmark::State& state) {
     dispatcher.stop();
 }
 
+static void benchmarkNotifyMotionWithManyWindows(benchmark::State& state) {
+    // Create dispatcher
+    FakeInputDispatcherPolicy fakePolicy;
+    InputDispatcher dispatcher(fakePolicy);
+    dispatcher.setInputDispatchMode(/*enabled*/ true, /*frozen*/ false);
+    dispatcher.start();
+
+    // Cover the display with a grid of small windows that are not touched, followed by a spy
+    // window and a full-screen window at the bottom that receive the touch.
+    constexpr int32_t DISPLAY_WIDTH = 1080;
+    constexpr int32_t DISPLAY_HEIGHT = 2400;
+    constexpr int32_t CELL_SIZE = 50;
+    std::shared_ptr<FakeApplicationHandle> application = std::make_shared<FakeApplicationHandle>();
+    std::vector<sp<FakeWindowHandle>> windows;
+    std::vector<gui::WindowInfo> windowInfos;
+    const int32_t windowCount = static_cast<int32_t>(state.range(0));
+    for (int32_t i = 0; i < windowCount; i++) {
+        sp<FakeWindowHandle> window =
+                sp<FakeWindowHandle>::make(application, dispatcher,
+                                           "Small Window " + std::to_string(i), DISPLAY_ID);
+        // Leave the top-left corner of the display, where the touch happens, uncovered.
+        const int32_t column = i % (DISPLAY_WIDTH / CELL_SIZE - 4) + 4;
+        const int32_t row = (i / (DISPLAY_WIDTH / CELL_SIZE - 4)) % (DISPLAY_HEIGHT / CELL_SIZE);
+        window->setFrame(Rect(column * CELL_SIZE, row * CELL_SIZE, (column + 1) * CELL_SIZE,
+                              (row + 1) * CELL_SIZE));
+        windowInfos.push_back(*window->getInfo());
+        windows.push_back(window);
+    }
+    sp<FakeWindowHandle> spyWindow =
+            sp<FakeWindowHandle>::make(application, dispatcher, "Spy Window", DISPLAY_ID);
+    spyWindow->setFrame(Rect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT));
+    spyWindow->setSpy(true);
+    spyWindow->setTrustedOverlay(true);
+    windowInfos.push_back(*spyWindow->getInfo());
+    sp<FakeWindowHandle> window =
+            sp<FakeWindowHandle>::make(application, dispatcher, "Fake Window", DISPLAY_ID);
+    window->setFrame(Rect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT));
+    windowInfos.push_back(*window->getInfo());
+
+    gui::DisplayInfo info;
+    info.displayId = DISPLAY_ID;
+    info.logicalWidth = DISPLAY_WIDTH;
+    info.logicalHeight = DISPLAY_HEIGHT;
+    dispatcher.onWindowInfosChanged({windowInfos, {info}, /*vsyncId=*/0, /*timestamp=*/0});
+
+    NotifyMotionArgs motionArgs = generateMotionArgs();
+
+    for (auto _ : state) {
+        // Send ACTION_DOWN
+        motionArgs.action = AMOTION_EVENT_ACTION_DOWN;
+        motionArgs.downTime = now();
+        motionArgs.eventTime = motionArgs.downTime;
+        dispatcher.notifyMotion(motionArgs);
+
+        // Send ACTION_UP
+        motionArgs.action = AMOTION_EVENT_ACTION_UP;
+        motionArgs.eventTime = now();
+        dispatcher.notifyMotion(motionArgs);
+
+        spyWindow->consumeMotion();
+        spyWindow->consumeMotion();
+        window->consumeMotion();
+        window->consumeMotion();
+    }
+
+    dispatcher.stop();
+}
+
 } // namespace
 
 BENCHMARK(benchmarkNotifyMotion);
 BENCHMARK(benchmarkInjectMotion);
 BENCHMARK(benchmarkOnWindowInfosChanged);
+BENCHMARK(benchmarkNotifyMotionWithManyWindows)->Arg(10)->Arg(100)->Arg(500);
 
 } // namespace android::inputdispatcher
 
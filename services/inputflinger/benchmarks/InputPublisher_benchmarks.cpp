@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <android/os/IInputConstants.h>
+#include <attestation/HmacKeyManager.h>
+#include <input/InputTransport.h>
+
+using android::os::IInputConstants;
+
+namespace android {
+
+namespace {
+
+// An arbitrary device id.
+constexpr int32_t DEVICE_ID = 1;
+
+// Stylus events are reported at up to 480Hz, and each one may need to be published to several
+// windows. This is the number of motion events that are pending on a connection at once.
+constexpr int64_t MIN_PENDING_EVENTS = 1;
+constexpr int64_t MAX_PENDING_EVENTS = 16;
+
+struct ChannelPair {
+    std::shared_ptr<InputChannel> server;
+    std::unique_ptr<InputChannel> client;
+};
+
+ChannelPair openChannelPair() {
+    std::unique_ptr<InputChannel> serverChannel, clientChannel;
+    status_t result =
+            InputChannel::openInputChannelPair("benchmark channel", serverChannel, clientChannel);
+    LOG_ALWAYS_FATAL_IF(result != OK, "Could not open channel pair: %d", result);
+    return {std::move(serverChannel), std::move(clientChannel)};
+}
+
+status_t publishMotionEvent(InputPublisher& publisher, uint32_t seq, int32_t action,
+                            nsecs_t downTime, nsecs_t eventTime) {
+    PointerProperties pointerProperties[1];
+    PointerCoords pointerCoords[1];
+    pointerProperties[0].clear();
+    pointerProperties[0].id = 0;
+    pointerProperties[0].toolType = ToolType::STYLUS;
+    pointerCoords[0].clear();
+    pointerCoords[0].setAxisValue(AMOTION_EVENT_AXIS_X, 100);
+    pointerCoords[0].setAxisValue(AMOTION_EVENT_AXIS_Y, 100);
+    pointerCoords[0].setAxisValue(AMOTION_EVENT_AXIS_PRESSURE, 0.5);
+
+    ui::Transform identityTransform;
+    return publisher.publishMotionEvent(seq, IInputConstants::INVALID_INPUT_EVENT_ID, DEVICE_ID,
+                                        AINPUT_SOURCE_STYLUS, ADISPLAY_ID_DEFAULT, INVALID_HMAC,
+                                        action, /*actionButton=*/0,
+                                        /*flags=*/0, /*edgeFlags=*/0, AMETA_NONE,
+                                        /*buttonState=*/0, MotionClassification::NONE,
+                                        identityTransform, /*xPrecision=*/0, /*yPrecision=*/0,
+                                        AMOTION_EVENT_INVALID_CURSOR_POSITION,
+                                        AMOTION_EVENT_INVALID_CURSOR_POSITION, identityTransform,
+                                        downTime, eventTime, /*pointerCount=*/1,
+                                        pointerProperties, pointerCoords);
+}
+
+void drain(InputChannel& channel, int64_t count) {
+    InputMessage msg;
+    for (int64_t i = 0; i < count; i++) {
+        LOG_ALWAYS_FATAL_IF(channel.receiveMessage(&msg) != OK, "Could not receive message");
+    }
+}
+
+/**
+ * Publishes the DOWN that starts the stylus gesture whose MOVEs are benchmarked, so that the
+ * benchmark sends a consistent event stream.
+ */
+nsecs_t beginGesture(InputPublisher& publisher, InputChannel& client, uint32_t& seq) {
+    const nsecs_t downTime = systemTime(SYSTEM_TIME_MONOTONIC);
+    LOG_ALWAYS_FATAL_IF(publishMotionEvent(publisher, seq++, AMOTION_EVENT_ACTION_DOWN, downTime,
+                                           downTime) != OK,
+                        "Could not publish DOWN");
+    drain(client, 1);
+    return downTime;
+}
+
+void endGesture(InputPublisher& publisher, InputChannel& client, uint32_t& seq,
+                nsecs_t downTime) {
+    LOG_ALWAYS_FATAL_IF(publishMotionEvent(publisher, seq++, AMOTION_EVENT_ACTION_UP, downTime,
+                                           systemTime(SYSTEM_TIME_MONOTONIC)) != OK,
+                        "Could not publish UP");
+    drain(client, 1);
+}
+
+} // namespace
+
+static void benchmarkPublishMotionEvents(benchmark::State& state) {
+    ChannelPair channels = openChannelPair();
+    InputPublisher publisher(channels.server);
+    const int64_t pendingCount = state.range(0);
+
+    uint32_t seq = 1;
+    const nsecs_t downTime = beginGesture(publisher, *channels.client, seq);
+    for (auto _ : state) {
+        for (int64_t i = 0; i < pendingCount; i++) {
+            publishMotionEvent(publisher, seq++, AMOTION_EVENT_ACTION_MOVE, downTime,
+                               systemTime(SYSTEM_TIME_MONOTONIC));
+        }
+        state.PauseTiming();
+        drain(*channels.client, pendingCount);
+        state.ResumeTiming();
+    }
+    endGesture(publisher, *channels.client, seq, downTime);
+    state.SetItemsProcessed(state.iterations() * pendingCount);
+}
+
+static void benchmarkPublishMotionEventsBatched(benchmark::State& state) {
+    ChannelPair channels = openChannelPair();
+    InputPublisher publisher(channels.server);
+    const int64_t pendingCount = state.range(0);
+
+    uint32_t seq = 1;
+    const nsecs_t downTime = beginGesture(publisher, *channels.client, seq);
+    for (auto _ : state) {
+        publisher.beginBatch();
+        for (int64_t i = 0; i < pendingCount; i++) {
+            publishMotionEvent(publisher, seq++, AMOTION_EVENT_ACTION_MOVE, downTime,
+                               systemTime(SYSTEM_TIME_MONOTONIC));
+        }
+        size_t publishedCount;
+        LOG_ALWAYS_FATAL_IF(publisher.endBatch(publishedCount) != OK, "Could not publish batch");
+        state.PauseTiming();
+        drain(*channels.client, pendingCount);
+        state.ResumeTiming();
+    }
+    endGesture(publisher, *channels.client, seq, downTime);
+    state.SetItemsProcessed(state.iterations() * pendingCount);
+}
+
+BENCHMARK(benchmarkPublishMotionEvents)->RangeMultiplier(2)->Range(MIN_PENDING_EVENTS,
+                                                                    MAX_PENDING_EVENTS);
+BENCHMARK(benchmarkPublishMotionEventsBatched)
+        ->RangeMultiplier(2)
+        ->Range(MIN_PENDING_EVENTS, MAX_PENDING_EVENTS);
+
+} // namespace android
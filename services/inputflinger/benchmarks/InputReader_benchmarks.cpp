@@ -0,0 +1,228 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <InputReader.h>
+#include <linux/input-event-codes.h>
+#include "../dispatcher/InputDispatcher.h"
+#include "../tests/FakeApplicationHandle.h"
+#include "../tests/FakeEventHub.h"
+#include "../tests/FakeInputDispatcherPolicy.h"
+#include "../tests/FakeInputReaderPolicy.h"
+#include "../tests/FakeWindowHandle.h"
+
+namespace {
+
+// Allocations made by the whole process, and by the current thread. These are counted for every
+// benchmark in this binary, but only reported by the ones below.
+std::atomic<int64_t> gAllocationCount{0};
+thread_local int64_t tAllocationCount = 0;
+
+void* countedAllocate(size_t size) {
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    tAllocationCount++;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace android::inputdispatcher {
+
+namespace {
+
+// An arbitrary event hub device id.
+constexpr int32_t EVENTHUB_ID = 1;
+
+constexpr int32_t DISPLAY_ID = ADISPLAY_ID_DEFAULT;
+constexpr int32_t DISPLAY_WIDTH = 1080;
+constexpr int32_t DISPLAY_HEIGHT = 2400;
+
+// The number of frames in which every finger moves, between the frame where they all go down and
+// the frame where they are all lifted.
+constexpr int32_t MOVE_FRAMES = 8;
+
+// The reader thread loop, driven by the benchmark instead.
+class BenchmarkInputReader : public InputReader {
+public:
+    using InputReader::InputReader;
+    using InputReader::loopOnce;
+};
+
+// Lets every touch through to the windows, like the system policy does for an awake device.
+class PassToUserDispatcherPolicy : public FakeInputDispatcherPolicy {
+private:
+    void interceptMotionBeforeQueueing(int32_t, nsecs_t, uint32_t& policyFlags) override {
+        policyFlags |= POLICY_FLAG_PASS_TO_USER;
+    }
+};
+
+static nsecs_t now() {
+    return systemTime(SYSTEM_TIME_MONOTONIC);
+}
+
+static void addTouchscreen(FakeEventHub& eventHub, int32_t maxPointers) {
+    eventHub.addDevice(EVENTHUB_ID, "Benchmark Touchscreen",
+                       InputDeviceClass::TOUCH | InputDeviceClass::TOUCH_MT);
+    eventHub.addConfigurationProperty(EVENTHUB_ID, "touch.deviceType", "touchScreen");
+    eventHub.addAbsoluteAxis(EVENTHUB_ID, ABS_MT_POSITION_X, 0, DISPLAY_WIDTH - 1, 0, 0);
+    eventHub.addAbsoluteAxis(EVENTHUB_ID, ABS_MT_POSITION_Y, 0, DISPLAY_HEIGHT - 1, 0, 0);
+    eventHub.addAbsoluteAxis(EVENTHUB_ID, ABS_MT_TRACKING_ID, 0, 0xffff, 0, 0);
+    eventHub.addAbsoluteAxis(EVENTHUB_ID, ABS_MT_SLOT, 0, maxPointers - 1, 0, 0);
+    eventHub.setAbsoluteAxisValue(EVENTHUB_ID, ABS_MT_SLOT, 0);
+    eventHub.finishDeviceScan();
+}
+
+// Queues the raw events of one multi-touch frame, in which every pointer is down at the given
+// offset from its starting position, or is lifted.
+static void enqueueFrame(FakeEventHub& eventHub, int32_t pointerCount, int32_t offset,
+                         bool lifted) {
+    const nsecs_t when = now();
+    for (int32_t slot = 0; slot < pointerCount; slot++) {
+        eventHub.enqueueEvent(when, when, EVENTHUB_ID, EV_ABS, ABS_MT_SLOT, slot);
+        if (lifted) {
+            eventHub.enqueueEvent(when, when, EVENTHUB_ID, EV_ABS, ABS_MT_TRACKING_ID, -1);
+            continue;
+        }
+        if (offset == 0) {
+            eventHub.enqueueEvent(when, when, EVENTHUB_ID, EV_ABS, ABS_MT_TRACKING_ID, slot);
+        }
+        eventHub.enqueueEvent(when, when, EVENTHUB_ID, EV_ABS, ABS_MT_POSITION_X,
+                              100 + slot * 80 + offset);
+        eventHub.enqueueEvent(when, when, EVENTHUB_ID, EV_ABS, ABS_MT_POSITION_Y, 100 + offset);
+    }
+    eventHub.enqueueEvent(when, when, EVENTHUB_ID, EV_SYN, SYN_REPORT, 0);
+}
+
+static bool isUp(const InputEvent& event) {
+    return event.getType() == InputEventType::MOTION &&
+            MotionEvent::getActionMasked(static_cast<const MotionEvent&>(event).getAction()) ==
+            AMOTION_EVENT_ACTION_UP;
+}
+
+// A multi-touch gesture read from the event hub by the reader, dispatched by the dispatcher, and
+// received by a window. Every iteration is one gesture: all pointers go down in one frame, move
+// for a number of frames, and are lifted in one frame. Reports the time and the allocations per
+// motion event delivered by the reader, both for the reader thread alone and end to end.
+static void benchmarkReadAndDispatchMultiTouch(benchmark::State& state) {
+    const auto pointerCount = static_cast<int32_t>(state.range(0));
+
+    PassToUserDispatcherPolicy dispatcherPolicy;
+    InputDispatcher dispatcher(dispatcherPolicy);
+    dispatcher.setInputDispatchMode(/*enabled*/ true, /*frozen*/ false);
+    dispatcher.start();
+
+    std::shared_ptr<FakeApplicationHandle> application = std::make_shared<FakeApplicationHandle>();
+    sp<FakeWindowHandle> window =
+            sp<FakeWindowHandle>::make(application, dispatcher, "Fake Window", DISPLAY_ID);
+    window->setFrame(Rect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT));
+    gui::DisplayInfo displayInfo;
+    displayInfo.displayId = DISPLAY_ID;
+    displayInfo.logicalWidth = DISPLAY_WIDTH;
+    displayInfo.logicalHeight = DISPLAY_HEIGHT;
+    dispatcher.onWindowInfosChanged(
+            {{*window->getInfo()}, {displayInfo}, /*vsyncId=*/0, /*timestamp=*/0});
+
+    std::shared_ptr<FakeEventHub> eventHub = std::make_shared<FakeEventHub>();
+    sp<FakeInputReaderPolicy> readerPolicy = sp<FakeInputReaderPolicy>::make();
+    readerPolicy->addDisplayViewport(DISPLAY_ID, DISPLAY_WIDTH, DISPLAY_HEIGHT, ui::ROTATION_0,
+                                     /*isActive=*/true, "local:0", /*physicalPort=*/std::nullopt,
+                                     ViewportType::INTERNAL);
+    BenchmarkInputReader reader(eventHub, readerPolicy, dispatcher);
+    addTouchscreen(*eventHub, pointerCount);
+    reader.loopOnce();
+    reader.loopOnce();
+
+    // DOWN and a POINTER_DOWN for every other pointer, the moves, and then the reverse.
+    const int64_t eventsPerGesture = 2 * pointerCount + MOVE_FRAMES;
+    int64_t readerAllocations = 0;
+    const int64_t startAllocations = gAllocationCount.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        for (int32_t frame = 0; frame <= MOVE_FRAMES + 1; frame++) {
+            enqueueFrame(*eventHub, pointerCount, frame, /*lifted=*/frame == MOVE_FRAMES + 1);
+            const int64_t threadAllocations = tAllocationCount;
+            reader.loopOnce();
+            readerAllocations += tAllocationCount - threadAllocations;
+        }
+
+        // Moves may be batched by the window's consumer, so wait for the end of the gesture rather
+        // than counting events.
+        for (;;) {
+            std::unique_ptr<InputEvent> event = window->consume(100ms);
+            if (event == nullptr) {
+                state.SkipWithError("The window did not receive the whole gesture");
+                break;
+            }
+            if (isUp(*event)) {
+                break;
+            }
+        }
+    }
+    const int64_t allocations = gAllocationCount.load(std::memory_order_relaxed) - startAllocations;
+
+    const int64_t events = state.iterations() * eventsPerGesture;
+    state.SetItemsProcessed(events);
+    if (events > 0) {
+        state.counters["reader_allocs_per_event"] =
+                static_cast<double>(readerAllocations) / static_cast<double>(events);
+        state.counters["allocs_per_event"] =
+                static_cast<double>(allocations) / static_cast<double>(events);
+    }
+
+    dispatcher.stop();
+}
+
+} // namespace
+
+BENCHMARK(benchmarkReadAndDispatchMultiTouch)
+        ->ArgName("pointers")
+        ->Arg(1)
+        ->Arg(2)
+        ->Arg(5)
+        ->Arg(10);
+
+} // namespace android::inputdispatcher
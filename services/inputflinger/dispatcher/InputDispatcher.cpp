@@ -1292,7 +1292,8 @@ sp<WindowInfoHandle> InputDispatcher::findTouchedWindowAtLocked(int32_t displayI
                                                                 bool ignoreDragWindow) const {
     // Traverse windows from front to back to find touched window.
     const auto& windowHandles = getWindowHandlesLocked(displayId);
-    for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
+    for (size_t i : getWindowHitIndexLocked(displayId).touchCandidatesAt(x, y)) {
+        const sp<WindowInfoHandle>& windowHandle = windowHandles[i];
         if (ignoreDragWindow && haveSameToken(windowHandle, mDragState->dragWindow)) {
             continue;
         }
@@ -1314,21 +1315,21 @@ std::vector<InputTarget> InputDispatcher::findOutsideTargetsLocked(
     // Traverse windows from front to back until we encounter the touched window.
     std::vector<InputTarget> outsideTargets;
     const auto& windowHandles = getWindowHandlesLocked(displayId);
-    for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
-        if (windowHandle == touchedWindow) {
+    const WindowHitIndex& hitIndex = getWindowHitIndexLocked(displayId);
+    const size_t touchedWindowIndex =
+            hitIndex.indexOf(touchedWindow).value_or(windowHandles.size());
+    for (size_t i : hitIndex.watchOutsideTouchWindows()) {
+        if (i >= touchedWindowIndex) {
             // Stop iterating once we found a touched window. Any WATCH_OUTSIDE_TOUCH window
             // below the touched window will not get ACTION_OUTSIDE event.
             return outsideTargets;
         }
 
-        const WindowInfo& info = *windowHandle->getInfo();
-        if (info.inputConfig.test(WindowInfo::InputConfig::WATCH_OUTSIDE_TOUCH)) {
-            std::bitset<MAX_POINTER_ID + 1> pointerIds;
-            pointerIds.set(pointerId);
-            addPointerWindowTargetLocked(windowHandle, InputTarget::DispatchMode::OUTSIDE,
-                                         ftl::Flags<InputTarget::Flags>(), pointerIds,
-                                         /*firstDownTimeInTarget=*/std::nullopt, outsideTargets);
-        }
+        std::bitset<MAX_POINTER_ID + 1> pointerIds;
+        pointerIds.set(pointerId);
+        addPointerWindowTargetLocked(windowHandles[i], InputTarget::DispatchMode::OUTSIDE,
+                                     ftl::Flags<InputTarget::Flags>(), pointerIds,
+                                     /*firstDownTimeInTarget=*/std::nullopt, outsideTargets);
     }
     return outsideTargets;
 }
@@ -1338,7 +1339,8 @@ std::vector<sp<WindowInfoHandle>> InputDispatcher::findTouchedSpyWindowsAtLocked
     // Traverse windows from front to back and gather the touched spy windows.
     std::vector<sp<WindowInfoHandle>> spyWindows;
     const auto& windowHandles = getWindowHandlesLocked(displayId);
-    for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
+    for (size_t i : getWindowHitIndexLocked(displayId).touchCandidatesAt(x, y)) {
+        const sp<WindowInfoHandle>& windowHandle = windowHandles[i];
         const WindowInfo& info = *windowHandle->getInfo();
 
         if (!windowAcceptsTouchAt(info, displayId, x, y, isStylus, getTransformLocked(displayId))) {
@@ -3026,10 +3028,13 @@ InputDispatcher::TouchOcclusionInfo InputDispatcher::computeTouchOcclusionInfoLo
     info.obscuringOpacity = 0;
     info.obscuringUid = gui::Uid::INVALID;
     std::map<gui::Uid, float> opacityByUid;
-    for (const sp<WindowInfoHandle>& otherHandle : windowHandles) {
-        if (windowHandle == otherHandle) {
+    const WindowHitIndex& hitIndex = getWindowHitIndexLocked(displayId);
+    const size_t windowIndex = hitIndex.indexOf(windowHandle).value_or(windowHandles.size());
+    for (size_t i : hitIndex.frameCandidatesAt(x, y)) {
+        if (i >= windowIndex) {
             break; // All future windows are below us. Exit early.
         }
+        const sp<WindowInfoHandle>& otherHandle = windowHandles[i];
         const WindowInfo* otherInfo = otherHandle->getInfo();
         if (canBeObscuredBy(windowHandle, otherHandle) && otherInfo->frameContainsPoint(x, y) &&
             !haveSameApplicationToken(windowInfo, otherInfo)) {
@@ -3104,10 +3109,13 @@ bool InputDispatcher::isWindowObscuredAtPointLocked(const sp<WindowInfoHandle>&
                                                     int32_t x, int32_t y) const {
     int32_t displayId = windowHandle->getInfo()->displayId;
     const std::vector<sp<WindowInfoHandle>>& windowHandles = getWindowHandlesLocked(displayId);
-    for (const sp<WindowInfoHandle>& otherHandle : windowHandles) {
-        if (windowHandle == otherHandle) {
+    const WindowHitIndex& hitIndex = getWindowHitIndexLocked(displayId);
+    const size_t windowIndex = hitIndex.indexOf(windowHandle).value_or(windowHandles.size());
+    for (size_t i : hitIndex.frameCandidatesAt(x, y)) {
+        if (i >= windowIndex) {
             break; // All future windows are below us. Exit early.
         }
+        const sp<WindowInfoHandle>& otherHandle = windowHandles[i];
         const WindowInfo* otherInfo = otherHandle->getInfo();
         if (canBeObscuredBy(windowHandle, otherHandle) &&
             otherInfo->frameContainsPoint(x, y)) {
@@ -3628,6 +3636,72 @@ status_t InputDispatcher::publishMotionEvent(Connection& connection,
                                 motionEntry.pointerProperties.data(), usingCoords);
 }
 
+status_t InputDispatcher::publishDispatchEntry(Connection& connection,
+                                               DispatchEntry& dispatchEntry) const {
+    const EventEntry& eventEntry = *(dispatchEntry.eventEntry);
+    switch (eventEntry.type) {
+        case EventEntry::Type::KEY: {
+            const KeyEntry& keyEntry = static_cast<const KeyEntry&>(eventEntry);
+            std::array<uint8_t, 32> hmac = getSignature(keyEntry, dispatchEntry);
+            if (DEBUG_OUTBOUND_EVENT_DETAILS) {
+                LOG(INFO) << "Publishing " << dispatchEntry << " to "
+                          << connection.getInputChannelName();
+            }
+
+            // Publish the key event.
+            return connection.inputPublisher
+                    .publishKeyEvent(dispatchEntry.seq, keyEntry.id, keyEntry.deviceId,
+                                     keyEntry.source, keyEntry.displayId, std::move(hmac),
+                                     keyEntry.action, dispatchEntry.resolvedFlags,
+                                     keyEntry.keyCode, keyEntry.scanCode, keyEntry.metaState,
+                                     keyEntry.repeatCount, keyEntry.downTime, keyEntry.eventTime);
+        }
+
+        case EventEntry::Type::MOTION: {
+            if (DEBUG_OUTBOUND_EVENT_DETAILS) {
+                LOG(INFO) << "Publishing " << dispatchEntry << " to "
+                          << connection.getInputChannelName();
+            }
+            return publishMotionEvent(connection, dispatchEntry);
+        }
+
+        case EventEntry::Type::FOCUS: {
+            const FocusEntry& focusEntry = static_cast<const FocusEntry&>(eventEntry);
+            return connection.inputPublisher.publishFocusEvent(dispatchEntry.seq, focusEntry.id,
+                                                               focusEntry.hasFocus);
+        }
+
+        case EventEntry::Type::TOUCH_MODE_CHANGED: {
+            const TouchModeEntry& touchModeEntry = static_cast<const TouchModeEntry&>(eventEntry);
+            return connection.inputPublisher.publishTouchModeEvent(dispatchEntry.seq,
+                                                                   touchModeEntry.id,
+                                                                   touchModeEntry.inTouchMode);
+        }
+
+        case EventEntry::Type::POINTER_CAPTURE_CHANGED: {
+            const auto& captureEntry = static_cast<const PointerCaptureChangedEntry&>(eventEntry);
+            return connection.inputPublisher
+                    .publishCaptureEvent(dispatchEntry.seq, captureEntry.id,
+                                         captureEntry.pointerCaptureRequest.enable);
+        }
+
+        case EventEntry::Type::DRAG: {
+            const DragEntry& dragEntry = static_cast<const DragEntry&>(eventEntry);
+            return connection.inputPublisher.publishDragEvent(dispatchEntry.seq, dragEntry.id,
+                                                              dragEntry.x, dragEntry.y,
+                                                              dragEntry.isExiting);
+        }
+
+        case EventEntry::Type::CONFIGURATION_CHANGED:
+        case EventEntry::Type::DEVICE_RESET:
+        case EventEntry::Type::SENSOR: {
+            LOG_ALWAYS_FATAL("Should never start dispatch cycles for %s events",
+                             ftl::enum_string(eventEntry.type).c_str());
+            return INVALID_OPERATION;
+        }
+    }
+}
+
 void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
                                                const std::shared_ptr<Connection>& connection) {
     ATRACE_NAME_IF(ATRACE_ENABLED(),
@@ -3638,87 +3712,51 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
     }
 
     while (connection->status == Connection::Status::NORMAL && !connection->outboundQueue.empty()) {
-        std::unique_ptr<DispatchEntry>& dispatchEntry = connection->outboundQueue.front();
-        dispatchEntry->deliveryTime = currentTime;
-        const std::chrono::nanoseconds timeout = getDispatchingTimeoutLocked(connection);
-        dispatchEntry->timeoutTime = currentTime + timeout.count();
-
-        // Publish the event.
-        status_t status;
-        const EventEntry& eventEntry = *(dispatchEntry->eventEntry);
-        switch (eventEntry.type) {
-            case EventEntry::Type::KEY: {
-                const KeyEntry& keyEntry = static_cast<const KeyEntry&>(eventEntry);
-                std::array<uint8_t, 32> hmac = getSignature(keyEntry, *dispatchEntry);
-                if (DEBUG_OUTBOUND_EVENT_DETAILS) {
-                    LOG(INFO) << "Publishing " << *dispatchEntry << " to "
-                              << connection->getInputChannelName();
-                }
-
-                // Publish the key event.
-                status = connection->inputPublisher
-                                 .publishKeyEvent(dispatchEntry->seq, keyEntry.id,
-                                                  keyEntry.deviceId, keyEntry.source,
-                                                  keyEntry.displayId, std::move(hmac),
-                                                  keyEntry.action, dispatchEntry->resolvedFlags,
-                                                  keyEntry.keyCode, keyEntry.scanCode,
-                                                  keyEntry.metaState, keyEntry.repeatCount,
-                                                  keyEntry.downTime, keyEntry.eventTime);
-                break;
-            }
-
-            case EventEntry::Type::MOTION: {
-                if (DEBUG_OUTBOUND_EVENT_DETAILS) {
-                    LOG(INFO) << "Publishing " << *dispatchEntry << " to "
-                              << connection->getInputChannelName();
-                }
-                status = publishMotionEvent(*connection, *dispatchEntry);
-                break;
-            }
-
-            case EventEntry::Type::FOCUS: {
-                const FocusEntry& focusEntry = static_cast<const FocusEntry&>(eventEntry);
-                status = connection->inputPublisher.publishFocusEvent(dispatchEntry->seq,
-                                                                      focusEntry.id,
-                                                                      focusEntry.hasFocus);
-                break;
-            }
-
-            case EventEntry::Type::TOUCH_MODE_CHANGED: {
-                const TouchModeEntry& touchModeEntry =
-                        static_cast<const TouchModeEntry&>(eventEntry);
-                status = connection->inputPublisher
-                                 .publishTouchModeEvent(dispatchEntry->seq, touchModeEntry.id,
-                                                        touchModeEntry.inTouchMode);
-
-                break;
-            }
+        // When several events are pending, publish them as a single batch so that they are written
+        // to the channel with one system call.
+        const size_t pendingCount = connection->outboundQueue.size();
+        const bool batch = pendingCount > 1;
+        if (batch) {
+            connection->inputPublisher.beginBatch();
+        }
 
-            case EventEntry::Type::POINTER_CAPTURE_CHANGED: {
-                const auto& captureEntry =
-                        static_cast<const PointerCaptureChangedEntry&>(eventEntry);
-                status = connection->inputPublisher
-                                 .publishCaptureEvent(dispatchEntry->seq, captureEntry.id,
-                                                      captureEntry.pointerCaptureRequest.enable);
+        const std::chrono::nanoseconds timeout = getDispatchingTimeoutLocked(connection);
+        status_t status = OK;
+        size_t publishedCount = 0;
+        while (publishedCount < pendingCount) {
+            DispatchEntry& dispatchEntry = *connection->outboundQueue[publishedCount];
+            dispatchEntry.deliveryTime = currentTime;
+            dispatchEntry.timeoutTime = currentTime + timeout.count();
+
+            // Publish the event.
+            status = publishDispatchEntry(*connection, dispatchEntry);
+            if (status) {
                 break;
             }
+            publishedCount++;
+        }
 
-            case EventEntry::Type::DRAG: {
-                const DragEntry& dragEntry = static_cast<const DragEntry&>(eventEntry);
-                status = connection->inputPublisher.publishDragEvent(dispatchEntry->seq,
-                                                                     dragEntry.id, dragEntry.x,
-                                                                     dragEntry.y,
-                                                                     dragEntry.isExiting);
-                break;
+        if (batch) {
+            // Only the events that actually made it into the channel have been published.
+            size_t sentCount;
+            const status_t batchStatus = connection->inputPublisher.endBatch(sentCount);
+            if (batchStatus) {
+                status = batchStatus;
             }
+            publishedCount = sentCount;
+        }
 
-            case EventEntry::Type::CONFIGURATION_CHANGED:
-            case EventEntry::Type::DEVICE_RESET:
-            case EventEntry::Type::SENSOR: {
-                LOG_ALWAYS_FATAL("Should never start dispatch cycles for %s events",
-                                 ftl::enum_string(eventEntry.type).c_str());
-                return;
+        // Re-enqueue the published events on the wait queue.
+        for (size_t i = 0; i < publishedCount; i++) {
+            std::unique_ptr<DispatchEntry>& dispatchEntry = connection->outboundQueue.front();
+            const nsecs_t timeoutTime = dispatchEntry->timeoutTime;
+            connection->waitQueue.emplace_back(std::move(dispatchEntry));
+            connection->outboundQueue.erase(connection->outboundQueue.begin());
+            traceOutboundQueueLength(*connection);
+            if (connection->responsive) {
+                mAnrTracker.insert(timeoutTime, connection->inputChannel->getConnectionToken());
             }
+            traceWaitQueueLength(*connection);
         }
 
         // Check the result.
@@ -3750,16 +3788,6 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
             }
             return;
         }
-
-        // Re-enqueue the event on the wait queue.
-        const nsecs_t timeoutTime = dispatchEntry->timeoutTime;
-        connection->waitQueue.emplace_back(std::move(dispatchEntry));
-        connection->outboundQueue.erase(connection->outboundQueue.begin());
-        traceOutboundQueueLength(*connection);
-        if (connection->responsive) {
-            mAnrTracker.insert(timeoutTime, connection->inputChannel->getConnectionToken());
-        }
-        traceWaitQueueLength(*connection);
     }
 }
 
@@ -4941,6 +4969,12 @@ const std::vector<sp<WindowInfoHandle>>& InputDispatcher::getWindowHandlesLocked
     return it != mWindowHandlesByDisplay.end() ? it->second : EMPTY_WINDOW_HANDLES;
 }
 
+const WindowHitIndex& InputDispatcher::getWindowHitIndexLocked(int32_t displayId) const {
+    static const WindowHitIndex EMPTY_WINDOW_HIT_INDEX;
+    auto it = mWindowHitIndexByDisplay.find(displayId);
+    return it != mWindowHitIndexByDisplay.end() ? it->second : EMPTY_WINDOW_HIT_INDEX;
+}
+
 sp<WindowInfoHandle> InputDispatcher::getWindowHandleLocked(
         const sp<IBinder>& windowHandleToken, std::optional<int32_t> displayId) const {
     if (windowHandleToken == nullptr) {
@@ -5069,6 +5103,7 @@ void InputDispatcher::updateWindowHandlesForDisplayLocked(
     if (windowInfoHandles.empty()) {
         // Remove all handles on a display if there are no windows left.
         mWindowHandlesByDisplay.erase(displayId);
+        mWindowHitIndexByDisplay.erase(displayId);
         return;
     }
 
@@ -5114,6 +5149,14 @@ void InputDispatcher::updateWindowHandlesForDisplayLocked(
 
     // Insert or replace
     mWindowHandlesByDisplay[displayId] = newHandles;
+
+    std::optional<Rect> logicalDisplayBounds;
+    if (const auto it = mDisplayInfos.find(displayId); it != mDisplayInfos.end()) {
+        logicalDisplayBounds = Rect(it->second.logicalWidth, it->second.logicalHeight);
+    }
+    mWindowHitIndexByDisplay[displayId] =
+            WindowHitIndex(mWindowHandlesByDisplay[displayId], getTransformLocked(displayId),
+                           logicalDisplayBounds);
 }
 
 /**
@@ -32,6 +32,7 @@
 #include "Monitor.h"
 #include "TouchState.h"
 #include "TouchedWindow.h"
+#include "WindowHitIndex.h"
 
 #include <attestation/HmacKeyManager.h>
 #include <gui/InputApplication.h>
@@ -350,6 +351,9 @@ private:
             mWindowHandlesByDisplay GUARDED_BY(mLock);
     std::unordered_map<int32_t /*displayId*/, android::gui::DisplayInfo> mDisplayInfos
             GUARDED_BY(mLock);
+    // Spatial index over mWindowHandlesByDisplay, used to speed up touch hit-testing.
+    std::unordered_map<int32_t /*displayId*/, WindowHitIndex> mWindowHitIndexByDisplay
+            GUARDED_BY(mLock);
     void setInputWindowsLocked(
             const std::vector<sp<android::gui::WindowInfoHandle>>& inputWindowHandles,
             int32_t displayId) REQUIRES(mLock);
@@ -357,6 +361,8 @@ private:
     const std::vector<sp<android::gui::WindowInfoHandle>>& getWindowHandlesLocked(
             int32_t displayId) const REQUIRES(mLock);
     ui::Transform getTransformLocked(int32_t displayId) const REQUIRES(mLock);
+    // Get the spatial index for the windows on the display, return an empty index if not found.
+    const WindowHitIndex& getWindowHitIndexLocked(int32_t displayId) const REQUIRES(mLock);
 
     sp<android::gui::WindowInfoHandle> getWindowHandleLocked(
             const sp<IBinder>& windowHandleToken, std::optional<int32_t> displayId = {}) const
@@ -592,6 +598,7 @@ private:
                                     std::shared_ptr<const EventEntry>,
                                     const InputTarget& inputTarget) REQUIRES(mLock);
     status_t publishMotionEvent(Connection& connection, DispatchEntry& dispatchEntry) const;
+    status_t publishDispatchEntry(Connection& connection, DispatchEntry& dispatchEntry) const;
     void startDispatchCycleLocked(nsecs_t currentTime,
                                   const std::shared_ptr<Connection>& connection) REQUIRES(mLock);
     void finishDispatchCycleLocked(nsecs_t currentTime,
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WindowHitIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+using android::gui::WindowInfo;
+using android::gui::WindowInfoHandle;
+
+namespace android::inputdispatcher {
+
+namespace {
+
+bool containsPoint(const Rect& r, int32_t x, int32_t y) {
+    return x >= r.left && x < r.right && y >= r.top && y < r.bottom;
+}
+
+bool containsRect(const Rect& outer, const Rect& inner) {
+    return inner.left >= outer.left && inner.top >= outer.top && inner.right <= outer.right &&
+            inner.bottom <= outer.bottom;
+}
+
+Rect unionOf(const Rect& a, const Rect& b) {
+    return Rect(std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right),
+                std::max(a.bottom, b.bottom));
+}
+
+// Returns true if the window could receive a touch for some combination of pointer tool types.
+bool mayAcceptTouches(const WindowInfo& info) {
+    if (info.inputConfig.test(WindowInfo::InputConfig::NOT_VISIBLE)) {
+        return false;
+    }
+    return !info.inputConfig.test(WindowInfo::InputConfig::NOT_TOUCHABLE) ||
+            info.interceptsStylus();
+}
+
+} // namespace
+
+// --- WindowHitIndex::Grid ---
+
+void WindowHitIndex::Grid::build(const std::vector<std::optional<Rect>>& boundsByIndex,
+                                 std::optional<Rect> clip) {
+    mExtent = Rect::EMPTY_RECT;
+    mColumns = 0;
+    mRows = 0;
+    mCells.clear();
+    mOutside.clear();
+
+    std::optional<Rect> extent;
+    for (const std::optional<Rect>& bounds : boundsByIndex) {
+        if (bounds) {
+            extent = extent ? unionOf(*extent, *bounds) : *bounds;
+        }
+    }
+    if (extent && clip) {
+        Rect clipped;
+        if (extent->intersect(*clip, &clipped)) {
+            extent = clipped;
+        } else {
+            extent.reset();
+        }
+    }
+
+    for (size_t i = 0; i < boundsByIndex.size(); i++) {
+        const std::optional<Rect>& bounds = boundsByIndex[i];
+        if (bounds && (!extent || !containsRect(*extent, *bounds))) {
+            mOutside.push_back(i);
+        }
+    }
+    if (!extent) {
+        return;
+    }
+
+    mExtent = *extent;
+    const int64_t width = int64_t(mExtent.right) - mExtent.left;
+    const int64_t height = int64_t(mExtent.bottom) - mExtent.top;
+    mColumns = static_cast<int32_t>(std::min<int64_t>(MAX_CELLS_PER_AXIS, width));
+    mRows = static_cast<int32_t>(std::min<int64_t>(MAX_CELLS_PER_AXIS, height));
+    mCells.resize(mColumns * mRows);
+
+    for (size_t i = 0; i < boundsByIndex.size(); i++) {
+        Rect clipped;
+        if (!boundsByIndex[i] || !boundsByIndex[i]->intersect(mExtent, &clipped)) {
+            continue;
+        }
+        const int32_t firstColumn = columnFor(clipped.left);
+        const int32_t lastColumn = columnFor(clipped.right - 1);
+        const int32_t firstRow = rowFor(clipped.top);
+        const int32_t lastRow = rowFor(clipped.bottom - 1);
+        for (int32_t row = firstRow; row <= lastRow; row++) {
+            for (int32_t column = firstColumn; column <= lastColumn; column++) {
+                // Indices are visited in ascending order, so every cell stays sorted by z-order.
+                mCells[row * mColumns + column].push_back(i);
+            }
+        }
+    }
+}
+
+const std::vector<size_t>& WindowHitIndex::Grid::at(int32_t x, int32_t y) const {
+    if (mCells.empty() || !containsPoint(mExtent, x, y)) {
+        return mOutside;
+    }
+    return mCells[rowFor(y) * mColumns + columnFor(x)];
+}
+
+int32_t WindowHitIndex::Grid::columnFor(int32_t x) const {
+    const int64_t width = int64_t(mExtent.right) - mExtent.left;
+    return static_cast<int32_t>((int64_t(x) - mExtent.left) * mColumns / width);
+}
+
+int32_t WindowHitIndex::Grid::rowFor(int32_t y) const {
+    const int64_t height = int64_t(mExtent.bottom) - mExtent.top;
+    return static_cast<int32_t>((int64_t(y) - mExtent.top) * mRows / height);
+}
+
+// --- WindowHitIndex ---
+
+WindowHitIndex::WindowHitIndex(const std::vector<sp<WindowInfoHandle>>& windowHandles,
+                               const ui::Transform& displayTransform,
+                               std::optional<Rect> logicalDisplayBounds)
+      : mDisplayTransform(displayTransform) {
+    std::vector<std::optional<Rect>> touchableBounds(windowHandles.size());
+    std::vector<std::optional<Rect>> frameBounds(windowHandles.size());
+    mIndexByHandle.reserve(windowHandles.size());
+
+    for (size_t i = 0; i < windowHandles.size(); i++) {
+        const WindowInfo& info = *windowHandles[i]->getInfo();
+        mIndexByHandle.emplace(windowHandles[i].get(), i);
+
+        if (info.inputConfig.test(WindowInfo::InputConfig::WATCH_OUTSIDE_TOUCH)) {
+            mWatchOutsideTouch.push_back(i);
+        }
+        // Touches are hit-tested in the logical display space, so index the touchable regions in
+        // that space as well.
+        if (mayAcceptTouches(info) && !info.touchableRegion.isEmpty()) {
+            const Rect bounds = mDisplayTransform.transform(info.touchableRegion).getBounds();
+            if (!bounds.isEmpty()) {
+                touchableBounds[i] = bounds;
+            }
+        }
+        // Invisible windows never obscure other windows.
+        if (!info.inputConfig.test(WindowInfo::InputConfig::NOT_VISIBLE) &&
+            !info.frame.isEmpty()) {
+            frameBounds[i] = info.frame;
+        }
+    }
+
+    std::optional<Rect> displayBounds;
+    if (logicalDisplayBounds) {
+        displayBounds = mDisplayTransform.inverse().transform(*logicalDisplayBounds);
+    }
+    mTouchableGrid.build(touchableBounds, logicalDisplayBounds);
+    mFrameGrid.build(frameBounds, displayBounds);
+}
+
+const std::vector<size_t>& WindowHitIndex::touchCandidatesAt(float x, float y) const {
+    const vec2 p = mDisplayTransform.transform(x, y);
+    return mTouchableGrid.at(static_cast<int32_t>(std::floor(p.x)),
+                             static_cast<int32_t>(std::floor(p.y)));
+}
+
+const std::vector<size_t>& WindowHitIndex::frameCandidatesAt(int32_t x, int32_t y) const {
+    return mFrameGrid.at(x, y);
+}
+
+std::optional<size_t> WindowHitIndex::indexOf(const sp<WindowInfoHandle>& windowHandle) const {
+    auto it = mIndexByHandle.find(windowHandle.get());
+    if (it == mIndexByHandle.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+} // namespace android::inputdispatcher
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <gui/WindowInfo.h>
+#include <ui/Rect.h>
+#include <ui/Transform.h>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace android::inputdispatcher {
+
+/**
+ * Spatial index over the input windows of a single display.
+ *
+ * The index does not decide whether a window is hit. It only narrows down the set of windows that
+ * need to be checked for a given point, so that hit-testing does not have to walk every window on
+ * the display. Candidates are returned as indices into the window handle list the index was built
+ * from, in ascending order, which preserves the front-to-back z-order of that list. Callers must
+ * still perform the exact checks (touchable region, input config, etc.) on every candidate.
+ *
+ * The index must be rebuilt whenever the window list or the display transform changes.
+ */
+class WindowHitIndex {
+public:
+    WindowHitIndex() = default;
+    /**
+     * Build the index for the given windows, ordered front to back. 'displayTransform' takes
+     * display coordinates to logical display coordinates, and 'logicalDisplayBounds' is the size of
+     * the logical display, if known.
+     */
+    WindowHitIndex(const std::vector<sp<gui::WindowInfoHandle>>& windowHandles,
+                   const ui::Transform& displayTransform,
+                   std::optional<Rect> logicalDisplayBounds);
+
+    // Windows whose touchable region may contain the given point, in display coordinates.
+    const std::vector<size_t>& touchCandidatesAt(float x, float y) const;
+    // Windows whose frame may contain the given point, in display coordinates.
+    const std::vector<size_t>& frameCandidatesAt(int32_t x, int32_t y) const;
+    // Windows that have requested ACTION_OUTSIDE events.
+    const std::vector<size_t>& watchOutsideTouchWindows() const { return mWatchOutsideTouch; }
+    // Position of the given handle in the window list, or std::nullopt if it is not on the display.
+    std::optional<size_t> indexOf(const sp<gui::WindowInfoHandle>& windowHandle) const;
+
+private:
+    /**
+     * Uniform grid of cells over a bounded extent. Every cell holds the sorted indices of the
+     * windows whose bounds intersect it. Points outside of the extent only need to consider the
+     * windows whose bounds were clipped when building the grid.
+     */
+    class Grid {
+    public:
+        void build(const std::vector<std::optional<Rect>>& boundsByIndex,
+                   std::optional<Rect> clip);
+        const std::vector<size_t>& at(int32_t x, int32_t y) const;
+
+    private:
+        static constexpr int32_t MAX_CELLS_PER_AXIS = 16;
+
+        Rect mExtent = Rect::EMPTY_RECT;
+        int32_t mColumns = 0;
+        int32_t mRows = 0;
+        std::vector<std::vector<size_t>> mCells;
+        // Windows that extend past the extent, used for points outside of it.
+        std::vector<size_t> mOutside;
+
+        int32_t columnFor(int32_t x) const;
+        int32_t rowFor(int32_t y) const;
+    };
+
+    ui::Transform mDisplayTransform;
+    Grid mTouchableGrid;
+    Grid mFrameGrid;
+    std::vector<size_t> mWatchOutsideTouch;
+    std::unordered_map<const gui::WindowInfoHandle*, size_t> mIndexByHandle;
+};
+
+} // namespace android::inputdispatcher
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <initializer_list>
+#include <variant>
 #include <vector>
 
 #include <input/Input.h>
@@ -37,6 +39,8 @@ struct NotifyInputDevicesChangedArgs {
 
     NotifyInputDevicesChangedArgs(const NotifyInputDevicesChangedArgs& other) = default;
     NotifyInputDevicesChangedArgs& operator=(const NotifyInputDevicesChangedArgs&) = default;
+    NotifyInputDevicesChangedArgs(NotifyInputDevicesChangedArgs&& other) = default;
+    NotifyInputDevicesChangedArgs& operator=(NotifyInputDevicesChangedArgs&&) = default;
 };
 
 /* Describes a configuration change event. */
@@ -52,6 +56,8 @@ struct NotifyConfigurationChangedArgs {
 
     NotifyConfigurationChangedArgs(const NotifyConfigurationChangedArgs& other) = default;
     NotifyConfigurationChangedArgs& operator=(const NotifyConfigurationChangedArgs&) = default;
+    NotifyConfigurationChangedArgs(NotifyConfigurationChangedArgs&& other) = default;
+    NotifyConfigurationChangedArgs& operator=(NotifyConfigurationChangedArgs&&) = default;
 };
 
 /* Describes a key event. */
@@ -82,6 +88,8 @@ struct NotifyKeyArgs {
 
     NotifyKeyArgs(const NotifyKeyArgs& other) = default;
     NotifyKeyArgs& operator=(const NotifyKeyArgs&) = default;
+    NotifyKeyArgs(NotifyKeyArgs&& other) = default;
+    NotifyKeyArgs& operator=(NotifyKeyArgs&&) = default;
 };
 
 /* Describes a motion event. */
@@ -133,6 +141,8 @@ struct NotifyMotionArgs {
 
     NotifyMotionArgs(const NotifyMotionArgs& other) = default;
     NotifyMotionArgs& operator=(const android::NotifyMotionArgs&) = default;
+    NotifyMotionArgs(NotifyMotionArgs&& other) = default;
+    NotifyMotionArgs& operator=(NotifyMotionArgs&&) = default;
 
     bool operator==(const NotifyMotionArgs& rhs) const;
 
@@ -162,6 +172,8 @@ struct NotifySensorArgs {
 
     NotifySensorArgs(const NotifySensorArgs& other) = default;
     NotifySensorArgs& operator=(const NotifySensorArgs&) = default;
+    NotifySensorArgs(NotifySensorArgs&& other) = default;
+    NotifySensorArgs& operator=(NotifySensorArgs&&) = default;
 };
 
 /* Describes a switch event. */
@@ -180,6 +192,8 @@ struct NotifySwitchArgs {
 
     NotifySwitchArgs(const NotifySwitchArgs& other) = default;
     NotifySwitchArgs& operator=(const NotifySwitchArgs&) = default;
+    NotifySwitchArgs(NotifySwitchArgs&& other) = default;
+    NotifySwitchArgs& operator=(NotifySwitchArgs&&) = default;
 
     bool operator==(const NotifySwitchArgs& rhs) const = default;
 };
@@ -198,6 +212,8 @@ struct NotifyDeviceResetArgs {
 
     NotifyDeviceResetArgs(const NotifyDeviceResetArgs& other) = default;
     NotifyDeviceResetArgs& operator=(const NotifyDeviceResetArgs&) = default;
+    NotifyDeviceResetArgs(NotifyDeviceResetArgs&& other) = default;
+    NotifyDeviceResetArgs& operator=(NotifyDeviceResetArgs&&) = default;
 
     bool operator==(const NotifyDeviceResetArgs& rhs) const = default;
 };
@@ -215,6 +231,8 @@ struct NotifyPointerCaptureChangedArgs {
 
     NotifyPointerCaptureChangedArgs(const NotifyPointerCaptureChangedArgs& other) = default;
     NotifyPointerCaptureChangedArgs& operator=(const NotifyPointerCaptureChangedArgs&) = default;
+    NotifyPointerCaptureChangedArgs(NotifyPointerCaptureChangedArgs&& other) = default;
+    NotifyPointerCaptureChangedArgs& operator=(NotifyPointerCaptureChangedArgs&&) = default;
 };
 
 /* Describes a vibrator state event. */
@@ -231,6 +249,8 @@ struct NotifyVibratorStateArgs {
 
     NotifyVibratorStateArgs(const NotifyVibratorStateArgs& other) = default;
     NotifyVibratorStateArgs& operator=(const NotifyVibratorStateArgs&) = default;
+    NotifyVibratorStateArgs(NotifyVibratorStateArgs&& other) = default;
+    NotifyVibratorStateArgs& operator=(NotifyVibratorStateArgs&&) = default;
 };
 
 using NotifyArgs =
@@ -240,4 +260,60 @@ using NotifyArgs =
 
 const char* toString(const NotifyArgs& args);
 
+/**
+ * An ordered batch of NotifyArgs, produced by the input mappers while processing events and
+ * delivered to the listener by the reader.
+ *
+ * The storage of a batch is taken from, and returned to, a small per-thread pool, so that once the
+ * reader thread has warmed up, processing a frame of events (for example a multi-touch frame that
+ * results in several motion events) does not allocate for the batches that carry them.
+ */
+class NotifyArgsBatch {
+public:
+    using value_type = NotifyArgs;
+    using iterator = std::vector<NotifyArgs>::iterator;
+    using const_iterator = std::vector<NotifyArgs>::const_iterator;
+
+    NotifyArgsBatch();
+    NotifyArgsBatch(std::initializer_list<NotifyArgs> args);
+    NotifyArgsBatch(const NotifyArgsBatch& other);
+    NotifyArgsBatch(NotifyArgsBatch&& other) noexcept;
+    ~NotifyArgsBatch();
+
+    NotifyArgsBatch& operator=(const NotifyArgsBatch& other);
+    NotifyArgsBatch& operator=(NotifyArgsBatch&& other) noexcept;
+
+    // Appends the args of another batch, leaving it empty.
+    NotifyArgsBatch& operator+=(NotifyArgsBatch&& other);
+
+    void push_back(const NotifyArgs& args) { mArgs.push_back(args); }
+    void push_back(NotifyArgs&& args) { mArgs.push_back(std::move(args)); }
+    template <typename... Args>
+    NotifyArgs& emplace_back(Args&&... args) {
+        return mArgs.emplace_back(std::forward<Args>(args)...);
+    }
+    iterator erase(const_iterator position) { return mArgs.erase(position); }
+    void pop_front() { mArgs.erase(mArgs.begin()); }
+    void clear() { mArgs.clear(); }
+    void swap(NotifyArgsBatch& other) noexcept { mArgs.swap(other.mArgs); }
+
+    iterator begin() { return mArgs.begin(); }
+    iterator end() { return mArgs.end(); }
+    const_iterator begin() const { return mArgs.begin(); }
+    const_iterator end() const { return mArgs.end(); }
+    NotifyArgs& front() { return mArgs.front(); }
+    const NotifyArgs& front() const { return mArgs.front(); }
+    NotifyArgs& back() { return mArgs.back(); }
+    const NotifyArgs& back() const { return mArgs.back(); }
+    size_t size() const { return mArgs.size(); }
+    bool empty() const { return mArgs.empty(); }
+
+private:
+    std::vector<NotifyArgs> mArgs;
+};
+
+inline void swap(NotifyArgsBatch& lhs, NotifyArgsBatch& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
 } // namespace android
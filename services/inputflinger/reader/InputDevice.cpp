@@ -66,9 +66,9 @@ bool InputDevice::isEnabled() {
     return enabled;
 }
 
-std::list<NotifyArgs> InputDevice::updateEnableState(nsecs_t when,
-                                                     const InputReaderConfiguration& readerConfig,
-                                                     bool forceEnable) {
+NotifyArgsBatch InputDevice::updateEnableState(nsecs_t when,
+                                               const InputReaderConfiguration& readerConfig,
+                                               bool forceEnable) {
     bool enable = forceEnable;
     if (!forceEnable) {
         // If the device was explicitly disabled by the user, it would be present in the
@@ -89,7 +89,7 @@ std::list<NotifyArgs> InputDevice::updateEnableState(nsecs_t when,
         }
     }
 
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     if (isEnabled() == enable) {
         return out;
     }
@@ -173,7 +173,7 @@ void InputDevice::addEmptyEventHubDevice(int32_t eventHubId) {
     mDevices.insert({eventHubId, std::make_pair(std::move(contextPtr), std::move(mappers))});
 }
 
-[[nodiscard]] std::list<NotifyArgs> InputDevice::addEventHubDevice(
+[[nodiscard]] NotifyArgsBatch InputDevice::addEventHubDevice(
         nsecs_t when, int32_t eventHubId, const InputReaderConfiguration& readerConfig) {
     if (mDevices.find(eventHubId) != mDevices.end()) {
         return {};
@@ -184,7 +184,7 @@ void InputDevice::addEmptyEventHubDevice(int32_t eventHubId) {
     // Note: we need to ensure device is kept enabled till mappers are configured
     // TODO: b/281852638 refactor tests to remove this flag and reliance on the empty device
     addEmptyEventHubDevice(eventHubId);
-    std::list<NotifyArgs> out = configureInternal(when, readerConfig, {}, /*forceEnable=*/true);
+    NotifyArgsBatch out = configureInternal(when, readerConfig, {}, /*forceEnable=*/true);
 
     DevicePair& devicePair = mDevices[eventHubId];
     devicePair.second = createMappers(*devicePair.first, readerConfig);
@@ -202,16 +202,14 @@ void InputDevice::removeEventHubDevice(int32_t eventHubId) {
     mDevices.erase(eventHubId);
 }
 
-std::list<NotifyArgs> InputDevice::configure(nsecs_t when,
-                                             const InputReaderConfiguration& readerConfig,
-                                             ConfigurationChanges changes) {
+NotifyArgsBatch InputDevice::configure(nsecs_t when, const InputReaderConfiguration& readerConfig,
+                                       ConfigurationChanges changes) {
     return configureInternal(when, readerConfig, changes);
 }
-std::list<NotifyArgs> InputDevice::configureInternal(nsecs_t when,
-                                                     const InputReaderConfiguration& readerConfig,
-                                                     ConfigurationChanges changes,
-                                                     bool forceEnable) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::configureInternal(nsecs_t when,
+                                               const InputReaderConfiguration& readerConfig,
+                                               ConfigurationChanges changes, bool forceEnable) {
+    NotifyArgsBatch out;
     mSources = 0;
     mClasses = ftl::Flags<InputDeviceClass>(0);
     mControllerNumber = 0;
@@ -322,8 +320,8 @@ std::list<NotifyArgs> InputDevice::configureInternal(nsecs_t when,
     return out;
 }
 
-std::list<NotifyArgs> InputDevice::reset(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::reset(nsecs_t when) {
+    NotifyArgsBatch out;
     for_each_mapper([&](InputMapper& mapper) { out += mapper.reset(when); });
 
     mContext->updateGlobalMetaState();
@@ -332,13 +330,13 @@ std::list<NotifyArgs> InputDevice::reset(nsecs_t when) {
     return out;
 }
 
-std::list<NotifyArgs> InputDevice::process(const RawEvent* rawEvents, size_t count) {
+NotifyArgsBatch InputDevice::process(const RawEvent* rawEvents, size_t count) {
     // Process all of the events in order for each mapper.
     // We cannot simply ask each mapper to process them in bulk because mappers may
     // have side-effects that must be interleaved.  For example, joystick movement events and
     // gamepad button presses are handled by different mappers but they should be dispatched
     // in the order received.
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     for (const RawEvent* rawEvent = rawEvents; count != 0; rawEvent++) {
         if (debugRawEvents()) {
             const auto [type, code, value] =
@@ -371,7 +369,7 @@ std::list<NotifyArgs> InputDevice::process(const RawEvent* rawEvents, size_t cou
     return out;
 }
 
-void InputDevice::postProcess(std::list<NotifyArgs>& args) const {
+void InputDevice::postProcess(NotifyArgsBatch& args) const {
     if (mIsWaking) {
         // Update policy flags to request wake for the `NotifyArgs` that come from waking devices.
         for (auto& arg : args) {
@@ -386,14 +384,14 @@ void InputDevice::postProcess(std::list<NotifyArgs>& args) const {
     }
 }
 
-std::list<NotifyArgs> InputDevice::timeoutExpired(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::timeoutExpired(nsecs_t when) {
+    NotifyArgsBatch out;
     for_each_mapper([&](InputMapper& mapper) { out += mapper.timeoutExpired(when); });
     return out;
 }
 
-std::list<NotifyArgs> InputDevice::updateExternalStylusState(const StylusState& state) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::updateExternalStylusState(const StylusState& state) {
+    NotifyArgsBatch out;
     for_each_mapper([&](InputMapper& mapper) { out += mapper.updateExternalStylusState(state); });
     return out;
 }
@@ -560,15 +558,15 @@ int32_t InputDevice::getKeyCodeForKeyLocation(int32_t locationKeyCode) const {
     return *result;
 }
 
-std::list<NotifyArgs> InputDevice::vibrate(const VibrationSequence& sequence, ssize_t repeat,
-                                           int32_t token) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::vibrate(const VibrationSequence& sequence, ssize_t repeat,
+                                     int32_t token) {
+    NotifyArgsBatch out;
     for_each_mapper([&](InputMapper& mapper) { out += mapper.vibrate(sequence, repeat, token); });
     return out;
 }
 
-std::list<NotifyArgs> InputDevice::cancelVibrate(int32_t token) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::cancelVibrate(int32_t token) {
+    NotifyArgsBatch out;
     for_each_mapper([&](InputMapper& mapper) { out += mapper.cancelVibrate(token); });
     return out;
 }
@@ -613,8 +611,8 @@ void InputDevice::flushSensor(InputDeviceSensorType sensorType) {
     for_each_mapper([sensorType](InputMapper& mapper) { mapper.flushSensor(sensorType); });
 }
 
-std::list<NotifyArgs> InputDevice::cancelTouch(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputDevice::cancelTouch(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     for_each_mapper([&](InputMapper& mapper) { out += mapper.cancelTouch(when, readTime); });
     return out;
 }
@@ -115,7 +115,7 @@ void InputReader::loopOnce() {
     // Copy some state so that we can access it outside the lock later.
     bool inputDevicesChanged = false;
     std::vector<InputDeviceInfo> inputDevices;
-    std::list<NotifyArgs> notifyArgs;
+    NotifyArgsBatch notifyArgs;
     { // acquire lock
         std::scoped_lock _l(mLock);
 
@@ -189,8 +189,8 @@ void InputReader::loopOnce() {
     }
 }
 
-std::list<NotifyArgs> InputReader::processEventsLocked(const RawEvent* rawEvents, size_t count) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputReader::processEventsLocked(const RawEvent* rawEvents, size_t count) {
+    NotifyArgsBatch out;
     for (const RawEvent* rawEvent = rawEvents; count;) {
         int32_t type = rawEvent->type;
         size_t batchSize = 1;
@@ -338,9 +338,8 @@ std::shared_ptr<InputDevice> InputReader::createDeviceLocked(
     return device;
 }
 
-std::list<NotifyArgs> InputReader::processEventsForDeviceLocked(int32_t eventHubId,
-                                                                const RawEvent* rawEvents,
-                                                                size_t count) {
+NotifyArgsBatch InputReader::processEventsForDeviceLocked(int32_t eventHubId,
+                                                          const RawEvent* rawEvents, size_t count) {
     auto deviceIt = mDevices.find(eventHubId);
     if (deviceIt == mDevices.end()) {
         ALOGW("Discarding event for unknown eventHubId %d.", eventHubId);
@@ -367,8 +366,8 @@ InputDevice* InputReader::findInputDeviceLocked(int32_t deviceId) const {
     return nullptr;
 }
 
-std::list<NotifyArgs> InputReader::timeoutExpiredLocked(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputReader::timeoutExpiredLocked(nsecs_t when) {
+    NotifyArgsBatch out;
     for (auto& devicePair : mDevices) {
         std::shared_ptr<InputDevice>& device = devicePair.second;
         if (!device->isIgnored()) {
@@ -464,8 +463,8 @@ void InputReader::getExternalStylusDevicesLocked(std::vector<InputDeviceInfo>& o
     }
 }
 
-std::list<NotifyArgs> InputReader::dispatchExternalStylusStateLocked(const StylusState& state) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch InputReader::dispatchExternalStylusStateLocked(const StylusState& state) {
+    NotifyArgsBatch out;
     for (auto& devicePair : mDevices) {
         std::shared_ptr<InputDevice>& device = devicePair.second;
         out += device->updateExternalStylusState(state);
@@ -1091,7 +1090,7 @@ void InputReader::ContextImpl::getExternalStylusDevices(std::vector<InputDeviceI
     mReader->getExternalStylusDevicesLocked(outDevices);
 }
 
-std::list<NotifyArgs> InputReader::ContextImpl::dispatchExternalStylusState(
+NotifyArgsBatch InputReader::ContextImpl::dispatchExternalStylusState(
         const StylusState& state) {
     return mReader->dispatchExternalStylusStateLocked(state);
 }
@@ -80,16 +80,16 @@ public:
 
     void dump(std::string& dump, const std::string& eventHubDevStr);
     void addEmptyEventHubDevice(int32_t eventHubId);
-    [[nodiscard]] std::list<NotifyArgs> addEventHubDevice(
+    [[nodiscard]] NotifyArgsBatch addEventHubDevice(
             nsecs_t when, int32_t eventHubId, const InputReaderConfiguration& readerConfig);
     void removeEventHubDevice(int32_t eventHubId);
-    [[nodiscard]] std::list<NotifyArgs> configure(nsecs_t when,
-                                                  const InputReaderConfiguration& readerConfig,
-                                                  ConfigurationChanges changes);
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when);
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvents, size_t count);
-    [[nodiscard]] std::list<NotifyArgs> timeoutExpired(nsecs_t when);
-    [[nodiscard]] std::list<NotifyArgs> updateExternalStylusState(const StylusState& state);
+    [[nodiscard]] NotifyArgsBatch configure(nsecs_t when,
+                                            const InputReaderConfiguration& readerConfig,
+                                            ConfigurationChanges changes);
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when);
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvents, size_t count);
+    [[nodiscard]] NotifyArgsBatch timeoutExpired(nsecs_t when);
+    [[nodiscard]] NotifyArgsBatch updateExternalStylusState(const StylusState& state);
 
     InputDeviceInfo getDeviceInfo();
     int32_t getKeyCodeState(uint32_t sourceMask, int32_t keyCode);
@@ -98,12 +98,12 @@ public:
     int32_t getKeyCodeForKeyLocation(int32_t locationKeyCode) const;
     bool markSupportedKeyCodes(uint32_t sourceMask, const std::vector<int32_t>& keyCodes,
                                uint8_t* outFlags);
-    [[nodiscard]] std::list<NotifyArgs> vibrate(const VibrationSequence& sequence, ssize_t repeat,
-                                                int32_t token);
-    [[nodiscard]] std::list<NotifyArgs> cancelVibrate(int32_t token);
+    [[nodiscard]] NotifyArgsBatch vibrate(const VibrationSequence& sequence, ssize_t repeat,
+                                          int32_t token);
+    [[nodiscard]] NotifyArgsBatch cancelVibrate(int32_t token);
     bool isVibrating();
     std::vector<int32_t> getVibratorIds();
-    [[nodiscard]] std::list<NotifyArgs> cancelTouch(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch cancelTouch(nsecs_t when, nsecs_t readTime);
     bool enableSensor(InputDeviceSensorType sensorType, std::chrono::microseconds samplingPeriod,
                       std::chrono::microseconds maxBatchReportLatency);
     void disableSensor(InputDeviceSensorType sensorType);
@@ -206,18 +206,18 @@ private:
     std::vector<std::unique_ptr<InputMapper>> createMappers(
             InputDeviceContext& contextPtr, const InputReaderConfiguration& readerConfig);
 
-    [[nodiscard]] std::list<NotifyArgs> configureInternal(
+    [[nodiscard]] NotifyArgsBatch configureInternal(
             nsecs_t when, const InputReaderConfiguration& readerConfig,
             ConfigurationChanges changes, bool forceEnable = false);
 
-    [[nodiscard]] std::list<NotifyArgs> updateEnableState(
+    [[nodiscard]] NotifyArgsBatch updateEnableState(
             nsecs_t when, const InputReaderConfiguration& readerConfig, bool forceEnable = false);
 
     PropertyMap mConfiguration;
 
     // Runs logic post a `process` call. This can be used to update the generated `NotifyArgs` as
     // per the properties of the InputDevice.
-    void postProcess(std::list<NotifyArgs>& args) const;
+    void postProcess(NotifyArgsBatch& args) const;
 
     // helpers to interate over the devices collection
     // run a function against every mapper on every subdevice
@@ -453,7 +453,7 @@ public:
     inline std::optional<DisplayViewport> getAssociatedViewport() const {
         return mDevice.getAssociatedViewport();
     }
-    [[nodiscard]] inline std::list<NotifyArgs> cancelTouch(nsecs_t when, nsecs_t readTime) {
+    [[nodiscard]] inline NotifyArgsBatch cancelTouch(nsecs_t when, nsecs_t readTime) {
         return mDevice.cancelTouch(when, readTime);
     }
     inline void bumpGeneration() { mDevice.bumpGeneration(); }
@@ -148,7 +148,7 @@ protected:
         int32_t bumpGeneration() NO_THREAD_SAFETY_ANALYSIS override;
         void getExternalStylusDevices(std::vector<InputDeviceInfo>& outDevices)
                 REQUIRES(mReader->mLock) override;
-        [[nodiscard]] std::list<NotifyArgs> dispatchExternalStylusState(const StylusState& outState)
+        [[nodiscard]] NotifyArgsBatch dispatchExternalStylusState(const StylusState& outState)
                 REQUIRES(mReader->mLock) override;
         InputReaderPolicyInterface* getPolicy() REQUIRES(mReader->mLock) override;
         EventHubInterface* getEventHub() REQUIRES(mReader->mLock) override;
@@ -184,7 +184,7 @@ private:
     // list can only be accessed with the lock, so the events inside it are well-ordered.
     // Once the reader is done working, these events will be swapped into a temporary storage and
     // sent to the 'mNextListener' without holding the lock.
-    std::list<NotifyArgs> mPendingArgs GUARDED_BY(mLock);
+    NotifyArgsBatch mPendingArgs GUARDED_BY(mLock);
 
     InputReaderConfiguration mConfig GUARDED_BY(mLock);
 
@@ -205,15 +205,15 @@ private:
     nsecs_t mLastKeyDownTimestamp GUARDED_BY(mLock){0};
 
     // low-level input event decoding and device management
-    [[nodiscard]] std::list<NotifyArgs> processEventsLocked(const RawEvent* rawEvents, size_t count)
+    [[nodiscard]] NotifyArgsBatch processEventsLocked(const RawEvent* rawEvents, size_t count)
             REQUIRES(mLock);
 
     void addDeviceLocked(nsecs_t when, int32_t eventHubId) REQUIRES(mLock);
     void removeDeviceLocked(nsecs_t when, int32_t eventHubId) REQUIRES(mLock);
-    [[nodiscard]] std::list<NotifyArgs> processEventsForDeviceLocked(int32_t eventHubId,
-                                                                     const RawEvent* rawEvents,
-                                                                     size_t count) REQUIRES(mLock);
-    [[nodiscard]] std::list<NotifyArgs> timeoutExpiredLocked(nsecs_t when) REQUIRES(mLock);
+    [[nodiscard]] NotifyArgsBatch processEventsForDeviceLocked(int32_t eventHubId,
+                                                               const RawEvent* rawEvents,
+                                                               size_t count) REQUIRES(mLock);
+    [[nodiscard]] NotifyArgsBatch timeoutExpiredLocked(nsecs_t when) REQUIRES(mLock);
 
     void handleConfigurationChangedLocked(nsecs_t when) REQUIRES(mLock);
 
@@ -227,7 +227,7 @@ private:
 
     void notifyExternalStylusPresenceChangedLocked() REQUIRES(mLock);
     void getExternalStylusDevicesLocked(std::vector<InputDeviceInfo>& outDevices) REQUIRES(mLock);
-    [[nodiscard]] std::list<NotifyArgs> dispatchExternalStylusStateLocked(const StylusState& state)
+    [[nodiscard]] NotifyArgsBatch dispatchExternalStylusStateLocked(const StylusState& state)
             REQUIRES(mLock);
 
     // The PointerController that is shared among all the input devices that need it.
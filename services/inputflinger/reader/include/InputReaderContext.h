@@ -52,7 +52,7 @@ public:
     virtual int32_t bumpGeneration() = 0;
 
     virtual void getExternalStylusDevices(std::vector<InputDeviceInfo>& outDevices) = 0;
-    [[nodiscard]] virtual std::list<NotifyArgs> dispatchExternalStylusState(
+    [[nodiscard]] virtual NotifyArgsBatch dispatchExternalStylusState(
             const StylusState& outState) = 0;
 
     virtual InputReaderPolicyInterface* getPolicy() = 0;
@@ -149,8 +149,8 @@ void CapturedTouchpadEventConverter::reset() {
     mPointerIdForSlotNumber.clear();
 }
 
-std::list<NotifyArgs> CapturedTouchpadEventConverter::process(const RawEvent& rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch CapturedTouchpadEventConverter::process(const RawEvent& rawEvent) {
+    NotifyArgsBatch out;
     if (rawEvent.type == EV_SYN && rawEvent.code == SYN_REPORT) {
         out = sync(rawEvent.when, rawEvent.readTime);
         mMotionAccumulator.finishSync();
@@ -161,8 +161,8 @@ std::list<NotifyArgs> CapturedTouchpadEventConverter::process(const RawEvent& ra
     return out;
 }
 
-std::list<NotifyArgs> CapturedTouchpadEventConverter::sync(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch CapturedTouchpadEventConverter::sync(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     std::vector<PointerCoords> coords;
     std::vector<PointerProperties> properties;
     std::map<size_t, size_t> coordsIndexForSlotNumber;
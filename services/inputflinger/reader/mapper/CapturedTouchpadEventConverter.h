@@ -44,12 +44,12 @@ public:
     std::string dump() const;
     void populateMotionRanges(InputDeviceInfo& info) const;
     void reset();
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent& rawEvent);
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent& rawEvent);
 
 private:
     void tryAddRawMotionRange(InputDeviceInfo& deviceInfo, int32_t androidAxis,
                               int32_t evdevAxis) const;
-    [[nodiscard]] std::list<NotifyArgs> sync(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch sync(nsecs_t when, nsecs_t readTime);
     [[nodiscard]] NotifyMotionArgs makeMotionArgs(nsecs_t when, nsecs_t readTime, int32_t action,
                                                   const std::vector<PointerCoords>& coords,
                                                   const std::vector<PointerProperties>& properties,
@@ -139,10 +139,10 @@ void CursorInputMapper::dump(std::string& dump) {
     dump += StringPrintf(INDENT3 "DownTime: %" PRId64 "\n", mDownTime);
 }
 
-std::list<NotifyArgs> CursorInputMapper::reconfigure(nsecs_t when,
-                                                     const InputReaderConfiguration& readerConfig,
-                                                     ConfigurationChanges changes) {
-    std::list<NotifyArgs> out = InputMapper::reconfigure(when, readerConfig, changes);
+NotifyArgsBatch CursorInputMapper::reconfigure(nsecs_t when,
+                                               const InputReaderConfiguration& readerConfig,
+                                               ConfigurationChanges changes) {
+    NotifyArgsBatch out = InputMapper::reconfigure(when, readerConfig, changes);
 
     if (!changes.any()) { // first time only
         configureBasicParams();
@@ -199,7 +199,7 @@ void CursorInputMapper::dumpParameters(std::string& dump) {
     dump += StringPrintf(INDENT4 "OrientationAware: %s\n", toString(mParameters.orientationAware));
 }
 
-std::list<NotifyArgs> CursorInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch CursorInputMapper::reset(nsecs_t when) {
     mButtonState = 0;
     mDownTime = 0;
     mLastEventTime = std::numeric_limits<nsecs_t>::min();
@@ -215,8 +215,8 @@ std::list<NotifyArgs> CursorInputMapper::reset(nsecs_t when) {
     return InputMapper::reset(when);
 }
 
-std::list<NotifyArgs> CursorInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch CursorInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     mCursorButtonAccumulator.process(rawEvent);
     mCursorMotionAccumulator.process(rawEvent);
     mCursorScrollAccumulator.process(rawEvent);
@@ -232,8 +232,8 @@ std::list<NotifyArgs> CursorInputMapper::process(const RawEvent* rawEvent) {
     return out;
 }
 
-std::list<NotifyArgs> CursorInputMapper::sync(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch CursorInputMapper::sync(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     if (!mDisplayId) {
         // Ignore events when there is no target display configured.
         return out;
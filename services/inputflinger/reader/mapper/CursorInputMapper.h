@@ -62,11 +62,11 @@ public:
     virtual uint32_t getSources() const override;
     virtual void populateDeviceInfo(InputDeviceInfo& deviceInfo) override;
     virtual void dump(std::string& dump) override;
-    [[nodiscard]] std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& readerConfig,
-                                                    ConfigurationChanges changes) override;
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch reconfigure(nsecs_t when,
+                                              const InputReaderConfiguration& readerConfig,
+                                              ConfigurationChanges changes) override;
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
     virtual int32_t getScanCodeState(uint32_t sourceMask, int32_t scanCode) override;
 
@@ -138,7 +138,7 @@ private:
     void configureOnChangePointerSpeed(const InputReaderConfiguration& config);
     void configureOnChangeDisplayInfo(const InputReaderConfiguration& config);
 
-    [[nodiscard]] std::list<NotifyArgs> sync(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch sync(nsecs_t when, nsecs_t readTime);
 
     static Parameters computeParameters(const InputDeviceContext& deviceContext);
 };
@@ -47,22 +47,22 @@ void ExternalStylusInputMapper::dump(std::string& dump) {
     dumpStylusState(dump, mStylusState);
 }
 
-std::list<NotifyArgs> ExternalStylusInputMapper::reconfigure(nsecs_t when,
-                                                             const InputReaderConfiguration& config,
-                                                             ConfigurationChanges changes) {
+NotifyArgsBatch ExternalStylusInputMapper::reconfigure(nsecs_t when,
+                                                       const InputReaderConfiguration& config,
+                                                       ConfigurationChanges changes) {
     getAbsoluteAxisInfo(ABS_PRESSURE, &mRawPressureAxis);
     mTouchButtonAccumulator.configure();
     return {};
 }
 
-std::list<NotifyArgs> ExternalStylusInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch ExternalStylusInputMapper::reset(nsecs_t when) {
     mSingleTouchMotionAccumulator.reset(getDeviceContext());
     mTouchButtonAccumulator.reset();
     return InputMapper::reset(when);
 }
 
-std::list<NotifyArgs> ExternalStylusInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch ExternalStylusInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     mSingleTouchMotionAccumulator.process(rawEvent);
     mTouchButtonAccumulator.process(rawEvent);
 
@@ -72,7 +72,7 @@ std::list<NotifyArgs> ExternalStylusInputMapper::process(const RawEvent* rawEven
     return out;
 }
 
-std::list<NotifyArgs> ExternalStylusInputMapper::sync(nsecs_t when) {
+NotifyArgsBatch ExternalStylusInputMapper::sync(nsecs_t when) {
     mStylusState.clear();
 
     mStylusState.when = when;
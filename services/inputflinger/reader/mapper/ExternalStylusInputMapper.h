@@ -35,11 +35,10 @@ public:
     uint32_t getSources() const override;
     void populateDeviceInfo(InputDeviceInfo& deviceInfo) override;
     void dump(std::string& dump) override;
-    [[nodiscard]] std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& config,
-                                                    ConfigurationChanges changes) override;
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                              ConfigurationChanges changes) override;
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
 private:
     SingleTouchMotionAccumulator mSingleTouchMotionAccumulator;
@@ -50,7 +49,7 @@ private:
 
     explicit ExternalStylusInputMapper(InputDeviceContext& deviceContext,
                                        const InputReaderConfiguration& readerConfig);
-    [[nodiscard]] std::list<NotifyArgs> sync(nsecs_t when);
+    [[nodiscard]] NotifyArgsBatch sync(nsecs_t when);
 };
 
 } // namespace android
@@ -37,16 +37,16 @@ void InputMapper::populateDeviceInfo(InputDeviceInfo& info) {
 
 void InputMapper::dump(std::string& dump) {}
 
-std::list<NotifyArgs> InputMapper::reconfigure(nsecs_t when, const InputReaderConfiguration& config,
-                                               ConfigurationChanges changes) {
+NotifyArgsBatch InputMapper::reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                         ConfigurationChanges changes) {
     return {};
 }
 
-std::list<NotifyArgs> InputMapper::reset(nsecs_t when) {
+NotifyArgsBatch InputMapper::reset(nsecs_t when) {
     return {};
 }
 
-std::list<NotifyArgs> InputMapper::timeoutExpired(nsecs_t when) {
+NotifyArgsBatch InputMapper::timeoutExpired(nsecs_t when) {
     return {};
 }
 
@@ -71,12 +71,12 @@ bool InputMapper::markSupportedKeyCodes(uint32_t sourceMask, const std::vector<i
     return false;
 }
 
-std::list<NotifyArgs> InputMapper::vibrate(const VibrationSequence& sequence, ssize_t repeat,
-                                           int32_t token) {
+NotifyArgsBatch InputMapper::vibrate(const VibrationSequence& sequence, ssize_t repeat,
+                                     int32_t token) {
     return {};
 }
 
-std::list<NotifyArgs> InputMapper::cancelVibrate(int32_t token) {
+NotifyArgsBatch InputMapper::cancelVibrate(int32_t token) {
     return {};
 }
 
@@ -88,7 +88,7 @@ std::vector<int32_t> InputMapper::getVibratorIds() {
     return {};
 }
 
-std::list<NotifyArgs> InputMapper::cancelTouch(nsecs_t when, nsecs_t readTime) {
+NotifyArgsBatch InputMapper::cancelTouch(nsecs_t when, nsecs_t readTime) {
     return {};
 }
 
@@ -110,7 +110,7 @@ bool InputMapper::updateMetaState(int32_t keyCode) {
     return false;
 }
 
-std::list<NotifyArgs> InputMapper::updateExternalStylusState(const StylusState& state) {
+NotifyArgsBatch InputMapper::updateExternalStylusState(const StylusState& state) {
     return {};
 }
 
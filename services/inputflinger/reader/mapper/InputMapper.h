@@ -35,7 +35,7 @@ std::unique_ptr<T> createInputMapper(InputDeviceContext& deviceContext,
     std::unique_ptr<T> mapper(new T(deviceContext, readerConfig, args...));
     // We need to reset and configure the mapper to ensure it is ready to process event
     nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
-    std::list<NotifyArgs> unused = mapper->reset(now);
+    NotifyArgsBatch unused = mapper->reset(now);
     unused += mapper->reconfigure(now, readerConfig, /*changes=*/{});
     return mapper;
 }
@@ -74,12 +74,12 @@ public:
     virtual uint32_t getSources() const = 0;
     virtual void populateDeviceInfo(InputDeviceInfo& deviceInfo);
     virtual void dump(std::string& dump);
-    [[nodiscard]] virtual std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                            const InputReaderConfiguration& config,
-                                                            ConfigurationChanges changes);
-    [[nodiscard]] virtual std::list<NotifyArgs> reset(nsecs_t when);
-    [[nodiscard]] virtual std::list<NotifyArgs> process(const RawEvent* rawEvent) = 0;
-    [[nodiscard]] virtual std::list<NotifyArgs> timeoutExpired(nsecs_t when);
+    [[nodiscard]] virtual NotifyArgsBatch reconfigure(nsecs_t when,
+                                                      const InputReaderConfiguration& config,
+                                                      ConfigurationChanges changes);
+    [[nodiscard]] virtual NotifyArgsBatch reset(nsecs_t when);
+    [[nodiscard]] virtual NotifyArgsBatch process(const RawEvent* rawEvent) = 0;
+    [[nodiscard]] virtual NotifyArgsBatch timeoutExpired(nsecs_t when);
 
     virtual int32_t getKeyCodeState(uint32_t sourceMask, int32_t keyCode);
     virtual int32_t getScanCodeState(uint32_t sourceMask, int32_t scanCode);
@@ -88,12 +88,12 @@ public:
 
     virtual bool markSupportedKeyCodes(uint32_t sourceMask, const std::vector<int32_t>& keyCodes,
                                        uint8_t* outFlags);
-    [[nodiscard]] virtual std::list<NotifyArgs> vibrate(const VibrationSequence& sequence,
-                                                        ssize_t repeat, int32_t token);
-    [[nodiscard]] virtual std::list<NotifyArgs> cancelVibrate(int32_t token);
+    [[nodiscard]] virtual NotifyArgsBatch vibrate(const VibrationSequence& sequence, ssize_t repeat,
+                                                  int32_t token);
+    [[nodiscard]] virtual NotifyArgsBatch cancelVibrate(int32_t token);
     virtual bool isVibrating();
     virtual std::vector<int32_t> getVibratorIds();
-    [[nodiscard]] virtual std::list<NotifyArgs> cancelTouch(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] virtual NotifyArgsBatch cancelTouch(nsecs_t when, nsecs_t readTime);
     virtual bool enableSensor(InputDeviceSensorType sensorType,
                               std::chrono::microseconds samplingPeriod,
                               std::chrono::microseconds maxBatchReportLatency);
@@ -115,7 +115,7 @@ public:
      */
     virtual bool updateMetaState(int32_t keyCode);
 
-    [[nodiscard]] virtual std::list<NotifyArgs> updateExternalStylusState(const StylusState& state);
+    [[nodiscard]] virtual NotifyArgsBatch updateExternalStylusState(const StylusState& state);
 
     virtual std::optional<int32_t> getAssociatedDisplayId() { return std::nullopt; }
     virtual void updateLedState(bool reset) {}
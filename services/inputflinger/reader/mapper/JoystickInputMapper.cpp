@@ -104,10 +104,10 @@ void JoystickInputMapper::dump(std::string& dump) {
     }
 }
 
-std::list<NotifyArgs> JoystickInputMapper::reconfigure(nsecs_t when,
-                                                       const InputReaderConfiguration& config,
-                                                       ConfigurationChanges changes) {
-    std::list<NotifyArgs> out = InputMapper::reconfigure(when, config, changes);
+NotifyArgsBatch JoystickInputMapper::reconfigure(nsecs_t when,
+                                                 const InputReaderConfiguration& config,
+                                                 ConfigurationChanges changes) {
+    NotifyArgsBatch out = InputMapper::reconfigure(when, config, changes);
 
     if (!changes.any()) { // first time only
         // Collect all axes.
@@ -249,7 +249,7 @@ bool JoystickInputMapper::isCenteredAxis(int32_t axis) {
     }
 }
 
-std::list<NotifyArgs> JoystickInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch JoystickInputMapper::reset(nsecs_t when) {
     // Recenter all axes.
     for (std::pair<const int32_t, Axis>& pair : mAxes) {
         Axis& axis = pair.second;
@@ -259,8 +259,8 @@ std::list<NotifyArgs> JoystickInputMapper::reset(nsecs_t when) {
     return InputMapper::reset(when);
 }
 
-std::list<NotifyArgs> JoystickInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch JoystickInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     switch (rawEvent->type) {
         case EV_ABS: {
             auto it = mAxes.find(rawEvent->code);
@@ -310,8 +310,8 @@ std::list<NotifyArgs> JoystickInputMapper::process(const RawEvent* rawEvent) {
     return out;
 }
 
-std::list<NotifyArgs> JoystickInputMapper::sync(nsecs_t when, nsecs_t readTime, bool force) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch JoystickInputMapper::sync(nsecs_t when, nsecs_t readTime, bool force) {
+    NotifyArgsBatch out;
     if (!filterAxes(force)) {
         return out;
     }
@@ -31,11 +31,10 @@ public:
     virtual uint32_t getSources() const override;
     virtual void populateDeviceInfo(InputDeviceInfo& deviceInfo) override;
     virtual void dump(std::string& dump) override;
-    [[nodiscard]] std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& config,
-                                                    ConfigurationChanges changes) override;
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                              ConfigurationChanges changes) override;
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
 private:
     struct Axis {
@@ -98,7 +97,7 @@ private:
     // Axes indexed by raw ABS_* axis index.
     std::unordered_map<int32_t, Axis> mAxes;
 
-    [[nodiscard]] std::list<NotifyArgs> sync(nsecs_t when, nsecs_t readTime, bool force);
+    [[nodiscard]] NotifyArgsBatch sync(nsecs_t when, nsecs_t readTime, bool force);
 
     bool haveAxis(int32_t axisId);
     void pruneAxes(bool ignoreExplicitlyMappedAxes);
@@ -138,10 +138,10 @@ std::optional<DisplayViewport> KeyboardInputMapper::findViewport(
     return std::nullopt;
 }
 
-std::list<NotifyArgs> KeyboardInputMapper::reconfigure(nsecs_t when,
-                                                       const InputReaderConfiguration& config,
-                                                       ConfigurationChanges changes) {
-    std::list<NotifyArgs> out = InputMapper::reconfigure(when, config, changes);
+NotifyArgsBatch KeyboardInputMapper::reconfigure(nsecs_t when,
+                                                 const InputReaderConfiguration& config,
+                                                 ConfigurationChanges changes) {
+    NotifyArgsBatch out = InputMapper::reconfigure(when, config, changes);
 
     if (!changes.any()) { // first time only
         // Configure basic parameters.
@@ -196,8 +196,8 @@ void KeyboardInputMapper::dumpParameters(std::string& dump) const {
     dump += StringPrintf(INDENT4 "HandlesKeyRepeat: %s\n", toString(mParameters.handlesKeyRepeat));
 }
 
-std::list<NotifyArgs> KeyboardInputMapper::reset(nsecs_t when) {
-    std::list<NotifyArgs> out = cancelAllDownKeys(when);
+NotifyArgsBatch KeyboardInputMapper::reset(nsecs_t when) {
+    NotifyArgsBatch out = cancelAllDownKeys(when);
     mHidUsageAccumulator.reset();
 
     resetLedState();
@@ -206,8 +206,8 @@ std::list<NotifyArgs> KeyboardInputMapper::reset(nsecs_t when) {
     return out;
 }
 
-std::list<NotifyArgs> KeyboardInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch KeyboardInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     mHidUsageAccumulator.process(*rawEvent);
     switch (rawEvent->type) {
         case EV_KEY: {
@@ -223,9 +223,9 @@ std::list<NotifyArgs> KeyboardInputMapper::process(const RawEvent* rawEvent) {
     return out;
 }
 
-std::list<NotifyArgs> KeyboardInputMapper::processKey(nsecs_t when, nsecs_t readTime, bool down,
-                                                      int32_t scanCode, int32_t usageCode) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch KeyboardInputMapper::processKey(nsecs_t when, nsecs_t readTime, bool down,
+                                                int32_t scanCode, int32_t usageCode) {
+    NotifyArgsBatch out;
     int32_t keyCode;
     int32_t keyMetaState;
     uint32_t policyFlags;
@@ -432,8 +432,8 @@ std::optional<int32_t> KeyboardInputMapper::getAssociatedDisplayId() {
     return std::nullopt;
 }
 
-std::list<NotifyArgs> KeyboardInputMapper::cancelAllDownKeys(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch KeyboardInputMapper::cancelAllDownKeys(nsecs_t when) {
+    NotifyArgsBatch out;
     size_t n = mKeyDowns.size();
     for (size_t i = 0; i < n; i++) {
         out.emplace_back(NotifyKeyArgs(getContext()->getNextId(), when,
@@ -32,11 +32,10 @@ public:
     uint32_t getSources() const override;
     void populateDeviceInfo(InputDeviceInfo& deviceInfo) override;
     void dump(std::string& dump) override;
-    [[nodiscard]] std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& config,
-                                                    ConfigurationChanges changes) override;
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                              ConfigurationChanges changes) override;
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
     int32_t getKeyCodeState(uint32_t sourceMask, int32_t keyCode) override;
     int32_t getScanCodeState(uint32_t sourceMask, int32_t scanCode) override;
@@ -93,8 +92,8 @@ private:
     ui::Rotation getOrientation();
     int32_t getDisplayId();
 
-    [[nodiscard]] std::list<NotifyArgs> processKey(nsecs_t when, nsecs_t readTime, bool down,
-                                                   int32_t scanCode, int32_t usageCode);
+    [[nodiscard]] NotifyArgsBatch processKey(nsecs_t when, nsecs_t readTime, bool down,
+                                             int32_t scanCode, int32_t usageCode);
 
     bool updateMetaStateIfNeeded(int32_t keyCode, bool down);
 
@@ -106,7 +105,7 @@ private:
     void initializeLedState(LedState& ledState, int32_t led);
     void updateLedStateForModifier(LedState& ledState, int32_t led, int32_t modifier, bool reset);
     std::optional<DisplayViewport> findViewport(const InputReaderConfiguration& readerConfig);
-    [[nodiscard]] std::list<NotifyArgs> cancelAllDownKeys(nsecs_t when);
+    [[nodiscard]] NotifyArgsBatch cancelAllDownKeys(nsecs_t when);
     void onKeyDownProcessed(nsecs_t downTime);
 };
 
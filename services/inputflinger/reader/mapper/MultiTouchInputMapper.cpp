@@ -34,7 +34,7 @@ MultiTouchInputMapper::MultiTouchInputMapper(InputDeviceContext& deviceContext,
 
 MultiTouchInputMapper::~MultiTouchInputMapper() {}
 
-std::list<NotifyArgs> MultiTouchInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch MultiTouchInputMapper::reset(nsecs_t when) {
     // The evdev multi-touch protocol does not allow userspace applications to query the initial or
     // current state of the pointers at any time. This means if we clear our accumulated state when
     // resetting the input mapper, there's no way to rebuild the full initial state of the pointers.
@@ -44,8 +44,8 @@ std::list<NotifyArgs> MultiTouchInputMapper::reset(nsecs_t when) {
     return TouchInputMapper::reset(when);
 }
 
-std::list<NotifyArgs> MultiTouchInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out = TouchInputMapper::process(rawEvent);
+NotifyArgsBatch MultiTouchInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out = TouchInputMapper::process(rawEvent);
 
     mMultiTouchMotionAccumulator.process(rawEvent);
     return out;
@@ -177,9 +177,9 @@ void MultiTouchInputMapper::syncTouch(nsecs_t when, RawState* outState) {
     mMultiTouchMotionAccumulator.finishSync();
 }
 
-std::list<NotifyArgs> MultiTouchInputMapper::reconfigure(nsecs_t when,
-                                                         const InputReaderConfiguration& config,
-                                                         ConfigurationChanges changes) {
+NotifyArgsBatch MultiTouchInputMapper::reconfigure(nsecs_t when,
+                                                   const InputReaderConfiguration& config,
+                                                   ConfigurationChanges changes) {
     const bool simulateStylusWithTouch =
             sysprop::InputProperties::simulate_stylus_with_touch().value_or(false);
     if (simulateStylusWithTouch != mShouldSimulateStylusWithTouch) {
@@ -30,11 +30,10 @@ public:
 
     ~MultiTouchInputMapper() override;
 
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
-    [[nodiscard]] std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& config,
-                                                    ConfigurationChanges changes) override;
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                              ConfigurationChanges changes) override;
 
 protected:
     void syncTouch(nsecs_t when, RawState* outState) override;
@@ -66,10 +66,10 @@ void RotaryEncoderInputMapper::dump(std::string& dump) {
     dump += StringPrintf(INDENT3 "HaveSlopController: %s\n", toString(mSlopController != nullptr));
 }
 
-std::list<NotifyArgs> RotaryEncoderInputMapper::reconfigure(nsecs_t when,
-                                                            const InputReaderConfiguration& config,
-                                                            ConfigurationChanges changes) {
-    std::list<NotifyArgs> out = InputMapper::reconfigure(when, config, changes);
+NotifyArgsBatch RotaryEncoderInputMapper::reconfigure(nsecs_t when,
+                                                      const InputReaderConfiguration& config,
+                                                      ConfigurationChanges changes) {
+    NotifyArgsBatch out = InputMapper::reconfigure(when, config, changes);
     if (!changes.any()) {
         mRotaryEncoderScrollAccumulator.configure(getDeviceContext());
 
@@ -95,14 +95,14 @@ std::list<NotifyArgs> RotaryEncoderInputMapper::reconfigure(nsecs_t when,
     return out;
 }
 
-std::list<NotifyArgs> RotaryEncoderInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch RotaryEncoderInputMapper::reset(nsecs_t when) {
     mRotaryEncoderScrollAccumulator.reset(getDeviceContext());
 
     return InputMapper::reset(when);
 }
 
-std::list<NotifyArgs> RotaryEncoderInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch RotaryEncoderInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     mRotaryEncoderScrollAccumulator.process(rawEvent);
 
     if (rawEvent->type == EV_SYN && rawEvent->code == SYN_REPORT) {
@@ -111,8 +111,8 @@ std::list<NotifyArgs> RotaryEncoderInputMapper::process(const RawEvent* rawEvent
     return out;
 }
 
-std::list<NotifyArgs> RotaryEncoderInputMapper::sync(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch RotaryEncoderInputMapper::sync(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
 
     float scroll = mRotaryEncoderScrollAccumulator.getRelativeVWheel();
     if (mSlopController) {
@@ -117,10 +117,9 @@ void SensorInputMapper::dump(std::string& dump) {
     }
 }
 
-std::list<NotifyArgs> SensorInputMapper::reconfigure(nsecs_t when,
-                                                     const InputReaderConfiguration& config,
-                                                     ConfigurationChanges changes) {
-    std::list<NotifyArgs> out = InputMapper::reconfigure(when, config, changes);
+NotifyArgsBatch SensorInputMapper::reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                               ConfigurationChanges changes) {
+    NotifyArgsBatch out = InputMapper::reconfigure(when, config, changes);
 
     if (!changes.any()) { // first time only
         mDeviceEnabled = true;
@@ -182,7 +181,7 @@ SensorInputMapper::Axis SensorInputMapper::createAxis(const AxisInfo& axisInfo,
     return Axis(rawAxisInfo, axisInfo, scale, offset, min, max, flat, fuzz, resolution, filter);
 }
 
-std::list<NotifyArgs> SensorInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch SensorInputMapper::reset(nsecs_t when) {
     // Recenter all axes.
     for (std::pair<const int32_t, Axis>& pair : mAxes) {
         Axis& axis = pair.second;
@@ -251,8 +250,8 @@ void SensorInputMapper::processHardWareTimestamp(nsecs_t evTime, int32_t mscTime
     mPrevMscTime = static_cast<uint32_t>(mscTime);
 }
 
-std::list<NotifyArgs> SensorInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch SensorInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     switch (rawEvent->type) {
         case EV_ABS: {
             auto it = mAxes.find(rawEvent->code);
@@ -372,8 +371,8 @@ void SensorInputMapper::disableSensor(InputDeviceSensorType sensorType) {
     }
 }
 
-std::list<NotifyArgs> SensorInputMapper::sync(nsecs_t when, bool force) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch SensorInputMapper::sync(nsecs_t when, bool force) {
+    NotifyArgsBatch out;
     for (auto& [sensorType, sensor] : mSensors) {
         // Skip if sensor not enabled
         if (!sensor.enabled) {
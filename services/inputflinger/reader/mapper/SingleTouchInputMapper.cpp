@@ -24,14 +24,14 @@ SingleTouchInputMapper::SingleTouchInputMapper(InputDeviceContext& deviceContext
 
 SingleTouchInputMapper::~SingleTouchInputMapper() {}
 
-std::list<NotifyArgs> SingleTouchInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch SingleTouchInputMapper::reset(nsecs_t when) {
     mSingleTouchMotionAccumulator.reset(getDeviceContext());
 
     return TouchInputMapper::reset(when);
 }
 
-std::list<NotifyArgs> SingleTouchInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out = TouchInputMapper::process(rawEvent);
+NotifyArgsBatch SingleTouchInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out = TouchInputMapper::process(rawEvent);
 
     mSingleTouchMotionAccumulator.process(rawEvent);
     return out;
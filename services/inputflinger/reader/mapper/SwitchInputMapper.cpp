@@ -30,8 +30,8 @@ uint32_t SwitchInputMapper::getSources() const {
     return AINPUT_SOURCE_SWITCH;
 }
 
-std::list<NotifyArgs> SwitchInputMapper::process(const RawEvent* rawEvent) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch SwitchInputMapper::process(const RawEvent* rawEvent) {
+    NotifyArgsBatch out;
     switch (rawEvent->type) {
         case EV_SW:
             processSwitch(rawEvent->code, rawEvent->value);
@@ -56,8 +56,8 @@ void SwitchInputMapper::processSwitch(int32_t switchCode, int32_t switchValue) {
     }
 }
 
-std::list<NotifyArgs> SwitchInputMapper::sync(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch SwitchInputMapper::sync(nsecs_t when) {
+    NotifyArgsBatch out;
     if (mUpdatedSwitchMask) {
         uint32_t updatedSwitchValues = mSwitchValues & mUpdatedSwitchMask;
         out.push_back(NotifySwitchArgs(getContext()->getNextId(), when, /*policyFlags=*/0,
@@ -29,7 +29,7 @@ public:
     virtual ~SwitchInputMapper();
 
     virtual uint32_t getSources() const override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
     virtual int32_t getSwitchState(uint32_t sourceMask, int32_t switchCode) override;
     virtual void dump(std::string& dump) override;
@@ -41,7 +41,7 @@ private:
     explicit SwitchInputMapper(InputDeviceContext& deviceContext,
                                const InputReaderConfiguration& readerConfig);
     void processSwitch(int32_t switchCode, int32_t switchValue);
-    [[nodiscard]] std::list<NotifyArgs> sync(nsecs_t when);
+    [[nodiscard]] NotifyArgsBatch sync(nsecs_t when);
 };
 
 } // namespace android
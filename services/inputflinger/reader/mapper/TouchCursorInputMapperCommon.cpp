@@ -26,11 +26,11 @@ namespace android {
 
 namespace {
 
-[[nodiscard]] std::list<NotifyArgs> synthesizeButtonKey(
+[[nodiscard]] NotifyArgsBatch synthesizeButtonKey(
         InputReaderContext* context, int32_t action, nsecs_t when, nsecs_t readTime,
         int32_t deviceId, uint32_t source, int32_t displayId, uint32_t policyFlags,
         int32_t lastButtonState, int32_t currentButtonState, int32_t buttonState, int32_t keyCode) {
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     if ((action == AKEY_EVENT_ACTION_DOWN && !(lastButtonState & buttonState) &&
          (currentButtonState & buttonState)) ||
         (action == AKEY_EVENT_ACTION_UP && (lastButtonState & buttonState) &&
@@ -86,11 +86,11 @@ bool isPointerDown(int32_t buttonState) {
              AMOTION_EVENT_BUTTON_TERTIARY);
 }
 
-[[nodiscard]] std::list<NotifyArgs> synthesizeButtonKeys(
+[[nodiscard]] NotifyArgsBatch synthesizeButtonKeys(
         InputReaderContext* context, int32_t action, nsecs_t when, nsecs_t readTime,
         int32_t deviceId, uint32_t source, int32_t displayId, uint32_t policyFlags,
         int32_t lastButtonState, int32_t currentButtonState) {
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     out += synthesizeButtonKey(context, action, when, readTime, deviceId, source, displayId,
                                policyFlags, lastButtonState, currentButtonState,
                                AMOTION_EVENT_BUTTON_BACK, AKEYCODE_BACK);
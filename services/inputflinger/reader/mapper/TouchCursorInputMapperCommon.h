@@ -34,7 +34,7 @@ void rotateDelta(ui::Rotation orientation, float* deltaX, float* deltaY);
 // button states.  This determines whether the event is reported as a touch event.
 bool isPointerDown(int32_t buttonState);
 
-[[nodiscard]] std::list<NotifyArgs> synthesizeButtonKeys(
+[[nodiscard]] NotifyArgsBatch synthesizeButtonKeys(
         InputReaderContext* context, int32_t action, nsecs_t when, nsecs_t readTime,
         int32_t deviceId, uint32_t source, int32_t displayId, uint32_t policyFlags,
         int32_t lastButtonState, int32_t currentButtonState);
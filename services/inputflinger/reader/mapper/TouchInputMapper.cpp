@@ -289,10 +289,9 @@ void TouchInputMapper::dump(std::string& dump) {
     }
 }
 
-std::list<NotifyArgs> TouchInputMapper::reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& config,
-                                                    ConfigurationChanges changes) {
-    std::list<NotifyArgs> out = InputMapper::reconfigure(when, config, changes);
+NotifyArgsBatch TouchInputMapper::reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                              ConfigurationChanges changes) {
+    NotifyArgsBatch out = InputMapper::reconfigure(when, config, changes);
 
     mConfig = config;
 
@@ -1386,8 +1385,8 @@ void TouchInputMapper::updateAffineTransformation() {
                                                                  mInputDeviceOrientation);
 }
 
-std::list<NotifyArgs> TouchInputMapper::reset(nsecs_t when) {
-    std::list<NotifyArgs> out = cancelTouch(when, when);
+NotifyArgsBatch TouchInputMapper::reset(nsecs_t when) {
+    NotifyArgsBatch out = cancelTouch(when, when);
     updateTouchSpots();
 
     mCursorButtonAccumulator.reset(getDeviceContext());
@@ -1436,20 +1435,20 @@ void TouchInputMapper::clearStylusDataPendingFlags() {
     mExternalStylusFusionTimeout = LLONG_MAX;
 }
 
-std::list<NotifyArgs> TouchInputMapper::process(const RawEvent* rawEvent) {
+NotifyArgsBatch TouchInputMapper::process(const RawEvent* rawEvent) {
     mCursorButtonAccumulator.process(rawEvent);
     mCursorScrollAccumulator.process(rawEvent);
     mTouchButtonAccumulator.process(rawEvent);
 
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     if (rawEvent->type == EV_SYN && rawEvent->code == SYN_REPORT) {
         out += sync(rawEvent->when, rawEvent->readTime);
     }
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::sync(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::sync(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     if (mDeviceMode == DeviceMode::DISABLED) {
         // Only save the last pending state when the device is disabled.
         mRawStatesPending.clear();
@@ -1507,8 +1506,8 @@ std::list<NotifyArgs> TouchInputMapper::sync(nsecs_t when, nsecs_t readTime) {
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::processRawTouches(bool timeout) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::processRawTouches(bool timeout) {
+    NotifyArgsBatch out;
     if (mDeviceMode == DeviceMode::DISABLED) {
         // Do not process raw event while the device is disabled.
         return out;
@@ -1559,8 +1558,8 @@ std::list<NotifyArgs> TouchInputMapper::processRawTouches(bool timeout) {
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::cookAndDispatch(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::cookAndDispatch(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     // Always start with a clean state.
     mCurrentCookedState.clear();
 
@@ -1801,8 +1800,8 @@ bool TouchInputMapper::assignExternalStylusId(const RawState& state, bool timeou
     return true;
 }
 
-std::list<NotifyArgs> TouchInputMapper::timeoutExpired(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::timeoutExpired(nsecs_t when) {
+    NotifyArgsBatch out;
     if (mDeviceMode == DeviceMode::POINTER) {
         if (mPointerUsage == PointerUsage::GESTURES) {
             // Since this is a synthetic event, we can consider its latency to be zero
@@ -1819,8 +1818,8 @@ std::list<NotifyArgs> TouchInputMapper::timeoutExpired(nsecs_t when) {
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::updateExternalStylusState(const StylusState& state) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::updateExternalStylusState(const StylusState& state) {
+    NotifyArgsBatch out;
     const bool buttonsChanged = mExternalStylusState.buttons != state.buttons;
     mExternalStylusState = state;
     if (mFusedStylusPointerId || mExternalStylusFusionTimeout != LLONG_MAX || buttonsChanged) {
@@ -1835,10 +1834,10 @@ std::list<NotifyArgs> TouchInputMapper::updateExternalStylusState(const StylusSt
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::consumeRawTouches(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags, bool& outConsumed) {
+NotifyArgsBatch TouchInputMapper::consumeRawTouches(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags, bool& outConsumed) {
     outConsumed = false;
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     // Check for release of a virtual key.
     if (mCurrentVirtualKey.down) {
         if (mCurrentRawState.rawPointerData.touchingIdBits.isEmpty()) {
@@ -1977,9 +1976,9 @@ NotifyKeyArgs TouchInputMapper::dispatchVirtualKey(nsecs_t when, nsecs_t readTim
                          keyEventFlags, keyCode, scanCode, metaState, downTime);
 }
 
-std::list<NotifyArgs> TouchInputMapper::abortTouches(nsecs_t when, nsecs_t readTime,
-                                                     uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::abortTouches(nsecs_t when, nsecs_t readTime,
+                                               uint32_t policyFlags) {
+    NotifyArgsBatch out;
     if (mCurrentMotionAborted) {
         // Current motion event was already aborted.
         return out;
@@ -2031,9 +2030,9 @@ static bool updateMovedPointers(const PropertiesArray& inProperties, CoordsArray
     return changed;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchTouches(nsecs_t when, nsecs_t readTime,
-                                                        uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchTouches(nsecs_t when, nsecs_t readTime,
+                                                  uint32_t policyFlags) {
+    NotifyArgsBatch out;
     BitSet32 currentIdBits = mCurrentCookedState.cookedPointerData.touchingIdBits;
     BitSet32 lastIdBits = mLastCookedState.cookedPointerData.touchingIdBits;
     int32_t metaState = getContext()->getGlobalMetaState();
@@ -2132,9 +2131,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchTouches(nsecs_t when, nsecs_t re
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchHoverExit(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchHoverExit(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags) {
+    NotifyArgsBatch out;
     if (mSentHoverEnter &&
         (mCurrentCookedState.cookedPointerData.hoveringIdBits.isEmpty() ||
          !mCurrentCookedState.cookedPointerData.touchingIdBits.isEmpty())) {
@@ -2153,9 +2152,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchHoverExit(nsecs_t when, nsecs_t
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchHoverEnterAndMove(nsecs_t when, nsecs_t readTime,
-                                                                  uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchHoverEnterAndMove(nsecs_t when, nsecs_t readTime,
+                                                            uint32_t policyFlags) {
+    NotifyArgsBatch out;
     if (mCurrentCookedState.cookedPointerData.touchingIdBits.isEmpty() &&
         !mCurrentCookedState.cookedPointerData.hoveringIdBits.isEmpty()) {
         int32_t metaState = getContext()->getGlobalMetaState();
@@ -2185,9 +2184,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchHoverEnterAndMove(nsecs_t when,
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchButtonRelease(nsecs_t when, nsecs_t readTime,
-                                                              uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchButtonRelease(nsecs_t when, nsecs_t readTime,
+                                                        uint32_t policyFlags) {
+    NotifyArgsBatch out;
     BitSet32 releasedButtons(mLastCookedState.buttonState & ~mCurrentCookedState.buttonState);
     const BitSet32& idBits = findActiveIdBits(mLastCookedState.cookedPointerData);
     const int32_t metaState = getContext()->getGlobalMetaState();
@@ -2207,9 +2206,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchButtonRelease(nsecs_t when, nsec
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchButtonPress(nsecs_t when, nsecs_t readTime,
-                                                            uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchButtonPress(nsecs_t when, nsecs_t readTime,
+                                                      uint32_t policyFlags) {
+    NotifyArgsBatch out;
     BitSet32 pressedButtons(mCurrentCookedState.buttonState & ~mLastCookedState.buttonState);
     const BitSet32& idBits = findActiveIdBits(mCurrentCookedState.cookedPointerData);
     const int32_t metaState = getContext()->getGlobalMetaState();
@@ -2229,11 +2228,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchButtonPress(nsecs_t when, nsecs_
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchGestureButtonRelease(nsecs_t when,
-                                                                     uint32_t policyFlags,
-                                                                     BitSet32 idBits,
-                                                                     nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchGestureButtonRelease(nsecs_t when, uint32_t policyFlags,
+                                                               BitSet32 idBits, nsecs_t readTime) {
+    NotifyArgsBatch out;
     BitSet32 releasedButtons(mLastCookedState.buttonState & ~mCurrentCookedState.buttonState);
     const int32_t metaState = getContext()->getGlobalMetaState();
     int32_t buttonState = mLastCookedState.buttonState;
@@ -2253,11 +2250,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchGestureButtonRelease(nsecs_t whe
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchGestureButtonPress(nsecs_t when,
-                                                                   uint32_t policyFlags,
-                                                                   BitSet32 idBits,
-                                                                   nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchGestureButtonPress(nsecs_t when, uint32_t policyFlags,
+                                                             BitSet32 idBits, nsecs_t readTime) {
+    NotifyArgsBatch out;
     BitSet32 pressedButtons(mCurrentCookedState.buttonState & ~mLastCookedState.buttonState);
     const int32_t metaState = getContext()->getGlobalMetaState();
     int32_t buttonState = mLastCookedState.buttonState;
@@ -2488,10 +2483,10 @@ void TouchInputMapper::cookPointerData() {
     }
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchPointerUsage(nsecs_t when, nsecs_t readTime,
-                                                             uint32_t policyFlags,
-                                                             PointerUsage pointerUsage) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchPointerUsage(nsecs_t when, nsecs_t readTime,
+                                                       uint32_t policyFlags,
+                                                       PointerUsage pointerUsage) {
+    NotifyArgsBatch out;
     if (pointerUsage != mPointerUsage) {
         out += abortPointerUsage(when, readTime, policyFlags);
         mPointerUsage = pointerUsage;
@@ -2513,9 +2508,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchPointerUsage(nsecs_t when, nsecs
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::abortPointerUsage(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::abortPointerUsage(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags) {
+    NotifyArgsBatch out;
     switch (mPointerUsage) {
         case PointerUsage::GESTURES:
             out += abortPointerGestures(when, readTime, policyFlags);
@@ -2534,10 +2529,9 @@ std::list<NotifyArgs> TouchInputMapper::abortPointerUsage(nsecs_t when, nsecs_t
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchPointerGestures(nsecs_t when, nsecs_t readTime,
-                                                                uint32_t policyFlags,
-                                                                bool isTimeout) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::dispatchPointerGestures(nsecs_t when, nsecs_t readTime,
+                                                          uint32_t policyFlags, bool isTimeout) {
+    NotifyArgsBatch out;
     // Update current gesture coordinates.
     bool cancelPreviousGesture, finishPreviousGesture;
     bool sendEvents =
@@ -2775,13 +2769,13 @@ std::list<NotifyArgs> TouchInputMapper::dispatchPointerGestures(nsecs_t when, ns
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::abortPointerGestures(nsecs_t when, nsecs_t readTime,
-                                                             uint32_t policyFlags) {
+NotifyArgsBatch TouchInputMapper::abortPointerGestures(nsecs_t when, nsecs_t readTime,
+                                                       uint32_t policyFlags) {
     const MotionClassification classification =
             mPointerGesture.lastGestureMode == PointerGesture::Mode::SWIPE
             ? MotionClassification::TWO_FINGER_SWIPE
             : MotionClassification::NONE;
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     // Cancel previously dispatches pointers.
     if (!mPointerGesture.lastGestureIdBits.isEmpty()) {
         int32_t metaState = getContext()->getGlobalMetaState();
@@ -3530,8 +3524,8 @@ void TouchInputMapper::moveMousePointerFromPointerDelta(nsecs_t when, uint32_t p
     mPointerController->move(deltaX, deltaY);
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchPointerStylus(nsecs_t when, nsecs_t readTime,
-                                                              uint32_t policyFlags) {
+NotifyArgsBatch TouchInputMapper::dispatchPointerStylus(nsecs_t when, nsecs_t readTime,
+                                                        uint32_t policyFlags) {
     mPointerSimple.currentCoords.clear();
     mPointerSimple.currentProperties.clear();
 
@@ -3566,13 +3560,13 @@ std::list<NotifyArgs> TouchInputMapper::dispatchPointerStylus(nsecs_t when, nsec
     return dispatchPointerSimple(when, readTime, policyFlags, down, hovering, mViewport.displayId);
 }
 
-std::list<NotifyArgs> TouchInputMapper::abortPointerStylus(nsecs_t when, nsecs_t readTime,
-                                                           uint32_t policyFlags) {
+NotifyArgsBatch TouchInputMapper::abortPointerStylus(nsecs_t when, nsecs_t readTime,
+                                                     uint32_t policyFlags) {
     return abortPointerSimple(when, readTime, policyFlags);
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchPointerMouse(nsecs_t when, nsecs_t readTime,
-                                                             uint32_t policyFlags) {
+NotifyArgsBatch TouchInputMapper::dispatchPointerMouse(nsecs_t when, nsecs_t readTime,
+                                                       uint32_t policyFlags) {
     mPointerSimple.currentCoords.clear();
     mPointerSimple.currentProperties.clear();
 
@@ -3610,21 +3604,21 @@ std::list<NotifyArgs> TouchInputMapper::dispatchPointerMouse(nsecs_t when, nsecs
     return dispatchPointerSimple(when, readTime, policyFlags, down, hovering, displayId);
 }
 
-std::list<NotifyArgs> TouchInputMapper::abortPointerMouse(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags) {
-    std::list<NotifyArgs> out = abortPointerSimple(when, readTime, policyFlags);
+NotifyArgsBatch TouchInputMapper::abortPointerMouse(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags) {
+    NotifyArgsBatch out = abortPointerSimple(when, readTime, policyFlags);
 
     mPointerVelocityControl.reset();
 
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::dispatchPointerSimple(nsecs_t when, nsecs_t readTime,
-                                                              uint32_t policyFlags, bool down,
-                                                              bool hovering, int32_t displayId) {
+NotifyArgsBatch TouchInputMapper::dispatchPointerSimple(nsecs_t when, nsecs_t readTime,
+                                                        uint32_t policyFlags, bool down,
+                                                        bool hovering, int32_t displayId) {
     LOG_ALWAYS_FATAL_IF(mDeviceMode != DeviceMode::POINTER,
                         "%s cannot be used when the device is not in POINTER mode.", __func__);
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     int32_t metaState = getContext()->getGlobalMetaState();
     auto cursorPosition = mPointerSimple.currentCoords.getXYValue();
 
@@ -3759,9 +3753,9 @@ std::list<NotifyArgs> TouchInputMapper::dispatchPointerSimple(nsecs_t when, nsec
     return out;
 }
 
-std::list<NotifyArgs> TouchInputMapper::abortPointerSimple(nsecs_t when, nsecs_t readTime,
-                                                           uint32_t policyFlags) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::abortPointerSimple(nsecs_t when, nsecs_t readTime,
+                                                     uint32_t policyFlags) {
+    NotifyArgsBatch out;
     if (mPointerSimple.down || mPointerSimple.hovering) {
         int32_t metaState = getContext()->getGlobalMetaState();
         out.push_back(NotifyMotionArgs(getContext()->getNextId(), when, readTime, getDeviceId(),
@@ -3866,8 +3860,8 @@ NotifyMotionArgs TouchInputMapper::dispatchMotion(
                             yCursorPosition, downTime, std::move(frames));
 }
 
-std::list<NotifyArgs> TouchInputMapper::cancelTouch(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch TouchInputMapper::cancelTouch(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     out += abortPointerUsage(when, readTime, /*policyFlags=*/0);
     out += abortTouches(when, readTime, /* policyFlags=*/0);
     return out;
@@ -151,20 +151,19 @@ public:
     uint32_t getSources() const override;
     void populateDeviceInfo(InputDeviceInfo& deviceInfo) override;
     void dump(std::string& dump) override;
-    [[nodiscard]] std::list<NotifyArgs> reconfigure(nsecs_t when,
-                                                    const InputReaderConfiguration& config,
-                                                    ConfigurationChanges changes) override;
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch reconfigure(nsecs_t when, const InputReaderConfiguration& config,
+                                              ConfigurationChanges changes) override;
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
     int32_t getKeyCodeState(uint32_t sourceMask, int32_t keyCode) override;
     int32_t getScanCodeState(uint32_t sourceMask, int32_t scanCode) override;
     bool markSupportedKeyCodes(uint32_t sourceMask, const std::vector<int32_t>& keyCodes,
                                uint8_t* outFlags) override;
 
-    [[nodiscard]] std::list<NotifyArgs> cancelTouch(nsecs_t when, nsecs_t readTime) override;
-    [[nodiscard]] std::list<NotifyArgs> timeoutExpired(nsecs_t when) override;
-    [[nodiscard]] std::list<NotifyArgs> updateExternalStylusState(
+    [[nodiscard]] NotifyArgsBatch cancelTouch(nsecs_t when, nsecs_t readTime) override;
+    [[nodiscard]] NotifyArgsBatch timeoutExpired(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch updateExternalStylusState(
             const StylusState& state) override;
     std::optional<int32_t> getAssociatedDisplayId() override;
 
@@ -721,50 +720,45 @@ private:
     void initializeOrientedRanges();
     void initializeSizeRanges();
 
-    [[nodiscard]] std::list<NotifyArgs> sync(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch sync(nsecs_t when, nsecs_t readTime);
 
-    [[nodiscard]] std::list<NotifyArgs> consumeRawTouches(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags, bool& outConsumed);
-    [[nodiscard]] std::list<NotifyArgs> processRawTouches(bool timeout);
-    [[nodiscard]] std::list<NotifyArgs> cookAndDispatch(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch consumeRawTouches(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags, bool& outConsumed);
+    [[nodiscard]] NotifyArgsBatch processRawTouches(bool timeout);
+    [[nodiscard]] NotifyArgsBatch cookAndDispatch(nsecs_t when, nsecs_t readTime);
     [[nodiscard]] NotifyKeyArgs dispatchVirtualKey(nsecs_t when, nsecs_t readTime,
                                                    uint32_t policyFlags, int32_t keyEventAction,
                                                    int32_t keyEventFlags);
 
-    [[nodiscard]] std::list<NotifyArgs> dispatchTouches(nsecs_t when, nsecs_t readTime,
-                                                        uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> dispatchHoverExit(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> dispatchHoverEnterAndMove(nsecs_t when, nsecs_t readTime,
-                                                                  uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> dispatchButtonRelease(nsecs_t when, nsecs_t readTime,
-                                                              uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> dispatchButtonPress(nsecs_t when, nsecs_t readTime,
+    [[nodiscard]] NotifyArgsBatch dispatchTouches(nsecs_t when, nsecs_t readTime,
+                                                  uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch dispatchHoverExit(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch dispatchHoverEnterAndMove(nsecs_t when, nsecs_t readTime,
                                                             uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> dispatchGestureButtonPress(nsecs_t when,
-                                                                   uint32_t policyFlags,
-                                                                   BitSet32 idBits,
-                                                                   nsecs_t readTime);
-    [[nodiscard]] std::list<NotifyArgs> dispatchGestureButtonRelease(nsecs_t when,
-                                                                     uint32_t policyFlags,
-                                                                     BitSet32 idBits,
-                                                                     nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch dispatchButtonRelease(nsecs_t when, nsecs_t readTime,
+                                                        uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch dispatchButtonPress(nsecs_t when, nsecs_t readTime,
+                                                      uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch dispatchGestureButtonPress(nsecs_t when, uint32_t policyFlags,
+                                                             BitSet32 idBits, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch dispatchGestureButtonRelease(nsecs_t when, uint32_t policyFlags,
+                                                               BitSet32 idBits, nsecs_t readTime);
     const BitSet32& findActiveIdBits(const CookedPointerData& cookedPointerData);
     void cookPointerData();
-    [[nodiscard]] std::list<NotifyArgs> abortTouches(nsecs_t when, nsecs_t readTime,
-                                                     uint32_t policyFlags);
-
-    [[nodiscard]] std::list<NotifyArgs> dispatchPointerUsage(nsecs_t when, nsecs_t readTime,
-                                                             uint32_t policyFlags,
-                                                             PointerUsage pointerUsage);
-    [[nodiscard]] std::list<NotifyArgs> abortPointerUsage(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags);
-
-    [[nodiscard]] std::list<NotifyArgs> dispatchPointerGestures(nsecs_t when, nsecs_t readTime,
-                                                                uint32_t policyFlags,
-                                                                bool isTimeout);
-    [[nodiscard]] std::list<NotifyArgs> abortPointerGestures(nsecs_t when, nsecs_t readTime,
-                                                             uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch abortTouches(nsecs_t when, nsecs_t readTime,
+                                               uint32_t policyFlags);
+
+    [[nodiscard]] NotifyArgsBatch dispatchPointerUsage(nsecs_t when, nsecs_t readTime,
+                                                       uint32_t policyFlags,
+                                                       PointerUsage pointerUsage);
+    [[nodiscard]] NotifyArgsBatch abortPointerUsage(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags);
+
+    [[nodiscard]] NotifyArgsBatch dispatchPointerGestures(nsecs_t when, nsecs_t readTime,
+                                                          uint32_t policyFlags, bool isTimeout);
+    [[nodiscard]] NotifyArgsBatch abortPointerGestures(nsecs_t when, nsecs_t readTime,
+                                                       uint32_t policyFlags);
     bool preparePointerGestures(nsecs_t when, bool* outCancelPreviousGesture,
                                 bool* outFinishPreviousGesture, bool isTimeout);
 
@@ -780,21 +774,21 @@ private:
     // between the last and current events. Uses a relative motion.
     void moveMousePointerFromPointerDelta(nsecs_t when, uint32_t pointerId);
 
-    [[nodiscard]] std::list<NotifyArgs> dispatchPointerStylus(nsecs_t when, nsecs_t readTime,
-                                                              uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> abortPointerStylus(nsecs_t when, nsecs_t readTime,
-                                                           uint32_t policyFlags);
-
-    [[nodiscard]] std::list<NotifyArgs> dispatchPointerMouse(nsecs_t when, nsecs_t readTime,
-                                                             uint32_t policyFlags);
-    [[nodiscard]] std::list<NotifyArgs> abortPointerMouse(nsecs_t when, nsecs_t readTime,
-                                                          uint32_t policyFlags);
-
-    [[nodiscard]] std::list<NotifyArgs> dispatchPointerSimple(nsecs_t when, nsecs_t readTime,
-                                                              uint32_t policyFlags, bool down,
-                                                              bool hovering, int32_t displayId);
-    [[nodiscard]] std::list<NotifyArgs> abortPointerSimple(nsecs_t when, nsecs_t readTime,
-                                                           uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch dispatchPointerStylus(nsecs_t when, nsecs_t readTime,
+                                                        uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch abortPointerStylus(nsecs_t when, nsecs_t readTime,
+                                                     uint32_t policyFlags);
+
+    [[nodiscard]] NotifyArgsBatch dispatchPointerMouse(nsecs_t when, nsecs_t readTime,
+                                                       uint32_t policyFlags);
+    [[nodiscard]] NotifyArgsBatch abortPointerMouse(nsecs_t when, nsecs_t readTime,
+                                                    uint32_t policyFlags);
+
+    [[nodiscard]] NotifyArgsBatch dispatchPointerSimple(nsecs_t when, nsecs_t readTime,
+                                                        uint32_t policyFlags, bool down,
+                                                        bool hovering, int32_t displayId);
+    [[nodiscard]] NotifyArgsBatch abortPointerSimple(nsecs_t when, nsecs_t readTime,
+                                                     uint32_t policyFlags);
 
     // Attempts to assign a pointer id to the external stylus. Returns true if the state should be
     // withheld from further processing while waiting for data from the stylus.
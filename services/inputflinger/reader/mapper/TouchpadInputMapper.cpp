@@ -322,9 +322,9 @@ void TouchpadInputMapper::dump(std::string& dump) {
     dump += StringPrintf(INDENT3 "DisplayId: %s\n", toString(mDisplayId).c_str());
 }
 
-std::list<NotifyArgs> TouchpadInputMapper::reconfigure(nsecs_t when,
-                                                       const InputReaderConfiguration& config,
-                                                       ConfigurationChanges changes) {
+NotifyArgsBatch TouchpadInputMapper::reconfigure(nsecs_t when,
+                                                 const InputReaderConfiguration& config,
+                                                 ConfigurationChanges changes) {
     if (!changes.any()) {
         // First time configuration
         mPropertyProvider.loadPropertiesFromIdcFile(getDeviceContext().getConfiguration());
@@ -405,7 +405,7 @@ std::list<NotifyArgs> TouchpadInputMapper::reconfigure(nsecs_t when,
         mPropertyProvider.getProperty("Button Right Click Zone Enable")
                 .setBoolValues({config.touchpadRightClickZoneEnabled});
     }
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     if ((!changes.any() && config.pointerCaptureRequest.enable) ||
         changes.test(InputReaderConfiguration::Change::POINTER_CAPTURE)) {
         mPointerCaptured = config.pointerCaptureRequest.enable;
@@ -427,10 +427,10 @@ std::list<NotifyArgs> TouchpadInputMapper::reconfigure(nsecs_t when,
     return out;
 }
 
-std::list<NotifyArgs> TouchpadInputMapper::reset(nsecs_t when) {
+NotifyArgsBatch TouchpadInputMapper::reset(nsecs_t when) {
     mStateConverter.reset();
     resetGestureInterpreter(when);
-    std::list<NotifyArgs> out = mGestureConverter.reset(when);
+    NotifyArgsBatch out = mGestureConverter.reset(when);
     out += InputMapper::reset(when);
     return out;
 }
@@ -445,7 +445,7 @@ void TouchpadInputMapper::resetGestureInterpreter(nsecs_t when) {
     mResettingInterpreter = false;
 }
 
-std::list<NotifyArgs> TouchpadInputMapper::process(const RawEvent* rawEvent) {
+NotifyArgsBatch TouchpadInputMapper::process(const RawEvent* rawEvent) {
     if (mPointerCaptured) {
         return mCapturedEventConverter.process(*rawEvent);
     }
@@ -484,14 +484,14 @@ void TouchpadInputMapper::updatePalmDetectionMetrics() {
     mLastFrameTrackingIds = currentTrackingIds;
 }
 
-std::list<NotifyArgs> TouchpadInputMapper::sendHardwareState(nsecs_t when, nsecs_t readTime,
-                                                             SelfContainedHardwareState schs) {
+NotifyArgsBatch TouchpadInputMapper::sendHardwareState(nsecs_t when, nsecs_t readTime,
+                                                       SelfContainedHardwareState schs) {
     ALOGD_IF(DEBUG_TOUCHPAD_GESTURES, "New hardware state: %s", schs.state.String().c_str());
     mGestureInterpreter->PushHardwareState(&schs.state);
     return processGestures(when, readTime);
 }
 
-std::list<NotifyArgs> TouchpadInputMapper::timeoutExpired(nsecs_t when) {
+NotifyArgsBatch TouchpadInputMapper::timeoutExpired(nsecs_t when) {
     if (!input_flags::enable_gestures_library_timer_provider()) {
         return {};
     }
@@ -509,8 +509,8 @@ void TouchpadInputMapper::consumeGesture(const Gesture* gesture) {
     mGesturesToProcess.push_back(*gesture);
 }
 
-std::list<NotifyArgs> TouchpadInputMapper::processGestures(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out = {};
+NotifyArgsBatch TouchpadInputMapper::processGestures(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out = {};
     if (mDisplayId) {
         MetricsAccumulator& metricsAccumulator = MetricsAccumulator::getInstance();
         for (Gesture& gesture : mGesturesToProcess) {
@@ -36,18 +36,18 @@ void VibratorInputMapper::populateDeviceInfo(InputDeviceInfo& info) {
     info.setVibrator(true);
 }
 
-std::list<NotifyArgs> VibratorInputMapper::process(const RawEvent* rawEvent) {
+NotifyArgsBatch VibratorInputMapper::process(const RawEvent* rawEvent) {
     // TODO: Handle FF_STATUS, although it does not seem to be widely supported.
     return {};
 }
 
-std::list<NotifyArgs> VibratorInputMapper::vibrate(const VibrationSequence& sequence,
-                                                   ssize_t repeat, int32_t token) {
+NotifyArgsBatch VibratorInputMapper::vibrate(const VibrationSequence& sequence, ssize_t repeat,
+                                             int32_t token) {
     if (DEBUG_VIBRATOR) {
         ALOGD("vibrate: deviceId=%d, pattern=[%s], repeat=%zd, token=%d", getDeviceId(),
               sequence.toString().c_str(), repeat, token);
     }
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
 
     mVibrating = true;
     mSequence = sequence;
@@ -62,11 +62,11 @@ std::list<NotifyArgs> VibratorInputMapper::vibrate(const VibrationSequence& sequ
     return out;
 }
 
-std::list<NotifyArgs> VibratorInputMapper::cancelVibrate(int32_t token) {
+NotifyArgsBatch VibratorInputMapper::cancelVibrate(int32_t token) {
     if (DEBUG_VIBRATOR) {
         ALOGD("cancelVibrate: deviceId=%d, token=%d", getDeviceId(), token);
     }
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
 
     if (mVibrating && mToken == token) {
         out.push_back(stopVibrating());
@@ -82,8 +82,8 @@ std::vector<int32_t> VibratorInputMapper::getVibratorIds() {
     return getDeviceContext().getVibratorIds();
 }
 
-std::list<NotifyArgs> VibratorInputMapper::timeoutExpired(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch VibratorInputMapper::timeoutExpired(nsecs_t when) {
+    NotifyArgsBatch out;
     if (mVibrating) {
         if (when >= mNextStepTime) {
             out += nextStep();
@@ -94,11 +94,11 @@ std::list<NotifyArgs> VibratorInputMapper::timeoutExpired(nsecs_t when) {
     return out;
 }
 
-std::list<NotifyArgs> VibratorInputMapper::nextStep() {
+NotifyArgsBatch VibratorInputMapper::nextStep() {
     if (DEBUG_VIBRATOR) {
         ALOGD("nextStep: index=%d, vibrate deviceId=%d", (int)mIndex, getDeviceId());
     }
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     mIndex += 1;
     if (size_t(mIndex) >= mSequence.pattern.size()) {
         if (mRepeat < 0) {
@@ -30,14 +30,14 @@ public:
 
     virtual uint32_t getSources() const override;
     virtual void populateDeviceInfo(InputDeviceInfo& deviceInfo) override;
-    [[nodiscard]] std::list<NotifyArgs> process(const RawEvent* rawEvent) override;
+    [[nodiscard]] NotifyArgsBatch process(const RawEvent* rawEvent) override;
 
-    [[nodiscard]] std::list<NotifyArgs> vibrate(const VibrationSequence& sequence, ssize_t repeat,
-                                                int32_t token) override;
-    [[nodiscard]] std::list<NotifyArgs> cancelVibrate(int32_t token) override;
+    [[nodiscard]] NotifyArgsBatch vibrate(const VibrationSequence& sequence, ssize_t repeat,
+                                          int32_t token) override;
+    [[nodiscard]] NotifyArgsBatch cancelVibrate(int32_t token) override;
     virtual bool isVibrating() override;
     virtual std::vector<int32_t> getVibratorIds() override;
-    [[nodiscard]] std::list<NotifyArgs> timeoutExpired(nsecs_t when) override;
+    [[nodiscard]] NotifyArgsBatch timeoutExpired(nsecs_t when) override;
     virtual void dump(std::string& dump) override;
 
 private:
@@ -50,7 +50,7 @@ private:
 
     explicit VibratorInputMapper(InputDeviceContext& deviceContext,
                                  const InputReaderConfiguration& readerConfig);
-    [[nodiscard]] std::list<NotifyArgs> nextStep();
+    [[nodiscard]] NotifyArgsBatch nextStep();
     [[nodiscard]] NotifyVibratorStateArgs stopVibrating();
 };
 
@@ -78,8 +78,8 @@ std::string GestureConverter::dump() const {
     return out.str();
 }
 
-std::list<NotifyArgs> GestureConverter::reset(nsecs_t when) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch GestureConverter::reset(nsecs_t when) {
+    NotifyArgsBatch out;
     switch (mCurrentClassification) {
         case MotionClassification::TWO_FINGER_SWIPE:
             out.push_back(endScroll(when, when));
@@ -130,8 +130,8 @@ void GestureConverter::populateMotionRanges(InputDeviceInfo& info) const {
     // would be orders of magnitude too high, so probably not very useful.)
 }
 
-std::list<NotifyArgs> GestureConverter::handleGesture(nsecs_t when, nsecs_t readTime,
-                                                      const Gesture& gesture) {
+NotifyArgsBatch GestureConverter::handleGesture(nsecs_t when, nsecs_t readTime,
+                                                const Gesture& gesture) {
     if (!mDisplayId) {
         // Ignore gestures when there is no target display configured.
         return {};
@@ -193,9 +193,9 @@ NotifyMotionArgs GestureConverter::handleMove(nsecs_t when, nsecs_t readTime,
                           yCursorPosition);
 }
 
-std::list<NotifyArgs> GestureConverter::handleButtonsChange(nsecs_t when, nsecs_t readTime,
-                                                            const Gesture& gesture) {
-    std::list<NotifyArgs> out = {};
+NotifyArgsBatch GestureConverter::handleButtonsChange(nsecs_t when, nsecs_t readTime,
+                                                      const Gesture& gesture) {
+    NotifyArgsBatch out = {};
 
     mPointerController->setPresentation(PointerControllerInterface::Presentation::POINTER);
     mPointerController->unfade(PointerControllerInterface::Transition::IMMEDIATE);
@@ -225,7 +225,7 @@ std::list<NotifyArgs> GestureConverter::handleButtonsChange(nsecs_t when, nsecs_
     coords.setAxisValue(AMOTION_EVENT_AXIS_PRESSURE, pointerDown ? 1.0f : 0.0f);
 
     uint32_t newButtonState = mButtonState;
-    std::list<NotifyArgs> pressEvents = {};
+    NotifyArgsBatch pressEvents = {};
     for (uint32_t button = 1; button <= GESTURES_BUTTON_FORWARD; button <<= 1) {
         if (buttonsPressed & button) {
             uint32_t actionButton = gesturesButtonToMotionEventButton(button);
@@ -243,7 +243,7 @@ std::list<NotifyArgs> GestureConverter::handleButtonsChange(nsecs_t when, nsecs_
                                      mFingerProps.data(), &coords, xCursorPosition,
                                      yCursorPosition));
     }
-    out.splice(out.end(), pressEvents);
+    out += std::move(pressEvents);
 
     // The same button may be in both down and up in the same gesture, in which case we should treat
     // it as having gone down and then up. So, we treat a single button change gesture as two state
@@ -276,8 +276,8 @@ std::list<NotifyArgs> GestureConverter::handleButtonsChange(nsecs_t when, nsecs_
     return out;
 }
 
-std::list<NotifyArgs> GestureConverter::releaseAllButtons(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch GestureConverter::releaseAllButtons(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     const auto [xCursorPosition, yCursorPosition] =
             mEnablePointerChoreographer ? FloatPoint{0, 0} : mPointerController->getPosition();
 
@@ -310,9 +310,9 @@ std::list<NotifyArgs> GestureConverter::releaseAllButtons(nsecs_t when, nsecs_t
     return out;
 }
 
-std::list<NotifyArgs> GestureConverter::handleScroll(nsecs_t when, nsecs_t readTime,
-                                                     const Gesture& gesture) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch GestureConverter::handleScroll(nsecs_t when, nsecs_t readTime,
+                                               const Gesture& gesture) {
+    NotifyArgsBatch out;
     PointerCoords& coords = mFakeFingerCoords[0];
     const auto [xCursorPosition, yCursorPosition] =
             mEnablePointerChoreographer ? FloatPoint{0, 0} : mPointerController->getPosition();
@@ -347,8 +347,8 @@ std::list<NotifyArgs> GestureConverter::handleScroll(nsecs_t when, nsecs_t readT
     return out;
 }
 
-std::list<NotifyArgs> GestureConverter::handleFling(nsecs_t when, nsecs_t readTime,
-                                                    const Gesture& gesture) {
+NotifyArgsBatch GestureConverter::handleFling(nsecs_t when, nsecs_t readTime,
+                                              const Gesture& gesture) {
     switch (gesture.details.fling.fling_state) {
         case GESTURES_FLING_START:
             if (mCurrentClassification == MotionClassification::TWO_FINGER_SWIPE) {
@@ -396,11 +396,11 @@ NotifyMotionArgs GestureConverter::endScroll(nsecs_t when, nsecs_t readTime) {
     return args;
 }
 
-[[nodiscard]] std::list<NotifyArgs> GestureConverter::handleMultiFingerSwipe(nsecs_t when,
-                                                                             nsecs_t readTime,
-                                                                             uint32_t fingerCount,
-                                                                             float dx, float dy) {
-    std::list<NotifyArgs> out = {};
+[[nodiscard]] NotifyArgsBatch GestureConverter::handleMultiFingerSwipe(nsecs_t when,
+                                                                       nsecs_t readTime,
+                                                                       uint32_t fingerCount,
+                                                                       float dx, float dy) {
+    NotifyArgsBatch out = {};
 
     const auto [xCursorPosition, yCursorPosition] =
             mEnablePointerChoreographer ? FloatPoint{0, 0} : mPointerController->getPosition();
@@ -460,9 +460,9 @@ NotifyMotionArgs GestureConverter::endScroll(nsecs_t when, nsecs_t readTime) {
     return out;
 }
 
-[[nodiscard]] std::list<NotifyArgs> GestureConverter::handleMultiFingerSwipeLift(nsecs_t when,
-                                                                                 nsecs_t readTime) {
-    std::list<NotifyArgs> out = {};
+[[nodiscard]] NotifyArgsBatch GestureConverter::handleMultiFingerSwipeLift(nsecs_t when,
+                                                                           nsecs_t readTime) {
+    NotifyArgsBatch out = {};
     if (mCurrentClassification != MotionClassification::MULTI_FINGER_SWIPE) {
         return out;
     }
@@ -489,8 +489,8 @@ NotifyMotionArgs GestureConverter::endScroll(nsecs_t when, nsecs_t readTime) {
     return out;
 }
 
-[[nodiscard]] std::list<NotifyArgs> GestureConverter::handlePinch(nsecs_t when, nsecs_t readTime,
-                                                                  const Gesture& gesture) {
+[[nodiscard]] NotifyArgsBatch GestureConverter::handlePinch(nsecs_t when, nsecs_t readTime,
+                                                            const Gesture& gesture) {
     const auto [xCursorPosition, yCursorPosition] =
             mEnablePointerChoreographer ? FloatPoint{0, 0} : mPointerController->getPosition();
 
@@ -515,7 +515,7 @@ NotifyMotionArgs GestureConverter::endScroll(nsecs_t when, nsecs_t readTime) {
         mFakeFingerCoords[1].setAxisValue(AMOTION_EVENT_AXIS_Y, yCursorPosition);
         mFakeFingerCoords[1].setAxisValue(AMOTION_EVENT_AXIS_PRESSURE, 1.0f);
         mDownTime = when;
-        std::list<NotifyArgs> out;
+        NotifyArgsBatch out;
         out.push_back(makeMotionArgs(when, readTime, AMOTION_EVENT_ACTION_DOWN,
                                      /* actionButton= */ 0, mButtonState, /* pointerCount= */ 1,
                                      mFingerProps.data(), mFakeFingerCoords.data(), xCursorPosition,
@@ -547,8 +547,8 @@ NotifyMotionArgs GestureConverter::endScroll(nsecs_t when, nsecs_t readTime) {
                            mFakeFingerCoords.data(), xCursorPosition, yCursorPosition)};
 }
 
-std::list<NotifyArgs> GestureConverter::endPinch(nsecs_t when, nsecs_t readTime) {
-    std::list<NotifyArgs> out;
+NotifyArgsBatch GestureConverter::endPinch(nsecs_t when, nsecs_t readTime) {
+    NotifyArgsBatch out;
     const auto [xCursorPosition, yCursorPosition] =
             mEnablePointerChoreographer ? FloatPoint{0, 0} : mPointerController->getPosition();
 
@@ -44,7 +44,7 @@ public:
     std::string dump() const;
 
     void setOrientation(ui::Rotation orientation) { mOrientation = orientation; }
-    [[nodiscard]] std::list<NotifyArgs> reset(nsecs_t when);
+    [[nodiscard]] NotifyArgsBatch reset(nsecs_t when);
 
     void setDisplayId(std::optional<int32_t> displayId) { mDisplayId = displayId; }
 
@@ -52,28 +52,27 @@ public:
 
     void populateMotionRanges(InputDeviceInfo& info) const;
 
-    [[nodiscard]] std::list<NotifyArgs> handleGesture(nsecs_t when, nsecs_t readTime,
-                                                      const Gesture& gesture);
+    [[nodiscard]] NotifyArgsBatch handleGesture(nsecs_t when, nsecs_t readTime,
+                                                const Gesture& gesture);
 
 private:
     [[nodiscard]] NotifyMotionArgs handleMove(nsecs_t when, nsecs_t readTime,
                                               const Gesture& gesture);
-    [[nodiscard]] std::list<NotifyArgs> handleButtonsChange(nsecs_t when, nsecs_t readTime,
-                                                            const Gesture& gesture);
-    [[nodiscard]] std::list<NotifyArgs> releaseAllButtons(nsecs_t when, nsecs_t readTime);
-    [[nodiscard]] std::list<NotifyArgs> handleScroll(nsecs_t when, nsecs_t readTime,
-                                                     const Gesture& gesture);
-    [[nodiscard]] std::list<NotifyArgs> handleFling(nsecs_t when, nsecs_t readTime,
-                                                    const Gesture& gesture);
+    [[nodiscard]] NotifyArgsBatch handleButtonsChange(nsecs_t when, nsecs_t readTime,
+                                                      const Gesture& gesture);
+    [[nodiscard]] NotifyArgsBatch releaseAllButtons(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch handleScroll(nsecs_t when, nsecs_t readTime,
+                                               const Gesture& gesture);
+    [[nodiscard]] NotifyArgsBatch handleFling(nsecs_t when, nsecs_t readTime,
+                                              const Gesture& gesture);
     [[nodiscard]] NotifyMotionArgs endScroll(nsecs_t when, nsecs_t readTime);
 
-    [[nodiscard]] std::list<NotifyArgs> handleMultiFingerSwipe(nsecs_t when, nsecs_t readTime,
-                                                               uint32_t fingerCount, float dx,
-                                                               float dy);
-    [[nodiscard]] std::list<NotifyArgs> handleMultiFingerSwipeLift(nsecs_t when, nsecs_t readTime);
-    [[nodiscard]] std::list<NotifyArgs> handlePinch(nsecs_t when, nsecs_t readTime,
-                                                    const Gesture& gesture);
-    [[nodiscard]] std::list<NotifyArgs> endPinch(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch handleMultiFingerSwipe(nsecs_t when, nsecs_t readTime,
+                                                         uint32_t fingerCount, float dx, float dy);
+    [[nodiscard]] NotifyArgsBatch handleMultiFingerSwipeLift(nsecs_t when, nsecs_t readTime);
+    [[nodiscard]] NotifyArgsBatch handlePinch(nsecs_t when, nsecs_t readTime,
+                                              const Gesture& gesture);
+    [[nodiscard]] NotifyArgsBatch endPinch(nsecs_t when, nsecs_t readTime);
 
     NotifyMotionArgs makeMotionArgs(nsecs_t when, nsecs_t readTime, int32_t action,
                                     int32_t actionButton, int32_t buttonState,
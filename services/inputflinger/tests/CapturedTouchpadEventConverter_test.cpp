@@ -91,11 +91,11 @@ protected:
         event.type = type;
         event.code = code;
         event.value = value;
-        std::list<NotifyArgs> out = conv.process(event);
+        NotifyArgsBatch out = conv.process(event);
         EXPECT_TRUE(out.empty());
     }
 
-    std::list<NotifyArgs> processSync(CapturedTouchpadEventConverter& conv) {
+    NotifyArgsBatch processSync(CapturedTouchpadEventConverter& conv) {
         RawEvent event;
         event.when = ARBITRARY_TIME;
         event.readTime = READ_TIME;
@@ -107,7 +107,7 @@ protected:
     }
 
     NotifyMotionArgs processSyncAndExpectSingleMotionArg(CapturedTouchpadEventConverter& conv) {
-        std::list<NotifyArgs> args = processSync(conv);
+        NotifyArgsBatch args = processSync(conv);
         EXPECT_EQ(1u, args.size());
         return std::get<NotifyMotionArgs>(args.front());
     }
@@ -245,7 +245,7 @@ TEST_F(CapturedTouchpadEventConverterTest, OneFinger_motionReportedCorrectly) {
     processAxis(conv, EV_KEY, BTN_TOUCH, 0);
     processAxis(conv, EV_KEY, BTN_TOOL_FINGER, 0);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_MOVE), WithPointerCount(1u),
@@ -464,7 +464,7 @@ TEST_F(CapturedTouchpadEventConverterTest, FingerTurningIntoPalm_cancelled) {
     processAxis(conv, EV_ABS, ABS_MT_POSITION_X, 51);
     processAxis(conv, EV_ABS, ABS_MT_TOOL_TYPE, MT_TOOL_PALM);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_MOVE), WithPointerCount(1u)));
@@ -572,7 +572,7 @@ TEST_F(CapturedTouchpadEventConverterTest, FingerAndFingerTurningIntoPalm_partia
     processAxis(conv, EV_KEY, BTN_TOUCH, 1);
     processAxis(conv, EV_KEY, BTN_TOOL_DOUBLETAP, 1);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_DOWN), WithPointerCount(1u),
@@ -632,7 +632,7 @@ TEST_F(CapturedTouchpadEventConverterTest, FingerAndPalmTurningIntoFinger_report
     processAxis(conv, EV_ABS, ABS_MT_POSITION_X, 251);
     processAxis(conv, EV_ABS, ABS_MT_TOOL_TYPE, MT_TOOL_FINGER);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_MOVE), WithPointerCount(1u)));
@@ -670,7 +670,7 @@ TEST_F(CapturedTouchpadEventConverterTest, TwoFingers_motionReportedCorrectly) {
     processAxis(conv, EV_KEY, BTN_TOOL_FINGER, 0);
     processAxis(conv, EV_KEY, BTN_TOOL_DOUBLETAP, 1);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_MOVE), WithPointerCount(1u),
@@ -737,7 +737,7 @@ TEST_F(CapturedTouchpadEventConverterTest, PointerIdsReusedAfterLift) {
     processAxis(conv, EV_KEY, BTN_TOUCH, 1);
     processAxis(conv, EV_KEY, BTN_TOOL_DOUBLETAP, 1);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_DOWN), WithPointerCount(1u),
@@ -797,7 +797,7 @@ TEST_F(CapturedTouchpadEventConverterTest,
 
     processAxis(conv, EV_KEY, BTN_LEFT, 1);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 WithMotionAction(AMOTION_EVENT_ACTION_DOWN));
@@ -841,7 +841,7 @@ TEST_F(CapturedTouchpadEventConverterTest, ButtonPressedBeforeTouch_ReportedOnce
     processAxis(conv, EV_KEY, BTN_TOUCH, 1);
     processAxis(conv, EV_KEY, BTN_TOOL_FINGER, 1);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 WithMotionAction(AMOTION_EVENT_ACTION_DOWN));
@@ -866,7 +866,7 @@ TEST_F(CapturedTouchpadEventConverterTest, ButtonReleasedAfterTouchLifts_Reporte
 
     processAxis(conv, EV_KEY, BTN_LEFT, 1);
 
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 WithMotionAction(AMOTION_EVENT_ACTION_DOWN));
@@ -908,7 +908,7 @@ TEST_F(CapturedTouchpadEventConverterTest, MultipleButtonsPressedDuringTouch_Rep
                 WithMotionAction(AMOTION_EVENT_ACTION_DOWN));
 
     processAxis(conv, EV_KEY, BTN_LEFT, 1);
-    std::list<NotifyArgs> args = processSync(conv);
+    NotifyArgsBatch args = processSync(conv);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 WithMotionAction(AMOTION_EVENT_ACTION_MOVE));
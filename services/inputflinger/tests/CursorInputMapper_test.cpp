@@ -79,7 +79,7 @@ protected:
         mReaderConfiguration.pointerCaptureRequest.enable = enabled;
         mReaderConfiguration.pointerCaptureRequest.seq = 1;
         int32_t generation = mDevice->getGeneration();
-        std::list<NotifyArgs> args =
+        NotifyArgsBatch args =
                 mMapper->reconfigure(ARBITRARY_TIME, mReaderConfiguration,
                                      InputReaderConfiguration::Change::POINTER_CAPTURE);
         ASSERT_THAT(args,
@@ -96,7 +96,7 @@ protected:
  * ends. Currently, it is not.
  */
 TEST_F(CursorInputMapperUnitTest, HoverAndLeftButtonPress) {
-    std::list<NotifyArgs> args;
+    NotifyArgsBatch args;
 
     // Move the cursor a little
     args += process(EV_REL, REL_X, 10);
@@ -140,7 +140,7 @@ TEST_F(CursorInputMapperUnitTest, HoverAndLeftButtonPress) {
  */
 TEST_F(CursorInputMapperUnitTest, ProcessPointerCapture) {
     setPointerCapture(true);
-    std::list<NotifyArgs> args;
+    NotifyArgsBatch args;
 
     // Move.
     args += process(EV_REL, REL_X, 10);
@@ -107,7 +107,7 @@ TEST_F(GestureConverterTest, Move) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture moveGesture(kGestureMove, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, -5, 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
     ASSERT_EQ(1u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -126,7 +126,7 @@ TEST_F(GestureConverterTest, Move_Rotated) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture moveGesture(kGestureMove, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, -5, 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
     ASSERT_EQ(1u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -147,7 +147,7 @@ TEST_F(GestureConverterTest, ButtonsChange) {
     Gesture downGesture(kGestureButtonsChange, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                         /* down= */ GESTURES_BUTTON_LEFT | GESTURES_BUTTON_RIGHT,
                         /* up= */ GESTURES_BUTTON_NONE, /* is_tap= */ false);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
     ASSERT_EQ(3u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -219,7 +219,7 @@ TEST_F(GestureConverterTest, DragWithButton) {
     Gesture downGesture(kGestureButtonsChange, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                         /* down= */ GESTURES_BUTTON_LEFT, /* up= */ GESTURES_BUTTON_NONE,
                         /* is_tap= */ false);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
     ASSERT_EQ(2u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -279,7 +279,7 @@ TEST_F(GestureConverterTest, Scroll) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(downTime, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(downTime, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -333,7 +333,7 @@ TEST_F(GestureConverterTest, Scroll_Rotated) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(downTime, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(downTime, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -378,7 +378,7 @@ TEST_F(GestureConverterTest, Scroll_ClearsClassificationAfterGesture) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture continueGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -5);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, continueGesture);
@@ -401,7 +401,7 @@ TEST_F(GestureConverterTest, Scroll_ClearsScrollDistanceAfterGesture) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture continueGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -5);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, continueGesture);
@@ -426,7 +426,7 @@ TEST_F(GestureConverterTest, ThreeFingerSwipe_ClearsClassificationAfterGesture)
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dx=*/0,
                          /*dy=*/0);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture liftGesture(kGestureSwipeLift, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, liftGesture);
@@ -446,7 +446,7 @@ TEST_F(GestureConverterTest, ThreeFingerSwipe_ClearsGestureAxesAfterGesture) {
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dx=*/5,
                          /*dy=*/5);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture liftGesture(kGestureSwipeLift, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, liftGesture);
@@ -472,7 +472,7 @@ TEST_F(GestureConverterTest, ThreeFingerSwipe_Vertical) {
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dx= */ 0,
                          /* dy= */ 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(4u, args.size());
 
     // Three fake fingers should be created. We don't actually care where they are, so long as they
@@ -574,7 +574,7 @@ TEST_F(GestureConverterTest, ThreeFingerSwipe_Rotated) {
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dx= */ 0,
                          /* dy= */ 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(4u, args.size());
 
     // Three fake fingers should be created. We don't actually care where they are, so long as they
@@ -657,7 +657,7 @@ TEST_F(GestureConverterTest, FourFingerSwipe_Horizontal) {
 
     Gesture startGesture(kGestureFourFingerSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                          /* dx= */ 10, /* dy= */ 0);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(5u, args.size());
 
     // Four fake fingers should be created. We don't actually care where they are, so long as they
@@ -780,7 +780,7 @@ TEST_F(GestureConverterTest, Pinch_Inwards) {
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dz= */ 1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_DOWN),
@@ -834,7 +834,7 @@ TEST_F(GestureConverterTest, Pinch_Outwards) {
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dz= */ 1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_DOWN),
@@ -888,7 +888,7 @@ TEST_F(GestureConverterTest, Pinch_ClearsClassificationAfterGesture) {
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dz=*/1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture updateGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                           /*dz=*/1.2, GESTURES_ZOOM_UPDATE);
@@ -912,7 +912,7 @@ TEST_F(GestureConverterTest, Pinch_ClearsScaleFactorAfterGesture) {
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dz=*/1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture updateGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                           /*dz=*/1.2, GESTURES_ZOOM_UPDATE);
@@ -941,7 +941,7 @@ TEST_F(GestureConverterTest, ResetWithButtonPressed) {
                         /*up=*/GESTURES_BUTTON_NONE, /*is_tap=*/false);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(3u, args.size());
 
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -971,7 +971,7 @@ TEST_F(GestureConverterTest, ResetDuringScroll) {
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_UP),
@@ -992,7 +992,7 @@ TEST_F(GestureConverterTest, ResetDuringThreeFingerSwipe) {
                          /*dy=*/10);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(3u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_POINTER_UP |
@@ -1026,7 +1026,7 @@ TEST_F(GestureConverterTest, ResetDuringPinch) {
                          GESTURES_ZOOM_START);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_POINTER_UP |
@@ -1049,7 +1049,7 @@ TEST_F(GestureConverterTest, FlingTapDown) {
 
     Gesture tapDownGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                            /*vx=*/0.f, /*vy=*/0.f, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, tapDownGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, tapDownGesture);
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_HOVER_MOVE),
@@ -1069,7 +1069,7 @@ TEST_F(GestureConverterTest, Tap) {
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1125,7 +1125,7 @@ TEST_F(GestureConverterTest, Click) {
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1190,7 +1190,7 @@ TEST_F_WITH_FLAGS(GestureConverterTest, TapWithTapToClickDisabled,
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1223,7 +1223,7 @@ TEST_F_WITH_FLAGS(GestureConverterTest, ClickWithTapToClickDisabled,
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1290,7 +1290,7 @@ TEST_F_WITH_FLAGS(GestureConverterTest, MoveEnablesTapToClick,
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture moveGesture(kGestureMove, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, -5, 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
     ASSERT_EQ(1u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1321,7 +1321,7 @@ TEST_F(GestureConverterTestWithChoreographer, Move) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture moveGesture(kGestureMove, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, -5, 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
     ASSERT_EQ(1u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1337,7 +1337,7 @@ TEST_F(GestureConverterTestWithChoreographer, Move_Rotated) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture moveGesture(kGestureMove, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, -5, 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
     ASSERT_EQ(1u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1355,7 +1355,7 @@ TEST_F(GestureConverterTestWithChoreographer, ButtonsChange) {
     Gesture downGesture(kGestureButtonsChange, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                         /* down= */ GESTURES_BUTTON_LEFT | GESTURES_BUTTON_RIGHT,
                         /* up= */ GESTURES_BUTTON_NONE, /* is_tap= */ false);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
     ASSERT_EQ(3u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1425,7 +1425,7 @@ TEST_F(GestureConverterTestWithChoreographer, DragWithButton) {
     Gesture downGesture(kGestureButtonsChange, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                         /* down= */ GESTURES_BUTTON_LEFT, /* up= */ GESTURES_BUTTON_NONE,
                         /* is_tap= */ false);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
     ASSERT_EQ(2u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1481,7 +1481,7 @@ TEST_F(GestureConverterTestWithChoreographer, Scroll) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(downTime, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(downTime, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1532,7 +1532,7 @@ TEST_F(GestureConverterTestWithChoreographer, Scroll_Rotated) {
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(downTime, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(downTime, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -1574,7 +1574,7 @@ TEST_F(GestureConverterTestWithChoreographer, Scroll_ClearsClassificationAfterGe
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture continueGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -5);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, continueGesture);
@@ -1597,7 +1597,7 @@ TEST_F(GestureConverterTestWithChoreographer, Scroll_ClearsScrollDistanceAfterGe
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture continueGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -5);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, continueGesture);
@@ -1622,7 +1622,7 @@ TEST_F(GestureConverterTestWithChoreographer, ThreeFingerSwipe_ClearsClassificat
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dx=*/0,
                          /*dy=*/0);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture liftGesture(kGestureSwipeLift, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, liftGesture);
@@ -1642,7 +1642,7 @@ TEST_F(GestureConverterTestWithChoreographer, ThreeFingerSwipe_ClearsGestureAxes
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dx=*/5,
                          /*dy=*/5);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture liftGesture(kGestureSwipeLift, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME);
     args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, liftGesture);
@@ -1668,7 +1668,7 @@ TEST_F(GestureConverterTestWithChoreographer, ThreeFingerSwipe_Vertical) {
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dx= */ 0,
                          /* dy= */ 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(4u, args.size());
 
     // Three fake fingers should be created. We don't actually care where they are, so long as they
@@ -1770,7 +1770,7 @@ TEST_F(GestureConverterTestWithChoreographer, ThreeFingerSwipe_Rotated) {
 
     Gesture startGesture(kGestureSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dx= */ 0,
                          /* dy= */ 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(4u, args.size());
 
     // Three fake fingers should be created. We don't actually care where they are, so long as they
@@ -1853,7 +1853,7 @@ TEST_F(GestureConverterTestWithChoreographer, FourFingerSwipe_Horizontal) {
 
     Gesture startGesture(kGestureFourFingerSwipe, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                          /* dx= */ 10, /* dy= */ 0);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(5u, args.size());
 
     // Four fake fingers should be created. We don't actually care where they are, so long as they
@@ -1976,7 +1976,7 @@ TEST_F(GestureConverterTestWithChoreographer, Pinch_Inwards) {
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dz= */ 1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_DOWN),
@@ -2029,7 +2029,7 @@ TEST_F(GestureConverterTestWithChoreographer, Pinch_Outwards) {
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* dz= */ 1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
     ASSERT_EQ(2u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_DOWN),
@@ -2082,7 +2082,7 @@ TEST_F(GestureConverterTestWithChoreographer, Pinch_ClearsClassificationAfterGes
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dz=*/1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture updateGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                           /*dz=*/1.2, GESTURES_ZOOM_UPDATE);
@@ -2106,7 +2106,7 @@ TEST_F(GestureConverterTestWithChoreographer, Pinch_ClearsScaleFactorAfterGestur
 
     Gesture startGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /*dz=*/1,
                          GESTURES_ZOOM_START);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
     Gesture updateGesture(kGesturePinch, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                           /*dz=*/1.2, GESTURES_ZOOM_UPDATE);
@@ -2135,7 +2135,7 @@ TEST_F(GestureConverterTestWithChoreographer, ResetWithButtonPressed) {
                         /*up=*/GESTURES_BUTTON_NONE, /*is_tap=*/false);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, downGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(3u, args.size());
 
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -2164,7 +2164,7 @@ TEST_F(GestureConverterTestWithChoreographer, ResetDuringScroll) {
     Gesture startGesture(kGestureScroll, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, 0, -10);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_UP), WithCoords(0, -10),
@@ -2184,7 +2184,7 @@ TEST_F(GestureConverterTestWithChoreographer, ResetDuringThreeFingerSwipe) {
                          /*dy=*/10);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(3u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_POINTER_UP |
@@ -2218,7 +2218,7 @@ TEST_F(GestureConverterTestWithChoreographer, ResetDuringPinch) {
                          GESTURES_ZOOM_START);
     (void)converter.handleGesture(ARBITRARY_TIME, READ_TIME, startGesture);
 
-    std::list<NotifyArgs> args = converter.reset(ARBITRARY_TIME);
+    NotifyArgsBatch args = converter.reset(ARBITRARY_TIME);
     ASSERT_EQ(2u, args.size());
     EXPECT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_POINTER_UP |
@@ -2241,7 +2241,7 @@ TEST_F(GestureConverterTestWithChoreographer, FlingTapDown) {
 
     Gesture tapDownGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME,
                            /*vx=*/0.f, /*vy=*/0.f, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, tapDownGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, tapDownGesture);
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
                 AllOf(WithMotionAction(AMOTION_EVENT_ACTION_HOVER_MOVE), WithCoords(0, 0),
@@ -2257,7 +2257,7 @@ TEST_F(GestureConverterTestWithChoreographer, Tap) {
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -2311,7 +2311,7 @@ TEST_F(GestureConverterTestWithChoreographer, Click) {
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -2374,7 +2374,7 @@ TEST_F_WITH_FLAGS(GestureConverterTestWithChoreographer, TapWithTapToClickDisabl
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -2406,7 +2406,7 @@ TEST_F_WITH_FLAGS(GestureConverterTestWithChoreographer, ClickWithTapToClickDisa
 
     Gesture flingGesture(kGestureFling, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, /* vx= */ 0,
                          /* vy= */ 0, GESTURES_FLING_TAP_DOWN);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, flingGesture);
 
     ASSERT_EQ(1u, args.size());
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -2471,7 +2471,7 @@ TEST_F_WITH_FLAGS(GestureConverterTestWithChoreographer, MoveEnablesTapToClick,
     converter.setDisplayId(ADISPLAY_ID_DEFAULT);
 
     Gesture moveGesture(kGestureMove, ARBITRARY_GESTURE_TIME, ARBITRARY_GESTURE_TIME, -5, 10);
-    std::list<NotifyArgs> args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
+    NotifyArgsBatch args = converter.handleGesture(ARBITRARY_TIME, READ_TIME, moveGesture);
     ASSERT_EQ(1u, args.size());
 
     ASSERT_THAT(std::get<NotifyMotionArgs>(args.front()),
@@ -82,13 +82,13 @@ void InputMapperUnitTest::setKeyCodeState(KeyState state, std::set<int> keyCodes
     }
 }
 
-std::list<NotifyArgs> InputMapperUnitTest::process(int32_t type, int32_t code, int32_t value) {
+NotifyArgsBatch InputMapperUnitTest::process(int32_t type, int32_t code, int32_t value) {
     nsecs_t when = systemTime(SYSTEM_TIME_MONOTONIC);
     return process(when, type, code, value);
 }
 
-std::list<NotifyArgs> InputMapperUnitTest::process(nsecs_t when, int32_t type, int32_t code,
-                                                   int32_t value) {
+NotifyArgsBatch InputMapperUnitTest::process(nsecs_t when, int32_t type, int32_t code,
+                                             int32_t value) {
     RawEvent event;
     event.when = when;
     event.readTime = when;
@@ -127,7 +127,7 @@ void InputMapperTest::addConfigurationProperty(const char* key, const char* valu
     mFakeEventHub->addConfigurationProperty(EVENTHUB_ID, key, value);
 }
 
-std::list<NotifyArgs> InputMapperTest::configureDevice(ConfigurationChanges changes) {
+NotifyArgsBatch InputMapperTest::configureDevice(ConfigurationChanges changes) {
     using namespace ftl::flag_operators;
     if (!changes.any() ||
         (changes.any(InputReaderConfiguration::Change::DISPLAY_INFO |
@@ -136,7 +136,7 @@ std::list<NotifyArgs> InputMapperTest::configureDevice(ConfigurationChanges chan
         mReader->requestRefreshConfiguration(changes);
         mReader->loopOnce();
     }
-    std::list<NotifyArgs> out =
+    NotifyArgsBatch out =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(), changes);
     // Loop the reader to flush the input listener queue.
     for (const NotifyArgs& args : out) {
@@ -178,8 +178,8 @@ void InputMapperTest::clearViewports() {
     mFakePolicy->clearViewports();
 }
 
-std::list<NotifyArgs> InputMapperTest::process(InputMapper& mapper, nsecs_t when, nsecs_t readTime,
-                                               int32_t type, int32_t code, int32_t value) {
+NotifyArgsBatch InputMapperTest::process(InputMapper& mapper, nsecs_t when, nsecs_t readTime,
+                                         int32_t type, int32_t code, int32_t value) {
     RawEvent event;
     event.when = when;
     event.readTime = readTime;
@@ -187,7 +187,7 @@ std::list<NotifyArgs> InputMapperTest::process(InputMapper& mapper, nsecs_t when
     event.type = type;
     event.code = code;
     event.value = value;
-    std::list<NotifyArgs> processArgList = mapper.process(&event);
+    NotifyArgsBatch processArgList = mapper.process(&event);
     for (const NotifyArgs& args : processArgList) {
         mFakeListener->notify(args);
     }
@@ -205,8 +205,8 @@ void InputMapperTest::resetMapper(InputMapper& mapper, nsecs_t when) {
     mReader->loopOnce();
 }
 
-std::list<NotifyArgs> InputMapperTest::handleTimeout(InputMapper& mapper, nsecs_t when) {
-    std::list<NotifyArgs> generatedArgs = mapper.timeoutExpired(when);
+NotifyArgsBatch InputMapperTest::handleTimeout(InputMapper& mapper, nsecs_t when) {
+    NotifyArgsBatch generatedArgs = mapper.timeoutExpired(when);
     for (const NotifyArgs& args : generatedArgs) {
         mFakeListener->notify(args);
     }
@@ -51,8 +51,8 @@ protected:
 
     void setKeyCodeState(KeyState state, std::set<int> keyCodes);
 
-    std::list<NotifyArgs> process(int32_t type, int32_t code, int32_t value);
-    std::list<NotifyArgs> process(nsecs_t when, int32_t type, int32_t code, int32_t value);
+    NotifyArgsBatch process(int32_t type, int32_t code, int32_t value);
+    NotifyArgsBatch process(nsecs_t when, int32_t type, int32_t code, int32_t value);
 
     MockEventHubInterface mMockEventHub;
     sp<FakeInputReaderPolicy> mFakePolicy;
@@ -90,7 +90,7 @@ protected:
     void TearDown() override;
 
     void addConfigurationProperty(const char* key, const char* value);
-    std::list<NotifyArgs> configureDevice(ConfigurationChanges changes);
+    NotifyArgsBatch configureDevice(ConfigurationChanges changes);
     std::shared_ptr<InputDevice> newDevice(int32_t deviceId, const std::string& name,
                                            const std::string& location, int32_t eventHubId,
                                            ftl::Flags<InputDeviceClass> classes, int bus = 0);
@@ -99,7 +99,7 @@ protected:
         T& mapper =
                 mDevice->addMapper<T>(EVENTHUB_ID, mFakePolicy->getReaderConfiguration(), args...);
         configureDevice(/*changes=*/{});
-        std::list<NotifyArgs> resetArgList = mDevice->reset(ARBITRARY_TIME);
+        NotifyArgsBatch resetArgList = mDevice->reset(ARBITRARY_TIME);
         resetArgList += mapper.reset(ARBITRARY_TIME);
         // Loop the reader to flush the input listener queue.
         for (const NotifyArgs& loopArgs : resetArgList) {
@@ -125,11 +125,11 @@ protected:
                                       std::optional<uint8_t> physicalPort,
                                       ViewportType viewportType);
     void clearViewports();
-    std::list<NotifyArgs> process(InputMapper& mapper, nsecs_t when, nsecs_t readTime, int32_t type,
-                                  int32_t code, int32_t value);
+    NotifyArgsBatch process(InputMapper& mapper, nsecs_t when, nsecs_t readTime, int32_t type,
+                            int32_t code, int32_t value);
     void resetMapper(InputMapper& mapper, nsecs_t when);
 
-    std::list<NotifyArgs> handleTimeout(InputMapper& mapper, nsecs_t when);
+    NotifyArgsBatch handleTimeout(InputMapper& mapper, nsecs_t when);
 
     static void assertMotionRange(const InputDeviceInfo& info, int32_t axis, uint32_t source,
                                   float min, float max, float flat, float fuzz);
@@ -167,7 +167,7 @@ class FakeInputMapper : public InputMapper {
     // fake mapping which would normally come from keyCharacterMap
     std::unordered_map<int32_t, int32_t> mKeyCodeMapping;
     std::vector<int32_t> mSupportedKeyCodes;
-    std::list<NotifyArgs> mProcessResult;
+    NotifyArgsBatch mProcessResult;
 
     std::mutex mLock;
     std::condition_variable mStateChangedCondition;
@@ -199,7 +199,7 @@ public:
     }
 
     // Sets the return value for the `process` call.
-    void setProcessResult(std::list<NotifyArgs> notifyArgs) {
+    void setProcessResult(NotifyArgsBatch notifyArgs) {
         mProcessResult.clear();
         for (auto notifyArg : notifyArgs) {
             mProcessResult.push_back(notifyArg);
@@ -289,8 +289,8 @@ private:
         }
     }
 
-    std::list<NotifyArgs> reconfigure(nsecs_t, const InputReaderConfiguration& config,
-                                      ConfigurationChanges changes) override {
+    NotifyArgsBatch reconfigure(nsecs_t, const InputReaderConfiguration& config,
+                                ConfigurationChanges changes) override {
         std::scoped_lock<std::mutex> lock(mLock);
         mConfigureWasCalled = true;
 
@@ -304,14 +304,14 @@ private:
         return {};
     }
 
-    std::list<NotifyArgs> reset(nsecs_t) override {
+    NotifyArgsBatch reset(nsecs_t) override {
         std::scoped_lock<std::mutex> lock(mLock);
         mResetWasCalled = true;
         mStateChangedCondition.notify_all();
         return {};
     }
 
-    std::list<NotifyArgs> process(const RawEvent* rawEvent) override {
+    NotifyArgsBatch process(const RawEvent* rawEvent) override {
         std::scoped_lock<std::mutex> lock(mLock);
         mLastEvent = *rawEvent;
         mProcessWasCalled = true;
@@ -2559,7 +2559,7 @@ TEST_F(InputDeviceTest, WhenDeviceCreated_EnabledIsFalse) {
 TEST_F(InputDeviceTest, WhenNoMappersAreRegistered_DeviceIsIgnored) {
     // Configuration.
     InputReaderConfiguration config;
-    std::list<NotifyArgs> unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
+    NotifyArgsBatch unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
 
     // Reset.
     unused += mDevice->reset(ARBITRARY_TIME);
@@ -2620,7 +2620,7 @@ TEST_F(InputDeviceTest, WhenMappersAreRegistered_DeviceIsNotIgnoredAndForwardsRe
     mapper2.setMetaState(AMETA_SHIFT_ON);
 
     InputReaderConfiguration config;
-    std::list<NotifyArgs> unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
+    NotifyArgsBatch unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
 
     std::optional<std::string> propertyValue = mDevice->getConfiguration().getString("key");
     ASSERT_TRUE(propertyValue.has_value())
@@ -2704,11 +2704,11 @@ TEST_F(InputDeviceTest, WakeDevice_AddsWakeFlagToProcessNotifyArgs) {
     mapper.setProcessResult({args1, args2, args3});
 
     InputReaderConfiguration config;
-    std::list<NotifyArgs> unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
+    NotifyArgsBatch unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
 
     RawEvent event;
     event.deviceId = EVENTHUB_ID;
-    std::list<NotifyArgs> notifyArgs = mDevice->process(&event, 1);
+    NotifyArgsBatch notifyArgs = mDevice->process(&event, 1);
 
     for (auto& arg : notifyArgs) {
         if (const auto notifyMotionArgs = std::get_if<NotifyMotionArgs>(&arg)) {
@@ -2730,11 +2730,11 @@ TEST_F(InputDeviceTest, NotWakeDevice_DoesNotAddWakeFlagToProcessNotifyArgs) {
     mapper.setProcessResult({args});
 
     InputReaderConfiguration config;
-    std::list<NotifyArgs> unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
+    NotifyArgsBatch unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
 
     RawEvent event;
     event.deviceId = EVENTHUB_ID;
-    std::list<NotifyArgs> notifyArgs = mDevice->process(&event, 1);
+    NotifyArgsBatch notifyArgs = mDevice->process(&event, 1);
 
     // POLICY_FLAG_WAKE is not added to the NotifyArgs.
     ASSERT_EQ(0u, std::get<NotifyMotionArgs>(notifyArgs.front()).policyFlags);
@@ -2750,11 +2750,11 @@ TEST_F(InputDeviceTest, NotWakeDevice_DoesNotRemoveExistingWakeFlagFromProcessNo
     mapper.setProcessResult({args});
 
     InputReaderConfiguration config;
-    std::list<NotifyArgs> unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
+    NotifyArgsBatch unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
 
     RawEvent event;
     event.deviceId = EVENTHUB_ID;
-    std::list<NotifyArgs> notifyArgs = mDevice->process(&event, 1);
+    NotifyArgsBatch notifyArgs = mDevice->process(&event, 1);
 
     // The POLICY_FLAG_WAKE is preserved, despite the device being a non-wake device.
     ASSERT_EQ(POLICY_FLAG_WAKE, std::get<NotifyMotionArgs>(notifyArgs.front()).policyFlags);
@@ -2768,7 +2768,7 @@ TEST_F(InputDeviceTest, Configure_AssignsDisplayPort) {
                                         AINPUT_SOURCE_TOUCHSCREEN);
 
     // First Configuration.
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -2811,7 +2811,7 @@ TEST_F(InputDeviceTest, Configure_AssignsDisplayUniqueId) {
     mFakePolicy->clearViewports();
     mDevice->addMapper<FakeInputMapper>(EVENTHUB_ID, mFakePolicy->getReaderConfiguration(),
                                         AINPUT_SOURCE_KEYBOARD);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
     ASSERT_TRUE(mDevice->isEnabled());
@@ -2847,7 +2847,7 @@ TEST_F(InputDeviceTest, Configure_UniqueId_CorrectlyMatches) {
     mFakePolicy->clearViewports();
     mDevice->addMapper<FakeInputMapper>(EVENTHUB_ID, mFakePolicy->getReaderConfiguration(),
                                         AINPUT_SOURCE_KEYBOARD);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -2887,7 +2887,7 @@ TEST_F(InputDeviceTest, KernelBufferOverflowResetsMappers) {
     FakeInputMapper& mapper =
             mDevice->addMapper<FakeInputMapper>(EVENTHUB_ID, mFakePolicy->getReaderConfiguration(),
                                                 AINPUT_SOURCE_KEYBOARD);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -2960,7 +2960,7 @@ TEST_F(SwitchInputMapperTest, GetSwitchState) {
 
 TEST_F(SwitchInputMapperTest, Process) {
     SwitchInputMapper& mapper = constructAndAddMapper<SwitchInputMapper>();
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     out = process(mapper, ARBITRARY_TIME, READ_TIME, EV_SW, SW_LID, 1);
     ASSERT_TRUE(out.empty());
     out = process(mapper, ARBITRARY_TIME, READ_TIME, EV_SW, SW_JACK_PHYSICAL_INSERT, 1);
@@ -3017,7 +3017,7 @@ TEST_F(VibratorInputMapperTest, Vibrate) {
 
     ASSERT_FALSE(mapper.isVibrating());
     // Start vibrating
-    std::list<NotifyArgs> out = mapper.vibrate(sequence, /*repeat=*/-1, VIBRATION_TOKEN);
+    NotifyArgsBatch out = mapper.vibrate(sequence, /*repeat=*/-1, VIBRATION_TOKEN);
     ASSERT_TRUE(mapper.isVibrating());
     // Verify vibrator state listener was notified.
     mReader->loopOnce();
@@ -3710,7 +3710,7 @@ TEST_F(KeyboardInputMapperTest, NoMetaStateWhenMetaKeysNotPresent) {
                                                        AINPUT_KEYBOARD_TYPE_NON_ALPHABETIC);
 
     // Meta state should be AMETA_NONE after reset
-    std::list<NotifyArgs> unused = mapper.reset(ARBITRARY_TIME);
+    NotifyArgsBatch unused = mapper.reset(ARBITRARY_TIME);
     ASSERT_EQ(AMETA_NONE, mapper.getMetaState());
     // Meta state should be AMETA_NONE with update, as device doesn't have the keys.
     mapper.updateMetaState(AKEYCODE_NUM_LOCK);
@@ -3766,7 +3766,7 @@ TEST_F(KeyboardInputMapperTest, Configure_AssignsDisplayPort) {
                                                                         ->getReaderConfiguration(),
                                                                 AINPUT_SOURCE_KEYBOARD,
                                                                 AINPUT_KEYBOARD_TYPE_ALPHABETIC);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             device2->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
     unused += device2->reset(ARBITRARY_TIME);
@@ -3880,7 +3880,7 @@ TEST_F(KeyboardInputMapperTest, Process_LockedKeysShouldToggleAfterReattach) {
                                                                         ->getReaderConfiguration(),
                                                                 AINPUT_SOURCE_KEYBOARD,
                                                                 AINPUT_KEYBOARD_TYPE_ALPHABETIC);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             device2->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
     unused += device2->reset(ARBITRARY_TIME);
@@ -3945,7 +3945,7 @@ TEST_F(KeyboardInputMapperTest, Process_LockedKeysShouldToggleInMultiDevices) {
                                                                         ->getReaderConfiguration(),
                                                                 AINPUT_SOURCE_KEYBOARD,
                                                                 AINPUT_KEYBOARD_TYPE_ALPHABETIC);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             device2->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
     unused += device2->reset(ARBITRARY_TIME);
@@ -4028,7 +4028,7 @@ TEST_F(KeyboardInputMapperTest, Process_DisabledDevice) {
 TEST_F(KeyboardInputMapperTest, Configure_AssignKeyboardLayoutInfo) {
     constructAndAddMapper<KeyboardInputMapper>(AINPUT_SOURCE_KEYBOARD,
                                                AINPUT_KEYBOARD_TYPE_ALPHABETIC);
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -4061,7 +4061,7 @@ TEST_F(KeyboardInputMapperTest, LayoutInfoCorrectlyMapped) {
     constructAndAddMapper<KeyboardInputMapper>(AINPUT_SOURCE_KEYBOARD,
                                                AINPUT_KEYBOARD_TYPE_ALPHABETIC);
     InputReaderConfiguration config;
-    std::list<NotifyArgs> unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
+    NotifyArgsBatch unused = mDevice->configure(ARBITRARY_TIME, config, /*changes=*/{});
 
     ASSERT_EQ("en", mDevice->getDeviceInfo().getKeyboardLayoutInfo()->languageTag);
     ASSERT_EQ("extended", mDevice->getDeviceInfo().getKeyboardLayoutInfo()->layoutType);
@@ -7657,7 +7657,7 @@ TEST_F(SingleTouchInputMapperTest, WhenDeviceTypeIsChangedToTouchNavigation_upda
     mFakePolicy->addDeviceTypeAssociation(DEVICE_LOCATION, "touchNavigation");
 
     // Send update to the mapper.
-    std::list<NotifyArgs> unused2 =
+    NotifyArgsBatch unused2 =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                InputReaderConfiguration::Change::DEVICE_TYPE /*changes*/);
 
@@ -8134,8 +8134,8 @@ public:
         return mapper;
     }
 
-    std::list<NotifyArgs> processExternalStylusState(InputMapper& mapper) {
-        std::list<NotifyArgs> generatedArgs = mapper.updateExternalStylusState(mStylusState);
+    NotifyArgsBatch processExternalStylusState(InputMapper& mapper) {
+        NotifyArgsBatch generatedArgs = mapper.updateExternalStylusState(mStylusState);
         for (const NotifyArgs& args : generatedArgs) {
             mFakeListener->notify(args);
         }
@@ -10355,7 +10355,7 @@ TEST_F(MultiTouchInputMapperTest, Process_Pointer_ShowTouches) {
     device2->addEmptyEventHubDevice(SECOND_EVENTHUB_ID);
     MultiTouchInputMapper& mapper2 = device2->constructAndAddMapper<
             MultiTouchInputMapper>(SECOND_EVENTHUB_ID, mFakePolicy->getReaderConfiguration());
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             device2->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
     unused += device2->reset(ARBITRARY_TIME);
@@ -12015,7 +12015,7 @@ TEST_F(LightControllerTest, Ignore_MonoLight_WithPreferredBacklightLevels) {
                                             "0,100,200");
 
     PeripheralController& controller = addControllerAndConfigure<PeripheralController>();
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -12036,7 +12036,7 @@ TEST_F(LightControllerTest, KeyboardBacklight_WithNoPreferredBacklightLevels) {
     mFakeEventHub->addRawLightInfo(infoMono.id, std::move(infoMono));
 
     PeripheralController& controller = addControllerAndConfigure<PeripheralController>();
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -12059,7 +12059,7 @@ TEST_F(LightControllerTest, KeyboardBacklight_WithPreferredBacklightLevels) {
                                             "0,100,200");
 
     PeripheralController& controller = addControllerAndConfigure<PeripheralController>();
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
@@ -12088,7 +12088,7 @@ TEST_F(LightControllerTest, KeyboardBacklight_WithWrongPreferredBacklightLevels)
                                             "0,100,200,300,400,500");
 
     PeripheralController& controller = addControllerAndConfigure<PeripheralController>();
-    std::list<NotifyArgs> unused =
+    NotifyArgsBatch unused =
             mDevice->configure(ARBITRARY_TIME, mFakePolicy->getReaderConfiguration(),
                                /*changes=*/{});
 
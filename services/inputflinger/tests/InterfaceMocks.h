@@ -63,7 +63,7 @@ public:
 
     MOCK_METHOD(void, getExternalStylusDevices, (std::vector<InputDeviceInfo> & outDevices),
                 (override));
-    MOCK_METHOD(std::list<NotifyArgs>, dispatchExternalStylusState, (const StylusState& outState),
+    MOCK_METHOD(NotifyArgsBatch, dispatchExternalStylusState, (const StylusState& outState),
                 (override));
 
     MOCK_METHOD(InputReaderPolicyInterface*, getPolicy, (), (override));
@@ -126,7 +126,7 @@ protected:
  * but only after the button is released.
  */
 TEST_F(TouchpadInputMapperTest, HoverAndLeftButtonPress) {
-    std::list<NotifyArgs> args;
+    NotifyArgsBatch args;
 
     args += process(EV_ABS, ABS_MT_TRACKING_ID, 1);
     args += process(EV_KEY, BTN_TOUCH, 1);
@@ -189,7 +189,7 @@ TEST_F(TouchpadInputMapperTestWithChoreographer, HoverAndLeftButtonPress) {
     mFakePolicy->addDisplayViewport(DISPLAY_ID, DISPLAY_WIDTH, DISPLAY_HEIGHT, ui::ROTATION_0,
                                     /*isActive=*/true, "local:0", NO_PORT, ViewportType::INTERNAL);
 
-    std::list<NotifyArgs> args;
+    NotifyArgsBatch args;
 
     args += mMapper->reconfigure(systemTime(SYSTEM_TIME_MONOTONIC), mReaderConfiguration,
                                  InputReaderConfiguration::Change::DISPLAY_INFO);
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "../dispatcher/WindowHitIndex.h"
+
+// atest inputflinger_tests:WindowHitIndexTest
+
+using android::gui::WindowInfo;
+using android::gui::WindowInfoHandle;
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace android::inputdispatcher {
+
+namespace {
+
+constexpr int32_t DISPLAY_WIDTH = 1000;
+constexpr int32_t DISPLAY_HEIGHT = 2000;
+
+sp<WindowInfoHandle> createWindow(const Rect& frame) {
+    WindowInfo info;
+    info.frame = frame;
+    info.touchableRegion = Region(frame);
+    return sp<WindowInfoHandle>::make(info);
+}
+
+} // namespace
+
+TEST(WindowHitIndexTest, EmptyIndex_ReturnsNoCandidates) {
+    WindowHitIndex index;
+    ASSERT_THAT(index.touchCandidatesAt(10, 10), IsEmpty());
+    ASSERT_THAT(index.frameCandidatesAt(10, 10), IsEmpty());
+    ASSERT_FALSE(index.indexOf(createWindow(Rect(0, 0, 10, 10))).has_value());
+}
+
+TEST(WindowHitIndexTest, CandidatesAreReturnedInZOrder) {
+    std::vector<sp<WindowInfoHandle>> windows;
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+    windows.push_back(createWindow(Rect(500, 500, 600, 600)));
+    windows.push_back(createWindow(Rect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT)));
+
+    WindowHitIndex index(windows, ui::Transform(), Rect(DISPLAY_WIDTH, DISPLAY_HEIGHT));
+
+    ASSERT_THAT(index.touchCandidatesAt(50, 50), ElementsAre(0u, 2u));
+    ASSERT_THAT(index.touchCandidatesAt(550, 550), ElementsAre(1u, 2u));
+    ASSERT_THAT(index.touchCandidatesAt(900, 1900), ElementsAre(2u));
+    ASSERT_THAT(index.frameCandidatesAt(550, 550), ElementsAre(1u, 2u));
+    ASSERT_EQ(std::optional<size_t>(1), index.indexOf(windows[1]));
+}
+
+TEST(WindowHitIndexTest, InvisibleAndUntouchableWindows_AreSkipped) {
+    std::vector<sp<WindowInfoHandle>> windows;
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+    windows[0]->editInfo()->setInputConfig(WindowInfo::InputConfig::NOT_VISIBLE, true);
+    windows[1]->editInfo()->setInputConfig(WindowInfo::InputConfig::NOT_TOUCHABLE, true);
+
+    WindowHitIndex index(windows, ui::Transform(), Rect(DISPLAY_WIDTH, DISPLAY_HEIGHT));
+
+    ASSERT_THAT(index.touchCandidatesAt(50, 50), IsEmpty());
+    // Untouchable windows can still obscure the windows below them.
+    ASSERT_THAT(index.frameCandidatesAt(50, 50), ElementsAre(1u));
+}
+
+TEST(WindowHitIndexTest, WindowsOutsideOfDisplay_AreStillFound) {
+    std::vector<sp<WindowInfoHandle>> windows;
+    windows.push_back(createWindow(Rect(-100, -100, 2 * DISPLAY_WIDTH, 50)));
+    windows.push_back(createWindow(Rect(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT)));
+
+    WindowHitIndex index(windows, ui::Transform(), Rect(DISPLAY_WIDTH, DISPLAY_HEIGHT));
+
+    ASSERT_THAT(index.touchCandidatesAt(-50, -50), ElementsAre(0u));
+    ASSERT_THAT(index.touchCandidatesAt(1500, 10), ElementsAre(0u));
+    ASSERT_THAT(index.touchCandidatesAt(10, 10), ElementsAre(0u, 1u));
+}
+
+TEST(WindowHitIndexTest, TouchableRegionsAreIndexedInLogicalDisplaySpace) {
+    std::vector<sp<WindowInfoHandle>> windows;
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+
+    // Translate the display so that display coordinates (x, y) map to (x + 200, y + 300).
+    ui::Transform displayTransform;
+    displayTransform.set(200, 300);
+    WindowHitIndex index(windows, displayTransform, Rect(DISPLAY_WIDTH, DISPLAY_HEIGHT));
+
+    ASSERT_THAT(index.touchCandidatesAt(50, 50), ElementsAre(0u));
+    ASSERT_THAT(index.touchCandidatesAt(150, 150), IsEmpty());
+    ASSERT_THAT(index.frameCandidatesAt(50, 50), ElementsAre(0u));
+}
+
+TEST(WindowHitIndexTest, WatchOutsideTouchWindows) {
+    std::vector<sp<WindowInfoHandle>> windows;
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+    windows.push_back(createWindow(Rect(0, 0, 100, 100)));
+    windows[0]->editInfo()->setInputConfig(WindowInfo::InputConfig::WATCH_OUTSIDE_TOUCH, true);
+    windows[2]->editInfo()->setInputConfig(WindowInfo::InputConfig::WATCH_OUTSIDE_TOUCH, true);
+
+    WindowHitIndex index(windows, ui::Transform(), std::nullopt);
+
+    ASSERT_THAT(index.watchOutsideTouchWindows(), ElementsAre(0u, 2u));
+}
+
+} // namespace android::inputdispatcher
@@ -354,7 +354,7 @@ public:
     void requestTimeoutAtTime(nsecs_t when) override {}
     int32_t bumpGeneration() override { return mFdp->ConsumeIntegral<int32_t>(); }
     void getExternalStylusDevices(std::vector<InputDeviceInfo>& outDevices) override {}
-    std::list<NotifyArgs> dispatchExternalStylusState(const StylusState& outState) override {
+    NotifyArgsBatch dispatchExternalStylusState(const StylusState& outState) override {
         return {};
     }
     InputReaderPolicyInterface* getPolicy() override { return mPolicy.get(); }
@@ -388,7 +388,7 @@ InputDevice getFuzzedInputDevice(Fdp& fdp, FuzzInputReaderContext* context) {
 template <class Fdp>
 void configureAndResetDevice(Fdp& fdp, InputDevice& device) {
     nsecs_t arbitraryTime = fdp.template ConsumeIntegral<nsecs_t>();
-    std::list<NotifyArgs> out;
+    NotifyArgsBatch out;
     out += device.configure(arbitraryTime, /*readerConfig=*/{}, /*changes=*/{});
     out += device.reset(arbitraryTime);
 }
@@ -90,17 +90,17 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t* data, size_t size) {
                 },
                 [&]() -> void { mapper.getSources(); },
                 [&]() -> void {
-                    std::list<NotifyArgs> unused =
+                    NotifyArgsBatch unused =
                             mapper.reconfigure(fdp->ConsumeIntegral<nsecs_t>(), policyConfig,
                                                InputReaderConfiguration::Change(
                                                        fdp->ConsumeIntegral<uint32_t>()));
                 },
                 [&]() -> void {
-                    std::list<NotifyArgs> unused = mapper.reset(fdp->ConsumeIntegral<nsecs_t>());
+                    NotifyArgsBatch unused = mapper.reset(fdp->ConsumeIntegral<nsecs_t>());
                 },
                 [&]() -> void {
                     RawEvent rawEvent = getFuzzedRawEvent(*fdp);
-                    std::list<NotifyArgs> unused = mapper.process(&rawEvent);
+                    NotifyArgsBatch unused = mapper.process(&rawEvent);
                 },
                 [&]() -> void {
                     mapper.getKeyCodeState(fdp->ConsumeIntegral<uint32_t>(),
@@ -120,19 +120,19 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t* data, size_t size) {
                                                  nullptr);
                 },
                 [&]() -> void {
-                    std::list<NotifyArgs> unused =
+                    NotifyArgsBatch unused =
                             mapper.cancelTouch(fdp->ConsumeIntegral<nsecs_t>(),
                                                fdp->ConsumeIntegral<nsecs_t>());
                 },
                 [&]() -> void {
-                    std::list<NotifyArgs> unused =
+                    NotifyArgsBatch unused =
                             mapper.timeoutExpired(fdp->ConsumeIntegral<nsecs_t>());
                 },
                 [&]() -> void {
                     StylusState state{fdp->ConsumeIntegral<nsecs_t>(),
                                       fdp->ConsumeFloatingPoint<float>(),
                                       fdp->ConsumeIntegral<uint32_t>(), getFuzzedToolType(*fdp)};
-                    std::list<NotifyArgs> unused = mapper.updateExternalStylusState(state);
+                    NotifyArgsBatch unused = mapper.updateExternalStylusState(state);
                 },
                 [&]() -> void { mapper.getAssociatedDisplayId(); },
         })();
@@ -164,17 +164,17 @@ extern "C" int LLVMFuzzerTestOneInput(uint8_t* data, size_t size) {
                 [&]() -> void {
                     setTouchpadSettings(*fdp, policyConfig);
                     policyConfig.pointerCaptureRequest.enable = fdp->ConsumeBool();
-                    std::list<NotifyArgs> unused =
+                    NotifyArgsBatch unused =
                             mapper.reconfigure(fdp->ConsumeIntegral<nsecs_t>(), policyConfig,
                                                InputReaderConfiguration::Change(
                                                        fdp->ConsumeIntegral<uint32_t>()));
                 },
                 [&]() -> void {
-                    std::list<NotifyArgs> unused = mapper.reset(fdp->ConsumeIntegral<nsecs_t>());
+                    NotifyArgsBatch unused = mapper.reset(fdp->ConsumeIntegral<nsecs_t>());
                 },
                 [&]() -> void {
                     RawEvent event = getFuzzedRawEvent(*fdp);
-                    std::list<NotifyArgs> unused = mapper.process(&event);
+                    NotifyArgsBatch unused = mapper.process(&event);
                 },
         })();
     }
@@ -288,91 +288,83 @@ bool SensorService::SensorEventConnection::incrementPendingFlushCountIfHasAccess
 }
 
 status_t SensorService::SensorEventConnection::sendEvents(
-        sensors_event_t const* buffer, size_t numEvents,
-        sensors_event_t* scratch,
-        wp<const SensorEventConnection> const * mapFlushEventsToConnections) {
-    // filter out events not for this connection
-
-    std::unique_ptr<sensors_event_t[]> sanitizedBuffer;
-
-    int count = 0;
+        sensors_event_t const* buffer, size_t numEvents) {
     Mutex::Autolock _l(mConnectionLock);
-    if (scratch) {
-        size_t i=0;
-        while (i<numEvents) {
-            int32_t sensor_handle = buffer[i].sensor;
+    mGatheredEvents.clear();
+    int index_wake_up_event = -1;
+    if (hasSensorAccess()) {
+        mGatheredEvents.append(buffer, numEvents);
+        index_wake_up_event = findWakeUpSensorEventLocked(buffer, numEvents);
+    } else {
+        for (size_t i = 0; i < numEvents; i++) {
             if (buffer[i].type == SENSOR_TYPE_META_DATA) {
-                ALOGD_IF(DEBUG_CONNECTIONS, "flush complete event sensor==%d ",
-                        buffer[i].meta_data.sensor);
-                // Setting sensor_handle to the correct sensor to ensure the sensor events per
-                // connection are filtered correctly.  buffer[i].sensor is zero for meta_data
-                // events.
-                sensor_handle = buffer[i].meta_data.sensor;
+                mGatheredEvents.append(&buffer[i++], 1);
             }
+        }
+    }
+    return sendGatheredEventsLocked(index_wake_up_event);
+}
 
-            // Check if this connection has registered for this sensor. If not continue to the
-            // next sensor_event.
-            if (mSensorInfo.count(sensor_handle) == 0) {
-                ++i;
-                continue;
-            }
+status_t SensorService::SensorEventConnection::sendEvents(
+        const SensorEventFanOut& fanOut,
+        wp<const SensorEventConnection> const * mapFlushEventsToConnections) {
+    // filter out events not for this connection
+    sensors_event_t const* buffer = fanOut.events();
+    Mutex::Autolock _l(mConnectionLock);
+    mGatheredEvents.clear();
+    const bool sensorAccess = hasSensorAccess();
+    int index_wake_up_event = -1;
+    for (const SensorEventFanOut::Run& run : fanOut.runs()) {
+        // Check if this connection has registered for this sensor. If not continue to the
+        // next run.
+        const auto iter = mSensorInfo.find(run.handle);
+        if (iter == mSensorInfo.end()) {
+            continue;
+        }
 
-            FlushInfo& flushInfo = mSensorInfo[sensor_handle];
-            // Check if there is a pending flush_complete event for this sensor on this connection.
-            if (buffer[i].type == SENSOR_TYPE_META_DATA && flushInfo.mFirstFlushPending == true &&
-                    mapFlushEventsToConnections[i] == this) {
+        FlushInfo& flushInfo = iter->second;
+        size_t i = run.begin;
+        // If there is a pending flush complete event for this sensor on this connection, ignore
+        // the events up to and including it.
+        while (flushInfo.mFirstFlushPending && i < run.end) {
+            if (buffer[i].type == SENSOR_TYPE_META_DATA && mapFlushEventsToConnections[i] == this) {
                 flushInfo.mFirstFlushPending = false;
                 ALOGD_IF(DEBUG_CONNECTIONS, "First flush event for sensor==%d ",
                         buffer[i].meta_data.sensor);
-                ++i;
-                continue;
-            }
-
-            // If there is a pending flush complete event for this sensor on this connection,
-            // ignore the event and proceed to the next.
-            if (flushInfo.mFirstFlushPending) {
-                ++i;
-                continue;
             }
+            ++i;
+        }
 
-            do {
-                // Keep copying events into the scratch buffer as long as they are regular
-                // sensor_events are from the same sensor_handle OR they are flush_complete_events
-                // from the same sensor_handle AND the current connection is mapped to the
-                // corresponding flush_complete_event.
+        const size_t first = mGatheredEvents.size();
+        if (!run.hasMetaData && sensorAccess && mHandleToAppOp.count(run.handle) == 0) {
+            // Regular sensor events that don't need an AppOp, which is the common case: send the
+            // whole run.
+            mGatheredEvents.append(&buffer[i], run.end - i);
+        } else {
+            for (; i < run.end; ++i) {
+                // Send flush_complete_events only if the current connection is mapped to them,
+                // and regular sensor_events after checking the AppOp.
                 if (buffer[i].type == SENSOR_TYPE_META_DATA) {
+                    ALOGD_IF(DEBUG_CONNECTIONS, "flush complete event sensor==%d ",
+                            buffer[i].meta_data.sensor);
                     if (mapFlushEventsToConnections[i] == this) {
-                        scratch[count++] = buffer[i];
-                    }
-                } else {
-                    // Regular sensor event, just copy it to the scratch buffer after checking
-                    // the AppOp.
-                    if (hasSensorAccess() && noteOpIfRequired(buffer[i])) {
-                        scratch[count++] = buffer[i];
+                        mGatheredEvents.append(&buffer[i], 1);
                     }
-                }
-                i++;
-            } while ((i<numEvents) && ((buffer[i].sensor == sensor_handle &&
-                                        buffer[i].type != SENSOR_TYPE_META_DATA) ||
-                                       (buffer[i].type == SENSOR_TYPE_META_DATA  &&
-                                        buffer[i].meta_data.sensor == sensor_handle)));
-        }
-    } else {
-        if (hasSensorAccess()) {
-            scratch = const_cast<sensors_event_t *>(buffer);
-            count = numEvents;
-        } else {
-            sanitizedBuffer.reset(new sensors_event_t[numEvents]);
-            scratch = sanitizedBuffer.get();
-            for (size_t i = 0; i < numEvents; i++) {
-                if (buffer[i].type == SENSOR_TYPE_META_DATA) {
-                    scratch[count++] = buffer[i++];
+                } else if (sensorAccess && noteOpIfRequired(buffer[i])) {
+                    mGatheredEvents.append(&buffer[i], 1);
                 }
             }
         }
+        if (run.wakeUp && index_wake_up_event < 0 && mGatheredEvents.size() > first) {
+            index_wake_up_event = first;
+        }
     }
+    return sendGatheredEventsLocked(index_wake_up_event);
+}
 
+status_t SensorService::SensorEventConnection::sendGatheredEventsLocked(int index_wake_up_event) {
     sendPendingFlushEventsLocked();
+    const int count = mGatheredEvents.size();
     // Early return if there are no events for this connection.
     if (count == 0) {
         return status_t(NO_ERROR);
@@ -382,34 +374,38 @@ status_t SensorService::SensorEventConnection::sendEvents(
      mEventsReceived += count;
 #endif
     if (mCacheSize != 0) {
-        // There are some events in the cache which need to be sent first. Copy this buffer to
+        // There are some events in the cache which need to be sent first. Copy these events to
         // the end of cache.
-        appendEventsToCacheLocked(scratch, count);
+        appendEventsToCacheLocked(mGatheredEvents.flatten(), count);
         return status_t(NO_ERROR);
     }
 
-    int index_wake_up_event = -1;
-    if (hasSensorAccess()) {
-        index_wake_up_event = findWakeUpSensorEventLocked(scratch, count);
-        if (index_wake_up_event >= 0) {
-            BatteryService::noteWakeupSensorEvent(scratch[index_wake_up_event].timestamp,
-                                                  mUid, scratch[index_wake_up_event].sensor);
-            scratch[index_wake_up_event].flags |= WAKE_UP_SENSOR_EVENT_NEEDS_ACK;
-            ++mWakeLockRefCount;
+    // The events may be shared with other connections, so the flag is set on a copy of the
+    // wake_up sensor_event.
+    sensors_event_t* wakeUpEvent = nullptr;
+    if (hasSensorAccess() && index_wake_up_event >= 0) {
+        wakeUpEvent = mGatheredEvents.editEvent(index_wake_up_event);
+        BatteryService::noteWakeupSensorEvent(wakeUpEvent->timestamp, mUid, wakeUpEvent->sensor);
+        wakeUpEvent->flags |= WAKE_UP_SENSOR_EVENT_NEEDS_ACK;
+        ++mWakeLockRefCount;
 #if DEBUG_CONNECTIONS
-            ++mTotalAcksNeeded;
+        ++mTotalAcksNeeded;
 #endif
-        }
     }
 
     // NOTE: ASensorEvent and sensors_event_t are the same type.
-    ssize_t size = SensorEventQueue::write(mChannel,
-                                    reinterpret_cast<ASensorEvent const*>(scratch), count);
+    ssize_t size = mGatheredEvents.isFragmented()
+            ? SensorEventQueue::write(mChannel,
+                                      reinterpret_cast<ASensorEvent const*>(
+                                              mGatheredEvents.flatten()),
+                                      count)
+            : SensorEventQueue::write(mChannel, mGatheredEvents.buffers(),
+                                      mGatheredEvents.bufferCount());
     if (size < 0) {
         // Write error, copy events to local cache.
-        if (index_wake_up_event >= 0) {
+        if (wakeUpEvent != nullptr) {
             // If there was a wake_up sensor_event, reset the flag.
-            scratch[index_wake_up_event].flags &= ~WAKE_UP_SENSOR_EVENT_NEEDS_ACK;
+            wakeUpEvent->flags &= ~WAKE_UP_SENSOR_EVENT_NEEDS_ACK;
             if (mWakeLockRefCount > 0) {
                 --mWakeLockRefCount;
             }
@@ -423,7 +419,7 @@ status_t SensorService::SensorEventConnection::sendEvents(
             mCacheSize = 0;
         }
         // Save the events so that they can be written later
-        appendEventsToCacheLocked(scratch, count);
+        appendEventsToCacheLocked(mGatheredEvents.flatten(), count);
 
         // Add this file descriptor to the looper to get a callback when this fd is available for
         // writing.
@@ -38,6 +38,7 @@
 #include <sensor/ISensorServer.h>
 #include <sensor/ISensorEventConnection.h>
 
+#include "SensorEventFanOut.h"
 #include "SensorService.h"
 
 namespace android {
@@ -54,8 +55,13 @@ public:
                           bool isDataInjectionMode, const String16& opPackageName,
                           const String16& attributionTag);
 
-    status_t sendEvents(sensors_event_t const* buffer, size_t count, sensors_event_t* scratch,
-                        wp<const SensorEventConnection> const * mapFlushEventsToConnections = nullptr);
+    // Sends all the events, or only the flush complete events if the connection has no sensor
+    // access.
+    status_t sendEvents(sensors_event_t const* buffer, size_t count);
+    // Sends the events of the sensors registered by this connection. mapFlushEventsToConnections
+    // holds the connection each flush complete event of fanOut was requested by.
+    status_t sendEvents(const SensorEventFanOut& fanOut,
+                        wp<const SensorEventConnection> const * mapFlushEventsToConnections);
     bool hasSensor(int32_t handle) const;
     bool hasAnySensor() const;
     bool hasOneShotSensors() const;
@@ -96,6 +102,11 @@ private:
     // flag set. SOCK_SEQPACKET ensures that either the entire packet is read or dropped.
     int findWakeUpSensorEventLocked(sensors_event_t const* scratch, int count);
 
+    // Writes mGatheredEvents to the socket, or to the cache if events are already waiting there or
+    // the write fails. index_wake_up_event is the index of the first wake_up sensor_event in
+    // mGatheredEvents, or -1 if there is none.
+    status_t sendGatheredEventsLocked(int index_wake_up_event);
+
     // Send pending flush_complete events. There may have been flush_complete_events that are
     // dropped which need to be sent separately before other events. On older HALs (1_0) this method
     // emulates the behavior of flush().
@@ -179,6 +190,8 @@ private:
     // protected by SensorService::mLock. Key for this map is the sensor handle.
     std::unordered_map<int32_t, FlushInfo> mSensorInfo;
 
+    // The events being sent by sendEvents(), kept to reuse its memory.
+    GatheredSensorEvents mGatheredEvents;
     sensors_event_t *mEventCache;
     int mCacheSize, mMaxCacheSize;
     int64_t mTimeOfLastEventDrop;
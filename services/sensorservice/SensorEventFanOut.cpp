@@ -0,0 +1,125 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SensorEventFanOut.h"
+
+#include <log/log.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace android {
+
+void SensorEventFanOut::index(const sensors_event_t* events, size_t count,
+                              const std::function<bool(int32_t handle)>& isWakeUpSensor) {
+    mEvents = events;
+    mSize = count;
+    mRuns.clear();
+    mWakeUpSensors.clear();
+    for (size_t i = 0; i < count; i++) {
+        const bool metaData = events[i].type == SENSOR_TYPE_META_DATA;
+        // events[i].sensor is zero for flush complete events.
+        const int32_t handle = metaData ? events[i].meta_data.sensor : events[i].sensor;
+        if (!mRuns.empty() && mRuns.back().handle == handle) {
+            mRuns.back().end = i + 1;
+            mRuns.back().hasMetaData |= metaData;
+            continue;
+        }
+        // Events of different sensors are often interleaved, so remember the sensors looked up.
+        auto it = std::lower_bound(mWakeUpSensors.begin(), mWakeUpSensors.end(), handle,
+                                   [](const std::pair<int32_t, bool>& sensor, int32_t handle) {
+                                       return sensor.first < handle;
+                                   });
+        if (it == mWakeUpSensors.end() || it->first != handle) {
+            it = mWakeUpSensors.insert(it, {handle, isWakeUpSensor(handle)});
+        }
+        mRuns.push_back({.handle = handle,
+                         .begin = i,
+                         .end = i + 1,
+                         .hasMetaData = metaData,
+                         .wakeUp = it->second});
+    }
+}
+
+void GatheredSensorEvents::clear() {
+    mBuffers.clear();
+    mSize = 0;
+    mHasEditedEvent = false;
+}
+
+void GatheredSensorEvents::append(const sensors_event_t* events, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    mSize += count;
+    if (!mBuffers.empty()) {
+        struct iovec& last = mBuffers.back();
+        if (static_cast<const char*>(last.iov_base) + last.iov_len ==
+            reinterpret_cast<const char*>(events)) {
+            last.iov_len += count * sizeof(sensors_event_t);
+            return;
+        }
+    }
+    mBuffers.push_back({.iov_base = const_cast<sensors_event_t*>(events),
+                        .iov_len = count * sizeof(sensors_event_t)});
+}
+
+sensors_event_t* GatheredSensorEvents::editEvent(size_t index) {
+    LOG_ALWAYS_FATAL_IF(mHasEditedEvent, "Only one gathered sensor event can be edited");
+    LOG_ALWAYS_FATAL_IF(index >= mSize, "Gathered sensor event %zu out of range (%zu)", index,
+                        mSize);
+    size_t first = 0;
+    for (auto it = mBuffers.begin(); it != mBuffers.end(); ++it) {
+        const size_t count = it->iov_len / sizeof(sensors_event_t);
+        if (index >= first + count) {
+            first += count;
+            continue;
+        }
+        // Split the buffer around the event, and point to the copy in between.
+        sensors_event_t* events = static_cast<sensors_event_t*>(it->iov_base);
+        const size_t offset = index - first;
+        mEditedEvent = events[offset];
+        mHasEditedEvent = true;
+        const struct iovec after = {.iov_base = events + offset + 1,
+                                    .iov_len = (count - offset - 1) * sizeof(sensors_event_t)};
+        const struct iovec edited = {.iov_base = &mEditedEvent,
+                                     .iov_len = sizeof(sensors_event_t)};
+        if (offset == 0) {
+            *it = edited;
+        } else {
+            it->iov_len = offset * sizeof(sensors_event_t);
+            it = mBuffers.insert(it + 1, edited);
+        }
+        if (after.iov_len != 0) {
+            mBuffers.insert(it + 1, after);
+        }
+        break;
+    }
+    return &mEditedEvent;
+}
+
+const sensors_event_t* GatheredSensorEvents::flatten() {
+    mFlattened.resize(mSize);
+    char* dst = reinterpret_cast<char*>(mFlattened.data());
+    for (const struct iovec& buffer : mBuffers) {
+        memcpy(dst, buffer.iov_base, buffer.iov_len);
+        dst += buffer.iov_len;
+    }
+    return mFlattened.data();
+}
+
+} // namespace android
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ANDROID_SENSOR_EVENT_FAN_OUT_H
+#define ANDROID_SENSOR_EVENT_FAN_OUT_H
+
+#include <hardware/sensors.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace android {
+
+// Events polled from the HAL, grouped once per poll into runs of consecutive events of the same
+// sensor, so that each connection can pick the events it registered for run by run rather than
+// event by event. Flush complete events belong to the run of the sensor they were flushed for.
+class SensorEventFanOut {
+public:
+    struct Run {
+        int32_t handle;
+        // Range of the events of this run in the indexed buffer.
+        size_t begin;
+        size_t end;
+        // Whether the run contains flush complete events, which are only sent to some of the
+        // connections of the sensor.
+        bool hasMetaData;
+        bool wakeUp;
+    };
+
+    // Indexes count events from events, which must stay valid and unchanged until the events
+    // have been sent. isWakeUpSensor is called once for each sensor that has events.
+    void index(const sensors_event_t* events, size_t count,
+               const std::function<bool(int32_t handle)>& isWakeUpSensor);
+
+    const sensors_event_t* events() const { return mEvents; }
+    size_t size() const { return mSize; }
+    const std::vector<Run>& runs() const { return mRuns; }
+
+private:
+    const sensors_event_t* mEvents = nullptr;
+    size_t mSize = 0;
+    // Kept across polls so that indexing does not allocate once they have grown to the number of
+    // runs and sensors of a poll.
+    std::vector<Run> mRuns;
+    // Whether each sensor with events in the poll is a wake up sensor, sorted by handle. A poll
+    // only has events of a few sensors, so a sorted vector beats hashing, and unlike a map it
+    // keeps its storage when cleared.
+    std::vector<std::pair<int32_t, bool>> mWakeUpSensors;
+};
+
+// The events sent to a connection in one write, gathered from the buffers they are in rather than
+// copied into one. Ranges that are contiguous in memory are merged.
+class GatheredSensorEvents {
+public:
+    void clear();
+    void append(const sensors_event_t* events, size_t count);
+
+    // Number of gathered events.
+    size_t size() const { return mSize; }
+
+    const struct iovec* buffers() const { return mBuffers.data(); }
+    size_t bufferCount() const { return mBuffers.size(); }
+
+    // Whether the events are spread over so many buffers that copying them into one costs less
+    // than having the kernel gather them. This is typically the case when a connection receives
+    // some of several sensors whose events are interleaved.
+    bool isFragmented() const { return mSize < kMinEventsPerBuffer * mBuffers.size(); }
+
+    // Replaces the event at index with a copy that can be modified, and returns the copy. Only one
+    // event can be edited until the next clear().
+    sensors_event_t* editEvent(size_t index);
+
+    // Copies the gathered events into a contiguous buffer, which stays valid until the next call.
+    const sensors_event_t* flatten();
+
+private:
+    static constexpr size_t kMinEventsPerBuffer = 4;
+
+    std::vector<struct iovec> mBuffers;
+    size_t mSize = 0;
+    bool mHasEditedEvent = false;
+    sensors_event_t mEditedEvent;
+    std::vector<sensors_event_t> mFlattened;
+};
+
+} // namespace android
+
+#endif // ANDROID_SENSOR_EVENT_FAN_OUT_H
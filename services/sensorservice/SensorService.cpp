@@ -470,7 +470,6 @@ void SensorService::onFirstRef() {
             mLooper = new Looper(false);
             const size_t minBufferSize = SensorEventQueue::MAX_RECEIVE_BUFFER_EVENT_COUNT;
             mSensorEventBuffer = new sensors_event_t[minBufferSize];
-            mSensorEventScratch = new sensors_event_t[minBufferSize];
             mRuntimeSensorEventBuffer = nullptr;
             mMapFlushEventsToConnections = new wp<const SensorEventConnection> [minBufferSize];
             mCurrentOperatingMode = NORMAL;
@@ -1220,12 +1219,15 @@ bool SensorService::threadLoop() {
             }
         }
 
+        // Group the events by sensor once, rather than once per client.
+        mSensorEventFanOut.index(mSensorEventBuffer, count,
+                                 [this](int32_t handle) { return isWakeUpSensor(handle); });
+
         // Send our events to clients. Check the state of wake lock for each client and release the
         // lock if none of the clients need it.
         bool needsWakeLock = false;
         for (const sp<SensorEventConnection>& connection : activeConnections) {
-            connection->sendEvents(mSensorEventBuffer, count, mSensorEventScratch,
-                                   mMapFlushEventsToConnections);
+            connection->sendEvents(mSensorEventFanOut, mMapFlushEventsToConnections);
             needsWakeLock |= connection->needsWakeLock();
             // If the connection has one-shot sensors, it may be cleaned up after first trigger.
             // Early check for one-shot sensors.
@@ -1275,8 +1277,7 @@ void SensorService::processRuntimeSensorEvents() {
         sortEventBuffer(mRuntimeSensorEventBuffer, count);
 
         for (const sp<SensorEventConnection>& connection : connLock.getActiveConnections()) {
-            connection->sendEvents(mRuntimeSensorEventBuffer, count, /* scratch= */ nullptr,
-                                   /* mapFlushEventsToConnections= */ nullptr);
+            connection->sendEvents(mRuntimeSensorEventBuffer, count);
             if (connection->hasOneShotSensors()) {
                 cleanupAutoDisabledSensorLocked(connection, mRuntimeSensorEventBuffer, count);
             }
@@ -1384,6 +1385,10 @@ bool SensorService::isWakeUpSensorEvent(const sensors_event_t& event) const {
     if (event.type == SENSOR_TYPE_META_DATA) {
         handle = event.meta_data.sensor;
     }
+    return isWakeUpSensor(handle);
+}
+
+bool SensorService::isWakeUpSensor(int handle) const {
     std::shared_ptr<SensorInterface> sensor = getSensorInterfaceFromHandle(handle);
     return sensor != nullptr && sensor->getSensor().isWakeUpSensor();
 }
@@ -2032,7 +2037,7 @@ status_t SensorService::enable(const sp<SensorEventConnection>& connection,
                             if (isWakeUpSensorEvent(event) && !mWakeLockAcquired) {
                                 setWakeLockAcquiredLocked(true);
                             }
-                            connection->sendEvents(&event, 1, nullptr);
+                            connection->sendEvents(&event, 1);
                             if (!connection->needsWakeLock() && mWakeLockAcquired) {
                                 checkWakeLockStateLocked(&connLock);
                             }
@@ -19,6 +19,7 @@
 
 #include "SensorList.h"
 #include "RecentEventLogger.h"
+#include "SensorEventFanOut.h"
 
 #include <android-base/macros.h>
 #include <binder/AppOpsManager.h>
@@ -438,6 +439,7 @@ private:
     void checkWakeLockStateLocked(ConnectionSafeAutolock* connLock);
     bool isWakeLockAcquired();
     bool isWakeUpSensorEvent(const sensors_event_t& event) const;
+    bool isWakeUpSensor(int handle) const;
 
     sp<Looper> getLooper() const;
 
@@ -545,7 +547,9 @@ private:
     std::unordered_set<int> mActiveVirtualSensors;
     SensorConnectionHolder mConnectionHolder;
     bool mWakeLockAcquired;
-    sensors_event_t *mSensorEventBuffer, *mSensorEventScratch, *mRuntimeSensorEventBuffer;
+    sensors_event_t *mSensorEventBuffer, *mRuntimeSensorEventBuffer;
+    // The events of mSensorEventBuffer grouped by sensor, for sending them to the connections.
+    SensorEventFanOut mSensorEventFanOut;
     // WARNING: these SensorEventConnection instances must not be promoted to sp, except via
     // modification to add support for them in ConnectionSafeAutolock
     wp<const SensorEventConnection> * mMapFlushEventsToConnections;
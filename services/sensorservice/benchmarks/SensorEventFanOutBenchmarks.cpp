@@ -0,0 +1,198 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include <android/sensor.h>
+#include <sensor/BitTube.h>
+#include <sensor/SensorEventQueue.h>
+
+#include <unordered_set>
+#include <vector>
+
+#include "ISensorHalWrapper.h"
+#include "SensorEventFanOut.h"
+
+using namespace android;
+
+namespace {
+
+static constexpr size_t kMaxEvents = SensorEventQueue::MAX_RECEIVE_BUFFER_EVENT_COUNT;
+static constexpr size_t kConnectionCount = 50;
+static constexpr int64_t kImuPeriodNs = 1'000'000; // 1kHz
+
+// A HAL with a few IMUs reporting at 1kHz, whose events are polled every pollPeriodNs.
+class FakeImuHalWrapper : public ISensorHalWrapper {
+public:
+    FakeImuHalWrapper(size_t imuCount, int64_t pollPeriodNs)
+          : mImuCount(imuCount), mPollPeriodNs(pollPeriodNs) {}
+
+    bool connect(SensorDeviceCallback* /*callback*/) override { return true; }
+    void prepareForReconnect() override {}
+    bool supportsPolling() override { return true; }
+    bool supportsMessageQueues() override { return false; }
+
+    // Returns the events of all the IMUs since the last poll, interleaved by timestamp.
+    ssize_t poll(sensors_event_t* buffer, size_t count) override {
+        const int64_t end = mTimestamp + mPollPeriodNs;
+        size_t n = 0;
+        for (; mTimestamp < end; mTimestamp += kImuPeriodNs) {
+            for (size_t imu = 0; imu < mImuCount && n < count; imu++) {
+                sensors_event_t& event = buffer[n++];
+                event = {};
+                event.version = sizeof(sensors_event_t);
+                event.sensor = static_cast<int32_t>(imu + 1);
+                event.type = SENSOR_TYPE_ACCELEROMETER;
+                event.timestamp = mTimestamp;
+            }
+        }
+        return static_cast<ssize_t>(n);
+    }
+
+    ssize_t pollFmq(sensors_event_t* buffer, size_t maxNumEventsToRead) override {
+        return poll(buffer, maxNumEventsToRead);
+    }
+
+    std::vector<sensor_t> getSensorsList() override {
+        std::vector<sensor_t> sensors(mImuCount);
+        for (size_t imu = 0; imu < mImuCount; imu++) {
+            sensors[imu].handle = static_cast<int>(imu + 1);
+            sensors[imu].type = SENSOR_TYPE_ACCELEROMETER;
+            sensors[imu].minDelay = static_cast<int32_t>(kImuPeriodNs / 1000);
+        }
+        return sensors;
+    }
+
+    status_t setOperationMode(SensorService::Mode /*mode*/) override { return OK; }
+    status_t activate(int32_t /*sensorHandle*/, bool /*enabled*/) override { return OK; }
+    status_t batch(int32_t /*sensorHandle*/, int64_t /*samplingPeriodNs*/,
+                   int64_t /*maxReportLatencyNs*/) override {
+        return OK;
+    }
+    status_t flush(int32_t /*sensorHandle*/) override { return OK; }
+    status_t injectSensorData(const sensors_event_t* /*event*/) override { return OK; }
+    status_t registerDirectChannel(const sensors_direct_mem_t* /*memory*/,
+                                   int32_t* /*channelHandle*/) override {
+        return INVALID_OPERATION;
+    }
+    status_t unregisterDirectChannel(int32_t /*channelHandle*/) override { return OK; }
+    status_t configureDirectChannel(int32_t /*sensorHandle*/, int32_t /*channelHandle*/,
+                                    const struct sensors_direct_cfg_t* /*config*/) override {
+        return INVALID_OPERATION;
+    }
+    void writeWakeLockHandled(uint32_t /*count*/) override {}
+
+private:
+    const size_t mImuCount;
+    const int64_t mPollPeriodNs;
+    int64_t mTimestamp = 0;
+};
+
+struct FakeConnection {
+    sp<BitTube> channel;
+    std::unordered_set<int32_t> handles;
+};
+
+// Each connection registers for some of the IMUs, so that connections get different events.
+std::vector<FakeConnection> createConnections(size_t imuCount) {
+    std::vector<FakeConnection> connections(kConnectionCount);
+    for (size_t i = 0; i < kConnectionCount; i++) {
+        connections[i].channel = new BitTube(kMaxEvents * sizeof(ASensorEvent));
+        for (size_t imu = 0; imu < imuCount; imu++) {
+            if (imu == 0 || (i + imu) % 3 != 0) {
+                connections[i].handles.insert(static_cast<int32_t>(imu + 1));
+            }
+        }
+    }
+    return connections;
+}
+
+// Reads what was sent, as the apps would.
+void drain(const std::vector<FakeConnection>& connections) {
+    ASensorEvent events[kMaxEvents];
+    for (const FakeConnection& connection : connections) {
+        while (BitTube::recvObjects(connection.channel, events, kMaxEvents) > 0) {
+        }
+    }
+}
+
+// Copies the events of each connection into a scratch buffer before writing them, which is what
+// SensorService did before SensorEventFanOut.
+void BM_SensorEventFanOut_Copy(benchmark::State& state) {
+    const size_t imuCount = static_cast<size_t>(state.range(0));
+    FakeImuHalWrapper hal(imuCount, state.range(1));
+    std::vector<FakeConnection> connections = createConnections(imuCount);
+    std::vector<sensors_event_t> buffer(kMaxEvents);
+    std::vector<sensors_event_t> scratch(kMaxEvents);
+    for (auto _ : state) {
+        const ssize_t count = hal.poll(buffer.data(), buffer.size());
+        for (const FakeConnection& connection : connections) {
+            size_t n = 0;
+            for (ssize_t i = 0; i < count; i++) {
+                if (connection.handles.count(buffer[i].sensor) != 0) {
+                    scratch[n++] = buffer[i];
+                }
+            }
+            SensorEventQueue::write(connection.channel,
+                                    reinterpret_cast<ASensorEvent const*>(scratch.data()), n);
+        }
+        state.PauseTiming();
+        drain(connections);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_SensorEventFanOut_Copy)->ArgsProduct({{1, 2, 6}, {1'000'000, 4'000'000}});
+
+// Indexes the events once, and gathers the runs of each connection into a single write, like
+// SensorEventConnection does.
+void BM_SensorEventFanOut_Gathered(benchmark::State& state) {
+    const size_t imuCount = static_cast<size_t>(state.range(0));
+    FakeImuHalWrapper hal(imuCount, state.range(1));
+    std::vector<FakeConnection> connections = createConnections(imuCount);
+    std::vector<sensors_event_t> buffer(kMaxEvents);
+    SensorEventFanOut fanOut;
+    GatheredSensorEvents gathered;
+    for (auto _ : state) {
+        const ssize_t count = hal.poll(buffer.data(), buffer.size());
+        fanOut.index(buffer.data(), static_cast<size_t>(count),
+                     [](int32_t /*handle*/) { return false; });
+        for (const FakeConnection& connection : connections) {
+            gathered.clear();
+            for (const SensorEventFanOut::Run& run : fanOut.runs()) {
+                if (connection.handles.count(run.handle) != 0) {
+                    gathered.append(&buffer[run.begin], run.end - run.begin);
+                }
+            }
+            if (gathered.isFragmented()) {
+                SensorEventQueue::write(connection.channel,
+                                        reinterpret_cast<ASensorEvent const*>(gathered.flatten()),
+                                        gathered.size());
+            } else {
+                SensorEventQueue::write(connection.channel, gathered.buffers(),
+                                        gathered.bufferCount());
+            }
+        }
+        state.PauseTiming();
+        drain(connections);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_SensorEventFanOut_Gathered)->ArgsProduct({{1, 2, 6}, {1'000'000, 4'000'000}});
+
+} // namespace
+
+BENCHMARK_MAIN();
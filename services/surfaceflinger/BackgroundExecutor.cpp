@@ -37,6 +37,12 @@ BackgroundExecutor::BackgroundExecutor() : Singleton<BackgroundExecutor>() {
         while (!mDone) {
             LOG_ALWAYS_FATAL_IF(sem_wait(&mSemaphore), "sem_wait failed (%d)", errno);
             auto callbacks = mCallbacksQueue.pop();
+            // Each post matches one push, but pop skips values that a producer is still writing.
+            // This is a background thread, so retry rather than lose the post.
+            while (!callbacks && !mCallbacksQueue.isEmpty()) {
+                std::this_thread::yield();
+                callbacks = mCallbacksQueue.pop();
+            }
             if (!callbacks) {
                 continue;
             }
@@ -18,8 +18,13 @@
 
 #include <compositionengine/CompositionEngine.h>
 
+#include <memory>
+#include <vector>
+
 namespace android::compositionengine::impl {
 
+class HwcAsyncWorker;
+
 class CompositionEngine : public compositionengine::CompositionEngine {
 public:
     CompositionEngine();
@@ -57,11 +62,17 @@ public:
     void setNeedsAnotherUpdateForTest(bool);
 
 private:
+    // Prepares the outputs for presenting, on several threads if multithreaded.
+    void prepareOutputs(const CompositionRefreshArgs&, bool multithreaded);
+
     std::unique_ptr<HWComposer> mHwComposer;
     renderengine::RenderEngine* mRenderEngine;
     std::shared_ptr<TimeStats> mTimeStats;
     bool mNeedsAnotherUpdate = false;
     nsecs_t mRefreshStartTime = 0;
+
+    // Threads preparing all outputs but one, when they are prepared concurrently.
+    std::vector<std::unique_ptr<HwcAsyncWorker>> mPrepareWorkers;
 };
 
 std::unique_ptr<compositionengine::CompositionEngine> createCompositionEngine();
@@ -33,6 +33,9 @@ namespace android::compositionengine::impl {
 // When the worker returns with a value, the composition continues if the prediction
 // was successful otherwise the client composition is re-executed.
 //
+// The same real time threads also run HWC present for offloaded displays, and
+// prepare outputs concurrently, see CompositionEngine::present.
+//
 // Note: This does not alter the sequence between HWC and surfaceflinger.
 class HwcAsyncWorker final {
 public:
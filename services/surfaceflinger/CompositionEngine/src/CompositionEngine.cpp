@@ -20,6 +20,7 @@
 #include <compositionengine/OutputLayer.h>
 #include <compositionengine/impl/CompositionEngine.h>
 #include <compositionengine/impl/Display.h>
+#include <compositionengine/impl/HwcAsyncWorker.h>
 #include <ui/DisplayMap.h>
 
 #include <renderengine/RenderEngine.h>
@@ -90,25 +91,41 @@ nsecs_t CompositionEngine::getLastFrameRefreshTimestamp() const {
 }
 
 namespace {
-void offloadOutputs(Outputs& outputs) {
+bool isHwcOutput(const compositionengine::Output& output) {
+    return ftl::Optional(output.getDisplayId()).and_then(HalDisplayId::tryCast).has_value();
+}
+
+// Whether HWC may be called for the outputs from several threads at once, which
+// is the case if every enabled HWC-enabled output supports it.
+bool supportsMultithreadedPresent(const Outputs& outputs) {
     if (!FlagManager::getInstance().multithreaded_present() || outputs.size() < 2) {
-        return;
+        return false;
     }
 
-    ui::PhysicalDisplayVector<compositionengine::Output*> outputsToOffload;
     for (const auto& output : outputs) {
-        if (!ftl::Optional(output->getDisplayId()).and_then(HalDisplayId::tryCast)) {
-            // Not HWC-enabled, so it is always client-composited. No need to offload.
+        if (!isHwcOutput(*output)) {
+            // Not HWC-enabled, so it is always client-composited.
             continue;
         }
         if (!output->getState().isEnabled) {
             continue;
         }
-
-        // Only run present in multiple threads if all HWC-enabled displays
-        // being refreshed support it.
         if (!output->supportsOffloadPresent()) {
-            return;
+            return false;
+        }
+    }
+    return true;
+}
+
+void offloadOutputs(Outputs& outputs) {
+    ui::PhysicalDisplayVector<compositionengine::Output*> outputsToOffload;
+    for (const auto& output : outputs) {
+        if (!isHwcOutput(*output)) {
+            // Not HWC-enabled, so it is always client-composited. No need to offload.
+            continue;
+        }
+        if (!output->getState().isEnabled) {
+            continue;
         }
         outputsToOffload.push_back(output.get());
     }
@@ -133,21 +150,18 @@ void CompositionEngine::present(CompositionRefreshArgs& args) {
 
     preComposition(args);
 
-    {
-        // latchedLayers is used to track the set of front-end layer state that
-        // has been latched across all outputs for the prepare step, and is not
-        // needed for anything else.
-        LayerFESet latchedLayers;
+    // Only run prepare and present in multiple threads if all HWC-enabled
+    // displays being refreshed support it.
+    const bool multithreadedPresent = supportsMultithreadedPresent(args.outputs);
 
-        for (const auto& output : args.outputs) {
-            output->prepare(args, latchedLayers);
-        }
-    }
+    prepareOutputs(args, multithreadedPresent);
 
     // Offloading the HWC call for `present` allows us to simultaneously call it
     // on multiple displays. This is desirable because these calls block and can
     // be slow.
-    offloadOutputs(args.outputs);
+    if (multithreadedPresent) {
+        offloadOutputs(args.outputs);
+    }
 
     ui::DisplayVector<ftl::Future<std::monostate>> presentFutures;
     for (const auto& output : args.outputs) {
@@ -164,6 +178,55 @@ void CompositionEngine::present(CompositionRefreshArgs& args) {
     }
 }
 
+void CompositionEngine::prepareOutputs(const CompositionRefreshArgs& args, bool multithreaded) {
+    // latchedLayers is used to track the set of front-end layer state that
+    // has been latched across all outputs for the prepare step, and is not
+    // needed for anything else.
+    LayerFESet latchedLayers;
+
+    ui::DisplayVector<compositionengine::Output*> outputsToPrepare;
+    for (const auto& output : args.outputs) {
+        // Only enabled outputs are known to support calling HWC from another
+        // thread, and there is little to prepare for the others anyway.
+        if (multithreaded && output->getState().isEnabled) {
+            outputsToPrepare.push_back(output.get());
+        } else {
+            output->prepare(args, latchedLayers);
+        }
+    }
+
+    if (outputsToPrepare.empty()) {
+        return;
+    }
+
+    // Prepare the last output on the main thread, while the workers prepare
+    // the others. The outputs only share the layers, whose front-end state is
+    // not changed while preparing, and the set of latched layers, of which each
+    // worker gets its own.
+    const size_t workerCount = outputsToPrepare.size() - 1;
+    while (mPrepareWorkers.size() < workerCount) {
+        mPrepareWorkers.push_back(std::make_unique<HwcAsyncWorker>());
+    }
+
+    std::vector<LayerFESet> workerLatchedLayers(workerCount);
+    ui::DisplayVector<std::future<bool>> prepareFutures;
+    for (size_t i = 0; i < workerCount; i++) {
+        prepareFutures.push_back(mPrepareWorkers[i]->send(
+                [&args, output = outputsToPrepare[i], layers = &workerLatchedLayers[i]]() {
+                    output->prepare(args, *layers);
+                    return true;
+                }));
+    }
+    outputsToPrepare.back()->prepare(args, latchedLayers);
+
+    {
+        ATRACE_NAME("Waiting on prepare");
+        for (auto& future : prepareFutures) {
+            future.wait();
+        }
+    }
+}
+
 void CompositionEngine::updateCursorAsync(CompositionRefreshArgs& args) {
 
     for (const auto& output : args.outputs) {
@@ -60,10 +60,12 @@ void HwcAsyncWorker::run() {
     std::unique_lock<std::mutex> lock(mMutex);
     android::base::ScopedLockAssertion assumeLock(mMutex);
     while (!mDone) {
-        mCv.wait(lock);
+        // A task may have been sent before this thread first waited.
         if (mTaskRequested && mTask.valid()) {
             mTask();
             mTaskRequested = false;
+        } else {
+            mCv.wait(lock);
         }
     }
 }
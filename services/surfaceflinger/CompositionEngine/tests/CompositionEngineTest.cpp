@@ -29,6 +29,9 @@
 #include "MockHWComposer.h"
 #include "TimeStats/TimeStats.h"
 
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <variant>
 
 using namespace com::android::graphics::surfaceflinger;
@@ -483,5 +486,138 @@ TEST_F(CompositionEngineOffloadTest, disabledDisplaysDoNotPreventOthersFromOfflo
     mEngine.present(mRefreshArgs);
 }
 
+struct CompositionEnginePrepareTest : public CompositionEngineOffloadTest {
+    std::mutex mMutex;
+    std::unordered_map<const compositionengine::Output*, std::thread::id> mPrepareThreads;
+
+    void setOutputs(std::initializer_list<std::shared_ptr<mock::Output>> outputs) {
+        for (auto& output : outputs) {
+            EXPECT_CALL(*output, prepare(Ref(mRefreshArgs), _))
+                    .WillOnce([this, output = output.get()](const CompositionRefreshArgs&,
+                                                            LayerFESet&) {
+                        std::scoped_lock lock(mMutex);
+                        mPrepareThreads[output] = std::this_thread::get_id();
+                    });
+            EXPECT_CALL(*output, present(Ref(mRefreshArgs)))
+                    .WillOnce(Return(ftl::yield<std::monostate>({})));
+
+            mRefreshArgs.outputs.push_back(std::move(output));
+        }
+    }
+
+    bool preparedOnMainThread(const std::shared_ptr<mock::Output>& output) {
+        std::scoped_lock lock(mMutex);
+        return mPrepareThreads.at(output.get()) == std::this_thread::get_id();
+    }
+};
+
+TEST_F(CompositionEnginePrepareTest, preparesOnMultipleThreads) {
+    EXPECT_CALL(*mDisplay1, supportsOffloadPresent).WillOnce(Return(true));
+    EXPECT_CALL(*mDisplay2, supportsOffloadPresent).WillOnce(Return(true));
+
+    EXPECT_CALL(*mDisplay1, offloadPresentNextFrame).Times(1);
+    EXPECT_CALL(*mDisplay2, offloadPresentNextFrame).Times(0);
+
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, true);
+    setOutputs({mDisplay1, mDisplay2});
+
+    mEngine.present(mRefreshArgs);
+
+    EXPECT_FALSE(preparedOnMainThread(mDisplay1));
+    EXPECT_TRUE(preparedOnMainThread(mDisplay2));
+}
+
+TEST_F(CompositionEnginePrepareTest, dependsOnSupport) {
+    EXPECT_CALL(*mDisplay1, supportsOffloadPresent).WillOnce(Return(true));
+    EXPECT_CALL(*mDisplay2, supportsOffloadPresent).WillOnce(Return(false));
+
+    EXPECT_CALL(*mDisplay1, offloadPresentNextFrame).Times(0);
+    EXPECT_CALL(*mDisplay2, offloadPresentNextFrame).Times(0);
+
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, true);
+    setOutputs({mDisplay1, mDisplay2});
+
+    mEngine.present(mRefreshArgs);
+
+    EXPECT_TRUE(preparedOnMainThread(mDisplay1));
+    EXPECT_TRUE(preparedOnMainThread(mDisplay2));
+}
+
+TEST_F(CompositionEnginePrepareTest, dependsOnFlag) {
+    EXPECT_CALL(*mDisplay1, supportsOffloadPresent).Times(0);
+    EXPECT_CALL(*mDisplay2, supportsOffloadPresent).Times(0);
+
+    EXPECT_CALL(*mDisplay1, offloadPresentNextFrame).Times(0);
+    EXPECT_CALL(*mDisplay2, offloadPresentNextFrame).Times(0);
+
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, false);
+    setOutputs({mDisplay1, mDisplay2});
+
+    mEngine.present(mRefreshArgs);
+
+    EXPECT_TRUE(preparedOnMainThread(mDisplay1));
+    EXPECT_TRUE(preparedOnMainThread(mDisplay2));
+}
+
+TEST_F(CompositionEnginePrepareTest, virtualDisplay) {
+    EXPECT_CALL(*mDisplay1, supportsOffloadPresent).WillOnce(Return(true));
+    EXPECT_CALL(*mVirtualDisplay, supportsOffloadPresent).Times(0);
+
+    EXPECT_CALL(*mDisplay1, offloadPresentNextFrame).Times(0);
+    EXPECT_CALL(*mVirtualDisplay, offloadPresentNextFrame).Times(0);
+
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, true);
+    setOutputs({mDisplay1, mVirtualDisplay});
+
+    mEngine.present(mRefreshArgs);
+
+    // Virtual displays without HWC may be prepared concurrently, though their
+    // present is never offloaded.
+    EXPECT_FALSE(preparedOnMainThread(mDisplay1));
+    EXPECT_TRUE(preparedOnMainThread(mVirtualDisplay));
+}
+
+TEST_F(CompositionEnginePrepareTest, disabledDisplaysArePreparedOnMainThread) {
+    // Disable mDisplay2.
+    mOutputStates[1].isEnabled = false;
+    EXPECT_CALL(*mDisplay1, supportsOffloadPresent).WillOnce(Return(true));
+    EXPECT_CALL(*mDisplay2, supportsOffloadPresent).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mHalVirtualDisplay, supportsOffloadPresent).WillOnce(Return(true));
+
+    EXPECT_CALL(*mDisplay1, offloadPresentNextFrame).Times(1);
+    EXPECT_CALL(*mDisplay2, offloadPresentNextFrame).Times(0);
+    EXPECT_CALL(*mHalVirtualDisplay, offloadPresentNextFrame).Times(0);
+
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, true);
+    setOutputs({mDisplay1, mDisplay2, mHalVirtualDisplay});
+
+    mEngine.present(mRefreshArgs);
+
+    EXPECT_FALSE(preparedOnMainThread(mDisplay1));
+    EXPECT_TRUE(preparedOnMainThread(mDisplay2));
+    EXPECT_TRUE(preparedOnMainThread(mHalVirtualDisplay));
+}
+
+TEST_F(CompositionEnginePrepareTest, reusesWorkersAcrossFrames) {
+    EXPECT_CALL(*mDisplay1, supportsOffloadPresent).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mDisplay2, supportsOffloadPresent).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mDisplay1, offloadPresentNextFrame).Times(2);
+
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, true);
+    setOutputs({mDisplay1, mDisplay2});
+    mEngine.present(mRefreshArgs);
+    const std::thread::id firstWorker = [&] {
+        std::scoped_lock lock(mMutex);
+        return mPrepareThreads.at(mDisplay1.get());
+    }();
+
+    mRefreshArgs.outputs.clear();
+    setOutputs({mDisplay1, mDisplay2});
+    mEngine.present(mRefreshArgs);
+
+    std::scoped_lock lock(mMutex);
+    EXPECT_EQ(firstWorker, mPrepareThreads.at(mDisplay1.get()));
+}
+
 } // namespace
 } // namespace android::compositionengine
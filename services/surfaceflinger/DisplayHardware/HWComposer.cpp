@@ -251,7 +251,8 @@ int32_t HWComposer::getAttribute(hal::HWDisplayId hwcDisplayId, hal::HWConfigId
 std::shared_ptr<HWC2::Layer> HWComposer::createLayer(HalDisplayId displayId) {
     RETURN_IF_INVALID_DISPLAY(displayId, nullptr);
 
-    auto expected = mDisplayData[displayId].hwcDisplay->createLayer();
+    // Outputs may be prepared on several threads, so only look up the display.
+    auto expected = mDisplayData.at(displayId).hwcDisplay->createLayer();
     if (!expected.has_value()) {
         auto error = std::move(expected).error();
         RETURN_IF_HWC_ERROR(error, displayId, nullptr);
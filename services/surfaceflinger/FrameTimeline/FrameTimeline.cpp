@@ -25,6 +25,7 @@
 #include <utils/Log.h>
 #include <utils/Trace.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cinttypes>
 #include <numeric>
@@ -817,6 +818,7 @@ FrameTimeline::FrameTimeline(std::shared_ptr<TimeStats> timeStats, pid_t surface
         mJankClassificationThresholds(thresholds) {
     mCurrentDisplayFrame =
             std::make_shared<DisplayFrame>(mTimeStats, thresholds, &mTraceCookieCounter);
+    mCurrentDisplayFrame->setSequence(mNextDisplayFrameSequence++);
 }
 
 void FrameTimeline::onBootFinished() {
@@ -1250,46 +1252,54 @@ float FrameTimeline::computeFps(const std::unordered_set<int32_t>& layerIds) {
         return 0.0f;
     }
 
-    std::vector<nsecs_t> presentTimes;
+    // The number of presented DisplayFrames that contain at least one layer from layerIds, and
+    // the present times of the first and last of them.
+    size_t presentCount = 0;
+    nsecs_t firstPresentTime = 0;
+    nsecs_t lastPresentTime = 0;
     {
-        std::scoped_lock lock(mMutex);
-        presentTimes.reserve(mDisplayFrames.size());
-        for (size_t i = 0; i < mDisplayFrames.size(); i++) {
-            const auto& displayFrame = mDisplayFrames[i];
-            if (displayFrame->getActuals().presentTime <= 0) {
-                continue;
+        std::scoped_lock lock(mFpsMutex);
+        if (layerIds.size() == 1) {
+            const auto it = mLayerPresents.find(*layerIds.begin());
+            if (it != mLayerPresents.end()) {
+                presentCount = it->second.size();
+                firstPresentTime = it->second.front().presentTime;
+                lastPresentTime = it->second.back().presentTime;
             }
-            for (const auto& surfaceFrame : displayFrame->getSurfaceFrames()) {
-                if (surfaceFrame->getPresentState() == SurfaceFrame::PresentState::Presented &&
-                    layerIds.count(surfaceFrame->getLayerId()) > 0) {
-                    // We're looking for DisplayFrames that presents at least one layer from
-                    // layerIds, so push the present time and skip looking through the rest of the
-                    // SurfaceFrames.
-                    presentTimes.push_back(displayFrame->getActuals().presentTime);
-                    break;
+        } else {
+            // A DisplayFrame that presents several of the layers only counts once.
+            std::vector<LayerPresent> presents;
+            for (const int32_t layerId : layerIds) {
+                const auto it = mLayerPresents.find(layerId);
+                if (it != mLayerPresents.end()) {
+                    presents.insert(presents.end(), it->second.begin(), it->second.end());
                 }
             }
+            std::sort(presents.begin(), presents.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.displayFrameSequence < rhs.displayFrameSequence;
+            });
+            presents.erase(std::unique(presents.begin(), presents.end(),
+                                       [](const auto& lhs, const auto& rhs) {
+                                           return lhs.displayFrameSequence ==
+                                                   rhs.displayFrameSequence;
+                                       }),
+                           presents.end());
+            presentCount = presents.size();
+            if (!presents.empty()) {
+                firstPresentTime = presents.front().presentTime;
+                lastPresentTime = presents.back().presentTime;
+            }
         }
     }
 
     // FPS can't be computed when there's fewer than 2 presented frames.
-    if (presentTimes.size() <= 1) {
+    if (presentCount <= 1) {
         return 0.0f;
     }
 
-    nsecs_t priorPresentTime = -1;
-    nsecs_t totalPresentToPresentWalls = 0;
-
-    for (const nsecs_t presentTime : presentTimes) {
-        if (priorPresentTime == -1) {
-            priorPresentTime = presentTime;
-            continue;
-        }
-
-        totalPresentToPresentWalls += (presentTime - priorPresentTime);
-        priorPresentTime = presentTime;
-    }
-
+    // The present-to-present durations of consecutive frames add up to the duration between the
+    // first and the last frame.
+    const nsecs_t totalPresentToPresentWalls = lastPresentTime - firstPresentTime;
     if (CC_UNLIKELY(totalPresentToPresentWalls <= 0)) {
         ALOGW("Invalid total present-to-present duration when computing fps: %" PRId64,
               totalPresentToPresentWalls);
@@ -1300,7 +1310,7 @@ float FrameTimeline::computeFps(const std::unordered_set<int32_t>& layerIds) {
             std::chrono::duration_cast<std::chrono::nanoseconds>(1s).count();
     // (10^9 nanoseconds / second) * (N present deltas) / (total nanoseconds in N present deltas) =
     // M frames / second
-    return kOneSecond * static_cast<nsecs_t>((presentTimes.size() - 1)) /
+    return kOneSecond * static_cast<nsecs_t>((presentCount - 1)) /
             static_cast<float>(totalPresentToPresentWalls);
 }
 
@@ -1335,6 +1345,7 @@ void FrameTimeline::flushPendingPresentFences() {
         auto& displayFrame = pendingPresentFence.second;
         displayFrame->onPresent(signalTime, mPreviousPresentTime);
         displayFrame->trace(mSurfaceFlingerPid, monoBootOffset, mPreviousPresentTime);
+        recordLayerPresents(*displayFrame);
         mPendingPresentFences.erase(mPendingPresentFences.begin());
     }
 
@@ -1351,6 +1362,7 @@ void FrameTimeline::flushPendingPresentFences() {
         auto& displayFrame = pendingPresentFence.second;
         displayFrame->onPresent(signalTime, mPreviousPresentTime);
         displayFrame->trace(mSurfaceFlingerPid, monoBootOffset, mPreviousPresentTime);
+        recordLayerPresents(*displayFrame);
         mPreviousPresentTime = signalTime;
 
         mPendingPresentFences.erase(mPendingPresentFences.begin() + static_cast<int>(i));
@@ -1361,12 +1373,57 @@ void FrameTimeline::flushPendingPresentFences() {
 void FrameTimeline::finalizeCurrentDisplayFrame() {
     while (mDisplayFrames.size() >= mMaxDisplayFrames) {
         // We maintain only a fixed number of frames' data. Pop older frames
+        evictLayerPresents(*mDisplayFrames.front());
         mDisplayFrames.pop_front();
     }
     mDisplayFrames.push_back(mCurrentDisplayFrame);
     mCurrentDisplayFrame.reset();
     mCurrentDisplayFrame = std::make_shared<DisplayFrame>(mTimeStats, mJankClassificationThresholds,
                                                           &mTraceCookieCounter);
+    mCurrentDisplayFrame->setSequence(mNextDisplayFrameSequence++);
+}
+
+void FrameTimeline::recordLayerPresents(const DisplayFrame& displayFrame) {
+    const nsecs_t presentTime = displayFrame.getActuals().presentTime;
+    if (presentTime <= 0) {
+        return;
+    }
+    // Frames are presented in order, but one may have left the history while its fence was
+    // pending. The current frame joins the history right after being presented.
+    const uint64_t sequence = displayFrame.getSequence();
+    if (!mDisplayFrames.empty() && sequence < mDisplayFrames.front()->getSequence()) {
+        return;
+    }
+
+    std::scoped_lock lock(mFpsMutex);
+    for (const auto& surfaceFrame : displayFrame.getSurfaceFrames()) {
+        if (surfaceFrame->getPresentState() != SurfaceFrame::PresentState::Presented) {
+            continue;
+        }
+        auto& presents = mLayerPresents[surfaceFrame->getLayerId()];
+        // A layer may have more than one SurfaceFrame in a DisplayFrame.
+        if (presents.empty() || presents.back().displayFrameSequence != sequence) {
+            presents.push_back({sequence, presentTime});
+        }
+    }
+}
+
+void FrameTimeline::evictLayerPresents(const DisplayFrame& displayFrame) {
+    const uint64_t sequence = displayFrame.getSequence();
+    std::scoped_lock lock(mFpsMutex);
+    for (const auto& surfaceFrame : displayFrame.getSurfaceFrames()) {
+        const auto it = mLayerPresents.find(surfaceFrame->getLayerId());
+        if (it == mLayerPresents.end()) {
+            continue;
+        }
+        auto& presents = it->second;
+        while (!presents.empty() && presents.front().displayFrameSequence <= sequence) {
+            presents.pop_front();
+        }
+        if (presents.empty()) {
+            mLayerPresents.erase(it);
+        }
+    }
 }
 
 nsecs_t FrameTimeline::DisplayFrame::getBaseTime() const {
@@ -1474,6 +1531,10 @@ void FrameTimeline::setMaxDisplayFrames(uint32_t size) {
     // The size can either increase or decrease, clear everything, to be consistent
     mDisplayFrames.clear();
     mPendingPresentFences.clear();
+    {
+        std::scoped_lock fpsLock(mFpsMutex);
+        mLayerPresents.clear();
+    }
     mMaxDisplayFrames = size;
 }
 
@@ -23,6 +23,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 #include <gui/ISurfaceComposer.h>
 #include <gui/JankInfo.h>
@@ -395,6 +396,9 @@ public:
         void setActualStartTime(nsecs_t actualStartTime);
         void setActualEndTime(nsecs_t actualEndTime);
         void setGpuFence(const std::shared_ptr<FenceTime>& gpuFence);
+        // Position of this DisplayFrame in FrameTimeline's history, increasing by one per frame.
+        void setSequence(uint64_t sequence) { mSequence = sequence; }
+        uint64_t getSequence() const { return mSequence; }
 
         // BaseTime is the smallest timestamp in a DisplayFrame.
         // Used for dumping all timestamps relative to the oldest, making it easy to read.
@@ -458,6 +462,7 @@ public:
         // Using a reference here because the counter is owned by FrameTimeline, which outlives
         // DisplayFrame.
         TraceCookieCounter& mTraceCookieCounter;
+        uint64_t mSequence = 0;
     };
 
     FrameTimeline(std::shared_ptr<TimeStats> timeStats, pid_t surfaceFlingerPid,
@@ -493,6 +498,10 @@ private:
     void flushPendingPresentFences() REQUIRES(mMutex);
     std::optional<size_t> getFirstSignalFenceIndex() const REQUIRES(mMutex);
     void finalizeCurrentDisplayFrame() REQUIRES(mMutex);
+    // Records the present time of the layers presented by a DisplayFrame, for computeFps().
+    void recordLayerPresents(const DisplayFrame& displayFrame) REQUIRES(mMutex);
+    // Forgets the present times recorded for a DisplayFrame that left the history.
+    void evictLayerPresents(const DisplayFrame& displayFrame) REQUIRES(mMutex);
     void dumpAll(std::string& result);
     void dumpJank(std::string& result);
 
@@ -501,6 +510,18 @@ private:
     std::vector<std::pair<std::shared_ptr<FenceTime>, std::shared_ptr<DisplayFrame>>>
             mPendingPresentFences GUARDED_BY(mMutex);
     std::shared_ptr<DisplayFrame> mCurrentDisplayFrame GUARDED_BY(mMutex);
+    uint64_t mNextDisplayFrameSequence GUARDED_BY(mMutex) = 0;
+
+    struct LayerPresent {
+        uint64_t displayFrameSequence;
+        nsecs_t presentTime;
+    };
+    // For each layer, the presented DisplayFrames of the history that contain one of its
+    // SurfaceFrames, oldest first. Kept up to date as frames are presented and evicted so that
+    // computeFps() doesn't have to walk the history, and guarded by its own mutex so that it
+    // doesn't wait for frames to be finalized. Acquired after mMutex.
+    std::unordered_map<int32_t, std::deque<LayerPresent>> mLayerPresents GUARDED_BY(mFpsMutex);
+    mutable std::mutex mFpsMutex;
     TokenManager mTokenManager;
     TraceCookieCounter mTraceCookieCounter;
     mutable std::mutex mMutex;
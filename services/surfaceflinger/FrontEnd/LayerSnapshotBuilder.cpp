@@ -19,8 +19,10 @@
 #undef LOG_TAG
 #define LOG_TAG "SurfaceFlinger"
 
+#include <algorithm>
 #include <numeric>
 #include <optional>
+#include <unordered_map>
 
 #include <ftl/small_map.h>
 #include <gui/TraceUtils.h>
@@ -333,6 +335,32 @@ uint32_t getPrimaryDisplayRotationFlags(
     return 0;
 }
 
+using SubtreeByPath = std::unordered_map<LayerHierarchy::TraversalPath, size_t,
+                                         LayerHierarchy::TraversalPathHash>;
+
+// Walks the hierarchy like updateSnapshotsInHierarchy and records which top-level subtree reaches
+// each snapshot. If two subtrees reach the same snapshot, their groups are merged.
+void groupSubtreesByPath(const LayerHierarchy& hierarchy,
+                         LayerHierarchy::TraversalPath& traversalPath, size_t subtree,
+                         SubtreeByPath& subtreeByPath, std::vector<size_t>& groupIds, int depth) {
+    if (depth > 50) {
+        return;
+    }
+    auto [it, inserted] = subtreeByPath.emplace(traversalPath, subtree);
+    if (!inserted && groupIds[it->second] != groupIds[subtree]) {
+        const size_t from = groupIds[it->second];
+        const size_t to = groupIds[subtree];
+        std::replace(groupIds.begin(), groupIds.end(), from, to);
+    }
+    for (auto& [childHierarchy, variant] : hierarchy.mChildren) {
+        LayerHierarchy::ScopedAddToTraversalPath addChildToPath(traversalPath,
+                                                                childHierarchy->getLayer()->id,
+                                                                variant);
+        groupSubtreesByPath(*childHierarchy, traversalPath, subtree, subtreeByPath, groupIds,
+                            depth + 1);
+    }
+}
+
 } // namespace
 
 LayerSnapshot LayerSnapshotBuilder::getRootSnapshot() {
@@ -370,6 +398,7 @@ LayerSnapshotBuilder::LayerSnapshotBuilder() {}
 LayerSnapshotBuilder::LayerSnapshotBuilder(Args args) : LayerSnapshotBuilder() {
     args.forceUpdate = ForceUpdateFlags::ALL;
     updateSnapshots(args);
+    updateSnapshotIndices();
 }
 
 bool LayerSnapshotBuilder::tryFastUpdate(const Args& args) {
@@ -398,10 +427,11 @@ bool LayerSnapshotBuilder::tryFastUpdate(const Args& args) {
 
     // Walk through all the updated requested layer states and update the corresponding snapshots.
     for (const RequestedLayerState* requested : args.layerLifecycleManager.getChangedLayers()) {
-        auto range = mIdToSnapshots.equal_range(requested->id);
-        for (auto it = range.first; it != range.second; it++) {
-            it->second->merge(*requested, forceUpdate, args.displayChanges, args.forceFullDamage,
-                              primaryDisplayRotationFlags);
+        auto it = mIdToSnapshots.find(requested->id);
+        if (it == mIdToSnapshots.end()) continue;
+        for (LayerSnapshot* snapshot : it->second) {
+            snapshot->merge(*requested, forceUpdate, args.displayChanges, args.forceFullDamage,
+                            primaryDisplayRotationFlags);
         }
     }
 
@@ -439,6 +469,13 @@ void LayerSnapshotBuilder::updateSnapshots(const Args& args) {
         }
     }
 
+    const bool hierarchyChanged = args.forceUpdate == ForceUpdateFlags::HIERARCHY ||
+            args.layerLifecycleManager.getGlobalChanges().test(
+                    RequestedLayerState::Changes::Hierarchy);
+    if (hierarchyChanged) {
+        mSubtreeGroupsValid = false;
+    }
+
     LayerHierarchy::TraversalPath root = LayerHierarchy::TraversalPath::ROOT;
     if (args.root.getLayer()) {
         // The hierarchy can have a root layer when used for screenshots otherwise, it will have
@@ -446,6 +483,8 @@ void LayerSnapshotBuilder::updateSnapshots(const Args& args) {
         LayerHierarchy::ScopedAddToTraversalPath addChildToPath(root, args.root.getLayer()->id,
                                                                 LayerHierarchy::Variant::Attached);
         updateSnapshotsInHierarchy(args, args.root, root, rootSnapshot, /*depth=*/0);
+    } else if (canUpdateSubtreesInParallel(args)) {
+        updateSubtreesInParallel(args, rootSnapshot);
     } else {
         for (auto& [childHierarchy, variant] : args.root.mChildren) {
             LayerHierarchy::ScopedAddToTraversalPath addChildToPath(root,
@@ -453,6 +492,9 @@ void LayerSnapshotBuilder::updateSnapshots(const Args& args) {
                                                                     variant);
             updateSnapshotsInHierarchy(args, *childHierarchy, root, rootSnapshot, /*depth=*/0);
         }
+        if (mWorkerPool && !mSubtreeGroupsValid) {
+            updateSubtreeGroups(args);
+        }
     }
 
     // Update touchable region crops outside the main update pass. This is because a layer could be
@@ -490,12 +532,21 @@ void LayerSnapshotBuilder::updateSnapshots(const Args& args) {
 
         mPathToSnapshot.erase(traversalPath);
 
-        auto range = mIdToSnapshots.equal_range(traversalPath.id);
-        auto matchingSnapshot =
-                std::find_if(range.first, range.second, [&traversalPath](auto& snapshotWithId) {
-                    return snapshotWithId.second->path == traversalPath;
-                });
-        mIdToSnapshots.erase(matchingSnapshot);
+        auto snapshotsWithId = mIdToSnapshots.find(traversalPath.id);
+        if (snapshotsWithId != mIdToSnapshots.end()) {
+            auto& snapshots = snapshotsWithId->second;
+            auto matchingSnapshot =
+                    std::find_if(snapshots.begin(), snapshots.end(),
+                                 [&traversalPath](LayerSnapshot* snapshot) {
+                                     return snapshot->path == traversalPath;
+                                 });
+            if (matchingSnapshot != snapshots.end()) {
+                snapshots.unstable_erase(matchingSnapshot);
+            }
+            if (snapshots.empty()) {
+                mIdToSnapshots.erase(snapshotsWithId);
+            }
+        }
         mNeedsTouchableRegionCrop.erase(traversalPath);
         mSnapshots.back()->globalZ = it->get()->globalZ;
         std::iter_swap(it, mSnapshots.end() - 1);
@@ -512,6 +563,91 @@ void LayerSnapshotBuilder::update(const Args& args) {
         return;
     }
     updateSnapshots(args);
+    updateSnapshotIndices();
+}
+
+void LayerSnapshotBuilder::updateSnapshotIndices() {
+    mVisibleSnapshotIndices.clear();
+    mInputSnapshotIndices.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(mNumInterestingSnapshots); i++) {
+        const LayerSnapshot& snapshot = *mSnapshots[i];
+        if (snapshot.isVisible) {
+            mVisibleSnapshotIndices.push_back(i);
+        }
+        if (snapshot.hasInputInfo()) {
+            mInputSnapshotIndices.push_back(i);
+        }
+    }
+}
+
+void LayerSnapshotBuilder::setWorkerThreadCount(size_t workerThreadCount) {
+    if (workerThreadCount == 0) {
+        mWorkerPool.reset();
+    } else if (!mWorkerPool || mWorkerPool->getThreadCount() != workerThreadCount) {
+        mWorkerPool = std::make_unique<WorkerPool>(workerThreadCount);
+    }
+    mSubtreeGroupsValid = false;
+}
+
+bool LayerSnapshotBuilder::canUpdateSubtreesInParallel(const Args& args) const {
+    if (!mWorkerPool || !mSubtreeGroupsValid || mSubtreeGroups.size() < 2 ||
+        mSnapshots.size() < mMinSnapshotsForParallelUpdate) {
+        return false;
+    }
+    if (args.root.mChildren.size() != mSubtreeRootIds.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < mSubtreeRootIds.size(); i++) {
+        if (args.root.mChildren[i].first->getLayer()->id != mSubtreeRootIds[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LayerSnapshotBuilder::updateSubtreesInParallel(const Args& args,
+                                                    const LayerSnapshot& rootSnapshot) {
+    ATRACE_NAME("UpdateSubtreesInParallel");
+    mWorkerPool->run(mSubtreeGroups.size(), [&](size_t group) {
+        LayerHierarchy::TraversalPath root = LayerHierarchy::TraversalPath::ROOT;
+        for (size_t subtree : mSubtreeGroups[group]) {
+            auto& [childHierarchy, variant] = args.root.mChildren[subtree];
+            LayerHierarchy::ScopedAddToTraversalPath addChildToPath(root,
+                                                                    childHierarchy->getLayer()->id,
+                                                                    variant);
+            updateSnapshotsInHierarchy(args, *childHierarchy, root, rootSnapshot, /*depth=*/0);
+        }
+    });
+}
+
+void LayerSnapshotBuilder::updateSubtreeGroups(const Args& args) {
+    ATRACE_NAME("UpdateSubtreeGroups");
+    const size_t subtreeCount = args.root.mChildren.size();
+    std::vector<size_t> groupIds(subtreeCount);
+    std::iota(groupIds.begin(), groupIds.end(), 0);
+    SubtreeByPath subtreeByPath;
+    mSubtreeRootIds.clear();
+    for (size_t i = 0; i < subtreeCount; i++) {
+        auto& [childHierarchy, variant] = args.root.mChildren[i];
+        mSubtreeRootIds.push_back(childHierarchy->getLayer()->id);
+        LayerHierarchy::TraversalPath root = LayerHierarchy::TraversalPath::ROOT;
+        LayerHierarchy::ScopedAddToTraversalPath addChildToPath(root,
+                                                                childHierarchy->getLayer()->id,
+                                                                variant);
+        groupSubtreesByPath(*childHierarchy, root, i, subtreeByPath, groupIds, /*depth=*/0);
+    }
+
+    mSubtreeGroups.clear();
+    std::vector<size_t> groupIndices(subtreeCount, subtreeCount);
+    for (size_t i = 0; i < subtreeCount; i++) {
+        size_t& groupIndex = groupIndices[groupIds[i]];
+        if (groupIndex == subtreeCount) {
+            groupIndex = mSubtreeGroups.size();
+            mSubtreeGroups.emplace_back();
+        }
+        mSubtreeGroups[groupIndex].push_back(i);
+    }
+    mSubtreeGroupsValid = true;
 }
 
 const LayerSnapshot& LayerSnapshotBuilder::updateSnapshotsInHierarchy(
@@ -580,7 +716,7 @@ LayerSnapshot* LayerSnapshotBuilder::createSnapshot(const LayerHierarchy::Traver
     }
     mPathToSnapshot[path] = snapshot;
 
-    mIdToSnapshots.emplace(path.id, snapshot);
+    mIdToSnapshots[path.id].push_back(snapshot);
     return snapshot;
 }
 
@@ -1087,6 +1223,7 @@ void LayerSnapshotBuilder::updateInput(LayerSnapshot& snapshot,
     }
 
     if (requested.touchCropId != UNASSIGNED_LAYER_ID || path.isClone()) {
+        std::scoped_lock lock(mNeedsTouchableRegionCropMutex);
         mNeedsTouchableRegionCrop.insert(path);
     }
     auto cropLayerSnapshot = getSnapshot(requested.touchCropId);
@@ -1120,10 +1257,8 @@ std::vector<std::unique_ptr<LayerSnapshot>>& LayerSnapshotBuilder::getSnapshots(
 }
 
 void LayerSnapshotBuilder::forEachVisibleSnapshot(const ConstVisitor& visitor) const {
-    for (int i = 0; i < mNumInterestingSnapshots; i++) {
-        LayerSnapshot& snapshot = *mSnapshots[(size_t)i];
-        if (!snapshot.isVisible) continue;
-        visitor(snapshot);
+    for (uint32_t i : mVisibleSnapshotIndices) {
+        visitor(*mSnapshots[i]);
     }
 }
 
@@ -1142,18 +1277,14 @@ void LayerSnapshotBuilder::forEachVisibleSnapshot(const ConstVisitor& visitor,
 }
 
 void LayerSnapshotBuilder::forEachVisibleSnapshot(const Visitor& visitor) {
-    for (int i = 0; i < mNumInterestingSnapshots; i++) {
-        std::unique_ptr<LayerSnapshot>& snapshot = mSnapshots.at((size_t)i);
-        if (!snapshot->isVisible) continue;
-        visitor(snapshot);
+    for (uint32_t i : mVisibleSnapshotIndices) {
+        visitor(mSnapshots.at(i));
     }
 }
 
 void LayerSnapshotBuilder::forEachInputSnapshot(const ConstVisitor& visitor) const {
-    for (int i = mNumInterestingSnapshots - 1; i >= 0; i--) {
-        LayerSnapshot& snapshot = *mSnapshots[(size_t)i];
-        if (!snapshot.hasInputInfo()) continue;
-        visitor(snapshot);
+    for (auto it = mInputSnapshotIndices.rbegin(); it != mInputSnapshotIndices.rend(); it++) {
+        visitor(*mSnapshots[*it]);
     }
 }
 
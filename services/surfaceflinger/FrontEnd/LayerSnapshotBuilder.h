@@ -16,11 +16,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
+#include <ftl/small_vector.h>
+
 #include "FrontEnd/DisplayInfo.h"
 #include "FrontEnd/LayerLifecycleManager.h"
 #include "LayerHierarchy.h"
 #include "LayerSnapshot.h"
 #include "RequestedLayerState.h"
+#include "WorkerPool.h"
 
 namespace android::surfaceflinger::frontend {
 
@@ -70,6 +76,11 @@ public:
     // LayerLifecycleManager.commitChanges is called as that function will clear all
     // change flags.
     void update(const Args&);
+
+    // Update independent top-level subtrees of the hierarchy, such as the roots of different
+    // displays, on up to workerThreadCount threads in addition to the calling thread. Passing 0
+    // keeps all updates on the calling thread.
+    void setWorkerThreadCount(size_t workerThreadCount);
     std::vector<std::unique_ptr<LayerSnapshot>>& getSnapshots();
     LayerSnapshot* getSnapshot(uint32_t layerId) const;
     LayerSnapshot* getSnapshot(const LayerHierarchy::TraversalPath& id) const;
@@ -98,6 +109,16 @@ private:
 
     void updateSnapshots(const Args& args);
 
+    // Returns true if the top-level subtrees can be updated on the worker pool. This is only the
+    // case when the hierarchy has not changed since the subtree groups were computed, which also
+    // guarantees that every snapshot the update reaches already exists.
+    bool canUpdateSubtreesInParallel(const Args& args) const;
+    void updateSubtreesInParallel(const Args& args, const LayerSnapshot& rootSnapshot);
+    void updateSubtreeGroups(const Args& args);
+    // Rebuild the z-ordered indices of visible and input snapshots after the snapshots have been
+    // updated and sorted.
+    void updateSnapshotIndices();
+
     const LayerSnapshot& updateSnapshotsInHierarchy(const Args&, const LayerHierarchy& hierarchy,
                                                     LayerHierarchy::TraversalPath& traversalPath,
                                                     const LayerSnapshot& parentSnapshot, int depth);
@@ -127,14 +148,33 @@ private:
     std::unordered_map<LayerHierarchy::TraversalPath, LayerSnapshot*,
                        LayerHierarchy::TraversalPathHash>
             mPathToSnapshot;
-    std::multimap<uint32_t, LayerSnapshot*> mIdToSnapshots;
+    // All snapshots of a layer. There is more than one if the layer is mirrored.
+    std::unordered_map<uint32_t, ftl::SmallVector<LayerSnapshot*, 1>> mIdToSnapshots;
 
     // Track snapshots that needs touchable region crop from other snapshots
     std::unordered_set<LayerHierarchy::TraversalPath, LayerHierarchy::TraversalPathHash>
             mNeedsTouchableRegionCrop;
+    // Guards insertions into mNeedsTouchableRegionCrop while subtrees are updated in parallel.
+    std::mutex mNeedsTouchableRegionCropMutex;
     std::vector<std::unique_ptr<LayerSnapshot>> mSnapshots;
-    bool mResortSnapshots = false;
+    std::atomic<bool> mResortSnapshots = false;
     int mNumInterestingSnapshots = 0;
+    // Indices into mSnapshots of the visible and input snapshots, in z-order. The visitors walk
+    // these dense lists instead of loading every interesting snapshot to check whether it is
+    // visible or has input.
+    std::vector<uint32_t> mVisibleSnapshotIndices;
+    std::vector<uint32_t> mInputSnapshotIndices;
+
+    std::unique_ptr<WorkerPool> mWorkerPool;
+    // Top-level subtrees, as indices into the root's children, that are updated together because
+    // they reach the same snapshots, for example through relative layers. Groups are updated in
+    // parallel with each other and the subtrees in a group are updated in order.
+    std::vector<std::vector<size_t>> mSubtreeGroups;
+    // Ids of the top-level layers the groups were computed for.
+    std::vector<uint32_t> mSubtreeRootIds;
+    bool mSubtreeGroupsValid = false;
+    // Below this many snapshots, handing work to the pool costs more than it saves.
+    size_t mMinSnapshotsForParallelUpdate = 64;
 };
 
 } // namespace android::surfaceflinger::frontend
@@ -40,7 +40,7 @@ void TransactionHandler::collectTransactions() {
         if (!maybeTransaction.has_value()) {
             break;
         }
-        auto transaction = maybeTransaction.value();
+        auto transaction = std::move(*maybeTransaction);
         mPendingTransactionQueues[transaction.applyToken].emplace(std::move(transaction));
     }
 }
@@ -54,19 +54,33 @@ std::vector<TransactionState> TransactionHandler::flushTransactions() {
     // than the transaction which satisfies our barrier. In fact this is the exact use case
     // that the primitive is designed for. This means we may first process
     // the barrier dependent transaction, determine it ineligible to complete
-    // and then satisfy in a later inner iteration of flushPendingTransactionQueues.
-    // The barrier dependent transaction was eligible to be presented in this frame
-    // but we would have prevented it without case. To fix this we continually
-    // loop through flushPendingTransactionQueues until we perform an iteration
-    // where the number of transactionsPendingBarrier doesn't change. This way
-    // we can continue to resolve dependency chains of barriers as far as possible.
-    int lastTransactionsPendingBarrier = 0;
-    int transactionsPendingBarrier = 0;
-    do {
-        lastTransactionsPendingBarrier = transactionsPendingBarrier;
-        // Collect transactions that are ready to be applied.
-        transactionsPendingBarrier = flushPendingTransactionQueues(transactions, flushState);
-    } while (lastTransactionsPendingBarrier != transactionsPendingBarrier);
+    // and then satisfy it later in the flush. Rather than walking every queue again until
+    // nothing changes, queues that are blocked on a barrier are indexed by the layers their
+    // front transaction has buffers for, and are only flushed again once a transaction with a
+    // buffer for one of those layers is ready to be applied. This way we can continue to resolve
+    // dependency chains of barriers as far as possible, while only revisiting the queues that
+    // could have been unblocked.
+    mQueuesWaitingOnBarrier.clear();
+    mBufferLayersMadeReady.clear();
+    flushPendingTransactionQueues(transactions, flushState);
+    while (!mBufferLayersMadeReady.empty()) {
+        IBinder* layer = mBufferLayersMadeReady.back();
+        mBufferLayersMadeReady.pop_back();
+        auto waitingIt = mQueuesWaitingOnBarrier.find(layer);
+        if (waitingIt == mQueuesWaitingOnBarrier.end()) {
+            continue;
+        }
+        std::vector<sp<IBinder>> applyTokens = std::move(waitingIt->second);
+        mQueuesWaitingOnBarrier.erase(waitingIt);
+        for (const sp<IBinder>& applyToken : applyTokens) {
+            auto queueIt = mPendingTransactionQueues.find(applyToken);
+            if (queueIt != mPendingTransactionQueues.end()) {
+                flushPendingTransactionQueue(applyToken, queueIt->second, transactions,
+                                             flushState);
+            }
+        }
+    }
+    std::erase_if(mPendingTransactionQueues, [](const auto& entry) { return entry.second.empty(); });
 
     applyUnsignaledBufferTransaction(transactions, flushState);
 
@@ -110,6 +124,7 @@ void TransactionHandler::popTransactionFromPending(std::vector<TransactionState>
 
     auto& readyToApplyTransaction = transactions.back();
     readyToApplyTransaction.traverseStatesWithBuffers([&](const layer_state_t& state) {
+        mBufferLayersMadeReady.push_back(state.surface.get());
         const bool frameNumberChanged =
                 state.bufferData->flags.test(BufferData::BufferDataChange::frameNumberChanged);
         if (frameNumberChanged) {
@@ -146,38 +161,39 @@ TransactionHandler::TransactionReadiness TransactionHandler::applyFilters(
     return ready;
 }
 
-int TransactionHandler::flushPendingTransactionQueues(std::vector<TransactionState>& transactions,
-                                                      TransactionFlushState& flushState) {
-    int transactionsPendingBarrier = 0;
-    auto it = mPendingTransactionQueues.begin();
-    while (it != mPendingTransactionQueues.end()) {
-        auto& [applyToken, queue] = *it;
-        while (!queue.empty()) {
-            auto& transaction = queue.front();
-            flushState.transaction = &transaction;
-            auto ready = applyFilters(flushState);
-            if (ready == TransactionReadiness::NotReadyBarrier) {
-                transactionsPendingBarrier++;
-                break;
-            } else if (ready == TransactionReadiness::NotReady) {
-                break;
-            } else if (ready == TransactionReadiness::NotReadyUnsignaled) {
-                // We maybe able to latch this transaction if it's the only transaction
-                // ready to be applied.
-                flushState.queueWithUnsignaledBuffer = applyToken;
-                break;
-            }
-            // ready == TransactionReadiness::Ready
-            popTransactionFromPending(transactions, flushState, queue);
-        }
+void TransactionHandler::flushPendingTransactionQueues(std::vector<TransactionState>& transactions,
+                                                       TransactionFlushState& flushState) {
+    for (auto& [applyToken, queue] : mPendingTransactionQueues) {
+        flushPendingTransactionQueue(applyToken, queue, transactions, flushState);
+    }
+}
 
-        if (queue.empty()) {
-            it = mPendingTransactionQueues.erase(it);
-        } else {
-            it = std::next(it, 1);
+void TransactionHandler::flushPendingTransactionQueue(const sp<IBinder>& applyToken,
+                                                      std::queue<TransactionState>& queue,
+                                                      std::vector<TransactionState>& transactions,
+                                                      TransactionFlushState& flushState) {
+    while (!queue.empty()) {
+        auto& transaction = queue.front();
+        flushState.transaction = &transaction;
+        auto ready = applyFilters(flushState);
+        if (ready == TransactionReadiness::NotReadyBarrier) {
+            // Revisit this queue once one of the layers the transaction has a buffer for has a
+            // new buffer ready to be presented.
+            transaction.traverseStatesWithBuffers([&](const layer_state_t& state) {
+                mQueuesWaitingOnBarrier[state.surface.get()].push_back(applyToken);
+            });
+            break;
+        } else if (ready == TransactionReadiness::NotReady) {
+            break;
+        } else if (ready == TransactionReadiness::NotReadyUnsignaled) {
+            // We maybe able to latch this transaction if it's the only transaction
+            // ready to be applied.
+            flushState.queueWithUnsignaledBuffer = applyToken;
+            break;
         }
+        // ready == TransactionReadiness::Ready
+        popTransactionFromPending(transactions, flushState, queue);
     }
-    return transactionsPendingBarrier;
 }
 
 void TransactionHandler::addTransactionReadyFilter(TransactionFilter&& filter) {
@@ -81,7 +81,10 @@ private:
     // For unit tests
     friend class ::android::TestableSurfaceFlinger;
 
-    int flushPendingTransactionQueues(std::vector<TransactionState>&, TransactionFlushState&);
+    void flushPendingTransactionQueues(std::vector<TransactionState>&, TransactionFlushState&);
+    void flushPendingTransactionQueue(const sp<IBinder>& applyToken,
+                                      std::queue<TransactionState>& queue,
+                                      std::vector<TransactionState>&, TransactionFlushState&);
     void applyUnsignaledBufferTransaction(std::vector<TransactionState>&, TransactionFlushState&);
     void popTransactionFromPending(std::vector<TransactionState>&, TransactionFlushState&,
                                    std::queue<TransactionState>&);
@@ -92,6 +95,13 @@ private:
     std::atomic<size_t> mPendingTransactionCount = 0;
     ftl::SmallVector<TransactionFilter, 2> mTransactionReadyFilters;
 
+    // Only used while flushing transactions. Apply tokens of the queues blocked on a barrier,
+    // keyed by the layers their front transaction has buffers for.
+    std::unordered_map<IBinder*, std::vector<sp<IBinder>>> mQueuesWaitingOnBarrier;
+    // Layers that had a buffer made ready to present, whose waiting queues have not been flushed
+    // again yet.
+    std::vector<IBinder*> mBufferLayersMadeReady;
+
     std::mutex mStalledMutex;
     std::unordered_map<uint64_t /* transactionId */, StalledTransactionInfo> mStalledTransactions
             GUARDED_BY(mStalledMutex);
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "WorkerPool.h"
+
+namespace android::surfaceflinger::frontend {
+
+WorkerPool::WorkerPool(size_t threadCount) {
+    mThreads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        mThreads.emplace_back(&WorkerPool::threadMain, this);
+        pthread_setname_np(mThreads.back().native_handle(), "FrontEndWorker");
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::scoped_lock lock(mMutex);
+        mDone = true;
+        mWorkAvailable.notify_all();
+    }
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::run(size_t taskCount, const std::function<void(size_t)>& task) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    android::base::ScopedLockAssertion assumeLock(mMutex);
+    mTask = &task;
+    mTaskCount = taskCount;
+    mNextTask = 0;
+    mWorkAvailable.notify_all();
+
+    runTasks(lock);
+    while (mRunningTasks > 0) {
+        mWorkDone.wait(lock);
+    }
+    mTask = nullptr;
+    mTaskCount = 0;
+    mNextTask = 0;
+}
+
+void WorkerPool::runTasks(std::unique_lock<std::mutex>& lock) {
+    while (mNextTask < mTaskCount) {
+        const size_t index = mNextTask++;
+        const auto& task = *mTask;
+        mRunningTasks++;
+        lock.unlock();
+        task(index);
+        lock.lock();
+        mRunningTasks--;
+    }
+    if (mRunningTasks == 0) {
+        mWorkDone.notify_all();
+    }
+}
+
+void WorkerPool::threadMain() {
+    // The pool runs work for the main thread, which is waiting on it. Run at the same kind of
+    // priority as other helpers of the composition hot path.
+    struct sched_param param = {0};
+    param.sched_priority = 2;
+    sched_setscheduler(0, SCHED_FIFO, &param);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    android::base::ScopedLockAssertion assumeLock(mMutex);
+    while (!mDone) {
+        if (mNextTask < mTaskCount) {
+            runTasks(lock);
+            continue;
+        }
+        mWorkAvailable.wait(lock);
+    }
+}
+
+} // namespace android::surfaceflinger::frontend
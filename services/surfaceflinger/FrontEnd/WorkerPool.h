@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <android-base/thread_annotations.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace android::surfaceflinger::frontend {
+
+// A fixed set of threads that run batches of independent tasks for the front end. The calling
+// thread takes part in running each batch, so a batch of n tasks can use up to threadCount + 1
+// threads.
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t threadCount);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Calls task(i) for every i in [0, taskCount) and returns once all of them have completed.
+    // Tasks may run concurrently and in any order. Must only be called from one thread at a time.
+    void run(size_t taskCount, const std::function<void(size_t)>& task);
+
+    size_t getThreadCount() const { return mThreads.size(); }
+
+private:
+    void threadMain();
+    // Runs tasks from the current batch until there are none left to start. Called and returns
+    // with mMutex held.
+    void runTasks(std::unique_lock<std::mutex>& lock) REQUIRES(mMutex);
+
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mWorkDone;
+    const std::function<void(size_t)>* mTask GUARDED_BY(mMutex) = nullptr;
+    size_t mTaskCount GUARDED_BY(mMutex) = 0;
+    size_t mNextTask GUARDED_BY(mMutex) = 0;
+    size_t mRunningTasks GUARDED_BY(mMutex) = 0;
+    bool mDone GUARDED_BY(mMutex) = false;
+    std::vector<std::thread> mThreads;
+};
+
+} // namespace android::surfaceflinger::frontend
@@ -15,68 +15,137 @@
  */
 
 #pragma once
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
 #include <optional>
 
-template <typename T>
-// Single consumer multi producer stack. We can understand the two operations independently to see
-// why they are without race condition.
+// Multi producer single consumer FIFO queue. If push(a) happens before push(b), a is popped before
+// b. pop never blocks: if the next value in FIFO order is still being written by a producer, pop
+// returns std::nullopt even though isEmpty() is false, and a later pop returns it.
 //
-// push is responsible for maintaining a linked list stored in mPush, and called from multiple
-// threads without lock. We can see that if two threads never observe the same value from
-// mPush.load, it just functions as a normal linked list. In the case where two threads observe the
-// same value, one of them has to execute the compare_exchange first. The one that doesn't execute
-// the compare exchange first, will receive false from compare_exchange. previousHead is updated (by
-// compare_exchange) to the most recent value of mPush, and we try again. It's relatively clear to
-// see that the process can repeat with an arbitrary number of threads.
+// Values are stored in a ring of Capacity pre-allocated slots, so push and pop do not allocate
+// while the ring has room. Each slot carries a sequence number that tells producers and the
+// consumer whose turn it is:
 //
-// Pop is much simpler. If mPop is empty (as it begins) it atomically exchanges
-// the entire push list with null. This is safe, since the only other reader (push)
-// of mPush will retry if it changes in between it's read and atomic compare. We
-// then store the list and pop one element.
+// push reserves the next position with a compare_exchange on mEnqueuePos, which only succeeds if
+// the slot for that position has been released by the consumer (sequence == position). Once it
+// owns the position, the producer writes the value and publishes it by storing position + 1 to the
+// sequence with release ordering. Two producers can never own the same position, because only one
+// of them can move mEnqueuePos past it.
 //
-// If we already had something in the pop list we just pop directly.
+// pop is only ever called from one thread, so mDequeuePos is only written by the consumer. If the
+// slot at mDequeuePos has been published (acquire), it moves the value out and releases the slot
+// for the next lap of the ring by storing position + Capacity to the sequence. The consumer may run
+// at a higher priority than the producers, so it never waits for a producer that has reserved a
+// slot but not published it yet.
+//
+// If the ring is full, values spill into an overflow list guarded by a mutex. To preserve FIFO
+// order, producers keep using the overflow list as long as it is not empty, and the consumer only
+// takes from it once the ring has been drained of everything pushed before it.
+template <typename T, size_t Capacity = 64>
 class LocklessQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
 public:
-    class Entry {
-    public:
-        T mValue;
-        std::atomic<Entry*> mNext;
-        Entry(T value) : mValue(value) {}
-    };
-    std::atomic<Entry*> mPush = nullptr;
-    std::atomic<Entry*> mPop = nullptr;
-    bool isEmpty() { return (mPush.load() == nullptr) && (mPop.load() == nullptr); }
+    LocklessQueue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LocklessQueue(const LocklessQueue&) = delete;
+    LocklessQueue& operator=(const LocklessQueue&) = delete;
+
+    bool isEmpty() const {
+        return mEnqueuePos.load(std::memory_order_acquire) ==
+                mDequeuePos.load(std::memory_order_relaxed) &&
+                mOverflowSize.load(std::memory_order_acquire) == 0;
+    }
 
     void push(T value) {
-        Entry* entry = new Entry(value);
-        Entry* previousHead = mPush.load(/*std::memory_order_relaxed*/);
-        do {
-            entry->mNext = previousHead;
-        } while (!mPush.compare_exchange_weak(previousHead, entry)); /*std::memory_order_release*/
+        if (mOverflowSize.load(std::memory_order_acquire) == 0 && tryPushToRing(value)) {
+            return;
+        }
+        std::scoped_lock lock(mOverflowMutex);
+        mOverflow.push_back(std::move(value));
+        mOverflowSize.fetch_add(1, std::memory_order_release);
     }
+
     std::optional<T> pop() {
-        Entry* popped = mPop.load(/*std::memory_order_acquire*/);
-        if (popped) {
-            // Single consumer so this is fine
-            mPop.store(popped->mNext /* , std::memory_order_release */);
-            auto value = popped->mValue;
-            delete popped;
-            return std::move(value);
-        } else {
-            Entry* grabbedList = mPush.exchange(nullptr /* , std::memory_order_acquire */);
-            if (!grabbedList) return std::nullopt;
-            // Reverse the list
-            while (grabbedList->mNext) {
-                Entry* next = grabbedList->mNext;
-                grabbedList->mNext = popped;
-                popped = grabbedList;
-                grabbedList = next;
+        // Load the overflow size first. A value in the overflow list that we observe here makes
+        // every value pushed to the ring before it visible to the loads below.
+        const size_t overflowSize = mOverflowSize.load(std::memory_order_acquire);
+        const size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+        if (mEnqueuePos.load(std::memory_order_acquire) != pos) {
+            Slot& slot = mSlots[pos & kMask];
+            // The position has been reserved, but the producer may not have published the value
+            // yet. Rather than wait for a possibly preempted producer, let the next pop retry. The
+            // overflow list only holds values pushed after this one, so it has to wait as well.
+            if (slot.mSequence.load(std::memory_order_acquire) != pos + 1) {
+                return std::nullopt;
+            }
+            std::optional<T> value = std::move(slot.mValue);
+            slot.mValue.reset();
+            slot.mSequence.store(pos + Capacity, std::memory_order_release);
+            mDequeuePos.store(pos + 1, std::memory_order_relaxed);
+            return value;
+        }
+
+        if (overflowSize == 0) {
+            return std::nullopt;
+        }
+        std::scoped_lock lock(mOverflowMutex);
+        std::optional<T> value = std::move(mOverflow.front());
+        mOverflow.pop_front();
+        mOverflowSize.fetch_sub(1, std::memory_order_release);
+        return value;
+    }
+
+private:
+    static constexpr size_t kMask = Capacity - 1;
+
+    struct Slot {
+        std::atomic<size_t> mSequence;
+        std::optional<T> mValue;
+    };
+
+    // Returns false, leaving value untouched, if the ring is full.
+    bool tryPushToRing(T& value) {
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = mSlots[pos & kMask];
+            const size_t sequence = slot.mSequence.load(std::memory_order_acquire);
+            // Compare as a signed difference so that wrapping positions are handled correctly.
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                // The slot is free for this lap, try to reserve it.
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_acq_rel,
+                                                      std::memory_order_relaxed)) {
+                    slot.mValue = std::move(value);
+                    slot.mSequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // Another producer reserved it first, pos now holds the latest position.
+            } else if (diff < 0) {
+                // The consumer has not released the slot from the previous lap yet.
+                return false;
+            } else {
+                // Another producer has already moved past this position.
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
             }
-            mPop.store(popped /* , std::memory_order_release */);
-            auto value = grabbedList->mValue;
-            delete grabbedList;
-            return std::move(value);
         }
     }
+
+    std::array<Slot, Capacity> mSlots;
+    // Producers and the consumer write to different positions, keep them on separate cache lines.
+    alignas(64) std::atomic<size_t> mEnqueuePos = 0;
+    alignas(64) std::atomic<size_t> mDequeuePos = 0;
+
+    std::mutex mOverflowMutex;
+    std::deque<T> mOverflow;
+    std::atomic<size_t> mOverflowSize = 0;
 };
@@ -24,6 +24,7 @@
 #include <sched.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <optional>
@@ -37,6 +38,8 @@
 #include <cutils/compiler.h>
 #include <cutils/sched_policy.h>
 
+#include <ftl/small_vector.h>
+
 #include <gui/DisplayEventReceiver.h>
 #include <gui/SchedulingPolicy.h>
 
@@ -667,16 +670,33 @@ void EventThread::generateFrameTimeline(VsyncEventData& outVsyncEventData, nsecs
 
 void EventThread::dispatchEvent(const DisplayEventReceiver::Event& event,
                                 const DisplayEventConsumers& consumers) {
-    for (const auto& consumer : consumers) {
-        DisplayEventReceiver::Event copy = event;
-        if (event.header.type == DisplayEventReceiver::DISPLAY_EVENT_VSYNC) {
-            const Period frameInterval = mCallback.getVsyncPeriod(consumer->mOwnerUid);
-            copy.vsync.vsyncData.frameInterval = frameInterval.ns();
-            generateFrameTimeline(copy.vsync.vsyncData, frameInterval.ns(), copy.header.timestamp,
-                                  event.vsync.vsyncData.preferredExpectedPresentationTime(),
-                                  event.vsync.vsyncData.preferredDeadlineTimestamp());
+    // The frame timelines of a VSYNC event only depend on the frame interval of
+    // the consumer, so they are generated once per frame interval, and their
+    // tokens are shared by the consumers with that frame interval.
+    ftl::SmallVector<DisplayEventReceiver::Event, 2> vsyncEvents;
+    const auto vsyncEventFor =
+            [&](const EventThreadConnection& consumer) -> const DisplayEventReceiver::Event& {
+        const nsecs_t frameInterval = mCallback.getVsyncPeriod(consumer.mOwnerUid).ns();
+        const auto it = std::find_if(vsyncEvents.begin(), vsyncEvents.end(),
+                                     [frameInterval](const DisplayEventReceiver::Event& vsync) {
+                                         return vsync.vsync.vsyncData.frameInterval ==
+                                                 frameInterval;
+                                     });
+        if (it != vsyncEvents.end()) {
+            return *it;
         }
-        switch (consumer->postEvent(copy)) {
+
+        auto& vsync = vsyncEvents.emplace_back(event);
+        vsync.vsync.vsyncData.frameInterval = frameInterval;
+        generateFrameTimeline(vsync.vsync.vsyncData, frameInterval, vsync.header.timestamp,
+                              event.vsync.vsyncData.preferredExpectedPresentationTime(),
+                              event.vsync.vsyncData.preferredDeadlineTimestamp());
+        return vsync;
+    };
+
+    const bool isVsync = event.header.type == DisplayEventReceiver::DISPLAY_EVENT_VSYNC;
+    for (const auto& consumer : consumers) {
+        switch (consumer->postEvent(isVsync ? vsyncEventFor(*consumer) : event)) {
             case NO_ERROR:
                 break;
 
@@ -21,6 +21,7 @@
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wextra"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <deque>
@@ -33,6 +34,7 @@
 #include <ftl/match.h>
 #include <ftl/unit.h>
 #include <gui/TraceUtils.h>
+#include <math/HashCombine.h>
 #include <scheduler/FrameRateMode.h>
 #include <utils/Trace.h>
 
@@ -471,16 +473,65 @@ auto RefreshRateSelector::getRankedFrameRates(const std::vector<LayerRequirement
                                               GlobalSignals signals) const -> RankedFrameRates {
     std::lock_guard lock(mLock);
 
-    if (mGetRankedFrameRatesCache &&
-        mGetRankedFrameRatesCache->arguments == std::make_pair(layers, signals)) {
-        return mGetRankedFrameRatesCache->result;
+    if (const auto* result = mGetRankedFrameRatesCache.get(layers, signals)) {
+        return *result;
     }
 
     const auto result = getRankedFrameRatesLocked(layers, signals);
-    mGetRankedFrameRatesCache = GetRankedFrameRatesCache{{layers, signals}, result};
+    mGetRankedFrameRatesCache.put(layers, signals, result);
     return result;
 }
 
+size_t RefreshRateSelector::GetRankedFrameRatesCache::hashArguments(
+        const std::vector<LayerRequirement>& layers, GlobalSignals signals) {
+    size_t hash = android::hashCombine(signals.touch, signals.idle, signals.powerOnImminent);
+    for (const auto& layer : layers) {
+        // The desired refresh rate is compared approximately, so it is left out.
+        android::hashCombineSingle(hash, layer.name);
+        android::hashCombineSingle(hash, static_cast<int>(layer.vote));
+        android::hashCombineSingle(hash, static_cast<int>(layer.seamlessness));
+        android::hashCombineSingle(hash, static_cast<int>(layer.frameRateCategory));
+        android::hashCombineSingle(hash, layer.weight);
+        android::hashCombineSingle(hash, layer.focused);
+    }
+    return hash;
+}
+
+auto RefreshRateSelector::GetRankedFrameRatesCache::get(const std::vector<LayerRequirement>& layers,
+                                                        GlobalSignals signals)
+        -> const RankedFrameRates* {
+    const size_t hash = hashArguments(layers, signals);
+    const auto it = std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry& entry) {
+        return entry.hash == hash && entry.signals == signals && entry.layers == layers;
+    });
+    if (it == mEntries.end()) {
+        mMissCount++;
+        return nullptr;
+    }
+
+    mHitCount++;
+    std::rotate(mEntries.begin(), it, it + 1);
+    return &mEntries.front().result;
+}
+
+void RefreshRateSelector::GetRankedFrameRatesCache::put(
+        const std::vector<LayerRequirement>& layers, GlobalSignals signals,
+        const RankedFrameRates& result) {
+    if (mEntries.size() == kMaxSize) {
+        mEntries.pop_back();
+    }
+    mEntries.insert(mEntries.begin(),
+                    Entry{hashArguments(layers, signals), layers, signals, result});
+}
+
+void RefreshRateSelector::GetRankedFrameRatesCache::dump(utils::Dumper& dumper) const {
+    using namespace std::string_view_literals;
+
+    dumper.dump("size"sv, mEntries.size());
+    dumper.dump("hits"sv, mHitCount);
+    dumper.dump("misses"sv, mMissCount);
+}
+
 auto RefreshRateSelector::getRankedFrameRatesLocked(const std::vector<LayerRequirement>& layers,
                                                     GlobalSignals signals) const
         -> RankedFrameRates {
@@ -1161,7 +1212,7 @@ void RefreshRateSelector::setActiveMode(DisplayModeId modeId, Fps renderFrameRat
 
     // Invalidate the cached invocation to getRankedFrameRates. This forces
     // the refresh rate to be recomputed on the next call to getRankedFrameRates.
-    mGetRankedFrameRatesCache.reset();
+    mGetRankedFrameRatesCache.clear();
 
     const auto activeModeOpt = mDisplayModes.get(modeId);
     LOG_ALWAYS_FATAL_IF(!activeModeOpt);
@@ -1200,7 +1251,7 @@ void RefreshRateSelector::updateDisplayModes(DisplayModes modes, DisplayModeId a
 
     // Invalidate the cached invocation to getRankedFrameRates. This forces
     // the refresh rate to be recomputed on the next call to getRankedFrameRates.
-    mGetRankedFrameRatesCache.reset();
+    mGetRankedFrameRatesCache.clear();
 
     mDisplayModes = std::move(modes);
     const auto activeModeOpt = mDisplayModes.get(activeModeId);
@@ -1300,7 +1351,7 @@ auto RefreshRateSelector::setPolicy(const PolicyVariant& policy) -> SetPolicyRes
             return SetPolicyResult::Invalid;
         }
 
-        mGetRankedFrameRatesCache.reset();
+        mGetRankedFrameRatesCache.clear();
 
         if (*getCurrentPolicyLocked() == oldPolicy) {
             return SetPolicyResult::Unchanged;
@@ -1488,6 +1539,12 @@ void RefreshRateSelector::dump(utils::Dumper& dumper) const {
 
     dumper.dump("frameRateOverrideConfig"sv, *ftl::enum_name(mFrameRateOverrideConfig));
 
+    dumper.dump("rankedFrameRatesCache"sv);
+    {
+        utils::Dumper::Indent indent(dumper);
+        mGetRankedFrameRatesCache.dump(dumper);
+    }
+
     dumper.dump("idleTimer"sv);
     {
         utils::Dumper::Indent indent(dumper);
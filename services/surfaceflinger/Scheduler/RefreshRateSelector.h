@@ -534,11 +534,41 @@ private:
 
     Config::FrameRateOverride mFrameRateOverrideConfig;
 
-    struct GetRankedFrameRatesCache {
-        std::pair<std::vector<LayerRequirement>, GlobalSignals> arguments;
-        RankedFrameRates result;
+    // Results of the most recent calls to getRankedFrameRates, as its arguments tend to alternate
+    // between a few values, e.g. when touch boost starts and ends. The results depend on the
+    // policy and display modes as well, so the cache is cleared whenever they change.
+    class GetRankedFrameRatesCache {
+    public:
+        static constexpr size_t kMaxSize = 4;
+
+        // Returns the cached result for the arguments, or null if there is none.
+        const RankedFrameRates* get(const std::vector<LayerRequirement>&, GlobalSignals);
+
+        // Caches the result for the arguments, evicting the least recently used result if full.
+        void put(const std::vector<LayerRequirement>&, GlobalSignals, const RankedFrameRates&);
+
+        void clear() { mEntries.clear(); }
+        size_t size() const { return mEntries.size(); }
+
+        void dump(utils::Dumper&) const;
+
+    private:
+        static size_t hashArguments(const std::vector<LayerRequirement>&, GlobalSignals);
+
+        struct Entry {
+            size_t hash;
+            std::vector<LayerRequirement> layers;
+            GlobalSignals signals;
+            RankedFrameRates result;
+        };
+
+        // Ordered by most recent use.
+        std::vector<Entry> mEntries;
+
+        size_t mHitCount = 0;
+        size_t mMissCount = 0;
     };
-    mutable std::optional<GetRankedFrameRatesCache> mGetRankedFrameRatesCache GUARDED_BY(mLock);
+    mutable GetRankedFrameRatesCache mGetRankedFrameRatesCache GUARDED_BY(mLock);
 
     // Declare mIdleTimer last to ensure its thread joins before the mutex/callbacks are destroyed.
     std::mutex mIdleTimerCallbacksMutex;
@@ -57,6 +57,10 @@ VSyncPredictor::VSyncPredictor(ftl::NonNull<DisplayModePtr> modePtr, size_t hist
         kOutlierTolerancePercent(std::min(outlierTolerancePercent, kMaxPercent)),
         mVsyncTrackerCallback(callback),
         mDisplayModePtr(modePtr) {
+    // Samples are added on every hardware vsync, so don't allocate then.
+    mTimestamps.reserve(kHistorySize);
+    mOrdinals.reserve(kHistorySize);
+    mResiduals.reserve(kHistorySize);
     resetModel();
 }
 
@@ -92,11 +96,8 @@ bool VSyncPredictor::validate(nsecs_t timestamp) const {
         return false;
     }
 
-    const auto iter = std::min_element(mTimestamps.begin(), mTimestamps.end(),
-                                       [timestamp](nsecs_t a, nsecs_t b) {
-                                           return std::abs(timestamp - a) < std::abs(timestamp - b);
-                                       });
-    const auto distancePercent = std::abs(*iter - timestamp) * kMaxPercent / idealPeriod();
+    const auto distancePercent =
+            std::abs(closestTimestampLocked(timestamp) - timestamp) * kMaxPercent / idealPeriod();
     if (distancePercent < kOutlierTolerancePercent) {
         // duplicate timestamp
         ATRACE_FORMAT_INSTANT("duplicate timestamp");
@@ -105,6 +106,161 @@ bool VSyncPredictor::validate(nsecs_t timestamp) const {
     return true;
 }
 
+nsecs_t VSyncPredictor::oldestTimestampLocked() const {
+    if (mDescendingTimestamps == 0) {
+        return mTimestamps[next(mLastTimestampIndex)];
+    }
+    return *std::min_element(mTimestamps.begin(), mTimestamps.end());
+}
+
+nsecs_t VSyncPredictor::newestTimestampLocked() const {
+    if (mDescendingTimestamps == 0) {
+        return mTimestamps[mLastTimestampIndex];
+    }
+    return *std::max_element(mTimestamps.begin(), mTimestamps.end());
+}
+
+nsecs_t VSyncPredictor::closestTimestampLocked(nsecs_t timestamp) const {
+    const auto distance = [timestamp](nsecs_t a) { return std::abs(timestamp - a); };
+    if (mDescendingTimestamps > 0) {
+        return *std::min_element(mTimestamps.begin(), mTimestamps.end(),
+                                 [&](nsecs_t a, nsecs_t b) { return distance(a) < distance(b); });
+    }
+
+    // The timestamps ascend from the oldest one, so binary search them.
+    const size_t size = mTimestamps.size();
+    const size_t oldest = next(mLastTimestampIndex);
+    const auto at = [&](size_t i) { return mTimestamps[(oldest + i) % size]; };
+    size_t low = 0;
+    size_t high = size;
+    while (low < high) {
+        const size_t mid = (low + high) / 2;
+        if (at(mid) < timestamp) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == 0) {
+        return at(0);
+    }
+    if (low == size || distance(at(low - 1)) <= distance(at(low))) {
+        return at(low - 1);
+    }
+    return at(low);
+}
+
+void VSyncPredictor::insertTimestamp(nsecs_t timestamp) {
+    if (mTimestamps.size() != kHistorySize) {
+        if (!mTimestamps.empty() && timestamp < mTimestamps[mLastTimestampIndex]) {
+            mDescendingTimestamps++;
+        }
+        mTimestamps.push_back(timestamp);
+        mOrdinals.push_back(0);
+        mResiduals.push_back(0);
+        mLastTimestampIndex = next(mLastTimestampIndex);
+        return;
+    }
+
+    const size_t oldest = next(mLastTimestampIndex);
+    const size_t secondOldest = next(oldest);
+    if (secondOldest != oldest) {
+        if (mTimestamps[secondOldest] < mTimestamps[oldest]) {
+            mDescendingTimestamps--;
+        }
+        if (timestamp < mTimestamps[mLastTimestampIndex]) {
+            mDescendingTimestamps++;
+        }
+    }
+
+    if (mRegressionValid && secondOldest != oldest) {
+        // The oldest timestamp adds nothing to the sums, as they are relative to it. Make them
+        // relative to the next one instead.
+        const auto count = static_cast<int64_t>(mTimestamps.size() - 1);
+        const nsecs_t offset = mTimestamps[secondOldest] - mTimestamps[oldest];
+        const int64_t ordinalOffset = mOrdinals[secondOldest] - mOrdinals[oldest];
+        mSums = {.timestamps = mSums.timestamps - count * offset,
+                 .ordinals = mSums.ordinals - count * ordinalOffset,
+                 .squaredOrdinals = mSums.squaredOrdinals - 2 * ordinalOffset * mSums.ordinals +
+                         count * ordinalOffset * ordinalOffset,
+                 .products = mSums.products - offset * mSums.ordinals -
+                         ordinalOffset * mSums.timestamps + count * offset * ordinalOffset};
+        if (mResiduals[oldest] == mMinResidual || mResiduals[oldest] == mMaxResidual) {
+            mResidualRangeDirty = true;
+        }
+    } else {
+        mRegressionValid = false;
+    }
+
+    mLastTimestampIndex = oldest;
+    mTimestamps[mLastTimestampIndex] = timestamp;
+}
+
+bool VSyncPredictor::addToRegression(nsecs_t currentPeriod) {
+    if (!mRegressionValid || mDescendingTimestamps > 0 || currentPeriod <= 0) {
+        return false;
+    }
+
+    const size_t size = mTimestamps.size();
+    const size_t newest = mLastTimestampIndex;
+    const size_t previous = (newest + size - 1) % size;
+    const size_t oldest = next(newest);
+    const nsecs_t timestamp = mTimestamps[newest] - mTimestamps[oldest];
+    const int64_t ordinal = (timestamp + currentPeriod / 2) / currentPeriod;
+    if (mOrdinals[oldest] + ordinal < mOrdinals[previous]) {
+        return false;
+    }
+
+    mOrdinals[newest] = mOrdinals[oldest] + ordinal;
+    mResiduals[newest] = mTimestamps[newest] - mOrdinalOrigin - mOrdinals[newest] * mOrdinalPeriod;
+    mSums.timestamps += timestamp;
+    mSums.ordinals += ordinal;
+    mSums.squaredOrdinals += ordinal * ordinal;
+    mSums.products += timestamp * ordinal;
+    if (mResidualRangeDirty) {
+        updateResidualRange();
+    } else {
+        mMinResidual = std::min(mMinResidual, mResiduals[newest]);
+        mMaxResidual = std::max(mMaxResidual, mResiduals[newest]);
+    }
+
+    // The ordinals were computed with mOrdinalPeriod, and relative to mOrdinalOrigin. Check that
+    // the current period, relative to the oldest timestamp, rounds every timestamp to the same
+    // vsync, i.e. that their distance to it stays in [-period / 2, period - period / 2). Ordinals
+    // ascend, so the newest one is the largest relative to the oldest.
+    const nsecs_t drift = ordinal * (mOrdinalPeriod - currentPeriod);
+    const nsecs_t low = mMinResidual - mResiduals[oldest] + std::min<nsecs_t>(drift, 0);
+    const nsecs_t high = mMaxResidual - mResiduals[oldest] + std::max<nsecs_t>(drift, 0);
+    return low >= -(currentPeriod / 2) && high < currentPeriod - currentPeriod / 2;
+}
+
+void VSyncPredictor::rebuildRegression(nsecs_t currentPeriod) {
+    const nsecs_t oldestTS = oldestTimestampLocked();
+    mSums = {};
+    for (size_t i = 0; i < mTimestamps.size(); i++) {
+        const nsecs_t timestamp = mTimestamps[i] - oldestTS;
+        const int64_t ordinal =
+                currentPeriod == 0 ? 0 : (timestamp + currentPeriod / 2) / currentPeriod;
+        mSums.timestamps += timestamp;
+        mSums.ordinals += ordinal;
+        mSums.squaredOrdinals += ordinal * ordinal;
+        mSums.products += timestamp * ordinal;
+        mOrdinals[i] = ordinal;
+        mResiduals[i] = timestamp - ordinal * currentPeriod;
+    }
+    mOrdinalOrigin = oldestTS;
+    mOrdinalPeriod = currentPeriod;
+    mRegressionValid = mDescendingTimestamps == 0 && currentPeriod > 0;
+    updateResidualRange();
+}
+
+void VSyncPredictor::updateResidualRange() {
+    const auto [min, max] = std::minmax_element(mResiduals.begin(), mResiduals.end());
+    mMinResidual = *min;
+    mMaxResidual = *max;
+    mResidualRangeDirty = false;
+}
+
 nsecs_t VSyncPredictor::currentPeriod() const {
     std::lock_guard lock(mMutex);
     return mRateMap.find(idealPeriod())->second.slope;
@@ -143,8 +299,7 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
             mTimestamps.push_back(timestamp);
             clearTimestamps();
         } else if (!mTimestamps.empty()) {
-            mKnownTimestamp =
-                    std::max(timestamp, *std::max_element(mTimestamps.begin(), mTimestamps.end()));
+            mKnownTimestamp = std::max(timestamp, newestTimestampLocked());
         } else {
             mKnownTimestamp = timestamp;
         }
@@ -153,13 +308,7 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
         return false;
     }
 
-    if (mTimestamps.size() != kHistorySize) {
-        mTimestamps.push_back(timestamp);
-        mLastTimestampIndex = next(mLastTimestampIndex);
-    } else {
-        mLastTimestampIndex = next(mLastTimestampIndex);
-        mTimestamps[mLastTimestampIndex] = timestamp;
-    }
+    insertTimestamp(timestamp);
 
     traceInt64If("VSP-ts", timestamp);
 
@@ -184,47 +333,31 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
     //
     // intercept = mean(Y) - slope * mean(X)
     //
-    std::vector<nsecs_t> vsyncTS(numSamples);
-    std::vector<nsecs_t> ordinals(numSamples);
-
-    // Normalizing to the oldest timestamp cuts down on error in calculating the intercept.
-    const auto oldestTS = *std::min_element(mTimestamps.begin(), mTimestamps.end());
+    // Both sums are expanded into sums of X_i, Y_i, X_i^2 and X_i * Y_i, which are kept up to
+    // date as timestamps come and go, instead of going over every timestamp. Everything is
+    // computed in integers, so the result is the same as summing over the timestamps.
     auto it = mRateMap.find(idealPeriod());
     auto const currentPeriod = it->second.slope;
 
+    // Normalizing to the oldest timestamp cuts down on error in calculating the intercept. The
+    // ordinals are snapped with the current period, so when it changes enough to move one of
+    // them to another vsync, recompute the sums.
+    if (!addToRegression(currentPeriod)) {
+        rebuildRegression(currentPeriod);
+    }
+
     // The mean of the ordinals must be precise for the intercept calculation, so scale them up for
     // fixed-point arithmetic.
     constexpr int64_t kScalingFactor = 1000;
 
-    nsecs_t meanTS = 0;
-    nsecs_t meanOrdinal = 0;
+    const auto count = static_cast<int64_t>(numSamples);
+    const nsecs_t meanTS = mSums.timestamps / count;
+    const nsecs_t meanOrdinal = mSums.ordinals * kScalingFactor / count;
 
-    for (size_t i = 0; i < numSamples; i++) {
-        const auto timestamp = mTimestamps[i] - oldestTS;
-        vsyncTS[i] = timestamp;
-        meanTS += timestamp;
-
-        const auto ordinal = currentPeriod == 0
-                ? 0
-                : (vsyncTS[i] + currentPeriod / 2) / currentPeriod * kScalingFactor;
-        ordinals[i] = ordinal;
-        meanOrdinal += ordinal;
-    }
-
-    meanTS /= numSamples;
-    meanOrdinal /= numSamples;
-
-    for (size_t i = 0; i < numSamples; i++) {
-        vsyncTS[i] -= meanTS;
-        ordinals[i] -= meanOrdinal;
-    }
-
-    nsecs_t top = 0;
-    nsecs_t bottom = 0;
-    for (size_t i = 0; i < numSamples; i++) {
-        top += vsyncTS[i] * ordinals[i];
-        bottom += ordinals[i] * ordinals[i];
-    }
+    const nsecs_t top = mSums.products * kScalingFactor - meanOrdinal * mSums.timestamps -
+            meanTS * mSums.ordinals * kScalingFactor + count * meanTS * meanOrdinal;
+    const nsecs_t bottom = mSums.squaredOrdinals * kScalingFactor * kScalingFactor -
+            2 * meanOrdinal * mSums.ordinals * kScalingFactor + count * meanOrdinal * meanOrdinal;
 
     if (CC_UNLIKELY(bottom == 0)) {
         it->second = {idealPeriod(), 0};
@@ -273,7 +406,7 @@ nsecs_t VSyncPredictor::nextAnticipatedVSyncTimeFromLocked(nsecs_t timePoint) co
         return knownTimestamp + numPeriodsOut * idealPeriod();
     }
 
-    auto const oldest = *std::min_element(mTimestamps.begin(), mTimestamps.end());
+    auto const oldest = oldestTimestampLocked();
 
     // See b/145667109, the ordinal calculation must take into account the intercept.
     auto const zeroPoint = oldest + intercept;
@@ -534,6 +667,10 @@ void VSyncPredictor::clearTimestamps() {
         mTimestamps.clear();
         mLastTimestampIndex = 0;
     }
+    mOrdinals.clear();
+    mResiduals.clear();
+    mDescendingTimestamps = 0;
+    mRegressionValid = false;
 }
 
 bool VSyncPredictor::needsMoreSamples() const {
@@ -86,6 +86,13 @@ private:
 
     size_t next(size_t i) const REQUIRES(mMutex);
     bool validate(nsecs_t timestamp) const REQUIRES(mMutex);
+    nsecs_t oldestTimestampLocked() const REQUIRES(mMutex);
+    nsecs_t newestTimestampLocked() const REQUIRES(mMutex);
+    nsecs_t closestTimestampLocked(nsecs_t timestamp) const REQUIRES(mMutex);
+    void insertTimestamp(nsecs_t timestamp) REQUIRES(mMutex);
+    bool addToRegression(nsecs_t currentPeriod) REQUIRES(mMutex);
+    void rebuildRegression(nsecs_t currentPeriod) REQUIRES(mMutex);
+    void updateResidualRange() REQUIRES(mMutex);
     Model getVSyncPredictionModelLocked() const REQUIRES(mMutex);
     nsecs_t nextAnticipatedVSyncTimeFromLocked(nsecs_t timePoint) const REQUIRES(mMutex);
     bool isVSyncInPhaseLocked(nsecs_t timePoint, unsigned divisor) const REQUIRES(mMutex);
@@ -113,6 +120,32 @@ private:
 
     size_t mLastTimestampIndex GUARDED_BY(mMutex) = 0;
     std::vector<nsecs_t> mTimestamps GUARDED_BY(mMutex);
+    // Number of timestamps that are smaller than the one before them in mTimestamps. While there
+    // are none, the oldest timestamp is also the smallest.
+    size_t mDescendingTimestamps GUARDED_BY(mMutex) = 0;
+
+    // The regression is updated one timestamp at a time while the timestamps ascend. Each
+    // timestamp gets the ordinal of its vsync, counted in periods of mOrdinalPeriod from
+    // mOrdinalOrigin, and a residual, its distance to that vsync. The residuals tell whether the
+    // ordinals are still the ones the current period would give.
+    bool mRegressionValid GUARDED_BY(mMutex) = false;
+    nsecs_t mOrdinalOrigin GUARDED_BY(mMutex) = 0;
+    nsecs_t mOrdinalPeriod GUARDED_BY(mMutex) = 0;
+    std::vector<int64_t> mOrdinals GUARDED_BY(mMutex);
+    std::vector<nsecs_t> mResiduals GUARDED_BY(mMutex);
+    nsecs_t mMinResidual GUARDED_BY(mMutex) = 0;
+    nsecs_t mMaxResidual GUARDED_BY(mMutex) = 0;
+    bool mResidualRangeDirty GUARDED_BY(mMutex) = false;
+
+    // Sums over the timestamps of the regression, with timestamps and ordinals relative to the
+    // oldest timestamp.
+    struct RegressionSums {
+        nsecs_t timestamps = 0;
+        int64_t ordinals = 0;
+        int64_t squaredOrdinals = 0;
+        int64_t products = 0;
+    };
+    RegressionSums mSums GUARDED_BY(mMutex);
 
     ftl::NonNull<DisplayModePtr> mDisplayModePtr GUARDED_BY(mMutex);
     std::optional<Fps> mRenderRateOpt GUARDED_BY(mMutex);
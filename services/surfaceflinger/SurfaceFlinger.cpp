@@ -551,6 +551,8 @@ SurfaceFlinger::SurfaceFlinger(Factory& factory) : SurfaceFlinger(factory, SkipI
             base::GetBoolProperty("persist.debug.sf.enable_layer_lifecycle_manager"s, true);
     mLegacyFrontEndEnabled = !mLayerLifecycleManagerEnabled ||
             base::GetBoolProperty("persist.debug.sf.enable_legacy_frontend"s, false);
+    mLayerSnapshotBuilder.setWorkerThreadCount(
+            base::GetUintProperty<size_t>("debug.sf.layer_snapshot_builder_threads"s, 0u));
 }
 
 LatchUnsignaledConfig SurfaceFlinger::getLatchUnsignaledConfig() {
@@ -20,6 +20,7 @@
 
 #include <android-base/stringprintf.h>
 #include <log/log.h>
+#include <pthread.h>
 #include <timestatsatomsproto/TimeStatsAtomsProtoHeader.h>
 #include <utils/String8.h>
 #include <utils/Timers.h>
@@ -28,6 +29,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <limits>
 #include <unordered_map>
 
 #include "TimeStats.h"
@@ -97,6 +99,8 @@ bool TimeStats::populateGlobalAtom(std::vector<uint8_t>* pulledData) {
     if (mTimeStats.statsStartLegacy == 0) {
         return false;
     }
+    // The jank payloads are updated by queued JankyFramesInfo events.
+    flushLayerEventsLocked();
     flushPowerTimeLocked();
     SurfaceflingerStatsGlobalInfoWrapper atomList;
     for (const auto& globalSlice : mTimeStats.stats) {
@@ -146,6 +150,7 @@ bool TimeStats::populateGlobalAtom(std::vector<uint8_t>* pulledData) {
 
 bool TimeStats::populateLayerAtom(std::vector<uint8_t>* pulledData) {
     std::lock_guard<std::mutex> lock(mMutex);
+    flushLayerEventsLocked();
 
     std::vector<TimeStatsHelper::TimeStatsLayer*> dumpStats;
     uint32_t numLayers = 0;
@@ -253,6 +258,18 @@ TimeStats::TimeStats(std::optional<size_t> maxPulledLayers,
     if (maxPulledHistogramBuckets) {
         mMaxPulledHistogramBuckets = *maxPulledHistogramBuckets;
     }
+
+    mFlushThread = std::thread(&TimeStats::flushThreadMain, this);
+    pthread_setname_np(mFlushThread.native_handle(), "TimeStatsFlush");
+}
+
+TimeStats::~TimeStats() {
+    {
+        std::lock_guard<std::mutex> lock(mFlushMutex);
+        mFlushThreadStopping = true;
+    }
+    mFlushCondition.notify_one();
+    mFlushThread.join();
 }
 
 bool TimeStats::onPullAtom(const int atomId, std::vector<uint8_t>* pulledData) {
@@ -308,6 +325,7 @@ std::string TimeStats::miniDump() {
 
     std::string result = "TimeStats miniDump:\n";
     std::lock_guard<std::mutex> lock(mMutex);
+    flushLayerEventsLocked();
     android::base::StringAppendF(&result, "Number of layers currently being tracked is %zu\n",
                                  mTimeStatsTracker.size());
     android::base::StringAppendF(&result, "Number of layers in the stats pool is %zu\n",
@@ -564,6 +582,109 @@ bool TimeStats::canAddNewAggregatedStats(uid_t uid, const std::string& layerName
     return layerRecords < MAX_NUM_LAYER_STATS;
 }
 
+TimeStats::InternedLayerName* TimeStats::internLayerName(const std::string& layerName) {
+    {
+        std::shared_lock lock(mLayerNamesMutex);
+        if (const auto it = mLayerNames.find(layerName); it != mLayerNames.end()) {
+            it->second.fetch_add(1, std::memory_order_relaxed);
+            return &*it;
+        }
+    }
+    std::unique_lock lock(mLayerNamesMutex);
+    const auto [it, inserted] = mLayerNames.try_emplace(layerName, 0u);
+    it->second.fetch_add(1, std::memory_order_relaxed);
+    return &*it;
+}
+
+void TimeStats::releaseLayerName(const PostTimeEvent& event) {
+    event.layerName->second.fetch_sub(1, std::memory_order_release);
+}
+
+void TimeStats::releaseLayerName(const JankyFramesEvent& event) {
+    event.layerName->second.fetch_sub(1, std::memory_order_release);
+}
+
+void TimeStats::pruneLayerNames() {
+    {
+        std::shared_lock lock(mLayerNamesMutex);
+        if (mLayerNames.size() <= MAX_NUM_LAYER_NAMES) return;
+    }
+    // References are only added with mLayerNamesMutex held, so a name that has none now cannot
+    // gain one while it is being erased.
+    std::unique_lock lock(mLayerNamesMutex);
+    std::erase_if(mLayerNames, [](const InternedLayerName& name) {
+        return name.second.load(std::memory_order_acquire) == 0;
+    });
+}
+
+void TimeStats::queueLayerEvent(LayerEvent&& event) {
+    mLayerEvents.push(std::move(event));
+    // Only the event that reaches the threshold wakes up the flush thread, so that queueing an
+    // event does not take a lock otherwise.
+    if (mQueuedLayerEvents.fetch_add(1, std::memory_order_relaxed) + 1 ==
+        LAYER_EVENT_FLUSH_THRESHOLD) {
+        {
+            std::lock_guard<std::mutex> lock(mFlushMutex);
+            mFlushRequested = true;
+        }
+        mFlushCondition.notify_one();
+    }
+}
+
+void TimeStats::flushLayerEventsLocked() {
+    flushLayerEventsLocked(std::numeric_limits<size_t>::max());
+}
+
+size_t TimeStats::flushLayerEventsLocked(size_t maxEvents) {
+    size_t flushed = 0;
+    while (flushed < maxEvents) {
+        std::optional<LayerEvent> event = mLayerEvents.pop();
+        if (!event) break;
+        std::visit(
+                [this](const auto& e) {
+                    applyLayerEventLocked(e);
+                    releaseLayerName(e);
+                },
+                *event);
+        flushed++;
+    }
+    mQueuedLayerEvents.fetch_sub(static_cast<int64_t>(flushed), std::memory_order_relaxed);
+    pruneLayerNames();
+    return flushed;
+}
+
+void TimeStats::flushThreadMain() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mFlushMutex);
+            mFlushCondition.wait(lock, [this] { return mFlushRequested || mFlushThreadStopping; });
+            if (mFlushThreadStopping) return;
+            mFlushRequested = false;
+        }
+
+        ATRACE_NAME("TimeStats::flushLayerEvents");
+        // Release mMutex between batches, so that the main thread does not wait for the whole
+        // queue to be flushed.
+        size_t flushed;
+        do {
+            std::lock_guard<std::mutex> lock(mMutex);
+            flushed = flushLayerEventsLocked(LAYER_EVENT_FLUSH_BATCH_SIZE);
+        } while (flushed == LAYER_EVENT_FLUSH_BATCH_SIZE);
+    }
+}
+
+TimeStats::TimeRecord* TimeStats::getWaitingTimeRecordLocked(int32_t layerId,
+                                                             uint64_t frameNumber) {
+    if (!mTimeStatsTracker.count(layerId)) return nullptr;
+    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    if (layerRecord.waitData < 0 ||
+        layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
+        return nullptr;
+    TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
+    if (timeRecord.frameTime.frameNumber != frameNumber) return nullptr;
+    return &timeRecord;
+}
+
 void TimeStats::setPostTime(int32_t layerId, uint64_t frameNumber, const std::string& layerName,
                             uid_t uid, nsecs_t postTime, GameMode gameMode) {
     if (!mEnabled.load()) return;
@@ -572,15 +693,21 @@ void TimeStats::setPostTime(int32_t layerId, uint64_t frameNumber, const std::st
     ALOGV("[%d]-[%" PRIu64 "]-[%s]-PostTime[%" PRId64 "]", layerId, frameNumber, layerName.c_str(),
           postTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!canAddNewAggregatedStats(uid, layerName, gameMode)) {
+    queueLayerEvent(PostTimeEvent{layerId, frameNumber, internLayerName(layerName), uid, postTime,
+                                  gameMode});
+}
+
+void TimeStats::applyLayerEventLocked(const PostTimeEvent& event) {
+    const int32_t layerId = event.layerId;
+    const std::string& layerName = event.layerName->first;
+    if (!canAddNewAggregatedStats(event.uid, layerName, event.gameMode)) {
         return;
     }
     if (!mTimeStatsTracker.count(layerId) && mTimeStatsTracker.size() < MAX_NUM_LAYER_RECORDS &&
         layerNameIsValid(layerName)) {
-        mTimeStatsTracker[layerId].uid = uid;
+        mTimeStatsTracker[layerId].uid = event.uid;
         mTimeStatsTracker[layerId].layerName = layerName;
-        mTimeStatsTracker[layerId].gameMode = gameMode;
+        mTimeStatsTracker[layerId].gameMode = event.gameMode;
     }
     if (!mTimeStatsTracker.count(layerId)) return;
     LayerRecord& layerRecord = mTimeStatsTracker[layerId];
@@ -596,11 +723,11 @@ void TimeStats::setPostTime(int32_t layerId, uint64_t frameNumber, const std::st
     TimeRecord timeRecord = {
             .frameTime =
                     {
-                            .frameNumber = frameNumber,
-                            .postTime = postTime,
-                            .latchTime = postTime,
-                            .acquireTime = postTime,
-                            .desiredTime = postTime,
+                            .frameNumber = event.frameNumber,
+                            .postTime = event.postTime,
+                            .latchTime = event.postTime,
+                            .acquireTime = event.postTime,
+                            .desiredTime = event.postTime,
                     },
     };
     layerRecord.timeRecords.push_back(timeRecord);
@@ -615,15 +742,12 @@ void TimeStats::setLatchTime(int32_t layerId, uint64_t frameNumber, nsecs_t latc
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-LatchTime[%" PRId64 "]", layerId, frameNumber, latchTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
-    if (layerRecord.waitData < 0 ||
-        layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
-        return;
-    TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
-    if (timeRecord.frameTime.frameNumber == frameNumber) {
-        timeRecord.frameTime.latchTime = latchTime;
+    queueLayerEvent(LatchTimeEvent{layerId, frameNumber, latchTime});
+}
+
+void TimeStats::applyLayerEventLocked(const LatchTimeEvent& event) {
+    if (TimeRecord* timeRecord = getWaitingTimeRecordLocked(event.layerId, event.frameNumber)) {
+        timeRecord->frameTime.latchTime = event.latchTime;
     }
 }
 
@@ -634,11 +758,14 @@ void TimeStats::incrementLatchSkipped(int32_t layerId, LatchSkipReason reason) {
     ALOGV("[%d]-LatchSkipped-Reason[%d]", layerId,
           static_cast<std::underlying_type<LatchSkipReason>::type>(reason));
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    queueLayerEvent(LatchSkippedEvent{layerId, reason});
+}
 
-    switch (reason) {
+void TimeStats::applyLayerEventLocked(const LatchSkippedEvent& event) {
+    if (!mTimeStatsTracker.count(event.layerId)) return;
+    LayerRecord& layerRecord = mTimeStatsTracker[event.layerId];
+
+    switch (event.reason) {
         case LatchSkipReason::LateAcquire:
             layerRecord.lateAcquireFrames++;
             break;
@@ -651,9 +778,12 @@ void TimeStats::incrementBadDesiredPresent(int32_t layerId) {
     ATRACE_CALL();
     ALOGV("[%d]-BadDesiredPresent", layerId);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    queueLayerEvent(BadDesiredPresentEvent{layerId});
+}
+
+void TimeStats::applyLayerEventLocked(const BadDesiredPresentEvent& event) {
+    if (!mTimeStatsTracker.count(event.layerId)) return;
+    LayerRecord& layerRecord = mTimeStatsTracker[event.layerId];
     layerRecord.badDesiredPresentFrames++;
 }
 
@@ -663,15 +793,12 @@ void TimeStats::setDesiredTime(int32_t layerId, uint64_t frameNumber, nsecs_t de
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-DesiredTime[%" PRId64 "]", layerId, frameNumber, desiredTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
-    if (layerRecord.waitData < 0 ||
-        layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
-        return;
-    TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
-    if (timeRecord.frameTime.frameNumber == frameNumber) {
-        timeRecord.frameTime.desiredTime = desiredTime;
+    queueLayerEvent(DesiredTimeEvent{layerId, frameNumber, desiredTime});
+}
+
+void TimeStats::applyLayerEventLocked(const DesiredTimeEvent& event) {
+    if (TimeRecord* timeRecord = getWaitingTimeRecordLocked(event.layerId, event.frameNumber)) {
+        timeRecord->frameTime.desiredTime = event.desiredTime;
     }
 }
 
@@ -681,15 +808,12 @@ void TimeStats::setAcquireTime(int32_t layerId, uint64_t frameNumber, nsecs_t ac
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-AcquireTime[%" PRId64 "]", layerId, frameNumber, acquireTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
-    if (layerRecord.waitData < 0 ||
-        layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
-        return;
-    TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
-    if (timeRecord.frameTime.frameNumber == frameNumber) {
-        timeRecord.frameTime.acquireTime = acquireTime;
+    queueLayerEvent(AcquireTimeEvent{layerId, frameNumber, acquireTime});
+}
+
+void TimeStats::applyLayerEventLocked(const AcquireTimeEvent& event) {
+    if (TimeRecord* timeRecord = getWaitingTimeRecordLocked(event.layerId, event.frameNumber)) {
+        timeRecord->frameTime.acquireTime = event.acquireTime;
     }
 }
 
@@ -701,15 +825,12 @@ void TimeStats::setAcquireFence(int32_t layerId, uint64_t frameNumber,
     ALOGV("[%d]-[%" PRIu64 "]-AcquireFenceTime[%" PRId64 "]", layerId, frameNumber,
           acquireFence->getSignalTime());
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
-    if (layerRecord.waitData < 0 ||
-        layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
-        return;
-    TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
-    if (timeRecord.frameTime.frameNumber == frameNumber) {
-        timeRecord.acquireFence = acquireFence;
+    queueLayerEvent(AcquireFenceEvent{layerId, frameNumber, acquireFence});
+}
+
+void TimeStats::applyLayerEventLocked(const AcquireFenceEvent& event) {
+    if (TimeRecord* timeRecord = getWaitingTimeRecordLocked(event.layerId, event.frameNumber)) {
+        timeRecord->acquireFence = event.acquireFence;
     }
 }
 
@@ -721,21 +842,8 @@ void TimeStats::setPresentTime(int32_t layerId, uint64_t frameNumber, nsecs_t pr
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-PresentTime[%" PRId64 "]", layerId, frameNumber, presentTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
-    if (layerRecord.waitData < 0 ||
-        layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
-        return;
-    TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
-    if (timeRecord.frameTime.frameNumber == frameNumber) {
-        timeRecord.frameTime.presentTime = presentTime;
-        timeRecord.ready = true;
-        layerRecord.waitData++;
-    }
-
-    flushAvailableRecordsToStatsLocked(layerId, displayRefreshRate, renderRate, frameRateVote,
-                                       gameMode);
+    queueLayerEvent(PresentEvent{layerId, frameNumber, presentTime, displayRefreshRate, renderRate,
+                                 frameRateVote, gameMode});
 }
 
 void TimeStats::setPresentFence(int32_t layerId, uint64_t frameNumber,
@@ -748,21 +856,30 @@ void TimeStats::setPresentFence(int32_t layerId, uint64_t frameNumber,
     ALOGV("[%d]-[%" PRIu64 "]-PresentFenceTime[%" PRId64 "]", layerId, frameNumber,
           presentFence->getSignalTime());
 
-    std::lock_guard<std::mutex> lock(mMutex);
+    queueLayerEvent(PresentEvent{layerId, frameNumber, presentFence, displayRefreshRate,
+                                 renderRate, frameRateVote, gameMode});
+}
+
+void TimeStats::applyLayerEventLocked(const PresentEvent& event) {
+    const int32_t layerId = event.layerId;
     if (!mTimeStatsTracker.count(layerId)) return;
     LayerRecord& layerRecord = mTimeStatsTracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
     TimeRecord& timeRecord = layerRecord.timeRecords[layerRecord.waitData];
-    if (timeRecord.frameTime.frameNumber == frameNumber) {
-        timeRecord.presentFence = presentFence;
+    if (timeRecord.frameTime.frameNumber == event.frameNumber) {
+        if (const auto presentTime = std::get_if<nsecs_t>(&event.present)) {
+            timeRecord.frameTime.presentTime = *presentTime;
+        } else {
+            timeRecord.presentFence = std::get<std::shared_ptr<FenceTime>>(event.present);
+        }
         timeRecord.ready = true;
         layerRecord.waitData++;
     }
 
-    flushAvailableRecordsToStatsLocked(layerId, displayRefreshRate, renderRate, frameRateVote,
-                                       gameMode);
+    flushAvailableRecordsToStatsLocked(layerId, event.displayRefreshRate, event.renderRate,
+                                       event.frameRateVote, event.gameMode);
 }
 
 static const constexpr int32_t kValidJankyReason = JankType::DisplayHAL |
@@ -806,8 +923,15 @@ void TimeStats::incrementJankyFrames(const JankyFramesInfo& info) {
     if (!mEnabled.load()) return;
 
     ATRACE_CALL();
-    std::lock_guard<std::mutex> lock(mMutex);
+    // Queued behind the present fence of the same frame, so that it sees the layer stats that
+    // the present fence created.
+    queueLayerEvent(JankyFramesEvent{info.refreshRate, info.renderRate, info.uid,
+                                     internLayerName(info.layerName), info.gameMode, info.reasons,
+                                     info.displayDeadlineDelta, info.displayPresentJitter,
+                                     info.appDeadlineDelta});
+}
 
+void TimeStats::applyLayerEventLocked(const JankyFramesEvent& info) {
     // Only update layer stats if we're already tracking the layer in TimeStats.
     // Otherwise, continue tracking the statistic but use a default layer name instead.
     // As an implementation detail, we do this because this method is expected to be
@@ -837,7 +961,7 @@ void TimeStats::incrementJankyFrames(const JankyFramesInfo& info) {
 
     updateJankPayload<TimeStatsHelper::TimelineStats>(timelineStats, info.reasons);
 
-    TimeStatsHelper::LayerStatsKey layerKey = {info.uid, info.layerName, info.gameMode};
+    TimeStatsHelper::LayerStatsKey layerKey = {info.uid, info.layerName->first, info.gameMode};
     if (!timelineStats.stats.count(layerKey)) {
         layerKey = {info.uid, kDefaultLayerName, kDefaultGameMode};
         timelineStats.stats[layerKey].displayRefreshRateBucket = refreshRateBucket;
@@ -863,8 +987,19 @@ void TimeStats::incrementJankyFrames(const JankyFramesInfo& info) {
 void TimeStats::onDestroy(int32_t layerId) {
     ATRACE_CALL();
     ALOGV("[%d]-onDestroy", layerId);
+    if (mEnabled.load()) {
+        queueLayerEvent(DestroyEvent{layerId});
+        return;
+    }
+
+    // Nothing else is queued while disabled, so flush now rather than leave the record around.
     std::lock_guard<std::mutex> lock(mMutex);
-    mTimeStatsTracker.erase(layerId);
+    flushLayerEventsLocked();
+    applyLayerEventLocked(DestroyEvent{layerId});
+}
+
+void TimeStats::applyLayerEventLocked(const DestroyEvent& event) {
+    mTimeStatsTracker.erase(event.layerId);
 }
 
 void TimeStats::removeTimeRecord(int32_t layerId, uint64_t frameNumber) {
@@ -873,12 +1008,15 @@ void TimeStats::removeTimeRecord(int32_t layerId, uint64_t frameNumber) {
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-removeTimeRecord", layerId, frameNumber);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    queueLayerEvent(RemoveTimeRecordEvent{layerId, frameNumber});
+}
+
+void TimeStats::applyLayerEventLocked(const RemoveTimeRecordEvent& event) {
+    if (!mTimeStatsTracker.count(event.layerId)) return;
+    LayerRecord& layerRecord = mTimeStatsTracker[event.layerId];
     size_t removeAt = 0;
     for (const TimeRecord& record : layerRecord.timeRecords) {
-        if (record.frameTime.frameNumber == frameNumber) break;
+        if (record.frameTime.frameNumber == event.frameNumber) break;
         removeAt++;
     }
     if (removeAt == layerRecord.timeRecords.size()) return;
@@ -1045,6 +1183,7 @@ void TimeStats::disable() {
 
 void TimeStats::clearAll() {
     std::lock_guard<std::mutex> lock(mMutex);
+    flushLayerEventsLocked();
     mTimeStats.stats.clear();
     clearGlobalLocked();
     clearLayersLocked();
@@ -1100,6 +1239,7 @@ void TimeStats::dump(bool asProto, std::optional<uint32_t> maxLayers, std::strin
         return;
     }
 
+    flushLayerEventsLocked();
     mTimeStats.statsEndLegacy = static_cast<int64_t>(std::time(0));
 
     flushPowerTimeLocked();
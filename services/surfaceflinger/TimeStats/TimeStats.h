@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <variant>
 
@@ -34,6 +39,8 @@
 
 #include <scheduler/Fps.h>
 
+#include "../LocklessQueue.h"
+
 using android::gui::GameMode;
 using android::gui::LayerMetadata;
 using namespace android::surfaceflinger;
@@ -236,11 +243,100 @@ class TimeStats : public android::TimeStats {
         std::deque<RenderEngineDuration> renderEngineDurations;
     };
 
+    // Layer names are interned, so that queueing an event does not copy the name. The value is
+    // the number of queued events that refer to the name; a name is only erased while it is zero.
+    using LayerNameTable = std::unordered_map<std::string, std::atomic<uint32_t>>;
+    using InternedLayerName = LayerNameTable::value_type;
+
+    // Per layer calls, which happen for every frame of every layer from binder threads and the
+    // main thread, are queued as events without taking mMutex, and applied to mTimeStatsTracker
+    // and mTimeStats later by flushLayerEventsLocked(), in the order they were queued.
+    struct PostTimeEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+        InternedLayerName* layerName;
+        uid_t uid;
+        nsecs_t postTime;
+        GameMode gameMode;
+    };
+
+    struct LatchTimeEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+        nsecs_t latchTime;
+    };
+
+    struct LatchSkippedEvent {
+        int32_t layerId;
+        LatchSkipReason reason;
+    };
+
+    struct BadDesiredPresentEvent {
+        int32_t layerId;
+    };
+
+    struct DesiredTimeEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+        nsecs_t desiredTime;
+    };
+
+    struct AcquireTimeEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+        nsecs_t acquireTime;
+    };
+
+    struct AcquireFenceEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+        std::shared_ptr<FenceTime> acquireFence;
+    };
+
+    struct PresentEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+        // Either the present time, or a fence that signals at the present time.
+        std::variant<nsecs_t, std::shared_ptr<FenceTime>> present;
+        Fps displayRefreshRate;
+        std::optional<Fps> renderRate;
+        SetFrameRateVote frameRateVote;
+        GameMode gameMode;
+    };
+
+    // JankyFramesInfo, with the layer name interned.
+    struct JankyFramesEvent {
+        Fps refreshRate;
+        std::optional<Fps> renderRate;
+        uid_t uid;
+        InternedLayerName* layerName;
+        GameMode gameMode;
+        int32_t reasons;
+        nsecs_t displayDeadlineDelta;
+        nsecs_t displayPresentJitter;
+        nsecs_t appDeadlineDelta;
+    };
+
+    struct RemoveTimeRecordEvent {
+        int32_t layerId;
+        uint64_t frameNumber;
+    };
+
+    struct DestroyEvent {
+        int32_t layerId;
+    };
+
+    using LayerEvent =
+            std::variant<PostTimeEvent, LatchTimeEvent, LatchSkippedEvent, BadDesiredPresentEvent,
+                         DesiredTimeEvent, AcquireTimeEvent, AcquireFenceEvent, PresentEvent,
+                         JankyFramesEvent, RemoveTimeRecordEvent, DestroyEvent>;
+
 public:
     TimeStats();
     // For testing only for injecting custom dependencies.
     TimeStats(std::optional<size_t> maxPulledLayers,
               std::optional<size_t> maxPulledHistogramBuckets);
+    ~TimeStats() override;
 
     bool onPullAtom(const int atomId, std::vector<uint8_t>* pulledData) override;
     void parseArgs(bool asProto, const Vector<String16>& args, std::string& result) override;
@@ -291,6 +387,39 @@ public:
 private:
     bool populateGlobalAtom(std::vector<uint8_t>* pulledData);
     bool populateLayerAtom(std::vector<uint8_t>* pulledData);
+    // Returns the interned copy of layerName, holding a reference for one queued event. The name
+    // is only copied the first time it is seen, which is usually the first post of a new layer.
+    InternedLayerName* internLayerName(const std::string& layerName);
+    // Drops the reference that a queued event held on its layer name, if it has one.
+    template <typename Event>
+    static void releaseLayerName(const Event&) {}
+    static void releaseLayerName(const PostTimeEvent& event);
+    static void releaseLayerName(const JankyFramesEvent& event);
+    // Erases the names that no queued event refers to, once there are more than
+    // MAX_NUM_LAYER_NAMES of them.
+    void pruneLayerNames();
+    void queueLayerEvent(LayerEvent&& event);
+    // Applies every queued layer event. Only the thread holding mMutex may flush, as there can
+    // only be one consumer of mLayerEvents.
+    void flushLayerEventsLocked();
+    // Applies at most maxEvents queued layer events, and returns how many it applied.
+    size_t flushLayerEventsLocked(size_t maxEvents);
+    void flushThreadMain();
+
+    void applyLayerEventLocked(const PostTimeEvent&);
+    void applyLayerEventLocked(const LatchTimeEvent&);
+    void applyLayerEventLocked(const LatchSkippedEvent&);
+    void applyLayerEventLocked(const BadDesiredPresentEvent&);
+    void applyLayerEventLocked(const DesiredTimeEvent&);
+    void applyLayerEventLocked(const AcquireTimeEvent&);
+    void applyLayerEventLocked(const AcquireFenceEvent&);
+    void applyLayerEventLocked(const PresentEvent&);
+    void applyLayerEventLocked(const JankyFramesEvent&);
+    void applyLayerEventLocked(const RemoveTimeRecordEvent&);
+    void applyLayerEventLocked(const DestroyEvent&);
+    // Returns the record of the frame that is still waiting for timestamps, if it is frameNumber.
+    TimeRecord* getWaitingTimeRecordLocked(int32_t layerId, uint64_t frameNumber);
+
     bool recordReadyLocked(int32_t layerId, TimeRecord* timeRecord);
     void flushAvailableRecordsToStatsLocked(int32_t layerId, Fps displayRefreshRate,
                                             std::optional<Fps> renderRate, SetFrameRateVote,
@@ -314,6 +443,32 @@ private:
     PowerTime mPowerTime;
     GlobalRecord mGlobalRecord;
 
+    // Room for a few frames worth of events of every layer. Events that don't fit are still
+    // queued, but behind a mutex.
+    static const size_t LAYER_EVENT_QUEUE_SIZE = 2048;
+    // The number of queued events at which the flush thread wakes up.
+    static const int64_t LAYER_EVENT_FLUSH_THRESHOLD = LAYER_EVENT_QUEUE_SIZE / 4;
+    // The number of events the flush thread applies at a time, so that it does not hold mMutex
+    // for long.
+    static const size_t LAYER_EVENT_FLUSH_BATCH_SIZE = 64;
+
+    // Names of live layers, and of layers that recently had jank reported, are kept interned.
+    static const size_t MAX_NUM_LAYER_NAMES = 400;
+
+    std::shared_mutex mLayerNamesMutex;
+    LayerNameTable mLayerNames;
+
+    LocklessQueue<LayerEvent, LAYER_EVENT_QUEUE_SIZE> mLayerEvents;
+    // May briefly be lower than the actual number of events, as an event is counted after it is
+    // queued.
+    std::atomic<int64_t> mQueuedLayerEvents = 0;
+
+    std::mutex mFlushMutex;
+    std::condition_variable mFlushCondition;
+    bool mFlushRequested = false;
+    bool mFlushThreadStopping = false;
+    std::thread mFlushThread;
+
     static const size_t MAX_NUM_LAYER_RECORDS = 200;
 
     static const size_t REFRESH_RATE_BUCKET_WIDTH = 30;
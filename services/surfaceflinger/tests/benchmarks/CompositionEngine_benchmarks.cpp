@@ -0,0 +1,141 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <com_android_graphics_surfaceflinger_flags.h>
+#include <common/test/FlagUtils.h>
+#include <compositionengine/CompositionRefreshArgs.h>
+#include <compositionengine/LayerFE.h>
+#include <compositionengine/LayerFECompositionState.h>
+#include <compositionengine/impl/CompositionEngine.h>
+#include <compositionengine/impl/Output.h>
+#include <ftl/future.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace android::compositionengine {
+namespace {
+
+using namespace com::android::graphics::surfaceflinger;
+
+constexpr ui::LayerStack kLayerStack{0};
+constexpr ui::Size kDisplaySize{1080, 2400};
+
+// A layer that is always visible with fixed geometry.
+class FakeLayerFE : public LayerFE {
+public:
+    explicit FakeLayerFE(const LayerFECompositionState& state) : mState(state) {}
+
+    const LayerFECompositionState* getCompositionState() const override { return &mState; }
+    bool onPreComposition(nsecs_t, bool) override { return false; }
+    std::optional<LayerSettings> prepareClientComposition(
+            ClientCompositionTargetSettings&) const override {
+        return {};
+    }
+    void onLayerDisplayed(ftl::SharedFuture<FenceResult>, ui::LayerStack) override {}
+    const char* getDebugName() const override { return "FakeLayerFE"; }
+    int32_t getSequence() const override { return 0; }
+    bool hasRoundedCorners() const override { return false; }
+    const gui::LayerMetadata* getMetadata() const override { return nullptr; }
+    const gui::LayerMetadata* getRelativeMetadata() const override { return nullptr; }
+
+private:
+    const LayerFECompositionState mState;
+};
+
+// An HWC output that supports multithreaded present, and whose present does
+// nothing, so that only prepare is measured.
+class PrepareOnlyOutput : public impl::Output {
+public:
+    explicit PrepareOnlyOutput(PhysicalDisplayId displayId) : mDisplayId(displayId) {}
+
+    std::optional<DisplayId> getDisplayId() const override { return mDisplayId; }
+    bool supportsOffloadPresent() const override { return true; }
+    void offloadPresentNextFrame() override {}
+    ftl::Future<std::monostate> present(const CompositionRefreshArgs&) override {
+        return ftl::yield<std::monostate>({});
+    }
+
+private:
+    const PhysicalDisplayId mDisplayId;
+};
+
+// Windows covering parts of the screen, a third of them translucent.
+std::vector<sp<LayerFE>> randomLayers(size_t count) {
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int32_t> x(-100, 1000);
+    std::uniform_int_distribution<int32_t> y(-100, 2300);
+    std::uniform_int_distribution<int32_t> size(50, 1200);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<sp<LayerFE>> layers;
+    for (size_t i = 0; i < count; i++) {
+        LayerFECompositionState state;
+        state.isVisible = true;
+        state.outputFilter = {kLayerStack, false};
+        const auto left = static_cast<float>(x(generator));
+        const auto top = static_cast<float>(y(generator));
+        state.geomLayerBounds = FloatRect(left, top, left + static_cast<float>(size(generator)),
+                                          top + static_cast<float>(size(generator)));
+        state.isOpaque = percent(generator) < 66;
+        layers.push_back(sp<FakeLayerFE>::make(state));
+    }
+    return layers;
+}
+
+// Measures CompositionEngine::present for state.range(0) displays showing the
+// same 64 layers, in a frame whose geometry changed, with prepare running on
+// one thread or on one thread per display.
+void presentOutputs(benchmark::State& state, bool multithreaded) {
+    SET_FLAG_FOR_TEST(flags::multithreaded_present, multithreaded);
+
+    auto engine = impl::createCompositionEngine();
+    CompositionRefreshArgs args;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        const auto displayId = PhysicalDisplayId::fromPort(static_cast<uint8_t>(i));
+        auto output = impl::createOutputTemplated<PrepareOnlyOutput>(*engine, displayId);
+        output->setCompositionEnabled(true);
+        output->setLayerFilter({kLayerStack, false});
+        output->setDisplaySize(kDisplaySize);
+        output->setProjection(ui::ROTATION_0, Rect(kDisplaySize), Rect(kDisplaySize));
+        args.outputs.push_back(std::move(output));
+    }
+    for (auto& layer : randomLayers(64)) {
+        args.layers.push_back(std::move(layer));
+    }
+    args.updatingOutputGeometryThisFrame = true;
+
+    for (auto _ : state) {
+        engine->present(args);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_CompositionEngine_Present(benchmark::State& state) {
+    presentOutputs(state, false);
+}
+BENCHMARK(BM_CompositionEngine_Present)->Arg(1)->Arg(2)->Arg(4);
+
+void BM_CompositionEngine_PresentMultithreaded(benchmark::State& state) {
+    presentOutputs(state, true);
+}
+BENCHMARK(BM_CompositionEngine_PresentMultithreaded)->Arg(1)->Arg(2)->Arg(4);
+
+} // namespace
+} // namespace android::compositionengine
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "FrameTimeline.h"
+#include "Scheduler/EventThread.h"
+#include "Scheduler/VSyncDispatch.h"
+#include "Scheduler/VsyncSchedule.h"
+#include "mock/MockVSyncTracker.h"
+
+namespace android {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr PhysicalDisplayId kDisplayId = PhysicalDisplayId::fromPort(111u);
+constexpr Period kVsyncPeriod = Period::fromNs(std::chrono::nanoseconds(1s).count() / 120);
+
+// Lets the benchmark send the VSYNC callbacks of the EventThread.
+class FakeVSyncDispatch : public scheduler::VSyncDispatch {
+public:
+    CallbackToken registerCallback(Callback callback, std::string) override {
+        mCallback = std::move(callback);
+        return CallbackToken(0);
+    }
+    void unregisterCallback(CallbackToken) override {}
+    scheduler::ScheduleResult schedule(CallbackToken, ScheduleTiming) override { return 0; }
+    scheduler::ScheduleResult update(CallbackToken, ScheduleTiming) override { return 0; }
+    scheduler::CancelResult cancel(CallbackToken) override {
+        return scheduler::CancelResult::Cancelled;
+    }
+    void dump(std::string&) const override {}
+
+    void onVsync(nsecs_t vsyncTime, nsecs_t wakeupTime, nsecs_t readyTime) {
+        mCallback(vsyncTime, wakeupTime, readyTime);
+    }
+
+private:
+    Callback mCallback;
+};
+
+class BenchmarkVsyncSchedule : public scheduler::VsyncSchedule {
+public:
+    BenchmarkVsyncSchedule(TrackerPtr tracker, DispatchPtr dispatch)
+          : VsyncSchedule(kDisplayId, std::move(tracker), std::move(dispatch), nullptr) {}
+};
+
+// Counts the events posted to all connections instead of writing them to a socket.
+class EventCounter {
+public:
+    void onEvent() {
+        std::lock_guard lock(mMutex);
+        mCount++;
+        mCondition.notify_all();
+    }
+
+    void waitForEvents(size_t count) {
+        std::unique_lock lock(mMutex);
+        mCondition.wait(lock, [&] { return mCount >= count; });
+        mCount -= count;
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    size_t mCount = 0;
+};
+
+class CountingConnection : public EventThreadConnection {
+public:
+    CountingConnection(impl::EventThread* eventThread, uid_t uid, EventCounter& counter)
+          : EventThreadConnection(eventThread, uid), mCounter(counter) {}
+
+    status_t postEvent(const DisplayEventReceiver::Event&) override {
+        mCounter.onEvent();
+        return NO_ERROR;
+    }
+
+private:
+    EventCounter& mCounter;
+};
+
+// Apps with a frame rate override get VSYNC at 60 Hz, the others at 120 Hz.
+class Callback : public IEventThreadCallback {
+public:
+    bool throttleVsync(TimePoint, uid_t) override { return false; }
+    Period getVsyncPeriod(uid_t uid) override {
+        return uid % 4 == 0 ? Period::fromNs(2 * kVsyncPeriod.ns()) : kVsyncPeriod;
+    }
+    void resync() override {}
+};
+
+// Measures the time from a VSYNC callback of the EventThread until the VSYNC
+// event has been posted to state.range(0) connections of distinct apps, a
+// quarter of them with a frame rate override.
+void BM_EventThread_DispatchVsync(benchmark::State& state) {
+    const auto tracker = std::make_shared<testing::NiceMock<mock::VSyncTracker>>();
+    const auto dispatch = std::make_shared<FakeVSyncDispatch>();
+    const auto schedule = std::make_shared<BenchmarkVsyncSchedule>(tracker, dispatch);
+    frametimeline::impl::TokenManager tokenManager;
+    Callback callback;
+    EventCounter counter;
+    impl::EventThread eventThread("BenchmarkEventThread", schedule, &tokenManager, callback,
+                                  0ms, 3ms);
+
+    const auto connectionCount = static_cast<size_t>(state.range(0));
+    std::vector<sp<CountingConnection>> connections;
+    for (size_t i = 0; i < connectionCount; i++) {
+        connections.push_back(
+                sp<CountingConnection>::make(&eventThread, static_cast<uid_t>(10000 + i),
+                                             counter));
+    }
+
+    eventThread.onHotplugReceived(kDisplayId, true);
+    counter.waitForEvents(connectionCount);
+    for (const auto& connection : connections) {
+        eventThread.setVsyncRate(1, connection);
+    }
+
+    nsecs_t vsyncTime = systemTime() + kVsyncPeriod.ns();
+    for (auto _ : state) {
+        dispatch->onVsync(vsyncTime, vsyncTime - kVsyncPeriod.ns(), vsyncTime - 3'000'000);
+        counter.waitForEvents(connectionCount);
+        vsyncTime += kVsyncPeriod.ns();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EventThread_DispatchVsync)->Arg(16)->Arg(64)->Arg(256);
+
+} // namespace
+} // namespace android
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "FrameTimeline/FrameTimeline.h"
+#include "TimeStats/TimeStats.h"
+
+namespace android {
+namespace {
+
+using namespace std::chrono_literals;
+using frametimeline::SurfaceFrame;
+
+constexpr int32_t kNumLayers = 100;
+// Each FPS listener watches the layers of one task.
+constexpr int32_t kLayersPerListener = 3;
+constexpr nsecs_t kVsyncPeriod = std::chrono::nanoseconds(1s).count() / 120;
+constexpr pid_t kSurfaceFlingerPid = 666;
+
+// Presents a DisplayFrame with a presented SurfaceFrame for every layer.
+void presentDisplayFrame(frametimeline::impl::FrameTimeline& frameTimeline, nsecs_t presentTime) {
+    for (int32_t layerId = 0; layerId < kNumLayers; layerId++) {
+        auto surfaceFrame =
+                frameTimeline.createSurfaceFrameForToken(FrameTimelineInfo(), /*ownerPid=*/1,
+                                                         /*ownerUid=*/1000, layerId, "layer",
+                                                         "layer", /*isBuffer=*/true,
+                                                         GameMode::Unsupported);
+        surfaceFrame->setPresentState(SurfaceFrame::PresentState::Presented);
+        frameTimeline.addSurfaceFrame(std::move(surfaceFrame));
+    }
+    frameTimeline.setSfPresent(presentTime, std::make_shared<FenceTime>(presentTime));
+}
+
+// Measures the FPS queries of state.range(1) listeners, like FpsReporter makes every
+// sampling period, with a full history of state.range(0) DisplayFrames of 100 layers each.
+void BM_FrameTimeline_ComputeFps(benchmark::State& state) {
+    const uint32_t historySize = static_cast<uint32_t>(state.range(0));
+    const int32_t numListeners = static_cast<int32_t>(state.range(1));
+
+    frametimeline::impl::FrameTimeline frameTimeline(std::make_shared<impl::TimeStats>(),
+                                                     kSurfaceFlingerPid);
+    frameTimeline.setMaxDisplayFrames(historySize);
+    nsecs_t presentTime = kVsyncPeriod;
+    for (uint32_t i = 0; i < historySize; i++) {
+        presentDisplayFrame(frameTimeline, presentTime);
+        presentTime += kVsyncPeriod;
+    }
+
+    std::vector<std::unordered_set<int32_t>> listenerLayerIds(numListeners);
+    for (int32_t listener = 0; listener < numListeners; listener++) {
+        for (int32_t i = 0; i < kLayersPerListener; i++) {
+            listenerLayerIds[listener].insert((listener * kLayersPerListener + i) % kNumLayers);
+        }
+    }
+
+    for (auto _ : state) {
+        for (const auto& layerIds : listenerLayerIds) {
+            benchmark::DoNotOptimize(frameTimeline.computeFps(layerIds));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numListeners);
+}
+BENCHMARK(BM_FrameTimeline_ComputeFps)->ArgsProduct({{64, 256}, {1, 10, 50}});
+
+// Measures presenting a DisplayFrame of 100 layers once the history is full, which includes
+// evicting the oldest DisplayFrame.
+void BM_FrameTimeline_Present(benchmark::State& state) {
+    frametimeline::impl::FrameTimeline frameTimeline(std::make_shared<impl::TimeStats>(),
+                                                     kSurfaceFlingerPid);
+    nsecs_t presentTime = kVsyncPeriod;
+    for (int i = 0; i < 64; i++) {
+        presentDisplayFrame(frameTimeline, presentTime);
+        presentTime += kVsyncPeriod;
+    }
+
+    for (auto _ : state) {
+        presentDisplayFrame(frameTimeline, presentTime);
+        presentTime += kVsyncPeriod;
+    }
+    state.SetItemsProcessed(state.iterations() * kNumLayers);
+}
+BENCHMARK(BM_FrameTimeline_Present);
+
+} // namespace
+} // namespace android
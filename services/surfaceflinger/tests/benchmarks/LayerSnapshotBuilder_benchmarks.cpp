@@ -0,0 +1,191 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "FrontEnd/LayerCreationArgs.h"
+#include "FrontEnd/LayerHierarchy.h"
+#include "FrontEnd/LayerLifecycleManager.h"
+#include "FrontEnd/LayerSnapshotBuilder.h"
+
+namespace android::surfaceflinger::frontend {
+namespace {
+
+// Every display has a tree of layers under its root with this many children per layer, so
+// 1 + 8 + 64 + 512 = 585 layers per display.
+constexpr uint32_t kChildrenPerLayer = 8;
+constexpr uint32_t kTreeDepth = 3;
+
+std::vector<TransactionState> createTransaction(uint32_t layerId) {
+    std::vector<TransactionState> transactions;
+    transactions.emplace_back();
+    transactions.back().states.push_back({});
+    transactions.back().states.front().layerId = layerId;
+    return transactions;
+}
+
+// Layers for a number of displays, each with its own layer stack and a tree of color layers
+// under a root layer.
+class TestHierarchy {
+public:
+    explicit TestHierarchy(uint32_t displayCount) {
+        uint32_t nextId = 1;
+        for (uint32_t display = 0; display < displayCount; display++) {
+            const uint32_t rootId = nextId++;
+            mDisplayRootIds.push_back(rootId);
+            addLayer(rootId, UNASSIGNED_LAYER_ID);
+            auto transactions = createTransaction(rootId);
+            transactions.back().states.front().state.what = layer_state_t::eLayerStackChanged;
+            transactions.back().states.front().state.layerStack =
+                    ui::LayerStack::fromValue(display);
+            mLifecycleManager.applyTransactions(transactions);
+            addTree(nextId, rootId, kTreeDepth);
+
+            DisplayInfo info;
+            info.info.logicalWidth = 1080;
+            info.info.logicalHeight = 2400;
+            info.isPrimary = display == 0;
+            mDisplays.emplace_or_replace(ui::LayerStack::fromValue(display), info);
+        }
+        mHierarchyBuilder.update(mLifecycleManager.getLayers(),
+                                 mLifecycleManager.getDestroyedLayers());
+    }
+
+    LayerSnapshotBuilder::Args createArgs(bool displayChanges) const {
+        return {.root = mHierarchyBuilder.getHierarchy(),
+                .layerLifecycleManager = mLifecycleManager,
+                .includeMetadata = false,
+                .displays = mDisplays,
+                .displayChanges = displayChanges,
+                .globalShadowSettings = mGlobalShadowSettings,
+                .supportsBlur = true,
+                .supportedLayerGenericMetadata = {},
+                .genericLayerMetadataKeyMap = {}};
+    }
+
+    // A geometry change on every display root, which makes the builder walk the whole hierarchy.
+    void setRootCrops(int32_t size) {
+        for (uint32_t rootId : mDisplayRootIds) {
+            auto transactions = createTransaction(rootId);
+            transactions.back().states.front().state.what = layer_state_t::eCropChanged;
+            transactions.back().states.front().state.crop = Rect(0, 0, size, size);
+            mLifecycleManager.applyTransactions(transactions);
+        }
+    }
+
+    void commitChanges() { mLifecycleManager.commitChanges(); }
+
+private:
+    void addLayer(uint32_t id, uint32_t parentId) {
+        LayerCreationArgs args(std::make_optional(id));
+        args.name = "layer";
+        args.addToRoot = parentId == UNASSIGNED_LAYER_ID;
+        args.parentId = parentId;
+        std::vector<std::unique_ptr<RequestedLayerState>> layers;
+        layers.emplace_back(std::make_unique<RequestedLayerState>(args));
+        mLifecycleManager.addLayers(std::move(layers));
+
+        // Give the layer some content so that it is visible.
+        auto transactions = createTransaction(id);
+        transactions.back().states.front().state.what = layer_state_t::eColorChanged;
+        transactions.back().states.front().state.color.rgb = half3(1._hf, 1._hf, 1._hf);
+        mLifecycleManager.applyTransactions(transactions);
+    }
+
+    void addTree(uint32_t& nextId, uint32_t parentId, uint32_t depth) {
+        for (uint32_t i = 0; i < kChildrenPerLayer; i++) {
+            const uint32_t id = nextId++;
+            addLayer(id, parentId);
+            if (depth > 1) {
+                addTree(nextId, id, depth - 1);
+            }
+        }
+    }
+
+    LayerLifecycleManager mLifecycleManager;
+    LayerHierarchyBuilder mHierarchyBuilder{{}};
+    DisplayInfos mDisplays;
+    ShadowSettings mGlobalShadowSettings;
+    std::vector<uint32_t> mDisplayRootIds;
+};
+
+} // namespace
+
+// Commit: a geometry change on every display root. Run with the builder updating every display on
+// the calling thread and with one thread per display.
+static void BM_LayerSnapshotBuilder_UpdateGeometry(benchmark::State& state) {
+    const auto displayCount = static_cast<uint32_t>(state.range(0));
+    const bool parallel = state.range(1) != 0;
+
+    TestHierarchy hierarchy(displayCount);
+    LayerSnapshotBuilder snapshotBuilder(hierarchy.createArgs(/*displayChanges=*/true));
+    snapshotBuilder.setWorkerThreadCount(parallel ? displayCount - 1 : 0);
+    hierarchy.commitChanges();
+    const LayerSnapshotBuilder::Args args = hierarchy.createArgs(/*displayChanges=*/false);
+
+    int32_t cropSize = 1000;
+    for (auto _ : state) {
+        state.PauseTiming();
+        cropSize = cropSize == 1000 ? 900 : 1000;
+        hierarchy.setRootCrops(cropSize);
+        state.ResumeTiming();
+
+        snapshotBuilder.update(args);
+
+        state.PauseTiming();
+        hierarchy.commitChanges();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(snapshotBuilder.getSnapshots().size()));
+}
+BENCHMARK(BM_LayerSnapshotBuilder_UpdateGeometry)
+        ->ArgNames({"displays", "parallel"})
+        ->ArgsProduct({{1, 2, 4}, {0, 1}});
+
+// Composite prep: the passes SurfaceFlinger makes over the snapshots for every composited frame,
+// moving the visible snapshots to their LayerFEs and back, and collecting input windows.
+static void BM_LayerSnapshotBuilder_VisitSnapshots(benchmark::State& state) {
+    const auto displayCount = static_cast<uint32_t>(state.range(0));
+    TestHierarchy hierarchy(displayCount);
+    LayerSnapshotBuilder snapshotBuilder(hierarchy.createArgs(/*displayChanges=*/true));
+    hierarchy.commitChanges();
+
+    std::vector<std::unique_ptr<LayerSnapshot>> movedSnapshots;
+    size_t visibleSnapshotCount = 0;
+    for (auto _ : state) {
+        snapshotBuilder.forEachVisibleSnapshot([&](std::unique_ptr<LayerSnapshot>& snapshot) {
+            movedSnapshots.push_back(std::move(snapshot));
+        });
+        visibleSnapshotCount = movedSnapshots.size();
+        auto& snapshots = snapshotBuilder.getSnapshots();
+        for (auto& snapshot : movedSnapshots) {
+            const size_t globalZ = snapshot->globalZ;
+            snapshots[globalZ] = std::move(snapshot);
+        }
+        movedSnapshots.clear();
+
+        snapshotBuilder.forEachVisibleSnapshot([](const LayerSnapshot& snapshot) {
+            benchmark::DoNotOptimize(snapshot.transformedBoundsWithoutTransparentRegion);
+        });
+        snapshotBuilder.forEachInputSnapshot(
+                [](const LayerSnapshot& snapshot) { benchmark::DoNotOptimize(snapshot.inputInfo); });
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(visibleSnapshotCount));
+}
+BENCHMARK(BM_LayerSnapshotBuilder_VisitSnapshots)->ArgName("displays")->Arg(1)->Arg(4);
+
+} // namespace android::surfaceflinger::frontend
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <queue>
+
+#include "LocklessQueue.h"
+#include "TransactionState.h"
+
+namespace android {
+namespace {
+
+// The number of binder threads calling setTransactionState at once.
+constexpr int kMinProducerThreads = 1;
+constexpr int kMaxProducerThreads = 16;
+
+TransactionState createTransaction(uint64_t id) {
+    TransactionState transaction;
+    transaction.id = id;
+    transaction.states.resize(2);
+    transaction.states[0].state.what = layer_state_t::ePositionChanged;
+    transaction.states[1].state.what = layer_state_t::eAlphaChanged;
+    return transaction;
+}
+
+// A mutex guarded queue, as a baseline for comparison.
+class MutexQueue {
+public:
+    void push(TransactionState value) {
+        std::scoped_lock lock(mMutex);
+        mQueue.push(std::move(value));
+    }
+
+    std::optional<TransactionState> pop() {
+        std::scoped_lock lock(mMutex);
+        if (mQueue.empty()) {
+            return std::nullopt;
+        }
+        std::optional<TransactionState> value = std::move(mQueue.front());
+        mQueue.pop();
+        return value;
+    }
+
+private:
+    std::mutex mMutex;
+    std::queue<TransactionState> mQueue;
+};
+
+// Every benchmark thread pushes transactions like a binder thread would, and the first thread also
+// drains the queue like the main thread does when it collects transactions.
+template <typename Queue>
+void pushTransactions(benchmark::State& state, Queue& queue) {
+    uint64_t id = static_cast<uint64_t>(state.thread_index()) << 32;
+    for (auto _ : state) {
+        queue.push(createTransaction(id++));
+        if (state.thread_index() == 0) {
+            while (auto transaction = queue.pop()) {
+                benchmark::DoNotOptimize(transaction);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+LocklessQueue<TransactionState> sLocklessQueue;
+MutexQueue sMutexQueue;
+
+} // namespace
+
+static void BM_LocklessQueue_PushTransactionState(benchmark::State& state) {
+    pushTransactions(state, sLocklessQueue);
+}
+BENCHMARK(BM_LocklessQueue_PushTransactionState)
+        ->ThreadRange(kMinProducerThreads, kMaxProducerThreads)
+        ->UseRealTime();
+
+static void BM_MutexQueue_PushTransactionState(benchmark::State& state) {
+    pushTransactions(state, sMutexQueue);
+}
+BENCHMARK(BM_MutexQueue_PushTransactionState)
+        ->ThreadRange(kMinProducerThreads, kMaxProducerThreads)
+        ->UseRealTime();
+
+} // namespace android
+
+BENCHMARK_MAIN();
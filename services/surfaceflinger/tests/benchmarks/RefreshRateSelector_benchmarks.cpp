@@ -0,0 +1,101 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "DisplayHardware/DisplayMode.h"
+#include "Scheduler/RefreshRateSelector.h"
+#include "mock/DisplayHardware/MockDisplayMode.h"
+
+namespace android::scheduler {
+namespace {
+
+using namespace std::string_literals;
+
+using Config = RefreshRateSelector::Config;
+using LayerRequirement = RefreshRateSelector::LayerRequirement;
+using LayerVoteType = RefreshRateSelector::LayerVoteType;
+
+constexpr DisplayModeId kModeId60{0};
+
+// The modes of RefreshRateSelectorTest's kModes_30_60_72_90_120, with frame rate overrides
+// enabled, so that each mode also offers its divisors as render frame rates.
+RefreshRateSelector createSelector() {
+    const Config config = {.enableFrameRateOverride = Config::FrameRateOverride::Enabled};
+    return RefreshRateSelector(makeModes(mock::createDisplayMode(kModeId60, 60_Hz),
+                                         mock::createDisplayMode(DisplayModeId(1), 30_Hz),
+                                         mock::createDisplayMode(DisplayModeId(2), 72_Hz),
+                                         mock::createDisplayMode(DisplayModeId(3), 90_Hz),
+                                         mock::createDisplayMode(DisplayModeId(4), 120_Hz)),
+                               kModeId60, config);
+}
+
+// An app playing a video over a wallpaper, with the rest of the layers animating at the
+// heuristic rate of the given refresh rate.
+std::vector<LayerRequirement> createLayers(size_t count, Fps heuristicRate) {
+    std::vector<LayerRequirement> layers;
+    layers.push_back({.name = "Video"s,
+                      .vote = LayerVoteType::ExplicitExactOrMultiple,
+                      .desiredRefreshRate = 24_Hz,
+                      .weight = 1.f,
+                      .focused = true});
+    layers.push_back({.name = "Wallpaper"s, .vote = LayerVoteType::Min, .weight = 1.f});
+    while (layers.size() < count) {
+        layers.push_back({.name = "Animation#"s + std::to_string(layers.size()),
+                          .vote = LayerVoteType::Heuristic,
+                          .desiredRefreshRate = heuristicRate,
+                          .weight = 0.5f});
+    }
+    return layers;
+}
+
+// Measures ranking the frame rates for state.range(0) layers while touch boost starts and ends
+// on every frame.
+void BM_RefreshRateSelector_AlternatingSignals(benchmark::State& state) {
+    const auto selector = createSelector();
+    const auto layers = createLayers(static_cast<size_t>(state.range(0)), 60_Hz);
+
+    bool touch = false;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(selector.getRankedFrameRates(layers, {.touch = touch}));
+        touch = !touch;
+    }
+}
+BENCHMARK(BM_RefreshRateSelector_AlternatingSignals)->Arg(4)->Arg(16)->Arg(64);
+
+// Measures ranking the frame rates for state.range(0) layers whose heuristic rate changes on
+// every frame, cycling through more layer requirements than are cached.
+void BM_RefreshRateSelector_ChangingLayers(benchmark::State& state) {
+    const auto selector = createSelector();
+    const Fps kHeuristicRates[] = {30_Hz, 45_Hz, 60_Hz, 72_Hz, 90_Hz, 120_Hz};
+    std::vector<std::vector<LayerRequirement>> layerSets;
+    for (const Fps heuristicRate : kHeuristicRates) {
+        layerSets.push_back(createLayers(static_cast<size_t>(state.range(0)), heuristicRate));
+    }
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(selector.getRankedFrameRates(layerSets[i], {}));
+        i = (i + 1) % layerSets.size();
+    }
+}
+BENCHMARK(BM_RefreshRateSelector_ChangingLayers)->Arg(4)->Arg(16)->Arg(64);
+
+} // namespace
+} // namespace android::scheduler
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TimeStats/TimeStats.h"
+
+namespace {
+
+// Allocations made by the current thread. These are counted for every benchmark in this binary,
+// but only reported by the ones below.
+thread_local int64_t tAllocationCount = 0;
+
+void* countedAllocate(size_t size) {
+    tAllocationCount++;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace android {
+namespace {
+
+using namespace std::chrono_literals;
+
+constexpr int32_t kNumLayers = 100;
+constexpr auto kVsyncPeriod = std::chrono::nanoseconds(1s) / 120;
+constexpr Fps kRefreshRate = Fps::fromPeriodNsecs(kVsyncPeriod.count());
+
+std::string layerName(int32_t layerId) {
+    return "com.example.fake#" + std::to_string(layerId);
+}
+
+// Measures the time the main thread spends in TimeStats per frame, while 100 layers update at
+// 120Hz. Binder threads post a buffer for each of their layers every vsync, and the main thread
+// latches and presents the latest buffer of every layer every vsync, like SurfaceFlinger does.
+// Only the main thread's calls are timed, the rest of the vsync period is left to the other
+// threads. Also reports how many allocations the TimeStats calls make on the main thread per
+// frame, and on the binder threads per post. Layer names and fences are created outside of the
+// counted calls, as SurfaceFlinger already holds them.
+void BM_TimeStats_MainThreadFrame(benchmark::State& state) {
+    const int32_t numBinderThreads = static_cast<int32_t>(state.range(0));
+
+    impl::TimeStats timeStats;
+    std::string result;
+    Vector<String16> args;
+    args.push_back(String16("-enable"));
+    timeStats.parseArgs(/*asProto=*/false, args, result);
+
+    std::vector<std::string> layerNames;
+    std::vector<TimeStats::JankyFramesInfo> jankyFrames;
+    for (int32_t layerId = 0; layerId < kNumLayers; layerId++) {
+        layerNames.push_back(layerName(layerId));
+        jankyFrames.push_back({kRefreshRate, std::nullopt, /*uid=*/1000, layerName(layerId),
+                               GameMode::Unsupported, JankType::None, 0, 0, 0});
+    }
+
+    std::vector<std::atomic<uint64_t>> postedFrameNumbers(kNumLayers);
+    std::atomic<bool> done = false;
+    std::atomic<int64_t> binderAllocations = 0;
+    std::atomic<int64_t> posts = 0;
+    std::vector<std::thread> binderThreads;
+    for (int32_t thread = 0; thread < numBinderThreads; thread++) {
+        binderThreads.emplace_back([&, thread] {
+            auto vsync = std::chrono::steady_clock::now();
+            for (uint64_t frameNumber = 1; !done; frameNumber++) {
+                for (int32_t layerId = thread; layerId < kNumLayers;
+                     layerId += numBinderThreads) {
+                    const int64_t startAllocations = tAllocationCount;
+                    timeStats.setPostTime(layerId, frameNumber, layerNames[layerId], /*uid=*/1000,
+                                          systemTime(), GameMode::Unsupported);
+                    binderAllocations += tAllocationCount - startAllocations;
+                    posts++;
+                    postedFrameNumbers[layerId] = frameNumber;
+                }
+                vsync += kVsyncPeriod;
+                std::this_thread::sleep_until(vsync);
+            }
+        });
+    }
+
+    std::vector<std::shared_ptr<FenceTime>> acquireFences(kNumLayers);
+    int64_t mainAllocations = 0;
+    auto vsync = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        const nsecs_t now = systemTime();
+        for (auto& fence : acquireFences) {
+            fence = std::make_shared<FenceTime>(now);
+        }
+        const auto presentFence = std::make_shared<FenceTime>(now);
+
+        const auto start = std::chrono::steady_clock::now();
+        const int64_t startAllocations = tAllocationCount;
+        for (int32_t layerId = 0; layerId < kNumLayers; layerId++) {
+            const uint64_t frameNumber = postedFrameNumbers[layerId];
+            timeStats.setLatchTime(layerId, frameNumber, now);
+            timeStats.setDesiredTime(layerId, frameNumber, now);
+            timeStats.setAcquireFence(layerId, frameNumber, acquireFences[layerId]);
+            timeStats.setPresentFence(layerId, frameNumber, presentFence, kRefreshRate,
+                                      std::nullopt, {}, GameMode::Unsupported);
+            timeStats.incrementJankyFrames(jankyFrames[layerId]);
+        }
+        mainAllocations += tAllocationCount - startAllocations;
+        state.SetIterationTime(
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        vsync += kVsyncPeriod;
+        std::this_thread::sleep_until(vsync);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumLayers);
+
+    done = true;
+    for (std::thread& thread : binderThreads) {
+        thread.join();
+    }
+
+    state.counters["main_allocs_per_frame"] =
+            static_cast<double>(mainAllocations) / static_cast<double>(state.iterations());
+    if (posts > 0) {
+        state.counters["binder_allocs_per_post"] =
+                static_cast<double>(binderAllocations) / static_cast<double>(posts);
+    }
+}
+// Two seconds of frames.
+BENCHMARK(BM_TimeStats_MainThreadFrame)->Arg(1)->Arg(4)->Iterations(240)->UseManualTime();
+
+} // namespace
+} // namespace android
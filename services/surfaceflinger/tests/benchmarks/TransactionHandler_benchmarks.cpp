@@ -0,0 +1,111 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <binder/Binder.h>
+#include <gui/fake/BufferData.h>
+#include <renderengine/mock/FakeExternalTexture.h>
+
+#include "FrontEnd/TransactionHandler.h"
+#include "TransactionState.h"
+
+namespace android {
+namespace {
+
+using frontend::TransactionHandler;
+using TransactionReadiness = TransactionHandler::TransactionReadiness;
+
+// The number of apps, each with its own apply token.
+constexpr int64_t kMinApplyTokens = 100;
+constexpr int64_t kMaxApplyTokens = 800;
+// The number of apply tokens sharing a layer, whose transactions wait on each other's barriers.
+constexpr uint64_t kChainLength = 8;
+
+// Only the barrier check, as in SurfaceFlinger::transactionReadyBufferCheck.
+TransactionReadiness barrierFilter(const TransactionHandler::TransactionFlushState& flushState) {
+    auto ready = TransactionReadiness::Ready;
+    flushState.transaction->traverseStatesWithBuffers([&](const layer_state_t& s) {
+        if (s.bufferData->hasBarrier &&
+            !(flushState.bufferLayersReadyToPresent.contains(s.surface.get()) &&
+              flushState.bufferLayersReadyToPresent.get(s.surface.get()) >=
+                      s.bufferData->barrierFrameNumber)) {
+            ready = TransactionReadiness::NotReadyBarrier;
+        }
+    });
+    return ready;
+}
+
+TransactionState createTransaction(const sp<IBinder>& applyToken, const sp<IBinder>& surface,
+                                   uint64_t frameNumber) {
+    TransactionState transaction;
+    transaction.applyToken = applyToken;
+    transaction.states.emplace_back();
+    auto& state = transaction.states[0].state;
+    state.what |= layer_state_t::eBufferChanged;
+    state.surface = surface;
+    state.bufferData = std::make_shared<fake::BufferData>(frameNumber, /*width=*/1, /*height=*/1,
+                                                          /*pixelFormat=*/0, /*outUsage=*/0);
+    state.bufferData->frameNumber = frameNumber;
+    state.bufferData->flags = BufferData::BufferDataChange::frameNumberChanged;
+    // Every frame but the first waits for the previous frame on the same layer, which is sent on
+    // a different apply token, like a sync transaction.
+    state.bufferData->hasBarrier = frameNumber > 1;
+    state.bufferData->barrierFrameNumber = frameNumber - 1;
+    transaction.states[0].externalTexture =
+            std::make_shared<renderengine::mock::FakeExternalTexture>(1, 1, frameNumber, 0, 0);
+    return transaction;
+}
+
+} // namespace
+
+static void BM_TransactionHandler_FlushChainedBarriers(benchmark::State& state) {
+    const auto applyTokenCount = static_cast<uint64_t>(state.range(0));
+    std::vector<sp<IBinder>> applyTokens;
+    std::vector<sp<IBinder>> surfaces;
+    for (uint64_t i = 0; i < applyTokenCount; i++) {
+        applyTokens.push_back(sp<BBinder>::make());
+    }
+    for (uint64_t i = 0; i < (applyTokenCount + kChainLength - 1) / kChainLength; i++) {
+        surfaces.push_back(sp<BBinder>::make());
+    }
+
+    TransactionHandler handler;
+    handler.addTransactionReadyFilter(barrierFilter);
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Queue the end of each chain first, so that most transactions are blocked on their
+        // barrier when they are first visited.
+        for (uint64_t i = applyTokenCount; i-- > 0;) {
+            handler.queueTransaction(createTransaction(applyTokens[i], surfaces[i / kChainLength],
+                                                       i % kChainLength + 1));
+        }
+        handler.collectTransactions();
+        state.ResumeTiming();
+
+        std::vector<TransactionState> transactions = handler.flushTransactions();
+        if (transactions.size() != applyTokenCount) {
+            state.SkipWithError("Not all transactions were flushed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransactionHandler_FlushChainedBarriers)
+        ->RangeMultiplier(2)
+        ->Range(kMinApplyTokens, kMaxApplyTokens);
+
+} // namespace android
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "Scheduler/VSyncPredictor.h"
+#include "mock/DisplayHardware/MockDisplayMode.h"
+#include "mock/MockVsyncTrackerCallback.h"
+
+namespace android::scheduler {
+namespace {
+
+// The values VsyncSchedule uses.
+constexpr size_t kHistorySize = 20;
+constexpr size_t kMinSamplesForPrediction = 6;
+constexpr uint32_t kDiscardOutlierPercent = 20;
+
+// Measures adding a hardware vsync timestamp to the model, at a refresh rate of state.range(0)
+// Hz. The timestamps are 0.2% slower than the ideal period, with 20us of jitter, like fences of
+// a real display.
+void BM_VSyncPredictor_AddVsyncTimestamp(benchmark::State& state) {
+    const Fps refreshRate = Fps::fromValue(static_cast<float>(state.range(0)));
+    const nsecs_t period = refreshRate.getPeriodNsecs();
+    mock::NoOpVsyncTrackerCallback callback;
+    VSyncPredictor predictor(ftl::as_non_null(
+                                     android::mock::createDisplayMode(DisplayModeId(0),
+                                                                      refreshRate)),
+                             kHistorySize, kMinSamplesForPrediction, kDiscardOutlierPercent,
+                             callback);
+
+    constexpr size_t kNumTimestamps = 4096;
+    std::mt19937 generator(0);
+    std::normal_distribution<double> jitter(0, 20'000);
+    std::vector<nsecs_t> timestamps(kNumTimestamps);
+    for (size_t i = 0; i < kNumTimestamps; i++) {
+        timestamps[i] = static_cast<nsecs_t>(i) * (period + period / 500) +
+                static_cast<nsecs_t>(jitter(generator));
+    }
+
+    nsecs_t offset = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(predictor.addVsyncTimestamp(timestamps[i] + offset));
+        if (++i == kNumTimestamps) {
+            i = 0;
+            offset += timestamps.back() + period;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_VSyncPredictor_AddVsyncTimestamp)->Arg(120)->Arg(240);
+
+} // namespace
+} // namespace android::scheduler
@@ -25,6 +25,7 @@
 #include <gtest/gtest.h>
 #include <log/log.h>
 #include <scheduler/VsyncConfig.h>
+#include <unordered_map>
 #include <utils/Errors.h>
 
 #include "AsyncCallRecorder.h"
@@ -138,6 +139,7 @@ protected:
     std::unique_ptr<frametimeline::impl::TokenManager> mTokenManager;
 
     std::chrono::nanoseconds mVsyncPeriod;
+    std::unordered_map<uid_t, std::chrono::nanoseconds> mVsyncPeriodOverrides;
 
     static constexpr uid_t mConnectionUid = 443;
     static constexpr uid_t mThrottledConnectionUid = 177;
@@ -179,7 +181,10 @@ bool EventThreadTest::throttleVsync(android::TimePoint expectedVsyncTimestamp, u
     return (uid == mThrottledConnectionUid);
 }
 
-Period EventThreadTest::getVsyncPeriod(uid_t) {
+Period EventThreadTest::getVsyncPeriod(uid_t uid) {
+    if (const auto it = mVsyncPeriodOverrides.find(uid); it != mVsyncPeriodOverrides.end()) {
+        return it->second;
+    }
     return mVsyncPeriod;
 }
 
@@ -462,6 +467,58 @@ TEST_F(EventThreadTest, requestNextVsyncEventFrameTimelinesValidLength) {
     expectVsyncEventDataFrameTimelinesValidLength(vsyncEventData);
 }
 
+TEST_F(EventThreadTest, requestNextVsyncSharesFrameTimelinesOfSameFrameInterval) {
+    constexpr uid_t kHalfRateUid = 101;
+    mVsyncPeriodOverrides[kHalfRateUid] = 2 * VSYNC_PERIOD;
+    setupEventThread();
+
+    ConnectionEventRecorder sameRateEventCallRecorder{0};
+    ConnectionEventRecorder halfRateEventCallRecorder{0};
+    const auto sameRateConnection = createConnection(sameRateEventCallRecorder);
+    const auto halfRateConnection =
+            createConnection(halfRateEventCallRecorder, {}, kHalfRateUid);
+
+    mThread->requestNextVsync(mConnection);
+    mThread->requestNextVsync(sameRateConnection);
+    mThread->requestNextVsync(halfRateConnection);
+    expectVSyncCallbackScheduleReceived(true);
+
+    onVSyncEvent(123, 456, 789);
+    const auto args = mConnectionEventCallRecorder.waitForCall();
+    const auto sameRateArgs = sameRateEventCallRecorder.waitForCall();
+    const auto halfRateArgs = halfRateEventCallRecorder.waitForCall();
+    ASSERT_TRUE(args.has_value());
+    ASSERT_TRUE(sameRateArgs.has_value());
+    ASSERT_TRUE(halfRateArgs.has_value());
+
+    // Connections with the same frame interval get the same frame timelines.
+    const VsyncEventData& vsyncData = std::get<0>(args.value()).vsync.vsyncData;
+    const VsyncEventData& sameRateVsyncData = std::get<0>(sameRateArgs.value()).vsync.vsyncData;
+    const nsecs_t frameInterval = std::chrono::nanoseconds(VSYNC_PERIOD).count();
+    EXPECT_EQ(frameInterval, vsyncData.frameInterval);
+    EXPECT_EQ(frameInterval, sameRateVsyncData.frameInterval);
+    ASSERT_EQ(vsyncData.frameTimelinesLength, sameRateVsyncData.frameTimelinesLength);
+    EXPECT_EQ(vsyncData.preferredFrameTimelineIndex,
+              sameRateVsyncData.preferredFrameTimelineIndex);
+    for (size_t i = 0; i < vsyncData.frameTimelinesLength; i++) {
+        EXPECT_EQ(vsyncData.frameTimelines[i].vsyncId, sameRateVsyncData.frameTimelines[i].vsyncId)
+                << "Vsync ID differs for frame timeline " << i;
+        EXPECT_EQ(vsyncData.frameTimelines[i].deadlineTimestamp,
+                  sameRateVsyncData.frameTimelines[i].deadlineTimestamp)
+                << "Deadline timestamp differs for frame timeline " << i;
+    }
+
+    // Connections with another frame interval get frame timelines of their own.
+    const VsyncEventData& halfRateVsyncData = std::get<0>(halfRateArgs.value()).vsync.vsyncData;
+    EXPECT_EQ(2 * frameInterval, halfRateVsyncData.frameInterval);
+    for (size_t i = 0; i < halfRateVsyncData.frameTimelinesLength; i++) {
+        for (size_t j = 0; j < vsyncData.frameTimelinesLength; j++) {
+            EXPECT_NE(halfRateVsyncData.frameTimelines[i].vsyncId,
+                      vsyncData.frameTimelines[j].vsyncId);
+        }
+    }
+}
+
 TEST_F(EventThreadTest, getLatestVsyncEventData) {
     setupEventThread();
 
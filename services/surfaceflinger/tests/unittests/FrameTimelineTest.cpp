@@ -135,6 +135,22 @@ public:
         mFrameTimeline->setSfPresent(2500, presentFence1);
     }
 
+    // Presents a DisplayFrame with a presented SurfaceFrame for each of layerIds.
+    void addPresentedDisplayFrame(const std::vector<int32_t>& layerIds, nsecs_t presentTime) {
+        for (const int32_t layerId : layerIds) {
+            auto surfaceFrame =
+                    mFrameTimeline->createSurfaceFrameForToken(FrameTimelineInfo(), sPidOne,
+                                                               sUidOne, layerId, sLayerNameOne,
+                                                               sLayerNameOne, /*isBuffer*/ true,
+                                                               sGameMode);
+            surfaceFrame->setPresentState(SurfaceFrame::PresentState::Presented);
+            mFrameTimeline->addSurfaceFrame(surfaceFrame);
+        }
+        auto presentFence = fenceFactory.createFenceTimeForTest(Fence::NO_FENCE);
+        presentFence->signalForTest(presentTime);
+        mFrameTimeline->setSfPresent(presentTime, presentFence);
+    }
+
     void flushTokens() {
         for (size_t i = 0; i < maxTokens; i++) {
             mTokenManager->generateTokenForPredictions({});
@@ -2604,6 +2620,61 @@ TEST_F(FrameTimelineTest, computeFps_averagesOverMultipleFrames) {
     EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne}), 5.0f);
 }
 
+TEST_F(FrameTimelineTest, computeFps_countsDisplayFramesWithSeveralLayersOnce) {
+    const auto oneHundredMs = std::chrono::nanoseconds(100ms).count();
+    const auto twoHundredMs = std::chrono::nanoseconds(200ms).count();
+    const auto threeHundredMs = std::chrono::nanoseconds(300ms).count();
+    addPresentedDisplayFrame({sLayerIdOne, sLayerIdTwo}, oneHundredMs);
+    addPresentedDisplayFrame({sLayerIdOne, sLayerIdOne}, twoHundredMs);
+    addPresentedDisplayFrame({sLayerIdTwo}, threeHundredMs);
+
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne}), 10.0f);
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdTwo}), 5.0f);
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne, sLayerIdTwo}), 10.0f);
+}
+
+TEST_F(FrameTimelineTest, computeFps_ignoresEvictedDisplayFrames) {
+    const auto oneHundredMs = std::chrono::nanoseconds(100ms).count();
+    const auto fourHundredMs = std::chrono::nanoseconds(400ms).count();
+    const auto fiveHundredMs = std::chrono::nanoseconds(500ms).count();
+    *maxDisplayFrames = 2;
+    addPresentedDisplayFrame({sLayerIdOne}, oneHundredMs);
+    addPresentedDisplayFrame({sLayerIdOne, sLayerIdTwo}, fourHundredMs);
+    addPresentedDisplayFrame({sLayerIdOne}, fiveHundredMs);
+
+    // Only the last two DisplayFrames are kept.
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne}), 10.0f);
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne, sLayerIdTwo}), 10.0f);
+
+    mFrameTimeline->setMaxDisplayFrames(256);
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne}), 0.0f);
+}
+
+TEST_F(FrameTimelineTest, computeFps_ignoresDisplayFramesEvictedBeforePresent) {
+    const auto oneHundredMs = std::chrono::nanoseconds(100ms).count();
+    const auto twoHundredMs = std::chrono::nanoseconds(200ms).count();
+    const auto fourHundredMs = std::chrono::nanoseconds(400ms).count();
+    *maxDisplayFrames = 2;
+
+    // The first DisplayFrame leaves the history before its fence signals.
+    auto surfaceFrame =
+            mFrameTimeline->createSurfaceFrameForToken(FrameTimelineInfo(), sPidOne, sUidOne,
+                                                       sLayerIdOne, sLayerNameOne, sLayerNameOne,
+                                                       /*isBuffer*/ true, sGameMode);
+    surfaceFrame->setPresentState(SurfaceFrame::PresentState::Presented);
+    mFrameTimeline->addSurfaceFrame(surfaceFrame);
+    auto pendingFence = fenceFactory.createFenceTimeForTest(Fence::NO_FENCE);
+    mFrameTimeline->setSfPresent(oneHundredMs, pendingFence);
+    addEmptyDisplayFrame();
+    addEmptyDisplayFrame();
+    pendingFence->signalForTest(oneHundredMs);
+
+    addPresentedDisplayFrame({sLayerIdOne}, twoHundredMs);
+    addPresentedDisplayFrame({sLayerIdOne}, fourHundredMs);
+
+    EXPECT_EQ(mFrameTimeline->computeFps({sLayerIdOne}), 5.0f);
+}
+
 TEST_F(FrameTimelineTest, getMinTime) {
     // Use SurfaceFrame::getBaseTime to test the getMinTime.
     FrameTimelineInfo ftInfo;
@@ -92,6 +92,49 @@ protected:
         EXPECT_EQ(expectedVisibleLayerIdsInZOrder, actualVisibleLayerIdsInZOrder);
     }
 
+    void enableParallelUpdate(LayerSnapshotBuilder& builder) {
+        builder.setWorkerThreadCount(2);
+        builder.mMinSnapshotsForParallelUpdate = 0;
+    }
+
+    size_t getSubtreeGroupCount(const LayerSnapshotBuilder& builder) {
+        return builder.mSubtreeGroupsValid ? builder.mSubtreeGroups.size() : 0;
+    }
+
+    // Applies the same changes to both builders and verifies that they produce the same snapshots.
+    void updateAndCompare(LayerSnapshotBuilder& serialBuilder,
+                          LayerSnapshotBuilder& parallelBuilder, bool hasDisplayChanges) {
+        if (mLifecycleManager.getGlobalChanges().test(RequestedLayerState::Changes::Hierarchy)) {
+            mHierarchyBuilder.update(mLifecycleManager.getLayers(),
+                                     mLifecycleManager.getDestroyedLayers());
+        }
+        LayerSnapshotBuilder::Args args{.root = mHierarchyBuilder.getHierarchy(),
+                                        .layerLifecycleManager = mLifecycleManager,
+                                        .includeMetadata = false,
+                                        .displays = mFrontEndDisplayInfos,
+                                        .displayChanges = hasDisplayChanges,
+                                        .globalShadowSettings = globalShadowSettings,
+                                        .supportsBlur = true,
+                                        .supportedLayerGenericMetadata = {},
+                                        .genericLayerMetadataKeyMap = {}};
+        serialBuilder.update(args);
+        parallelBuilder.update(args);
+        mLifecycleManager.commitChanges();
+
+        ASSERT_EQ(serialBuilder.getSnapshots().size(), parallelBuilder.getSnapshots().size());
+        for (auto& expected : serialBuilder.getSnapshots()) {
+            SCOPED_TRACE(expected->getDebugString());
+            LayerSnapshot* actual = parallelBuilder.getSnapshot(expected->path);
+            ASSERT_NE(nullptr, actual);
+            EXPECT_EQ(expected->getDebugString(), actual->getDebugString());
+            EXPECT_EQ(expected->globalZ, actual->globalZ);
+            EXPECT_EQ(expected->isHiddenByPolicyFromRelativeParent,
+                      actual->isHiddenByPolicyFromRelativeParent);
+            EXPECT_EQ(expected->reachablilty, actual->reachablilty);
+            EXPECT_EQ(expected->alpha, actual->alpha);
+        }
+    }
+
     LayerSnapshot* getSnapshot(uint32_t layerId) { return mSnapshotBuilder.getSnapshot(layerId); }
     LayerSnapshot* getSnapshot(const LayerHierarchy::TraversalPath path) {
         return mSnapshotBuilder.getSnapshot(path);
@@ -1200,4 +1243,61 @@ TEST_F(LayerSnapshotTest, propagateDropInputMode) {
     EXPECT_EQ(getSnapshot(11)->dropInputMode, gui::DropInputMode::ALL);
 }
 
+TEST_F(LayerSnapshotTest, parallelSubtreeUpdateMatchesSerialUpdate) {
+    LayerSnapshotBuilder::Args args{.root = mHierarchyBuilder.getHierarchy(),
+                                    .layerLifecycleManager = mLifecycleManager,
+                                    .includeMetadata = false,
+                                    .displays = mFrontEndDisplayInfos,
+                                    .globalShadowSettings = globalShadowSettings,
+                                    .supportedLayerGenericMetadata = {},
+                                    .genericLayerMetadataKeyMap = {}};
+    LayerSnapshotBuilder parallelBuilder(args);
+    enableParallelUpdate(parallelBuilder);
+
+    // The subtree groups are computed on the first update after enabling the worker pool.
+    setCrop(1, Rect(0, 0, 100, 100));
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+    EXPECT_EQ(2u, getSubtreeGroupCount(parallelBuilder));
+
+    // Layers 1 and 2 are now updated on different threads.
+    setCrop(11, Rect(0, 0, 50, 50));
+    setAlpha(2, 0.5f);
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+    setColor(121);
+    setFlags(122, layer_state_t::eLayerHidden, layer_state_t::eLayerHidden);
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/true);
+    EXPECT_EQ(2u, getSubtreeGroupCount(parallelBuilder));
+}
+
+TEST_F(LayerSnapshotTest, parallelSubtreeUpdateGroupsRelativeLayers) {
+    LayerSnapshotBuilder::Args args{.root = mHierarchyBuilder.getHierarchy(),
+                                    .layerLifecycleManager = mLifecycleManager,
+                                    .includeMetadata = false,
+                                    .displays = mFrontEndDisplayInfos,
+                                    .globalShadowSettings = globalShadowSettings,
+                                    .supportedLayerGenericMetadata = {},
+                                    .genericLayerMetadataKeyMap = {}};
+    LayerSnapshotBuilder parallelBuilder(args);
+    enableParallelUpdate(parallelBuilder);
+
+    // Layer 13 is reached from both top-level subtrees, so they have to be updated together.
+    reparentRelativeLayer(13, 2);
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+    EXPECT_EQ(1u, getSubtreeGroupCount(parallelBuilder));
+    setAlpha(2, 0.5f);
+    setCrop(1, Rect(0, 0, 100, 100));
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+
+    // Clones are separate snapshots, mirroring a layer from the other subtree does not tie the
+    // subtrees together.
+    removeRelativeZ(13);
+    mirrorLayer(/*id=*/3, /*parent=*/2, /*layerToMirror=*/11);
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+    EXPECT_EQ(2u, getSubtreeGroupCount(parallelBuilder));
+    setCrop(11, Rect(0, 0, 50, 50));
+    setAlpha(1, 0.5f);
+    updateAndCompare(mSnapshotBuilder, parallelBuilder, /*hasDisplayChanges=*/false);
+}
+
 } // namespace android::surfaceflinger::frontend
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "LocklessQueue.h"
+
+namespace android {
+namespace {
+
+TEST(LocklessQueueTest, popsInFifoOrder) {
+    LocklessQueue<int> queue;
+    ASSERT_TRUE(queue.isEmpty());
+    ASSERT_FALSE(queue.pop().has_value());
+
+    for (int i = 0; i < 10; i++) {
+        queue.push(i);
+    }
+    ASSERT_FALSE(queue.isEmpty());
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i, queue.pop().value_or(-1));
+    }
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(LocklessQueueTest, overflowPreservesFifoOrder) {
+    LocklessQueue<int, 4> queue;
+    // Fill the ring and spill into the overflow list.
+    for (int i = 0; i < 10; i++) {
+        queue.push(i);
+    }
+    // Free up ring slots while the overflow list is not empty. New values must still be popped
+    // after the ones in the overflow list.
+    EXPECT_EQ(0, queue.pop().value_or(-1));
+    EXPECT_EQ(1, queue.pop().value_or(-1));
+    queue.push(10);
+    queue.push(11);
+    for (int i = 2; i < 12; i++) {
+        EXPECT_EQ(i, queue.pop().value_or(-1));
+    }
+    EXPECT_TRUE(queue.isEmpty());
+
+    // Once drained, the ring is used again.
+    queue.push(12);
+    EXPECT_EQ(12, queue.pop().value_or(-1));
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(LocklessQueueTest, wrapsAroundTheRing) {
+    LocklessQueue<int, 4> queue;
+    for (int i = 0; i < 100; i++) {
+        queue.push(i);
+        queue.push(i + 1000);
+        EXPECT_EQ(i, queue.pop().value_or(-1));
+        EXPECT_EQ(i + 1000, queue.pop().value_or(-1));
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(LocklessQueueTest, supportsMoveOnlyTypes) {
+    LocklessQueue<std::unique_ptr<int>, 2> queue;
+    for (int i = 0; i < 4; i++) {
+        queue.push(std::make_unique<int>(i));
+    }
+    for (int i = 0; i < 4; i++) {
+        auto value = queue.pop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(i, **value);
+    }
+}
+
+TEST(LocklessQueueTest, multipleProducersPreserveOrderPerProducer) {
+    constexpr int kProducerCount = 8;
+    constexpr int kValuesPerProducer = 10000;
+    struct Value {
+        int producer;
+        int index;
+    };
+    // A small ring so that the overflow path is exercised as well.
+    LocklessQueue<Value, 16> queue;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < kProducerCount; producer++) {
+        producers.emplace_back([&queue, producer]() {
+            for (int index = 0; index < kValuesPerProducer; index++) {
+                queue.push({producer, index});
+            }
+        });
+    }
+
+    std::vector<int> nextIndex(kProducerCount, 0);
+    int popped = 0;
+    while (popped < kProducerCount * kValuesPerProducer) {
+        auto value = queue.pop();
+        if (!value) {
+            std::this_thread::yield();
+            continue;
+        }
+        EXPECT_EQ(nextIndex[static_cast<size_t>(value->producer)], value->index);
+        nextIndex[static_cast<size_t>(value->producer)] = value->index + 1;
+        popped++;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+// A value whose move constructor, which push uses to write the value into its ring slot, blocks
+// until the test releases it. This stalls the producer after it has reserved the slot but before
+// it has published it.
+struct StallGate {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool reserved = false;
+    bool released = false;
+};
+
+struct StallingValue {
+    int value;
+    StallGate* gate;
+
+    StallingValue(int value, StallGate* gate = nullptr) : value(value), gate(gate) {}
+
+    StallingValue(StallingValue&& other)
+          : value(other.value), gate(std::exchange(other.gate, nullptr)) {
+        if (!gate) return;
+        std::unique_lock lock(gate->mutex);
+        gate->reserved = true;
+        gate->cv.notify_all();
+        gate->cv.wait(lock, [this] { return gate->released; });
+    }
+
+    StallingValue& operator=(StallingValue&&) = default;
+};
+
+TEST(LocklessQueueTest, popDoesNotWaitForStalledProducer) {
+    LocklessQueue<StallingValue, 4> queue;
+    StallGate gate;
+
+    std::thread producer([&] { queue.push(StallingValue(0, &gate)); });
+    {
+        std::unique_lock lock(gate.mutex);
+        gate.cv.wait(lock, [&] { return gate.reserved; });
+    }
+    // Published after the stalled value, so it must not be popped before it either.
+    queue.push(StallingValue(1));
+
+    EXPECT_FALSE(queue.isEmpty());
+    EXPECT_FALSE(queue.pop().has_value());
+    EXPECT_FALSE(queue.pop().has_value());
+
+    {
+        std::scoped_lock lock(gate.mutex);
+        gate.released = true;
+    }
+    gate.cv.notify_all();
+    producer.join();
+
+    auto first = queue.pop();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(0, first->value);
+    auto second = queue.pop();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(1, second->value);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+} // namespace
+} // namespace android
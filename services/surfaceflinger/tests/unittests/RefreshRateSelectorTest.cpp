@@ -2643,7 +2643,7 @@ TEST_P(RefreshRateSelectorTest, getBestFrameRateMode_ReadsCache) {
                                                                   {90_Hz, kMode90}}},
                                                           GlobalSignals{.touch = true}};
 
-    selector.mutableGetRankedRefreshRatesCache() = {args, result};
+    selector.mutableGetRankedRefreshRatesCache().put(args.first, args.second, result);
 
     EXPECT_EQ(result, selector.getRankedFrameRates(args.first, args.second));
 }
@@ -2651,18 +2651,54 @@ TEST_P(RefreshRateSelectorTest, getBestFrameRateMode_ReadsCache) {
 TEST_P(RefreshRateSelectorTest, getBestFrameRateMode_WritesCache) {
     auto selector = createSelector(kModes_30_60_72_90_120, kModeId60);
 
-    EXPECT_FALSE(selector.mutableGetRankedRefreshRatesCache());
+    EXPECT_EQ(0u, selector.mutableGetRankedRefreshRatesCache().size());
 
     std::vector<LayerRequirement> layers = {{.weight = 1.f}, {.weight = 0.5f}};
     RefreshRateSelector::GlobalSignals globalSignals{.touch = true, .idle = true};
 
     const auto result = selector.getRankedFrameRates(layers, globalSignals);
 
-    const auto& cache = selector.mutableGetRankedRefreshRatesCache();
-    ASSERT_TRUE(cache);
+    auto& cache = selector.mutableGetRankedRefreshRatesCache();
+    ASSERT_EQ(1u, cache.size());
 
-    EXPECT_EQ(cache->arguments, std::make_pair(layers, globalSignals));
-    EXPECT_EQ(cache->result, result);
+    const auto* cachedResult = cache.get(layers, globalSignals);
+    ASSERT_TRUE(cachedResult);
+    EXPECT_EQ(*cachedResult, result);
+}
+
+TEST_P(RefreshRateSelectorTest, getBestFrameRateMode_CachesRecentArguments) {
+    auto selector = createSelector(kModes_30_60_72_90_120, kModeId60);
+    using GetRankedFrameRatesCache = TestableRefreshRateSelector::GetRankedFrameRatesCache;
+    auto& cache = selector.mutableGetRankedRefreshRatesCache();
+
+    std::vector<LayerRequirement> layers = {{.weight = 1.f}};
+    layers[0].vote = LayerVoteType::ExplicitDefault;
+    layers[0].name = "ExplicitDefault";
+
+    // Alternating between the results for touch and no touch uses the cache.
+    layers[0].desiredRefreshRate = 60_Hz;
+    const auto result = selector.getRankedFrameRates(layers, {});
+    const auto touchResult = selector.getRankedFrameRates(layers, {.touch = true});
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_EQ(result, selector.getRankedFrameRates(layers, {}));
+    EXPECT_EQ(touchResult, selector.getRankedFrameRates(layers, {.touch = true}));
+    EXPECT_EQ(2u, cache.size());
+
+    // Other layer requirements evict the least recently used results.
+    const Fps kDesiredRefreshRates[] = {30_Hz, 72_Hz, 90_Hz};
+    for (const Fps desiredRefreshRate : kDesiredRefreshRates) {
+        layers[0].desiredRefreshRate = desiredRefreshRate;
+        selector.getRankedFrameRates(layers, {});
+    }
+    EXPECT_EQ(GetRankedFrameRatesCache::kMaxSize, cache.size());
+    layers[0].desiredRefreshRate = 60_Hz;
+    EXPECT_FALSE(cache.get(layers, {}));
+    EXPECT_TRUE(cache.get(layers, {.touch = true}));
+
+    // Changing the policy clears the cache.
+    EXPECT_EQ(SetPolicyResult::Changed,
+              selector.setDisplayManagerPolicy({kModeId60, {60_Hz, 90_Hz}}));
+    EXPECT_EQ(0u, cache.size());
 }
 
 TEST_P(RefreshRateSelectorTest, getBestFrameRateMode_ExplicitExactTouchBoost) {
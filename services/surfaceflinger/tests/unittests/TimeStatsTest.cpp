@@ -30,8 +30,10 @@
 #include <utils/String16.h>
 #include <utils/Vector.h>
 
+#include <algorithm>
 #include <chrono>
 #include <random>
+#include <thread>
 #include <unordered_set>
 
 #include "libsurfaceflinger_unittest_main.h"
@@ -742,6 +744,70 @@ TEST_F(TimeStatsTest, canInsertMultipleLayersTimeStats) {
     EXPECT_EQ(2, globalProto.stats_size());
 }
 
+TEST_F(TimeStatsTest, canInsertLayerTimeStatsFromMultipleThreads) {
+    EXPECT_TRUE(inputCommand(InputCommand::ENABLE, FMT_STRING).empty());
+
+    // Enough frames to overflow the layer event queue and to wake up the flush thread many times.
+    constexpr int32_t kNumThreads = 4;
+    constexpr uint64_t kNumFrames = 1000;
+    std::vector<std::thread> threads;
+    for (int32_t layerId = 0; layerId < kNumThreads; layerId++) {
+        threads.emplace_back([this, layerId] {
+            for (uint64_t frameNumber = 1; frameNumber <= kNumFrames; frameNumber++) {
+                insertTimeRecord(NORMAL_SEQUENCE, layerId, frameNumber, frameNumber * 10000000);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    SFTimeStatsGlobalProto globalProto;
+    ASSERT_TRUE(globalProto.ParseFromString(inputCommand(InputCommand::DUMP_ALL, FMT_PROTO)));
+
+    ASSERT_EQ(kNumThreads, globalProto.stats_size());
+    for (const SFTimeStatsLayerProto& layerProto : globalProto.stats()) {
+        // The first frame of each layer has no previous present to compare with.
+        EXPECT_EQ(static_cast<int32_t>(kNumFrames - 1), layerProto.total_frames())
+                << layerProto.layer_name();
+    }
+}
+
+TEST_F(TimeStatsTest, keepsLayerNamesAcrossManyDistinctNames) {
+    EXPECT_TRUE(inputCommand(InputCommand::ENABLE, FMT_STRING).empty());
+
+    insertTimeRecord(NORMAL_SEQUENCE, LAYER_ID_0, 1, 1000000);
+    // Far more distinct names than TimeStats keeps interned, like transaction-only layers whose
+    // names include a hash code.
+    constexpr int32_t kNumOtherLayers = 1000;
+    for (int32_t i = 0; i < kNumOtherLayers; i++) {
+        mTimeStats->incrementJankyFrames({kRefreshRate0, kRenderRate0, UID_0,
+                                          "leash#" + std::to_string(i), kGameMode, JankType::None,
+                                          1, 2, 3});
+    }
+    // Flushes, and drops the interned names that no queued event refers to anymore.
+    inputCommand(InputCommand::DUMP_ALL, FMT_STRING);
+
+    mTimeStats->incrementJankyFrames({kRefreshRate0, kRenderRate0, UID_0, genLayerName(LAYER_ID_0),
+                                      kGameMode, JankType::AppDeadlineMissed, 1, 2, 3});
+    insertTimeRecord(NORMAL_SEQUENCE_2, LAYER_ID_0, 2, 2000000);
+
+    const std::string result(inputCommand(InputCommand::DUMP_ALL, FMT_STRING));
+    EXPECT_THAT(result, HasSubstr("totalTimelineFrames = " + std::to_string(kNumOtherLayers + 1)));
+    EXPECT_THAT(result, HasSubstr("layerName = " + genLayerName(LAYER_ID_0)));
+    EXPECT_THAT(result, HasSubstr("appUnattributedJankyFrames = 1"));
+
+    SFTimeStatsGlobalProto globalProto;
+    ASSERT_TRUE(globalProto.ParseFromString(inputCommand(InputCommand::DUMP_ALL, FMT_PROTO)));
+    const auto layerProto =
+            std::find_if(globalProto.stats().begin(), globalProto.stats().end(),
+                         [](const SFTimeStatsLayerProto& layer) {
+                             return layer.layer_name() == genLayerName(LAYER_ID_0);
+                         });
+    ASSERT_NE(globalProto.stats().end(), layerProto);
+    EXPECT_EQ(1, layerProto->total_frames());
+}
+
 TEST_F(TimeStatsTest, canInsertUnorderedLayerTimeStats) {
     EXPECT_TRUE(inputCommand(InputCommand::ENABLE, FMT_STRING).empty());
 
@@ -909,6 +909,59 @@ TEST(TransactionHandlerTest, QueueTransaction) {
     EXPECT_EQ(transactionsReadyToBeApplied.front().id, 42u);
 }
 
+TEST(TransactionHandlerTest, ChainedBarriersAcrossApplyTokensAreFlushedTogether) {
+    using TransactionReadiness = TransactionHandler::TransactionReadiness;
+    TransactionHandler handler;
+    // Only the barrier check, as in SurfaceFlinger::transactionReadyBufferCheck.
+    handler.addTransactionReadyFilter(
+            [](const TransactionHandler::TransactionFlushState& flushState) {
+                auto ready = TransactionReadiness::Ready;
+                flushState.transaction->traverseStatesWithBuffers([&](const layer_state_t& s) {
+                    if (s.bufferData->hasBarrier &&
+                        !(flushState.bufferLayersReadyToPresent.contains(s.surface.get()) &&
+                          flushState.bufferLayersReadyToPresent.get(s.surface.get()) >=
+                                  s.bufferData->barrierFrameNumber)) {
+                        ready = TransactionReadiness::NotReadyBarrier;
+                    }
+                });
+                return ready;
+            });
+
+    // Each transaction is on its own apply token, and waits for the frame of the previous one.
+    // Queue them backwards so that most of them are blocked when first visited.
+    constexpr uint64_t kChainLength = 50;
+    const sp<IBinder> surface = sp<BBinder>::make();
+    for (uint64_t i = kChainLength; i-- > 0;) {
+        TransactionState transaction;
+        transaction.applyToken = sp<BBinder>::make();
+        transaction.id = i;
+        transaction.states.emplace_back();
+        auto& state = transaction.states[0].state;
+        state.what |= layer_state_t::eBufferChanged;
+        state.surface = surface;
+        state.bufferData =
+                std::make_shared<fake::BufferData>(/* bufferId */ i + 1, /* width */ 1,
+                                                   /* height */ 1, /* pixelFormat */ 0,
+                                                   /* outUsage */ 0);
+        state.bufferData->frameNumber = i + 1;
+        state.bufferData->flags = BufferData::BufferDataChange::frameNumberChanged;
+        state.bufferData->hasBarrier = i > 0;
+        state.bufferData->barrierFrameNumber = i;
+        transaction.states[0].externalTexture =
+                std::make_shared<FakeExternalTexture>(*state.bufferData);
+        handler.queueTransaction(std::move(transaction));
+    }
+
+    handler.collectTransactions();
+    std::vector<TransactionState> transactions = handler.flushTransactions();
+
+    ASSERT_EQ(kChainLength, transactions.size());
+    for (size_t i = 0; i < transactions.size(); i++) {
+        EXPECT_EQ(i, transactions[i].id);
+    }
+    EXPECT_FALSE(handler.hasPendingTransactions());
+}
+
 TEST(TransactionHandlerTest, TransactionsKeepTrackOfDirectMerges) {
     SurfaceComposerClient::Transaction transaction1, transaction2, transaction3, transaction4;
 
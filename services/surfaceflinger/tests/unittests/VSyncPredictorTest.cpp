@@ -483,6 +483,24 @@ TEST_F(VSyncPredictorTest, aPhoneThatHasBeenAroundAWhileCanStillComputePeriod) {
     EXPECT_THAT(intercept, Eq(0));
 }
 
+TEST_F(VSyncPredictorTest, followsSlowlyDriftingPeriodOverManySamples) {
+    constexpr nsecs_t timeBase = 100_years;
+    constexpr auto kNumVsyncs = 10000;
+
+    // The model is updated one sample at a time, so make sure it doesn't accumulate errors as
+    // the period drifts by 10% and older samples keep leaving the history.
+    nsecs_t now = timeBase;
+    nsecs_t realPeriod = mPeriod;
+    for (int i = 0; i < kNumVsyncs; i++) {
+        realPeriod = mPeriod + mPeriod * i / kNumVsyncs / 10;
+        now += realPeriod;
+        EXPECT_TRUE(tracker.addVsyncTimestamp(now));
+    }
+    auto [slope, intercept] = tracker.getVSyncPredictionModel();
+    EXPECT_THAT(slope, IsCloseTo(realPeriod, 1));
+    EXPECT_THAT(intercept, IsCloseTo(0, mMaxRoundingError));
+}
+
 TEST_F(VSyncPredictorTest, isVSyncInPhase) {
     auto last = mNow;
     auto const bias = 10;